@@ -33,6 +33,13 @@ void Driver::init()
     // 2024-05-12 INPUT should not be GlobalC, mohan 2024-05-12
     Driver::reading();
 
+    // (2) run many structures in the batch mode, each has its own logs
+    if (PARAM.inp.stru_batch != "none")
+    {
+        this->batch_world();
+        return;
+    }
+
     // (2) welcome to the atomic world!
     this->atomic_world();
 
@@ -35,6 +35,13 @@ class Driver
      */
     void atomic_world();
 
+    /**
+     * @brief Run the structures given by "stru_batch" one by one.
+     * The INPUT is read once, and each structure is written to its own
+     * directory in OUT.suffix, with its own running log.
+     */
+    void batch_world();
+
     // the actual calculations
     void driver_run();
 };
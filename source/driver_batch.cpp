@@ -0,0 +1,127 @@
+#include "driver.h"
+#include "module_base/global_file.h"
+#include "module_base/global_function.h"
+#include "module_base/parallel_common.h"
+#include "module_base/timer.h"
+#include "module_base/tool_quit.h"
+#include "module_io/batch_stru.h"
+#include "module_io/print_info.h"
+#include "module_io/read_input.h"
+#include "module_parameter/parameter.h"
+
+#include <fstream>
+#include <utility>
+
+void Driver::batch_world()
+{
+    ModuleBase::TITLE("Driver", "batch_world");
+
+    // the parameters read from INPUT, some of them are autoset for each structure
+    const Input_para input0 = PARAM.inp;
+    const System_para sys0 = PARAM.globalv;
+    ModuleIO::Batch_Stru batch(PARAM.inp.stru_batch);
+
+    // the logs of reading INPUT are closed, each structure opens its own
+    ModuleBase::Global_File::close_all_log(GlobalV::MY_RANK, PARAM.inp.out_alllog, PARAM.inp.calculation);
+
+    // a failed structure is recorded and skipped, the batch goes on with the next one
+    ModuleBase::set_quit_throw(true);
+    std::vector<std::pair<std::string, std::string>> failed;
+    std::size_t nfound = 0;
+    std::size_t ib = 0;
+    while (true)
+    {
+        // look for new structures, more may come to the directory during the run
+        if (ib == batch.files.size() && (nfound == 0 || batch.from_dir()))
+        {
+            std::vector<std::string> new_files;
+            std::vector<std::string> new_names;
+            if (GlobalV::MY_RANK == 0)
+            {
+                batch.find(new_files, new_names);
+            }
+            int nnew = new_files.size();
+#ifdef __MPI
+            Parallel_Common::bcast_int(nnew);
+#endif
+            new_files.resize(nnew);
+            new_names.resize(nnew);
+#ifdef __MPI
+            if (nnew > 0)
+            {
+                Parallel_Common::bcast_string(new_files.data(), nnew);
+                Parallel_Common::bcast_string(new_names.data(), nnew);
+            }
+#endif
+            nfound += nnew;
+            for (int i = 0; i < nnew; ++i)
+            {
+                if (!batch.add(new_files[i], new_names[i]))
+                {
+                    failed.push_back(std::make_pair(new_files[i], "an earlier structure has the same name " + new_names[i]));
+                }
+            }
+        }
+        if (ib == batch.files.size())
+        {
+            break;
+        }
+
+        time_t time_start = std::time(nullptr);
+        ModuleBase::timer::timer_pool.clear();
+        ModuleBase::timer::start();
+
+        PARAM.set_batch_stru(input0, sys0, batch.files[ib], batch.names[ib]);
+        if (GlobalV::MY_RANK == 0)
+        {
+            std::cout << " BATCH STRUCTURE " << ib + 1 << " : " << batch.files[ib] << std::endl;
+        }
+
+        // the output directory and the logs of this structure
+        try
+        {
+            ModuleIO::ReadInput read_input(PARAM.globalv.myrank);
+            read_input.create_directory(PARAM);
+            this->print_start_info();
+            ModuleBase::GlobalFunc::OUT(GlobalV::ofs_running, "global_in_stru", PARAM.globalv.global_in_stru);
+            read_input.write_parameters(PARAM, PARAM.globalv.global_out_dir + PARAM.globalv.global_in_card);
+
+            this->atomic_world();
+
+            time_t time_finish = std::time(nullptr);
+            ModuleIO::print_time(time_start, time_finish);
+        }
+        catch (const ModuleBase::Quit_Error& e)
+        {
+            failed.push_back(std::make_pair(batch.files[ib], std::string(e.what())));
+        }
+        ModuleBase::Global_File::close_all_log(GlobalV::MY_RANK, PARAM.inp.out_alllog, PARAM.inp.calculation);
+        ++ib;
+    }
+    ModuleBase::set_quit_throw(false);
+
+    // the failed structures and their errors, in the order they are met
+    if (GlobalV::MY_RANK == 0 && !failed.empty())
+    {
+        std::ofstream ofs((sys0.global_out_dir + "batch_failed.log").c_str());
+        for (const auto& f: failed)
+        {
+            ofs << f.first << " : " << f.second << std::endl;
+        }
+    }
+
+    if (nfound == 0)
+    {
+        ModuleBase::WARNING_QUIT("Driver::batch_world", "no structure is found in stru_batch");
+    }
+    if (GlobalV::MY_RANK == 0)
+    {
+        std::cout << " BATCH FINISHED WITH " << nfound << " STRUCTURES, " << failed.size() << " FAILED";
+        if (!failed.empty())
+        {
+            std::cout << ", SEE " << sys0.global_out_dir << "batch_failed.log";
+        }
+        std::cout << std::endl;
+    }
+    return;
+}
@@ -1,9 +1,13 @@
 #include "driver.h"
+#include "module_base/memory.h"
+#include "module_base/tool_quit.h"
+#include <base/core/cpu_allocator.h>
 #include "module_cell/check_atomic_stru.h"
 #include "module_cell/module_neighbor/sltk_atom_arrange.h"
 #include "module_hamilt_pw/hamilt_pwdft/global.h"
 #include "module_parameter/parameter.h"
 #include "module_io/para_json.h"
+#include "module_io/output_queue.h"
 #include "module_io/print_info.h"
 #include "module_io/winput.h"
 #include "module_md/run_md.h"
@@ -49,46 +53,80 @@ void Driver::driver_run()
     ucell.setup_cell(PARAM.globalv.global_in_stru, GlobalV::ofs_running);
     Check_Atomic_Stru::check_atomic_stru(ucell, PARAM.inp.min_dist_coef);
 
+    // blocks of the container tensors are counted by the memory tracker if out_mem_track is set
+    ModuleBase::Memory::set_track(PARAM.inp.out_mem_track);
+    if (PARAM.inp.out_mem_track)
+    {
+        base::core::CPUAllocator::track_hook = [](const void* ptr, size_t size) {
+            if (size > 0)
+            {
+                ModuleBase::Memory::track_alloc(ptr, size);
+            }
+            else
+            {
+                ModuleBase::Memory::track_free(ptr);
+            }
+        };
+    }
+
+    // gathered outputs are written by an I/O thread if out_async is set
+    ModuleIO::Output_Queue::instance().set_capacity(static_cast<std::size_t>(PARAM.inp.out_async) << 20);
+
     //! 2: initialize the ESolver (depends on a set-up ucell after `setup_cell`)
     ModuleESolver::ESolver* p_esolver = ModuleESolver::init_esolver(PARAM.inp, ucell);
 
-    //! 3: initialize Esolver and fill json-structure
-    p_esolver->before_all_runners(ucell, PARAM.inp);
+    // in the batch mode a failed structure throws ModuleBase::Quit_Error, the ESolver is freed before
+    // the batch goes on with the next structure
+    try
+    {
+        //! 3: initialize Esolver and fill json-structure
+        {
+            ModuleBase::Memory::Scope scope("ESolver::before_all_runners");
+            p_esolver->before_all_runners(ucell, PARAM.inp);
+        }
 
-    // this Json part should be moved to before_all_runners, mohan 2024-05-12
+        // this Json part should be moved to before_all_runners, mohan 2024-05-12
 #ifdef __RAPIDJSON
-    Json::gen_stru_wrapper(&ucell);
+        Json::gen_stru_wrapper(&ucell);
 #endif
 
-    const std::string cal_type = PARAM.inp.calculation;
+        const std::string cal_type = PARAM.inp.calculation;
 
-    //! 4: different types of calculations
-    if (cal_type == "md")
-    {
-        Run_MD::md_line(ucell, p_esolver, PARAM);
-    }
-    else if (cal_type == "scf" || cal_type == "relax" || cal_type == "cell-relax" || cal_type == "nscf")
-    {
-        Relax_Driver rl_driver;
-        rl_driver.relax_driver(p_esolver, ucell);
-    }
-    else if (cal_type == "get_S")
-    {
-        p_esolver->runner(ucell, 0);
+        //! 4: different types of calculations
+        if (cal_type == "md")
+        {
+            Run_MD::md_line(ucell, p_esolver, PARAM);
+        }
+        else if (cal_type == "scf" || cal_type == "relax" || cal_type == "cell-relax" || cal_type == "nscf")
+        {
+            Relax_Driver rl_driver;
+            rl_driver.relax_driver(p_esolver, ucell);
+        }
+        else if (cal_type == "get_S")
+        {
+            p_esolver->runner(ucell, 0);
+        }
+        else
+        {
+            //! supported "other" functions:
+            //! get_pchg(LCAO),
+            //! test_memory(PW,LCAO),
+            //! test_neighbour(LCAO),
+            //! gen_bessel(PW), et al.
+            const int istep = 0;
+            p_esolver->others(ucell, istep);
+        }
     }
-    else
+    catch (const ModuleBase::Quit_Error&)
     {
-        //! supported "other" functions:
-        //! get_pchg(LCAO),
-        //! test_memory(PW,LCAO),
-        //! test_neighbour(LCAO),
-        //! gen_bessel(PW), et al.
-        const int istep = 0;
-        p_esolver->others(ucell, istep);
+        ModuleIO::Output_Queue::instance().finalize();
+        ModuleESolver::clean_esolver(p_esolver);
+        throw;
     }
 
     //! 5: clean up esolver
     p_esolver->after_all_runners(ucell);
+    ModuleIO::Output_Queue::instance().finalize();
 
     ModuleESolver::clean_esolver(p_esolver);
 
@@ -7,6 +7,8 @@
 #include "tool_quit.h"
 
 #include <cassert>
+#include <cstdlib>
+#include <vector>
 
 namespace ModuleBase
 {
@@ -624,6 +626,72 @@ void Chebyshev<REAL, Device>::tracepolyA(
     return;
 }
 
+template <typename REAL, typename Device>
+void Chebyshev<REAL, Device>::tracepolyAA(
+    std::function<void(std::complex<REAL>* in, std::complex<REAL>* out, const int)> funA,
+    std::complex<REAL>* wavein,
+    REAL* polygram,
+    const int N,
+    const int LDA,
+    const int m)
+{
+    std::complex<REAL>* arraynp1 = nullptr;
+    std::complex<REAL>* arrayn = nullptr;
+    std::complex<REAL>* arrayn_1 = nullptr;
+    assert(N >= 0 && LDA >= N);
+    int ndmxt;
+    if (m == 1)
+    {
+        ndmxt = N * m;
+    }
+    else
+    {
+        ndmxt = LDA * m;
+    }
+
+    // w_n = \sum_i Re(v_i^+ * T_n(A) * v_i), n = 0, 1, ..., 2*norder-2
+    std::vector<REAL> moment(2 * norder, 0);
+
+    resmem_complex_op()(this->ctx, arraynp1, ndmxt);
+    resmem_complex_op()(this->ctx, arrayn, ndmxt);
+    resmem_complex_op()(this->ctx, arrayn_1, ndmxt);
+
+    memcpy_complex_op()(this->ctx, this->ctx, arrayn_1, wavein, ndmxt);
+
+    moment[0] = this->ddot_real(arrayn_1, arrayn_1, N, LDA, m);
+    if (norder > 1)
+    {
+        funA(arrayn_1, arrayn, m);
+        moment[1] = this->ddot_real(arrayn_1, arrayn, N, LDA, m);
+        moment[2] = 2 * this->ddot_real(arrayn, arrayn, N, LDA, m) - moment[0];
+    }
+
+    // more than 1-st orders
+    for (int ior = 2; ior < norder; ++ior)
+    {
+        recurs_complex(funA, arraynp1, arrayn, arrayn_1, N, LDA, m);
+        moment[2 * ior - 1] = 2 * this->ddot_real(arrayn, arraynp1, N, LDA, m) - moment[1];
+        moment[2 * ior] = 2 * this->ddot_real(arraynp1, arraynp1, N, LDA, m) - moment[0];
+        std::complex<REAL>* tem = arrayn_1;
+        arrayn_1 = arrayn;
+        arrayn = arraynp1;
+        arraynp1 = tem;
+    }
+
+    for (int j = 0; j < norder; ++j)
+    {
+        for (int k = 0; k < norder; ++k)
+        {
+            polygram[j * norder + k] = (moment[j + k] + moment[std::abs(j - k)]) / 2;
+        }
+    }
+
+    delmem_complex_op()(this->ctx, arraynp1);
+    delmem_complex_op()(this->ctx, arrayn);
+    delmem_complex_op()(this->ctx, arrayn_1);
+    return;
+}
+
 template <typename REAL, typename Device>
 void Chebyshev<REAL, Device>::recurs_complex(
     std::function<void(std::complex<REAL>* in, std::complex<REAL>* out, const int)> funA,
@@ -66,6 +66,8 @@ class FFTW;
  *
  * 3. che.tracepolyA(hpsi, psi_in, npw, npwx, nbands)
  * 	  //calculate \sum_i^{nbands} <psi_i|T_n(H)|psi_i>
+ *    che.tracepolyAA(hpsi, psi_in, gram, npw, npwx, nbands)
+ * 	  //calculate \sum_i^{nbands} <psi_i|T_m(H)T_n(H)|psi_i>
  *
  * 4. che.calcoef_complex(expi);  //calculate C_n[exp(ix)]
  * 	  che.getpolyval(PI/4, T, norder);             //get T_n(pi/4)
@@ -140,6 +142,18 @@ class Chebyshev
                     const int LDA = 1,
                     const int m = 1);
 
+    // Gram matrix of all orders in v-represent: G_{jk} = \sum_i Re(v_{i,j}^+ * v_{i,k}), where v_{i,n} = T_n(A)v_i
+    // Since T_jT_k = (T_{j+k} + T_{|j-k|})/2, G_{jk} = (w_{j+k} + w_{|j-k|})/2 for Hermitian A, where w_n (n < 2*norder-1)
+    // are obtained by w_{2n} = 2*v_n^+ v_n - w_0 and w_{2n+1} = 2*v_n^+ v_{n+1} - w_1.
+    // It gives the same matrix as calpolyvec_complex + gemm, but only three vectors are stored.
+    // polygram: [CPU] norder * norder
+    void tracepolyAA(std::function<void(std::complex<REAL>* in, std::complex<REAL>* out, const int)> funA,
+                     std::complex<REAL>* wavein,
+                     REAL* polygram,
+                     const int N,
+                     const int LDA = 1,
+                     const int m = 1);
+
     // get T_n(x)
     void getpolyval(REAL x, REAL* polyval, const int N);
 
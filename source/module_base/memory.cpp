@@ -2,10 +2,18 @@
 // AUTHOR : mohan
 // DATE : 2008-11-18
 //==========================================================
+#include <algorithm>
 #include <cassert>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <unordered_map>
 #include "memory.h"
 #include "global_variable.h"
 #include "module_base/parallel_reduce.h"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 namespace ModuleBase
 {
@@ -24,6 +32,7 @@ int Memory::short_memory = sizeof(short); // 2.0 Byte
 int Memory::n_memory = 1000;
 int Memory::n_now = 0;
 bool Memory::init_flag = false;
+bool Memory::track_flag = false;
 
 #if defined(__CUDA) || defined(__ROCM)
 
@@ -434,68 +443,356 @@ void Memory::print_all(std::ofstream &ofs)
 	}
 
 #if defined(__CUDA) || defined(__ROCM)
-	if(!init_flag_gpu) 
+	if(init_flag_gpu)
 	{
-		delete[] print_flag;
-		return;
-	}
-
-	ofs <<"\n NAME-------------------------|GPU MEMORY(MB)----" << std::endl;
-	ofs <<std::setw(30)<< "total" << std::setw(15) <<std::setprecision(4)<< Memory::total_gpu << std::endl;
+		ofs <<"\n NAME-------------------------|GPU MEMORY(MB)----" << std::endl;
+		ofs <<std::setw(30)<< "total" << std::setw(15) <<std::setprecision(4)<< Memory::total_gpu << std::endl;
     
-    assert(n_memory>0);
+	    assert(n_memory>0);
 
-	bool *print_flag_gpu = new bool[n_memory];
+		bool *print_flag_gpu = new bool[n_memory];
 
-	for(int i=0; i<n_memory; i++) 
-	{
-		print_flag_gpu[i] = false;
-	}	
+		for(int i=0; i<n_memory; i++) 
+		{
+			print_flag_gpu[i] = false;
+		}	
 
-	for (int i=0; i<n_memory; i++)
-    {
+		for (int i=0; i<n_memory; i++)
+	    {
 #ifdef __MPI
-		Parallel_Reduce::reduce_all(consume_gpu[i]);
+			Parallel_Reduce::reduce_all(consume_gpu[i]);
 #endif
-	}
+		}
 
-	for (int i=0; i<n_memory; i++) // Xiaoyang fix memory record sum bug 2023/10/25
-	{
-		int k = 0;
-		double tmp = -1.0;
-		for(int j=0; j<n_memory; j++)
+		for (int i=0; i<n_memory; i++) // Xiaoyang fix memory record sum bug 2023/10/25
 		{
-			if(print_flag_gpu[j])
+			int k = 0;
+			double tmp = -1.0;
+			for(int j=0; j<n_memory; j++)
 			{
+				if(print_flag_gpu[j])
+				{
+					continue;
+				}
+				else if(tmp < consume_gpu[j])
+				{
+					k = j;
+					tmp = consume_gpu[j];
+				}
+			}
+			print_flag_gpu[k] = true;
+			if ( consume_gpu[k] < small )
+	        {
 				continue;
 			}
-			else if(tmp < consume_gpu[j])
+			else
 			{
-				k = j;
-				tmp = consume_gpu[j];
+				ofs << std::setw(30) << name_gpu[k]
+	            << std::setw(15) << consume_gpu[k] << std::endl;
 			}
-		}
-		print_flag_gpu[k] = true;
-		if ( consume_gpu[k] < small )
-        {
-			continue;
-		}
-		else
-		{
-			ofs << std::setw(30) << name_gpu[k]
-            << std::setw(15) << consume_gpu[k] << std::endl;
+
 		}
 
+		delete[] print_flag_gpu;
 	}
-
-	delete[] print_flag_gpu;
 #endif
 
 	ofs<<" -------------   < 1.0 MB has been ignored ----------------"<<std::endl;
     ofs<<" ----------------------------------------------------------"<<std::endl;
 
+	print_track(ofs);
+
 	delete[] print_flag; //mohan fix by valgrind at 2012-04-02
 	return;
 }
 
+
+namespace
+{
+// blocks allocated by a thread with a larger index are counted in the last one
+const int max_track_thread = 64;
+// closed scopes kept in the timeline, the later ones are dropped
+const size_t max_timeline = 10000;
+
+struct TrackBlock
+{
+	size_t bytes;
+	int scope;
+	int thread;
+};
+
+struct ScopeStat
+{
+	size_t live = 0;
+	size_t peak = 0;
+	size_t stage_peak = 0;
+	long count = 0;
+	std::vector<size_t> thread_live = std::vector<size_t>(max_track_thread, 0);
+	std::vector<size_t> thread_peak = std::vector<size_t>(max_track_thread, 0);
+};
+
+struct Tracker
+{
+	std::mutex mtx;
+	std::unordered_map<const void*, TrackBlock> blocks;
+	std::map<std::string, int> scope_index;
+	// scope 0 holds the blocks allocated outside of all scopes, and the total of the process in stage_peak
+	std::vector<std::string> tags = {"total"};
+	std::vector<ScopeStat> stats = std::vector<ScopeStat>(1);
+	std::vector<int> stack;
+	size_t live = 0;
+	std::vector<ModuleBase::Memory::TimelineEntry> timeline;
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+};
+
+// never destroyed, blocks may be freed by the destructors of static objects at exit
+Tracker& tracker()
+{
+	static Tracker* t = new Tracker;
+	return *t;
+}
+
+int track_thread()
+{
+#ifdef _OPENMP
+	return std::min(omp_get_thread_num(), max_track_thread - 1);
+#else
+	return 0;
+#endif
+}
+
+const double track_factor = 1.0 / 1024.0 / 1024.0;
+}
+
+void Memory::track_alloc(const void *ptr, const size_t bytes)
+{
+	if(!track_flag || ptr == nullptr || bytes == 0)
+	{
+		return;
+	}
+	Tracker& t = tracker();
+	const int thread = track_thread();
+	std::lock_guard<std::mutex> lock(t.mtx);
+	const int scope = t.stack.empty() ? 0 : t.stack.back();
+	t.blocks[ptr] = TrackBlock{bytes, scope, thread};
+	t.live += bytes;
+	t.stats[0].stage_peak = std::max(t.stats[0].stage_peak, t.live);
+	for(const int& s : t.stack)
+	{
+		t.stats[s].stage_peak = std::max(t.stats[s].stage_peak, t.live);
+	}
+	ScopeStat& stat = t.stats[scope];
+	stat.live += bytes;
+	stat.peak = std::max(stat.peak, stat.live);
+	stat.count++;
+	stat.thread_live[thread] += bytes;
+	stat.thread_peak[thread] = std::max(stat.thread_peak[thread], stat.thread_live[thread]);
+}
+
+void Memory::track_free(const void *ptr)
+{
+	if(!track_flag || ptr == nullptr)
+	{
+		return;
+	}
+	Tracker& t = tracker();
+	std::lock_guard<std::mutex> lock(t.mtx);
+	auto it = t.blocks.find(ptr);
+	if(it == t.blocks.end())
+	{
+		return;
+	}
+	const TrackBlock& block = it->second;
+	ScopeStat& stat = t.stats[block.scope];
+	stat.live -= block.bytes;
+	stat.thread_live[block.thread] -= block.bytes;
+	t.live -= block.bytes;
+	t.blocks.erase(it);
+}
+
+void Memory::begin_scope(const std::string &tag)
+{
+	if(!track_flag)
+	{
+		return;
+	}
+	Tracker& t = tracker();
+	std::lock_guard<std::mutex> lock(t.mtx);
+	auto it = t.scope_index.find(tag);
+	int scope = 0;
+	if(it == t.scope_index.end())
+	{
+		scope = t.tags.size();
+		t.scope_index[tag] = scope;
+		t.tags.push_back(tag);
+		t.stats.emplace_back();
+	}
+	else
+	{
+		scope = it->second;
+	}
+	t.stats[scope].stage_peak = std::max(t.stats[scope].stage_peak, t.live);
+	t.stack.push_back(scope);
+}
+
+void Memory::end_scope()
+{
+	if(!track_flag)
+	{
+		return;
+	}
+	Tracker& t = tracker();
+	std::lock_guard<std::mutex> lock(t.mtx);
+	if(t.stack.empty())
+	{
+		return;
+	}
+	const int scope = t.stack.back();
+	t.stack.pop_back();
+	if(t.timeline.size() < max_timeline)
+	{
+		TimelineEntry entry;
+		entry.tag = t.tags[scope];
+		entry.time = std::chrono::duration<double>(std::chrono::steady_clock::now() - t.start).count();
+		entry.live = t.live * track_factor;
+		entry.stage_peak = t.stats[scope].stage_peak * track_factor;
+		t.timeline.push_back(entry);
+	}
+}
+
+std::vector<Memory::TimelineEntry> Memory::get_timeline()
+{
+	Tracker& t = tracker();
+	std::lock_guard<std::mutex> lock(t.mtx);
+	return t.timeline;
+}
+
+std::vector<Memory::TrackRecord> Memory::reduce_track()
+{
+	Tracker& t = tracker();
+	std::vector<std::string> tags;
+	std::vector<double> peak;
+	std::vector<double> stage_peak;
+	std::vector<double> thread_peak;
+	std::vector<double> count;
+	{
+		std::lock_guard<std::mutex> lock(t.mtx);
+		tags = t.tags;
+	}
+#ifdef __MPI
+	// the scopes of rank 0, a scope opened only on other ranks is not reported
+	int size = 0;
+	std::string joined;
+	for(const std::string& tag : tags)
+	{
+		joined += tag + '\n';
+	}
+	size = joined.size();
+	MPI_Bcast(&size, 1, MPI_INT, 0, MPI_COMM_WORLD);
+	joined.resize(size);
+	MPI_Bcast(&joined[0], size, MPI_CHAR, 0, MPI_COMM_WORLD);
+	tags.clear();
+	size_t begin = 0;
+	for(size_t end = joined.find('\n'); end != std::string::npos; end = joined.find('\n', begin))
+	{
+		tags.push_back(joined.substr(begin, end - begin));
+		begin = end + 1;
+	}
+#endif
+	const int ntag = tags.size();
+	{
+		std::lock_guard<std::mutex> lock(t.mtx);
+		for(int i = 0; i < ntag; ++i)
+		{
+			int scope = -1;
+			if(i == 0)
+			{
+				scope = 0;
+			}
+			else
+			{
+				auto it = t.scope_index.find(tags[i]);
+				scope = (it == t.scope_index.end()) ? -1 : it->second;
+			}
+			if(scope < 0)
+			{
+				peak.push_back(0.0);
+				stage_peak.push_back(0.0);
+				thread_peak.push_back(0.0);
+				count.push_back(0.0);
+				continue;
+			}
+			const ScopeStat& stat = t.stats[scope];
+			// the total of the process is its peak of all tracked blocks
+			peak.push_back((i == 0 ? stat.stage_peak : stat.peak) * track_factor);
+			stage_peak.push_back(stat.stage_peak * track_factor);
+			// the total takes the largest thread peak and the allocations of all scopes
+			const int first = (i == 0) ? 0 : scope;
+			const int last = (i == 0) ? static_cast<int>(t.stats.size()) : scope + 1;
+			size_t thread_max = 0;
+			long n = 0;
+			for(int s = first; s < last; ++s)
+			{
+				thread_max = std::max(thread_max,
+					*std::max_element(t.stats[s].thread_peak.begin(), t.stats[s].thread_peak.end()));
+				n += t.stats[s].count;
+			}
+			thread_peak.push_back(thread_max * track_factor);
+			count.push_back(n);
+		}
+	}
+
+	std::vector<double> peak_min = peak;
+	std::vector<double> peak_max = peak;
+	std::vector<double> peak_sum = peak;
+	int nproc = 1;
+#ifdef __MPI
+	MPI_Comm_size(MPI_COMM_WORLD, &nproc);
+	MPI_Allreduce(peak.data(), peak_min.data(), ntag, MPI_DOUBLE, MPI_MIN, MPI_COMM_WORLD);
+	MPI_Allreduce(peak.data(), peak_max.data(), ntag, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+	MPI_Allreduce(peak.data(), peak_sum.data(), ntag, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+	MPI_Allreduce(MPI_IN_PLACE, stage_peak.data(), ntag, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+	MPI_Allreduce(MPI_IN_PLACE, thread_peak.data(), ntag, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+	MPI_Allreduce(MPI_IN_PLACE, count.data(), ntag, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+#endif
+
+	std::vector<TrackRecord> records(ntag);
+	for(int i = 0; i < ntag; ++i)
+	{
+		records[i].tag = tags[i];
+		records[i].peak_min = peak_min[i];
+		records[i].peak_avg = peak_sum[i] / nproc;
+		records[i].peak_max = peak_max[i];
+		records[i].stage_peak_max = stage_peak[i];
+		records[i].thread_peak_max = thread_peak[i];
+		records[i].count = static_cast<long>(count[i]);
+	}
+	return records;
+}
+
+void Memory::print_track(std::ofstream &ofs)
+{
+	if(!track_flag)
+	{
+		return;
+	}
+	const std::vector<TrackRecord> records = reduce_track();
+	ofs << "\n TRACKED ALLOCATIONS----------|PEAK(MB) MIN/AVG/MAX over ranks------|STAGE PEAK(MB)|THREAD PEAK(MB)|ALLOCATIONS" << std::endl;
+	for(const TrackRecord& r : records)
+	{
+		if(r.count == 0)
+		{
+			continue;
+		}
+		ofs << std::setw(30) << r.tag
+			<< std::setw(12) << std::setprecision(4) << r.peak_min
+			<< std::setw(12) << r.peak_avg
+			<< std::setw(12) << r.peak_max
+			<< std::setw(15) << r.stage_peak_max
+			<< std::setw(16) << r.thread_peak_max
+			<< std::setw(12) << r.count << std::endl;
+	}
+	ofs << " ----------------------------------------------------------" << std::endl;
+}
+
 }
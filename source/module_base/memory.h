@@ -1,8 +1,10 @@
 #ifndef MEMORY_H
 #define MEMORY_H
 
+#include <cstddef>
 #include <fstream>
 #include <string>
+#include <vector>
 
 namespace ModuleBase
 {
@@ -108,7 +110,96 @@ class Memory
      */
     static double calculate_mem(const long &n, const std::string &type);
 
+    /**
+     * @brief Switch the tracking of track_alloc(), track_free() and Scope on or off, off by default
+     * Set by the input out_mem_track before the ESolver is made, and kept the same on all MPI ranks.
+     */
+    static void set_track(const bool flag)
+    {
+        track_flag = flag;
+    }
+
+    static bool get_track()
+    {
+        return track_flag;
+    }
+
+    /**
+     * @brief Track a block allocated by resize_memory_op, the container allocator or HContainer
+     * The block is counted in the innermost open Scope, and removed by track_free().
+     * Thread safe, may be called inside OpenMP regions. Returns at once if the tracking is off.
+     *
+     * @param ptr The address of the block
+     * @param bytes The size of the block
+     */
+    static void track_alloc(const void *ptr, const size_t bytes);
+
+    /**
+     * @brief Remove a block tracked by track_alloc(), blocks not tracked are ignored
+     *
+     * @param ptr The address of the block
+     */
+    static void track_free(const void *ptr);
+
+    /// tagged scope open for the life of the object, the tracked blocks allocated meanwhile are counted in it
+    class Scope
+    {
+      public:
+        /// @param tag The name of the scope, such as "ESolver_KS::hamilt2density"
+        explicit Scope(const std::string &tag)
+        {
+            begin_scope(tag);
+        }
+        ~Scope()
+        {
+            end_scope();
+        }
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    };
+
+    /// statistics of one scope over all MPI ranks, in MB
+    struct TrackRecord
+    {
+        std::string tag;
+        double peak_min = 0.0; // peak of the live blocks allocated in the scope
+        double peak_avg = 0.0;
+        double peak_max = 0.0;
+        double stage_peak_max = 0.0; // peak of all live tracked blocks of the process while the scope is open
+        double thread_peak_max = 0.0; // peak of the live blocks allocated by one thread in the scope
+        long count = 0; // number of allocations of all ranks
+    };
+
+    /// one closed scope of the timeline of this rank, in seconds and MB
+    struct TimelineEntry
+    {
+        std::string tag;
+        double time = 0.0;
+        double live = 0.0;
+        double stage_peak = 0.0;
+    };
+
+    /**
+     * @brief Reduce the statistics of all scopes over the MPI ranks, must be called by all ranks
+     * The first record is "total" for the whole process, followed by the scopes of rank 0.
+     */
+    static std::vector<TrackRecord> reduce_track();
+
+    /// timeline of the scopes closed on this rank
+    static std::vector<TimelineEntry> get_timeline();
+
+    /// print the statistics of reduce_track() if the tracking is on, must be called by all ranks
+    static void print_track(std::ofstream &ofs);
+
   private:
+    static bool track_flag;
+
+    /// open a tagged scope, only used by Scope
+    static void begin_scope(const std::string &tag);
+
+    /// close the innermost scope and add it to the timeline, only used by Scope
+    static void end_scope();
+
     static double total;
     static std::string *name;
     static std::string *class_name;
@@ -3,10 +3,16 @@
 namespace base {
 namespace core {
 
+CPUAllocator::TrackHook CPUAllocator::track_hook = nullptr;
+
 // Allocate a block of CPU memory with the given size and default alignment.
 void *CPUAllocator::allocate(size_t size) {
     this->allocated_size_ = size;
-    return ::operator new(size);
+    void *ptr = ::operator new(size);
+    if (track_hook != nullptr) {
+        track_hook(ptr, size);
+    }
+    return ptr;
 }
 
 // Allocate a block of CPU memory with the given size and alignment.
@@ -16,12 +22,18 @@ void *CPUAllocator::allocate(size_t size, size_t alignment) {
     if (posix_memalign(&ptr, alignment, size) != 0) {
         ptr = nullptr;
     }
+    if (track_hook != nullptr) {
+        track_hook(ptr, size);
+    }
     return ptr;
 }
 
 // Free a block of CPU memory that was previously allocated by this allocator.
 void CPUAllocator::free(void *ptr) {
     this->allocated_size_ = 0;
+    if (track_hook != nullptr) {
+        track_hook(ptr, 0);
+    }
     ::operator delete(ptr);
 }
 
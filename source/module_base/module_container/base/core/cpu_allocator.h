@@ -49,6 +49,15 @@ public:
      */
     container::DeviceType GetDeviceType() override;
 
+    /**
+     * @brief Called with every block allocated (size > 0) or freed (size 0) by the CPU allocators.
+     *
+     * Used by the memory statistics of the application, nullptr by default so that the container
+     * library does not depend on them.
+     */
+    using TrackHook = void (*)(const void* ptr, size_t size);
+    static TrackHook track_hook;
+
 };
 
 } // namespace core
@@ -22,9 +22,11 @@ struct resize_memory_op<FPTYPE, base_device::DEVICE_CPU>
     {
         if (arr != nullptr)
         {
+            ModuleBase::Memory::track_free(arr);
             free(arr);
         }
         arr = (FPTYPE*)malloc(sizeof(FPTYPE) * size);
+        ModuleBase::Memory::track_alloc(arr, sizeof(FPTYPE) * size);
         std::string record_string;
         if (record_in != nullptr)
         {
@@ -96,6 +98,7 @@ struct delete_memory_op<FPTYPE, base_device::DEVICE_CPU>
 {
     void operator()(const base_device::DEVICE_CPU* dev, FPTYPE* arr)
     {
+        ModuleBase::Memory::track_free(arr);
         free(arr);
     }
 };
@@ -96,13 +96,17 @@ void Broyden_Mixing::tem_push_data(Mixing_Data& mdata,
 };
 
 template void Broyden_Mixing::tem_cal_coef(const Mixing_Data& mdata,
-                                           std::function<double(double*, double*)> inner_product);
+                                           std::function<double(double*, double*)> inner_product,
+                                           std::function<void(double*, const int)> reduce);
 template void Broyden_Mixing::tem_cal_coef(
     const Mixing_Data& mdata,
-    std::function<double(std::complex<double>*, std::complex<double>*)> inner_product);
+    std::function<double(std::complex<double>*, std::complex<double>*)> inner_product,
+    std::function<void(double*, const int)> reduce);
 
 template <class FPTYPE>
-void Broyden_Mixing::tem_cal_coef(const Mixing_Data& mdata, std::function<double(FPTYPE*, FPTYPE*)> inner_product)
+void Broyden_Mixing::tem_cal_coef(const Mixing_Data& mdata,
+                                  std::function<double(FPTYPE*, FPTYPE*)> inner_product,
+                                  std::function<void(double*, const int)> reduce)
 {
     ModuleBase::TITLE("Charge_Mixing", "Simplified_Broyden_mixing");
     ModuleBase::timer::tick("Charge", "Broyden_mixing");
@@ -115,26 +119,31 @@ void Broyden_Mixing::tem_cal_coef(const Mixing_Data& mdata, std::function<double
     FPTYPE* FP_F = static_cast<FPTYPE*>(F);
     if (ndim_cal_dF > 0)
     {
-        ModuleBase::matrix beta_tmp(ndim_cal_dF, ndim_cal_dF);
-        // beta(i, j) = <dF_i, dF_j>
+        // only dF_{start_dF} changed since the last step: the new row of beta(i, j) = <dF_i, dF_j>
+        // and c_i = <dF_i, F> are evaluated together, with one reduction for all of them
+        std::vector<double> products(2 * ndim_cal_dF);
+        FPTYPE* dFs = FP_dF + start_dF * length;
         for (int i = 0; i < ndim_cal_dF; ++i)
         {
             FPTYPE* dFi = FP_dF + i * length;
-            for (int j = i; j < ndim_cal_dF; ++j)
+            products[i] = inner_product(dFi, dFs);
+            products[ndim_cal_dF + i] = inner_product(dFi, FP_F);
+        }
+        if (reduce != nullptr)
+        {
+            reduce(products.data(), 2 * ndim_cal_dF);
+        }
+        for (int i = 0; i < ndim_cal_dF; ++i)
+        {
+            beta(i, start_dF) = beta(start_dF, i) = products[i];
+        }
+
+        ModuleBase::matrix beta_tmp(ndim_cal_dF, ndim_cal_dF);
+        for (int i = 0; i < ndim_cal_dF; ++i)
+        {
+            for (int j = 0; j < ndim_cal_dF; ++j)
             {
-                if (i != start_dF && j != start_dF)
-                {
-                    beta_tmp(i, j) = beta(i, j);
-                }
-                else
-                {
-                    FPTYPE* dFj = FP_dF + j * length;
-                    beta(i, j) = beta_tmp(i, j) = inner_product(dFi, dFj);
-                }
-                if (j != i)
-                {
-                    beta_tmp(j, i) = beta_tmp(i, j);
-                }
+                beta_tmp(i, j) = beta(i, j);
             }
         }
         double* work = new double[ndim_cal_dF];   // workspace
@@ -144,12 +153,7 @@ void Broyden_Mixing::tem_cal_coef(const Mixing_Data& mdata, std::function<double
         int m = 1;
         // gamma means the coeficients for mixing
         // but now gamma store <dFi|Fm>, namely c
-        std::vector<double> gamma(ndim_cal_dF);
-        for (int i = 0; i < ndim_cal_dF; ++i)
-        {
-            FPTYPE* dFi = FP_dF + i * length;
-            gamma[i] = inner_product(dFi, FP_F);
-        }
+        std::vector<double> gamma(products.begin() + ndim_cal_dF, products.end());
         // solve aG = c 
         dsysv_(&uu, &ndim_cal_dF, &m, beta_tmp.c, &ndim_cal_dF, iwork, gamma.data(), &ndim_cal_dF, work, &ndim_cal_dF, &info);
         if (info != 0)
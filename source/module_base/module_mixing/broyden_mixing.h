@@ -93,12 +93,32 @@ class Broyden_Mixing : public Mixing
      */
     virtual void cal_coef(const Mixing_Data& mdata, std::function<double(double*, double*)> inner_product) override
     {
-        tem_cal_coef(mdata, inner_product);
+        tem_cal_coef(mdata, inner_product, nullptr);
     }
     virtual void cal_coef(const Mixing_Data& mdata,
                           std::function<double(std::complex<double>*, std::complex<double>*)> inner_product) override
     {
-        tem_cal_coef(mdata, inner_product);
+        tem_cal_coef(mdata, inner_product, nullptr);
+    }
+
+    /**
+     * @brief calculate coeficients for mixing, the new row of beta and c are summed over processes at once
+     *
+     * @param mdata Mixing_Data
+     * @param inner_product_local pointer to the inner dot function without the sum over processes
+     * @param reduce (double* sums, int n) sum n local inner products over processes
+     */
+    virtual void cal_coef(const Mixing_Data& mdata,
+                          std::function<double(double*, double*)> inner_product_local,
+                          std::function<void(double*, const int)> reduce) override
+    {
+        tem_cal_coef(mdata, inner_product_local, reduce);
+    }
+    virtual void cal_coef(const Mixing_Data& mdata,
+                          std::function<double(std::complex<double>*, std::complex<double>*)> inner_product_local,
+                          std::function<void(double*, const int)> reduce) override
+    {
+        tem_cal_coef(mdata, inner_product_local, reduce);
     }
 
   private:
@@ -123,12 +143,17 @@ class Broyden_Mixing : public Mixing
 
     /**
      * @brief calculate coeficients for mixing
+     *        Only the row of beta belonging to the latest dF and c{k} = <dF{k}, F{m}> are new in each step,
+     *        i.e. 2*ndim inner products, which are summed over processes in a single call of reduce.
      *
      * @param mdata Mixing_Data
      * @param inner_product pointer to the inner dot function
+     * @param reduce sum the local inner products over processes, nullptr if inner_product already does it
      */
     template <class FPTYPE>
-    void tem_cal_coef(const Mixing_Data& mdata, std::function<double(FPTYPE*, FPTYPE*)> inner_product);
+    void tem_cal_coef(const Mixing_Data& mdata,
+                      std::function<double(FPTYPE*, FPTYPE*)> inner_product,
+                      std::function<void(double*, const int)> reduce);
 
   private:
     // F = data_out - data_in
@@ -137,7 +162,7 @@ class Broyden_Mixing : public Mixing
     void* dF = nullptr;
     // binded mixing_data
     Mixing_Data* address = nullptr;
-    // beta_ij = <dF_i, dF_j>
+    // beta_ij = <dF_i, dF_j>, kept between steps
     ModuleBase::matrix beta;
     // mixing_ndim = data_ndim - 1
     int mixing_ndim = -1;
@@ -54,6 +54,28 @@ void Mixing::push_data(Mixing_Data& mdata,
     return;
 }
 
+void Mixing::cal_coef(const Mixing_Data& mdata,
+                      std::function<double(double*, double*)> inner_product_local,
+                      std::function<void(double*, const int)> reduce)
+{
+    this->cal_coef(mdata, [&inner_product_local, &reduce](double* x1, double* x2) {
+        double sum = inner_product_local(x1, x2);
+        reduce(&sum, 1);
+        return sum;
+    });
+}
+
+void Mixing::cal_coef(const Mixing_Data& mdata,
+                      std::function<double(std::complex<double>*, std::complex<double>*)> inner_product_local,
+                      std::function<void(double*, const int)> reduce)
+{
+    this->cal_coef(mdata, [&inner_product_local, &reduce](std::complex<double>* x1, std::complex<double>* x2) {
+        double sum = inner_product_local(x1, x2);
+        reduce(&sum, 1);
+        return sum;
+    });
+}
+
 void Mixing::mix_data(const Mixing_Data& mdata, double* data_mix)
 {
     if (mdata.length <= 0)
@@ -93,6 +93,22 @@ class Mixing
                           std::function<double(std::complex<double>*, std::complex<double>*)> inner_product)
         = 0;
 
+    /**
+     * @brief calculate coeficients for mixing with inner products whose sum over processes is deferred
+     *        The default calls inner_product_local and reduce for each inner product; methods needing
+     *        several inner products per step may sum all of them in one call of reduce.
+     *
+     * @param mdata Mixing_Data
+     * @param inner_product_local pointer to the inner dot function without the sum over processes
+     * @param reduce (double* sums, int n) sum n local inner products over processes
+     */
+    virtual void cal_coef(const Mixing_Data& mdata,
+                          std::function<double(double*, double*)> inner_product_local,
+                          std::function<void(double*, const int)> reduce);
+    virtual void cal_coef(const Mixing_Data& mdata,
+                          std::function<double(std::complex<double>*, std::complex<double>*)> inner_product_local,
+                          std::function<void(double*, const int)> reduce);
+
     /**
      * @brief calculate the mixing data
      *
@@ -61,6 +61,9 @@ class Plain_Mixing : public Mixing
         this->tem_push_data(mdata, data_in, data_out, screen, mix, need_calcoef);
     };
 
+    // the overloads with a deferred reduce are kept from Mixing
+    using Mixing::cal_coef;
+
     /**
      * @brief calculate coeficients for mixing
      *
@@ -30,6 +30,7 @@ class Mixing_Test : public testing::Test
     double thr = 1e-8;
     int niter = 0;
     int maxiter = 10;
+    int nreduce = 0;
     std::vector<double> xd_ref = {0.0, 0.0, 0.0};
     std::vector<std::complex<double>> xc_ref = {
         {0.0, 1.0},
@@ -69,7 +70,7 @@ class Mixing_Test : public testing::Test
      *         [x3]   [-6/12 -3/12  36/12][x3]
      */
     template <typename FPTYPE>
-    void solve_linear_eq(FPTYPE* x_in, FPTYPE* x_out, bool diff_beta = false)
+    void solve_linear_eq(FPTYPE* x_in, FPTYPE* x_out, bool diff_beta = false, bool deferred_reduce = false)
     {
         this->mixing->init_mixing_data(xdata, 3, sizeof(FPTYPE));
         std::vector<FPTYPE> delta_x(3);
@@ -120,7 +121,17 @@ class Mixing_Test : public testing::Test
                 this->mixing->push_data(this->xdata, x_in, x_out, screen, true);
             }
 
-            this->mixing->cal_coef(this->xdata, inner_product);
+            if (deferred_reduce)
+            {
+                // a serial stand-in for the sum over processes, only counts the calls
+                this->mixing->cal_coef(this->xdata, inner_product, [this](double* sums, const int n) {
+                    ++this->nreduce;
+                });
+            }
+            else
+            {
+                this->mixing->cal_coef(this->xdata, inner_product);
+            }
 
             this->mixing->mix_data(this->xdata, x_in);
         }
@@ -198,6 +209,60 @@ TEST_F(Mixing_Test, BroydenSolveLinearEq)
     clear();
 }
 
+TEST_F(Mixing_Test, BroydenDeferredReduce)
+{
+#ifdef _OPENMP
+    omp_set_num_threads(1);
+#endif
+    // same path as BroydenSolveLinearEq, with a single reduction for all inner products of each step
+    init_method("broyden");
+    std::vector<double> x_in = xd_ref;
+    std::vector<double> x_out(3);
+    nreduce = 0;
+    solve_linear_eq<double>(x_in.data(), x_out.data(), true, true);
+    EXPECT_NEAR(x_out[0], 3.0, DOUBLETHRESHOLD);
+    EXPECT_NEAR(x_out[1], 2.0, DOUBLETHRESHOLD);
+    EXPECT_NEAR(x_out[2], 1.0, DOUBLETHRESHOLD);
+    ASSERT_EQ(niter, 5);
+    // no inner products in the first mixing step
+    EXPECT_EQ(nreduce, niter - 2);
+
+    this->mixing->reset();
+    xdata.reset();
+
+    std::vector<std::complex<double>> xc_in = xc_ref;
+    std::vector<std::complex<double>> xc_out(3);
+    nreduce = 0;
+    solve_linear_eq<std::complex<double>>(xc_in.data(), xc_out.data(), true, true);
+    EXPECT_NEAR(xc_out[0].real(), 3.0, DOUBLETHRESHOLD);
+    EXPECT_NEAR(xc_out[1].real(), 2.0, DOUBLETHRESHOLD);
+    EXPECT_NEAR(xc_out[2].real(), 1.0, DOUBLETHRESHOLD);
+    ASSERT_EQ(niter, 5);
+    EXPECT_EQ(nreduce, niter - 2);
+
+    clear();
+}
+
+TEST_F(Mixing_Test, PulayDeferredReduce)
+{
+#ifdef _OPENMP
+    omp_set_num_threads(1);
+#endif
+    // the default cal_coef with deferred reduction reduces every inner product on its own
+    init_method("pulay");
+    std::vector<double> x_in = xd_ref;
+    std::vector<double> x_out(3);
+    nreduce = 0;
+    solve_linear_eq<double>(x_in.data(), x_out.data(), false, true);
+    EXPECT_NEAR(x_out[0], 2.9999959638248037, DOUBLETHRESHOLD);
+    EXPECT_NEAR(x_out[1], 2.0000002552633349, DOUBLETHRESHOLD);
+    EXPECT_NEAR(x_out[2], 1.0000019542717642, DOUBLETHRESHOLD);
+    ASSERT_EQ(niter, 6);
+    EXPECT_GT(nreduce, niter - 2);
+
+    clear();
+}
+
 TEST_F(Mixing_Test, PulaySolveLinearEq)
 {
 #ifdef _OPENMP
@@ -34,5 +34,21 @@ void reduce_data(float* object, const int& n, const MPI_Comm& comm)
 {
     MPI_Allreduce(MPI_IN_PLACE, object, n, MPI_FLOAT, MPI_SUM, comm);
 }
+void gatherv_data(std::complex<double>* object, const int* counts, const int* displs, const MPI_Comm& comm)
+{
+    MPI_Allgatherv(MPI_IN_PLACE, 0, MPI_DATATYPE_NULL, object, counts, displs, MPI_DOUBLE_COMPLEX, comm);
+}
+void gatherv_data(std::complex<float>* object, const int* counts, const int* displs, const MPI_Comm& comm)
+{
+    MPI_Allgatherv(MPI_IN_PLACE, 0, MPI_DATATYPE_NULL, object, counts, displs, MPI_COMPLEX, comm);
+}
+void gatherv_data(double* object, const int* counts, const int* displs, const MPI_Comm& comm)
+{
+    MPI_Allgatherv(MPI_IN_PLACE, 0, MPI_DATATYPE_NULL, object, counts, displs, MPI_DOUBLE, comm);
+}
+void gatherv_data(float* object, const int* counts, const int* displs, const MPI_Comm& comm)
+{
+    MPI_Allgatherv(MPI_IN_PLACE, 0, MPI_DATATYPE_NULL, object, counts, displs, MPI_FLOAT, comm);
+}
 }
 #endif
\ No newline at end of file
@@ -15,6 +15,10 @@ void reduce_data(std::complex<double>* object, const int& n, const MPI_Comm& com
 void reduce_data(std::complex<float>* object, const int& n, const MPI_Comm& comm);
 void reduce_data(double* object, const int& n, const MPI_Comm& comm);
 void reduce_data(float* object, const int& n, const MPI_Comm& comm);
+void gatherv_data(std::complex<double>* object, const int* counts, const int* displs, const MPI_Comm& comm);
+void gatherv_data(std::complex<float>* object, const int* counts, const int* displs, const MPI_Comm& comm);
+void gatherv_data(double* object, const int* counts, const int* displs, const MPI_Comm& comm);
+void gatherv_data(float* object, const int* counts, const int* displs, const MPI_Comm& comm);
 
 /**
  * @brief bcast data in Device
@@ -101,6 +105,62 @@ void reduce_dev(const Device* ctx, T* object, const int& n, const MPI_Comm& comm
     return;
 }
 
+/**
+ * @brief allgatherv data in Device, in place
+ *
+ * @tparam T: float, double, std::complex<float>, std::complex<double>
+ * @tparam Device
+ * @param ctx Device ctx
+ * @param object arrays in Device, each process owns the part [displs[rank], displs[rank] + counts[rank])
+ * @param n the size of arrays
+ * @param counts number of elements owned by each process
+ * @param displs offsets of the parts owned by each process
+ * @param comm MPI_Comm
+ * @param tmp_space tmp space in CPU
+ */
+template <typename T, typename Device>
+void gatherv_dev(const Device* ctx,
+                 T* object,
+                 const int& n,
+                 const int* counts,
+                 const int* displs,
+                 const MPI_Comm& comm,
+                 T* tmp_space = nullptr)
+{
+    const base_device::DEVICE_CPU* cpu_ctx = {};
+    T* object_cpu = nullptr;
+    bool alloc = false;
+    if (base_device::get_device_type<Device>(ctx) == base_device::GpuDevice)
+    {
+        if(tmp_space == nullptr)
+        {
+            base_device::memory::resize_memory_op<T, base_device::DEVICE_CPU>()(cpu_ctx, object_cpu, n);
+            alloc = true;
+        }
+        else
+        {
+            object_cpu = tmp_space;
+        }
+        base_device::memory::synchronize_memory_op<T, base_device::DEVICE_CPU, Device>()(cpu_ctx, ctx, object_cpu, object, n);
+    }
+    else
+    {
+        object_cpu = object;
+    }
+
+    gatherv_data(object_cpu, counts, displs, comm);
+
+    if (base_device::get_device_type<Device>(ctx) == base_device::GpuDevice)
+    {
+        base_device::memory::synchronize_memory_op<T, Device, base_device::DEVICE_CPU>()(ctx, cpu_ctx, object, object_cpu, n);
+        if(alloc)
+        {
+            base_device::memory::delete_memory_op<T, base_device::DEVICE_CPU>()(cpu_ctx, object_cpu);
+        }
+    }
+    return;
+}
+
 }
     
 
@@ -222,6 +222,13 @@ void SphericalBesselTransformer::Impl::radrfft(
 
     _rfft_prepare(2 * n);
 
+    // in[i] vanishes for i > i_last, which is the case when F(x) is zero-padded to a large cutoff
+    int i_last = n;
+    while (i_last > 0 && in[i_last] == 0.0)
+    {
+        --i_last;
+    }
+
     bool is_imag = true;
     int sign = -1;
     for (int m = 0; m <= l; ++m)
@@ -230,8 +237,8 @@ void SphericalBesselTransformer::Impl::radrfft(
         // m odd  --> cos; f[2*n-i] = +f[i]; out += +real(rfft(f)) / y^(l+1-m)
         const double coef = reinterpret_cast<double(&)[2]>(c[idx(l,m)])[is_imag];
 
-        f_[0] = f_[n] = 0.0;
-        for (int i = 1; i != n; ++i)
+        std::fill(f_, f_ + 2 * n, 0.0);
+        for (int i = 1; i <= std::min(i_last, n - 1); ++i)
         {
             f_[i] = pref * coef * in[i] * std::pow(i * dx, m + 1 - l - p);
             f_[2 * n - i] = sign * f_[i];
@@ -254,7 +261,7 @@ void SphericalBesselTransformer::Impl::radrfft(
     // note that only the zeroth order spherical Bessel function is nonzero at 0
     if (l == 0)
     {
-        for (int i = 0; i <= n; ++i)
+        for (int i = 0; i <= i_last; ++i)
         {
             tmp[0] += 2.0 * pref * in[i] * std::pow(i*dx, 2-p); // p <= 2 is required here
         }
@@ -265,16 +272,22 @@ void SphericalBesselTransformer::Impl::radrfft(
     const int n_direct = (l == 0) ? 0 : static_cast<int>(ngrid * std::pow(1e-8, 1.0/l));
     if (n_direct > 0)
     {
-        std::vector<double> buffer(ngrid + n_direct);
+        // the trailing zeros are skipped; at least 4 of them and the parity of ngrid are kept,
+        // so that Simpson's rule gives the same result as on the whole grid
+        int ngrid_in = i_last + 5;
+        ngrid_in += (ngrid - ngrid_in) % 2;
+        ngrid_in = std::min(ngrid_in, ngrid);
+
+        std::vector<double> buffer(ngrid_in + n_direct);
         double* grid_in = buffer.data();
-        double* grid_out = grid_in + ngrid;
+        double* grid_out = grid_in + ngrid_in;
 
-        std::for_each(grid_in, grid_in + ngrid,
+        std::for_each(grid_in, grid_in + ngrid_in,
             [&](double& x) { x = (&x - grid_in) * dx; });
         std::for_each(grid_out, grid_out + n_direct,
             [&](double& y) { y = ((&y - grid_out) + 1) * dy; });
 
-        direct(l, ngrid, grid_in, in, n_direct, grid_out, &tmp[1], p);
+        direct(l, ngrid_in, grid_in, in, n_direct, grid_out, &tmp[1], p);
     }
 
     std::copy(tmp.begin(), tmp.end(), out);
@@ -0,0 +1,137 @@
+#include "table_cache.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace ModuleBase
+{
+
+namespace
+{
+const char magic[8] = {'A', 'B', 'A', 'C', 'U', 'S', 'T', 'B'};
+} // namespace
+
+Table_Cache::Table_Cache(const std::string& kind_in) : kind(kind_in)
+{
+    this->add_bytes(kind.data(), kind.size());
+    const int ver = version;
+    this->add_bytes(&ver, sizeof(int));
+}
+
+void Table_Cache::add_bytes(const void* data, const std::size_t nbytes)
+{
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (std::size_t i = 0; i < nbytes; ++i)
+    {
+        this->hash ^= bytes[i];
+        this->hash *= 1099511628211ULL;
+    }
+}
+
+void Table_Cache::add(const double* data, const std::size_t n)
+{
+    this->add_bytes(&n, sizeof(std::size_t));
+    this->add_bytes(data, n * sizeof(double));
+}
+
+void Table_Cache::add(const int* data, const std::size_t n)
+{
+    this->add_bytes(&n, sizeof(std::size_t));
+    this->add_bytes(data, n * sizeof(int));
+}
+
+void Table_Cache::add(const double value)
+{
+    this->add_bytes(&value, sizeof(double));
+}
+
+void Table_Cache::add(const int value)
+{
+    this->add_bytes(&value, sizeof(int));
+}
+
+std::string Table_Cache::get_hash() const
+{
+    char buf[17];
+    std::snprintf(buf, sizeof(buf), "%016llx", static_cast<unsigned long long>(this->hash));
+    return std::string(buf);
+}
+
+std::string Table_Cache::file_name(const std::string& dir) const
+{
+    std::string path = dir;
+    if (!path.empty() && path.back() != '/')
+    {
+        path += '/';
+    }
+    return path + this->kind + "_" + this->get_hash() + ".bin";
+}
+
+bool Table_Cache::load(const std::string& dir, double* table, const std::size_t n) const
+{
+    std::ifstream ifs(this->file_name(dir), std::ios::binary);
+    if (!ifs)
+    {
+        return false;
+    }
+
+    char magic_in[8];
+    int version_in = 0;
+    std::uint64_t hash_in = 0;
+    std::size_t n_in = 0;
+    ifs.read(magic_in, sizeof(magic_in));
+    ifs.read(reinterpret_cast<char*>(&version_in), sizeof(int));
+    ifs.read(reinterpret_cast<char*>(&hash_in), sizeof(std::uint64_t));
+    ifs.read(reinterpret_cast<char*>(&n_in), sizeof(std::size_t));
+    if (!ifs || std::string(magic_in, 8) != std::string(magic, 8) || version_in != version || hash_in != this->hash
+        || n_in != n)
+    {
+        return false;
+    }
+
+    // read into a buffer first, the table is kept if the file is truncated
+    std::string buffer(n * sizeof(double), '\0');
+    ifs.read(&buffer[0], buffer.size());
+    if (!ifs)
+    {
+        return false;
+    }
+    std::memcpy(table, buffer.data(), buffer.size());
+    return true;
+}
+
+bool Table_Cache::save(const std::string& dir, const double* table, const std::size_t n) const
+{
+    mkdir(dir.c_str(), 0755);
+
+    const std::string fn = this->file_name(dir);
+    std::stringstream ss;
+    ss << fn << ".tmp" << getpid() << "_" << std::chrono::steady_clock::now().time_since_epoch().count();
+    const std::string fn_tmp = ss.str();
+
+    std::ofstream ofs(fn_tmp, std::ios::binary);
+    if (!ofs)
+    {
+        return false;
+    }
+    const int ver = version;
+    ofs.write(magic, sizeof(magic));
+    ofs.write(reinterpret_cast<const char*>(&ver), sizeof(int));
+    ofs.write(reinterpret_cast<const char*>(&this->hash), sizeof(std::uint64_t));
+    ofs.write(reinterpret_cast<const char*>(&n), sizeof(std::size_t));
+    ofs.write(reinterpret_cast<const char*>(table), n * sizeof(double));
+    ofs.close();
+    if (!ofs)
+    {
+        std::remove(fn_tmp.c_str());
+        return false;
+    }
+    return std::rename(fn_tmp.c_str(), fn.c_str()) == 0;
+}
+
+} // namespace ModuleBase
@@ -0,0 +1,68 @@
+#ifndef TABLE_CACHE_H
+#define TABLE_CACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace ModuleBase
+{
+
+/**
+ * @brief A binary file on disk holding an interpolation table.
+ *
+ * The table is identified by the 64-bit FNV-1a hash of everything it is
+ * computed from (radial data of the pseudopotential, q grid, ...), which is
+ * given by add(). A later run with the same data finds the file by the hash
+ * and reads the table instead of integrating it again.
+ *
+ * The file is "<dir>/<kind>_<hash>.bin". It begins with a header of the magic
+ * word, the format version, the hash and the number of values, followed by the
+ * values in the native binary format.
+ */
+class Table_Cache
+{
+  public:
+    explicit Table_Cache(const std::string& kind_in);
+    ~Table_Cache() = default;
+
+    /// the data the table is computed from, in the order they are given
+    void add(const double* data, const std::size_t n);
+    void add(const int* data, const std::size_t n);
+    void add(const double value);
+    void add(const int value);
+
+    /// hexadecimal hash of the data given so far
+    std::string get_hash() const;
+
+    /// the file of the table in the directory dir
+    std::string file_name(const std::string& dir) const;
+
+    /**
+     * @brief read the table from the directory dir
+     * @param table n values, not changed if the file can not be used
+     * @return false if the file does not exist, or it does not match the hash, the version or n
+     */
+    bool load(const std::string& dir, double* table, const std::size_t n) const;
+
+    /**
+     * @brief write the table to the directory dir, which is created if needed
+     * The file is written with a temporary name and renamed at the end, so
+     * that other processes never read a partial file.
+     * @return false if the file can not be written
+     */
+    bool save(const std::string& dir, const double* table, const std::size_t n) const;
+
+    /// changed when the tables are computed differently, so that the old files are not used
+    static const int version = 1;
+
+  private:
+    void add_bytes(const void* data, const std::size_t nbytes);
+
+    std::string kind;
+    std::uint64_t hash = 14695981039346656037ULL;
+};
+
+} // namespace ModuleBase
+
+#endif
@@ -14,6 +14,7 @@
  *   - calfinalvec_real
  *   - calfinalvec_complex
  *   - tracepolyA
+ *   - tracepolyAA
  *   - checkconverge
  *
  *
@@ -334,6 +335,52 @@ TEST_F(MathChebyshevTest, tracepolyA)
     delete p_chetest;
 }
 
+TEST_F(MathChebyshevTest, tracepolyAA)
+{
+    const int norder = 30;
+    p_chetest = new ModuleBase::Chebyshev<double>(norder);
+    fun.factor = 0.7;
+    fun.LDA = 3;
+    const int LDA = fun.LDA;
+    std::complex<double>* v = new std::complex<double>[2 * LDA];
+    std::complex<double>* polyv = new std::complex<double>[2 * LDA * norder];
+    double* gram = new double[norder * norder];
+    v[0] = 1.0;
+    v[1] = std::complex<double>(0.2, 0.5);
+    v[2] = 0.0;
+    v[3] = std::complex<double>(0.0, -0.3);
+    v[4] = 1.0;
+    v[5] = 0.0; //[1 0.2+0.5i 0; -0.3i 1 0]
+    for (int i = 0; i < 2 * LDA * norder; ++i)
+    {
+        polyv[i] = 0.0;
+    }
+
+    auto fun_sigma_y
+        = [&](std::complex<double>* in, std::complex<double>* out, const int m = 1) { fun.sigma_y(in, out, m); };
+    p_chetest->calpolyvec_complex(fun_sigma_y, v, polyv, 2, LDA, 2);
+    p_chetest->tracepolyAA(fun_sigma_y, v, gram, 2, LDA, 2);
+    // the Gram matrix of the vectors of all orders
+    for (int j = 0; j < norder; ++j)
+    {
+        for (int k = 0; k < norder; ++k)
+        {
+            double ref = 0;
+            for (int i = 0; i < 2 * LDA; ++i)
+            {
+                ref += (std::conj(polyv[j * 2 * LDA + i]) * polyv[k * 2 * LDA + i]).real();
+            }
+            EXPECT_NEAR(gram[j * norder + k], ref, 1.e-10);
+        }
+    }
+    fun.factor = 1;
+    fun.LDA = 2;
+    delete[] v;
+    delete[] polyv;
+    delete[] gram;
+    delete p_chetest;
+}
+
 TEST_F(MathChebyshevTest, checkconverge)
 {
     const int norder = 100;
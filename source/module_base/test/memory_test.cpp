@@ -23,6 +23,11 @@ namespace GlobalV
  *   - print_all
  *     - print memory consumed (> MB) in a
  *     - std::ofstream file
+ *   - set_track, track_alloc, track_free, Scope
+ *     - nothing is tracked while the tracking is off
+ *     - live, peak and allocation counts of tagged scopes
+ *   - reduce_track, get_timeline
+ *     - statistics of the scopes and the timeline of closed scopes
  */
 
 #define private public
@@ -139,6 +144,78 @@ TEST_F(MemoryTest, printall)
 	ifs.close();
 }
 
+TEST_F(MemoryTest, Track)
+{
+	const size_t mb = 1024 * 1024;
+	std::vector<char> a(1), b(1), c(1), d(1);
+	// off by default, the blocks and the scopes are ignored
+	EXPECT_FALSE(ModuleBase::Memory::get_track());
+	{
+		ModuleBase::Memory::Scope scope("off");
+		ModuleBase::Memory::track_alloc(d.data(), 5 * mb);
+	}
+	EXPECT_TRUE(ModuleBase::Memory::get_timeline().empty());
+
+	ModuleBase::Memory::set_track(true);
+	ModuleBase::Memory::track_alloc(a.data(), 2 * mb);
+	{
+		ModuleBase::Memory::Scope scope("stage1");
+		ModuleBase::Memory::track_alloc(b.data(), 3 * mb);
+		ModuleBase::Memory::track_alloc(c.data(), 1 * mb);
+		ModuleBase::Memory::track_free(b.data());
+		ModuleBase::Memory::track_free(c.data());
+	}
+	{
+		ModuleBase::Memory::Scope scope("stage2");
+		ModuleBase::Memory::track_alloc(d.data(), 1 * mb);
+		// blocks not tracked are ignored
+		ModuleBase::Memory::track_free(b.data() + 1);
+	}
+	ModuleBase::Memory::track_free(a.data());
+
+	const std::vector<ModuleBase::Memory::TrackRecord> records = ModuleBase::Memory::reduce_track();
+	ASSERT_GE(records.size(), 3);
+	EXPECT_EQ(records[0].tag, "total");
+	EXPECT_DOUBLE_EQ(records[0].peak_max, 6.0);
+	EXPECT_EQ(records[0].count, 4);
+	for (const auto& r : records)
+	{
+		if (r.tag == "stage1")
+		{
+			EXPECT_DOUBLE_EQ(r.peak_max, 4.0);
+			EXPECT_DOUBLE_EQ(r.stage_peak_max, 6.0);
+			EXPECT_DOUBLE_EQ(r.thread_peak_max, 4.0);
+			EXPECT_EQ(r.count, 2);
+		}
+		else if (r.tag == "stage2")
+		{
+			EXPECT_DOUBLE_EQ(r.peak_max, 1.0);
+			EXPECT_DOUBLE_EQ(r.stage_peak_max, 3.0);
+			EXPECT_EQ(r.count, 1);
+		}
+	}
+	const std::vector<ModuleBase::Memory::TimelineEntry> timeline = ModuleBase::Memory::get_timeline();
+	ASSERT_EQ(timeline.size(), 2);
+	EXPECT_EQ(timeline[0].tag, "stage1");
+	EXPECT_DOUBLE_EQ(timeline[0].live, 2.0);
+	EXPECT_DOUBLE_EQ(timeline[0].stage_peak, 6.0);
+	EXPECT_EQ(timeline[1].tag, "stage2");
+	EXPECT_DOUBLE_EQ(timeline[1].live, 3.0);
+	EXPECT_LE(timeline[0].time, timeline[1].time);
+
+	ofs.open("tmp");
+	ModuleBase::Memory::print_track(ofs);
+	ofs.close();
+	ifs.open("tmp");
+	getline(ifs, output);
+	getline(ifs, output);
+	EXPECT_THAT(output, testing::HasSubstr("TRACKED ALLOCATIONS"));
+	getline(ifs, output);
+	EXPECT_THAT(output, testing::HasSubstr("total"));
+	ifs.close();
+	ModuleBase::Memory::set_track(false);
+}
+
 TEST_F(MemoryTest, finish)
 {
 	*ModuleBase::Memory::name = "tmp_name";
@@ -0,0 +1,131 @@
+#include "../table_cache.h"
+#include "gtest/gtest.h"
+
+#include <cstdio>
+#include <fstream>
+#include <vector>
+
+/************************************************
+ *  unit test of class Table_Cache
+ ***********************************************/
+
+/**
+ * - Tested Functions:
+ *   - GetHash
+ *     - the hash depends on the kind, the values and their order
+ *   - FileName
+ *     - "<dir>/<kind>_<hash>.bin"
+ *   - SaveLoad
+ *     - a saved table is read back by a cache of the same data
+ *   - LoadMismatch
+ *     - the table is not changed if the file is missing, has another hash or size,
+ *     - or is truncated
+ */
+
+class TableCacheTest : public testing::Test
+{
+  protected:
+    std::string dir = "./table_cache_test_dir";
+    std::vector<double> r = {0.0, 0.01, 0.02, 0.03, 0.04};
+    std::vector<int> lll = {0, 1};
+
+    void fill(ModuleBase::Table_Cache& cache)
+    {
+        cache.add(100);
+        cache.add(0.01);
+        cache.add(r.data(), r.size());
+        cache.add(lll.data(), lll.size());
+    }
+
+    void TearDown()
+    {
+        ModuleBase::Table_Cache cache("tab");
+        this->fill(cache);
+        std::remove(cache.file_name(dir).c_str());
+        std::remove(dir.c_str());
+    }
+};
+
+TEST_F(TableCacheTest, GetHash)
+{
+    ModuleBase::Table_Cache c1("tab");
+    ModuleBase::Table_Cache c2("tab");
+    ModuleBase::Table_Cache c3("qrad");
+    this->fill(c1);
+    this->fill(c2);
+    this->fill(c3);
+    EXPECT_EQ(c1.get_hash(), c2.get_hash());
+    EXPECT_NE(c1.get_hash(), c3.get_hash());
+    EXPECT_EQ(c1.get_hash().size(), 16);
+
+    c2.add(1);
+    EXPECT_NE(c1.get_hash(), c2.get_hash());
+
+    ModuleBase::Table_Cache c4("tab");
+    c4.add(0.01);
+    c4.add(100);
+    c4.add(r.data(), r.size());
+    c4.add(lll.data(), lll.size());
+    EXPECT_NE(c1.get_hash(), c4.get_hash());
+}
+
+TEST_F(TableCacheTest, FileName)
+{
+    ModuleBase::Table_Cache cache("tab");
+    EXPECT_EQ(cache.file_name("dir"), "dir/tab_" + cache.get_hash() + ".bin");
+    EXPECT_EQ(cache.file_name("dir/"), "dir/tab_" + cache.get_hash() + ".bin");
+}
+
+TEST_F(TableCacheTest, SaveLoad)
+{
+    ModuleBase::Table_Cache cache("tab");
+    this->fill(cache);
+    std::vector<double> table = {1.0, -2.5, 3.25, 1e-12, 7.0, 0.0};
+    EXPECT_TRUE(cache.save(dir, table.data(), table.size()));
+
+    ModuleBase::Table_Cache cache_in("tab");
+    this->fill(cache_in);
+    std::vector<double> table_in(table.size(), 0.0);
+    EXPECT_TRUE(cache_in.load(dir, table_in.data(), table_in.size()));
+    for (std::size_t i = 0; i < table.size(); ++i)
+    {
+        EXPECT_EQ(table_in[i], table[i]);
+    }
+}
+
+TEST_F(TableCacheTest, LoadMismatch)
+{
+    ModuleBase::Table_Cache cache("tab");
+    this->fill(cache);
+    std::vector<double> table_in(4, 9.0);
+    EXPECT_FALSE(cache.load(dir, table_in.data(), table_in.size()));
+
+    std::vector<double> table = {1.0, 2.0, 3.0, 4.0};
+    EXPECT_TRUE(cache.save(dir, table.data(), table.size()));
+
+    // another size
+    std::vector<double> table_short(3, 9.0);
+    EXPECT_FALSE(cache.load(dir, table_short.data(), table_short.size()));
+    EXPECT_EQ(table_short[0], 9.0);
+
+    // another hash, the file name is different
+    ModuleBase::Table_Cache other("tab");
+    this->fill(other);
+    other.add(2);
+    EXPECT_FALSE(other.load(dir, table_in.data(), table_in.size()));
+    EXPECT_EQ(table_in[0], 9.0);
+
+    // a truncated file
+    const std::string fn = cache.file_name(dir);
+    std::ifstream ifs(fn, std::ios::binary);
+    std::string content((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+    ifs.close();
+    std::ofstream ofs(fn, std::ios::binary);
+    ofs.write(content.data(), content.size() - sizeof(double));
+    ofs.close();
+    EXPECT_FALSE(cache.load(dir, table_in.data(), table_in.size()));
+    for (std::size_t i = 0; i < table_in.size(); ++i)
+    {
+        EXPECT_EQ(table_in[i], 9.0);
+    }
+}
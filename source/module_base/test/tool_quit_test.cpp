@@ -23,6 +23,9 @@
  *
  *   - ModuleBase::WARNING_QUIT
  *     - combine the above 2 functions
+ *
+ *   - ModuleBase::set_quit_throw
+ *     - QUIT and WARNING_QUIT throw Quit_Error instead of exiting
  */
 
 class ToolQuitTest : public testing::Test
@@ -119,6 +122,33 @@ TEST_F(ToolQuitTest,warningquit_with_ret)
 	EXPECT_THAT(output,testing::HasSubstr("!!!!!!!"));
 	ifs.close();
 }
+TEST_F(ToolQuitTest,quit_throw)
+{
+	ModuleBase::set_quit_throw(true);
+	testing::internal::CaptureStdout();
+	try
+	{
+		ModuleBase::WARNING_QUIT("INPUT","bad input parameter",2);
+		FAIL() << "WARNING_QUIT should throw";
+	}
+	catch (const ModuleBase::Quit_Error& e)
+	{
+		EXPECT_EQ(std::string(e.what()),"bad input parameter");
+		EXPECT_EQ(e.ret,2);
+	}
+	EXPECT_THROW(ModuleBase::QUIT(), ModuleBase::Quit_Error);
+	output = testing::internal::GetCapturedStdout();
+	// the timer is not printed, the caller goes on
+	EXPECT_THAT(output,testing::Not(testing::HasSubstr("TIME STATISTICS")));
+	ModuleBase::set_quit_throw(false);
+	GlobalV::ofs_warning.close();
+	ifs.open("warning.log");
+	getline(ifs,output);
+	// the warning is still written
+	EXPECT_THAT(output,testing::HasSubstr("warning"));
+	ifs.close();
+}
+
 // use __MPI to activate parallel environment
 #ifdef __MPI
 int main(int argc, char **argv)
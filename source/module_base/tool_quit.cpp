@@ -15,6 +15,14 @@
 
 namespace ModuleBase
 {
+// QUIT throws Quit_Error instead of exiting
+static bool quit_throw = false;
+
+void set_quit_throw(const bool flag)
+{
+    quit_throw = flag;
+}
+
 //==========================================================
 // GLOBAL FUNCTION :
 // NAME : WARNING( write information into GlobalV::ofs_warning)
@@ -44,6 +52,10 @@ void QUIT()
 
 void QUIT(int ret)
 {
+    if (quit_throw)
+    {
+        throw Quit_Error("QUIT", ret);
+    }
 
 #ifdef __NORMAL
 
@@ -102,6 +114,10 @@ void WARNING_QUIT(const std::string &file,const std::string &description,int ret
 
 #endif
 
+    if (quit_throw)
+    {
+        throw Quit_Error(description, ret);
+    }
     QUIT(ret);
 }
 
@@ -136,6 +152,10 @@ void CHECK_WARNING_QUIT(const bool error_in, const std::string &file,const std::
 		GlobalV::ofs_warning << std::endl;
 		GlobalV::ofs_warning << " ERROR! " << file << ", core " << GlobalV::MY_RANK+1 << ": " << description << std::endl;
 		GlobalV::ofs_warning << std::endl;
+		if (quit_throw)
+		{
+			throw Quit_Error(description, 1);
+		}
 		exit(1);
 	}
 #endif
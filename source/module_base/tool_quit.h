@@ -6,6 +6,7 @@
 #include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <stdexcept>
 #include <string>
 #include <valarray>
 #include <vector>
@@ -64,6 +65,27 @@ void WARNING(const std::string &file, const std::string &description);
  */
 void CHECK_WARNING_QUIT(const bool error, const std::string &file,const std::string &calculation,const std::string &description);
 
+/**
+ * @brief Error thrown by QUIT, WARNING_QUIT and CHECK_WARNING_QUIT instead of exiting
+ * when set_quit_throw(true), so that the batch mode can go on with the next structure
+ */
+class Quit_Error : public std::runtime_error
+{
+  public:
+    Quit_Error(const std::string& description, const int ret_in) : std::runtime_error(description), ret(ret_in)
+    {
+    }
+    // the exit code QUIT would have returned
+    int ret;
+};
+
+/**
+ * @brief Throw Quit_Error instead of exiting the program
+ *
+ * @param flag true to throw, false (default) to exit
+ */
+void set_quit_throw(const bool flag);
+
 } // namespace ModuleBase
 
 #endif
@@ -0,0 +1,106 @@
+#include "module_basis/module_nao/two_center_cache.h"
+
+#include "gtest/gtest.h"
+#include "module_base/global_variable.h"
+#include "module_base/tool_quit.h"
+
+#ifdef __MPI
+#include <mpi.h>
+#endif
+
+/***********************************************************
+ *      Unit test of class "TwoCenterCache"
+ ***********************************************************/
+/*!
+ *  Tested functions:
+ *
+ *  - start, set_built, keep
+ *      - the tables of a structure that failed while building them are discarded,
+ *        and the next structure with the same files builds its own
+ *      - complete tables are taken by the next structure with the same key,
+ *        but not by a structure with another key
+ *                                                                      */
+class TwoCenterCacheTest : public ::testing::Test
+{
+  protected:
+    void SetUp()
+    {
+#ifdef __MPI
+        MPI_Comm_rank(MPI_COMM_WORLD, &GlobalV::MY_RANK);
+#endif
+        ModuleBase::set_quit_throw(true);
+    }
+    void TearDown()
+    {
+        ModuleBase::set_quit_throw(false);
+    }
+
+    std::string dir = "../../../../../tests/PP_ORB/";
+    TwoCenterCache cache;
+};
+
+TEST_F(TwoCenterCacheTest, FailThenGood)
+{
+    const std::string key = "C H";
+
+    // the first structure fails in reading the second orbital file, after orb_ is set
+    {
+        std::string file_orb[2] = {dir + "C_gga_8au_100Ry_2s2p1d.orb", dir + "not_exist.orb"};
+        TwoCenterBundle bundle;
+        EXPECT_FALSE(cache.start(key, bundle));
+        EXPECT_THROW(bundle.build_orb(2, file_orb), ModuleBase::Quit_Error);
+        EXPECT_NE(bundle.orb_, nullptr);
+        cache.keep(bundle);
+        // the half-built tables are not taken from the bundle
+        EXPECT_NE(bundle.orb_, nullptr);
+    }
+
+    // the next structure with the same files builds the tables again
+    const RadialCollection* orb_good = nullptr;
+    {
+        std::string file_orb[2] = {dir + "C_gga_8au_100Ry_2s2p1d.orb", dir + "H_gga_8au_60Ry_2s1p.orb"};
+        TwoCenterBundle bundle;
+        EXPECT_FALSE(cache.start(key, bundle));
+        EXPECT_EQ(bundle.orb_, nullptr);
+        bundle.build_orb(2, file_orb);
+        cache.set_built();
+        orb_good = bundle.orb_.get();
+        cache.keep(bundle);
+        EXPECT_EQ(bundle.orb_, nullptr);
+    }
+
+    // the complete tables are taken by the next structure
+    {
+        TwoCenterBundle bundle;
+        EXPECT_TRUE(cache.start(key, bundle));
+        ASSERT_NE(bundle.orb_, nullptr);
+        EXPECT_EQ(bundle.orb_.get(), orb_good);
+        EXPECT_EQ(bundle.orb_->ntype(), 2);
+        cache.set_built();
+        cache.keep(bundle);
+    }
+
+    // but not by a structure with other files
+    {
+        TwoCenterBundle bundle;
+        EXPECT_FALSE(cache.start("C O", bundle));
+        EXPECT_EQ(bundle.orb_, nullptr);
+    }
+}
+
+int main(int argc, char** argv)
+{
+
+#ifdef __MPI
+    MPI_Init(&argc, &argv);
+#endif
+
+    testing::InitGoogleTest(&argc, argv);
+    int result = RUN_ALL_TESTS();
+
+#ifdef __MPI
+    MPI_Finalize();
+#endif
+
+    return result;
+}
@@ -0,0 +1,33 @@
+#include "module_basis/module_nao/two_center_cache.h"
+
+#include <utility>
+
+bool TwoCenterCache::start(const std::string& key, TwoCenterBundle& bundle)
+{
+    this->key_building_ = key;
+    this->built_ = false;
+    const bool reuse = this->valid_ && this->key_ == key;
+    if (reuse)
+    {
+        bundle = std::move(this->bundle_);
+    }
+    else
+    {
+        // the tables of other files are not needed any more
+        this->bundle_ = TwoCenterBundle();
+    }
+    this->valid_ = false;
+    return reuse;
+}
+
+void TwoCenterCache::keep(TwoCenterBundle& bundle)
+{
+    if (!this->built_ || bundle.orb_ == nullptr)
+    {
+        return;
+    }
+    this->bundle_ = std::move(bundle);
+    this->key_ = this->key_building_;
+    this->valid_ = true;
+    this->built_ = false;
+}
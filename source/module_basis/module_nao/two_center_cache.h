@@ -0,0 +1,43 @@
+#ifndef TWO_CENTER_CACHE_H
+#define TWO_CENTER_CACHE_H
+
+#include "module_basis/module_nao/two_center_bundle.h"
+
+#include <string>
+
+/**
+ * @brief two-center integral tables kept from one structure to the next in the batch mode (stru_batch)
+ *
+ * The tables of a structure are kept only if they were completely built, so a structure that fails while
+ * building them (e.g. a missing orbital file, or an error in build_beta or tabulate) does not hand
+ * half-built tables to the next structure.
+ */
+class TwoCenterCache
+{
+  public:
+    /**
+     * @brief start the tables of a structure
+     * @param key the files and parameters the tables are built from
+     * @param bundle takes the kept tables if they were built from the same key
+     * @return whether the kept tables are taken
+     */
+    bool start(const std::string& key, TwoCenterBundle& bundle);
+
+    /// the tables of the structure started last are completely built
+    void set_built()
+    {
+        this->built_ = true;
+    }
+
+    /// keep the tables of the structure started last, they are discarded if they were not completely built
+    void keep(TwoCenterBundle& bundle);
+
+  private:
+    std::string key_;          ///< key of the kept tables
+    std::string key_building_; ///< key of the structure started last
+    bool valid_ = false;       ///< whether bundle_ holds tables
+    bool built_ = false;       ///< whether the tables of the structure started last are complete
+    TwoCenterBundle bundle_;
+};
+
+#endif
@@ -41,9 +41,10 @@ void FFT_Bundle::initfft(int nx_in,
                          bool mpifft_in)
 {
     assert(this->device=="cpu" || this->device=="gpu");
-    assert(this->precision=="single" || this->precision=="double" || this->precision=="mixing");
+    assert(this->precision=="single" || this->precision=="double" || this->precision=="mixed");
 
-    if (this->precision=="single")
+    // mixed precision runs the first SCF iterations with float FFTs and the rest with double ones
+    if (this->precision=="single" || this->precision=="mixed")
     {
         #ifndef __ENABLE_FLOAT_FFTW
         float_define = false;
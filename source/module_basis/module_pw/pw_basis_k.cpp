@@ -40,7 +40,7 @@ PW_Basis_K::~PW_Basis_K()
     }
     else {
 #endif
-        if (this->precision == "single") {
+        if (this->precision == "single" || this->precision == "mixed") {
             delmem_sh_op()(cpu_ctx, this->s_kvec_c);
             delmem_sh_op()(cpu_ctx, this->s_gcar);
             delmem_sh_op()(cpu_ctx, this->s_gk2);
@@ -108,7 +108,7 @@ void PW_Basis_K:: initparameters(
     }
     else {
 #endif
-        if (this->precision == "single") {
+        if (this->precision == "single" || this->precision == "mixed") {
             resmem_sh_op()(cpu_ctx, this->s_kvec_c, this->nks * 3);
             castmem_d2s_h2h_op()(cpu_ctx, cpu_ctx, this->s_kvec_c, reinterpret_cast<double *>(&this->kvec_c[0][0]), this->nks * 3);
         }
@@ -261,13 +261,13 @@ void PW_Basis_K::collect_local_pw(const double& erf_ecut_in, const double& erf_h
     }
     else {
 #endif
-        if (this->precision == "single") {
+        if (this->precision == "single" || this->precision == "mixed") {
             resmem_sh_op()(cpu_ctx, this->s_gk2, this->npwk_max * this->nks, "PW_B_K::s_gk2");
             resmem_sh_op()(cpu_ctx, this->s_gcar, this->npwk_max * this->nks * 3, "PW_B_K::s_gcar");
             castmem_d2s_h2h_op()(cpu_ctx, cpu_ctx, this->s_gk2, this->gk2, this->npwk_max * this->nks);
             castmem_d2s_h2h_op()(cpu_ctx, cpu_ctx, this->s_gcar, reinterpret_cast<double *>(&this->gcar[0][0]), this->npwk_max * this->nks * 3);
         }
-        else {
+        if (this->precision != "single") {
             this->d_gcar = reinterpret_cast<double *>(&this->gcar[0][0]);
             this->d_gk2 = this->gk2;
         }
@@ -0,0 +1,101 @@
+//---------------------------------------------
+// TEST for FFT of precision = mixed
+//---------------------------------------------
+#include "../pw_basis_k.h"
+#ifdef __MPI
+#include "test_tool.h"
+#include "module_base/parallel_global.h"
+#include "mpi.h"
+#endif
+#include "module_base/constants.h"
+#include "module_base/global_function.h"
+#include "pw_test.h"
+
+using namespace std;
+TEST_F(PWTEST,test1_7)
+{
+    cout<<"dividemthd 1, gamma_only: off, xprime: false, precision: mixed, check both the float and the double fft"<<endl;
+    ModulePW::PW_Basis_K pwtest(device_flag, "mixed");
+    ModuleBase::Matrix3 latvec;
+    double wfcecut;
+    double lat0;
+    bool gamma_only;
+    ModuleBase::Vector3<double> *kvec_d;
+    int nks;
+    //--------------------------------------------------
+    lat0 = 2.7;
+    ModuleBase::Matrix3 la(1, 0.3, 0, 0, 2, 0, 0, 0, 2);
+    nks = 2;
+    kvec_d = new ModuleBase::Vector3<double>[nks];
+    kvec_d[0].set(0,0,0);
+    kvec_d[1].set(0.1,0.2,0.3);
+    latvec = la;
+    wfcecut = 10;
+    gamma_only = false;
+    int distribution_type = 1;
+    bool xprime = false;
+    //--------------------------------------------------
+#ifdef __MPI
+    pwtest.initmpi(nproc_in_pool, rank_in_pool, POOL_WORLD);
+#endif
+    pwtest.initgrids(lat0,latvec,4*wfcecut);
+    pwtest.initparameters(gamma_only,wfcecut,nks,kvec_d,distribution_type, xprime);
+    pwtest.setuptransform();
+    pwtest.collect_local_pw();
+
+    const int nrxx = pwtest.nrxx;
+    complex<double> * rhor = new complex<double> [nrxx];
+#ifdef __ENABLE_FLOAT_FFTW
+    complex<float> * rhofr = new complex<float> [nrxx];
+#endif
+    for(int ik = 0; ik < nks; ++ik)
+    {
+        const int npwk = pwtest.npwk[ik];
+        complex<double> * rhog = new complex<double> [npwk];
+        complex<double> * rhogout = new complex<double> [npwk];
+        for(int ig = 0 ; ig < npwk ; ++ig)
+        {
+            rhog[ig] = 1.0/(pwtest.getgk2(ik,ig)+1) + ModuleBase::IMAG_UNIT / (std::abs(pwtest.getgdirect(ik,ig).x+1) + 1);
+        }
+        // the double fft is used after the switch
+        pwtest.recip2real(rhog,rhor,ik);
+        pwtest.real2recip(rhor,rhogout,ik);
+        for(int ig = 0 ; ig < npwk ; ++ig)
+        {
+            EXPECT_NEAR(rhog[ig].real(),rhogout[ig].real(),1e-10);
+            EXPECT_NEAR(rhog[ig].imag(),rhogout[ig].imag(),1e-10);
+        }
+#ifdef __ENABLE_FLOAT_FFTW
+        // the float fft is used before the switch, on the same grids
+        complex<float> * rhofg = new complex<float> [npwk];
+        complex<float> * rhofgout = new complex<float> [npwk];
+        for(int ig = 0 ; ig < npwk ; ++ig)
+        {
+            rhofg[ig] = complex<float>(rhog[ig]);
+        }
+        pwtest.recip2real(rhofg,rhofr,ik);
+        for(int ir = 0 ; ir < nrxx ; ++ir)
+        {
+            EXPECT_NEAR(rhor[ir].real(),rhofr[ir].real(),1e-4);
+            EXPECT_NEAR(rhor[ir].imag(),rhofr[ir].imag(),1e-4);
+        }
+        pwtest.real2recip(rhofr,rhofgout,ik);
+        for(int ig = 0 ; ig < npwk ; ++ig)
+        {
+            EXPECT_NEAR(rhog[ig].real(),rhofgout[ig].real(),1e-5);
+            EXPECT_NEAR(rhog[ig].imag(),rhofgout[ig].imag(),1e-5);
+        }
+        delete [] rhofg;
+        delete [] rhofgout;
+#endif
+        delete [] rhog;
+        delete [] rhogout;
+    }
+    delete [] rhor;
+    delete [] kvec_d;
+    fftw_cleanup();
+#ifdef __ENABLE_FLOAT_FFTW
+    delete [] rhofr;
+    fftwf_cleanup();
+#endif
+}
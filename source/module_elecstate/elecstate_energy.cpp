@@ -188,6 +188,12 @@ double ElecState::cal_delta_eband(const UnitCell& ucell) const
 
     deband0 *= this->omega / this->charge->rhopw->nxyz;
 
+    // V_xc on the atom grids of LCAO is not in v_eff, its \int rho(r) v_xc(r) dr is vtxc
+    if (PARAM.inp.atom_grid)
+    {
+        deband0 -= this->f_en.vtxc;
+    }
+
     // \int rho(r) v_{exx}(r) dr = 2 E_{exx}[rho]
     deband0 -= 2 * this->f_en.exx; // Peize Lin add 2017-10-16
     return deband0;
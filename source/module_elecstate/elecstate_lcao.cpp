@@ -130,25 +130,10 @@ double ElecStateLCAO<std::complex<double>>::get_spin_constrain_energy()
     return sc.cal_escon();
 }
 
-#ifdef __PEXSI
 template <>
-void ElecStateLCAO<double>::dmToRho(std::vector<double*> pexsi_DM, std::vector<double*> pexsi_EDM)
+void ElecStateLCAO<double>::dmrToRho()
 {
-    ModuleBase::timer::tick("ElecStateLCAO", "dmToRho");
-
-    int nspin = PARAM.inp.nspin;
-    if (PARAM.inp.nspin == 4)
-    {
-        nspin = 1;
-    }
-
-    this->get_DM()->pexsi_EDM = pexsi_EDM;
-
-    for (int is = 0; is < nspin; is++)
-    {
-        this->DM->set_DMK_pointer(is, pexsi_DM[is]);
-    }
-    DM->cal_DMR();
+    ModuleBase::timer::tick("ElecStateLCAO", "dmrToRho");
 
     for (int is = 0; is < PARAM.inp.nspin; is++)
     {
@@ -164,14 +149,39 @@ void ElecStateLCAO<double>::dmToRho(std::vector<double*> pexsi_DM, std::vector<d
     {
         for (int is = 0; is < PARAM.inp.nspin; is++)
         {
-            ModuleBase::GlobalFunc::ZEROS(this->charge->kin_r[0], this->charge->nrxx);
+            ModuleBase::GlobalFunc::ZEROS(this->charge->kin_r[is], this->charge->nrxx);
         }
-        Gint_inout inout1(this->charge->kin_r, Gint_Tools::job_type::tau);
+        Gint_inout inout1(this->charge->kin_r, Gint_Tools::job_type::tau, PARAM.inp.nspin);
         this->gint_gamma->cal_gint(&inout1);
     }
 
     this->charge->renormalize_rho();
 
+    ModuleBase::timer::tick("ElecStateLCAO", "dmrToRho");
+    return;
+}
+
+template <>
+void ElecStateLCAO<double>::dmToRho(std::vector<double*> pexsi_DM, std::vector<double*> pexsi_EDM)
+{
+    ModuleBase::timer::tick("ElecStateLCAO", "dmToRho");
+
+    int nspin = PARAM.inp.nspin;
+    if (PARAM.inp.nspin == 4)
+    {
+        nspin = 1;
+    }
+
+    this->get_DM()->pexsi_EDM = pexsi_EDM;
+
+    for (int is = 0; is < nspin; is++)
+    {
+        this->DM->set_DMK_pointer(is, pexsi_DM[is]);
+    }
+    DM->cal_DMR();
+
+    this->dmrToRho();
+
     ModuleBase::timer::tick("ElecStateLCAO", "dmToRho");
     return;
 }
@@ -180,10 +190,14 @@ template <>
 void ElecStateLCAO<std::complex<double>>::dmToRho(std::vector<std::complex<double>*> pexsi_DM,
                                                   std::vector<std::complex<double>*> pexsi_EDM)
 {
-    ModuleBase::WARNING_QUIT("ElecStateLCAO", "pexsi is not completed for multi-k case");
+    ModuleBase::WARNING_QUIT("ElecStateLCAO", "dmToRho is not completed for multi-k case");
 }
 
-#endif
+template <>
+void ElecStateLCAO<std::complex<double>>::dmrToRho()
+{
+    ModuleBase::WARNING_QUIT("ElecStateLCAO", "dmrToRho is not completed for multi-k case");
+}
 
 template class ElecStateLCAO<double>;               // Gamma_only case
 template class ElecStateLCAO<std::complex<double>>; // multi-k case
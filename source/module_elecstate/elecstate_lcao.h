@@ -62,17 +62,20 @@ class ElecStateLCAO : public ElecState
 
     double get_spin_constrain_energy() override;
 
-#ifdef __PEXSI
-    // use for pexsi
+    // use for pexsi and foe
 
     /**
-     * @brief calculate electronic charge density from pointers of density matrix calculated by pexsi
-     * @param pexsi_DM: pointers of density matrix (DMK) calculated by pexsi
-     * @param pexsi_EDM: pointers of energy-weighed density matrix (EDMK) calculated by pexsi, needed by MD, will be
-     * stored in DensityMatrix::pexsi_EDM
+     * @brief calculate electronic charge density from pointers of density matrix calculated by pexsi or foe
+     * @param pexsi_DM: pointers of density matrix (DMK) calculated by pexsi or foe
+     * @param pexsi_EDM: pointers of energy-weighed density matrix (EDMK) calculated by pexsi or foe, needed by MD,
+     * will be stored in DensityMatrix::pexsi_EDM
      */
     void dmToRho(std::vector<TK*> pexsi_DM, std::vector<TK*> pexsi_EDM);
-#endif
+
+    /**
+     * @brief calculate electronic charge density from DMR already in DM, given by foe without DMK
+     */
+    void dmrToRho();
 
     DensityMatrix<TK, double>* DM = nullptr;
 
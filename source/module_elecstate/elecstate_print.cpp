@@ -58,7 +58,9 @@ void print_scf_iterinfo(const std::string& ks_solver,
            {"scalapack_gvx", "GV"},
            {"cusolver", "CU"},
            {"bpcg", "BP"},
-           {"pexsi", "PE"}}; // I change the key of "cg_in_lcao" to "CG" because all the other are only two letters
+           {"chfsi", "CF"},
+           {"pexsi", "PE"},
+           {"foe", "FO"}}; // I change the key of "cg_in_lcao" to "CG" because all the other are only two letters
     // ITER column
     std::vector<std::string> th_fmt = {" %-" + std::to_string(witer) + "s"}; // table header: th: ITER
     std::vector<std::string> td_fmt
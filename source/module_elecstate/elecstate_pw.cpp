@@ -8,6 +8,8 @@
 #include "module_base/timer.h"
 #include "module_base/module_device/device.h"
 
+#include <type_traits>
+
 namespace elecstate {
 
 template <typename T, typename Device>
@@ -31,7 +33,7 @@ ElecStatePW<T, Device>::ElecStatePW(ModulePW::PW_Basis_K* wfc_basis_in,
 template<typename T, typename Device>
 ElecStatePW<T, Device>::~ElecStatePW() 
 {
-    if (PARAM.inp.device == "gpu" || PARAM.inp.precision == "single")
+    if (PARAM.inp.device == "gpu" || !std::is_same<Real, double>::value)
     {
         delmem_var_op()(this->ctx, this->rho_data);
         delete[] this->rho;
@@ -63,7 +65,7 @@ void ElecStatePW<T, Device>::init_rho_data()
         return;
     }
 
-    if (PARAM.inp.device == "gpu" || PARAM.inp.precision == "single")
+    if (PARAM.inp.device == "gpu" || !std::is_same<Real, double>::value)
     {
         this->rho = new Real*[this->charge->nspin];
         resmem_var_op()(this->ctx, this->rho_data, this->charge->nspin * this->charge->nrxx);
@@ -138,7 +140,7 @@ void ElecStatePW<T, Device>::psiToRho(const psi::Psi<T, Device>& psi)
 
     this->add_usrho(psi);
 
-    if (PARAM.inp.device == "gpu" || PARAM.inp.precision == "single")
+    if (PARAM.inp.device == "gpu" || !std::is_same<Real, double>::value)
     {
         for (int ii = 0; ii < PARAM.inp.nspin; ii++)
         {
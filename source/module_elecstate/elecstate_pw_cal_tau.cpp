@@ -1,6 +1,8 @@
 #include "elecstate_pw.h"
 #include "elecstate_getters.h"
 
+#include <type_traits>
+
 namespace elecstate {
 
 template<typename T, typename Device>
@@ -50,7 +52,7 @@ void ElecStatePW<T, Device>::cal_tau(const psi::Psi<T, Device>& psi)
             }
         }
     }
-    if (PARAM.inp.device == "gpu" || PARAM.inp.precision == "single") {
+    if (PARAM.inp.device == "gpu" || !std::is_same<Real, double>::value) {
         for (int ii = 0; ii < PARAM.inp.nspin; ii++) {
             castmem_var_d2h_op()(cpu_ctx, this->ctx, this->charge->kin_r[ii], this->kin_r[ii], this->charge->nrxx);
         }
@@ -98,9 +98,12 @@ class Charge_Mixing
     // while Exx is using them as well as some other places
     const std::string& get_mixing_mode() const {return mixing_mode;}
     double get_mixing_beta() const {return mixing_beta;}
+    double get_mixing_beta_mag() const {return mixing_beta_mag;}
     int get_mixing_ndim() const {return mixing_ndim;}
     double get_mixing_gg0() const {return mixing_gg0;}
     Base_Mixing::Mixing* get_mixing() const {return mixing;}
+    /// number of densities pushed into the mixing since the last reset
+    int get_rho_ndim_history() const {return rho_mdata.ndim_history;}
 
     // for mixing restart
     int mixing_restart_step = 0; //which step to restart mixing during SCF, always equal to scf_namx except for the mixing restart
@@ -184,6 +187,18 @@ class Charge_Mixing
      */
     double inner_product_real(double* rho1, double* rho2);
 
+    /**
+     * @brief Process-local parts of inner_product_recip_hartree and inner_product_real, without the sum over the pool.
+     *        The mixing methods evaluate several of them and sum them in a single reduce_inner_products.
+     */
+    double inner_product_recip_hartree_local(std::complex<double>* rho1, std::complex<double>* rho2);
+    double inner_product_real_local(double* rho1, double* rho2);
+
+    /**
+     * @brief Sum n process-local inner products over the pool in one reduction
+     */
+    static void reduce_inner_products(double* sums, const int n);
+
     /**
      * @brief divide rho/tau to smooth and high frequency parts
      * @param data_d dense data
@@ -281,6 +281,15 @@ double Charge_Mixing::inner_product_recip_simple(std::complex<double>* rho1, std
 
 // a Hartree-like inner product
 double Charge_Mixing::inner_product_recip_hartree(std::complex<double>* rhog1, std::complex<double>* rhog2)
+{
+    double sum = this->inner_product_recip_hartree_local(rhog1, rhog2);
+#ifdef __MPI
+    Parallel_Reduce::reduce_pool(sum);
+#endif
+    return sum;
+}
+
+double Charge_Mixing::inner_product_recip_hartree_local(std::complex<double>* rhog1, std::complex<double>* rhog2)
 {
     ModuleBase::TITLE("Charge_Mixing", "inner_product_recip_hartree");
     ModuleBase::timer::tick("Charge_Mixing", "inner_product_recip_hartree");
@@ -440,9 +449,6 @@ double Charge_Mixing::inner_product_recip_hartree(std::complex<double>* rhog1, s
             }
         }
     }
-#ifdef __MPI
-    Parallel_Reduce::reduce_pool(sum);
-#endif
 
     ModuleBase::timer::tick("Charge_Mixing", "inner_product_recip_hartree");
 
@@ -452,6 +458,22 @@ double Charge_Mixing::inner_product_recip_hartree(std::complex<double>* rhog1, s
 }
 
 double Charge_Mixing::inner_product_real(double* rho1, double* rho2)
+{
+    double rnorm = this->inner_product_real_local(rho1, rho2);
+#ifdef __MPI
+    Parallel_Reduce::reduce_pool(rnorm);
+#endif
+    return rnorm;
+}
+
+void Charge_Mixing::reduce_inner_products(double* sums, const int n)
+{
+#ifdef __MPI
+    Parallel_Reduce::reduce_pool(sums, n);
+#endif
+}
+
+double Charge_Mixing::inner_product_real_local(double* rho1, double* rho2)
 {
     double rnorm = 0.0;
     // consider a resize for mixing_angle
@@ -466,8 +488,5 @@ double Charge_Mixing::inner_product_real(double* rho1, double* rho2)
     {
         rnorm += rho1[ir] * rho2[ir];
     }
-#ifdef __MPI
-    Parallel_Reduce::reduce_pool(rnorm);
-#endif
     return rnorm;
 }
\ No newline at end of file
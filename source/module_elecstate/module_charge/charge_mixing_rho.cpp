@@ -23,8 +23,9 @@ void Charge_Mixing::mix_rho_recip(Charge* chr)
     }
 
     //  inner_product_recip_hartree is a hartree-like sum, unit is Ry
+    //  the local parts are passed, the mixing sums all of its inner products in one reduction
     auto inner_product
-        = std::bind(&Charge_Mixing::inner_product_recip_hartree, this, std::placeholders::_1, std::placeholders::_2);
+        = std::bind(&Charge_Mixing::inner_product_recip_hartree_local, this, std::placeholders::_1, std::placeholders::_2);
 
     // DIIS Mixing Only for smooth part, while high_frequency part is mixed by plain mixing method.
     if (PARAM.inp.nspin == 1)
@@ -33,7 +34,7 @@ void Charge_Mixing::mix_rho_recip(Charge* chr)
         rhog_out = rhogs_out;
         auto screen = std::bind(&Charge_Mixing::Kerker_screen_recip, this, std::placeholders::_1);
         this->mixing->push_data(this->rho_mdata, rhog_in, rhog_out, screen, true);
-        this->mixing->cal_coef(this->rho_mdata, inner_product);
+        this->mixing->cal_coef(this->rho_mdata, inner_product, Charge_Mixing::reduce_inner_products);
         this->mixing->mix_data(this->rho_mdata, rhog_out);
     }
     else if (PARAM.inp.nspin == 2)
@@ -82,7 +83,7 @@ void Charge_Mixing::mix_rho_recip(Charge* chr)
                   }
               };
         this->mixing->push_data(this->rho_mdata, rhog_in, rhog_out, screen, twobeta_mix, true);
-        this->mixing->cal_coef(this->rho_mdata, inner_product);
+        this->mixing->cal_coef(this->rho_mdata, inner_product, Charge_Mixing::reduce_inner_products);
         this->mixing->mix_data(this->rho_mdata, rhog_out);
         // get rhog[is][ngmc] from rhog_mag[is*ngmc]
         for (int is = 0; is < PARAM.inp.nspin; is++)
@@ -133,7 +134,7 @@ void Charge_Mixing::mix_rho_recip(Charge* chr)
                   }
               };
         this->mixing->push_data(this->rho_mdata, rhog_in, rhog_out, screen, twobeta_mix, true);
-        this->mixing->cal_coef(this->rho_mdata, inner_product);
+        this->mixing->cal_coef(this->rho_mdata, inner_product, Charge_Mixing::reduce_inner_products);
         this->mixing->mix_data(this->rho_mdata, rhog_out);
     }
     else if (PARAM.inp.nspin == 4 && PARAM.inp.mixing_angle > 0)
@@ -197,7 +198,7 @@ void Charge_Mixing::mix_rho_recip(Charge* chr)
                   }
               };
         this->mixing->push_data(this->rho_mdata, rhog_in, rhog_out, screen, twobeta_mix, true);
-        this->mixing->cal_coef(this->rho_mdata, inner_product);
+        this->mixing->cal_coef(this->rho_mdata, inner_product, Charge_Mixing::reduce_inner_products);
         this->mixing->mix_data(this->rho_mdata, rhog_out);
         // get new |m| in real space using FT
         this->rhopw->recip2real(rhog_magabs + this->rhopw->npw, rho_magabs);
@@ -322,8 +323,8 @@ void Charge_Mixing::mix_rho_real(Charge* chr)
         auto screen = std::bind(&Charge_Mixing::Kerker_screen_real, this, std::placeholders::_1);
         this->mixing->push_data(this->rho_mdata, rhor_in, rhor_out, screen, true);    
         auto inner_product
-            = std::bind(&Charge_Mixing::inner_product_real, this, std::placeholders::_1, std::placeholders::_2);
-        this->mixing->cal_coef(this->rho_mdata, inner_product);
+            = std::bind(&Charge_Mixing::inner_product_real_local, this, std::placeholders::_1, std::placeholders::_2);
+        this->mixing->cal_coef(this->rho_mdata, inner_product, Charge_Mixing::reduce_inner_products);
         this->mixing->mix_data(this->rho_mdata, rhor_out);
     }
     else if (PARAM.inp.nspin == 2)
@@ -372,8 +373,8 @@ void Charge_Mixing::mix_rho_real(Charge* chr)
         };
         this->mixing->push_data(this->rho_mdata, rhor_in, rhor_out, screen, twobeta_mix, true);
         auto inner_product
-            = std::bind(&Charge_Mixing::inner_product_real, this, std::placeholders::_1, std::placeholders::_2);
-        this->mixing->cal_coef(this->rho_mdata, inner_product);
+            = std::bind(&Charge_Mixing::inner_product_real_local, this, std::placeholders::_1, std::placeholders::_2);
+        this->mixing->cal_coef(this->rho_mdata, inner_product, Charge_Mixing::reduce_inner_products);
         this->mixing->mix_data(this->rho_mdata, rhor_out);
         // get new rho[is][nrxx] from rho_mag[is*nrxx]
         for (int is = 0; is < PARAM.inp.nspin; is++)
@@ -417,8 +418,8 @@ void Charge_Mixing::mix_rho_real(Charge* chr)
         };
         this->mixing->push_data(this->rho_mdata, rhor_in, rhor_out, screen, twobeta_mix, true);
         auto inner_product
-            = std::bind(&Charge_Mixing::inner_product_real, this, std::placeholders::_1, std::placeholders::_2);
-        this->mixing->cal_coef(this->rho_mdata, inner_product);
+            = std::bind(&Charge_Mixing::inner_product_real_local, this, std::placeholders::_1, std::placeholders::_2);
+        this->mixing->cal_coef(this->rho_mdata, inner_product, Charge_Mixing::reduce_inner_products);
         this->mixing->mix_data(this->rho_mdata, rhor_out);
     }
     else if (PARAM.inp.nspin == 4 && PARAM.inp.mixing_angle > 0)
@@ -464,8 +465,8 @@ void Charge_Mixing::mix_rho_real(Charge* chr)
         };
         this->mixing->push_data(this->rho_mdata, rhor_in, rhor_out, screen, twobeta_mix, true);
         auto inner_product
-            = std::bind(&Charge_Mixing::inner_product_real, this, std::placeholders::_1, std::placeholders::_2);
-        this->mixing->cal_coef(this->rho_mdata, inner_product);
+            = std::bind(&Charge_Mixing::inner_product_real_local, this, std::placeholders::_1, std::placeholders::_2);
+        this->mixing->cal_coef(this->rho_mdata, inner_product, Charge_Mixing::reduce_inner_products);
         this->mixing->mix_data(this->rho_mdata, rhor_out);
         // use new |m| and angle to update {mx, my, mz}
         for (int ir = 0; ir < nrxx; ir++)
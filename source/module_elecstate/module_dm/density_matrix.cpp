@@ -1,9 +1,11 @@
 #include "density_matrix.h"
 
 #include "module_parameter/parameter.h"
+#include "module_base/global_function.h"
 #include "module_base/libm/libm.h"
 #include "module_base/memory.h"
 #include "module_base/timer.h"
+#include "module_base/tool_quit.h"
 #include "module_base/tool_title.h"
 #include "module_cell/klist.h"
 
@@ -372,6 +374,50 @@ void DensityMatrix<double, double>::cal_DMR(const int ik_in)
     ModuleBase::timer::tick("DensityMatrix", "cal_DMR");
 }
 
+// calculate DMK from DMR, only for gamma_only
+template <typename TK, typename TR>
+void DensityMatrix<TK, TR>::cal_DMK_from_DMR()
+{
+    ModuleBase::WARNING_QUIT("DensityMatrix::cal_DMK_from_DMR", "only gamma_only calculations are supported");
+}
+
+template <>
+void DensityMatrix<double, double>::cal_DMK_from_DMR()
+{
+    ModuleBase::TITLE("DensityMatrix", "cal_DMK_from_DMR");
+    ModuleBase::timer::tick("DensityMatrix", "cal_DMK_from_DMR");
+    int ld_hk = this->_paraV->nrow;
+    for (int is = 1; is <= this->_nspin; ++is)
+    {
+        int ik_begin = this->_nk * (is - 1); // jump this->_nk for spin_down if nspin==2
+        hamilt::HContainer<double>* tmp_DMR = this->_DMR[is - 1];
+        ModuleBase::GlobalFunc::ZEROS(this->_DMK[ik_begin].data(), this->_DMK[ik_begin].size());
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+        for (int i = 0; i < tmp_DMR->size_atom_pairs(); ++i)
+        {
+            hamilt::AtomPair<double>& tmp_ap = tmp_DMR->get_atom_pair(i);
+            int iat1 = tmp_ap.get_atom_i();
+            int iat2 = tmp_ap.get_atom_j();
+            int row_ap = this->_paraV->atom_begin_row[iat1];
+            int col_ap = this->_paraV->atom_begin_col[iat2];
+            // gamma_only DMR has only R = 0
+            const double* tmp_DMR_pointer = tmp_ap.get_pointer(0);
+            double* tmp_DMK_pointer = this->_DMK[ik_begin].data();
+            // transpose DMR row=>col, as in cal_DMR()
+            tmp_DMK_pointer += col_ap * this->_paraV->nrow + row_ap;
+            for (int mu = 0; mu < this->_paraV->get_row_size(iat1); ++mu)
+            {
+                BlasConnector::copy(this->_paraV->get_col_size(iat2), tmp_DMR_pointer, 1, tmp_DMK_pointer, ld_hk);
+                tmp_DMK_pointer += 1;
+                tmp_DMR_pointer += this->_paraV->get_col_size(iat2);
+            }
+        }
+    }
+    ModuleBase::timer::tick("DensityMatrix", "cal_DMK_from_DMR");
+}
+
 // switch_dmr
 template <typename TK, typename TR>
 void DensityMatrix<TK, TR>::switch_dmr(const int mode)
@@ -181,6 +181,13 @@ class DensityMatrix
      */
     void cal_DMR(const int ik_in = -1);
 
+    /**
+     * @brief calculate DMK from DMR, the reverse of cal_DMR() for gamma-only calculations
+     * used after the solvers giving DMR directly (foe), by the parts working on DMK.
+     * The elements of DMK out of the <I,J> pattern of DMR are zero.
+     */
+    void cal_DMK_from_DMR();
+
     /**
      * @brief calculate complex density matrix DMR with both real and imaginary part for noncollinear-spin calculation
      * the stored dm(k) has been used to calculate the passin DMR
@@ -217,13 +224,17 @@ class DensityMatrix
     
     std::vector<ModuleBase::ComplexMatrix> EDMK; // for TD-DFT
 
-#ifdef __PEXSI
     /**
-     * @brief EDM storage for PEXSI
+     * @brief EDM storage for PEXSI and FOE
      * used in MD calculation
      */
     std::vector<TK*> pexsi_EDM;
-#endif
+
+    /**
+     * @brief EDM(R) of each spin given by FOE, on the <I,J> pattern of DMR
+     * kept by the solver, used in the force calculation
+     */
+    std::vector<const hamilt::HContainer<TR>*> foe_EDMR;
 
   private:
     /**
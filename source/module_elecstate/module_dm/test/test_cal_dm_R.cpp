@@ -231,6 +231,52 @@ TEST_F(DMTest, cal_DMR_blas_double)
     delete kv;
 }
 
+TEST_F(DMTest, cal_DMK_from_DMR_double)
+{
+    // initalize a kvectors, Gamma-only
+    K_Vectors* kv = nullptr;
+    int nspin = 2;
+    int nks = 2; // since nspin = 2
+    kv = new K_Vectors;
+    kv->set_nks(nks);
+    kv->kvec_d.resize(nks);
+    // construct DM
+    elecstate::DensityMatrix<double, double> DM(paraV, nspin, kv->kvec_d, kv->get_nks() / nspin);
+    // set this->_DMK, different for each element and spin
+    for (int is = 1; is <= nspin; is++)
+    {
+        for (int i = 0; i < paraV->nrow; i++)
+        {
+            for (int j = 0; j < paraV->ncol; j++)
+            {
+                DM.set_DMK(is, 0, i, j, 0.1 * is + 0.01 * i + 0.001 * j);
+            }
+        }
+    }
+    // initialize this->_DMR
+    Grid_Driver gd(0, 0);
+    DM.init_DMR(&gd, &ucell);
+    for (int is = 1; is <= nspin; is++)
+    {
+        DM.get_DMR_pointer(is)->fix_gamma();
+    }
+    // DMK -> DMR -> DMK gives back the same DMK
+    DM.cal_DMR();
+    DM.set_DMK_zero();
+    DM.cal_DMK_from_DMR();
+    for (int is = 1; is <= nspin; is++)
+    {
+        for (int i = 0; i < paraV->nrow; i++)
+        {
+            for (int j = 0; j < paraV->ncol; j++)
+            {
+                EXPECT_NEAR(DM.get_DMK(is, 0, i, j), 0.1 * is + 0.01 * i + 0.001 * j, 1e-10);
+            }
+        }
+    }
+    delete kv;
+}
+
 TEST_F(DMTest, cal_DMR_blas_complex)
 {
     // get my rank of this process
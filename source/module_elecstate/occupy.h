@@ -65,6 +65,12 @@ public:
 
     static double wsweight(const ModuleBase::Vector3<double> &r, ModuleBase::Vector3<double> *rws,const int nrws);
 
+    // occupation of a state at (ef - e) / smearing_sigma = x for the smearing of type n
+    static double wgauss(const double& x, const int n);
+
+    // entropy term of the same state, demet = smearing_sigma * w1gauss(x, n)
+    static double w1gauss(const double& x, const int n);
+
 private:
   static void efermig(const ModuleBase::matrix& ekb,
                       const int nbnd,
@@ -87,10 +93,6 @@ private:
                       const int& is,
                       const std::vector<int>& isk);
 
-  static double wgauss(const double& x, const int n);
-
-  static double w1gauss(const double& x, const int n);
-
   //============================
   // Needed in tweights
   //============================
@@ -59,7 +59,7 @@ Potential::~Potential()
         }
     }
     else {
-        if (PARAM.inp.precision == "single") {
+        if (PARAM.inp.precision == "single" || PARAM.inp.precision == "mixed") {
             delmem_sh_op()(cpu_ctx, s_veff_smooth);
             delmem_sh_op()(cpu_ctx, s_vofk_smooth);
         }
@@ -142,11 +142,11 @@ void Potential::allocate()
         }
     }
     else {
-        if (PARAM.inp.precision == "single") {
+        if (PARAM.inp.precision == "single" || PARAM.inp.precision == "mixed") {
             resmem_sh_op()(cpu_ctx, s_veff_smooth, PARAM.inp.nspin * nrxx_smooth, "POT::sveff_smooth");
             resmem_sh_op()(cpu_ctx, s_vofk_smooth, PARAM.inp.nspin * nrxx_smooth, "POT::svofk_smooth");
         }
-        else {
+        if (PARAM.inp.precision != "single") {
             this->d_veff_smooth = this->veff_smooth.c;
             this->d_vofk_smooth = this->vofk_smooth.c;
         }
@@ -206,7 +206,7 @@ void Potential::update_from_charge(const Charge*const chg, const UnitCell*const
         }
     }
     else {
-        if (PARAM.inp.precision == "single") {
+        if (PARAM.inp.precision == "single" || PARAM.inp.precision == "mixed") {
             castmem_d2s_h2h_op()(cpu_ctx,
                                  cpu_ctx,
                                  s_veff_smooth,
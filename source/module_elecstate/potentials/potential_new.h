@@ -75,6 +75,13 @@ class Potential : public PotBase
 
     PotBase* get_pot_type(const std::string& pot_type);
 
+    // etxc and vtxc of an XC potential which is not a component, e.g. the one on the atom grids of LCAO
+    void set_etxc_vtxc(const double etxc_in, const double vtxc_in)
+    {
+        *this->etxc_ = etxc_in;
+        *this->vtxc_ = vtxc_in;
+    }
+
     // interfaces to get values
     ModuleBase::matrix& get_effective_v()
     {
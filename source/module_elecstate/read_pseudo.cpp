@@ -6,9 +6,22 @@
 #include "module_base/parallel_common.h"
 
 #include <cstring> // Peize Lin fix bug about strcmp 2016-08-02
+#include <map>
 
 namespace elecstate {
 
+namespace
+{
+// pseudopotentials already read by rank 0 in the batch mode (stru_batch),
+// keyed by the file, its type and the flags changing what is read
+struct Pseudo_Cached
+{
+    Atom_pseudo ncpp;
+    bool coulomb_potential = false;
+};
+std::map<std::string, Pseudo_Cached> pseudo_cache;
+} // namespace
+
 void read_pseudo(std::ofstream& ofs, UnitCell& ucell) {
     // read in non-local pseudopotential and ouput the projectors.
     ofs << "\n\n\n\n";
@@ -256,20 +269,37 @@ void read_cell_pseudopots(const std::string& pp_dir, std::ofstream& log, UnitCel
         int error = 0;
         int error_ap = 0;
 
+        // the same file is read only once in the batch mode
+        const bool use_cache = (PARAM.inp.stru_batch != "none");
+        bool from_cache = false;
+        std::string cache_key;
+
         if (GlobalV::MY_RANK == 0)
         {
             pp_address = pp_dir + ucell.pseudo_fn[i];
-            error = upf.init_pseudo_reader(pp_address, ucell.pseudo_type[i], ucell.atoms[i].ncpp); // xiaohui add 2013-06-23
-
-            if (error == 0) // mohan add 2021-04-16
+            cache_key = pp_address + " " + ucell.pseudo_type[i] + " " + std::to_string(upf.coulomb_potential) + " "
+                        + std::to_string(ucell.atoms[i].flag_empty_element);
+            auto cached = pseudo_cache.find(cache_key);
+            if (use_cache && cached != pseudo_cache.end())
+            {
+                ucell.atoms[i].ncpp = cached->second.ncpp;
+                upf.coulomb_potential = cached->second.coulomb_potential;
+                from_cache = true;
+            }
+            else
             {
-                if (ucell.atoms[i].flag_empty_element) // Peize Lin add for bsse 2021.04.07
+                error = upf.init_pseudo_reader(pp_address, ucell.pseudo_type[i], ucell.atoms[i].ncpp); // xiaohui add 2013-06-23
+
+                if (error == 0) // mohan add 2021-04-16
                 {
-                    upf.set_empty_element(ucell.atoms[i].ncpp);
+                    if (ucell.atoms[i].flag_empty_element) // Peize Lin add for bsse 2021.04.07
+                    {
+                        upf.set_empty_element(ucell.atoms[i].ncpp);
+                    }
+                    upf.set_upf_q(ucell.atoms[i].ncpp); // liuyu add 2023-09-21
+                    // average pseudopotential if needed
+                    error_ap = upf.average_p(PARAM.inp.soc_lambda, ucell.atoms[i].ncpp); // added by zhengdy 2020-10-20
                 }
-                upf.set_upf_q(ucell.atoms[i].ncpp); // liuyu add 2023-09-21
-                // average pseudopotential if needed
-                error_ap = upf.average_p(PARAM.inp.soc_lambda, ucell.atoms[i].ncpp); // added by zhengdy 2020-10-20
             }
             ucell.atoms[i].coulomb_potential = upf.coulomb_potential;
         }
@@ -311,7 +341,15 @@ void read_cell_pseudopots(const std::string& pp_dir, std::ofstream& log, UnitCel
 
         if (GlobalV::MY_RANK == 0)
         {
-		    upf.complete_default(ucell.atoms[i].ncpp);
+            if (!from_cache)
+            {
+                upf.complete_default(ucell.atoms[i].ncpp);
+                if (use_cache)
+                {
+                    pseudo_cache[cache_key].ncpp = ucell.atoms[i].ncpp;
+                    pseudo_cache[cache_key].coulomb_potential = upf.coulomb_potential;
+                }
+            }
             log << "\n Read in pseudopotential file is " << ucell.pseudo_fn[i] << std::endl;
             ModuleBase::GlobalFunc::OUT(log, "pseudopotential type", ucell.atoms[i].ncpp.pp_type);
             ModuleBase::GlobalFunc::OUT(log, "exchange-correlation functional", ucell.atoms[i].ncpp.xc_func);
@@ -1,5 +1,6 @@
 #include "esolver_ks.h"
 
+#include "module_base/memory.h"
 #include "module_base/timer.h"
 #include "module_cell/cal_atoms_info.h"
 #include "module_io/cube_io.h"
@@ -428,7 +429,10 @@ void ESolver_KS<T, Device>::runner(UnitCell& ucell, const int istep)
     ModuleBase::timer::tick(this->classname, "runner");
 
     // 2) before_scf (electronic iteration loops)
-    this->before_scf(ucell, istep);
+    {
+        ModuleBase::Memory::Scope scope("ESolver_KS::before_scf");
+        this->before_scf(ucell, istep);
+    }
 
     // 3) write charge density
     if (PARAM.inp.dm_to_rho)
@@ -449,10 +453,16 @@ void ESolver_KS<T, Device>::runner(UnitCell& ucell, const int istep)
         this->iter_init(ucell, istep, iter);
 
         // 6) use Hamiltonian to obtain charge density
-        this->hamilt2density(ucell, istep, iter, diag_ethr);
+        {
+            ModuleBase::Memory::Scope scope("ESolver_KS::hamilt2density");
+            this->hamilt2density(ucell, istep, iter, diag_ethr);
+        }
 
         // 7) finish scf iterations
-        this->iter_finish(ucell, istep, iter);
+        {
+            ModuleBase::Memory::Scope scope("ESolver_KS::iter_finish");
+            this->iter_finish(ucell, istep, iter);
+        }
 
         // 8) check convergence
         if (this->conv_esolver || this->oscillate_esolver)
@@ -467,7 +477,10 @@ void ESolver_KS<T, Device>::runner(UnitCell& ucell, const int istep)
     } // end scf iterations
 
     // 9) after scf
-    this->after_scf(ucell, istep);
+    {
+        ModuleBase::Memory::Scope scope("ESolver_KS::after_scf");
+        this->after_scf(ucell, istep);
+    }
 
     ModuleBase::timer::tick(this->classname, "runner");
     return;
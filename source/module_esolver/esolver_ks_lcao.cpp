@@ -58,6 +58,7 @@
 //-----HSolver ElecState Hamilt--------
 #include "module_elecstate/elecstate_lcao.h"
 #include "module_hamilt_lcao/hamilt_lcaodft/hamilt_lcao.h"
+#include "module_hamilt_lcao/hamilt_lcaodft/operator_lcao/vxc_atom_lcao.h"
 #include "module_hsolver/hsolver_lcao.h"
 // function used by deepks
 // #include "module_elecstate/cal_dm.h"
@@ -66,6 +67,7 @@
 // test RDMFT
 #include "module_rdmft/rdmft.h"
 
+#include <algorithm>
 #include <iostream>
 
 namespace ModuleESolver
@@ -104,6 +106,8 @@ ESolver_KS_LCAO<TK, TR>::ESolver_KS_LCAO()
 template <typename TK, typename TR>
 ESolver_KS_LCAO<TK, TR>::~ESolver_KS_LCAO()
 {
+    // the two-center tables are kept for the next structure in the batch mode
+    LCAO_domain::keep_basis_lcao(this->two_center_bundle_);
 }
 
 //------------------------------------------------------------------------------
@@ -737,7 +741,11 @@ void ESolver_KS_LCAO<TK, TR>::hamilt2density_single(UnitCell& ucell, int istep,
     }
     if (!skip_solve)
     {
+#ifdef __MPI
+        hsolver::HSolverLCAO<TK> hsolver_lcao_obj(&(this->pv), PARAM.inp.ks_solver, this->foe.get());
+#else
         hsolver::HSolverLCAO<TK> hsolver_lcao_obj(&(this->pv), PARAM.inp.ks_solver);
+#endif
         hsolver_lcao_obj.solve(this->p_hamilt, this->psi[0], this->pelec, skip_charge);
     }
 
@@ -802,6 +810,12 @@ void ESolver_KS_LCAO<TK, TR>::iter_finish(UnitCell& ucell, const int istep, int&
 {
     ModuleBase::TITLE("ESolver_KS_LCAO", "iter_finish");
 
+    // DM(k) is not given by foe, it is only made for the DFT+U and DeePKS below
+    if (PARAM.inp.ks_solver == "foe" && ((PARAM.inp.dft_plus_u == 2 && GlobalC::dftu.omc != 2) || PARAM.inp.deepks_scf))
+    {
+        dynamic_cast<elecstate::ElecStateLCAO<TK>*>(this->pelec)->get_DM()->cal_DMK_from_DMR();
+    }
+
     // 6) calculate the local occupation number matrix and energy correction in
     // DFT+U
     if (PARAM.inp.dft_plus_u)
@@ -844,6 +858,18 @@ void ESolver_KS_LCAO<TK, TR>::iter_finish(UnitCell& ucell, const int istep, int&
         sc.cal_mi_lcao(iter);
     }
 
+    // 9) the density on the atom grids has to converge as well as that of the FFT grid
+    if (PARAM.inp.atom_grid)
+    {
+        auto* vxc_atom = dynamic_cast<hamilt::HamiltLCAO<TK, TR>*>(this->p_hamilt)->get_vxc_atom();
+        if (vxc_atom != nullptr)
+        {
+            const double drho_atom = vxc_atom->cal_drho(PARAM.inp.nelec);
+            GlobalV::ofs_running << " DRHO on the atom grids = " << drho_atom << std::endl;
+            this->drho = std::max(this->drho, drho_atom);
+        }
+    }
+
     // call iter_finish() of ESolver_KS
     ESolver_KS<TK>::iter_finish(ucell, istep, iter);
 
@@ -924,6 +950,12 @@ void ESolver_KS_LCAO<TK, TR>::after_scf(UnitCell& ucell, const int istep)
     ModuleBase::TITLE("ESolver_KS_LCAO", "after_scf");
     ModuleBase::timer::tick("ESolver_KS_LCAO", "after_scf");
 
+    // 0) DM(k) is not given by foe, it is made from DM(R) for the output and the next ionic step
+    if (PARAM.inp.ks_solver == "foe")
+    {
+        dynamic_cast<elecstate::ElecStateLCAO<TK>*>(this->pelec)->get_DM()->cal_DMK_from_DMR();
+    }
+
     // 1) calculate the kinetic energy density tau, sunliang 2024-09-18
     if (PARAM.inp.out_elf[0] > 0)
     {
@@ -17,6 +17,11 @@
 
 #include <memory>
 
+namespace hsolver
+{
+template <typename T>
+class DiagoFoe;
+}
 namespace LR
 {
     template<typename T, typename TR>
@@ -92,6 +97,11 @@ class ESolver_KS_LCAO : public ESolver_KS<TK> {
     void beforesolver(const int istep);
     //---------------------------------------------------------------------
 
+#ifdef __MPI
+    // the foe solver keeps the sparsity patterns and EDM(R) during the SCF of one ionic step
+    std::shared_ptr<hsolver::DiagoFoe<TK>> foe = nullptr;
+#endif
+
 #ifdef __EXX
     std::shared_ptr<Exx_LRI_Interface<TK, double>> exd = nullptr;
     std::shared_ptr<Exx_LRI_Interface<TK, std::complex<double>>> exc = nullptr;
@@ -114,8 +114,18 @@ ESolver_KS_PW<T, Device>::~ESolver_KS_PW()
         delete reinterpret_cast<psi::Psi<std::complex<double>, Device>*>(this->__kspw_psi);
     }
 
+    this->switch_to_double_precision();
+    if (this->pelec_sp != nullptr)
+    {
+        // the potential belongs to pelec
+        this->pelec_sp->pot = nullptr;
+        delete this->pelec_sp;
+        this->pelec_sp = nullptr;
+    }
+
     delete this->psi;
     delete this->p_wf_init;
+    delete this->p_psi_extrap;
 }
 
 template <typename T, typename Device>
@@ -133,6 +143,70 @@ void ESolver_KS_PW<T, Device>::deallocate_hamilt()
     }
 }
 
+template <typename T, typename Device>
+void ESolver_KS_PW<T, Device>::init_single_precision(UnitCell& ucell)
+{
+    ModuleBase::TITLE("ESolver_KS_PW", "init_single_precision");
+
+    // drop the copies left by an SCF loop that did not reach the switch
+    this->switch_to_double_precision();
+
+    this->kspw_psi_sp = new psi::Psi<std::complex<float>, Device>(this->kspw_psi[0]);
+    ModuleBase::Memory::record("Psi_single", sizeof(std::complex<float>) * this->kspw_psi_sp->size());
+
+    this->p_hamilt_sp = new hamilt::HamiltPW<std::complex<float>, Device>(this->pelec->pot,
+                                                                         this->pw_wfc,
+                                                                         &this->kv,
+                                                                         &this->ppcell,
+                                                                         &ucell);
+
+    if (this->pelec_sp == nullptr)
+    {
+        this->pelec_sp = new elecstate::ElecStatePW<std::complex<float>, Device>(this->pw_wfc,
+                                                                                 &(this->chr),
+                                                                                 &(this->kv),
+                                                                                 &ucell,
+                                                                                 &this->ppcell,
+                                                                                 this->pw_rhod,
+                                                                                 this->pw_rho,
+                                                                                 this->pw_big);
+    }
+    this->pelec_sp->pot = this->pelec->pot;
+    this->pelec_sp->omega = this->pelec->omega;
+    this->pelec_sp->skip_weights = this->pelec->skip_weights;
+    this->pelec_sp->wg = this->pelec->wg;
+    this->pelec_sp->ekb = this->pelec->ekb;
+    this->pelec_sp->eferm = this->pelec->eferm;
+
+    this->mixed_precision.start(PARAM.inp.precision);
+}
+
+template <typename T, typename Device>
+void ESolver_KS_PW<T, Device>::switch_to_double_precision()
+{
+    if (this->kspw_psi_sp == nullptr)
+    {
+        return;
+    }
+    ModuleBase::TITLE("ESolver_KS_PW", "switch_to_double_precision");
+
+    if (this->mixed_precision.in_single())
+    {
+        base_device::memory::cast_memory_op<T, std::complex<float>, Device, Device>()(
+            this->ctx,
+            this->ctx,
+            this->kspw_psi[0].get_pointer() - this->kspw_psi[0].get_psi_bias(),
+            this->kspw_psi_sp[0].get_pointer() - this->kspw_psi_sp[0].get_psi_bias(),
+            this->kspw_psi[0].size());
+        this->mixed_precision.stop();
+    }
+
+    delete this->kspw_psi_sp;
+    this->kspw_psi_sp = nullptr;
+    delete reinterpret_cast<hamilt::HamiltPW<std::complex<float>, Device>*>(this->p_hamilt_sp);
+    this->p_hamilt_sp = nullptr;
+}
+
 template <typename T, typename Device>
 void ESolver_KS_PW<T, Device>::before_all_runners(UnitCell& ucell, const Input_para& inp)
 {
@@ -235,6 +309,19 @@ void ESolver_KS_PW<T, Device>::before_all_runners(UnitCell& ucell, const Input_p
     {
         ModuleBase::Memory::record("Psi_single", sizeof(T) * this->psi[0].size());
     }
+
+    //! the projection in the extrapolation of psi assumes the overlap S = 1, i.e. norm-conserving pseudopotentials
+    if (PARAM.inp.wfc_extrap != "none" && this->p_psi_extrap == nullptr)
+    {
+        if (PARAM.globalv.use_uspp)
+        {
+            ModuleBase::WARNING("ESolver_KS_PW", "wfc_extrap is not supported with ultrasoft pseudopotentials, ignored");
+        }
+        else
+        {
+            this->p_psi_extrap = new psi::PsiExtrap<T, Device>(PARAM.inp.wfc_extrap);
+        }
+    }
     ModuleBase::GlobalFunc::DONE(GlobalV::ofs_running, "INIT BASIS");
 
     //! 9) setup occupations
@@ -265,6 +352,12 @@ void ESolver_KS_PW<T, Device>::before_scf(UnitCell& ucell, const int istep)
         this->pw_wfc->collect_local_pw(PARAM.inp.erf_ecut, PARAM.inp.erf_height, PARAM.inp.erf_sigma);
 
         this->p_wf_init->make_table(this->kv.get_nks(), &this->sf, &this->ppcell, ucell);
+
+        // the stored wave functions belong to the old plane-wave basis
+        if (this->p_psi_extrap != nullptr)
+        {
+            this->p_psi_extrap->clear();
+        }
     }
     if (ucell.ionic_position_updated)
     {
@@ -413,7 +506,21 @@ void ESolver_KS_PW<T, Device>::before_scf(UnitCell& ucell, const int istep)
     // time before scf. But for random wavefunction, we dont, because random
     // wavefunction is not related to atomic coordinates. What the old strategy
     // does is only to initialize for once...
-    if (((PARAM.inp.init_wfc == "random") && (istep == 0)) || (PARAM.inp.init_wfc != "random"))
+    //
+    // with wfc_extrap, psi is predicted from the converged psi of the previous
+    // ionic steps instead, once enough steps are stored.
+    bool psi_extrapolated = false;
+    if (this->p_psi_extrap != nullptr && ucell.ionic_position_updated)
+    {
+        psi_extrapolated = this->p_psi_extrap->extrapolate(this->kspw_psi[0]);
+        if (psi_extrapolated)
+        {
+            GlobalV::ofs_running << " Extrapolate wave functions from " << this->p_psi_extrap->get_nhist()
+                                 << " previous ionic steps (" << PARAM.inp.wfc_extrap << ")" << std::endl;
+        }
+    }
+    if (!psi_extrapolated
+        && (((PARAM.inp.init_wfc == "random") && (istep == 0)) || (PARAM.inp.init_wfc != "random")))
     {
         this->p_wf_init->initialize_psi(this->psi,
                                         this->kspw_psi,
@@ -429,6 +536,12 @@ void ESolver_KS_PW<T, Device>::before_scf(UnitCell& ucell, const int istep)
         }
     }
 
+    // every SCF loop of precision = mixed starts in single precision
+    if (PARAM.inp.precision == "mixed")
+    {
+        this->init_single_precision(ucell);
+    }
+
     ModuleBase::timer::tick("ESolver_KS_PW", "before_scf");
 }
 
@@ -544,7 +657,45 @@ void ESolver_KS_PW<T, Device>::hamilt2density_single(UnitCell& ucell,
             skip_solve = true;
         }
     }
-    if (!skip_solve)
+    if (!skip_solve && this->mixed_precision.in_single())
+    {
+        using Tsp = std::complex<float>;
+        hsolver::DiagoIterAssist<Tsp, Device>::need_subspace = hsolver::DiagoIterAssist<T, Device>::need_subspace;
+        hsolver::DiagoIterAssist<Tsp, Device>::SCF_ITER = iter;
+        hsolver::DiagoIterAssist<Tsp, Device>::PW_DIAG_NMAX = hsolver::DiagoIterAssist<T, Device>::PW_DIAG_NMAX;
+        // keep the diag ethr above the single-precision limit of convergence, see hsolver::set_diagethr_ks
+        hsolver::DiagoIterAssist<Tsp, Device>::PW_DIAG_THR = std::max(ethr, 0.5e-4);
+
+        hsolver::HSolverPW<Tsp, Device> hsolver_pw_obj(this->pw_wfc,
+                                                       PARAM.inp.calculation,
+                                                       PARAM.inp.basis_type,
+                                                       PARAM.inp.ks_solver,
+                                                       PARAM.inp.use_paw,
+                                                       PARAM.globalv.use_uspp,
+                                                       PARAM.inp.nspin,
+                                                       hsolver::DiagoIterAssist<Tsp, Device>::SCF_ITER,
+                                                       hsolver::DiagoIterAssist<Tsp, Device>::PW_DIAG_NMAX,
+                                                       hsolver::DiagoIterAssist<Tsp, Device>::PW_DIAG_THR,
+                                                       hsolver::DiagoIterAssist<Tsp, Device>::need_subspace);
+
+        hsolver_pw_obj.solve(this->p_hamilt_sp,
+                             this->kspw_psi_sp[0],
+                             this->pelec_sp,
+                             this->pelec_sp->ekb.c,
+                             GlobalV::RANK_IN_POOL,
+                             GlobalV::NPROC_IN_POOL,
+                             skip_charge,
+                             ucell.tpiba,
+                             ucell.nat);
+
+        // the charge density is shared, the band energies and occupations are copied back
+        this->pelec->ekb = this->pelec_sp->ekb;
+        this->pelec->wg = this->pelec_sp->wg;
+        this->pelec->eferm = this->pelec_sp->eferm;
+        this->pelec->f_en.eband = this->pelec_sp->f_en.eband;
+        this->pelec->f_en.demet = this->pelec_sp->f_en.demet;
+    }
+    else if (!skip_solve)
     {
         hsolver::HSolverPW<T, Device> hsolver_pw_obj(this->pw_wfc,
                                                      PARAM.inp.calculation,
@@ -567,6 +718,13 @@ void ESolver_KS_PW<T, Device>::hamilt2density_single(UnitCell& ucell,
                              skip_charge,
                              ucell.tpiba,
                              ucell.nat);
+
+        // wfc_extrap = aspc: the bands of the first iteration are corrected with the extrapolated ones,
+        // the charge density of this iteration is kept
+        if (this->p_psi_extrap != nullptr && iter == 1 && this->p_psi_extrap->correct(this->kspw_psi[0]))
+        {
+            GlobalV::ofs_running << " Correct the extrapolated wave functions (aspc)" << std::endl;
+        }
     }
 
     Symmetry_rho srho;
@@ -608,6 +766,16 @@ void ESolver_KS_PW<T, Device>::iter_finish(UnitCell& ucell, const int istep, int
     // 1) Call iter_finish() of ESolver_KS
     ESolver_KS<T, Device>::iter_finish(ucell, istep, iter);
 
+    // 1.1) precision = mixed: continue in double precision once drho is small enough,
+    // a density converged in single precision is refined by at least one double-precision iteration
+    // on the potential already set by ESolver_KS::iter_finish()
+    if (this->mixed_precision.to_double(this->drho, PARAM.inp.precision_switch_thr, this->conv_esolver))
+    {
+        this->switch_to_double_precision();
+        GlobalV::ofs_running << " Switch from single to double precision at iter " << iter << ", drho = " << this->drho
+                             << std::endl;
+    }
+
     // 2) Update USPP-related quantities
     // D in uspp need vloc, thus needs update when veff updated
     // calculate the effective coefficient matrix for non-local pseudopotential
@@ -656,6 +824,15 @@ void ESolver_KS_PW<T, Device>::after_scf(UnitCell& ucell, const int istep)
     ModuleBase::TITLE("ESolver_KS_PW", "after_scf");
     ModuleBase::timer::tick("ESolver_KS_PW", "after_scf");
 
+    // 0) precision = mixed: the SCF loop may stop before the switch, e.g. when scf_nmax is reached
+    this->switch_to_double_precision();
+
+    // keep the converged psi for the extrapolation of the next ionic step
+    if (this->p_psi_extrap != nullptr)
+    {
+        this->p_psi_extrap->save(this->kspw_psi[0]);
+    }
+
     // 1) calculate the kinetic energy density tau, sunliang 2024-09-18
     if (PARAM.inp.out_elf[0] > 0)
     {
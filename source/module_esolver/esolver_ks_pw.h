@@ -1,7 +1,10 @@
 #ifndef ESOLVER_KS_PW_H
 #define ESOLVER_KS_PW_H
 #include "./esolver_ks.h"
+#include "./mixed_precision.h"
+#include "module_elecstate/elecstate_pw.h"
 #include "module_hamilt_pw/hamilt_pwdft/operator_pw/velocity_pw.h"
+#include "module_psi/psi_extrap.h"
 #include "module_psi/psi_init.h"
 
 #include <memory>
@@ -49,6 +52,12 @@ class ESolver_KS_PW : public ESolver_KS<T, Device>
     virtual void allocate_hamilt(const UnitCell& ucell);
     virtual void deallocate_hamilt();
 
+    //! precision = mixed: make single-precision copies of psi and the Hamiltonian for the first SCF iterations
+    void init_single_precision(UnitCell& ucell);
+
+    //! precision = mixed: promote psi to double precision and free the single-precision copies
+    void switch_to_double_precision();
+
     //! hide the psi in ESolver_KS for tmp use
     psi::Psi<std::complex<double>, base_device::DEVICE_CPU>* psi = nullptr;
 
@@ -65,6 +74,19 @@ class ESolver_KS_PW : public ESolver_KS<T, Device>
 
     bool already_initpsi = false;
 
+    //! extrapolation of psi between ionic steps, nullptr if wfc_extrap = none
+    psi::PsiExtrap<T, Device>* p_psi_extrap = nullptr;
+
+    //! precision = mixed: whether the SCF iterations run on the single-precision objects below
+    Mixed_Precision mixed_precision;
+
+    psi::Psi<std::complex<float>, Device>* kspw_psi_sp = nullptr;
+
+    hamilt::Hamilt<std::complex<float>, Device>* p_hamilt_sp = nullptr;
+
+    //! shares charge and potential with pelec, only used to build rho from the single-precision psi
+    elecstate::ElecStatePW<std::complex<float>, Device>* pelec_sp = nullptr;
+
     using castmem_2d_d2h_op
         = base_device::memory::cast_memory_op<std::complex<double>, T, base_device::DEVICE_CPU, Device>;
 
@@ -2,7 +2,11 @@
 #include "module_elecstate/module_charge/symmetry_rho.h"
 #include "module_esolver/esolver_ks_lcao.h"
 #include "module_hamilt_lcao/hamilt_lcaodft/hamilt_lcao.h"
+#include "module_hamilt_lcao/hamilt_lcaodft/operator_lcao/vxc_atom_lcao.h"
 #include "module_hamilt_lcao/module_dftu/dftu.h"
+#ifdef __MPI
+#include "module_hsolver/diago_foe.h"
+#endif
 #include "module_hamilt_pw/hamilt_pwdft/global.h"
 //
 #include "module_base/timer.h"
@@ -204,6 +208,16 @@ void ESolver_KS_LCAO<TK, TR>::before_scf(UnitCell& ucell, const int istep)
         );
     }
 
+    // the density on the atom grids is mixed with the coefficients of the charge mixing
+    if (PARAM.inp.atom_grid)
+    {
+        auto* vxc_atom = dynamic_cast<hamilt::HamiltLCAO<TK, TR>*>(this->p_hamilt)->get_vxc_atom();
+        if (vxc_atom != nullptr)
+        {
+            vxc_atom->set_mixing(this->p_chgmix);
+        }
+    }
+
 #ifdef __DEEPKS
     // for each ionic step, the overlap <phi|alpha> must be rebuilt
     // since it depends on ionic positions
@@ -312,6 +326,15 @@ void ESolver_KS_LCAO<TK, TR>::before_scf(UnitCell& ucell, const int istep)
         dynamic_cast<elecstate::ElecStateLCAO<TK>*>(this->pelec)->get_DM()->cal_DMR();
     }
 
+#ifdef __MPI
+    // the patterns of foe are made again for the new H(R) and DM(R)
+    if (PARAM.inp.ks_solver == "foe")
+    {
+        dynamic_cast<elecstate::ElecStateLCAO<TK>*>(this->pelec)->get_DM()->foe_EDMR.clear();
+        this->foe = std::make_shared<hsolver::DiagoFoe<TK>>(&(this->pv));
+    }
+#endif
+
     if (PARAM.inp.dm_to_rho)
     {
         std::string zipname = "output_DM0.npz";
@@ -0,0 +1,59 @@
+#ifndef MIXED_PRECISION_H
+#define MIXED_PRECISION_H
+
+#include <string>
+
+namespace ModuleESolver
+{
+
+/**
+ * @brief the precision of the SCF iterations of precision = mixed
+ * Each SCF loop starts in single precision and goes on in double precision after the first iteration
+ * whose drho is below precision_switch_thr. A density converged in single precision is refined by at
+ * least one double-precision iteration.
+ */
+class Mixed_Precision
+{
+  public:
+    /// an SCF loop starts, in single precision if precision is mixed
+    void start(const std::string& precision)
+    {
+        this->single = (precision == "mixed");
+    }
+
+    /// the SCF iterations go on in double precision
+    void stop()
+    {
+        this->single = false;
+    }
+
+    /// whether the SCF iterations run in single precision
+    bool in_single() const
+    {
+        return this->single;
+    }
+
+    /**
+     * @brief whether to go on in double precision after this iteration, stop() is called by the caller
+     * once the wavefunctions are promoted
+     * @param drho the charge density error of this iteration
+     * @param thr precision_switch_thr
+     * @param conv whether the SCF converged, reset to false if it converged in single precision
+     */
+    bool to_double(const double drho, const double thr, bool& conv) const
+    {
+        if (!this->single || (drho >= thr && !conv))
+        {
+            return false;
+        }
+        conv = false;
+        return true;
+    }
+
+  private:
+    bool single = false;
+};
+
+} // namespace ModuleESolver
+
+#endif
@@ -0,0 +1,93 @@
+#include "gtest/gtest.h"
+
+#include "../mixed_precision.h"
+
+#include <vector>
+
+/************************************************
+ *  unit tests of class Mixed_Precision
+ ***********************************************/
+
+/**
+ * - Tested Functions:
+ *   - Mixed_Precision::start(): only precision = mixed starts in single precision
+ *   - Mixed_Precision::to_double(): an SCF loop as in ESolver_KS_PW::iter_finish() switches to double
+ *     at the first iteration whose drho is below precision_switch_thr, and stays in double
+ *   - a density converged in single precision is not taken as converged
+ */
+
+namespace
+{
+// drho of an SCF loop, the switch comes at the 4th iteration
+const std::vector<double> drho = {1.0e-1, 2.0e-2, 3.0e-3, 4.0e-5, 3.0e-7, 1.0e-9};
+const double thr = 1.0e-4;
+const double scf_thr = 1.0e-8;
+} // namespace
+
+TEST(MixedPrecisionTest, Start)
+{
+    ModuleESolver::Mixed_Precision mp;
+    EXPECT_FALSE(mp.in_single());
+    mp.start("double");
+    EXPECT_FALSE(mp.in_single());
+    mp.start("single");
+    EXPECT_FALSE(mp.in_single());
+    mp.start("mixed");
+    EXPECT_TRUE(mp.in_single());
+    mp.stop();
+    EXPECT_FALSE(mp.in_single());
+}
+
+TEST(MixedPrecisionTest, SwitchAtThreshold)
+{
+    ModuleESolver::Mixed_Precision mp;
+    // two SCF loops, e.g. two ionic steps, both start in single precision
+    for (int istep = 0; istep < 2; ++istep)
+    {
+        mp.start("mixed");
+        std::vector<bool> single;
+        int switch_iter = -1;
+        for (int iter = 0; iter < static_cast<int>(drho.size()); ++iter)
+        {
+            single.push_back(mp.in_single());
+            bool conv = drho[iter] < scf_thr;
+            if (mp.to_double(drho[iter], thr, conv))
+            {
+                EXPECT_EQ(switch_iter, -1);
+                switch_iter = iter;
+                mp.stop();
+            }
+            EXPECT_EQ(conv, drho[iter] < scf_thr);
+        }
+        EXPECT_EQ(switch_iter, 3);
+        const std::vector<bool> ref = {true, true, true, true, false, false};
+        EXPECT_EQ(single, ref);
+    }
+}
+
+TEST(MixedPrecisionTest, ConvergedInSingle)
+{
+    ModuleESolver::Mixed_Precision mp;
+    mp.start("mixed");
+    // the single-precision iterations converged before drho reached precision_switch_thr
+    bool conv = true;
+    EXPECT_TRUE(mp.to_double(1.0e-3, thr, conv));
+    EXPECT_FALSE(conv);
+    mp.stop();
+
+    // then the double-precision iterations converge as usual
+    conv = true;
+    EXPECT_FALSE(mp.to_double(1.0e-9, thr, conv));
+    EXPECT_TRUE(conv);
+}
+
+TEST(MixedPrecisionTest, Double)
+{
+    ModuleESolver::Mixed_Precision mp;
+    mp.start("double");
+    bool conv = false;
+    EXPECT_FALSE(mp.to_double(1.0e-9, thr, conv));
+    conv = true;
+    EXPECT_FALSE(mp.to_double(1.0e-9, thr, conv));
+    EXPECT_TRUE(conv);
+}
@@ -88,9 +88,11 @@ ModuleBase::matrix surchem::cal_vel(const UnitCell& cell,
     double *tmp_Vel = new double[rho_basis->nrxx];
     ModuleBase::GlobalFunc::ZEROS(tmp_Vel, rho_basis->nrxx);
 
-    // Calculate Sol_phi with epsilon.
+    // Calculate Sol_phi with epsilon, starting from the solution of the last SCF iteration or ionic step.
     ncgsol = 0;
-    minimize_cg(cell, rho_basis, epsilon, B, Sol_phi, ncgsol);
+    const bool warm_start = (this->Sol_phi_last.size() == rho_basis->npw);
+    minimize_cg(cell, rho_basis, epsilon, B, Sol_phi, ncgsol, warm_start ? this->Sol_phi_last.data() : nullptr);
+    this->Sol_phi_last.assign(Sol_phi, Sol_phi + rho_basis->npw);
 
     ncgsol = 0;
     // Calculate Sol_phi0 with epsilon0.
@@ -1,3 +1,4 @@
+#include "module_base/timer.h"
 #include "module_hamilt_general/module_xc/xc_functional.h"
 #include "surchem.h"
 
@@ -6,8 +7,10 @@ void surchem::minimize_cg(const UnitCell& ucell,
                           double* d_eps,
                           const complex<double>* tot_N,
                           complex<double>* phi,
-                          int& ncgsol)
+                          int& ncgsol,
+                          const complex<double>* phi_guess)
 {
+    ModuleBase::timer::tick("surchem", "minimize_cg");
     // parameters of CG method
     double alpha = 0;
     double beta = 0;
@@ -56,12 +59,12 @@ void surchem::minimize_cg(const UnitCell& ucell,
         gsqu[ig].imag(0);
     }
 
-    // init guess for phi
-    // 'totN' = 4pi*totN
+    // init guess for phi: the solution of the last call if given,
+    // otherwise the solution in vacuum, 'totN' = 4pi*totN
     for (int ig = 0; ig < rho_basis->npw; ig++)
     {
         if(ig == ig0) continue;
-        phi[ig] = tot_N[ig] * gsqu[ig];
+        phi[ig] = (phi_guess != nullptr) ? phi_guess[ig] : tot_N[ig] * gsqu[ig];
     }
 
     // call leps to calculate div ( epsilon * grad ) phi
@@ -148,6 +151,8 @@ void surchem::minimize_cg(const UnitCell& ucell,
 
     // output: num of cg loop
     ncgsol = count;
+    ModuleBase::GlobalFunc::OUT(GlobalV::ofs_running, "generalized Poisson CG steps", count);
+    ModuleBase::GlobalFunc::OUT(GlobalV::ofs_running, "generalized Poisson residual", sqrt(r2));
 
     // comment test res
     delete[] resid;
@@ -159,6 +164,7 @@ void surchem::minimize_cg(const UnitCell& ucell,
     delete[] gradphi_y;
     delete[] gradphi_z;
     delete[] phi_work;
+    ModuleBase::timer::tick("surchem", "minimize_cg");
 }
 
 void surchem::Leps2(const UnitCell& ucell,
@@ -175,77 +181,25 @@ void surchem::Leps2(const UnitCell& ucell,
     ModuleBase::Vector3<double> *grad_phi = new ModuleBase::Vector3<double>[rho_basis->nrxx];
 
     XC_Functional::grad_rho(phi, grad_phi, rho_basis, ucell.tpiba);
-    // for (int i = 0; i < 10; i++) {
-    //     grad_phi[i].print();
-    // }
-    for (int ir = 0; ir < rho_basis->nrxx; ir++)
-    {
-        grad_phi[ir].x *= epsilon[ir];
-        grad_phi[ir].y *= epsilon[ir];
-        grad_phi[ir].z *= epsilon[ir];
-    }
-    std::vector<double> lp_real(rho_basis->nrxx,0);
-    ModuleBase::GlobalFunc::ZEROS(lp, rho_basis->npw);
-
-    std::vector<double> grad_grad_phi(rho_basis->nrxx,0);
-    complex<double> *grad_grad_phi_G = new complex<double>[rho_basis->npw];
-    ModuleBase::Vector3<double> *tmp_vector3 = new ModuleBase::Vector3<double>[rho_basis->nrxx];
-
-    // x
-    ModuleBase::GlobalFunc::ZEROS(grad_grad_phi_G, rho_basis->npw);
-    ModuleBase::GlobalFunc::ZEROS(tmp_vector3, rho_basis->nrxx);
-    for (int ir = 0; ir < rho_basis->nrxx; ir++)
-    {
-        grad_grad_phi[ir] = grad_phi[ir].x;
-    }
-    rho_basis->real2recip(grad_grad_phi.data(), grad_grad_phi_G);
-    XC_Functional::grad_rho(grad_grad_phi_G, tmp_vector3, rho_basis, ucell.tpiba);
-    for (int ir = 0; ir < rho_basis->nrxx; ir++)
-    {
-        lp_real[ir] += tmp_vector3[ir].x;
-    }
-
-    // y
-    grad_grad_phi.assign(grad_grad_phi.size(),0.0);
-    ModuleBase::GlobalFunc::ZEROS(grad_grad_phi_G, rho_basis->npw);
-    ModuleBase::GlobalFunc::ZEROS(tmp_vector3, rho_basis->nrxx);
-    for (int ir = 0; ir < rho_basis->nrxx; ir++)
-    {
-        grad_grad_phi[ir] = grad_phi[ir].y;
-    }
-    rho_basis->real2recip(grad_grad_phi.data(), grad_grad_phi_G);
-    XC_Functional::grad_rho(grad_grad_phi_G, tmp_vector3, rho_basis, ucell.tpiba);
-    for (int ir = 0; ir < rho_basis->nrxx; ir++)
-    {
-        lp_real[ir] += tmp_vector3[ir].y;
-    }
 
-    // z
-    grad_grad_phi.assign(grad_grad_phi.size(),0.0);
-    ModuleBase::GlobalFunc::ZEROS(grad_grad_phi_G, rho_basis->npw);
-    ModuleBase::GlobalFunc::ZEROS(tmp_vector3, rho_basis->nrxx);
-    for (int ir = 0; ir < rho_basis->nrxx; ir++)
-    {
-        grad_grad_phi[ir] = grad_phi[ir].z;
-    }
-    rho_basis->real2recip(grad_grad_phi.data(), grad_grad_phi_G);
-    XC_Functional::grad_rho(grad_grad_phi_G, tmp_vector3, rho_basis, ucell.tpiba);
-    for (int ir = 0; ir < rho_basis->nrxx; ir++)
+    // div (epsilon * grad phi) = \sum_i iG_i * FFT(epsilon * d_i phi), summed up in G space
+    // so that only one real2recip is needed for each direction
+    std::vector<double> eps_grad_phi(rho_basis->nrxx, 0);
+    complex<double> *eps_grad_phi_G = new complex<double>[rho_basis->npw];
+    ModuleBase::GlobalFunc::ZEROS(lp, rho_basis->npw);
+    for (int i = 0; i < 3; i++)
     {
-        lp_real[ir] += tmp_vector3[ir].z;
+        for (int ir = 0; ir < rho_basis->nrxx; ir++)
+        {
+            eps_grad_phi[ir] = epsilon[ir] * grad_phi[ir][i];
+        }
+        rho_basis->real2recip(eps_grad_phi.data(), eps_grad_phi_G);
+        for (int ig = 0; ig < rho_basis->npw; ig++)
+        {
+            lp[ig] += ModuleBase::IMAG_UNIT * rho_basis->gcar[ig][i] * ucell.tpiba * eps_grad_phi_G[ig];
+        }
     }
 
-    // for (int i = 0; i < 10; i++) {
-    //     cout << lp_real << [i] << endl;
-    // }
-
-    rho_basis->real2recip(lp_real.data(), lp);
-    // cout<<"lp: "<<endl;
-    // test_print(lp, 10);
-
     delete[] grad_phi;
-    std::vector<double>().swap(lp_real);
-    std::vector<double>().swap(grad_grad_phi);
-    delete[] grad_grad_phi_G;
-    delete[] tmp_vector3;
+    delete[] eps_grad_phi_G;
 }
@@ -50,6 +50,7 @@ void surchem::clear()
     this->TOTN_real = nullptr;
     this->delta_phi = nullptr;
     this->epspot = nullptr;
+    std::vector<std::complex<double>>().swap(this->Sol_phi_last);
 }
 
 surchem::~surchem()
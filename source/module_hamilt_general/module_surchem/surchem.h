@@ -24,6 +24,10 @@ class surchem
     ModuleBase::matrix Vel;
     double qs;
 
+    // solution of the generalized Poisson equation in the last cal_vel,
+    // the initial guess of minimize_cg in the next SCF iteration or ionic step
+    std::vector<std::complex<double>> Sol_phi_last;
+
     static double Acav;
     static double Ael;
 
@@ -90,7 +94,8 @@ class surchem
                      double* d_eps,
                      const complex<double>* tot_N,
                      complex<double>* phi,
-                     int& ncgsol);
+                     int& ncgsol,
+                     const complex<double>* phi_guess = nullptr);
 
     void Leps2(const UnitCell& ucell,
                const ModulePW::PW_Basis* rho_basis,
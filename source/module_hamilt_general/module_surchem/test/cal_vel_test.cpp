@@ -25,6 +25,8 @@
  *     - calculate the 2nd item of Vel
  *   - cal_vel
  *     - calculate electrostatic potential
+ *   - minimize_cg
+ *     - start from the solution of the last cal_vel
  */
 
 class cal_vel_test : public testing::Test
@@ -230,6 +232,97 @@ TEST_F(cal_vel_test, cal_vel)
     delete[] TOTN;
 }
 
+TEST_F(cal_vel_test, minimize_cg_warm_start)
+{
+    Setcell::setupcell(ucell);
+
+    std::string precision_flag, device_flag;
+    precision_flag = "double";
+    device_flag = "cpu";
+
+    ModulePW::PW_Basis pwtest(device_flag, precision_flag);
+    GlobalC::rhopw = &pwtest;
+    double wfcecut = 80;
+    bool gamma_only = false;
+    int distribution_type = 1;
+    bool xprime = false;
+
+    // init
+#ifdef __MPI
+    MPI_Comm_size(MPI_COMM_WORLD, &GlobalV::NPROC);
+    MPI_Comm_rank(MPI_COMM_WORLD, &GlobalV::MY_RANK);
+    MPI_Comm_split(MPI_COMM_WORLD, 0, 1, &POOL_WORLD); // in LCAO kpar=1
+#endif
+
+#ifdef __MPI
+    GlobalC::rhopw->initmpi(1, 0, POOL_WORLD);
+#endif
+    GlobalC::rhopw->initgrids(ucell.lat0, ucell.latvec, wfcecut);
+
+    GlobalC::rhopw->initparameters(gamma_only, wfcecut, distribution_type, xprime);
+    GlobalC::rhopw->setuptransform();
+    GlobalC::rhopw->collect_local_pw();
+    GlobalC::rhopw->collect_uniqgg();
+
+    const int npw = GlobalC::rhopw->npw;
+    const int nrxx = GlobalC::rhopw->nrxx;
+
+    complex<double>* TOTN = new complex<double>[npw];
+    complex<double>* PS_TOTN = new complex<double>[npw];
+    complex<double>* B = new complex<double>[npw];
+    complex<double>* phi = new complex<double>[npw];
+    for (int i = 0; i < npw; i++)
+    {
+        TOTN[i] = 1e-5;
+        PS_TOTN[i] = 1e-7;
+        B[i] = -4.0 * ModuleBase::PI * TOTN[i];
+    }
+
+    int nspin = 1;
+    solvent_model.Vel.create(nspin, nrxx);
+    solvent_model.epspot = new double[nrxx];
+    solvent_model.TOTN_real = new double[nrxx];
+    solvent_model.delta_phi = new double[nrxx];
+
+    EXPECT_TRUE(solvent_model.Sol_phi_last.empty());
+    solvent_model.cal_vel(ucell, GlobalC::rhopw, TOTN, PS_TOTN, nspin);
+    EXPECT_EQ(solvent_model.Sol_phi_last.size(), npw);
+
+    // the solution of the last call is already converged
+    double* PS_TOTN_real = new double[nrxx];
+    double* epsilon = new double[nrxx];
+    double* epsilon0 = new double[nrxx];
+    GlobalC::rhopw->recip2real(PS_TOTN, PS_TOTN_real);
+    solvent_model.cal_epsilon(GlobalC::rhopw, PS_TOTN_real, epsilon, epsilon0);
+    int ncgsol = -1;
+    solvent_model.minimize_cg(ucell, GlobalC::rhopw, epsilon, B, phi, ncgsol, solvent_model.Sol_phi_last.data());
+    EXPECT_EQ(ncgsol, 0);
+    for (int ig = 0; ig < npw; ig++)
+    {
+        if (ig == GlobalC::rhopw->ig_gge0)
+        {
+            continue;
+        }
+        EXPECT_EQ(phi[ig], solvent_model.Sol_phi_last[ig]);
+    }
+
+    // the same potential is obtained from the warm start
+    solvent_model.cal_vel(ucell, GlobalC::rhopw, TOTN, PS_TOTN, nspin);
+    EXPECT_NEAR(solvent_model.Vel(0, 0), 0.0532168705, 1e-10);
+    EXPECT_NEAR(solvent_model.Vel(0, 1), 0.0447818244, 1e-10);
+
+    solvent_model.clear();
+    EXPECT_TRUE(solvent_model.Sol_phi_last.empty());
+
+    delete[] PS_TOTN;
+    delete[] TOTN;
+    delete[] B;
+    delete[] phi;
+    delete[] PS_TOTN_real;
+    delete[] epsilon;
+    delete[] epsilon0;
+}
+
 int main(int argc, char** argv)
 {
 #ifdef __MPI
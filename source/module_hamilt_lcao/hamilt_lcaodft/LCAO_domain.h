@@ -25,6 +25,12 @@ void init_basis_lcao(Parallel_Orbitals& pv,
         TwoCenterBundle& two_center_bundle,
         LCAO_Orbitals& orb);
 
+/// keep the tables of two_center_bundle built by init_basis_lcao in the batch mode (stru_batch),
+/// the next structure with the same orbital files takes them instead of building them again.
+/// Tables not completely built are discarded. The uniform orbital tables of Gint (Gint_Tools::init_orb)
+/// are not kept, they are built again for every structure.
+void keep_basis_lcao(TwoCenterBundle& two_center_bundle);
+
 void build_Nonlocal_mu_new(const Parallel_Orbitals& pv,
                            ForceStressArrays& fsr, // mohan 2024-06-16
                            double* HlocR,
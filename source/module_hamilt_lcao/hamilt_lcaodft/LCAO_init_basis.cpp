@@ -1,5 +1,6 @@
 #include "LCAO_domain.h"
 
+#include "module_basis/module_nao/two_center_cache.h"
 #include "module_parameter/parameter.h"
 /// once the GlobalC::exx_info has been deleted, this include can be gone 
 /// mohan note 2024-07-21
@@ -7,9 +8,44 @@
 #include "module_hamilt_pw/hamilt_pwdft/global.h"
 #endif
 
+#include <sstream>
+
 namespace LCAO_domain
 {
 
+namespace
+{
+// the two-center tables kept by keep_basis_lcao
+TwoCenterCache two_center_cache;
+
+std::string two_center_key(const UnitCell& ucell,
+                           const double& onsite_radius,
+                           const double& lcao_ecut,
+                           const double& lcao_dk,
+                           const double& lcao_dr,
+                           const double& lcao_rmax)
+{
+    std::stringstream ss;
+    ss.precision(16);
+    ss << ucell.ntype << " " << onsite_radius << " " << lcao_ecut << " " << lcao_dk << " " << lcao_dr << " "
+       << lcao_rmax;
+    for (int it = 0; it < ucell.ntype; ++it)
+    {
+        ss << " " << ucell.orbital_fn[it];
+        // the projectors in the tables come from the pseudopotentials
+        if (PARAM.inp.vnl_in_h)
+        {
+            ss << " " << ucell.pseudo_fn[it];
+        }
+    }
+    if (PARAM.globalv.deepks_setorb)
+    {
+        ss << " " << ucell.descriptor_file;
+    }
+    return ss.str();
+}
+} // namespace
+
 void init_basis_lcao(Parallel_Orbitals& pv,
         const double &onsite_radius,
         const double &lcao_ecut,
@@ -45,11 +81,26 @@ void init_basis_lcao(Parallel_Orbitals& pv,
     // * reading the localized orbitals/projectors
     // * construct the interpolation tables.
 
-    two_center_bundle.build_orb(ucell.ntype, ucell.orbital_fn);
-    two_center_bundle.build_alpha(PARAM.globalv.deepks_setorb, &ucell.descriptor_file);
-    two_center_bundle.build_orb_onsite(onsite_radius);
-    // currently deepks only use one descriptor file, so cast bool to int is
-    // fine
+    // in the batch mode, the tables of the last structure are taken if they are built from the same files
+    bool reuse = false;
+    if (PARAM.inp.stru_batch != "none")
+    {
+        reuse = two_center_cache.start(two_center_key(ucell, onsite_radius, lcao_ecut, lcao_dk, lcao_dr, lcao_rmax),
+                                       two_center_bundle);
+        if (reuse)
+        {
+            GlobalV::ofs_running << " Two-center integral tables are reused from the last structure" << std::endl;
+        }
+    }
+
+    if (!reuse)
+    {
+        two_center_bundle.build_orb(ucell.ntype, ucell.orbital_fn);
+        two_center_bundle.build_alpha(PARAM.globalv.deepks_setorb, &ucell.descriptor_file);
+        two_center_bundle.build_orb_onsite(onsite_radius);
+        // currently deepks only use one descriptor file, so cast bool to int is
+        // fine
+    }
 
     // TODO Due to the omnipresence of LCAO_Orbitals, we still have to rely
     // on the old interface for now.
@@ -58,7 +109,10 @@ void init_basis_lcao(Parallel_Orbitals& pv,
     if (PARAM.inp.vnl_in_h)
     {
         ucell.infoNL.setupNonlocal(ucell.ntype, ucell.atoms, GlobalV::ofs_running, orb);
-        two_center_bundle.build_beta(ucell.ntype, ucell.infoNL.Beta);
+        if (!reuse)
+        {
+            two_center_bundle.build_beta(ucell.ntype, ucell.infoNL.Beta);
+        }
     }
 
     int Lmax = 0;
@@ -66,11 +120,16 @@ void init_basis_lcao(Parallel_Orbitals& pv,
     Lmax = GlobalC::exx_info.info_ri.abfs_Lmax;
 #endif
 
+    if (!reuse)
+    {
 #ifdef USE_NEW_TWO_CENTER
-    two_center_bundle.tabulate();
+        two_center_bundle.tabulate();
 #else
-    two_center_bundle.tabulate(lcao_ecut, lcao_dk, lcao_dr, lcao_rmax);
+        two_center_bundle.tabulate(lcao_ecut, lcao_dk, lcao_dr, lcao_rmax);
 #endif
+    }
+    // only complete tables are kept for the next structure
+    two_center_cache.set_built();
 
     // setup_2d_division
 #ifdef __MPI
@@ -102,4 +161,13 @@ void init_basis_lcao(Parallel_Orbitals& pv,
     return;
 }
 
+void keep_basis_lcao(TwoCenterBundle& two_center_bundle)
+{
+    if (PARAM.inp.stru_batch == "none")
+    {
+        return;
+    }
+    two_center_cache.keep(two_center_bundle);
+}
+
 }
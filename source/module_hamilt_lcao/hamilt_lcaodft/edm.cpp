@@ -1,4 +1,5 @@
 #include "FORCE.h"
+#include "module_elecstate/elecstate_lcao.h"
 #include "module_elecstate/module_dm/cal_dm_psi.h"
 #include "module_base/memory.h"
 #include "module_parameter/parameter.h"
@@ -27,8 +28,20 @@ elecstate::DensityMatrix<double, double> Force_LCAO<double>::cal_edm(const elecs
     // construct a DensityMatrix for Gamma-Only
     elecstate::DensityMatrix<double, double> edm(&pv, nspin);
     
-#ifdef __PEXSI
-    if (PARAM.inp.ks_solver == "pexsi")
+    // the energy-weighted density matrix is given by the solver without wave functions
+    if (PARAM.inp.ks_solver == "foe")
+    {
+        // EDM(R) is given by foe, EDM(k) is only needed by the Pulay force here
+        auto pes = dynamic_cast<const elecstate::ElecStateLCAO<double>*>(pelec);
+        const std::vector<const hamilt::HContainer<double>*>& foe_EDMR = pes->get_DM()->foe_EDMR;
+        edm.init_DMR(*foe_EDMR[0]);
+        for (int is = 0; is < nspin; is++)
+        {
+            edm.get_DMR_pointer(is + 1)->add(*foe_EDMR[is]);
+        }
+        edm.cal_DMK_from_DMR();
+    }
+    else if (PARAM.inp.ks_solver == "pexsi")
     {
         auto pes = dynamic_cast<const elecstate::ElecStateLCAO<double>*>(pelec);
         for (int ik = 0; ik < nspin; ik++)
@@ -38,7 +51,6 @@ elecstate::DensityMatrix<double, double> Force_LCAO<double>::cal_edm(const elecs
         
     }
     else
-#endif
     {
         elecstate::cal_dm_psi(edm.get_paraV_pointer(), wg_ekb, psi, edm);
     }
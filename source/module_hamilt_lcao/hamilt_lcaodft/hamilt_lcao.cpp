@@ -39,6 +39,7 @@
 #include "operator_lcao/td_ekinetic_lcao.h"
 #include "operator_lcao/td_nonlocal_lcao.h"
 #include "operator_lcao/veff_lcao.h"
+#include "operator_lcao/vxc_atom_lcao.h"
 
 namespace hamilt
 {
@@ -110,7 +111,11 @@ HamiltLCAO<TK, TR>::HamiltLCAO(Gint_Gamma* GG_in,
         {
             pot_register_in.push_back("hartree");
         }
-        pot_register_in.push_back("xc");
+        // XC is added by VxcAtom when it is integrated on the atom grids
+        if (!PARAM.inp.atom_grid)
+        {
+            pot_register_in.push_back("xc");
+        }
         if (PARAM.inp.imp_sol)
         {
             pot_register_in.push_back("surchem");
@@ -196,6 +201,20 @@ HamiltLCAO<TK, TR>::HamiltLCAO(Gint_Gamma* GG_in,
                                                                     PARAM.inp.nspin);
                 this->getOperator()->add(veff);
             }
+            // XC potential on the atom-centered grids
+            if (PARAM.inp.atom_grid)
+            {
+                this->vxc_atom = new VxcAtom<OperatorLCAO<TK, TR>>(GG_in->gridt,
+                                                                   this->hsk,
+                                                                   this->kv->kvec_d,
+                                                                   pot_in,
+                                                                   this->hR,
+                                                                   &ucell,
+                                                                   orb.cutoffs(),
+                                                                   &grid_d,
+                                                                   DM_in);
+                this->getOperator()->add(this->vxc_atom);
+            }
         }
 
 #ifdef __DEEPKS
@@ -444,6 +463,24 @@ void HamiltLCAO<TK, TR>::updateHk(const int ik)
 {
     ModuleBase::TITLE("HamiltLCAO", "updateHk");
     ModuleBase::timer::tick("HamiltLCAO", "updateHk");
+    this->update_current_spin(ik);
+    this->getOperator()->init(ik);
+    ModuleBase::timer::tick("HamiltLCAO", "updateHk");
+}
+
+template <typename TK, typename TR>
+void HamiltLCAO<TK, TR>::updateHR(const int ik)
+{
+    ModuleBase::TITLE("HamiltLCAO", "updateHR");
+    ModuleBase::timer::tick("HamiltLCAO", "updateHR");
+    this->update_current_spin(ik);
+    dynamic_cast<hamilt::OperatorLCAO<TK, TR>*>(this->ops)->init_hr(ik);
+    ModuleBase::timer::tick("HamiltLCAO", "updateHR");
+}
+
+template <typename TK, typename TR>
+void HamiltLCAO<TK, TR>::update_current_spin(const int ik)
+{
     // update global spin index
     if (PARAM.inp.nspin == 2)
     {
@@ -460,8 +497,6 @@ void HamiltLCAO<TK, TR>::updateHk(const int ik)
         }
         this->current_spin = this->kv->isk[ik];
     }
-    this->getOperator()->init(ik);
-    ModuleBase::timer::tick("HamiltLCAO", "updateHk");
 }
 
 template <typename TK, typename TR>
@@ -19,6 +19,11 @@
 namespace hamilt
 {
 
+template <typename TK, typename TR>
+class OperatorLCAO;
+template <class T>
+class VxcAtom;
+
 // template first for type of k space H matrix elements
 // template second for type of temporary matrix, gamma_only fix-gamma-matrix + S-gamma, multi-k fix-Real + S-Real
 template <typename TK, typename TR>
@@ -95,12 +100,23 @@ class HamiltLCAO : public Hamilt<TK>
     {
         return this->sR;
     }
+    /// get the operator of the XC potential on the atom grids, nullptr if atom_grid is off
+    VxcAtom<OperatorLCAO<TK, TR>>* get_vxc_atom() const
+    {
+        return this->vxc_atom;
+    }
     /// refresh the status of HR
     void refresh() override;
 
     // for target K point, update consequence of hPsi() and matrix()
     virtual void updateHk(const int ik) override;
 
+    /**
+     * @brief update H(R) and S(R) for the spin of the target K point, H(k) and S(k) are not calculated
+     * used by the solvers working on H(R) and S(R) directly
+     */
+    void updateHR(const int ik);
+
     /**
      * @brief special for LCAO, update SK only
      *
@@ -116,6 +132,9 @@ class HamiltLCAO : public Hamilt<TK>
     void matrix(MatrixBlock<TK>& hk_in, MatrixBlock<TK>& sk_in) override;
 
   private:
+    // switch the data of HR to the spin of the target K point for NSPIN=2
+    void update_current_spin(const int ik);
+
     const K_Vectors* kv = nullptr;
 
     // Real space Hamiltonian
@@ -133,6 +152,8 @@ class HamiltLCAO : public Hamilt<TK>
 
     const int istep = 0;
 
+    VxcAtom<OperatorLCAO<TK, TR>>* vxc_atom = nullptr;
+
     // sk and hk will be refactored to HamiltLCAO later
     // std::vector<TK> sk;
     // std::vector<TK> hk;
@@ -8,6 +8,7 @@
 #endif
 #include "module_cell/module_neighbor/sltk_grid_driver.h"
 #include "module_hamilt_lcao/module_hcontainer/hcontainer_funcs.h"
+#include <algorithm>
 #ifdef _OPENMP
 #include <unordered_set>
 #endif
@@ -250,159 +251,182 @@ void hamilt::DeePKS<hamilt::OperatorLCAO<TK, TR>>::calculate_HR()
 
     const Parallel_Orbitals* paraV = this->H_V_delta->get_paraV();
     const int npol = this->ucell->get_npol();
+    int nproj = 0;
+    for (int L0 = 0; L0 <= ptr_orb_->Alpha[0].getLmax(); ++L0)
+    {
+        nproj += (2 * L0 + 1) * ptr_orb_->Alpha[0].getNchi(L0);
+    }
 
     // 1. calculate <phi|alpha> for each pair of atoms
-    for (int iat0 = 0; iat0 < this->ucell->nat; iat0++)
+#ifdef _OPENMP
+#pragma omp parallel
     {
-        auto tau0 = ucell->get_tau(iat0);
-        int T0, I0;
-        ucell->iat2iait(iat0, &I0, &T0);
-        AdjacentAtomInfo& adjs = this->adjs_all[iat0];
-
-        // trace alpha orbital
-        std::vector<int> trace_alpha_row;
-        std::vector<int> trace_alpha_col;
-        std::vector<double> gedms;
-        if (!PARAM.inp.deepks_equiv)
+        std::unordered_set<int> atom_row_list;
+#pragma omp for
+        for (int iat0 = 0; iat0 < this->ucell->nat; iat0++)
         {
-            int ib = 0;
-            for (int L0 = 0; L0 <= ptr_orb_->Alpha[0].getLmax(); ++L0)
+            atom_row_list.insert(iat0);
+        }
+#endif
+        // <phi|alpha> of the neighbors of one atom, if nlm_tot is not calculated already
+        std::vector<std::unordered_map<int, std::vector<double>>> nlm_on_the_fly;
+        for (int iat0 = 0; iat0 < this->ucell->nat; iat0++)
+        {
+            auto tau0 = ucell->get_tau(iat0);
+            int T0, I0;
+            ucell->iat2iait(iat0, &I0, &T0);
+            AdjacentAtomInfo& adjs = this->adjs_all[iat0];
+#ifdef _OPENMP
+            // skip the projector atoms without any neighbor in the rows of this thread
+            bool has_row = false;
+            for (int ad1 = 0; ad1 < adjs.adj_num + 1 && !has_row; ++ad1)
             {
-                for (int N0 = 0; N0 < ptr_orb_->Alpha[0].getNchi(L0); ++N0)
-                {
-                    const int inl = GlobalC::ld.get_inl(T0, I0, L0, N0);
-                    const double* pgedm = GlobalC::ld.get_gedms(inl);
-                    const int nm = 2 * L0 + 1;
+                has_row = atom_row_list.find(ucell->itia2iat(adjs.ntype[ad1], adjs.natom[ad1])) != atom_row_list.end();
+            }
+            if (!has_row)
+            {
+                continue;
+            }
+#endif
 
-                    for (int m1 = 0; m1 < nm; ++m1) // m1 = 1 for s, 3 for p, 5 for d
+            // gedm of all the projectors as a nproj * nproj matrix,
+            // which is block diagonal in (L0, N0) without deepks_equiv
+            std::vector<double> gedm_full(nproj * nproj, 0.0);
+            if (!PARAM.inp.deepks_equiv)
+            {
+                int ib = 0;
+                for (int L0 = 0; L0 <= ptr_orb_->Alpha[0].getLmax(); ++L0)
+                {
+                    for (int N0 = 0; N0 < ptr_orb_->Alpha[0].getNchi(L0); ++N0)
                     {
-                        for (int m2 = 0; m2 < nm; ++m2) // m1 = 1 for s, 3 for p, 5 for d
+                        const int inl = GlobalC::ld.get_inl(T0, I0, L0, N0);
+                        const double* pgedm = GlobalC::ld.get_gedms(inl);
+                        const int nm = 2 * L0 + 1;
+
+                        for (int m1 = 0; m1 < nm; ++m1) // m1 = 1 for s, 3 for p, 5 for d
                         {
-                            trace_alpha_row.push_back(ib + m1);
-                            trace_alpha_col.push_back(ib + m2);
-                            gedms.push_back(pgedm[m1 * nm + m2]);
+                            for (int m2 = 0; m2 < nm; ++m2) // m1 = 1 for s, 3 for p, 5 for d
+                            {
+                                gedm_full[(ib + m1) * nproj + ib + m2] = pgedm[m1 * nm + m2];
+                            }
                         }
+                        ib += nm;
                     }
-                    ib += nm;
                 }
             }
-        }
-        else
-        {
-            const double* pgedm = GlobalC::ld.get_gedms(iat0);
-            int nproj = 0;
-            for (int il = 0; il < GlobalC::ld.get_lmaxd() + 1; il++)
+            else
             {
-                nproj += (2 * il + 1) * ptr_orb_->Alpha[0].getNchi(il);
+                const double* pgedm = GlobalC::ld.get_gedms(iat0);
+                std::copy(pgedm, pgedm + nproj * nproj, gedm_full.data());
             }
-            for (int iproj = 0; iproj < nproj; iproj++)
+            //--------------------------------------------------
+
+            const std::vector<std::unordered_map<int, std::vector<double>>>* nlm_iat = nullptr;
+            if (nlm_tot.size() != this->ucell->nat)
             {
-                for (int jproj = 0; jproj < nproj; jproj++)
-                {
-                    trace_alpha_row.push_back(iproj);
-                    trace_alpha_col.push_back(jproj);
-                    gedms.push_back(pgedm[iproj * nproj + jproj]);
-                }
+                nlm_on_the_fly.clear();
+                this->pre_calculate_nlm(iat0, nlm_on_the_fly);
+                nlm_iat = &nlm_on_the_fly;
             }
-        }
-        const int trace_alpha_size = trace_alpha_row.size();
-        //--------------------------------------------------
-
-        // if nlm_tot is not calculated already, calculate it on the fly now
-        int iat00 = iat0;
-        if (nlm_tot.size() != this->ucell->nat)
-        {
-            iat00 = 0;
-            nlm_tot[iat00].clear();
-            this->pre_calculate_nlm(iat0, nlm_tot[iat00]);
-        }
-        std::vector<std::unordered_map<int, std::vector<double>>>& nlm_iat = nlm_tot[iat00];
-
-        // 2. calculate <phi_I|beta>D<beta|phi_{J,R}> for each pair of <IJR> atoms
-        for (int ad1 = 0; ad1 < adjs.adj_num + 1; ++ad1)
-        {
-            const int T1 = adjs.ntype[ad1];
-            const int I1 = adjs.natom[ad1];
-            const int iat1 = ucell->itia2iat(T1, I1);
-            ModuleBase::Vector3<int>& R_index1 = adjs.box[ad1];
-            auto row_indexes = paraV->get_indexes_row(iat1);
-            const int row_size = row_indexes.size();
-            if (row_size == 0)
+            else
             {
-                continue;
+                nlm_iat = &nlm_tot[iat0];
             }
 
-            std::vector<double> s_1t(trace_alpha_size * row_size);
-            for (int irow = 0; irow < row_size; irow++)
+            // 2. calculate <phi_I|beta>D<beta|phi_{J,R}> for each pair of <IJR> atoms
+            for (int ad1 = 0; ad1 < adjs.adj_num + 1; ++ad1)
             {
-                const double* row_ptr = nlm_iat[ad1][row_indexes[irow]].data();
-                double* ps1t = &s_1t[irow * trace_alpha_size];
-                for (int i = 0; i < trace_alpha_size; i++)
+                const int T1 = adjs.ntype[ad1];
+                const int I1 = adjs.natom[ad1];
+                const int iat1 = ucell->itia2iat(T1, I1);
+#ifdef _OPENMP
+                if (atom_row_list.find(iat1) == atom_row_list.end())
                 {
-                    ps1t[i] = row_ptr[trace_alpha_row[i]] * gedms[i];
+                    continue;
                 }
-            }
-            for (int ad2 = 0; ad2 < adjs.adj_num + 1; ++ad2)
-            {
-                const int T2 = adjs.ntype[ad2];
-                const int I2 = adjs.natom[ad2];
-                const int iat2 = ucell->itia2iat(T2, I2);
-                ModuleBase::Vector3<int>& R_index2 = adjs.box[ad2];
-                ModuleBase::Vector3<int> R_vector(R_index2[0] - R_index1[0],
-                                                  R_index2[1] - R_index1[1],
-                                                  R_index2[2] - R_index1[2]);
-                hamilt::BaseMatrix<TR>* tmp
-                    = this->H_V_delta->find_matrix(iat1, iat2, R_vector[0], R_vector[1], R_vector[2]);
-                // if not found , skip this pair of atoms
-                if (tmp == nullptr)
+#endif
+                ModuleBase::Vector3<int>& R_index1 = adjs.box[ad1];
+                auto row_indexes = paraV->get_indexes_row(iat1);
+                const int row_size = row_indexes.size();
+                if (row_size == 0)
                 {
                     continue;
                 }
-                auto col_indexes = paraV->get_indexes_col(iat2);
-                const int col_size = col_indexes.size();
-                std::vector<double> hr_current(row_size * col_size, 0);
-                std::vector<double> s_2t(trace_alpha_size * col_size);
-                for (int icol = 0; icol < col_size; icol++)
+
+                std::vector<double> s_1t(nproj * row_size);
+                for (int irow = 0; irow < row_size; irow++)
                 {
-                    const double* col_ptr = nlm_iat[ad2][col_indexes[icol]].data();
-                    double* ps2t = &s_2t[icol * trace_alpha_size];
-                    for (int i = 0; i < trace_alpha_size; i++)
-                    {
-                        ps2t[i] = col_ptr[trace_alpha_col[i]];
-                    }
+                    const double* row_ptr = (*nlm_iat)[ad1].at(row_indexes[irow]).data();
+                    std::copy(row_ptr, row_ptr + nproj, &s_1t[irow * nproj]);
+                }
+                // s_1g = s_1t gedm_full, row-major
+                std::vector<double> s_1g(nproj * row_size);
+                {
+                    constexpr char transa = 'N', transb = 'N';
+                    const double gemm_alpha = 1.0, gemm_beta = 0.0;
+                    dgemm_(&transa,
+                           &transb,
+                           &nproj,
+                           &row_size,
+                           &nproj,
+                           &gemm_alpha,
+                           gedm_full.data(),
+                           &nproj,
+                           s_1t.data(),
+                           &nproj,
+                           &gemm_beta,
+                           s_1g.data(),
+                           &nproj);
                 }
-                /*for(int irow = 0;irow<row_size;irow++)
+                for (int ad2 = 0; ad2 < adjs.adj_num + 1; ++ad2)
                 {
-                    for(int icol=0;icol<col_size;icol++)
+                    const int T2 = adjs.ntype[ad2];
+                    const int I2 = adjs.natom[ad2];
+                    const int iat2 = ucell->itia2iat(T2, I2);
+                    ModuleBase::Vector3<int>& R_index2 = adjs.box[ad2];
+                    ModuleBase::Vector3<int> R_vector(R_index2[0] - R_index1[0],
+                                                      R_index2[1] - R_index1[1],
+                                                      R_index2[2] - R_index1[2]);
+                    hamilt::BaseMatrix<TR>* tmp
+                        = this->H_V_delta->find_matrix(iat1, iat2, R_vector[0], R_vector[1], R_vector[2]);
+                    // if not found , skip this pair of atoms
+                    if (tmp == nullptr)
                     {
-                        for(int ialpha=0;ialpha<trace_alpha_size;ialpha++)
-                        {
-                            tmp->get_pointer()[irow*col_size+icol] +=
-                                s_1t[irow*trace_alpha_size+ialpha] * s_2t[icol*trace_alpha_size+ialpha];
-                        }
+                        continue;
+                    }
+                    auto col_indexes = paraV->get_indexes_col(iat2);
+                    const int col_size = col_indexes.size();
+                    std::vector<double> hr_current(row_size * col_size, 0);
+                    std::vector<double> s_2t(nproj * col_size);
+                    for (int icol = 0; icol < col_size; icol++)
+                    {
+                        const double* col_ptr = (*nlm_iat)[ad2].at(col_indexes[icol]).data();
+                        std::copy(col_ptr, col_ptr + nproj, &s_2t[icol * nproj]);
                     }
-                }*/
-                // dgemm for s_2t and s_1t to get HR_12
-                constexpr char transa = 'T', transb = 'N';
-                const double gemm_alpha = 1.0, gemm_beta = 1.0;
-                dgemm_(&transa,
-                       &transb,
-                       &col_size,
-                       &row_size,
-                       &trace_alpha_size,
-                       &gemm_alpha,
-                       s_2t.data(),
-                       &trace_alpha_size,
-                       s_1t.data(),
-                       &trace_alpha_size,
-                       &gemm_beta,
-                       hr_current.data(),
-                       &col_size);
-                // add data of HR to target BaseMatrix
-                this->cal_HR_IJR(hr_current.data(), row_size, col_size, tmp->get_pointer());
+                    // dgemm for s_2t and s_1g to get HR_12
+                    constexpr char transa = 'T', transb = 'N';
+                    const double gemm_alpha = 1.0, gemm_beta = 1.0;
+                    dgemm_(&transa,
+                           &transb,
+                           &col_size,
+                           &row_size,
+                           &nproj,
+                           &gemm_alpha,
+                           s_2t.data(),
+                           &nproj,
+                           s_1g.data(),
+                           &nproj,
+                           &gemm_beta,
+                           hr_current.data(),
+                           &col_size);
+                    // add data of HR to target BaseMatrix
+                    this->cal_HR_IJR(hr_current.data(), row_size, col_size, tmp->get_pointer());
+                }
             }
         }
+#ifdef _OPENMP
     }
+#endif
     ModuleBase::timer::tick("DeePKS", "calculate_HR");
 }
 
@@ -82,7 +82,9 @@ void OperatorLCAO<TK, TR>::init(const int ik_in) {
     ModuleBase::timer::tick("OperatorLCAO", "init");
     if (this->is_first_node) {
         // refresh HK
-        this->refresh_h();
+        if (!this->hr_only) {
+            this->refresh_h();
+        }
         if (!this->hr_done) {
             // refresh HR
             this->hR->set_zero();
@@ -106,7 +108,9 @@ void OperatorLCAO<TK, TR>::init(const int ik_in) {
 
         // update SK next
         // in cal_type=lcao_overlap, SK should be update here
-        this->contributeHk(ik_in);
+        if (!this->hr_only) {
+            this->contributeHk(ik_in);
+        }
 
         break;
     }
@@ -162,7 +166,9 @@ void OperatorLCAO<TK, TR>::init(const int ik_in) {
         }
 
         // update H_V_delta_k next
-        this->contributeHk(ik_in);
+        if (!this->hr_only) {
+            this->contributeHk(ik_in);
+        }
 
         break;
     }
@@ -210,7 +216,9 @@ void OperatorLCAO<TK, TR>::init(const int ik_in) {
                 last = dynamic_cast<OperatorLCAO<TK, TR>*>(last->next_sub_op);
             }
         }
-        this->contributeHk(ik_in);
+        if (!this->hr_only) {
+            this->contributeHk(ik_in);
+        }
 
         break;
     }
@@ -227,9 +235,11 @@ void OperatorLCAO<TK, TR>::init(const int ik_in) {
             dynamic_cast<OperatorLCAO<TK, TR>*>(this->next_op)->hr_done
                 = this->hr_done;
         }
+        dynamic_cast<OperatorLCAO<TK, TR>*>(this->next_op)->hr_only
+            = this->hr_only;
         // call init() function of next node
         this->next_op->init(ik_in);
-    } else { // it is the last node, update HK with the current total HR
+    } else if (!this->hr_only) { // it is the last node, update HK with the current total HR
         OperatorLCAO<TK, TR>::contributeHk(ik_in);
     }
 
@@ -239,6 +249,13 @@ void OperatorLCAO<TK, TR>::init(const int ik_in) {
     ModuleBase::timer::tick("OperatorLCAO", "init");
 }
 
+template <typename TK, typename TR>
+void OperatorLCAO<TK, TR>::init_hr(const int ik_in) {
+    this->hr_only = true;
+    this->init(ik_in);
+    this->hr_only = false;
+}
+
 // contributeHk()
 template <typename TK, typename TR>
 void OperatorLCAO<TK, TR>::contributeHk(int ik) {
@@ -32,6 +32,12 @@ class OperatorLCAO : public Operator<TK> {
     class, but must override in derived class */
     virtual void init(const int ik_in) override;
 
+    /**
+     * @brief update H(R) of all the nodes as init() does, but without folding H(k) and S(k),
+     * used by the solvers working on H(R) and S(R) directly (foe)
+     */
+    void init_hr(const int ik_in);
+
     void refresh_h();
 
     /* Function getHR() is designed to update HR matrix only, it will loop all
@@ -114,6 +120,9 @@ class OperatorLCAO : public Operator<TK> {
     //! if H(R) is calculated
     bool hr_done = false;
 
+    //! if only H(R) is updated in init(), set by init_hr()
+    bool hr_only = false;
+
   private:
 
     void get_hs_pointers();
@@ -0,0 +1,385 @@
+#include "vxc_atom_lcao.h"
+
+#include "module_base/parallel_reduce.h"
+#include "module_base/timer.h"
+#include "module_base/tool_quit.h"
+#include "module_base/tool_title.h"
+#include "module_hamilt_general/module_xc/xc_functional.h"
+#include "module_hamilt_lcao/module_hcontainer/hcontainer_funcs.h"
+#include "module_parameter/parameter.h"
+
+#include <cassert>
+#include <cmath>
+
+namespace hamilt
+{
+
+template <typename TK, typename TR>
+VxcAtom<OperatorLCAO<TK, TR>>::VxcAtom(const Grid_Technique* gt_in,
+                                       HS_Matrix_K<TK>* hsk_in,
+                                       const std::vector<ModuleBase::Vector3<double>>& kvec_d_in,
+                                       elecstate::Potential* pot_in,
+                                       hamilt::HContainer<TR>* hR_in,
+                                       const UnitCell* ucell_in,
+                                       const std::vector<double>& orb_cutoff,
+                                       const Grid_Driver* GridD_in,
+                                       elecstate::DensityMatrix<TK, double>* DM_in)
+    : OperatorLCAO<TK, TR>(hsk_in, kvec_d_in, hR_in), pot(pot_in), DM(DM_in)
+{
+    ModuleBase::TITLE("VxcAtom", "VxcAtom");
+    this->cal_type = calculation_type::lcao_gint;
+    this->nspin = PARAM.inp.nspin;
+    if (!std::is_same<TK, double>::value || !std::is_same<TR, double>::value)
+    {
+        ModuleBase::WARNING_QUIT("VxcAtom", "atom_grid is only implemented for gamma_only calculations");
+    }
+    if (XC_Functional::get_func_type() != 1)
+    {
+        ModuleBase::WARNING_QUIT("VxcAtom", "atom_grid is only implemented for LDA functionals");
+    }
+    for (int it = 0; it < ucell_in->ntype; ++it)
+    {
+        if (ucell_in->atoms[it].ncpp.nlcc)
+        {
+            ModuleBase::WARNING_QUIT("VxcAtom", "atom_grid does not support the nonlinear core correction");
+        }
+    }
+    this->check_isolated(ucell_in, orb_cutoff, GridD_in);
+
+    this->grid.init(*gt_in, PARAM.inp.atom_grid_nrad, PARAM.inp.atom_grid_lmax);
+    for (int is = 0; is < this->nspin; ++is)
+    {
+        this->dm_serial.emplace_back(new hamilt::HContainer<double>(this->grid.get_pattern()));
+        this->v_serial.emplace_back(new hamilt::HContainer<double>(this->grid.get_pattern()));
+    }
+#ifdef __MPI
+    this->dm_plans.resize(this->nspin);
+    this->v_plans.resize(this->nspin);
+#endif
+}
+
+template <typename TK, typename TR>
+void VxcAtom<OperatorLCAO<TK, TR>>::check_isolated(const UnitCell* ucell_in,
+                                                   const std::vector<double>& orb_cutoff,
+                                                   const Grid_Driver* GridD_in)
+{
+    for (int iat1 = 0; iat1 < ucell_in->nat; iat1++)
+    {
+        auto tau1 = ucell_in->get_tau(iat1);
+        int T1, I1;
+        ucell_in->iat2iait(iat1, &I1, &T1);
+        AdjacentAtomInfo adjs;
+        GridD_in->Find_atom(*ucell_in, tau1, T1, I1, &adjs);
+        for (int ad = 0; ad < adjs.adj_num + 1; ++ad)
+        {
+            const int T2 = adjs.ntype[ad];
+            const int I2 = adjs.natom[ad];
+            const int iat2 = ucell_in->itia2iat(T2, I2);
+            const ModuleBase::Vector3<int>& R_index2 = adjs.box[ad];
+            if ((R_index2.x != 0 || R_index2.y != 0 || R_index2.z != 0)
+                && ucell_in->cal_dtau(iat1, iat2, R_index2).norm() * ucell_in->lat0 < orb_cutoff[T1] + orb_cutoff[T2])
+            {
+                ModuleBase::WARNING_QUIT("VxcAtom",
+                                         "atom_grid needs a vacuum larger than the orbital cutoffs around the system");
+            }
+        }
+    }
+}
+
+template <typename TK, typename TR>
+void VxcAtom<OperatorLCAO<TK, TR>>::cal_rho_out()
+{
+    ModuleBase::TITLE("VxcAtom", "cal_rho_out");
+    ModuleBase::timer::tick("VxcAtom", "cal_rho_out");
+    const int np = this->grid.get_npoints();
+
+    // DM(R) is zero before the first diagonalization, the atomic densities are used then
+    double dm_norm = 0.0;
+    for (int is = 0; is < this->nspin; ++is)
+    {
+#ifdef __MPI
+        hamilt::transferParallels2Serials(*this->DM->get_DMR_pointer(is + 1),
+                                          this->dm_serial[is].get(),
+                                          this->dm_plans[is]);
+#else
+        const hamilt::HContainer<double>* dmr = this->DM->get_DMR_pointer(is + 1);
+        for (int iap = 0; iap < this->dm_serial[is]->size_atom_pairs(); ++iap)
+        {
+            hamilt::AtomPair<double>& ap = this->dm_serial[is]->get_atom_pair(iap);
+            const hamilt::BaseMatrix<double>* m = dmr->find_matrix(ap.get_atom_i(), ap.get_atom_j(), 0, 0, 0);
+            if (m != nullptr)
+            {
+                std::copy(m->get_pointer(), m->get_pointer() + ap.get_size(), ap.get_pointer(0));
+            }
+        }
+#endif
+        const double* dm = this->dm_serial[is]->get_wrapper();
+        for (int i = 0; i < this->dm_serial[is]->get_nnr(); ++i)
+        {
+            dm_norm += std::abs(dm[i]);
+        }
+    }
+    Parallel_Reduce::reduce_all(dm_norm);
+
+    this->rho_out.assign(this->nspin, std::vector<double>(np, 0.0));
+    if (dm_norm == 0.0)
+    {
+        std::vector<double> mag(np, 0.0);
+        this->grid.atomic_rho(this->rho_out[0].data(), mag.data());
+        if (this->nspin == 2)
+        {
+            for (int ip = 0; ip < np; ++ip)
+            {
+                this->rho_out[1][ip] = 0.5 * (this->rho_out[0][ip] - mag[ip]);
+                this->rho_out[0][ip] = 0.5 * (this->rho_out[0][ip] + mag[ip]);
+            }
+        }
+    }
+    else
+    {
+        for (int is = 0; is < this->nspin; ++is)
+        {
+            this->grid.cal_rho(*this->dm_serial[is], this->rho_out[is].data());
+        }
+    }
+    this->rho_out_ready = true;
+    ModuleBase::timer::tick("VxcAtom", "cal_rho_out");
+}
+
+template <typename TK, typename TR>
+double VxcAtom<OperatorLCAO<TK, TR>>::cal_drho(const double nelec)
+{
+    ModuleBase::TITLE("VxcAtom", "cal_drho");
+    this->cal_rho_out();
+    if (this->rho_in.empty())
+    {
+        return 0.0;
+    }
+    const std::vector<double>& weights = this->grid.get_weights();
+    double drho = 0.0;
+    for (int is = 0; is < this->nspin; ++is)
+    {
+#ifdef _OPENMP
+#pragma omp parallel for reduction(+ : drho)
+#endif
+        for (int ip = 0; ip < this->grid.get_npoints(); ++ip)
+        {
+            drho += weights[ip] * std::abs(this->rho_out[is][ip] - this->rho_in[is][ip]);
+        }
+    }
+    Parallel_Reduce::reduce_all(drho);
+    assert(nelec != 0);
+    return drho / nelec;
+}
+
+template <typename TK, typename TR>
+void VxcAtom<OperatorLCAO<TK, TR>>::mix_rho()
+{
+    ModuleBase::TITLE("VxcAtom", "mix_rho");
+    ModuleBase::timer::tick("VxcAtom", "mix_rho");
+    const int np = this->grid.get_npoints();
+    const int length = this->nspin * np;
+    Base_Mixing::Mixing* mixing = (this->chgmix == nullptr) ? nullptr : this->chgmix->get_mixing();
+    if (this->rho_in.empty() || mixing == nullptr)
+    {
+        this->rho_in = this->rho_out;
+        if (mixing != nullptr)
+        {
+            mixing->init_mixing_data(this->rho_mdata, length, sizeof(double));
+        }
+        ModuleBase::timer::tick("VxcAtom", "mix_rho");
+        return;
+    }
+
+    // the coefficients of the last Charge_Mixing::mix_rho() are used, which belong to a history one
+    // step longer than that of the atom grids. The history of the FFT grid is reset at the first
+    // iteration and at the restart of the mixing, and it is not pushed if the density is kept.
+    const int ndim_rho = this->chgmix->get_rho_ndim_history();
+    if (ndim_rho != this->rho_mdata.ndim_history + 1)
+    {
+        mixing->init_mixing_data(this->rho_mdata, length, sizeof(double));
+        if (ndim_rho != 1)
+        {
+            this->rho_in = this->rho_out;
+            ModuleBase::timer::tick("VxcAtom", "mix_rho");
+            return;
+        }
+    }
+
+    // (rho_up + rho_dw, rho_up - rho_dw) for nspin 2, as in Charge_Mixing::mix_rho_real()
+    std::vector<double> data_in(length);
+    std::vector<double> data_out(length);
+    for (int ip = 0; ip < np; ++ip)
+    {
+        if (this->nspin == 1)
+        {
+            data_in[ip] = this->rho_in[0][ip];
+            data_out[ip] = this->rho_out[0][ip];
+        }
+        else
+        {
+            data_in[ip] = this->rho_in[0][ip] + this->rho_in[1][ip];
+            data_in[ip + np] = this->rho_in[0][ip] - this->rho_in[1][ip];
+            data_out[ip] = this->rho_out[0][ip] + this->rho_out[1][ip];
+            data_out[ip + np] = this->rho_out[0][ip] - this->rho_out[1][ip];
+        }
+    }
+    // no Kerker screening on the atom grids, as in Charge_Mixing::mix_dmr()
+    if (this->nspin == 1)
+    {
+        mixing->push_data(this->rho_mdata, data_in.data(), data_out.data(), nullptr, false);
+    }
+    else
+    {
+        const double beta = this->chgmix->get_mixing_beta();
+        const double beta_mag = this->chgmix->get_mixing_beta_mag();
+        auto twobeta_mix = [np, beta, beta_mag](double* out, const double* in, const double* sres) {
+            for (int i = 0; i < np; ++i)
+            {
+                out[i] = in[i] + beta * sres[i];
+            }
+            for (int i = np; i < 2 * np; ++i)
+            {
+                out[i] = in[i] + beta_mag * sres[i];
+            }
+        };
+        mixing->push_data(this->rho_mdata, data_in.data(), data_out.data(), nullptr, twobeta_mix, false);
+    }
+    mixing->mix_data(this->rho_mdata, data_out.data());
+    for (int ip = 0; ip < np; ++ip)
+    {
+        if (this->nspin == 1)
+        {
+            this->rho_in[0][ip] = data_out[ip];
+        }
+        else
+        {
+            this->rho_in[0][ip] = 0.5 * (data_out[ip] + data_out[ip + np]);
+            this->rho_in[1][ip] = 0.5 * (data_out[ip] - data_out[ip + np]);
+        }
+    }
+    ModuleBase::timer::tick("VxcAtom", "mix_rho");
+}
+
+template <typename TK, typename TR>
+void VxcAtom<OperatorLCAO<TK, TR>>::cal_vxc()
+{
+    ModuleBase::TITLE("VxcAtom", "cal_vxc");
+    ModuleBase::timer::tick("VxcAtom", "cal_vxc");
+    const int np = this->grid.get_npoints();
+    const std::vector<double>& weights = this->grid.get_weights();
+
+    // the output density of the last step is kept by cal_drho() before the mixing of the FFT grid,
+    // DM(R) may be changed later by Charge_Mixing::mix_dmr()
+    if (!this->rho_out_ready)
+    {
+        this->cal_rho_out();
+    }
+    this->mix_rho();
+    this->rho_out_ready = false;
+
+    // LDA on the points, as in XC_Functional::v_xc
+    const double e2 = 2.0;
+    const double vanishing_charge = 1.0e-10;
+    double etxc = 0.0;
+    double vtxc = 0.0;
+    std::vector<std::vector<double>> v(this->nspin, std::vector<double>(np, 0.0));
+#ifdef _OPENMP
+#pragma omp parallel for reduction(+ : etxc) reduction(+ : vtxc)
+#endif
+    for (int ip = 0; ip < np; ++ip)
+    {
+        double exc = 0.0;
+        if (this->nspin == 1)
+        {
+            const double rhox = this->rho_in[0][ip];
+            const double arhox = std::abs(rhox);
+            if (arhox > vanishing_charge)
+            {
+                double vxc = 0.0;
+                XC_Functional::xc(arhox, exc, vxc);
+                v[0][ip] = e2 * vxc;
+                etxc += weights[ip] * e2 * exc * rhox;
+                vtxc += weights[ip] * v[0][ip] * rhox;
+            }
+        }
+        else
+        {
+            const double rhox = this->rho_in[0][ip] + this->rho_in[1][ip];
+            const double arhox = std::abs(rhox);
+            if (arhox > vanishing_charge)
+            {
+                double zeta = (this->rho_in[0][ip] - this->rho_in[1][ip]) / arhox;
+                if (std::abs(zeta) > 1.0)
+                {
+                    zeta = (zeta > 0.0) ? 1.0 : (-1.0);
+                }
+                double vxc[2] = {0.0, 0.0};
+                XC_Functional::xc_spin(arhox, zeta, exc, vxc[0], vxc[1]);
+                for (int is = 0; is < 2; ++is)
+                {
+                    v[is][ip] = e2 * vxc[is];
+                    vtxc += weights[ip] * v[is][ip] * this->rho_in[is][ip];
+                }
+                etxc += weights[ip] * e2 * exc * rhox;
+            }
+        }
+    }
+    Parallel_Reduce::reduce_all(etxc);
+    Parallel_Reduce::reduce_all(vtxc);
+    this->pot->set_etxc_vtxc(etxc, vtxc);
+
+    for (int is = 0; is < this->nspin; ++is)
+    {
+        this->v_serial[is]->set_zero();
+        this->grid.cal_vlocal(v[is].data(), *this->v_serial[is]);
+    }
+    ModuleBase::timer::tick("VxcAtom", "cal_vxc");
+}
+
+template <typename TK, typename TR>
+void VxcAtom<OperatorLCAO<TK, TR>>::contributeHR()
+{
+    ModuleBase::WARNING_QUIT("VxcAtom", "atom_grid is only implemented for gamma_only calculations");
+}
+
+// special case of gamma-only
+template <>
+void VxcAtom<OperatorLCAO<double, double>>::contributeHR()
+{
+    ModuleBase::TITLE("VxcAtom", "contributeHR");
+    ModuleBase::timer::tick("VxcAtom", "contributeHR");
+    if (this->current_spin == 0)
+    {
+        this->cal_vxc();
+    }
+#ifdef __MPI
+    hamilt::transferSerials2Parallels(*this->v_serial[this->current_spin],
+                                      this->hR,
+                                      this->v_plans[this->current_spin]);
+#else
+    const hamilt::HContainer<double>& vr = *this->v_serial[this->current_spin];
+    for (int iap = 0; iap < vr.size_atom_pairs(); ++iap)
+    {
+        const hamilt::AtomPair<double>& ap = vr.get_atom_pair(iap);
+        hamilt::BaseMatrix<double>* m = this->hR->find_matrix(ap.get_atom_i(), ap.get_atom_j(), 0, 0, 0);
+        if (m != nullptr)
+        {
+            m->add_array(ap.get_pointer(0));
+        }
+    }
+#endif
+    if (this->nspin == 2)
+    {
+        this->current_spin = 1 - this->current_spin;
+    }
+    ModuleBase::timer::tick("VxcAtom", "contributeHR");
+}
+
+template class VxcAtom<OperatorLCAO<double, double>>;
+
+template class VxcAtom<OperatorLCAO<std::complex<double>, double>>;
+
+template class VxcAtom<OperatorLCAO<std::complex<double>, std::complex<double>>>;
+
+} // namespace hamilt
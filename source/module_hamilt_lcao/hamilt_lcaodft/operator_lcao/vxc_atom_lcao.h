@@ -0,0 +1,117 @@
+#ifndef VXCATOMLCAO_H
+#define VXCATOMLCAO_H
+#include "module_cell/module_neighbor/sltk_grid_driver.h"
+#include "module_cell/unitcell.h"
+#include "module_elecstate/module_charge/charge_mixing.h"
+#include "module_elecstate/module_dm/density_matrix.h"
+#include "module_elecstate/potentials/potential_new.h"
+#include "module_hamilt_lcao/module_gint/gint_atom.h"
+#include "operator_lcao.h"
+
+#include <memory>
+#include <vector>
+
+namespace hamilt
+{
+
+#ifndef __VXCATOMTEMPLATE
+#define __VXCATOMTEMPLATE
+
+template <class T>
+class VxcAtom : public T
+{
+};
+
+#endif
+
+/// @brief XC potential of gamma-only LCAO calculations integrated on atom-centered grids
+/// The density of each spin is built from DM(R) on the atom grids of Gint_Atom, mixed with the
+/// coefficients Charge_Mixing found for the density of the FFT grid, and <phi|V_xc|phi> of the
+/// LDA potential is added to H(R).
+/// "xc" is then left out of the Potential, so the FFT grid only carries the local pseudopotential
+/// and the Hartree potential. Only molecules and clusters, whose orbitals do not overlap with
+/// their periodic images, can be calculated in this way.
+/// @tparam TK
+/// @tparam TR
+template <typename TK, typename TR>
+class VxcAtom<OperatorLCAO<TK, TR>> : public OperatorLCAO<TK, TR>
+{
+  public:
+    VxcAtom<OperatorLCAO<TK, TR>>(const Grid_Technique* gt_in,
+                                  HS_Matrix_K<TK>* hsk_in,
+                                  const std::vector<ModuleBase::Vector3<double>>& kvec_d_in,
+                                  elecstate::Potential* pot_in,
+                                  hamilt::HContainer<TR>* hR_in,
+                                  const UnitCell* ucell_in,
+                                  const std::vector<double>& orb_cutoff,
+                                  const Grid_Driver* GridD_in,
+                                  elecstate::DensityMatrix<TK, double>* DM_in);
+
+    ~VxcAtom<OperatorLCAO<TK, TR>>(){};
+
+    /**
+     * @brief contributeHR() adds <phi_{\mu, 0}|V_{xc}|phi_{\nu, 0}> of the current spin to HR
+     * V_{xc} of all the spins is calculated when the first spin is asked for
+     */
+    virtual void contributeHR() override;
+
+    /**
+     * @brief mix the density of the atom grids with the coefficients of chgmix_in
+     * without a Charge_Mixing the output density of each step is used as it is
+     */
+    void set_mixing(const Charge_Mixing* chgmix_in)
+    {
+        this->chgmix = chgmix_in;
+    }
+
+    /**
+     * @brief density of the current DM(R) on the atom grids and its difference from the input density,
+     * \sum_{is} \int |rho_out - rho_in| / nelec as in Charge_Mixing::get_drho() with scf_thr_type 2
+     * the output density is kept for the mixing of the next call of contributeHR()
+     */
+    double cal_drho(const double nelec);
+
+  private:
+    elecstate::Potential* pot = nullptr;
+
+    elecstate::DensityMatrix<TK, double>* DM = nullptr;
+
+    int nspin = 1;
+
+    Gint_Atom grid;
+
+    const Charge_Mixing* chgmix = nullptr;
+
+    // mixed density of each spin on the local points of the atom grids
+    std::vector<std::vector<double>> rho_in;
+    // density of each spin from the last DM(R), valid until it is mixed if rho_out_ready
+    std::vector<std::vector<double>> rho_out;
+    bool rho_out_ready = false;
+    // history of the densities on the atom grids, pushed in step with that of the FFT grid
+    Base_Mixing::Mixing_Data rho_mdata;
+
+    // DM(R) and <phi|V_xc|phi> of each spin on the <I,J> pairs of the local batches
+    std::vector<std::unique_ptr<hamilt::HContainer<double>>> dm_serial;
+    std::vector<std::unique_ptr<hamilt::HContainer<double>>> v_serial;
+#ifdef __MPI
+    std::vector<std::unique_ptr<hamilt::HTransferPlan<double>>> dm_plans;
+    std::vector<std::unique_ptr<hamilt::HTransferPlan<double>>> v_plans;
+#endif
+
+    /**
+     * @brief quit if the orbitals of an atom overlap with those of a periodic image
+     */
+    void check_isolated(const UnitCell* ucell_in, const std::vector<double>& orb_cutoff, const Grid_Driver* GridD_in);
+
+    // rho_out from DM(R), the atomic densities before the first diagonalization
+    void cal_rho_out();
+
+    // rho_in of the next step from rho_in and rho_out
+    void mix_rho();
+
+    // V_xc and E_xc of the mixed density on the atom grids, <phi|V_xc|phi> of all the spins
+    void cal_vxc();
+};
+
+} // namespace hamilt
+#endif
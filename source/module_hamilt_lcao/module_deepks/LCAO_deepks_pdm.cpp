@@ -22,6 +22,8 @@
 #include "module_base/vector3.h"
 #include "module_hamilt_lcao/module_hcontainer/atom_pair.h"
 
+#include <algorithm>
+
 void LCAO_Deepks::read_projected_DM(bool read_pdm_file, bool is_equiv, const Numerical_Orbital& alpha)
 {
     if (read_pdm_file && !this->init_pdm) // for DeePKS NSCF calculation
@@ -105,252 +107,233 @@ void LCAO_Deepks::cal_projected_DM(const elecstate::DensityMatrix<TK, double>* d
     }
 
     const double Rcut_Alpha = orb.Alpha[0].getRcut();
-    for (int T0 = 0; T0 < ucell.ntype; T0++)
+    int nproj = 0;
+    for (int L0 = 0; L0 <= orb.Alpha[0].getLmax(); ++L0)
+    {
+        nproj += (2 * L0 + 1) * orb.Alpha[0].getNchi(L0);
+    }
+
+    // the neighbor search is not thread safe, so the adjacent atoms are found first
+    std::vector<AdjacentAtomInfo> adjs_all(ucell.nat);
+    for (int iat = 0; iat < ucell.nat; iat++)
+    {
+        const int T0 = ucell.iat2it[iat];
+        const int I0 = ucell.iat2ia[iat];
+        GridD.Find_atom(ucell, ucell.atoms[T0].tau[I0], T0, I0, &adjs_all[iat]);
+    }
+
+    // pdm of each projector atom is (S_1)^T DM S_2, where S_1 and S_2 are the local rows (columns) of <phi|alpha>
+    // of two neighbors, with all the nproj projectors as the columns, and the blocks of (L0, N0) are kept
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (int iat = 0; iat < ucell.nat; iat++)
     {
-        Atom* atom0 = &ucell.atoms[T0];
-        for (int I0 = 0; I0 < atom0->na; I0++)
+        const int T0 = ucell.iat2it[iat];
+        const int I0 = ucell.iat2ia[iat];
+        const ModuleBase::Vector3<double> tau0 = ucell.atoms[T0].tau[I0];
+        const AdjacentAtomInfo& adjs = adjs_all[iat];
+
+        std::vector<double> p_full(nproj * nproj, 0.0);
+        for (int ad1 = 0; ad1 < adjs.adj_num + 1; ++ad1)
         {
-            const int iat = ucell.itia2iat(T0, I0);
-            const ModuleBase::Vector3<double> tau0 = atom0->tau[I0];
-            GridD.Find_atom(ucell, atom0->tau[I0], T0, I0);
+            const int T1 = adjs.ntype[ad1];
+            const int I1 = adjs.natom[ad1];
+            const int ibt1 = ucell.itia2iat(T1, I1);
+            const ModuleBase::Vector3<double> tau1 = adjs.adjacent_tau[ad1];
+            const double Rcut_AO1 = orb.Phi[T1].getRcut();
+            const double dist1 = (tau1 - tau0).norm() * ucell.lat0;
+            if (dist1 >= Rcut_Alpha + Rcut_AO1)
+            {
+                continue;
+            }
 
-            // trace alpha orbital
-            std::vector<int> trace_alpha_row;
-            std::vector<int> trace_alpha_col;
-            if (!PARAM.inp.deepks_equiv)
+            const ModuleBase::Vector3<int> dR1 = adjs.box[ad1];
+            const hamilt::BaseMatrix<double>* overlap_1 = this->phialpha[0]->find_matrix(iat, ibt1, dR1);
+            if (overlap_1 == nullptr)
             {
-                int ib = 0;
-                for (int L0 = 0; L0 <= orb.Alpha[0].getLmax(); ++L0)
-                {
-                    for (int N0 = 0; N0 < orb.Alpha[0].getNchi(L0); ++N0)
-                    {
-                        const int inl = this->inl_index[T0](I0, L0, N0);
-                        const int nm = 2 * L0 + 1;
+                continue;
+            }
 
-                        for (int m1 = 0; m1 < nm; ++m1) // m1 = 1 for s, 3 for p, 5 for d
-                        {
-                            for (int m2 = 0; m2 < nm; ++m2) // m1 = 1 for s, 3 for p, 5 for d
-                            {
-                                trace_alpha_row.push_back(ib + m1);
-                                trace_alpha_col.push_back(ib + m2);
-                            }
-                        }
-                        ib += nm;
-                    }
-                }
+            const auto row_indexes = pv->get_indexes_row(ibt1);
+            const int row_size = row_indexes.size();
+            if (row_size == 0)
+            {
+                continue;
             }
-            else
+
+            std::vector<double> s_1(row_size * nproj);
+            for (int irow = 0; irow < row_size; irow++)
             {
-                int nproj = 0;
-                for (int il = 0; il < this->lmaxd + 1; il++)
-                {
-                    nproj += (2 * il + 1) * orb.Alpha[0].getNchi(il);
-                }
-                for (int iproj = 0; iproj < nproj; iproj++)
-                {
-                    for (int jproj = 0; jproj < nproj; jproj++)
-                    {
-                        trace_alpha_row.push_back(iproj);
-                        trace_alpha_col.push_back(jproj);
-                    }
-                }
+                const double* row_ptr = &overlap_1->get_value(row_indexes[irow], 0);
+                std::copy(row_ptr, row_ptr + nproj, &s_1[irow * nproj]);
             }
-            const int trace_alpha_size = trace_alpha_row.size();
+            // g_1dm = DM S_2, summed over the neighbors ad2
+            std::vector<double> g_1dm(row_size * nproj, 0.0);
 
-            for (int ad1 = 0; ad1 < GridD.getAdjacentNum() + 1; ++ad1)
+            for (int ad2 = 0; ad2 < adjs.adj_num + 1; ad2++)
             {
-                const int T1 = GridD.getType(ad1);
-                const int I1 = GridD.getNatom(ad1);
-                const int ibt1 = ucell.itia2iat(T1, I1);
-                const ModuleBase::Vector3<double> tau1 = GridD.getAdjacentTau(ad1);
-                const Atom* atom1 = &ucell.atoms[T1];
-                const int nw1_tot = atom1->nw * PARAM.globalv.npol;
-                const double Rcut_AO1 = orb.Phi[T1].getRcut();
-                const double dist1 = (tau1 - tau0).norm() * ucell.lat0;
-                if (dist1 >= Rcut_Alpha + Rcut_AO1)
+                const int T2 = adjs.ntype[ad2];
+                const int I2 = adjs.natom[ad2];
+                const int ibt2 = ucell.itia2iat(T2, I2);
+                const ModuleBase::Vector3<double> tau2 = adjs.adjacent_tau[ad2];
+                const double Rcut_AO2 = orb.Phi[T2].getRcut();
+                const double dist2 = (tau2 - tau0).norm() * ucell.lat0;
+                if (dist2 >= Rcut_Alpha + Rcut_AO2)
                 {
                     continue;
                 }
 
-                ModuleBase::Vector3<int> dR1(GridD.getBox(ad1).x, GridD.getBox(ad1).y, GridD.getBox(ad1).z);
-                if constexpr (std::is_same<TK, std::complex<double>>::value)
+                const ModuleBase::Vector3<int> dR2 = adjs.box[ad2];
+                const hamilt::BaseMatrix<double>* overlap_2 = this->phialpha[0]->find_matrix(iat, ibt2, dR2);
+                if (overlap_2 == nullptr)
                 {
-                    if (this->phialpha[0]->find_matrix(iat, ibt1, dR1.x, dR1.y, dR1.z) == nullptr)
-                    {
-                        continue;
-                    }
+                    continue;
                 }
 
-                auto row_indexes = pv->get_indexes_row(ibt1);
-                const int row_size = row_indexes.size();
-                if (row_size == 0)
+                const auto col_indexes = pv->get_indexes_col(ibt2);
+                const int col_size = col_indexes.size();
+                if (col_size == 0)
                 {
                     continue;
                 }
 
-                // no possible to unexist key
-                std::vector<double> s_1t(trace_alpha_size * row_size);
-                std::vector<double> g_1dmt(trace_alpha_size * row_size, 0.0);
-                for (int irow = 0; irow < row_size; irow++)
+                // prepare DM_gamma from DMR
+                std::vector<double> dm_array(row_size * col_size, 0.0);
+                const double* dm_current = nullptr;
+                for (int is = 0; is < dm->get_DMR_vector().size(); is++)
                 {
-                    hamilt::BaseMatrix<double>* row_ptr = this->phialpha[0]->find_matrix(iat, ibt1, dR1);
-
-                    for (int i = 0; i < trace_alpha_size; i++)
+                    int dRx, dRy, dRz;
+                    if constexpr (std::is_same<TK, double>::value)
                     {
-                        s_1t[i * row_size + irow] = row_ptr->get_value(row_indexes[irow], trace_alpha_row[i]);
+                        dRx = 0;
+                        dRy = 0;
+                        dRz = 0;
                     }
-                }
-
-                for (int ad2 = 0; ad2 < GridD.getAdjacentNum() + 1; ad2++)
-                {
-                    const int T2 = GridD.getType(ad2);
-                    const int I2 = GridD.getNatom(ad2);
-                    const int ibt2 = ucell.itia2iat(T2, I2);
-                    const ModuleBase::Vector3<double> tau2 = GridD.getAdjacentTau(ad2);
-                    const Atom* atom2 = &ucell.atoms[T2];
-                    const int nw2_tot = atom2->nw * PARAM.globalv.npol;
-
-                    ModuleBase::Vector3<int> dR2(GridD.getBox(ad2).x, GridD.getBox(ad2).y, GridD.getBox(ad2).z);
-                    if constexpr (std::is_same<TK, std::complex<double>>::value)
+                    else
                     {
-                        if (this->phialpha[0]->find_matrix(iat, ibt2, dR2.x, dR2.y, dR2.z) == nullptr)
-                        {
-                            continue;
-                        }
+                        dRx = dR2.x - dR1.x;
+                        dRy = dR2.y - dR1.y;
+                        dRz = dR2.z - dR1.z;
                     }
-
-                    const double Rcut_AO2 = orb.Phi[T2].getRcut();
-                    const double dist2 = (tau2 - tau0).norm() * ucell.lat0;
-
-                    if (dist2 >= Rcut_Alpha + Rcut_AO2)
+                    auto* tmp = dm->get_DMR_vector()[is]->find_matrix(ibt1, ibt2, dRx, dRy, dRz);
+                    if (tmp == nullptr)
                     {
-                        continue;
+                        // in case of no deepks_scf but out_deepks_label, size of DMR would mismatch with
+                        // deepks-orbitals
+                        dm_current = nullptr;
+                        break;
                     }
-
-                    auto col_indexes = pv->get_indexes_col(ibt2);
-                    const int col_size = col_indexes.size();
-                    if (col_size == 0)
+                    dm_current = tmp->get_pointer();
+                    for (int idm = 0; idm < row_size * col_size; idm++)
                     {
-                        continue;
+                        dm_array[idm] += dm_current[idm];
                     }
+                }
+                if (dm_current == nullptr)
+                {
+                    continue; // skip the long range DM pair more than nonlocal term
+                }
 
-                    std::vector<double> s_2t(trace_alpha_size * col_size);
-                    // no possible to unexist key
-                    for (int icol = 0; icol < col_size; icol++)
-                    {
-                        hamilt::BaseMatrix<double>* col_ptr = this->phialpha[0]->find_matrix(iat, ibt2, dR2);
-                        for (int i = 0; i < trace_alpha_size; i++)
-                        {
-                            s_2t[i * col_size + icol] = col_ptr->get_value(col_indexes[icol], trace_alpha_col[i]);
-                        }
-                    }
-                    // prepare DM_gamma from DMR
-                    std::vector<double> dm_array(row_size * col_size, 0.0);
-                    const double* dm_current = nullptr;
-                    for (int is = 0; is < dm->get_DMR_vector().size(); is++)
-                    {
-                        int dRx, dRy, dRz;
-                        if constexpr (std::is_same<TK, double>::value)
-                        {
-                            dRx = 0;
-                            dRy = 0;
-                            dRz = 0;
-                        }
-                        else
-                        {
-                            dRx = dR2.x - dR1.x;
-                            dRy = dR2.y - dR1.y;
-                            dRz = dR2.z - dR1.z;
-                        }
-                        auto* tmp = dm->get_DMR_vector()[is]->find_matrix(ibt1, ibt2, dRx, dRy, dRz);
-                        if (tmp == nullptr)
-                        {
-                            // in case of no deepks_scf but out_deepks_label, size of DMR would mismatch with
-                            // deepks-orbitals
-                            dm_current = nullptr;
-                            break;
-                        }
-                        dm_current = tmp->get_pointer();
-                        for (int idm = 0; idm < row_size * col_size; idm++)
-                        {
-                            dm_array[idm] += dm_current[idm];
-                        }
-                    }
-                    if (dm_current == nullptr)
-                    {
-                        continue; // skip the long range DM pair more than nonlocal term
-                    }
+                std::vector<double> s_2(col_size * nproj);
+                for (int icol = 0; icol < col_size; icol++)
+                {
+                    const double* col_ptr = &overlap_2->get_value(col_indexes[icol], 0);
+                    std::copy(col_ptr, col_ptr + nproj, &s_2[icol * nproj]);
+                }
 
-                    dm_current = dm_array.data();
-                    // dgemm for s_2t and dm_current to get g_1dmt
-                    constexpr char transa = 'T', transb = 'N';
-                    const double gemm_alpha = 1.0, gemm_beta = 1.0;
-                    dgemm_(&transa,
-                           &transb,
-                           &row_size,
-                           &trace_alpha_size,
-                           &col_size,
-                           &gemm_alpha,
-                           dm_current,
-                           &col_size,
-                           s_2t.data(),
-                           &col_size,
-                           &gemm_beta,
-                           g_1dmt.data(),
-                           &row_size);
-                } // ad2
-                // do dot of g_1dmt and s_1t to get orbital_pdm_shell
-                if (!PARAM.inp.deepks_equiv)
+                // dgemm for dm_array and s_2 to get g_1dm, all the matrices are row-major
+                constexpr char transa = 'N', transb = 'N';
+                const double gemm_alpha = 1.0, gemm_beta = 1.0;
+                dgemm_(&transa,
+                       &transb,
+                       &nproj,
+                       &row_size,
+                       &col_size,
+                       &gemm_alpha,
+                       s_2.data(),
+                       &nproj,
+                       dm_array.data(),
+                       &col_size,
+                       &gemm_beta,
+                       g_1dm.data(),
+                       &nproj);
+            } // ad2
+
+            // p_full += (s_1)^T g_1dm, only the diagonal blocks of (L0, N0) are needed without deepks_equiv
+            constexpr char transa = 'N', transb = 'T';
+            const double gemm_alpha = 1.0, gemm_beta = 1.0;
+            if (!PARAM.inp.deepks_equiv)
+            {
+                int ib = 0;
+                for (int L0 = 0; L0 <= orb.Alpha[0].getLmax(); ++L0)
                 {
-                    int ib = 0, index = 0, inc = 1;
-                    for (int L0 = 0; L0 <= orb.Alpha[0].getLmax(); ++L0)
+                    const int nm = 2 * L0 + 1;
+                    for (int N0 = 0; N0 < orb.Alpha[0].getNchi(L0); ++N0)
                     {
-                        for (int N0 = 0; N0 < orb.Alpha[0].getNchi(L0); ++N0)
-                        {
-                            const int inl = this->inl_index[T0](I0, L0, N0);
-                            const int nm = 2 * L0 + 1;
-
-                            for (int m1 = 0; m1 < nm; ++m1) // m1 = 1 for s, 3 for p, 5 for d
-                            {
-                                for (int m2 = 0; m2 < nm; ++m2) // m1 = 1 for s, 3 for p, 5 for d
-                                {
-                                    int ind = m1 * nm + m2;
-                                    pdm[inl][ind] += ddot_(&row_size,
-                                                           g_1dmt.data() + index * row_size,
-                                                           &inc,
-                                                           s_1t.data() + index * row_size,
-                                                           &inc);
-                                    index++;
-                                }
-                            }
-                            ib += nm;
-                        }
+                        dgemm_(&transa,
+                               &transb,
+                               &nm,
+                               &nm,
+                               &row_size,
+                               &gemm_alpha,
+                               g_1dm.data() + ib,
+                               &nproj,
+                               s_1.data() + ib,
+                               &nproj,
+                               &gemm_beta,
+                               p_full.data() + ib * nproj + ib,
+                               &nproj);
+                        ib += nm;
                     }
                 }
-                else
+            }
+            else
+            {
+                dgemm_(&transa,
+                       &transb,
+                       &nproj,
+                       &nproj,
+                       &row_size,
+                       &gemm_alpha,
+                       g_1dm.data(),
+                       &nproj,
+                       s_1.data(),
+                       &nproj,
+                       &gemm_beta,
+                       p_full.data(),
+                       &nproj);
+            }
+        } // ad1
+
+        if (!PARAM.inp.deepks_equiv)
+        {
+            int ib = 0;
+            for (int L0 = 0; L0 <= orb.Alpha[0].getLmax(); ++L0)
+            {
+                const int nm = 2 * L0 + 1;
+                for (int N0 = 0; N0 < orb.Alpha[0].getNchi(L0); ++N0)
                 {
-                    int index = 0, inc = 1;
-                    int nproj = 0;
-                    for (int il = 0; il < this->lmaxd + 1; il++)
-                    {
-                        nproj += (2 * il + 1) * orb.Alpha[0].getNchi(il);
-                    }
-                    for (int iproj = 0; iproj < nproj; iproj++)
+                    const int inl = this->inl_index[T0](I0, L0, N0);
+                    for (int m1 = 0; m1 < nm; ++m1) // m1 = 1 for s, 3 for p, 5 for d
                     {
-                        for (int jproj = 0; jproj < nproj; jproj++)
+                        for (int m2 = 0; m2 < nm; ++m2) // m1 = 1 for s, 3 for p, 5 for d
                         {
-                            pdm[iat][iproj * nproj + jproj] += ddot_(&row_size,
-                                                                     g_1dmt.data() + index * row_size,
-                                                                     &inc,
-                                                                     s_1t.data() + index * row_size,
-                                                                     &inc);
-                            index++;
+                            pdm[inl][m1 * nm + m2] += p_full[(ib + m1) * nproj + ib + m2];
                         }
                     }
+                    ib += nm;
                 }
-            } // ad1
-        }     // I0
-    }         // T0
+            }
+        }
+        else
+        {
+            for (int ind = 0; ind < nproj * nproj; ind++)
+            {
+                pdm[iat][ind] += p_full[ind];
+            }
+        }
+    } // iat
 
 #ifdef __MPI
     allsum_deepks(this->inlmax, pdm_size, this->pdm);
@@ -8,6 +8,9 @@
 #include "module_hamilt_lcao/module_hcontainer/atom_pair.h"
 #include "module_parameter/parameter.h"
 
+#include <algorithm>
+#include <vector>
+
 /// this subroutine calculates the gradient of projected density matrices
 /// gdmx_m,m = d/dX sum_{mu,nu} rho_{mu,nu} <chi_mu|alpha_m><alpha_m'|chi_nu>
 /// if stress label is enabled, the gradient of PDM wrt strain tensor will
@@ -19,6 +22,65 @@
 // 1. cal_gdmx, calculating gdmx (and optionally gdm_epsl for stress) for gamma point
 // 2. check_gdmx, which prints gdmx to a series of .dat files
 
+namespace
+{
+// the rows of <phi|alpha> of the local orbitals, row-major with nproj columns
+std::vector<double> gather_rows(const hamilt::BaseMatrix<double>* overlap,
+                                const std::vector<int>& indexes,
+                                const int nproj)
+{
+    std::vector<double> rows(indexes.size() * nproj);
+    for (int i = 0; i < indexes.size(); ++i)
+    {
+        const double* row_ptr = &overlap->get_value(indexes[i], 0);
+        std::copy(row_ptr, row_ptr + nproj, &rows[i * nproj]);
+    }
+    return rows;
+}
+
+// (s_1)^T dm s_2 of size nproj * nproj, where s_1, dm and s_2 are row-major
+// of size row_size * nproj, row_size * col_size and col_size * nproj
+std::vector<double> dm_sandwich(const std::vector<double>& s_1,
+                                const double* dm,
+                                const std::vector<double>& s_2,
+                                const int row_size,
+                                const int col_size,
+                                const int nproj)
+{
+    std::vector<double> g_1dm(row_size * nproj, 0.0);
+    std::vector<double> result(nproj * nproj, 0.0);
+    const double gemm_alpha = 1.0, gemm_beta = 0.0;
+    constexpr char transn = 'N', transt = 'T';
+    dgemm_(&transn,
+           &transn,
+           &nproj,
+           &row_size,
+           &col_size,
+           &gemm_alpha,
+           s_2.data(),
+           &nproj,
+           dm,
+           &col_size,
+           &gemm_beta,
+           g_1dm.data(),
+           &nproj);
+    dgemm_(&transn,
+           &transt,
+           &nproj,
+           &nproj,
+           &row_size,
+           &gemm_alpha,
+           g_1dm.data(),
+           &nproj,
+           s_1.data(),
+           &nproj,
+           &gemm_beta,
+           result.data(),
+           &nproj);
+    return result;
+}
+} // namespace
+
 template <typename TK>
 void LCAO_Deepks::cal_gdmx(const std::vector<std::vector<TK>>& dm,
                            const UnitCell& ucell,
@@ -165,139 +227,92 @@ void LCAO_Deepks::cal_gdmx(const std::vector<std::vector<TK>>& dm,
 
                     dm_current = dm_pair.get_pointer();
 
-                    for (int iw1 = 0; iw1 < row_indexes.size(); ++iw1)
+                    const hamilt::BaseMatrix<double>* overlap_1 = phialpha[0]->find_matrix(iat, ibt1, dR1);
+                    const hamilt::BaseMatrix<double>* overlap_2 = phialpha[0]->find_matrix(iat, ibt2, dR2);
+                    if (overlap_1 == nullptr || overlap_2 == nullptr)
                     {
-                        for (int iw2 = 0; iw2 < col_indexes.size(); ++iw2)
+                        continue;
+                    }
+                    std::vector<const hamilt::BaseMatrix<double>*> grad_overlap_1(3);
+                    std::vector<const hamilt::BaseMatrix<double>*> grad_overlap_2(3);
+                    for (int i = 0; i < 3; ++i)
+                    {
+                        grad_overlap_1[i] = phialpha[i + 1]->find_matrix(iat, ibt1, dR1);
+                        grad_overlap_2[i] = phialpha[i + 1]->find_matrix(iat, ibt2, dR2);
+                    }
+                    const int nproj = overlap_1->get_col_size();
+                    assert(nproj == overlap_2->get_col_size());
+
+                    // x[i](m1, m2) = sum_{mu,nu} <chi_mu|alpha_m1> rho_{mu,nu} <d/dX_i chi_nu|alpha_m2>
+                    const int row_size = row_indexes.size();
+                    const int col_size = col_indexes.size();
+                    std::vector<double> s_1 = gather_rows(overlap_1, row_indexes, nproj);
+                    std::vector<double> x[3];
+                    for (int i = 0; i < 3; ++i)
+                    {
+                        x[i] = dm_sandwich(s_1, dm_current, gather_rows(grad_overlap_2[i], col_indexes, nproj),
+                                           row_size, col_size, nproj);
+                    }
+                    // y[i](m1, m2) = sum_{mu,nu} <d/dX_i chi_mu|alpha_m1> rho_{mu,nu} <chi_nu|alpha_m2>
+                    std::vector<double> y[3];
+                    if (isstress)
+                    {
+                        const std::vector<double> s_2 = gather_rows(overlap_2, col_indexes, nproj);
+                        for (int i = 0; i < 3; ++i)
                         {
-                            hamilt::BaseMatrix<double>* overlap_1 = phialpha[0]->find_matrix(iat, ibt1, dR1);
-                            hamilt::BaseMatrix<double>* overlap_2 = phialpha[0]->find_matrix(iat, ibt2, dR2);
-                            std::vector<hamilt::BaseMatrix<double>*> grad_overlap_1(3);
-                            std::vector<hamilt::BaseMatrix<double>*> grad_overlap_2(3);
-
-                            assert(overlap_1->get_col_size() == overlap_2->get_col_size());
-
-                            for (int i = 0; i < 3; ++i)
-                            {
-                                grad_overlap_1[i] = phialpha[i + 1]->find_matrix(iat, ibt1, dR1);
-                                grad_overlap_2[i] = phialpha[i + 1]->find_matrix(iat, ibt2, dR2);
-                            }
+                            y[i] = dm_sandwich(gather_rows(grad_overlap_1[i], row_indexes, nproj), dm_current, s_2,
+                                               row_size, col_size, nproj);
+                        }
+                    }
 
-                            int ib = 0;
-                            for (int L0 = 0; L0 <= orb.Alpha[0].getLmax(); ++L0)
-                            {
-                                for (int N0 = 0; N0 < orb.Alpha[0].getNchi(L0); ++N0)
-                                {
-                                    const int inl = this->inl_index[T0](I0, L0, N0);
-                                    const int nm = 2 * L0 + 1;
-                                    for (int m1 = 0; m1 < nm; ++m1)
-                                    {
-                                        for (int m2 = 0; m2 < nm; ++m2)
-                                        {
-                                            //(<d/dX chi_mu|alpha_m>)<chi_nu|alpha_m'>
-                                            gdmx[iat][inl][m1 * nm + m2]
-                                                += grad_overlap_2[0]->get_value(col_indexes[iw2], ib + m2)
-                                                   * overlap_1->get_value(row_indexes[iw1], ib + m1) * *dm_current;
-                                            gdmy[iat][inl][m1 * nm + m2]
-                                                += grad_overlap_2[1]->get_value(col_indexes[iw2], ib + m2)
-                                                   * overlap_1->get_value(row_indexes[iw1], ib + m1) * *dm_current;
-                                            gdmz[iat][inl][m1 * nm + m2]
-                                                += grad_overlap_2[2]->get_value(col_indexes[iw2], ib + m2)
-                                                   * overlap_1->get_value(row_indexes[iw1], ib + m1) * *dm_current;
-
-                                            //(<d/dX chi_nu|alpha_m'>)<chi_mu|alpha_m>
-                                            gdmx[iat][inl][m2 * nm + m1]
-                                                += grad_overlap_2[0]->get_value(col_indexes[iw2], ib + m2)
-                                                   * overlap_1->get_value(row_indexes[iw1], ib + m1) * *dm_current;
-                                            gdmy[iat][inl][m2 * nm + m1]
-                                                += grad_overlap_2[1]->get_value(col_indexes[iw2], ib + m2)
-                                                   * overlap_1->get_value(row_indexes[iw1], ib + m1) * *dm_current;
-                                            gdmz[iat][inl][m2 * nm + m1]
-                                                += grad_overlap_2[2]->get_value(col_indexes[iw2], ib + m2)
-                                                   * overlap_1->get_value(row_indexes[iw1], ib + m1) * *dm_current;
-
-                                            //(<chi_mu|d/dX alpha_m>)<chi_nu|alpha_m'> = -(<d/dX
-                                            //chi_mu|alpha_m>)<chi_nu|alpha_m'>
-                                            gdmx[ibt2][inl][m1 * nm + m2]
-                                                -= grad_overlap_2[0]->get_value(col_indexes[iw2], ib + m2)
-                                                   * overlap_1->get_value(row_indexes[iw1], ib + m1) * *dm_current;
-                                            gdmy[ibt2][inl][m1 * nm + m2]
-                                                -= grad_overlap_2[1]->get_value(col_indexes[iw2], ib + m2)
-                                                   * overlap_1->get_value(row_indexes[iw1], ib + m1) * *dm_current;
-                                            gdmz[ibt2][inl][m1 * nm + m2]
-                                                -= grad_overlap_2[2]->get_value(col_indexes[iw2], ib + m2)
-                                                   * overlap_1->get_value(row_indexes[iw1], ib + m1) * *dm_current;
-
-                                            //(<chi_nu|d/dX alpha_m'>)<chi_mu|alpha_m> = -(<d/dX
-                                            //chi_nu|alpha_m'>)<chi_mu|alpha_m>
-                                            gdmx[ibt2][inl][m2 * nm + m1]
-                                                -= grad_overlap_2[0]->get_value(col_indexes[iw2], ib + m2)
-                                                   * overlap_1->get_value(row_indexes[iw1], ib + m1) * *dm_current;
-                                            gdmy[ibt2][inl][m2 * nm + m1]
-                                                -= grad_overlap_2[1]->get_value(col_indexes[iw2], ib + m2)
-                                                   * overlap_1->get_value(row_indexes[iw1], ib + m1) * *dm_current;
-                                            gdmz[ibt2][inl][m2 * nm + m1]
-                                                -= grad_overlap_2[2]->get_value(col_indexes[iw2], ib + m2)
-                                                   * overlap_1->get_value(row_indexes[iw1], ib + m1) * *dm_current;
-
-                                            if (isstress)
-                                            {
-                                                int mm = 0;
-                                                for (int ipol = 0; ipol < 3; ipol++)
-                                                {
-                                                    for (int jpol = ipol; jpol < 3; jpol++)
-                                                    {
-                                                        gdm_epsl[mm][inl][m2 * nm + m1]
-                                                            += ucell.lat0 * *dm_current
-                                                               * (grad_overlap_2[jpol]->get_value(col_indexes[iw2],
-                                                                                                  ib + m2)
-                                                                  * overlap_1->get_value(row_indexes[iw1], ib + m1)
-                                                                  * r0[ipol]);
-                                                        mm++;
-                                                    }
-                                                }
-                                            }
-                                        }
-                                    }
-                                    ib += nm;
-                                }
-                            }
-                            assert(ib == overlap_1->get_col_size());
-                            if (isstress)
+                    int ib = 0;
+                    for (int L0 = 0; L0 <= orb.Alpha[0].getLmax(); ++L0)
+                    {
+                        for (int N0 = 0; N0 < orb.Alpha[0].getNchi(L0); ++N0)
+                        {
+                            const int inl = this->inl_index[T0](I0, L0, N0);
+                            const int nm = 2 * L0 + 1;
+                            for (int m1 = 0; m1 < nm; ++m1)
                             {
-                                int ib = 0;
-                                for (int L0 = 0; L0 <= orb.Alpha[0].getLmax(); ++L0)
+                                for (int m2 = 0; m2 < nm; ++m2)
                                 {
-                                    for (int N0 = 0; N0 < orb.Alpha[0].getNchi(L0); ++N0)
+                                    const int a12 = (ib + m1) * nproj + ib + m2;
+                                    //(<d/dX chi_mu|alpha_m>)<chi_nu|alpha_m'> and (<d/dX chi_nu|alpha_m'>)<chi_mu|alpha_m>
+                                    gdmx[iat][inl][m1 * nm + m2] += x[0][a12];
+                                    gdmy[iat][inl][m1 * nm + m2] += x[1][a12];
+                                    gdmz[iat][inl][m1 * nm + m2] += x[2][a12];
+                                    gdmx[iat][inl][m2 * nm + m1] += x[0][a12];
+                                    gdmy[iat][inl][m2 * nm + m1] += x[1][a12];
+                                    gdmz[iat][inl][m2 * nm + m1] += x[2][a12];
+
+                                    //(<chi_mu|d/dX alpha_m>)<chi_nu|alpha_m'> = -(<d/dX chi_mu|alpha_m>)<chi_nu|alpha_m'>
+                                    gdmx[ibt2][inl][m1 * nm + m2] -= x[0][a12];
+                                    gdmy[ibt2][inl][m1 * nm + m2] -= x[1][a12];
+                                    gdmz[ibt2][inl][m1 * nm + m2] -= x[2][a12];
+                                    gdmx[ibt2][inl][m2 * nm + m1] -= x[0][a12];
+                                    gdmy[ibt2][inl][m2 * nm + m1] -= x[1][a12];
+                                    gdmz[ibt2][inl][m2 * nm + m1] -= x[2][a12];
+
+                                    if (isstress)
                                     {
-                                        const int inl = this->inl_index[T0](I0, L0, N0);
-                                        const int nm = 2 * L0 + 1;
-                                        for (int m1 = 0; m1 < nm; ++m1)
+                                        const int a21 = (ib + m2) * nproj + ib + m1;
+                                        int mm = 0;
+                                        for (int ipol = 0; ipol < 3; ipol++)
                                         {
-                                            for (int m2 = 0; m2 < nm; ++m2)
+                                            for (int jpol = ipol; jpol < 3; jpol++)
                                             {
-                                                int mm = 0;
-                                                for (int ipol = 0; ipol < 3; ipol++)
-                                                {
-                                                    for (int jpol = ipol; jpol < 3; jpol++)
-                                                    {
-                                                        gdm_epsl[mm][inl][m2 * nm + m1]
-                                                            += ucell.lat0 * *dm_current
-                                                               * (overlap_2->get_value(col_indexes[iw2], ib + m1)
-                                                                  * grad_overlap_1[jpol]->get_value(row_indexes[iw1],
-                                                                                                    ib + m2)
-                                                                  * r1[ipol]);
-                                                        mm++;
-                                                    }
-                                                }
+                                                gdm_epsl[mm][inl][m2 * nm + m1]
+                                                    += ucell.lat0 * (x[jpol][a12] * r0[ipol] + y[jpol][a21] * r1[ipol]);
+                                                mm++;
                                             }
                                         }
-                                        ib += nm;
                                     }
                                 }
                             }
-                            dm_current++;
-                        } // iw2
-                    }     // iw1
+                            ib += nm;
+                        }
+                    }
+                    assert(ib == nproj);
                 }         // ad2
             }             // ad1
         }                 // I0
@@ -29,7 +29,8 @@ void DeePKS_domain::cal_o_delta(const std::vector<TH>& dm_hl,
                 {
                     int iic;
                     if (PARAM.inp.ks_solver == "genelpa" || PARAM.inp.ks_solver == "scalapack_gvx"
-                        || PARAM.inp.ks_solver == "pexsi") // save the matrix as column major format
+                        || PARAM.inp.ks_solver == "pexsi"
+                        || PARAM.inp.ks_solver == "foe") // save the matrix as column major format
                     {
                         iic = mu + nu * pv.nrow;
                     }
@@ -11,9 +11,11 @@
 #include "module_elecstate/elecstate_pw.h"
 
 #ifdef __LCAO
+#include "module_base/scalapack_connector.h"
 #include "module_elecstate/elecstate_lcao.h"
 #include "module_elecstate/module_dm/cal_dm_psi.h"
 #include "module_hamilt_lcao/hamilt_lcaodft/operator_lcao/dspin_lcao.h"
+#include "subspace_funcs.h"
 #endif
 
 template <>
@@ -127,6 +129,152 @@ void spinconstrain::SpinConstrain<std::complex<double>>::calculate_delta_hcc(std
     }
 }
 
+#ifdef __LCAO
+template <>
+void spinconstrain::SpinConstrain<std::complex<double>>::update_psi_full_lcao()
+{
+    psi::Psi<std::complex<double>>* psi_t = static_cast<psi::Psi<std::complex<double>>*>(this->psi);
+    hamilt::Hamilt<std::complex<double>>* hamilt_t = static_cast<hamilt::Hamilt<std::complex<double>>*>(this->p_hamilt);
+    hsolver::HSolverLCAO<std::complex<double>> hsolver_t(this->ParaV, PARAM.inp.ks_solver);
+    // diagonalization without update charge
+    hsolver_t.solve(hamilt_t, psi_t[0], this->pelec, true);
+    this->pelec->calculate_weights();
+    this->pelec->calEBand();
+    elecstate::ElecStateLCAO<std::complex<double>>* pelec_lcao
+        = dynamic_cast<elecstate::ElecStateLCAO<std::complex<double>>*>(this->pelec);
+    elecstate::cal_dm_psi(this->ParaV, pelec_lcao->wg, *psi_t, *(pelec_lcao->get_DM()));
+    pelec_lcao->get_DM()->cal_DMR();
+
+    // save the new subspace, S*psi is calculated in the first subspace step
+    std::vector<std::complex<double>>().swap(this->spsi_full_save);
+#ifdef __MPI
+    if (PARAM.inp.sc_subspace_thr > 0.0 && GlobalV::KPAR_LCAO == 1 && PARAM.inp.ks_solver != "pexsi"
+        && PARAM.inp.ks_solver != "foe")
+    {
+        psi_t->fix_k(0);
+        this->psi_full_save.assign(psi_t->get_pointer(), psi_t->get_pointer() + psi_t->size());
+    }
+#endif
+}
+
+template <>
+bool spinconstrain::SpinConstrain<std::complex<double>>::update_psi_subspace_lcao()
+{
+    if (this->psi_full_save.empty())
+    {
+        return false;
+    }
+#ifdef __MPI
+    ModuleBase::TITLE("spinconstrain::SpinConstrain", "update_psi_subspace_lcao");
+    ModuleBase::timer::tick("spinconstrain::SpinConstrain", "update_psi_subspace_lcao");
+    using T = std::complex<double>;
+    psi::Psi<T>* psi_t = static_cast<psi::Psi<T>*>(this->psi);
+    hamilt::Hamilt<T>* hamilt_t = static_cast<hamilt::Hamilt<T>*>(this->p_hamilt);
+    const int nbands = PARAM.inp.nbands;
+    const int nlocal = PARAM.globalv.nlocal;
+    const int nk = psi_t->get_nk();
+    const size_t size_k = static_cast<size_t>(psi_t->get_nbands()) * psi_t->get_nbasis();
+    const int* desc_wfc = this->ParaV->desc_wfc;
+    const bool init_spsi = this->spsi_full_save.empty();
+    if (init_spsi)
+    {
+        this->spsi_full_save.resize(this->psi_full_save.size());
+    }
+
+    // nbands*nbands matrices on the BLACS grid of H(k)
+    Parallel_2D pv_sub;
+    pv_sub.set(nbands, nbands, this->ParaV->nb, this->ParaV->blacs_ctxt);
+    std::vector<T> hc(std::max(size_k, size_t(1)));
+    std::vector<T> hsub_loc(std::max(pv_sub.nloc, int64_t(1)));
+    std::vector<T> wsub_loc(std::max(pv_sub.nloc, int64_t(1)));
+    std::vector<T> hsub(nbands * nbands);
+    std::vector<T> wsub(nbands * nbands);
+    ModuleBase::matrix residual(nk, nbands);
+    const T one(1.0, 0.0);
+    const T zero(0.0, 0.0);
+    for (int ik = 0; ik < nk; ++ik)
+    {
+        hamilt_t->updateHk(ik);
+        hamilt::MatrixBlock<T> h_mat;
+        hamilt::MatrixBlock<T> s_mat;
+        hamilt_t->matrix(h_mat, s_mat);
+        const T* c0 = this->psi_full_save.data() + ik * size_k;
+        T* sc0 = this->spsi_full_save.data() + ik * size_k;
+        if (init_spsi)
+        {
+            ScalapackConnector::gemm('N', 'N', nlocal, nbands, nlocal,
+                                     one, s_mat.p, 1, 1, s_mat.desc, c0, 1, 1, desc_wfc,
+                                     zero, sc0, 1, 1, desc_wfc);
+        }
+        // hsub = C^dagger H C, G = H C - S C hsub, wsub = G^dagger G
+        ScalapackConnector::gemm('N', 'N', nlocal, nbands, nlocal,
+                                 one, h_mat.p, 1, 1, h_mat.desc, c0, 1, 1, desc_wfc,
+                                 zero, hc.data(), 1, 1, desc_wfc);
+        ScalapackConnector::gemm('C', 'N', nbands, nbands, nlocal,
+                                 one, c0, 1, 1, desc_wfc, hc.data(), 1, 1, desc_wfc,
+                                 zero, hsub_loc.data(), 1, 1, pv_sub.desc);
+        ScalapackConnector::gemm('N', 'N', nlocal, nbands, nbands,
+                                 -one, sc0, 1, 1, desc_wfc, hsub_loc.data(), 1, 1, pv_sub.desc,
+                                 one, hc.data(), 1, 1, desc_wfc);
+        ScalapackConnector::gemm('C', 'N', nbands, nbands, nlocal,
+                                 one, hc.data(), 1, 1, desc_wfc, hc.data(), 1, 1, desc_wfc,
+                                 zero, wsub_loc.data(), 1, 1, pv_sub.desc);
+
+        // the small eigenproblem is solved on every process
+        std::fill(hsub.begin(), hsub.end(), zero);
+        std::fill(wsub.begin(), wsub.end(), zero);
+        for (int ic = 0; ic < pv_sub.get_col_size(); ++ic)
+        {
+            const int gc = pv_sub.local2global_col(ic);
+            for (int ir = 0; ir < pv_sub.get_row_size(); ++ir)
+            {
+                const int gr = pv_sub.local2global_row(ir);
+                hsub[gc * nbands + gr] = hsub_loc[ic * pv_sub.get_row_size() + ir];
+                wsub[gc * nbands + gr] = wsub_loc[ic * pv_sub.get_row_size() + ir];
+            }
+        }
+        Parallel_Reduce::reduce_pool(hsub.data(), nbands * nbands);
+        Parallel_Reduce::reduce_pool(wsub.data(), nbands * nbands);
+        spinconstrain::diag_subspace_lcao(nbands, hsub.data(), wsub.data(), &this->pelec->ekb(ik, 0), &residual(ik, 0));
+
+        // psi = C V
+        for (int ic = 0; ic < pv_sub.get_col_size(); ++ic)
+        {
+            const int gc = pv_sub.local2global_col(ic);
+            for (int ir = 0; ir < pv_sub.get_row_size(); ++ir)
+            {
+                hsub_loc[ic * pv_sub.get_row_size() + ir] = hsub[gc * nbands + pv_sub.local2global_row(ir)];
+            }
+        }
+        psi_t->fix_k(ik);
+        ScalapackConnector::gemm('N', 'N', nlocal, nbands, nbands,
+                                 one, c0, 1, 1, desc_wfc, hsub_loc.data(), 1, 1, pv_sub.desc,
+                                 zero, psi_t->get_pointer(), 1, 1, desc_wfc);
+    }
+    this->pelec->calculate_weights();
+
+    const double max_residual = spinconstrain::max_occupied_residual(this->pelec->wg, residual);
+    const bool accepted = max_residual <= PARAM.inp.sc_subspace_thr;
+    if (accepted)
+    {
+        this->pelec->calEBand();
+        elecstate::ElecStateLCAO<T>* pelec_lcao = dynamic_cast<elecstate::ElecStateLCAO<T>*>(this->pelec);
+        elecstate::cal_dm_psi(this->ParaV, pelec_lcao->wg, *psi_t, *(pelec_lcao->get_DM()));
+        pelec_lcao->get_DM()->cal_DMR();
+    }
+    else
+    {
+        GlobalV::ofs_running << " residual of the lambda step in the band subspace " << max_residual
+                             << " Ry > sc_subspace_thr, diagonalize in the full basis" << std::endl;
+    }
+    ModuleBase::timer::tick("spinconstrain::SpinConstrain", "update_psi_subspace_lcao");
+    return accepted;
+#else
+    return false;
+#endif
+}
+#endif
+
 template <>
 void spinconstrain::SpinConstrain<std::complex<double>>::cal_mw_from_lambda(int i_step, const ModuleBase::Vector3<double>* delta_lambda)
 {
@@ -136,9 +284,6 @@ void spinconstrain::SpinConstrain<std::complex<double>>::cal_mw_from_lambda(int
 #ifdef __LCAO
     if (PARAM.inp.basis_type == "lcao")
     {
-        psi::Psi<std::complex<double>>* psi_t = static_cast<psi::Psi<std::complex<double>>*>(this->psi);
-        hamilt::Hamilt<std::complex<double>>* hamilt_t = static_cast<hamilt::Hamilt<std::complex<double>>*>(this->p_hamilt);
-        hsolver::HSolverLCAO<std::complex<double>> hsolver_t(this->ParaV, PARAM.inp.ks_solver);
         if (PARAM.inp.nspin == 2)
         {
             dynamic_cast<hamilt::DeltaSpin<hamilt::OperatorLCAO<std::complex<double>, double>>*>(this->p_operator)
@@ -150,14 +295,12 @@ void spinconstrain::SpinConstrain<std::complex<double>>::cal_mw_from_lambda(int
                 this->p_operator)
                 ->update_lambda();
         }
-        // diagonalization without update charge
-        hsolver_t.solve(hamilt_t, psi_t[0], this->pelec, true);
-        this->pelec->calculate_weights();
-        this->pelec->calEBand();
-        elecstate::ElecStateLCAO<std::complex<double>>* pelec_lcao
-            = dynamic_cast<elecstate::ElecStateLCAO<std::complex<double>>*>(this->pelec);
-        elecstate::cal_dm_psi(this->ParaV, pelec_lcao->wg, *psi_t, *(pelec_lcao->get_DM()));
-        pelec_lcao->get_DM()->cal_DMR();
+        // the lambda steps stay in the bands of the last full diagonalization,
+        // which is redone at the start of the loop and when the subspace is no longer accurate
+        if (i_step == -1 || !this->update_psi_subspace_lcao())
+        {
+            this->update_psi_full_lcao();
+        }
         this->cal_mi_lcao(i_step);
     }
     else
@@ -364,6 +507,28 @@ void spinconstrain::SpinConstrain<std::complex<double>>::update_psi_charge(const
     if (PARAM.inp.basis_type == "lcao")
     {
         psi::Psi<std::complex<double>>* psi_t = static_cast<psi::Psi<std::complex<double>>*>(this->psi);
+        if (!this->psi_full_save.empty())
+        {
+            // lambda may have been reset after the last lambda step, which is cheap to redo in the subspace
+            if (PARAM.inp.nspin == 2)
+            {
+                dynamic_cast<hamilt::DeltaSpin<hamilt::OperatorLCAO<std::complex<double>, double>>*>(
+                    this->p_operator)
+                    ->update_lambda();
+            }
+            else if (PARAM.inp.nspin == 4)
+            {
+                dynamic_cast<hamilt::DeltaSpin<hamilt::OperatorLCAO<std::complex<double>, std::complex<double>>>*>(
+                    this->p_operator)
+                    ->update_lambda();
+            }
+            if (!this->update_psi_subspace_lcao())
+            {
+                this->update_psi_full_lcao();
+            }
+            std::vector<std::complex<double>>().swap(this->psi_full_save);
+            std::vector<std::complex<double>>().swap(this->spsi_full_save);
+        }
         this->pelec->psiToRho(*psi_t);
     }
     else
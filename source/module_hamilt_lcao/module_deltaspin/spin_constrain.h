@@ -254,6 +254,17 @@ public:
     FPTYPE* sub_h_save;
     FPTYPE* sub_s_save;
     FPTYPE* becp_save;
+
+    /// LCAO: the bands of the last full diagonalization of all k points and S times them,
+    /// which span the subspace of the following lambda steps
+    std::vector<FPTYPE> psi_full_save;
+    std::vector<FPTYPE> spsi_full_save;
+    /// LCAO: diagonalize H with the current lambda in the full basis and save the new subspace,
+    /// then update wg and DM
+    void update_psi_full_lcao();
+    /// LCAO: Rayleigh-Ritz step with the current lambda in the saved subspace, then update wg and DM;
+    /// return false and leave DM unchanged if the residual of the occupied bands exceeds sc_subspace_thr
+    bool update_psi_subspace_lcao();
 };
 
 
@@ -0,0 +1,85 @@
+#include "subspace_funcs.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "module_base/lapack_connector.h"
+#include "module_base/tool_quit.h"
+
+void spinconstrain::diag_subspace_lcao(const int nbands,
+                                       std::complex<double>* hsub,
+                                       const std::complex<double>* wsub,
+                                       double* ekb,
+                                       double* residual)
+{
+    // remove the round-off of the parallel products before the Hermitian solver
+    for (int i = 0; i < nbands; ++i)
+    {
+        for (int j = 0; j < i; ++j)
+        {
+            const std::complex<double> hij = 0.5 * (hsub[j * nbands + i] + std::conj(hsub[i * nbands + j]));
+            hsub[j * nbands + i] = hij;
+            hsub[i * nbands + j] = std::conj(hij);
+        }
+        hsub[i * nbands + i] = hsub[i * nbands + i].real();
+    }
+
+    const char jobz = 'V';
+    const char uplo = 'U';
+    int lwork = -1;
+    int info = 0;
+    std::vector<std::complex<double>> work(1);
+    std::vector<double> rwork(std::max(1, 3 * nbands - 2));
+    zheev_(&jobz, &uplo, &nbands, hsub, &nbands, ekb, work.data(), &lwork, rwork.data(), &info);
+    lwork = static_cast<int>(work[0].real());
+    work.resize(lwork);
+    zheev_(&jobz, &uplo, &nbands, hsub, &nbands, ekb, work.data(), &lwork, rwork.data(), &info);
+    if (info != 0)
+    {
+        ModuleBase::WARNING_QUIT("spinconstrain::diag_subspace_lcao", "zheev failed in the band subspace");
+    }
+
+    // residual_j^2 = v_j^dagger W v_j
+    std::vector<std::complex<double>> wv(nbands);
+    for (int ib = 0; ib < nbands; ++ib)
+    {
+        const std::complex<double>* v = hsub + ib * nbands;
+        std::fill(wv.begin(), wv.end(), std::complex<double>(0.0, 0.0));
+        for (int j = 0; j < nbands; ++j)
+        {
+            for (int i = 0; i < nbands; ++i)
+            {
+                wv[i] += wsub[j * nbands + i] * v[j];
+            }
+        }
+        double r2 = 0.0;
+        for (int i = 0; i < nbands; ++i)
+        {
+            r2 += (std::conj(v[i]) * wv[i]).real();
+        }
+        residual[ib] = std::sqrt(std::max(r2, 0.0));
+    }
+}
+
+double spinconstrain::max_occupied_residual(const ModuleBase::matrix& wg, const ModuleBase::matrix& residual)
+{
+    double max_res = 0.0;
+    for (int ik = 0; ik < wg.nr; ++ik)
+    {
+        double wg_max = 0.0;
+        for (int ib = 0; ib < wg.nc; ++ib)
+        {
+            wg_max = std::max(wg_max, std::abs(wg(ik, ib)));
+        }
+        if (wg_max == 0.0)
+        {
+            continue;
+        }
+        for (int ib = 0; ib < wg.nc; ++ib)
+        {
+            max_res = std::max(max_res, std::abs(wg(ik, ib)) / wg_max * residual(ik, ib));
+        }
+    }
+    return max_res;
+}
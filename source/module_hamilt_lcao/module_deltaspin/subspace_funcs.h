@@ -0,0 +1,34 @@
+#ifndef SUBSPACE_FUNCS_H
+#define SUBSPACE_FUNCS_H
+
+#include <complex>
+
+#include "module_base/matrix.h"
+
+namespace spinconstrain
+{
+
+/**
+ * @brief Rayleigh-Ritz step of the lambda loop in the band subspace of LCAO.
+ *
+ * C are the nbands bands of the last full diagonalization (C^dagger S C = 1), H the Hamiltonian
+ * with the current lambda, hsub = C^dagger H C and wsub = G^dagger G with G = H C - S C hsub.
+ * On return hsub holds the eigenvectors v_j of hsub, ekb the eigenvalues and residual the norm
+ * |H C v_j - ekb_j S C v_j| = sqrt(v_j^dagger wsub v_j) of each rotated band.
+ * All the matrices are nbands*nbands and column-major.
+ */
+void diag_subspace_lcao(const int nbands,
+                        std::complex<double>* hsub,
+                        const std::complex<double>* wsub,
+                        double* ekb,
+                        double* residual);
+
+/**
+ * @brief the largest residual of the occupied bands, weighted by the occupation
+ * wg(ik, ib) / max_ib wg(ik, ib) of each k point, so that empty buffer bands do not count
+ */
+double max_occupied_residual(const ModuleBase::matrix& wg, const ModuleBase::matrix& residual);
+
+} // namespace spinconstrain
+
+#endif // SUBSPACE_FUNCS_H
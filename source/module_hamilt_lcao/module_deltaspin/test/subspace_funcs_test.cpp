@@ -0,0 +1,214 @@
+#include "../subspace_funcs.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "module_base/lapack_connector.h"
+
+#include <random>
+#include <vector>
+
+/************************************************
+ *  unit test of subspace_funcs
+ ***********************************************/
+
+/**
+ * - Tested Functions:
+ *  - diag_subspace_lcao(): Rayleigh-Ritz step in the band subspace and the residual of each rotated band
+ *  - max_occupied_residual(): the largest residual weighted by the relative occupation
+ */
+
+class SubspaceFuncsTest : public testing::Test
+{
+  protected:
+    using T = std::complex<double>;
+    const int nbasis = 12;
+    const int nbands = 5;
+    std::vector<T> h0;
+    std::vector<T> c0;
+    std::vector<double> e0;
+
+    void SetUp()
+    {
+        h0 = random_hermitian(1);
+        // C: the nbands lowest eigenvectors of H0, S = 1
+        std::vector<T> v = h0;
+        std::vector<double> e(nbasis);
+        eigh(nbasis, v, e);
+        c0.assign(v.begin(), v.begin() + nbasis * nbands);
+        e0.assign(e.begin(), e.begin() + nbands);
+    }
+
+    std::vector<T> random_hermitian(const int seed)
+    {
+        std::mt19937 gen(seed);
+        std::uniform_real_distribution<double> dis(-1.0, 1.0);
+        std::vector<T> h(nbasis * nbasis);
+        for (int j = 0; j < nbasis; ++j)
+        {
+            for (int i = 0; i <= j; ++i)
+            {
+                h[j * nbasis + i] = (i == j) ? T(dis(gen) + i, 0.0) : T(dis(gen), dis(gen));
+                h[i * nbasis + j] = std::conj(h[j * nbasis + i]);
+            }
+        }
+        return h;
+    }
+
+    void eigh(const int n, std::vector<T>& a, std::vector<double>& e)
+    {
+        const char jobz = 'V';
+        const char uplo = 'U';
+        int lwork = 4 * n;
+        int info = 0;
+        std::vector<T> work(lwork);
+        std::vector<double> rwork(3 * n);
+        zheev_(&jobz, &uplo, &n, a.data(), &n, e.data(), work.data(), &lwork, rwork.data(), &info);
+        ASSERT_EQ(info, 0);
+    }
+
+    // c(m, n) = op(a)(m, k) * b(k, n), column-major
+    std::vector<T> matmul(const char transa, const std::vector<T>& a, const std::vector<T>& b, int m, int n, int k)
+    {
+        std::vector<T> c(m * n, 0.0);
+        for (int j = 0; j < n; ++j)
+        {
+            for (int l = 0; l < k; ++l)
+            {
+                for (int i = 0; i < m; ++i)
+                {
+                    c[j * m + i] += (transa == 'C' ? std::conj(a[i * k + l]) : a[l * m + i]) * b[j * k + l];
+                }
+            }
+        }
+        return c;
+    }
+
+    // hsub and wsub of H in the subspace of c0
+    void subspace(const std::vector<T>& h, std::vector<T>& hsub, std::vector<T>& wsub)
+    {
+        const std::vector<T> hc = matmul('N', h, c0, nbasis, nbands, nbasis);
+        hsub = matmul('C', c0, hc, nbands, nbands, nbasis);
+        std::vector<T> g = matmul('N', c0, hsub, nbasis, nbands, nbands);
+        for (int i = 0; i < g.size(); ++i)
+        {
+            g[i] = hc[i] - g[i];
+        }
+        wsub = matmul('C', g, g, nbands, nbands, nbasis);
+    }
+};
+
+TEST_F(SubspaceFuncsTest, DiagSubspaceUnperturbed)
+{
+    std::vector<T> hsub, wsub;
+    subspace(h0, hsub, wsub);
+    std::vector<double> ekb(nbands), residual(nbands);
+    spinconstrain::diag_subspace_lcao(nbands, hsub.data(), wsub.data(), ekb.data(), residual.data());
+    for (int ib = 0; ib < nbands; ++ib)
+    {
+        EXPECT_NEAR(ekb[ib], e0[ib], 1e-10);
+        EXPECT_NEAR(residual[ib], 0.0, 1e-6);
+    }
+}
+
+TEST_F(SubspaceFuncsTest, DiagSubspaceInsidePerturbation)
+{
+    // dV = C X C^dagger does not couple the subspace to the rest
+    std::vector<T> x(nbands * nbands, 0.0);
+    for (int ib = 0; ib < nbands; ++ib)
+    {
+        x[ib * nbands + ib] = 0.1 * ib;
+        if (ib > 0)
+        {
+            x[ib * nbands + ib - 1] = T(0.05, 0.02);
+            x[(ib - 1) * nbands + ib] = T(0.05, -0.02);
+        }
+    }
+    std::vector<T> cx = matmul('N', c0, x, nbasis, nbands, nbands);
+    std::vector<T> c0_h(nbands * nbasis);
+    for (int i = 0; i < nbasis; ++i)
+    {
+        for (int ib = 0; ib < nbands; ++ib)
+        {
+            c0_h[i * nbands + ib] = std::conj(c0[ib * nbasis + i]);
+        }
+    }
+    std::vector<T> dv = matmul('N', cx, c0_h, nbasis, nbasis, nbands);
+    std::vector<T> h1 = h0;
+    for (int i = 0; i < h1.size(); ++i)
+    {
+        h1[i] += dv[i];
+    }
+
+    std::vector<T> hsub, wsub;
+    subspace(h1, hsub, wsub);
+    std::vector<double> ekb(nbands), residual(nbands);
+    spinconstrain::diag_subspace_lcao(nbands, hsub.data(), wsub.data(), ekb.data(), residual.data());
+
+    // eigenvalues of diag(e0) + X
+    std::vector<T> ref = x;
+    for (int ib = 0; ib < nbands; ++ib)
+    {
+        ref[ib * nbands + ib] += e0[ib];
+    }
+    std::vector<double> eref(nbands);
+    eigh(nbands, ref, eref);
+    for (int ib = 0; ib < nbands; ++ib)
+    {
+        EXPECT_NEAR(ekb[ib], eref[ib], 1e-10);
+        EXPECT_NEAR(residual[ib], 0.0, 1e-6);
+    }
+}
+
+TEST_F(SubspaceFuncsTest, DiagSubspaceResidual)
+{
+    std::vector<T> h1 = h0;
+    std::vector<T> dv = random_hermitian(2);
+    for (int i = 0; i < h1.size(); ++i)
+    {
+        h1[i] += 0.05 * dv[i];
+    }
+    std::vector<T> hsub, wsub;
+    subspace(h1, hsub, wsub);
+    std::vector<double> ekb(nbands), residual(nbands);
+    spinconstrain::diag_subspace_lcao(nbands, hsub.data(), wsub.data(), ekb.data(), residual.data());
+
+    // residual of the rotated bands psi = C V computed directly
+    const std::vector<T> psi = matmul('N', c0, hsub, nbasis, nbands, nbands);
+    const std::vector<T> hpsi = matmul('N', h1, psi, nbasis, nbands, nbasis);
+    std::vector<T> full = h1;
+    std::vector<double> efull(nbasis);
+    eigh(nbasis, full, efull);
+    for (int ib = 0; ib < nbands; ++ib)
+    {
+        double r2 = 0.0;
+        for (int i = 0; i < nbasis; ++i)
+        {
+            r2 += std::norm(hpsi[ib * nbasis + i] - ekb[ib] * psi[ib * nbasis + i]);
+        }
+        EXPECT_NEAR(residual[ib], std::sqrt(r2), 1e-10);
+        EXPECT_GT(residual[ib], 1e-4);
+        // Rayleigh-Ritz values are upper bounds of the exact ones
+        EXPECT_GE(ekb[ib], efull[ib] - 1e-12);
+    }
+}
+
+TEST_F(SubspaceFuncsTest, MaxOccupiedResidual)
+{
+    ModuleBase::matrix wg(2, 3);
+    ModuleBase::matrix residual(2, 3);
+    // k point 0: the empty band has the largest residual
+    wg(0, 0) = 0.5;
+    wg(0, 1) = 0.5;
+    wg(0, 2) = 0.0;
+    residual(0, 0) = 1e-5;
+    residual(0, 1) = 2e-5;
+    residual(0, 2) = 1.0;
+    // k point 1: half-occupied band
+    wg(1, 0) = 0.25;
+    wg(1, 1) = 0.125;
+    wg(1, 2) = 0.0;
+    residual(1, 0) = 1e-6;
+    residual(1, 1) = 1e-4;
+    residual(1, 2) = 1.0;
+    EXPECT_DOUBLE_EQ(spinconstrain::max_occupied_residual(wg, residual), 0.5e-4);
+}
@@ -199,6 +199,8 @@ private:
     //=============================================================
     // In dftu_force.cpp
     // For calculating force and stress fomr DFT+U
+    // the force and stress use the dense products of DM(k) and VU on the 2D-block matrices
+    // and the folded dS; only the occupations are computed from S(R) and DM(R) in cal_occup_m_R()
     //=============================================================
  public:
    void force_stress(const UnitCell& ucell,
@@ -300,6 +302,12 @@ private:
     void set_dmr(const elecstate::DensityMatrix<std::complex<double>, double>* dm_in_dftu_cd);
   
   private:
+    /**
+     * @brief local occupation number matrix from the correlated rows of S(R) and DM(R),
+     * used by cal_occup_m_k and cal_occup_m_gamma in place of the S(k) DM(k) products once the DM is set
+     */
+    void cal_occup_m_R(const UnitCell& ucell, const hamilt::HContainer<double>* sR, const double& mixing_beta);
+
     const UnitCell* ucell = nullptr;
     const elecstate::DensityMatrix<double, double>* dm_in_dftu_d = nullptr;
     const elecstate::DensityMatrix<std::complex<double>, double>* dm_in_dftu_cd = nullptr;
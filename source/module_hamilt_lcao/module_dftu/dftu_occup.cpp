@@ -1,4 +1,6 @@
 #include "dftu.h"
+#include "module_base/parallel_reduce.h"
+#include "module_base/tool_quit.h"
 #include "module_base/timer.h"
 #include "module_parameter/parameter.h"
 #include "module_hamilt_pw/hamilt_pwdft/global.h"
@@ -6,6 +8,10 @@
 #include "module_hamilt_lcao/hamilt_lcaodft/hamilt_lcao.h"
 #endif
 
+#include <algorithm>
+#include <array>
+#include <map>
+
 extern "C"
 {
   //I'm not sure what's happenig here, but the interface in scalapack_connecter.h
@@ -154,6 +160,14 @@ void DFTU::cal_occup_m_k(const int iter,
                          hamilt::Hamilt<std::complex<double>>* p_ham)
 {
     ModuleBase::TITLE("DFTU", "cal_occup_m_k");
+    // DM(R) is not separated into the spin components for nspin = 4
+    if (PARAM.inp.nspin != 4 && this->get_dmr(0) != nullptr)
+    {
+        this->cal_occup_m_R(ucell,
+                            dynamic_cast<hamilt::HamiltLCAO<std::complex<double>, double>*>(p_ham)->getSR(),
+                            mixing_beta);
+        return;
+    }
     ModuleBase::timer::tick("DFTU", "cal_occup_m_k");
 
     this->copy_locale(ucell);
@@ -376,6 +390,11 @@ void DFTU::cal_occup_m_gamma(const int iter,
                              hamilt::Hamilt<double>* p_ham)
 {
     ModuleBase::TITLE("DFTU", "cal_occup_m_gamma");
+    if (this->get_dmr(0) != nullptr)
+    {
+        this->cal_occup_m_R(ucell, dynamic_cast<hamilt::HamiltLCAO<double, double>*>(p_ham)->getSR(), mixing_beta);
+        return;
+    }
     ModuleBase::timer::tick("DFTU", "cal_occup_m_gamma");
     this->copy_locale(ucell);
     this->zero_locale(ucell);
@@ -523,5 +542,219 @@ void DFTU::cal_occup_m_gamma(const int iter,
     ModuleBase::timer::tick("DFTU", "cal_occup_m_gamma");
     return;
 }
+
+void DFTU::cal_occup_m_R(const UnitCell& ucell, const hamilt::HContainer<double>* sR, const double& mixing_beta)
+{
+    ModuleBase::TITLE("DFTU", "cal_occup_m_R");
+    ModuleBase::timer::tick("DFTU", "cal_occup_m_R");
+
+    this->copy_locale(ucell);
+    this->zero_locale(ucell);
+
+    const int nspin = PARAM.inp.nspin;
+    const int* iat2iwt = ucell.get_iat2iwt();
+
+    // the correlated shell (n = 0, l = orbital_corr) of each DFT+U atom, in the orbital indexes of the atom
+    std::vector<std::vector<int>> shell(ucell.nat);
+    for (int it = 0; it < ucell.ntype; it++)
+    {
+        const int l = orbital_corr[it];
+        if (l == -1)
+        {
+            continue;
+        }
+        for (int ia = 0; ia < ucell.atoms[it].na; ia++)
+        {
+            const int iat = ucell.itia2iat(it, ia);
+            for (int m = 0; m < 2 * l + 1; m++)
+            {
+                shell[iat].push_back(this->iatlnmipol2iwt[iat][l][0][m][0] - iat2iwt[iat]);
+            }
+        }
+    }
+
+    //=================Part 1======================
+    // the (I, J, R) blocks with a DFT+U atom I held by this process
+    std::vector<int> keys_local;
+    for (int iap = 0; iap < sR->size_atom_pairs(); iap++)
+    {
+        const hamilt::AtomPair<double>& ap = sR->get_atom_pair(iap);
+        if (shell[ap.get_atom_i()].empty())
+        {
+            continue;
+        }
+        for (int ir = 0; ir < ap.get_R_size(); ir++)
+        {
+            const ModuleBase::Vector3<int> R = ap.get_R_index(ir);
+            keys_local.insert(keys_local.end(), {ap.get_atom_i(), ap.get_atom_j(), R.x, R.y, R.z});
+        }
+    }
+    std::vector<int> keys_all = keys_local;
+#ifdef __MPI
+    int nproc = 1;
+    MPI_Comm_size(MPI_COMM_WORLD, &nproc);
+    const int nkey_local = keys_local.size();
+    std::vector<int> nkey(nproc);
+    std::vector<int> displ(nproc, 0);
+    MPI_Allgather(&nkey_local, 1, MPI_INT, nkey.data(), 1, MPI_INT, MPI_COMM_WORLD);
+    for (int ip = 1; ip < nproc; ip++)
+    {
+        displ[ip] = displ[ip - 1] + nkey[ip - 1];
+    }
+    keys_all.resize(displ[nproc - 1] + nkey[nproc - 1]);
+    MPI_Allgatherv(keys_local.data(),
+                   nkey_local,
+                   MPI_INT,
+                   keys_all.data(),
+                   nkey.data(),
+                   displ.data(),
+                   MPI_INT,
+                   MPI_COMM_WORLD);
+#endif
+
+    // every block keeps the rows of the correlated shell of I with all the orbitals of J,
+    // the overlap first and then the density matrix of each spin
+    std::map<std::array<int, 5>, int> offset;
+    for (int ik = 0; ik < keys_all.size(); ik += 5)
+    {
+        offset.insert({{keys_all[ik], keys_all[ik + 1], keys_all[ik + 2], keys_all[ik + 3], keys_all[ik + 4]}, 0});
+    }
+    int size = 0;
+    for (auto& key: offset)
+    {
+        key.second = size;
+        const int iat = key.first[0];
+        const int jat = key.first[1];
+        size += shell[iat].size() * ucell.atoms[ucell.iat2it[jat]].nw * (1 + nspin);
+    }
+    std::vector<double> rows(size, 0.0);
+
+    //=================Part 2======================
+    // copy the local elements of the shell rows of S(R) and DM(R)
+    for (int iap = 0; iap < sR->size_atom_pairs(); iap++)
+    {
+        const hamilt::AtomPair<double>& ap = sR->get_atom_pair(iap);
+        const int iat = ap.get_atom_i();
+        const int jat = ap.get_atom_j();
+        if (shell[iat].empty())
+        {
+            continue;
+        }
+        const int nw_j = ucell.atoms[ucell.iat2it[jat]].nw;
+        const int ncol = ap.get_col_size();
+        const std::vector<int> irow = this->paraV->get_indexes_row(iat);
+        const std::vector<int> icol = this->paraV->get_indexes_col(jat);
+        // local row of each orbital of the shell, -1 if it is on another process
+        std::vector<int> row_local(shell[iat].size(), -1);
+        for (int m = 0; m < shell[iat].size(); m++)
+        {
+            const auto pos = std::find(irow.begin(), irow.end(), shell[iat][m]);
+            if (pos != irow.end())
+            {
+                row_local[m] = pos - irow.begin();
+            }
+        }
+        for (int ir = 0; ir < ap.get_R_size(); ir++)
+        {
+            const ModuleBase::Vector3<int> R = ap.get_R_index(ir);
+            const int off = offset.at({iat, jat, R.x, R.y, R.z});
+            const int block = shell[iat].size() * nw_j;
+            std::vector<const double*> mat(1 + nspin, nullptr);
+            mat[0] = ap.get_pointer(ir);
+            for (int is = 0; is < nspin; is++)
+            {
+                const hamilt::BaseMatrix<double>* dm = this->get_dmr(is)->find_matrix(iat, jat, R.x, R.y, R.z);
+                mat[1 + is] = (dm == nullptr) ? nullptr : dm->get_pointer();
+            }
+            for (int im = 0; im < mat.size(); im++)
+            {
+                if (mat[im] == nullptr)
+                {
+                    continue;
+                }
+                for (int m = 0; m < shell[iat].size(); m++)
+                {
+                    if (row_local[m] < 0)
+                    {
+                        continue;
+                    }
+                    double* row = &rows[off + im * block + m * nw_j];
+                    for (int c = 0; c < ncol; c++)
+                    {
+                        row[icol[c]] = mat[im][row_local[m] * ncol + c];
+                    }
+                }
+            }
+        }
+    }
+#ifdef __MPI
+    Parallel_Reduce::reduce_all(rows.data(), size);
+#endif
+
+    //=================Part 3======================
+    // locale(m0, m1) = 1/4 \sum_{J,R,lambda} S_{m0,lambda}(R) DM_{m1,lambda}(R) + S_{m1,lambda}(R) DM_{m0,lambda}(R),
+    // the same as 1/4 \sum_k S(k) DM(k)^T + (S(k) DM(k)^T)^T in cal_occup_m_k, without a product of dense matrices
+    for (const auto& key: offset)
+    {
+        const int iat = key.first[0];
+        const int it = ucell.iat2it[iat];
+        const int l = orbital_corr[it];
+        const int nm = 2 * l + 1;
+        const int nw_j = ucell.atoms[ucell.iat2it[key.first[1]]].nw;
+        const int block = nm * nw_j;
+        const double* s = &rows[key.second];
+        for (int is = 0; is < nspin; is++)
+        {
+            const double* dm = &rows[key.second + (1 + is) * block];
+            for (int m0 = 0; m0 < nm; m0++)
+            {
+                for (int m1 = 0; m1 < nm; m1++)
+                {
+                    double sum = 0.0;
+                    for (int iw = 0; iw < nw_j; iw++)
+                    {
+                        sum += s[m0 * nw_j + iw] * dm[m1 * nw_j + iw] + s[m1 * nw_j + iw] * dm[m0 * nw_j + iw];
+                    }
+                    locale[iat][l][0][is](m0, m1) += sum / 4.0;
+                }
+            }
+        }
+    }
+
+    for (int iat = 0; iat < ucell.nat; iat++)
+    {
+        if (shell[iat].empty())
+        {
+            continue;
+        }
+        const int l = orbital_corr[ucell.iat2it[iat]];
+        // for the case spin independent calculation
+        switch (nspin)
+        {
+        case 1:
+            locale[iat][l][0][0] += transpose(locale[iat][l][0][0]);
+            locale[iat][l][0][0] *= 0.5;
+            locale[iat][l][0][1] += locale[iat][l][0][0];
+            break;
+
+        case 2:
+            for (int is = 0; is < nspin; is++)
+                locale[iat][l][0][is] += transpose(locale[iat][l][0][is]);
+            break;
+
+        default:
+            ModuleBase::WARNING_QUIT("DFTU::cal_occup_m_R", "Not supported NSPIN parameter");
+        }
+    }
+
+    if(mixing_dftu && initialed_locale)
+    {
+        this->mix_locale(ucell,mixing_beta);
+    }
+
+    this->initialed_locale = true;
+    ModuleBase::timer::tick("DFTU", "cal_occup_m_R");
+    return;
+}
 #endif
 } // namespace ModuleDFTU
\ No newline at end of file
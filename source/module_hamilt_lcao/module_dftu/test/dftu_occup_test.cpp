@@ -0,0 +1,389 @@
+#include "gtest/gtest.h"
+
+#include <cmath>
+#include <complex>
+#include <memory>
+#include <vector>
+
+#define private public
+#include "module_parameter/parameter.h"
+#include "../dftu.h"
+#include "module_hamilt_lcao/hamilt_lcaodft/hamilt_lcao.h"
+#undef private
+#include "module_base/constants.h"
+#include "module_base/global_function.h"
+#include "module_hamilt_lcao/module_hcontainer/hcontainer_funcs.h"
+
+/************************************************
+ *  unit test of dftu_occup.cpp
+ ***********************************************/
+
+/**
+ * - Tested Functions:
+ *   - DFTU::cal_occup_m_R(): the occupation matrices from the shell rows of S(R) and DM(R)
+ *     are the same as the ones of the S(k) DM(k) products of cal_occup_m_k() and cal_occup_m_gamma()
+ *     - nspin 1 and 2, multi-k and gamma-only
+ *     - 2D-block distribution with nb = 2, the rows of a shell are split among the processes
+ */
+
+// mock of DFTU
+ModuleDFTU::DFTU::DFTU()
+{
+}
+ModuleDFTU::DFTU::~DFTU()
+{
+}
+// DM(R) of each spin, cal_occup_m_R() is used if it is set
+std::vector<const hamilt::HContainer<double>*> tmp_DMR(2, nullptr);
+const hamilt::HContainer<double>* ModuleDFTU::DFTU::get_dmr(int ispin) const
+{
+    return tmp_DMR[ispin];
+}
+void ModuleDFTU::DFTU::folding_matrix_k_new(const int ik, hamilt::Hamilt<std::complex<double>>* p_ham)
+{
+    dynamic_cast<hamilt::HamiltLCAO<std::complex<double>, double>*>(p_ham)->updateSk(ik, 1);
+}
+
+// the members of HamiltLCAO used by DFTU, S(R) is set by the test
+namespace hamilt
+{
+template <typename TK, typename TR>
+HamiltLCAO<TK, TR>::HamiltLCAO(const UnitCell& ucell,
+                               const Grid_Driver& grid_d,
+                               const Parallel_Orbitals* paraV,
+                               const K_Vectors& kv_in,
+                               const TwoCenterIntegrator& intor_overlap_orb,
+                               const std::vector<double>& orb_cutoff)
+{
+    this->kv = &kv_in;
+    this->hsk = new HS_Matrix_K<TK>(paraV);
+    this->hR = new HContainer<TR>(paraV);
+    this->sR = new HContainer<TR>(paraV);
+}
+template <typename TK, typename TR>
+void HamiltLCAO<TK, TR>::refresh()
+{
+}
+template <typename TK, typename TR>
+void HamiltLCAO<TK, TR>::updateHk(const int ik)
+{
+}
+template <typename TK, typename TR>
+void HamiltLCAO<TK, TR>::matrix(MatrixBlock<TK>& hk_in, MatrixBlock<TK>& sk_in)
+{
+}
+template <typename TK, typename TR>
+void HamiltLCAO<TK, TR>::updateSk(const int ik, const int hk_type)
+{
+    ModuleBase::GlobalFunc::ZEROS(this->getSk(), this->get_size_hsk());
+    folding_HR(*this->sR, this->getSk(), this->kv->kvec_d[ik], this->hsk->get_pv()->get_row_size(), 1);
+}
+} // namespace hamilt
+
+K_Vectors::K_Vectors()
+{
+}
+K_Vectors::~K_Vectors()
+{
+}
+Grid::~Grid()
+{
+}
+Grid_Driver::~Grid_Driver()
+{
+}
+TwoCenterIntegrator::TwoCenterIntegrator()
+{
+}
+
+namespace
+{
+// one type of two atoms with s, p and d orbitals, U on the d shell
+const int nat = 2;
+const int nw = 9;
+const int nlocal = nat * nw;
+const int nk = 3;
+
+double s_value(const int rx, const int i, const int j)
+{
+    return 0.1 * std::cos(0.3 * i + 0.7 * j + 1.1 * rx) + ((i == j && rx == 0) ? 1.0 : 0.0);
+}
+
+std::complex<double> dmk_value(const int ik, const int i, const int j)
+{
+    return 0.1 * std::complex<double>(std::sin(0.5 * i + 0.2 * j + 0.9 * ik), std::cos(0.4 * i - 0.3 * j + 0.6 * ik));
+}
+} // namespace
+
+class DFTUOccupTest : public testing::TestWithParam<int>
+{
+  protected:
+    void SetUp() override
+    {
+        nspin = GetParam();
+        PARAM.input.nspin = nspin;
+        PARAM.input.ks_solver = "scalapack_gvx";
+        PARAM.sys.npol = 1;
+        PARAM.sys.nlocal = nlocal;
+
+        ucell.ntype = 1;
+        ucell.nat = nat;
+        ucell.atoms = new Atom[1];
+        ucell.iat2it = new int[nat];
+        ucell.iat2ia = new int[nat];
+        ucell.itia2iat.create(1, nat);
+        for (int iat = 0; iat < nat; iat++)
+        {
+            ucell.iat2it[iat] = 0;
+            ucell.iat2ia[iat] = iat;
+            ucell.itia2iat(0, iat) = iat;
+        }
+        Atom& atom = ucell.atoms[0];
+        atom.na = nat;
+        atom.nw = nw;
+        atom.nwl = 2;
+        atom.l_nchi = {1, 1, 1};
+        atom.iw2l = {0, 1, 1, 1, 2, 2, 2, 2, 2};
+        atom.iw2m = {0, 0, 1, 2, 0, 1, 2, 3, 4};
+        atom.iw2n.assign(nw, 0);
+        ucell.set_iat2iwt(1);
+
+        paraV = new Parallel_Orbitals();
+        paraV->init(nlocal, nlocal, 2, MPI_COMM_WORLD);
+        paraV->set_atomic_trace(ucell.get_iat2iwt(), nat, nlocal);
+
+        // the same as DFTU::init()
+        dftu.paraV = paraV;
+        dftu.orbital_corr = {2};
+        dftu.mixing_dftu = 0;
+        dftu.locale.resize(nat);
+        dftu.locale_save.resize(nat);
+        dftu.iatlnmipol2iwt.resize(nat);
+        for (int iat = 0; iat < nat; iat++)
+        {
+            dftu.locale[iat].resize(atom.nwl + 1);
+            dftu.locale_save[iat].resize(atom.nwl + 1);
+            dftu.iatlnmipol2iwt[iat].resize(atom.nwl + 1);
+            for (int l = 0; l <= atom.nwl; l++)
+            {
+                dftu.locale[iat][l].resize(1);
+                dftu.locale_save[iat][l].resize(1);
+                dftu.locale[iat][l][0].resize(2);
+                dftu.locale_save[iat][l][0].resize(2);
+                for (int is = 0; is < 2; is++)
+                {
+                    dftu.locale[iat][l][0][is].create(2 * l + 1, 2 * l + 1);
+                    dftu.locale_save[iat][l][0][is].create(2 * l + 1, 2 * l + 1);
+                }
+                dftu.iatlnmipol2iwt[iat][l].resize(1);
+                dftu.iatlnmipol2iwt[iat][l][0].resize(2 * l + 1, std::vector<int>(1));
+            }
+            for (int iw = 0; iw < nw; iw++)
+            {
+                dftu.iatlnmipol2iwt[iat][atom.iw2l[iw]][0][atom.iw2m[iw]][0] = ucell.get_iat2iwt()[iat] + iw;
+            }
+        }
+    }
+
+    void TearDown() override
+    {
+        tmp_DMR.assign(2, nullptr);
+        delete paraV;
+        delete[] ucell.atoms;
+    }
+
+    // an empty container with the pairs of all the atoms in the cells R = (rx, 0, 0), |rx| <= rmax
+    std::unique_ptr<hamilt::HContainer<double>> make_container(const int rmax) const
+    {
+        std::unique_ptr<hamilt::HContainer<double>> hc(new hamilt::HContainer<double>(paraV));
+        for (int iat = 0; iat < nat; iat++)
+        {
+            for (int jat = 0; jat < nat; jat++)
+            {
+                if (paraV->get_row_size(iat) <= 0 || paraV->get_col_size(jat) <= 0)
+                {
+                    continue;
+                }
+                for (int rx = -rmax; rx <= rmax; rx++)
+                {
+                    hc->insert_pair(hamilt::AtomPair<double>(iat, jat, rx, 0, 0, paraV));
+                }
+            }
+        }
+        hc->allocate(nullptr, true);
+        return hc;
+    }
+
+    // set the local elements of hc to f(rx, global row, global column)
+    template <typename F>
+    void fill(hamilt::HContainer<double>* hc, F f) const
+    {
+        for (int iap = 0; iap < hc->size_atom_pairs(); iap++)
+        {
+            hamilt::AtomPair<double>& ap = hc->get_atom_pair(iap);
+            const int row0 = ucell.get_iat2iwt()[ap.get_atom_i()];
+            const int col0 = ucell.get_iat2iwt()[ap.get_atom_j()];
+            const std::vector<int> irow = paraV->get_indexes_row(ap.get_atom_i());
+            const std::vector<int> icol = paraV->get_indexes_col(ap.get_atom_j());
+            for (int ir = 0; ir < ap.get_R_size(); ir++)
+            {
+                const int rx = ap.get_R_index(ir).x;
+                double* p = ap.get_pointer(ir);
+                for (int r = 0; r < irow.size(); r++)
+                {
+                    for (int c = 0; c < icol.size(); c++)
+                    {
+                        p[r * icol.size() + c] = f(rx, row0 + irow[r], col0 + icol[c]);
+                    }
+                }
+            }
+        }
+    }
+
+    // the local column-major block of the global matrix f(global row, global column)
+    template <typename T, typename F>
+    std::vector<T> local_matrix(F f) const
+    {
+        std::vector<T> m(paraV->nloc, T(0.0));
+        for (int i = 0; i < nlocal; i++)
+        {
+            for (int j = 0; j < nlocal; j++)
+            {
+                const int mu = paraV->global2local_row(i);
+                const int nu = paraV->global2local_col(j);
+                if (mu >= 0 && nu >= 0)
+                {
+                    m[nu * paraV->nrow + mu] = f(i, j);
+                }
+            }
+        }
+        return m;
+    }
+
+    std::vector<ModuleBase::matrix> occupations() const
+    {
+        std::vector<ModuleBase::matrix> occ;
+        for (int iat = 0; iat < nat; iat++)
+        {
+            for (int is = 0; is < 2; is++)
+            {
+                occ.push_back(dftu.locale[iat][2][0][is]);
+            }
+        }
+        return occ;
+    }
+
+    void compare(const std::vector<ModuleBase::matrix>& ref, const std::vector<ModuleBase::matrix>& occ) const
+    {
+        ASSERT_EQ(ref.size(), occ.size());
+        double norm = 0.0;
+        for (int i = 0; i < ref.size(); i++)
+        {
+            for (int j = 0; j < ref[i].nr * ref[i].nc; j++)
+            {
+                EXPECT_NEAR(occ[i].c[j], ref[i].c[j], 1e-12);
+                norm += std::abs(ref[i].c[j]);
+            }
+        }
+        EXPECT_GT(norm, 0.1);
+    }
+
+    int nspin = 1;
+    UnitCell ucell;
+    Parallel_Orbitals* paraV = nullptr;
+    ModuleDFTU::DFTU dftu;
+    Grid_Driver gd;
+    TwoCenterIntegrator intor;
+};
+
+TEST_P(DFTUOccupTest, MultiK)
+{
+    PARAM.sys.gamma_only_local = false;
+    K_Vectors kv;
+    kv.nks = nk * nspin;
+    for (int ik = 0; ik < kv.nks; ik++)
+    {
+        kv.kvec_d.push_back(ModuleBase::Vector3<double>((ik % nk - 1) / 3.0, 0.0, 0.0));
+        kv.isk.push_back(ik / nk);
+    }
+
+    hamilt::HamiltLCAO<std::complex<double>, double> ham(ucell, gd, paraV, kv, intor, {});
+    delete ham.getSR();
+    ham.getSR() = this->make_container(1).release();
+    this->fill(ham.getSR(), s_value);
+
+    // DM(R) = \sum_k Re[DM(k) e^{ikR}] as DensityMatrix::cal_DMR()
+    std::vector<std::vector<std::complex<double>>> dm_k(kv.nks);
+    std::vector<std::unique_ptr<hamilt::HContainer<double>>> dm_r(nspin);
+    for (int ik = 0; ik < kv.nks; ik++)
+    {
+        dm_k[ik] = this->local_matrix<std::complex<double>>([ik](int i, int j) { return dmk_value(ik, i, j); });
+    }
+    for (int is = 0; is < nspin; is++)
+    {
+        dm_r[is] = this->make_container(1);
+        this->fill(dm_r[is].get(), [&kv, is](int rx, int i, int j) {
+            double sum = 0.0;
+            for (int ik = is * nk; ik < (is + 1) * nk; ik++)
+            {
+                const double arg = ModuleBase::TWO_PI * kv.kvec_d[ik].x * rx;
+                sum += (dmk_value(ik, i, j) * std::complex<double>(std::cos(arg), std::sin(arg))).real();
+            }
+            return sum;
+        });
+    }
+
+    dftu.cal_occup_m_k(1, ucell, dm_k, kv, 0.0, &ham);
+    const std::vector<ModuleBase::matrix> ref = this->occupations();
+    for (int is = 0; is < nspin; is++)
+    {
+        tmp_DMR[is] = dm_r[is].get();
+    }
+    dftu.cal_occup_m_k(1, ucell, dm_k, kv, 0.0, &ham);
+    this->compare(ref, this->occupations());
+}
+
+TEST_P(DFTUOccupTest, Gamma)
+{
+    PARAM.sys.gamma_only_local = true;
+    K_Vectors kv;
+    kv.nks = nspin;
+    kv.kvec_d.assign(nspin, ModuleBase::Vector3<double>(0.0, 0.0, 0.0));
+    kv.isk = {0, 1};
+
+    hamilt::HamiltLCAO<double, double> ham(ucell, gd, paraV, kv, intor, {});
+    delete ham.getSR();
+    ham.getSR() = this->make_container(0).release();
+    this->fill(ham.getSR(), s_value);
+    // S(k) is made by HamiltLCAO::updateSk() before the occupations of gamma-only calculations
+    ham.updateSk(0, 1);
+
+    std::vector<std::vector<double>> dm_gamma(nspin);
+    std::vector<std::unique_ptr<hamilt::HContainer<double>>> dm_r(nspin);
+    for (int is = 0; is < nspin; is++)
+    {
+        dm_gamma[is] = this->local_matrix<double>([is](int i, int j) { return dmk_value(is, i, j).real(); });
+        dm_r[is] = this->make_container(0);
+        this->fill(dm_r[is].get(), [is](int rx, int i, int j) { return dmk_value(is, i, j).real(); });
+    }
+
+    dftu.cal_occup_m_gamma(1, ucell, dm_gamma, 0.0, &ham);
+    const std::vector<ModuleBase::matrix> ref = this->occupations();
+    for (int is = 0; is < nspin; is++)
+    {
+        tmp_DMR[is] = dm_r[is].get();
+    }
+    dftu.cal_occup_m_gamma(1, ucell, dm_gamma, 0.0, &ham);
+    this->compare(ref, this->occupations());
+}
+
+INSTANTIATE_TEST_SUITE_P(Nspin, DFTUOccupTest, testing::Values(1, 2));
+
+int main(int argc, char** argv)
+{
+    MPI_Init(&argc, &argv);
+    testing::InitGoogleTest(&argc, argv);
+    int result = RUN_ALL_TESTS();
+    MPI_Finalize();
+    return result;
+}
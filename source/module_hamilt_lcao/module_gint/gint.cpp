@@ -46,6 +46,40 @@ void Gint::cal_gint(Gint_inout* inout) {
         ModuleBase::WARNING_QUIT("Gint_interface::cal_gint",
                                  "gridt has not been allocated yet!");
     }
+    // with gint_balance, the kernels work on the big cells of this
+    // processor in the Gint layout: move vl and vofk there, and
+    // collect rho and tau in it. The communication must be done by
+    // all processors, including those without atoms.
+    Gint_inout* inout_fft = inout;
+    Gint_inout inout_gint = *inout;
+    std::vector<double> vl_gint;
+    std::vector<double> vofk_gint;
+    std::vector<std::vector<double>> rho_gint;
+    std::vector<double*> rho_gint_ptr;
+    const bool is_rho = inout->job == Gint_Tools::job_type::rho
+                        || inout->job == Gint_Tools::job_type::tau;
+    if (this->gridt->balanced) {
+        const int ngint = this->nbxx * this->bxyz;
+        if (inout->vl != nullptr && !is_rho) {
+            vl_gint.resize(ngint);
+            this->gridt->fft_to_gint(inout->vl, vl_gint.data());
+            inout_gint.vl = vl_gint.data();
+        }
+        if (inout->vofk != nullptr && !is_rho) {
+            vofk_gint.resize(ngint);
+            this->gridt->fft_to_gint(inout->vofk, vofk_gint.data());
+            inout_gint.vofk = vofk_gint.data();
+        }
+        if (is_rho) {
+            rho_gint.assign(inout->nspin_rho, std::vector<double>(ngint, 0.0));
+            rho_gint_ptr.resize(inout->nspin_rho);
+            for (int is = 0; is < inout->nspin_rho; is++) {
+                rho_gint_ptr[is] = rho_gint[is].data();
+            }
+            inout_gint.rho = rho_gint_ptr.data();
+        }
+        inout = &inout_gint;
+    }
     if (this->gridt->max_atom > 0) {
 #ifdef __CUDA
         if (PARAM.inp.device == "gpu"
@@ -85,6 +119,11 @@ void Gint::cal_gint(Gint_inout* inout) {
             }
         }
     }
+    if (this->gridt->balanced && is_rho) {
+        for (int is = 0; is < inout_fft->nspin_rho; is++) {
+            this->gridt->gint_to_fft_add(rho_gint[is].data(), inout_fft->rho[is]);
+        }
+    }
     ModuleBase::timer::tick("Gint_interface", "cal_gint");
     return;
 }
@@ -121,6 +160,13 @@ void Gint::prep_grid(const Grid_Technique& gt,
     this->nplane = nplane_in;
     this->startz_current = startz_current_in;
     this->ucell = ucell_in;
+    if (gt.balanced) {
+        // the local big cells are contiguous blocks of bx*by*bz points,
+        // indexed in the kernels as FFT planes of by*bz points per x.
+        this->nbxx = gt.nbxx;
+        this->ny = gt.by;
+        this->nplane = gt.bz;
+    }
     assert(nbx > 0);
     assert(nby > 0);
     assert(nbz >= 0);
@@ -142,6 +188,12 @@ void Gint::initialize_pvpR(const UnitCell& ucell_in, const Grid_Driver* gd, cons
 {
     ModuleBase::TITLE("Gint", "initialize_pvpR");
 
+#ifdef __MPI
+    this->hR_plan.reset();
+    this->hRCd_plan.reset();
+    this->DMR_plans.clear();
+#endif
+
     int npol = 1;
     // there is the only resize code of DMRGint
     if (this->DMRGint.size() == 0) {
@@ -221,6 +273,9 @@ void Gint::initialize_pvpR(const UnitCell& ucell_in, const Grid_Driver* gd, cons
 
 void Gint::reset_DMRGint(const int& nspin)
 {
+#ifdef __MPI
+    this->DMR_plans.clear();
+#endif
     if (this->hRGint)
     {
         for (auto& d : this->DMRGint) { delete d; }
@@ -251,9 +306,12 @@ void Gint::transfer_DM2DtoGrid(std::vector<hamilt::HContainer<double>*> DM2D) {
 
     ModuleBase::timer::tick("Gint", "transfer_DMR");
     if (PARAM.inp.nspin != 4) {
+#ifdef __MPI
+        this->DMR_plans.resize(this->DMRGint.size());
+#endif
         for (int is = 0; is < this->DMRGint.size(); is++) {
 #ifdef __MPI
-            hamilt::transferParallels2Serials(*DM2D[is], DMRGint[is]);
+            hamilt::transferParallels2Serials(*DM2D[is], DMRGint[is], this->DMR_plans[is]);
 #else
             this->DMRGint[is]->set_zero();
             this->DMRGint[is]->add(*DM2D[is]);
@@ -262,7 +320,8 @@ void Gint::transfer_DM2DtoGrid(std::vector<hamilt::HContainer<double>*> DM2D) {
     } else // NSPIN=4 case
     {
 #ifdef __MPI
-        hamilt::transferParallels2Serials(*DM2D[0], this->DMRGint_full);
+        this->DMR_plans.resize(1);
+        hamilt::transferParallels2Serials(*DM2D[0], this->DMRGint_full, this->DMR_plans[0]);
 #else
         this->DMRGint_full = DM2D[0];
 #endif
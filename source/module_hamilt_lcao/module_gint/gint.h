@@ -5,7 +5,9 @@
 #include "module_cell/module_neighbor/sltk_grid_driver.h"
 #include "module_hamilt_lcao/module_gint/grid_technique.h"
 #include "module_hamilt_lcao/module_hcontainer/hcontainer.h"
+#include "module_hamilt_lcao/module_hcontainer/transfer.h"
 #include <functional>
+#include <memory>
 
 //----------------------------------------------------------
 //！This class provides a unified interface to the
@@ -266,6 +268,14 @@ class Gint {
     //! tmp tools used in transfer_DM2DtoGrid 
     hamilt::HContainer<double>* DMRGint_full = nullptr;
 
+#ifdef __MPI
+    //! cached plans of the transfers between the grid and the 2D-block HContainers,
+    //! reset in initialize_pvpR when the <IJR> pattern changes
+    std::unique_ptr<hamilt::HTransferPlan<double>> hR_plan;
+    std::unique_ptr<hamilt::HTransferPlan<std::complex<double>>> hRCd_plan;
+    std::vector<std::unique_ptr<hamilt::HTransferPlan<double>>> DMR_plans;
+#endif
+
     std::vector<hamilt::HContainer<double>> pvdpRx_reduced;
     std::vector<hamilt::HContainer<double>> pvdpRy_reduced;
     std::vector<hamilt::HContainer<double>> pvdpRz_reduced;
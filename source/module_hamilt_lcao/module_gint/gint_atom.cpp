@@ -0,0 +1,518 @@
+#include "gint_atom.h"
+
+#include "gint_atom_grid.h"
+
+#include "module_base/blas_connector.h"
+#include "module_base/constants.h"
+#include "module_base/global_function.h"
+#include "module_base/global_variable.h"
+#include "module_base/parallel_reduce.h"
+#include "module_base/timer.h"
+#include "module_base/tool_quit.h"
+#include "module_base/tool_title.h"
+#include "module_base/ylm.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <set>
+
+namespace
+{
+// points of one batch
+const int batch_size = 128;
+} // namespace
+
+void Gint_Atom::init(const Grid_Technique& gt, const int nrad, const int lmax)
+{
+    ModuleBase::TITLE("Gint_Atom", "init");
+    ModuleBase::timer::tick("Gint_Atom", "init");
+    this->gt = &gt;
+    const UnitCell& ucell = *gt.ucell;
+    const int nat = ucell.nat;
+
+    std::vector<double> tau(3 * nat);
+    std::vector<double> rcut(nat);
+    for (int iat = 0; iat < nat; ++iat)
+    {
+        const int it = ucell.iat2it[iat];
+        const int ia = ucell.iat2ia[iat];
+        for (int d = 0; d < 3; ++d)
+        {
+            tau[3 * iat + d] = ucell.atoms[it].tau[ia][d] * ucell.lat0;
+        }
+        rcut[iat] = gt.rcuts[it];
+    }
+    const double rcut_max = *std::max_element(rcut.begin(), rcut.end());
+    auto distance = [&tau](const int iat, const double* r) {
+        const double dx = r[0] - tau[3 * iat];
+        const double dy = r[1] - tau[3 * iat + 1];
+        const double dz = r[2] - tau[3 * iat + 2];
+        return std::sqrt(dx * dx + dy * dy + dz * dz);
+    };
+
+    // the grid of an atom goes up to rcut_max, the atoms whose orbitals reach it are its partition centers
+    std::vector<std::vector<int>> centers(nat);
+    for (int iat = 0; iat < nat; ++iat)
+    {
+        centers[iat].push_back(iat);
+        for (int jat = 0; jat < nat; ++jat)
+        {
+            if (jat != iat && distance(jat, &tau[3 * iat]) < rcut_max + rcut[jat])
+            {
+                centers[iat].push_back(jat);
+            }
+        }
+    }
+
+    // the atoms are given to the processes in descending order of cost, each to the least loaded one
+    std::vector<int> order(nat);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&centers](const int a, const int b) {
+        return centers[a].size() > centers[b].size();
+    });
+    std::vector<double> load(GlobalV::NPROC, 0.0);
+    std::vector<int> local_atoms;
+    for (const int iat: order)
+    {
+        const int ip = std::min_element(load.begin(), load.end()) - load.begin();
+        load[ip] += centers[iat].size();
+        if (ip == GlobalV::MY_RANK)
+        {
+            local_atoms.push_back(iat);
+        }
+    }
+    std::sort(local_atoms.begin(), local_atoms.end());
+
+    std::vector<double> r_rad;
+    std::vector<double> w_rad;
+    std::vector<double> r_ang;
+    std::vector<double> w_ang;
+    int lmax_delley = lmax;
+    if (!Gint_Atom_Grid::quadrature(nrad, lmax_delley, r_rad, w_rad, r_ang, w_ang))
+    {
+        ModuleBase::WARNING_QUIT("Gint_Atom::init", "no Delley grid of this order, please decrease atom_grid_lmax");
+    }
+    const int nang = w_ang.size();
+
+    this->points.clear();
+    this->weights.clear();
+    this->batches.clear();
+    std::set<std::pair<int, int>> pairs;
+    for (const int iat: local_atoms)
+    {
+        const std::vector<int>& c = centers[iat];
+        const int nc = c.size();
+        std::vector<double> dRR(nc * nc, 0.0);
+        // exclusive zone of each center in Stratmann's scheme
+        std::vector<double> drR_thr(nc, 1.0e10);
+        for (int a = 0; a < nc; ++a)
+        {
+            for (int b = 0; b < nc; ++b)
+            {
+                if (a != b)
+                {
+                    dRR[a * nc + b] = distance(c[a], &tau[3 * c[b]]);
+                    drR_thr[a] = std::min(drR_thr[a], Gint_Atom_Grid::exclusive_radius(dRR[a * nc + b]));
+                }
+            }
+        }
+        std::vector<double> drR(nc);
+
+        std::vector<double> grid;
+        std::vector<double> w;
+        for (int ir = 0; ir < nrad && r_rad[ir] < rcut_max; ++ir)
+        {
+            for (int ia = 0; ia < nang; ++ia)
+            {
+                const double r[3] = {tau[3 * iat] + r_rad[ir] * r_ang[3 * ia],
+                                     tau[3 * iat + 1] + r_rad[ir] * r_ang[3 * ia + 1],
+                                     tau[3 * iat + 2] + r_rad[ir] * r_ang[3 * ia + 2]};
+                bool reached = false;
+                for (int a = 0; a < nc; ++a)
+                {
+                    drR[a] = distance(c[a], r);
+                    reached = reached || drR[a] < rcut[c[a]];
+                }
+                if (!reached)
+                {
+                    continue;
+                }
+                const double wp = Gint_Atom_Grid::partition_weight(nc, drR.data(), dRR.data(), drR_thr.data());
+                if (wp == 0.0)
+                {
+                    continue;
+                }
+                grid.insert(grid.end(), r, r + 3);
+                w.push_back(w_rad[ir] * w_ang[ia] * wp);
+            }
+        }
+
+        const int np = w.size();
+        std::vector<int> idx(np);
+        std::iota(idx.begin(), idx.end(), 0);
+        std::vector<int> starts = Gint_Atom_Grid::batches(grid.data(), idx.data(), np, batch_size);
+        starts.push_back(np);
+        const int offset = this->weights.size();
+        for (const int ip: idx)
+        {
+            this->points.insert(this->points.end(), &grid[3 * ip], &grid[3 * ip] + 3);
+            this->weights.push_back(w[ip]);
+        }
+        for (int ib = 0; ib + 1 < starts.size(); ++ib)
+        {
+            Batch batch;
+            batch.start = offset + starts[ib];
+            batch.size = starts[ib + 1] - starts[ib];
+            if (batch.size == 0)
+            {
+                continue;
+            }
+            // bounding sphere of the batch
+            double center[3] = {0.0, 0.0, 0.0};
+            for (int ip = batch.start; ip < batch.start + batch.size; ++ip)
+            {
+                for (int d = 0; d < 3; ++d)
+                {
+                    center[d] += this->points[3 * ip + d] / batch.size;
+                }
+            }
+            double radius = 0.0;
+            for (int ip = batch.start; ip < batch.start + batch.size; ++ip)
+            {
+                const double dx = this->points[3 * ip] - center[0];
+                const double dy = this->points[3 * ip + 1] - center[1];
+                const double dz = this->points[3 * ip + 2] - center[2];
+                radius = std::max(radius, std::sqrt(dx * dx + dy * dy + dz * dz));
+            }
+            batch.col_start.push_back(0);
+            for (const int jat: c)
+            {
+                if (distance(jat, center) < rcut[jat] + radius)
+                {
+                    batch.atoms.push_back(jat);
+                    batch.col_start.push_back(batch.col_start.back() + ucell.atoms[ucell.iat2it[jat]].nw);
+                }
+            }
+            for (const int iat1: batch.atoms)
+            {
+                for (const int iat2: batch.atoms)
+                {
+                    if (distance(iat1, &tau[3 * iat2]) < rcut[iat1] + rcut[iat2])
+                    {
+                        pairs.insert(std::make_pair(iat1, iat2));
+                    }
+                }
+            }
+            this->batches.push_back(std::move(batch));
+        }
+    }
+
+    std::vector<int> atom_begin(nat + 1, 0);
+    for (int iat = 0; iat < nat; ++iat)
+    {
+        atom_begin[iat + 1] = atom_begin[iat] + ucell.atoms[ucell.iat2it[iat]].nw;
+    }
+    this->pattern.reset(new hamilt::HContainer<double>(nat));
+    for (const auto& p: pairs)
+    {
+        hamilt::AtomPair<double> ap(p.first, p.second, 0, 0, 0, atom_begin.data(), atom_begin.data(), nat);
+        this->pattern->insert_pair(ap);
+    }
+    this->pattern->allocate(nullptr, true);
+    for (Batch& batch: this->batches)
+    {
+        const int na = batch.atoms.size();
+        batch.offset.assign(na * na, -1);
+        for (int a = 0; a < na; ++a)
+        {
+            for (int b = 0; b < na; ++b)
+            {
+                batch.offset[a * na + b] = this->pattern->find_matrix_offset(batch.atoms[a], batch.atoms[b], 0, 0, 0);
+            }
+        }
+    }
+
+    int npoints = this->weights.size();
+    Parallel_Reduce::reduce_all(npoints);
+    ModuleBase::GlobalFunc::OUT(GlobalV::ofs_running, "atom grid order of Delley", lmax_delley);
+    ModuleBase::GlobalFunc::OUT(GlobalV::ofs_running, "atom grid points", npoints);
+    ModuleBase::timer::tick("Gint_Atom", "init");
+}
+
+void Gint_Atom::cal_phi(const Batch& batch, std::vector<double>& phi) const
+{
+    const UnitCell& ucell = *this->gt->ucell;
+    const int nbasis = batch.col_start.back();
+    phi.assign(batch.size * nbasis, 0.0);
+    std::vector<double> ylma;
+    for (int a = 0; a < batch.atoms.size(); ++a)
+    {
+        const int iat = batch.atoms[a];
+        const int it = ucell.iat2it[iat];
+        const int ia = ucell.iat2ia[iat];
+        const Atom* const atom = &ucell.atoms[it];
+        const double tau[3] = {atom->tau[ia].x * ucell.lat0, atom->tau[ia].y * ucell.lat0, atom->tau[ia].z * ucell.lat0};
+        for (int ip = 0; ip < batch.size; ++ip)
+        {
+            const double* r = &this->points[3 * (batch.start + ip)];
+            const double dr[3] = {r[0] - tau[0], r[1] - tau[1], r[2] - tau[2]};
+            double distance = std::sqrt(dr[0] * dr[0] + dr[1] * dr[1] + dr[2] * dr[2]);
+            if (distance >= this->gt->rcuts[it])
+            {
+                continue;
+            }
+            if (distance < 1.0E-9)
+            {
+                distance += 1.0E-9;
+            }
+            ModuleBase::Ylm::sph_harm(atom->nwl, dr[0] / distance, dr[1] / distance, dr[2] / distance, ylma);
+
+            // cubic interpolation of the radial tables, as in Gint_Tools::cal_psir_ylm
+            const double delta_r = this->gt->dr_uniform;
+            const double position = distance / delta_r;
+            const int iq = static_cast<int>(position);
+            const double x = position - iq;
+            const double x2 = x * x;
+            const double x3 = x2 * x;
+            const double c3 = 3.0 * x2 - 2.0 * x3;
+            const double c1 = 1.0 - c3;
+            const double c2 = (x - 2.0 * x2 + x3) * delta_r;
+            const double c4 = (x3 - x2) * delta_r;
+
+            double* p = &phi[ip * nbasis + batch.col_start[a]];
+            double radial = 0.0;
+            for (int iw = 0; iw < atom->nw; ++iw)
+            {
+                if (atom->iw2_new[iw])
+                {
+                    const double* psi_uniform = this->gt->psi_u[it * this->gt->nwmax + iw].data();
+                    const double* dpsi_uniform = this->gt->dpsi_u[it * this->gt->nwmax + iw].data();
+                    radial = c1 * psi_uniform[iq] + c2 * dpsi_uniform[iq] + c3 * psi_uniform[iq + 1]
+                             + c4 * dpsi_uniform[iq + 1];
+                }
+                p[iw] = radial * ylma[atom->iw2_ylm[iw]];
+            }
+        }
+    }
+}
+
+void Gint_Atom::cal_rho(const hamilt::HContainer<double>& dm_serial, double* rho) const
+{
+    ModuleBase::timer::tick("Gint_Atom", "cal_rho");
+    const UnitCell& ucell = *this->gt->ucell;
+    const double* dm = dm_serial.get_wrapper();
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    {
+        std::vector<double> phi;
+        std::vector<double> dm_batch;
+        std::vector<double> phi_dm;
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic)
+#endif
+        for (int ib = 0; ib < this->batches.size(); ++ib)
+        {
+            const Batch& batch = this->batches[ib];
+            const int na = batch.atoms.size();
+            const int nbasis = batch.col_start.back();
+            if (nbasis == 0)
+            {
+                std::fill(rho + batch.start, rho + batch.start + batch.size, 0.0);
+                continue;
+            }
+            this->cal_phi(batch, phi);
+
+            // dense DM of the atoms of this batch
+            dm_batch.assign(nbasis * nbasis, 0.0);
+            for (int a = 0; a < na; ++a)
+            {
+                const int nw1 = ucell.atoms[ucell.iat2it[batch.atoms[a]]].nw;
+                for (int b = 0; b < na; ++b)
+                {
+                    const int offset = batch.offset[a * na + b];
+                    if (offset < 0)
+                    {
+                        continue;
+                    }
+                    const int nw2 = ucell.atoms[ucell.iat2it[batch.atoms[b]]].nw;
+                    for (int iw1 = 0; iw1 < nw1; ++iw1)
+                    {
+                        std::copy(dm + offset + iw1 * nw2,
+                                  dm + offset + (iw1 + 1) * nw2,
+                                  &dm_batch[(batch.col_start[a] + iw1) * nbasis + batch.col_start[b]]);
+                    }
+                }
+            }
+
+            // rho(r) = \sum_{mu,nu} phi_mu(r) DM_{mu,nu} phi_nu(r)
+            phi_dm.resize(batch.size * nbasis);
+            BlasConnector::gemm('N', 'N', batch.size, nbasis, nbasis,
+                                1.0, phi.data(), nbasis, dm_batch.data(), nbasis,
+                                0.0, phi_dm.data(), nbasis);
+            for (int ip = 0; ip < batch.size; ++ip)
+            {
+                rho[batch.start + ip] = BlasConnector::dot(nbasis, &phi_dm[ip * nbasis], 1, &phi[ip * nbasis], 1);
+            }
+        }
+    }
+    ModuleBase::timer::tick("Gint_Atom", "cal_rho");
+}
+
+void Gint_Atom::cal_vlocal(const double* v, hamilt::HContainer<double>& v_serial) const
+{
+    ModuleBase::timer::tick("Gint_Atom", "cal_vlocal");
+    const UnitCell& ucell = *this->gt->ucell;
+    const int nnr = v_serial.get_nnr();
+    double* vr = v_serial.get_wrapper();
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    {
+        std::vector<double> phi;
+        std::vector<double> phi_v;
+        std::vector<double> v_batch;
+        std::vector<double> vr_thread(nnr, 0.0);
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic)
+#endif
+        for (int ib = 0; ib < this->batches.size(); ++ib)
+        {
+            const Batch& batch = this->batches[ib];
+            const int na = batch.atoms.size();
+            const int nbasis = batch.col_start.back();
+            if (nbasis == 0)
+            {
+                continue;
+            }
+            this->cal_phi(batch, phi);
+
+            // <phi_mu|v|phi_nu> = \sum_r phi_mu(r) w(r) v(r) phi_nu(r)
+            phi_v.resize(batch.size * nbasis);
+            for (int ip = 0; ip < batch.size; ++ip)
+            {
+                const double wv = this->weights[batch.start + ip] * v[batch.start + ip];
+                for (int iw = 0; iw < nbasis; ++iw)
+                {
+                    phi_v[ip * nbasis + iw] = wv * phi[ip * nbasis + iw];
+                }
+            }
+            v_batch.resize(nbasis * nbasis);
+            BlasConnector::gemm('T', 'N', nbasis, nbasis, batch.size,
+                                1.0, phi.data(), nbasis, phi_v.data(), nbasis,
+                                0.0, v_batch.data(), nbasis);
+
+            for (int a = 0; a < na; ++a)
+            {
+                const int nw1 = ucell.atoms[ucell.iat2it[batch.atoms[a]]].nw;
+                for (int b = 0; b < na; ++b)
+                {
+                    const int offset = batch.offset[a * na + b];
+                    if (offset < 0)
+                    {
+                        continue;
+                    }
+                    const int nw2 = ucell.atoms[ucell.iat2it[batch.atoms[b]]].nw;
+                    for (int iw1 = 0; iw1 < nw1; ++iw1)
+                    {
+                        const double* src = &v_batch[(batch.col_start[a] + iw1) * nbasis + batch.col_start[b]];
+                        double* dst = &vr_thread[offset + iw1 * nw2];
+                        for (int iw2 = 0; iw2 < nw2; ++iw2)
+                        {
+                            dst[iw2] += src[iw2];
+                        }
+                    }
+                }
+            }
+        }
+#ifdef _OPENMP
+#pragma omp critical(gint_atom_vlocal)
+#endif
+        BlasConnector::axpy(nnr, 1.0, vr_thread.data(), 1, vr, 1);
+    }
+    ModuleBase::timer::tick("Gint_Atom", "cal_vlocal");
+}
+
+void Gint_Atom::atomic_rho(double* rho, double* mag) const
+{
+    ModuleBase::TITLE("Gint_Atom", "atomic_rho");
+    const UnitCell& ucell = *this->gt->ucell;
+
+    // spherical atomic densities rho_at(r) / (4 pi r^2) on the radial mesh of each type
+    std::vector<std::vector<double>> rho_type(ucell.ntype);
+    for (int it = 0; it < ucell.ntype; ++it)
+    {
+        const Atom& atom = ucell.atoms[it];
+        const int msh = atom.ncpp.msh;
+        rho_type[it].resize(msh, 0.0);
+        for (int ir = 1; ir < msh; ++ir)
+        {
+            rho_type[it][ir] = atom.ncpp.rho_at[ir] / ModuleBase::FOUR_PI / (atom.ncpp.r[ir] * atom.ncpp.r[ir]);
+        }
+        if (msh > 1)
+        {
+            rho_type[it][0] = rho_type[it][1];
+        }
+    }
+
+    const int npoints = this->weights.size();
+    std::fill(rho, rho + npoints, 0.0);
+    std::fill(mag, mag + npoints, 0.0);
+    for (const Batch& batch: this->batches)
+    {
+        for (const int iat: batch.atoms)
+        {
+            const int it = ucell.iat2it[iat];
+            const int ia = ucell.iat2ia[iat];
+            const Atom& atom = ucell.atoms[it];
+            const std::vector<double>& r_mesh = atom.ncpp.r;
+            const int msh = atom.ncpp.msh;
+            const double m = (ia < static_cast<int>(atom.mag.size()) && atom.ncpp.zv > 0.0)
+                                 ? std::max(-1.0, std::min(1.0, atom.mag[ia] / atom.ncpp.zv))
+                                 : 0.0;
+            const ModuleBase::Vector3<double> tau = atom.tau[ia] * ucell.lat0;
+            for (int ip = batch.start; ip < batch.start + batch.size; ++ip)
+            {
+                const double dx = this->points[3 * ip] - tau.x;
+                const double dy = this->points[3 * ip + 1] - tau.y;
+                const double dz = this->points[3 * ip + 2] - tau.z;
+                const double d = std::sqrt(dx * dx + dy * dy + dz * dz);
+                const int ir = std::upper_bound(r_mesh.begin(), r_mesh.begin() + msh, d) - r_mesh.begin();
+                if (ir >= msh)
+                {
+                    continue;
+                }
+                double value = rho_type[it][ir];
+                if (ir > 0)
+                {
+                    const double x = (d - r_mesh[ir - 1]) / (r_mesh[ir] - r_mesh[ir - 1]);
+                    value = (1.0 - x) * rho_type[it][ir - 1] + x * value;
+                }
+                rho[ip] += value;
+                mag[ip] += m * value;
+            }
+        }
+    }
+
+    // scaled to the number of valence electrons of the atoms
+    double ne = 0.0;
+    for (int ip = 0; ip < npoints; ++ip)
+    {
+        ne += this->weights[ip] * rho[ip];
+    }
+    Parallel_Reduce::reduce_all(ne);
+    double zv = 0.0;
+    for (int it = 0; it < ucell.ntype; ++it)
+    {
+        zv += ucell.atoms[it].ncpp.zv * ucell.atoms[it].na;
+    }
+    if (ne > 0.0)
+    {
+        for (int ip = 0; ip < npoints; ++ip)
+        {
+            rho[ip] *= zv / ne;
+            mag[ip] *= zv / ne;
+        }
+    }
+}
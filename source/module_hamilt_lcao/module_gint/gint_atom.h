@@ -0,0 +1,85 @@
+#ifndef GINT_ATOM_H
+#define GINT_ATOM_H
+
+#include "module_hamilt_lcao/module_gint/grid_technique.h"
+#include "module_hamilt_lcao/module_hcontainer/hcontainer.h"
+#include "module_hamilt_lcao/module_hcontainer/transfer.h"
+
+#include <memory>
+#include <vector>
+
+//----------------------------------------------------------
+//! Grid integration on atom-centered grids for gamma-only
+//! LCAO calculations of molecules and clusters.
+//! Each atom carries a Treutler-Ahlrichs M4 radial grid times
+//! a Delley angular grid, partitioned by the Becke weights with
+//! Stratmann's cell function. The atoms are shared among the
+//! processes, their points are cut into batches by
+//! Grid::Batch::maxmin, and the basis values of a batch are
+//! used in GEMMs to get rho from DM(R) and <phi|v|phi> from v,
+//! as in the uniform-grid Gint.
+//----------------------------------------------------------
+class Gint_Atom
+{
+  public:
+    /**
+     * @brief build the atom grids, the batches and the <I,J> pattern of the local batches
+     * @param gt gives the cell and the radial tables of the orbitals
+     * @param nrad number of radial points of each atom
+     * @param lmax order of the Delley angular grid
+     */
+    void init(const Grid_Technique& gt, const int nrad, const int lmax);
+
+    //! number of points on this process
+    int get_npoints() const { return this->weights.size(); }
+
+    //! quadrature weights of the points on this process, including the partition weights
+    const std::vector<double>& get_weights() const { return this->weights; }
+
+    //! serial HContainer with the <I,J> pairs needed by the local batches, to hold DM(R) and V(R)
+    const hamilt::HContainer<double>& get_pattern() const { return *this->pattern; }
+
+    /**
+     * @brief electron density on the local points
+     * @param dm_serial DM(R) of one spin on the pairs of get_pattern()
+     * @param rho rho[ip] of the local points
+     */
+    void cal_rho(const hamilt::HContainer<double>& dm_serial, double* rho) const;
+
+    /**
+     * @brief add <phi_I|v|phi_J> of the local points to v_serial
+     * @param v potential on the local points
+     * @param v_serial HContainer on the pairs of get_pattern()
+     */
+    void cal_vlocal(const double* v, hamilt::HContainer<double>& v_serial) const;
+
+    /**
+     * @brief superposition of the atomic densities of the pseudopotentials on the local points
+     * @param rho rho[ip] of the local points
+     * @param mag rho_up - rho_down given by the starting magnetizations of the atoms
+     */
+    void atomic_rho(double* rho, double* mag) const;
+
+  private:
+    struct Batch
+    {
+        int start = 0; // first point of the batch
+        int size = 0;  // number of points
+        std::vector<int> atoms; // atoms whose orbitals may reach the batch
+        std::vector<int> col_start; // first column of each atom in the basis values, dim: atoms.size() + 1
+        std::vector<int> offset; // offset of <atoms[a],atoms[b]> in the pattern, -1 if they do not overlap
+    };
+
+    // basis values phi[ip * nbasis + iw] of the points of a batch
+    void cal_phi(const Batch& batch, std::vector<double>& phi) const;
+
+    const Grid_Technique* gt = nullptr;
+
+    // coordinates in Bohr of the local points, x0, y0, z0, x1, ...
+    std::vector<double> points;
+    std::vector<double> weights;
+    std::vector<Batch> batches;
+    std::unique_ptr<hamilt::HContainer<double>> pattern;
+};
+
+#endif
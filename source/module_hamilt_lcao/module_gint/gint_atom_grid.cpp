@@ -0,0 +1,53 @@
+#include "gint_atom_grid.h"
+
+#include "module_base/constants.h"
+#include "module_base/grid/batch.h"
+#include "module_base/grid/delley.h"
+#include "module_base/grid/partition.h"
+#include "module_base/grid/radial.h"
+
+#include <numeric>
+
+namespace Gint_Atom_Grid
+{
+
+bool quadrature(const int nrad,
+                int& lmax,
+                std::vector<double>& r_rad,
+                std::vector<double>& w_rad,
+                std::vector<double>& r_ang,
+                std::vector<double>& w_ang)
+{
+    r_rad.resize(nrad);
+    w_rad.resize(nrad);
+    Grid::Radial::treutler_m4(nrad, 1.0, r_rad.data(), w_rad.data());
+    if (Grid::Angular::delley(lmax, r_ang, w_ang) != 0)
+    {
+        return false;
+    }
+    // Delley's weights sum to 1
+    for (double& w: w_ang)
+    {
+        w *= ModuleBase::FOUR_PI;
+    }
+    return true;
+}
+
+double exclusive_radius(const double dmin)
+{
+    return 0.5 * (1.0 - Grid::Partition::stratmann_a) * dmin;
+}
+
+double partition_weight(const int nc, const double* drR, const double* dRR, const double* drR_thr)
+{
+    std::vector<int> iR(nc);
+    std::iota(iR.begin(), iR.end(), 0);
+    return Grid::Partition::w_stratmann(nc, drR, dRR, drR_thr, nc, iR.data(), 0);
+}
+
+std::vector<int> batches(const double* grid, int* idx, const int m, const int m_thr)
+{
+    return Grid::Batch::maxmin(grid, idx, m, m_thr);
+}
+
+} // namespace Gint_Atom_Grid
@@ -0,0 +1,47 @@
+#ifndef GINT_ATOM_GRID_H
+#define GINT_ATOM_GRID_H
+
+#include <vector>
+
+//----------------------------------------------------------
+//! Wrappers of the quadratures, partition weights and batches
+//! of module_base/grid used by Gint_Atom.
+//! The namespace Grid of module_base/grid can not be seen
+//! together with the class Grid of the neighbor search, which
+//! comes with Grid_Technique, so they are called from a
+//! translation unit of their own.
+//----------------------------------------------------------
+namespace Gint_Atom_Grid
+{
+
+/**
+ * @brief Treutler-Ahlrichs M4 radial grid and Delley angular grid
+ * the radial weights include r^2, the angular weights include 4pi
+ * @param lmax order of the angular grid, set to the order of the grid found
+ * @return false if there is no Delley grid of this order
+ */
+bool quadrature(const int nrad,
+                int& lmax,
+                std::vector<double>& r_rad,
+                std::vector<double>& w_rad,
+                std::vector<double>& r_ang,
+                std::vector<double>& w_ang);
+
+//! radius of the zone around a center where its Stratmann weight is 1, dmin is the distance to the nearest center
+double exclusive_radius(const double dmin);
+
+/**
+ * @brief Becke weight with Stratmann's cell function of the first center
+ * @param nc number of centers
+ * @param drR distances of the point to the centers
+ * @param dRR distances between the centers, nc * nc
+ * @param drR_thr exclusive_radius() of each center
+ */
+double partition_weight(const int nc, const double* drR, const double* dRR, const double* drR_thr);
+
+//! Grid::Batch::maxmin(), start of each batch in idx
+std::vector<int> batches(const double* grid, int* idx, const int m, const int m_thr);
+
+} // namespace Gint_Atom_Grid
+
+#endif
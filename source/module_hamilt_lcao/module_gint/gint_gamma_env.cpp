@@ -23,6 +23,15 @@ void Gint_Gamma::cal_env(const double* wfc, double* rho,const UnitCell& ucell)
     const int ncyz = this->ny * this->nplane; // mohan add 2012-03-25
     const int bxyz = this->bxyz;
 
+    // with gint_balance, rho is collected in the Gint layout first
+    std::vector<double> rho_gint;
+    double* rho_out = rho;
+    if (this->gridt->balanced)
+    {
+        rho_gint.assign(this->nbxx * this->bxyz, 0.0);
+        rho_out = rho_gint.data();
+    }
+
     #pragma omp parallel 
     {
         std::vector<int> block_iw(max_size, 0);
@@ -91,11 +100,15 @@ void Gint_Gamma::cal_env(const double* wfc, double* rho,const UnitCell& ucell)
                         {
                             tmp += psi1[iw] * wfc[iw1_lo];
                         } // iw
-                        rho[vindex[ib]] += tmp;
+                        rho_out[vindex[ib]] += tmp;
                     } // cal_flag
                 }     // ib
             }         // ia1
         }
     }
+    if (this->gridt->balanced)
+    {
+        this->gridt->gint_to_fft_add(rho_gint.data(), rho);
+    }
     return;
 }
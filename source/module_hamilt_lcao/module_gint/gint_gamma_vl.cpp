@@ -84,7 +84,7 @@ void Gint_Gamma::transfer_pvpR(hamilt::HContainer<double>* hR, const UnitCell* u
     }
     else
     {
-        hamilt::transferSerials2Parallels(*this->hRGint, hR);
+        hamilt::transferSerials2Parallels(*this->hRGint, hR, this->hR_plan);
     }
 #else
     hR->add(*this->hRGint);
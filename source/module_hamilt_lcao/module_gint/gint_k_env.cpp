@@ -30,6 +30,15 @@ void Gint_k::cal_env_k(int ik,
     const int nbz = this->gridt->nbzp;
     const int ncyz = this->ny * this->nplane; // mohan add 2012-03-25
 
+    // with gint_balance, rho is collected in the Gint layout first
+    std::vector<double> rho_gint;
+    double* rho_out = rho;
+    if (this->gridt->balanced)
+    {
+        rho_gint.assign(this->nbxx * this->bxyz, 0.0);
+        rho_out = rho_gint.data();
+    }
+
     #pragma omp parallel 
     {
         std::vector<int> vindex(this->bxyz, 0);
@@ -127,12 +136,16 @@ void Gint_k::cal_env_k(int ik,
                                 tmp += std::complex<double>(psi1[iw], 0.0) * psi_k[iw1_lo] * kphase;
                             }
                         }
-                        rho[vindex[ib]] += tmp.real();
+                        rho_out[vindex[ib]] += tmp.real();
                     } // cal_flag
                 }     // ib
             }         // ia1
         } // i
     }
+    if (this->gridt->balanced)
+    {
+        this->gridt->gint_to_fft_add(rho_gint.data(), rho);
+    }
     ModuleBase::timer::tick("Gint_k", "cal_env_k");
     return;
 }
@@ -61,7 +61,7 @@ void Gint_k::transfer_pvpR(hamilt::HContainer<double>* hR, const UnitCell* ucell
     }
     else
     {
-        hamilt::transferSerials2Parallels(*this->hRGint, hR);
+        hamilt::transferSerials2Parallels(*this->hRGint, hR, this->hR_plan);
     }
 #else
     hR->add(*this->hRGint);
@@ -152,7 +152,7 @@ void Gint_k::transfer_pvpR(hamilt::HContainer<std::complex<double>>* hR,
     }
     else
     {
-        hamilt::transferSerials2Parallels<std::complex<double>>(*this->hRGintCd, hR);
+        hamilt::transferSerials2Parallels<std::complex<double>>(*this->hRGintCd, hR, this->hRCd_plan);
     }
 #else
     hR->add(*this->hRGintCd);
@@ -0,0 +1,100 @@
+#include "grid_partition.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace Grid_Partition
+{
+
+namespace
+{
+// spread the lower 21 bits of x so that there are two zero bits between each of them
+uint64_t spread_bits(const int x)
+{
+    uint64_t v = static_cast<uint64_t>(x) & 0x1fffff;
+    v = (v | v << 32) & 0x1f00000000ffff;
+    v = (v | v << 16) & 0x1f0000ff0000ff;
+    v = (v | v << 8) & 0x100f00f00f00f00f;
+    v = (v | v << 4) & 0x10c30c30c30c30c3;
+    v = (v | v << 2) & 0x1249249249249249;
+    return v;
+}
+} // namespace
+
+uint64_t morton_key(const int ix, const int iy, const int iz)
+{
+    return spread_bits(ix) << 2 | spread_bits(iy) << 1 | spread_bits(iz);
+}
+
+void partition_bigcells(const std::vector<double>& cost,
+                        const int nbx,
+                        const int nby,
+                        const int nbz,
+                        const int nproc,
+                        std::vector<int>& order,
+                        std::vector<int>& owner)
+{
+    const int nbxyz = nbx * nby * nbz;
+    assert(cost.size() == nbxyz);
+    assert(nproc > 0);
+
+    std::vector<uint64_t> key(nbxyz);
+    for (int ibx = 0; ibx < nbx; ++ibx)
+    {
+        for (int iby = 0; iby < nby; ++iby)
+        {
+            for (int ibz = 0; ibz < nbz; ++ibz)
+            {
+                key[ibx * nby * nbz + iby * nbz + ibz] = morton_key(ibx, iby, ibz);
+            }
+        }
+    }
+    order.resize(nbxyz);
+    for (int i = 0; i < nbxyz; ++i)
+    {
+        order[i] = i;
+    }
+    std::sort(order.begin(), order.end(), [&key](const int a, const int b) { return key[a] < key[b]; });
+
+    double total = 0.0;
+    for (int i = 0; i < nbxyz; ++i)
+    {
+        total += cost[i];
+    }
+
+    owner.assign(nbxyz, 0);
+    double prefix = 0.0;
+    for (int k = 0; k < nbxyz; ++k)
+    {
+        const int i = order[k];
+        int ip = 0;
+        if (total > 0.0)
+        {
+            ip = static_cast<int>(nproc * (prefix + 0.5 * cost[i]) / total);
+        }
+        else
+        {
+            ip = static_cast<int>(static_cast<long long>(nproc) * k / nbxyz);
+        }
+        owner[i] = std::min(ip, nproc - 1);
+        prefix += cost[i];
+    }
+}
+
+double imbalance(const std::vector<double>& cost, const std::vector<int>& owner, const int nproc)
+{
+    std::vector<double> cost_proc(nproc, 0.0);
+    double total = 0.0;
+    for (int i = 0; i < cost.size(); ++i)
+    {
+        cost_proc[owner[i]] += cost[i];
+        total += cost[i];
+    }
+    if (total <= 0.0)
+    {
+        return 1.0;
+    }
+    return *std::max_element(cost_proc.begin(), cost_proc.end()) * nproc / total;
+}
+
+} // namespace Grid_Partition
@@ -0,0 +1,46 @@
+#ifndef GRID_PARTITION_H
+#define GRID_PARTITION_H
+
+#include <cstdint>
+#include <vector>
+
+//----------------------------------------------------------
+//! Partition of the big cells of grid integration over the
+//! processors of a pool by the cost of each big cell
+//! (gint_balance). The big cells are ordered along the
+//! Z-order (Morton) space-filling curve and the curve is cut
+//! into pieces of nearly equal cost, so that the big cells of
+//! a processor stay compact and share most of their atoms.
+//! The global index of big cell (ibx, iby, ibz) is
+//! ibx * nby * nbz + iby * nbz + ibz, as in Grid_Technique.
+//----------------------------------------------------------
+namespace Grid_Partition
+{
+
+//! key of (ix, iy, iz) on the Z-order curve, interleaving the bits of the three indices
+uint64_t morton_key(const int ix, const int iy, const int iz);
+
+/**
+ * @brief cut the big cells into nproc pieces of nearly equal cost along the Z-order curve
+ * @param cost cost of each big cell, dim: nbx * nby * nbz
+ * @param order output, global index of the k-th big cell along the curve
+ * @param owner output, the processor of each big cell
+ *
+ * A big cell belongs to the processor whose share of the total cost contains the middle
+ * of the big cell, so the pieces are contiguous along the curve. If all the costs are
+ * zero, the big cells are split by number.
+ */
+void partition_bigcells(const std::vector<double>& cost,
+                        const int nbx,
+                        const int nby,
+                        const int nbz,
+                        const int nproc,
+                        std::vector<int>& order,
+                        std::vector<int>& owner);
+
+//! the largest cost of one processor divided by the average cost, 1 for a perfect balance
+double imbalance(const std::vector<double>& cost, const std::vector<int>& owner, const int nproc);
+
+} // namespace Grid_Partition
+
+#endif
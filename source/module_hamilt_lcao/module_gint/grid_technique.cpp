@@ -9,6 +9,10 @@
 #include "module_base/timer.h"
 #include "module_hamilt_pw/hamilt_pwdft/global.h"
 #include "module_hsolver/kernels/cuda/helper_cuda.h"
+#include "grid_partition.h"
+#ifdef __MPI
+#include "module_base/parallel_comm.h"
+#endif
 
 Grid_Technique::Grid_Technique() {
 #if ((defined __CUDA) /* || (defined __ROCM) */)
@@ -140,6 +144,13 @@ void Grid_Technique::get_startind(const int& ny,
     this->start_ind = std::vector<int>(nbxx, 0);
     ModuleBase::Memory::record("GT::start_ind", sizeof(int) * nbxx);
 
+    if (this->balanced) {
+        for (int i = 0; i < nbxx; i++) {
+            start_ind[i] = i * this->bxyz;
+        }
+        return;
+    }
+
     for (int i = 0; i < nbxx; i++) {
         int ibx = 0;
         int iby = 0;
@@ -175,6 +186,18 @@ void Grid_Technique::init_atoms_on_grid(const int& ny,
     ModuleBase::TITLE("Grid_Technique", "init_atoms_on_grid");
 
     assert(nbxx >= 0);
+
+    // index of the extended grid in the normal grid.
+    std::vector<int> index2normal = std::vector<int>(this->nxyze, 0);
+    ModuleBase::Memory::record("GT::index2normal", sizeof(int) * this->nxyze);
+    this->grid_expansion_index(true, index2normal.data());
+
+    this->balanced = false;
+#ifdef __MPI
+    if (PARAM.inp.gint_balance && PARAM.inp.device != "gpu" && GlobalV::NPROC_IN_POOL > 1) {
+        this->init_balanced_bigcells(index2normal.data(), ny, nplane, startz_current, ucell);
+    }
+#endif
     this->get_startind(ny, nplane, startz_current);
 
     // (1) prepare data.
@@ -199,12 +222,7 @@ void Grid_Technique::init_atoms_on_grid(const int& ny,
     ModuleBase::Memory::record("GT::in_this_processor",
                                sizeof(int) * this->nxyze);
 
-    // (4) init atoms on grid
-    std::vector<int> index2normal = std::vector<int>(this->nxyze, 0);
-    ModuleBase::Memory::record("GT::index2normal", sizeof(int) * this->nxyze);
-    this->grid_expansion_index(true, index2normal.data());
-
-    // (5) record how many atoms on
+    // (4) record how many atoms on
     // each local grid point (ix,iy,iz)
     int nat_local = 0;
     this->total_atoms_on_grid = 0;
@@ -239,23 +257,7 @@ void Grid_Technique::init_atoms_on_grid(const int& ny,
                 continue;
             }
 
-            bool is_atom_on_bcell = false;
-            const double dr_x_part = this->meshball_positions[im][0] - this->tau_in_bigcell[iat][0];
-            const double dr_y_part = this->meshball_positions[im][1] - this->tau_in_bigcell[iat][1];
-            const double dr_z_part = this->meshball_positions[im][2] - this->tau_in_bigcell[iat][2];
-            for(int imcell = 0; imcell < this -> bxyz; imcell++)
-            {
-                const double dr_x = this->meshcell_pos[imcell][0] + dr_x_part;
-                const double dr_y = this->meshcell_pos[imcell][1] + dr_y_part;
-                const double dr_z = this->meshcell_pos[imcell][2] + dr_z_part;
-                const double dist_square = dr_x * dr_x + dr_y * dr_y + dr_z * dr_z;
-                if(dist_square <= rcut_square)
-                {
-                    is_atom_on_bcell = true;
-                    break;
-                }
-            }
-            if(is_atom_on_bcell)
+            if(this->is_atom_on_bcell(iat, im, rcut_square))
             {
                 ++how_many_atoms[bcell_idx_on_proc];
                 ++this->total_atoms_on_grid;
@@ -302,8 +304,34 @@ void Grid_Technique::init_atoms_on_grid(const int& ny,
     return;
 }
 
+bool Grid_Technique::is_atom_on_bcell(const int iat, const int im, const double rcut_square) const {
+    const double dr_x_part = this->meshball_positions[im][0] - this->tau_in_bigcell[iat][0];
+    const double dr_y_part = this->meshball_positions[im][1] - this->tau_in_bigcell[iat][1];
+    const double dr_z_part = this->meshball_positions[im][2] - this->tau_in_bigcell[iat][2];
+    for (int imcell = 0; imcell < this->bxyz; imcell++) {
+        const double dr_x = this->meshcell_pos[imcell][0] + dr_x_part;
+        const double dr_y = this->meshcell_pos[imcell][1] + dr_y_part;
+        const double dr_z = this->meshcell_pos[imcell][2] + dr_z_part;
+        const double dist_square = dr_x * dr_x + dr_y * dr_y + dr_z * dr_z;
+        if (dist_square <= rcut_square) {
+            return true;
+        }
+    }
+    return false;
+}
+
 void Grid_Technique::check_bigcell(int* ind_bigcell,
                                    char* bigcell_on_processor) {
+    if (this->balanced) {
+        std::fill(ind_bigcell, ind_bigcell + nbxyz, 0);
+        std::fill(bigcell_on_processor, bigcell_on_processor + nbxyz, 0);
+        for (int i = 0; i < this->balanced_cells.size(); i++) {
+            ind_bigcell[this->balanced_cells[i]] = i;
+            bigcell_on_processor[this->balanced_cells[i]] = 1;
+        }
+        return;
+    }
+
     // check if a given bigcell is treated on this processor
     const int zstart = nbzp_start;
     const int zend = nbzp + zstart;
@@ -337,6 +365,204 @@ void Grid_Technique::check_bigcell(int* ind_bigcell,
     return;
 }
 
+void Grid_Technique::init_balanced_bigcells(const int* index2normal,
+                                            const int& ny,
+                                            const int& nplane,
+                                            const int& startz_current,
+                                            const UnitCell& ucell) {
+#ifdef __MPI
+    ModuleBase::TITLE("Grid_Technique", "init_balanced_bigcells");
+    ModuleBase::timer::tick("Grid_Technique", "init_balanced_bigcells");
+
+    const int nproc = GlobalV::NPROC_IN_POOL;
+    const int rank = GlobalV::RANK_IN_POOL;
+    const int zend = nbzp_start + nbzp;
+
+    // (1) the cost of a big cell grows with the number of orbitals n_w
+    // reaching it: n_w for the values of the orbitals and n_w^2 for the
+    // products of orbital pairs. Each processor counts the big cells
+    // of its own FFT planes.
+    std::vector<double> nw_on_bcell(nbxyz, 0.0);
+    for (int iat = 0; iat < ucell.nat; iat++) {
+        const int it = ucell.iat2it[iat];
+        const double rcut_square = this->rcuts[it] * this->rcuts[it];
+        for (int im = 0; im < this->meshball_ncells; im++) {
+            const int normal = index2normal[this->index_atom[iat] + this->index_ball[im]];
+            const int ibz = normal % nbz;
+            if (ibz < nbzp_start || ibz >= zend) {
+                continue;
+            }
+            if (this->is_atom_on_bcell(iat, im, rcut_square)) {
+                nw_on_bcell[normal] += ucell.atoms[it].nw;
+            }
+        }
+    }
+    Parallel_Reduce::reduce_pool(nw_on_bcell.data(), nbxyz);
+    std::vector<double> cost(nbxyz, 0.0);
+    for (int i = 0; i < nbxyz; i++) {
+        cost[i] = nw_on_bcell[i] * (nw_on_bcell[i] + 1.0);
+    }
+
+    // (2) cut the Z-order curve of the big cells by cost.
+    std::vector<int> order;
+    std::vector<int> owner;
+    Grid_Partition::partition_bigcells(cost, nbx, nby, nbz, nproc, order, owner);
+
+    // the processor owning the FFT planes of each ibz
+    std::vector<int> zstart_all(nproc, 0);
+    std::vector<int> nz_all(nproc, 0);
+    MPI_Allgather(&nbzp_start, 1, MPI_INT, zstart_all.data(), 1, MPI_INT, POOL_WORLD);
+    MPI_Allgather(&nbzp, 1, MPI_INT, nz_all.data(), 1, MPI_INT, POOL_WORLD);
+    std::vector<int> z_owner(nbz, 0);
+    for (int ip = 0; ip < nproc; ip++) {
+        for (int ibz = zstart_all[ip]; ibz < zstart_all[ip] + nz_all[ip]; ibz++) {
+            z_owner[ibz] = ip;
+        }
+    }
+
+    std::vector<int> fft_owner(nbxyz, 0);
+    for (int i = 0; i < nbxyz; i++) {
+        fft_owner[i] = z_owner[i % nbz];
+    }
+    ModuleBase::GlobalFunc::OUT(GlobalV::ofs_running,
+                                "gint imbalance of FFT planes",
+                                Grid_Partition::imbalance(cost, fft_owner, nproc));
+    ModuleBase::GlobalFunc::OUT(GlobalV::ofs_running,
+                                "gint imbalance of balanced big cells",
+                                Grid_Partition::imbalance(cost, owner, nproc));
+
+    // (3) the local big cells in the order of the curve.
+    this->balanced_cells.clear();
+    for (int k = 0; k < nbxyz; k++) {
+        if (owner[order[k]] == rank) {
+            this->balanced_cells.push_back(order[k]);
+        }
+    }
+    this->nbxx = this->balanced_cells.size();
+
+    // (4) the plan of the all-to-all. The owners are non-decreasing along
+    // the curve, so the big cells sent are already grouped by destination;
+    // both sides keep the order of the curve inside each group.
+    this->fft_ny = ny;
+    this->fft_nplane = nplane;
+    const int nbyz = nby * nbz;
+    this->fft_send_ind.clear();
+    this->fft_send_count.assign(nproc, 0);
+    for (int k = 0; k < nbxyz; k++) {
+        const int i = order[k];
+        if (fft_owner[i] != rank) {
+            continue;
+        }
+        const int ibx = i / nbyz;
+        const int iby = (i - ibx * nbyz) / nbz;
+        const int ibz = i % nbz;
+        this->fft_send_ind.push_back(ibz * this->bz - startz_current + iby * this->by * nplane
+                                     + ibx * this->bx * ny * nplane);
+        ++this->fft_send_count[owner[i]];
+    }
+
+    this->gint_recv_count.assign(nproc, 0);
+    for (int i = 0; i < nbxx; i++) {
+        ++this->gint_recv_count[fft_owner[this->balanced_cells[i]]];
+    }
+    std::vector<int> displ(nproc, 0);
+    for (int ip = 1; ip < nproc; ip++) {
+        displ[ip] = displ[ip - 1] + this->gint_recv_count[ip - 1];
+    }
+    this->gint_recv_ind.resize(nbxx);
+    for (int i = 0; i < nbxx; i++) {
+        this->gint_recv_ind[displ[fft_owner[this->balanced_cells[i]]]++] = i;
+    }
+
+    ModuleBase::Memory::record("GT::balanced_cells", sizeof(int) * (2 * nbxx + this->fft_send_ind.size()));
+    this->balanced = true;
+    ModuleBase::timer::tick("Grid_Technique", "init_balanced_bigcells");
+#endif
+    return;
+}
+
+void Grid_Technique::fft_to_gint(const double* fft, double* gint) const {
+#ifdef __MPI
+    ModuleBase::timer::tick("Grid_Technique", "fft_to_gint");
+    const int nproc = GlobalV::NPROC_IN_POOL;
+    const int nsend = this->fft_send_ind.size();
+    const int ncyz = this->fft_ny * this->fft_nplane;
+    std::vector<double> sendbuf(static_cast<size_t>(nsend) * bxyz);
+    std::vector<double> recvbuf(static_cast<size_t>(nbxx) * bxyz);
+
+#pragma omp parallel for
+    for (int c = 0; c < nsend; c++) {
+        double* block = sendbuf.data() + static_cast<size_t>(c) * bxyz;
+        for (int ii = 0; ii < bx; ii++) {
+            for (int jj = 0; jj < by; jj++) {
+                const double* line = fft + this->fft_send_ind[c] + ii * ncyz + jj * this->fft_nplane;
+                std::copy(line, line + bz, block + (ii * by + jj) * bz);
+            }
+        }
+    }
+
+    std::vector<int> scount(nproc), sdispl(nproc), rcount(nproc), rdispl(nproc);
+    for (int ip = 0; ip < nproc; ip++) {
+        scount[ip] = this->fft_send_count[ip] * bxyz;
+        rcount[ip] = this->gint_recv_count[ip] * bxyz;
+        sdispl[ip] = (ip == 0) ? 0 : sdispl[ip - 1] + scount[ip - 1];
+        rdispl[ip] = (ip == 0) ? 0 : rdispl[ip - 1] + rcount[ip - 1];
+    }
+    MPI_Alltoallv(sendbuf.data(), scount.data(), sdispl.data(), MPI_DOUBLE,
+                  recvbuf.data(), rcount.data(), rdispl.data(), MPI_DOUBLE, POOL_WORLD);
+
+#pragma omp parallel for
+    for (int c = 0; c < nbxx; c++) {
+        const double* block = recvbuf.data() + static_cast<size_t>(c) * bxyz;
+        std::copy(block, block + bxyz, gint + static_cast<size_t>(this->gint_recv_ind[c]) * bxyz);
+    }
+    ModuleBase::timer::tick("Grid_Technique", "fft_to_gint");
+#endif
+}
+
+void Grid_Technique::gint_to_fft_add(const double* gint, double* fft) const {
+#ifdef __MPI
+    ModuleBase::timer::tick("Grid_Technique", "gint_to_fft_add");
+    const int nproc = GlobalV::NPROC_IN_POOL;
+    const int nrecv = this->fft_send_ind.size();
+    const int ncyz = this->fft_ny * this->fft_nplane;
+    std::vector<double> sendbuf(static_cast<size_t>(nbxx) * bxyz);
+    std::vector<double> recvbuf(static_cast<size_t>(nrecv) * bxyz);
+
+#pragma omp parallel for
+    for (int c = 0; c < nbxx; c++) {
+        const double* block = gint + static_cast<size_t>(this->gint_recv_ind[c]) * bxyz;
+        std::copy(block, block + bxyz, sendbuf.data() + static_cast<size_t>(c) * bxyz);
+    }
+
+    std::vector<int> scount(nproc), sdispl(nproc), rcount(nproc), rdispl(nproc);
+    for (int ip = 0; ip < nproc; ip++) {
+        scount[ip] = this->gint_recv_count[ip] * bxyz;
+        rcount[ip] = this->fft_send_count[ip] * bxyz;
+        sdispl[ip] = (ip == 0) ? 0 : sdispl[ip - 1] + scount[ip - 1];
+        rdispl[ip] = (ip == 0) ? 0 : rdispl[ip - 1] + rcount[ip - 1];
+    }
+    MPI_Alltoallv(sendbuf.data(), scount.data(), sdispl.data(), MPI_DOUBLE,
+                  recvbuf.data(), rcount.data(), rdispl.data(), MPI_DOUBLE, POOL_WORLD);
+
+    // each point of the FFT planes belongs to exactly one big cell
+#pragma omp parallel for
+    for (int c = 0; c < nrecv; c++) {
+        const double* block = recvbuf.data() + static_cast<size_t>(c) * bxyz;
+        for (int ii = 0; ii < bx; ii++) {
+            for (int jj = 0; jj < by; jj++) {
+                double* line = fft + this->fft_send_ind[c] + ii * ncyz + jj * this->fft_nplane;
+                const double* src = block + (ii * by + jj) * bz;
+                for (int kk = 0; kk < bz; kk++) {
+                    line[kk] += src[kk];
+                }
+            }
+        }
+    }
+    ModuleBase::timer::tick("Grid_Technique", "gint_to_fft_add");
+#endif
+}
+
 void Grid_Technique::init_atoms_on_grid2(const int* index2normal,
                                          const UnitCell& ucell) {
     ModuleBase::TITLE("Grid_Techinique", "init_atoms_on_grid2");
@@ -395,24 +621,7 @@ void Grid_Technique::init_atoms_on_grid2(const int* index2normal,
                 continue;
             }
             
-            bool is_atom_on_bcell = false;
-            const double dr_x_part = this->meshball_positions[im][0] - this->tau_in_bigcell[iat][0];
-            const double dr_y_part = this->meshball_positions[im][1] - this->tau_in_bigcell[iat][1];
-            const double dr_z_part = this->meshball_positions[im][2] - this->tau_in_bigcell[iat][2];
-            for(int imcell = 0; imcell < this -> bxyz; imcell++)
-            {
-                const double dr_x = this->meshcell_pos[imcell][0] + dr_x_part;
-                const double dr_y = this->meshcell_pos[imcell][1] + dr_y_part;
-                const double dr_z = this->meshcell_pos[imcell][2] + dr_z_part;
-                const double dist_square = dr_x * dr_x + dr_y * dr_y + dr_z * dr_z;
-                if(dist_square <= rcut_square)
-                {
-                    is_atom_on_bcell = true;
-                    break;
-                }
-            }
-
-            if(is_atom_on_bcell)
+            if(this->is_atom_on_bcell(iat, im, rcut_square))
             {
             // it's not the normal order to calculate which_atom
             // and which_bigcell, especailly in 1D array.
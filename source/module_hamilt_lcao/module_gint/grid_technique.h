@@ -60,6 +60,20 @@ class Grid_Technique : public Grid_MeshBall {
     std::vector<int> trace_iat;
     std::vector<int> trace_lo; // trace local orbital.
 
+    //------------------------------------
+    // 4: big cells balanced by cost (gint_balance).
+    //------------------------------------
+    // if true, the big cells of this processor are chosen by their cost
+    // instead of its FFT planes, and start_ind points into the Gint layout,
+    // where each local big cell is a contiguous block of bxyz points
+    // ordered as (ix, iy, iz) -> ix * by * bz + iy * bz + iz.
+    bool balanced = false;
+
+    // move a function on the real space grid from the FFT layout to the Gint layout.
+    void fft_to_gint(const double* fft, double* gint) const;
+    // add a function in the Gint layout to the FFT layout.
+    void gint_to_fft_add(const double* gint, double* fft) const;
+
     //---------------------------------------
     // nnrg: number of matrix elements on
     // each processor's real space grid.
@@ -129,6 +143,20 @@ class Grid_Technique : public Grid_MeshBall {
     // The meaning of ijr can be referred to in the get_ijr_info function in hcontainer.cpp.
     std::vector<int> ijr_info;
 
+    // global index of the local big cells in the balanced distribution.
+    std::vector<int> balanced_cells;
+    // FFT index of the first point of the big cells on the FFT planes
+    // of this processor, grouped by the processor integrating them.
+    std::vector<int> fft_send_ind;
+    std::vector<int> fft_send_count;
+    // local index of the big cells of this processor,
+    // grouped by the processor owning their FFT planes.
+    std::vector<int> gint_recv_ind;
+    std::vector<int> gint_recv_count;
+    // the FFT planes of this processor: ny * nplane points per x
+    int fft_ny = 0;
+    int fft_nplane = 0;
+
     void cal_max_box_index();
     // atoms on meshball
     void init_atoms_on_grid(const int& ny,
@@ -141,6 +169,14 @@ class Grid_Technique : public Grid_MeshBall {
     void cal_grid_integration_index();
     void cal_trace_lo(const UnitCell& ucell);
     void check_bigcell(int* ind_bigcell, char* bigcell_on_processor);
+    // if the orbitals of atom iat reach the big cell im of its meshball
+    bool is_atom_on_bcell(const int iat, const int im, const double rcut_square) const;
+    // distribute the big cells by cost and set up the all-to-all plan
+    void init_balanced_bigcells(const int* index2normal,
+                                const int& ny,
+                                const int& nplane,
+                                const int& startz_current,
+                                const UnitCell& ucell);
     void get_startind(const int& ny,
                       const int& nplane,
                       const int& startz_current);
@@ -0,0 +1,163 @@
+#include "../gint_atom_grid.h"
+
+#include "module_base/constants.h"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <vector>
+
+/************************************************
+ *  unit test of gint_atom_grid
+ ***********************************************/
+
+/**
+ * - Tested Functions:
+ *  - quadrature(): radial and angular grids integrate a Gaussian of one center
+ *  - partition_weight(): the weights of all centers sum to 1, a molecular integral is exact
+ *  - batches(): every point is in one batch of at most m_thr points
+ */
+
+namespace
+{
+// three centers as in a water molecule, in Bohr
+const std::vector<double> centers = {0.0, 0.0, 0.0, 1.43, 1.11, 0.0, -1.43, 1.11, 0.0};
+
+double distance(const double* a, const double* b)
+{
+    return std::sqrt((a[0] - b[0]) * (a[0] - b[0]) + (a[1] - b[1]) * (a[1] - b[1]) + (a[2] - b[2]) * (a[2] - b[2]));
+}
+
+// weight of center c at point r, the centers are reordered to put c first
+double weight(const int c, const double* r)
+{
+    const int nc = centers.size() / 3;
+    std::vector<int> order(nc);
+    std::iota(order.begin(), order.end(), 0);
+    std::swap(order[0], order[c]);
+    std::vector<double> drR(nc);
+    std::vector<double> dRR(nc * nc, 0.0);
+    std::vector<double> drR_thr(nc, 1.0e10);
+    for (int a = 0; a < nc; ++a)
+    {
+        drR[a] = distance(r, &centers[3 * order[a]]);
+        for (int b = 0; b < nc; ++b)
+        {
+            if (a != b)
+            {
+                dRR[a * nc + b] = distance(&centers[3 * order[a]], &centers[3 * order[b]]);
+                drR_thr[a] = std::min(drR_thr[a], Gint_Atom_Grid::exclusive_radius(dRR[a * nc + b]));
+            }
+        }
+    }
+    return Gint_Atom_Grid::partition_weight(nc, drR.data(), dRR.data(), drR_thr.data());
+}
+} // namespace
+
+TEST(GintAtomGridTest, Quadrature)
+{
+    int lmax = 20;
+    std::vector<double> r_rad, w_rad, r_ang, w_ang;
+    ASSERT_TRUE(Gint_Atom_Grid::quadrature(60, lmax, r_rad, w_rad, r_ang, w_ang));
+    EXPECT_EQ(lmax, 23);
+    EXPECT_EQ(w_ang.size(), 194);
+    EXPECT_NEAR(std::accumulate(w_ang.begin(), w_ang.end(), 0.0), ModuleBase::FOUR_PI, 1e-12);
+
+    // \int exp(-r^2) (1 + z^2) d^3r = pi^{3/2} (1 + 1/2)
+    double sum = 0.0;
+    for (int ir = 0; ir < r_rad.size(); ++ir)
+    {
+        for (int ia = 0; ia < w_ang.size(); ++ia)
+        {
+            const double z = r_rad[ir] * r_ang[3 * ia + 2];
+            sum += w_rad[ir] * w_ang[ia] * std::exp(-r_rad[ir] * r_rad[ir]) * (1.0 + z * z);
+        }
+    }
+    EXPECT_NEAR(sum, 1.5 * std::pow(ModuleBase::PI, 1.5), 1e-8);
+
+    lmax = 100;
+    EXPECT_FALSE(Gint_Atom_Grid::quadrature(60, lmax, r_rad, w_rad, r_ang, w_ang));
+}
+
+TEST(GintAtomGridTest, PartitionWeight)
+{
+    const int nc = centers.size() / 3;
+    const std::vector<double> points = {0.1, 0.2, 0.3, 0.7, 0.6, 0.0, 0.0, 1.5, 0.2, -3.0, 2.0, 1.0, 0.01, -0.02, 0.0};
+    for (int ip = 0; ip < points.size() / 3; ++ip)
+    {
+        double sum = 0.0;
+        for (int c = 0; c < nc; ++c)
+        {
+            const double w = weight(c, &points[3 * ip]);
+            EXPECT_GE(w, 0.0);
+            EXPECT_LE(w, 1.0);
+            sum += w;
+        }
+        EXPECT_NEAR(sum, 1.0, 1e-12);
+    }
+    // close to the first center, inside its exclusive zone
+    EXPECT_DOUBLE_EQ(weight(0, &points[12]), 1.0);
+
+    // a Gaussian on each center, integrated on the partitioned grids of all centers
+    int lmax = 29;
+    std::vector<double> r_rad, w_rad, r_ang, w_ang;
+    ASSERT_TRUE(Gint_Atom_Grid::quadrature(75, lmax, r_rad, w_rad, r_ang, w_ang));
+    double sum = 0.0;
+    for (int c = 0; c < nc; ++c)
+    {
+        for (int ir = 0; ir < r_rad.size(); ++ir)
+        {
+            for (int ia = 0; ia < w_ang.size(); ++ia)
+            {
+                const double r[3] = {centers[3 * c] + r_rad[ir] * r_ang[3 * ia],
+                                     centers[3 * c + 1] + r_rad[ir] * r_ang[3 * ia + 1],
+                                     centers[3 * c + 2] + r_rad[ir] * r_ang[3 * ia + 2]};
+                double f = 0.0;
+                for (int a = 0; a < nc; ++a)
+                {
+                    const double d = distance(r, &centers[3 * a]);
+                    f += std::exp(-d * d);
+                }
+                sum += w_rad[ir] * w_ang[ia] * weight(c, r) * f;
+            }
+        }
+    }
+    EXPECT_NEAR(sum, nc * std::pow(ModuleBase::PI, 1.5), 1e-5);
+}
+
+TEST(GintAtomGridTest, Batches)
+{
+    int lmax = 11;
+    std::vector<double> r_rad, w_rad, r_ang, w_ang;
+    ASSERT_TRUE(Gint_Atom_Grid::quadrature(20, lmax, r_rad, w_rad, r_ang, w_ang));
+    std::vector<double> grid;
+    for (int ir = 0; ir < r_rad.size(); ++ir)
+    {
+        for (int ia = 0; ia < w_ang.size(); ++ia)
+        {
+            for (int d = 0; d < 3; ++d)
+            {
+                grid.push_back(r_rad[ir] * r_ang[3 * ia + d]);
+            }
+        }
+    }
+    const int m = grid.size() / 3;
+    std::vector<int> idx(m);
+    std::iota(idx.begin(), idx.end(), 0);
+    std::vector<int> starts = Gint_Atom_Grid::batches(grid.data(), idx.data(), m, 64);
+    ASSERT_GT(starts.size(), 1);
+    EXPECT_EQ(starts[0], 0);
+    starts.push_back(m);
+    for (int ib = 0; ib + 1 < starts.size(); ++ib)
+    {
+        EXPECT_GT(starts[ib + 1] - starts[ib], 0);
+        EXPECT_LE(starts[ib + 1] - starts[ib], 64);
+    }
+    std::sort(idx.begin(), idx.end());
+    for (int i = 0; i < m; ++i)
+    {
+        EXPECT_EQ(idx[i], i);
+    }
+}
@@ -0,0 +1,200 @@
+#include "../gint_atom_grid.h"
+#include "module_hamilt_general/module_xc/exx_info.h"
+#include "module_hamilt_general/module_xc/xc_functional.h"
+
+#include "gtest/gtest.h"
+
+#include <cmath>
+#include <numeric>
+#include <vector>
+
+/************************************************
+ *  unit test of the XC energy on the atom grids
+ ***********************************************/
+
+/**
+ * - Tested Functions:
+ *  - the LDA E_xc and \int v_xc rho of a water molecule, integrated on the partitioned atom grids
+ *    as in VxcAtom::cal_vxc(), agree with those of a uniform grid as in XC_Functional::v_xc()
+ *    - nspin 1 and 2
+ */
+
+namespace ModuleBase
+{
+void WARNING_QUIT(const std::string& file, const std::string& description)
+{
+    exit(1);
+}
+} // namespace ModuleBase
+
+namespace GlobalV
+{
+std::string BASIS_TYPE = "";
+bool CAL_STRESS = false;
+int CAL_FORCE = 0;
+int NSPIN = 1;
+} // namespace GlobalV
+
+namespace GlobalC
+{
+Exx_Info exx_info;
+}
+
+namespace
+{
+// water molecule in Bohr, O first
+const std::vector<double> centers = {0.0, 0.0, 0.0, 1.43, 1.11, 0.0, -1.43, 1.11, 0.0};
+
+double distance(const double* a, const double* b)
+{
+    return std::sqrt((a[0] - b[0]) * (a[0] - b[0]) + (a[1] - b[1]) * (a[1] - b[1]) + (a[2] - b[2]) * (a[2] - b[2]));
+}
+
+// normalized Gaussian of exponent alpha on the center c
+double gauss(const double alpha, const int c, const double* r)
+{
+    const double d = distance(r, &centers[3 * c]);
+    return std::pow(alpha / M_PI, 1.5) * std::exp(-alpha * d * d);
+}
+
+// smooth valence densities of 8 electrons, the up spin carries one more electron around O
+void density(const double* r, double& up, double& dw)
+{
+    const double rho = 3.0 * gauss(0.8, 0, r) + 3.0 * gauss(2.5, 0, r) + gauss(1.2, 1, r) + gauss(1.2, 2, r);
+    const double mag = gauss(0.8, 0, r);
+    up = 0.5 * (rho + mag);
+    dw = 0.5 * (rho - mag);
+}
+
+// E_xc and \int v_xc rho of one point of weight w, as in VxcAtom::cal_vxc()
+void lda(const int nspin, const double w, const double up, const double dw, double& etxc, double& vtxc)
+{
+    const double e2 = 2.0;
+    const double vanishing_charge = 1.0e-10;
+    const double rhox = up + dw;
+    if (std::abs(rhox) <= vanishing_charge)
+    {
+        return;
+    }
+    double exc = 0.0;
+    if (nspin == 1)
+    {
+        double vxc = 0.0;
+        XC_Functional::xc(rhox, exc, vxc);
+        vtxc += w * e2 * vxc * rhox;
+    }
+    else
+    {
+        double vxc[2] = {0.0, 0.0};
+        XC_Functional::xc_spin(rhox, (up - dw) / rhox, exc, vxc[0], vxc[1]);
+        vtxc += w * e2 * (vxc[0] * up + vxc[1] * dw);
+    }
+    etxc += w * e2 * exc * rhox;
+}
+
+// the atom grids of Gint_Atom with the default atom_grid_nrad and atom_grid_lmax
+void atom_grids(const int nspin, double& nelec, double& etxc, double& vtxc)
+{
+    const int nc = centers.size() / 3;
+    int lmax = 29;
+    std::vector<double> r_rad, w_rad, r_ang, w_ang;
+    ASSERT_TRUE(Gint_Atom_Grid::quadrature(75, lmax, r_rad, w_rad, r_ang, w_ang));
+    nelec = etxc = vtxc = 0.0;
+    for (int c = 0; c < nc; ++c)
+    {
+        // the center of the grid first
+        std::vector<int> order(nc);
+        std::iota(order.begin(), order.end(), 0);
+        std::swap(order[0], order[c]);
+        std::vector<double> dRR(nc * nc, 0.0);
+        std::vector<double> drR_thr(nc, 1.0e10);
+        for (int a = 0; a < nc; ++a)
+        {
+            for (int b = 0; b < nc; ++b)
+            {
+                if (a != b)
+                {
+                    dRR[a * nc + b] = distance(&centers[3 * order[a]], &centers[3 * order[b]]);
+                    drR_thr[a] = std::min(drR_thr[a], Gint_Atom_Grid::exclusive_radius(dRR[a * nc + b]));
+                }
+            }
+        }
+        std::vector<double> drR(nc);
+        for (int ir = 0; ir < r_rad.size(); ++ir)
+        {
+            for (int ia = 0; ia < w_ang.size(); ++ia)
+            {
+                const double r[3] = {centers[3 * c] + r_rad[ir] * r_ang[3 * ia],
+                                     centers[3 * c + 1] + r_rad[ir] * r_ang[3 * ia + 1],
+                                     centers[3 * c + 2] + r_rad[ir] * r_ang[3 * ia + 2]};
+                for (int a = 0; a < nc; ++a)
+                {
+                    drR[a] = distance(r, &centers[3 * order[a]]);
+                }
+                const double w = w_rad[ir] * w_ang[ia]
+                                 * Gint_Atom_Grid::partition_weight(nc, drR.data(), dRR.data(), drR_thr.data());
+                double up = 0.0;
+                double dw = 0.0;
+                density(r, up, dw);
+                nelec += w * (up + dw);
+                lda(nspin, w, up, dw, etxc, vtxc);
+            }
+        }
+    }
+}
+
+// a uniform grid in a cubic cell of side 16 Bohr, as the FFT grid with ecutrho of about 630 Ry
+void uniform_grid(const int nspin, double& nelec, double& etxc, double& vtxc)
+{
+    const int n = 128;
+    const double a = 16.0;
+    const double h = a / n;
+    const double dv = h * h * h;
+    nelec = etxc = vtxc = 0.0;
+    for (int i = 0; i < n; ++i)
+    {
+        for (int j = 0; j < n; ++j)
+        {
+            for (int k = 0; k < n; ++k)
+            {
+                const double r[3] = {-0.5 * a + i * h, -0.5 * a + j * h, -0.5 * a + k * h};
+                double up = 0.0;
+                double dw = 0.0;
+                density(r, up, dw);
+                nelec += dv * (up + dw);
+                lda(nspin, dv, up, dw, etxc, vtxc);
+            }
+        }
+    }
+}
+} // namespace
+
+class GintAtomXcTest : public testing::TestWithParam<int>
+{
+  protected:
+    void SetUp() override
+    {
+        XC_Functional::set_xc_type("PZ");
+    }
+};
+
+TEST_P(GintAtomXcTest, Water)
+{
+    const int nspin = GetParam();
+    GlobalV::NSPIN = nspin;
+    ASSERT_EQ(XC_Functional::get_func_type(), 1);
+
+    double nelec_atom = 0.0, etxc_atom = 0.0, vtxc_atom = 0.0;
+    atom_grids(nspin, nelec_atom, etxc_atom, vtxc_atom);
+    double nelec_fft = 0.0, etxc_fft = 0.0, vtxc_fft = 0.0;
+    uniform_grid(nspin, nelec_fft, etxc_fft, vtxc_fft);
+
+    EXPECT_NEAR(nelec_atom, 8.0, 1e-5);
+    EXPECT_NEAR(nelec_fft, 8.0, 1e-5);
+    // E_xc of this density is about -9.5 Ry
+    EXPECT_LT(etxc_atom, -9.0);
+    EXPECT_NEAR(etxc_atom, etxc_fft, 1e-5);
+    EXPECT_NEAR(vtxc_atom, vtxc_fft, 1e-5);
+}
+
+INSTANTIATE_TEST_SUITE_P(Nspin, GintAtomXcTest, testing::Values(1, 2));
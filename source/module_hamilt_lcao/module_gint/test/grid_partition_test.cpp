@@ -0,0 +1,145 @@
+#include "../grid_partition.h"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <set>
+#include <vector>
+
+/************************************************
+ *  unit test of grid_partition
+ ***********************************************/
+
+/**
+ * - Tested Functions:
+ *  - morton_key(): interleaved bits of (ix, iy, iz)
+ *  - partition_bigcells(): big cells cut into pieces of equal cost along the Z-order curve
+ *  - imbalance(): the largest cost of one processor over the average
+ */
+
+class GridPartitionTest : public testing::Test
+{
+  protected:
+    const int nbx = 6;
+    const int nby = 5;
+    const int nbz = 12;
+
+    // atoms only in the lower quarter of z, as in a slab with vacuum
+    std::vector<double> slab_cost()
+    {
+        std::vector<double> cost(nbx * nby * nbz, 0.0);
+        for (int ibx = 0; ibx < nbx; ++ibx)
+        {
+            for (int iby = 0; iby < nby; ++iby)
+            {
+                for (int ibz = 0; ibz < nbz / 4; ++ibz)
+                {
+                    cost[ibx * nby * nbz + iby * nbz + ibz] = 1.0 + (ibx + iby + ibz) % 3;
+                }
+            }
+        }
+        return cost;
+    }
+};
+
+TEST_F(GridPartitionTest, MortonKey)
+{
+    EXPECT_EQ(Grid_Partition::morton_key(0, 0, 0), 0);
+    EXPECT_EQ(Grid_Partition::morton_key(0, 0, 1), 1);
+    EXPECT_EQ(Grid_Partition::morton_key(0, 1, 0), 2);
+    EXPECT_EQ(Grid_Partition::morton_key(1, 0, 0), 4);
+    EXPECT_EQ(Grid_Partition::morton_key(1, 1, 1), 7);
+    EXPECT_EQ(Grid_Partition::morton_key(0, 0, 2), 8);
+    // bits 011 101 110
+    EXPECT_EQ(Grid_Partition::morton_key(3, 5, 6), 238);
+}
+
+TEST_F(GridPartitionTest, OrderIsPermutation)
+{
+    std::vector<int> order;
+    std::vector<int> owner;
+    Grid_Partition::partition_bigcells(slab_cost(), nbx, nby, nbz, 4, order, owner);
+    ASSERT_EQ(order.size(), nbx * nby * nbz);
+    ASSERT_EQ(owner.size(), nbx * nby * nbz);
+    std::set<int> cells(order.begin(), order.end());
+    EXPECT_EQ(cells.size(), nbx * nby * nbz);
+    EXPECT_EQ(*cells.begin(), 0);
+    EXPECT_EQ(*cells.rbegin(), nbx * nby * nbz - 1);
+}
+
+TEST_F(GridPartitionTest, ContiguousAlongCurve)
+{
+    const int nproc = 7;
+    std::vector<int> order;
+    std::vector<int> owner;
+    Grid_Partition::partition_bigcells(slab_cost(), nbx, nby, nbz, nproc, order, owner);
+    for (int k = 1; k < order.size(); ++k)
+    {
+        EXPECT_LE(owner[order[k - 1]], owner[order[k]]);
+    }
+    EXPECT_EQ(owner[order[0]], 0);
+    for (int i = 0; i < owner.size(); ++i)
+    {
+        EXPECT_GE(owner[i], 0);
+        EXPECT_LT(owner[i], nproc);
+    }
+}
+
+TEST_F(GridPartitionTest, BalanceSlab)
+{
+    const std::vector<double> cost = slab_cost();
+    const double cmax = *std::max_element(cost.begin(), cost.end());
+    for (int nproc = 2; nproc <= 8; ++nproc)
+    {
+        std::vector<int> order;
+        std::vector<int> owner;
+        Grid_Partition::partition_bigcells(cost, nbx, nby, nbz, nproc, order, owner);
+        double total = 0.0;
+        std::vector<double> cost_proc(nproc, 0.0);
+        for (int i = 0; i < cost.size(); ++i)
+        {
+            cost_proc[owner[i]] += cost[i];
+            total += cost[i];
+        }
+        // each processor is within one big cell of its share
+        for (int ip = 0; ip < nproc; ++ip)
+        {
+            EXPECT_LE(std::abs(cost_proc[ip] - total / nproc), cmax) << "nproc = " << nproc;
+        }
+
+        // the same cells cut by z planes, as the FFT does
+        std::vector<int> slab_owner(cost.size());
+        for (int i = 0; i < cost.size(); ++i)
+        {
+            slab_owner[i] = (i % nbz) * nproc / nbz;
+        }
+        EXPECT_LT(Grid_Partition::imbalance(cost, owner, nproc), Grid_Partition::imbalance(cost, slab_owner, nproc));
+    }
+}
+
+TEST_F(GridPartitionTest, ZeroCost)
+{
+    const int nproc = 5;
+    std::vector<double> cost(nbx * nby * nbz, 0.0);
+    std::vector<int> order;
+    std::vector<int> owner;
+    Grid_Partition::partition_bigcells(cost, nbx, nby, nbz, nproc, order, owner);
+    std::vector<int> count(nproc, 0);
+    for (int i = 0; i < owner.size(); ++i)
+    {
+        ++count[owner[i]];
+    }
+    for (int ip = 0; ip < nproc; ++ip)
+    {
+        EXPECT_EQ(count[ip], nbx * nby * nbz / nproc);
+    }
+    EXPECT_DOUBLE_EQ(Grid_Partition::imbalance(cost, owner, nproc), 1.0);
+}
+
+TEST_F(GridPartitionTest, Imbalance)
+{
+    const std::vector<double> cost = {1.0, 1.0, 2.0, 4.0};
+    EXPECT_DOUBLE_EQ(Grid_Partition::imbalance(cost, {0, 0, 1, 1}, 2), 1.5);
+    EXPECT_DOUBLE_EQ(Grid_Partition::imbalance(cost, {0, 0, 0, 1}, 2), 1.0);
+    EXPECT_DOUBLE_EQ(Grid_Partition::imbalance(cost, {0, 0, 0, 0}, 1), 1.0);
+}
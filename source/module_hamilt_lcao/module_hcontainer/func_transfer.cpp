@@ -586,6 +586,32 @@ void transferParallels2Serials(const hamilt::HContainer<TR>& hR_p, hamilt::HCont
 
 }
 
+// transferSerials2Parallels with a cached plan
+template <typename TR>
+void transferSerials2Parallels(const hamilt::HContainer<TR>& hR_s,
+                               hamilt::HContainer<TR>* hR_p,
+                               std::unique_ptr<hamilt::HTransferPlan<TR>>& plan)
+{
+    if (plan == nullptr || !plan->is_valid(&hR_s, hR_p))
+    {
+        plan.reset(new hamilt::HTransferPlan<TR>(const_cast<hamilt::HContainer<TR>*>(&hR_s), hR_p));
+    }
+    plan->serials2parallels();
+}
+
+// transferParallels2Serials with a cached plan
+template <typename TR>
+void transferParallels2Serials(const hamilt::HContainer<TR>& hR_p,
+                               hamilt::HContainer<TR>* hR_s,
+                               std::unique_ptr<hamilt::HTransferPlan<TR>>& plan)
+{
+    if (plan == nullptr || !plan->is_valid(hR_s, &hR_p))
+    {
+        plan.reset(new hamilt::HTransferPlan<TR>(hR_s, const_cast<hamilt::HContainer<TR>*>(&hR_p)));
+    }
+    plan->parallels2serials();
+}
+
 template<typename TR>
 void gatherParallels(const hamilt::HContainer<TR>& hR_p,
                      hamilt::HContainer<TR>* hR_s,
@@ -651,6 +677,18 @@ template void transferParallels2Serials(const hamilt::HContainer<double>& hR_p,
                                         hamilt::HContainer<double>* hR_s);
 template void transferParallels2Serials(const hamilt::HContainer<std::complex<double>>& hR_p,
                                         hamilt::HContainer<std::complex<double>>* hR_s);
+template void transferSerials2Parallels(const hamilt::HContainer<double>& hR_s,
+                                        hamilt::HContainer<double>* hR_p,
+                                        std::unique_ptr<hamilt::HTransferPlan<double>>& plan);
+template void transferSerials2Parallels(const hamilt::HContainer<std::complex<double>>& hR_s,
+                                        hamilt::HContainer<std::complex<double>>* hR_p,
+                                        std::unique_ptr<hamilt::HTransferPlan<std::complex<double>>>& plan);
+template void transferParallels2Serials(const hamilt::HContainer<double>& hR_p,
+                                        hamilt::HContainer<double>* hR_s,
+                                        std::unique_ptr<hamilt::HTransferPlan<double>>& plan);
+template void transferParallels2Serials(const hamilt::HContainer<std::complex<double>>& hR_p,
+                                        hamilt::HContainer<std::complex<double>>* hR_s,
+                                        std::unique_ptr<hamilt::HTransferPlan<std::complex<double>>>& plan);
 template void gatherParallels(const hamilt::HContainer<double>& hR_p,
                               hamilt::HContainer<double>* hR_s,
                               const int serial_rank);
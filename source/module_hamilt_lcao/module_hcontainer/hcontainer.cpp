@@ -1,5 +1,7 @@
 #include "hcontainer.h"
 
+#include "module_base/memory.h"
+
 namespace hamilt
 {
 
@@ -12,6 +14,7 @@ HContainer<T>::~HContainer()
 {
     if(this->allocated)
     {
+        ModuleBase::Memory::track_free(this->wrapper_pointer);
         delete[] this->wrapper_pointer;
     }
 }
@@ -151,6 +154,7 @@ void HContainer<T>::allocate(T* data_array, bool is_zero)
     size_t nnr = this->get_nnr();
     if(this->allocated)
     {// delete existed memory of this->wrapper_pointer
+        ModuleBase::Memory::track_free(this->wrapper_pointer);
         delete[] this->wrapper_pointer;
         this->allocated = false;
     }
@@ -159,6 +163,7 @@ void HContainer<T>::allocate(T* data_array, bool is_zero)
         // use this->wrapper_pointer as data_array
         this->allocated = true;
         this->wrapper_pointer = new T[nnr];
+        ModuleBase::Memory::track_alloc(this->wrapper_pointer, nnr * sizeof(T));
         ModuleBase::GlobalFunc::ZEROS(this->wrapper_pointer, nnr);
         data_array = this->wrapper_pointer;
     }
@@ -1,6 +1,9 @@
 #pragma once
 
 #include "module_hamilt_lcao/module_hcontainer/hcontainer.h"
+#include "module_hamilt_lcao/module_hcontainer/transfer.h"
+
+#include <memory>
 
 namespace hamilt
 {
@@ -49,6 +52,8 @@ void transferParallels2Serial(const hamilt::HContainer<TR>& hR_p,
 
 /**
  * @brief transfer the HContainer from all serial objects to all parallel objects
+ * the indexes are exchanged on every call, repeated transfers on the same pattern should use the
+ * overload with a HTransferPlan below
  * @param hR_s the HContainer of <I,J,R> atom pairs in serial object
  * @param hR_p the HContainer of <I,J,R> atom pairs in parallel object
 */
@@ -57,7 +62,9 @@ void transferSerials2Parallels(const hamilt::HContainer<TR>& hR_s,
                              hamilt::HContainer<TR>* hR_p);
 
 /**
- * @brief transfer the HContainer from all serial objects to all parallel objects
+ * @brief transfer the HContainer from all parallel objects to all serial objects
+ * the indexes are exchanged on every call, repeated transfers on the same pattern should use the
+ * overload with a HTransferPlan below
  * @param hR_p the HContainer of <I,J,R> atom pairs in parallel object
  * @param hR_s the HContainer of <I,J,R> atom pairs in serial object
 */
@@ -65,6 +72,26 @@ template<typename TR>
 void transferParallels2Serials(const hamilt::HContainer<TR>& hR_p,
                              hamilt::HContainer<TR>* hR_s);
 
+/**
+ * @brief the same as transferSerials2Parallels(hR_s, hR_p), with a plan which is kept for the next calls
+ * the plan is made on the first call, and made again if it is not valid for hR_s and hR_p any more.
+ * Reset the plan when the <I,J,R> pattern changes, e.g. after a new neighbor search.
+ * @param plan the cached HTransferPlan, nullptr before the first call
+*/
+template<typename TR>
+void transferSerials2Parallels(const hamilt::HContainer<TR>& hR_s,
+                               hamilt::HContainer<TR>* hR_p,
+                               std::unique_ptr<hamilt::HTransferPlan<TR>>& plan);
+
+/**
+ * @brief the same as transferParallels2Serials(hR_p, hR_s), with a plan which is kept for the next calls
+ * @param plan the cached HTransferPlan, nullptr before the first call
+*/
+template<typename TR>
+void transferParallels2Serials(const hamilt::HContainer<TR>& hR_p,
+                               hamilt::HContainer<TR>* hR_s,
+                               std::unique_ptr<hamilt::HTransferPlan<TR>>& plan);
+
 /**
  * @brief gather the HContainer from all parallel objects to target serial object
  * the serial object should be empty before gather
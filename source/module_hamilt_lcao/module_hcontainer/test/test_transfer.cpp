@@ -2,6 +2,7 @@
 #include "../transfer.h"
 #include "../hcontainer.h"
 #include <chrono>
+#include <memory>
 #ifdef __MPI
 #include <mpi.h>
 #include "../hcontainer_funcs.h"
@@ -399,6 +400,85 @@ TEST_F(TransferTest, paraAllToserialAll)
 #endif
 }
 
+TEST_F(TransferTest, planRepeatedTransfer)
+{
+#ifdef __MPI
+    hamilt::HContainer<double> HR_serial(ucell);
+    auto set_serial = [&](const double scale) {
+        for (int i = 0; i < HR_serial.size_atom_pairs(); i++)
+        {
+            hamilt::AtomPair<double>& atom_pair = HR_serial.get_atom_pair(i);
+            int atom_i = atom_pair.get_atom_i();
+            int atom_j = atom_pair.get_atom_j();
+            double* data = atom_pair.get_pointer(0);
+            for (int k = 0; k < test_nw; k++)
+            {
+                for (int l = 0; l < test_nw; l++)
+                {
+                    *data++ = ((double(atom_i * test_nw + k) * test_size + atom_j) * test_nw + l) * scale;
+                }
+            }
+        }
+    };
+    // values of HR_para are the sum of HR_serial over all ranks
+    auto check_para = [&](const double scale) {
+        for (int i = 0; i < HR_para->size_atom_pairs(); i++)
+        {
+            hamilt::AtomPair<double>& atom_pair = HR_para->get_atom_pair(i);
+            int atom_i = atom_pair.get_atom_i();
+            int atom_j = atom_pair.get_atom_j();
+            double* data = atom_pair.get_pointer(0);
+            auto row_indexes = paraV->get_indexes_row(atom_i);
+            auto col_indexes = paraV->get_indexes_col(atom_j);
+            for (int k = 0; k < row_indexes.size(); k++)
+            {
+                for (int l = 0; l < col_indexes.size(); l++)
+                {
+                    const double value
+                        = ((double(atom_i * test_nw + row_indexes[k]) * test_size + atom_j) * test_nw + col_indexes[l]);
+                    EXPECT_NEAR(*data++, value * scale * dsize, 1e-10);
+                }
+            }
+        }
+    };
+
+    std::unique_ptr<hamilt::HTransferPlan<double>> plan;
+    // the plan is made in the first call and reused with new values in the next ones
+    for (int istep = 1; istep <= 3; ++istep)
+    {
+        set_serial(istep);
+        HR_para->set_zero();
+        hamilt::transferSerials2Parallels(HR_serial, HR_para, plan);
+        check_para(istep);
+    }
+    const hamilt::HTransferPlan<double>* plan_pointer = plan.get();
+    EXPECT_TRUE(plan->is_valid(&HR_serial, HR_para));
+
+    // the same plan in the other direction
+    HR_serial.set_zero();
+    hamilt::transferParallels2Serials(*HR_para, &HR_serial, plan);
+    EXPECT_EQ(plan.get(), plan_pointer);
+    for (int i = 0; i < HR_serial.size_atom_pairs(); i++)
+    {
+        hamilt::AtomPair<double>& atom_pair = HR_serial.get_atom_pair(i);
+        int atom_i = atom_pair.get_atom_i();
+        int atom_j = atom_pair.get_atom_j();
+        double* data = atom_pair.get_pointer(0);
+        for (int k = 0; k < test_nw; k++)
+        {
+            for (int l = 0; l < test_nw; l++)
+            {
+                EXPECT_NEAR(*data++, ((double(atom_i * test_nw + k) * test_size + atom_j) * test_nw + l) * 3 * dsize, 1e-10);
+            }
+        }
+    }
+
+    // another HContainer needs a new plan
+    hamilt::HContainer<double> HR_serial2(ucell);
+    EXPECT_FALSE(plan->is_valid(&HR_serial2, HR_para));
+#endif
+}
+
 int main(int argc, char** argv)
 {
 #ifdef __MPI
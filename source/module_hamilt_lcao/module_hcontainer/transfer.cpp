@@ -8,10 +8,26 @@
 #include <mpi.h>
 
 #include <algorithm>
+#include <functional>
 
 namespace hamilt
 {
 
+// append the segment [begin, begin+length) to segments, merged with the last one if they are contiguous
+template <typename T>
+static inline void push_segment(std::vector<T*>* begins, std::vector<long>* lengths, T* begin, const long length)
+{
+    if (!begins->empty() && begins->back() + lengths->back() == begin)
+    {
+        lengths->back() += length;
+    }
+    else
+    {
+        begins->push_back(begin);
+        lengths->push_back(length);
+    }
+}
+
 // ------------------------------------------------
 // HTransPara
 // ------------------------------------------------
@@ -296,6 +312,40 @@ void HTransPara<T>::get_value_size(int* out) const
     return;
 }
 
+template <typename T>
+void HTransPara<T>::cal_value_segments(int irank, std::vector<T*>* begins, std::vector<long>* lengths) const
+{
+    begins->clear();
+    lengths->clear();
+    if (this->size_values[irank] == 0)
+    {
+        return;
+    }
+    const int number_atom = this->ap_indexes[irank][0];
+    const int* ap_data = this->ap_indexes[irank].data() + 1;
+    for (int i = 0; i < number_atom; ++i)
+    {
+        const int atom_i = *ap_data++;
+        const int number_atom_j = *ap_data++;
+        const int size_row = this->paraV->get_row_size(atom_i);
+        for (int j = 0; j < number_atom_j; ++j)
+        {
+            const int atom_j = *ap_data++;
+            const int size_col = this->paraV->get_col_size(atom_j);
+            const int number_R = *ap_data++;
+            for (int k = 0; k < number_R; ++k)
+            {
+                int r_index[3] = {ap_data[0], ap_data[1], ap_data[2]};
+                ap_data += 3;
+                if (size_row > 0 && size_col > 0)
+                {
+                    push_segment(begins, lengths, this->hr->data(atom_i, atom_j, r_index), size_row * size_col);
+                }
+            }
+        }
+    }
+}
+
 // ------------------------------------------------
 // HTransSerial
 // ------------------------------------------------
@@ -662,10 +712,275 @@ void HTransSerial<T>::get_value_size(int* out) const
     return;
 }
 
+template <typename T>
+void HTransSerial<T>::cal_value_segments(int irank, std::vector<T*>* begins, std::vector<long>* lengths) const
+{
+    begins->clear();
+    lengths->clear();
+    if (this->size_values[irank] == 0)
+    {
+        return;
+    }
+    auto& sparse_ap = this->hr->get_sparse_ap();
+    auto& sparse_ap_index = this->hr->get_sparse_ap_index();
+    for (int i = 0; i < sparse_ap.size(); ++i)
+    {
+        if (sparse_ap[i].size() == 0)
+        {
+            continue;
+        }
+        const int atom_i = i;
+        const int size_row = this->orb_indexes[irank][this->orb_row_indexes[irank].at(atom_i)];
+        if (size_row == 0)
+        {
+            continue;
+        }
+        const int* row_index = this->orb_indexes[irank].data() + this->orb_row_indexes[irank].at(atom_i) + 1;
+        for (int j = 0; j < sparse_ap[i].size(); ++j)
+        {
+            const int atom_j = sparse_ap[i][j];
+            const int size_col = this->orb_indexes[irank][this->orb_col_indexes[irank].at(atom_j)];
+            if (size_col == 0)
+            {
+                continue;
+            }
+            const int* col_index = this->orb_indexes[irank].data() + this->orb_col_indexes[irank].at(atom_j) + 1;
+            const hamilt::AtomPair<T>& tmp_ap = this->hr->get_atom_pair(sparse_ap_index[i][j]);
+            for (int k = 0; k < tmp_ap.get_R_size(); ++k)
+            {
+                const hamilt::BaseMatrix<T>& matrix = tmp_ap.get_HR_values(k);
+                for (int irow = 0; irow < size_row; ++irow)
+                {
+                    for (int icol = 0; icol < size_col; ++icol)
+                    {
+                        push_segment(begins, lengths, &matrix.get_value(row_index[irow], col_index[icol]), 1);
+                    }
+                }
+            }
+        }
+    }
+}
+
+// ------------------------------------------------
+// HTransferPlan
+// ------------------------------------------------
+
+template <typename T>
+HTransferPlan<T>::HTransferPlan(HContainer<T>* hr_s_in, HContainer<T>* hr_p_in)
+    : hr_s(hr_s_in), hr_p(hr_p_in), wrapper_s(hr_s_in->get_wrapper()), wrapper_p(hr_p_in->get_wrapper()),
+      nnr_s(hr_s_in->get_nnr()), nnr_p(hr_p_in->get_nnr())
+{
+    int size = 0;
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+    HTransSerial<T> trans_s(size, hr_s_in);
+    HTransPara<T> trans_p(size, hr_p_in);
+
+    // handshake of indexes, as in transferSerials2Parallels()
+    std::vector<int> sendbuf, receivebuf;
+    std::vector<int> sendcounts(size), recvcounts(size), sdispls(size), rdispls(size);
+    auto exchange = [&]() {
+        MPI_Alltoall(sendcounts.data(), 1, MPI_INT, recvcounts.data(), 1, MPI_INT, MPI_COMM_WORLD);
+        long recvbuf_size = 0;
+        for (int i = 0; i < size; ++i)
+        {
+            rdispls[i] = recvbuf_size;
+            recvbuf_size += recvcounts[i];
+        }
+        receivebuf.resize(recvbuf_size);
+        MPI_Alltoallv(sendbuf.data(),
+                      sendcounts.data(),
+                      sdispls.data(),
+                      MPI_INT,
+                      receivebuf.data(),
+                      recvcounts.data(),
+                      rdispls.data(),
+                      MPI_INT,
+                      MPI_COMM_WORLD);
+    };
+    for (int i = 0; i < size; ++i)
+    {
+        std::vector<int> tmp_indexes;
+        trans_s.cal_ap_indexes(i, &tmp_indexes);
+        sendcounts[i] = tmp_indexes.size();
+        sdispls[i] = sendbuf.size();
+        sendbuf.insert(sendbuf.end(), tmp_indexes.begin(), tmp_indexes.end());
+    }
+    exchange();
+    sendbuf.clear();
+    for (int i = 0; i < size; ++i)
+    {
+        trans_p.receive_ap_indexes(i, &receivebuf[rdispls[i]], recvcounts[i]);
+        std::vector<int> tmp_indexes;
+        trans_p.cal_orb_indexes(i, &tmp_indexes);
+        sendcounts[i] = tmp_indexes.size();
+        sdispls[i] = sendbuf.size();
+        sendbuf.insert(sendbuf.end(), tmp_indexes.begin(), tmp_indexes.end());
+    }
+    exchange();
+    for (int i = 0; i < size; ++i)
+    {
+        trans_s.receive_orb_indexes(i, &receivebuf[rdispls[i]], recvcounts[i]);
+    }
+
+    // the values of the serial HContainer for rank i are those of the parallel HContainer of rank i
+    // from this rank, so the neighbors of every rank are the same in both directions
+    std::vector<int> size_s(size), size_p(size);
+    trans_s.get_value_size(size_s.data());
+    trans_p.get_value_size(size_p.data());
+    std::vector<int> neighbors;
+    for (int i = 0; i < size; ++i)
+    {
+        if (size_s[i] > 0 || size_p[i] > 0)
+        {
+            neighbors.push_back(i);
+        }
+    }
+    MPI_Dist_graph_create_adjacent(MPI_COMM_WORLD,
+                                   neighbors.size(),
+                                   neighbors.data(),
+                                   MPI_UNWEIGHTED,
+                                   neighbors.size(),
+                                   neighbors.data(),
+                                   MPI_UNWEIGHTED,
+                                   MPI_INFO_NULL,
+                                   0,
+                                   &this->graph_comm);
+
+    // segments of every neighbor, with the offsets in the buffers
+    auto build = [&neighbors](const std::vector<int>& value_size,
+                              std::function<void(int, std::vector<T*>*, std::vector<long>*)> cal_segments,
+                              Segments& seg) {
+        long buffer_size = 0;
+        std::vector<T*> begins;
+        std::vector<long> lengths;
+        seg.neighbor_begin.push_back(0);
+        for (const int i: neighbors)
+        {
+            seg.counts.push_back(value_size[i]);
+            seg.displs.push_back(buffer_size);
+            cal_segments(i, &begins, &lengths);
+            for (size_t iseg = 0; iseg < begins.size(); ++iseg)
+            {
+                seg.begins.push_back(begins[iseg]);
+                seg.lengths.push_back(lengths[iseg]);
+                seg.offsets.push_back(buffer_size);
+                buffer_size += lengths[iseg];
+            }
+            seg.neighbor_begin.push_back(seg.begins.size());
+        }
+        seg.buffer.resize(buffer_size);
+    };
+    build(
+        size_s,
+        [&trans_s](int i, std::vector<T*>* begins, std::vector<long>* lengths) {
+            trans_s.cal_value_segments(i, begins, lengths);
+        },
+        this->segments_s);
+    build(
+        size_p,
+        [&trans_p](int i, std::vector<T*>* begins, std::vector<long>* lengths) {
+            trans_p.cal_value_segments(i, begins, lengths);
+        },
+        this->segments_p);
+}
+
+template <typename T>
+HTransferPlan<T>::~HTransferPlan()
+{
+    if (this->graph_comm != MPI_COMM_NULL)
+    {
+        MPI_Comm_free(&this->graph_comm);
+    }
+}
+
+template <typename T>
+bool HTransferPlan<T>::is_valid(const HContainer<T>* hr_s_in, const HContainer<T>* hr_p_in) const
+{
+    return hr_s_in == this->hr_s && hr_p_in == this->hr_p && hr_s_in->get_wrapper() == this->wrapper_s
+           && hr_p_in->get_wrapper() == this->wrapper_p && hr_s_in->get_nnr() == this->nnr_s
+           && hr_p_in->get_nnr() == this->nnr_p;
+}
+
+template <typename T>
+void HTransferPlan<T>::pack(Segments& seg, const long begin, const long end)
+{
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+    for (long iseg = begin; iseg < end; ++iseg)
+    {
+        std::copy(seg.begins[iseg], seg.begins[iseg] + seg.lengths[iseg], seg.buffer.data() + seg.offsets[iseg]);
+    }
+}
+
+template <typename T>
+void HTransferPlan<T>::unpack(Segments& seg, const long begin, const long end, const bool add)
+{
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+    for (long iseg = begin; iseg < end; ++iseg)
+    {
+        T* out = seg.begins[iseg];
+        const T* in = seg.buffer.data() + seg.offsets[iseg];
+        if (add)
+        {
+            for (long k = 0; k < seg.lengths[iseg]; ++k)
+            {
+                out[k] += in[k];
+            }
+        }
+        else
+        {
+            std::copy(in, in + seg.lengths[iseg], out);
+        }
+    }
+}
+
+template <typename T>
+void HTransferPlan<T>::serials2parallels()
+{
+    pack(this->segments_s, 0, this->segments_s.begins.size());
+    MPI_Neighbor_alltoallv(this->segments_s.buffer.data(),
+                           this->segments_s.counts.data(),
+                           this->segments_s.displs.data(),
+                           MPITraits<T>::datatype(),
+                           this->segments_p.buffer.data(),
+                           this->segments_p.counts.data(),
+                           this->segments_p.displs.data(),
+                           MPITraits<T>::datatype(),
+                           this->graph_comm);
+    // the values from different ranks are added to the same matrices, so one neighbor after another
+    const std::vector<long>& neighbor_begin = this->segments_p.neighbor_begin;
+    for (size_t i = 0; i + 1 < neighbor_begin.size(); ++i)
+    {
+        unpack(this->segments_p, neighbor_begin[i], neighbor_begin[i + 1], true);
+    }
+}
+
+template <typename T>
+void HTransferPlan<T>::parallels2serials()
+{
+    pack(this->segments_p, 0, this->segments_p.begins.size());
+    MPI_Neighbor_alltoallv(this->segments_p.buffer.data(),
+                           this->segments_p.counts.data(),
+                           this->segments_p.displs.data(),
+                           MPITraits<T>::datatype(),
+                           this->segments_s.buffer.data(),
+                           this->segments_s.counts.data(),
+                           this->segments_s.displs.data(),
+                           MPITraits<T>::datatype(),
+                           this->graph_comm);
+    // every value of the serial HContainer comes from one rank only
+    unpack(this->segments_s, 0, this->segments_s.begins.size(), false);
+}
+
 template class HTransPara<double>;
 template class HTransPara<std::complex<double>>;
 template class HTransSerial<double>;
 template class HTransSerial<std::complex<double>>;
+template class HTransferPlan<double>;
+template class HTransferPlan<std::complex<double>>;
 
 } // end namespace hamilt
 
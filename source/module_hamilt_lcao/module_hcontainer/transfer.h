@@ -8,6 +8,8 @@
 #include "./hcontainer.h"
 
 #ifdef __MPI
+#include <mpi.h>
+
 namespace hamilt
 {
 
@@ -63,6 +65,13 @@ class HTransPara
     long get_max_size() const;
     void get_value_size(int* out) const;
 
+    /**
+     * @brief addresses in this->hr of the values packed for ith rank, in the order of pack_data,
+     * merged into contiguous segments which begin at begins[i] and have lengths[i] values
+     * @param irank
+     */
+    void cal_value_segments(int irank, std::vector<T*>* begins, std::vector<long>* lengths) const;
+
   private:
     std::vector<std::vector<int>> ap_indexes;
     HContainer<T>* hr = nullptr;
@@ -126,6 +135,13 @@ class HTransSerial
     long get_max_size() const;
     void get_value_size(int* out) const;
 
+    /**
+     * @brief addresses in this->hr of the values packed for ith rank, in the order of pack_data,
+     * merged into contiguous segments which begin at begins[i] and have lengths[i] values
+     * @param irank
+     */
+    void cal_value_segments(int irank, std::vector<T*>* begins, std::vector<long>* lengths) const;
+
   private:
     std::vector<std::vector<int>> orb_indexes;
     HContainer<T>* hr = nullptr;
@@ -144,6 +160,72 @@ class HTransSerial
     std::vector<long> size_values;
 };
 
+/**
+ * @brief cached plan for repeated transfers between serial HContainers and a 2D-block parallel HContainer
+ * the serial HContainer of every rank holds full atom-pair matrices for its own <IJR> pattern (e.g. in Gint),
+ * the parallel one holds the 2D-block local part of all <IJR>s (e.g. H(R) and DM(R)).
+ * transferSerials2Parallels() and transferParallels2Serials() exchange all indexes on every call,
+ * this plan does the index handshake once in the constructor and keeps the offsets of the packed values
+ * as contiguous segments of both HContainers, so that every transfer only packs, moves the values with one
+ * neighbor collective among the ranks which really share data, and unpacks.
+ * The plan is only valid as long as the <IJR> patterns and the memory of both HContainers do not change,
+ * it has to be rebuilt after a new neighbor search.
+ */
+template <typename T>
+class HTransferPlan
+{
+  public:
+    HTransferPlan(HContainer<T>* hr_s_in, HContainer<T>* hr_p_in);
+    ~HTransferPlan();
+
+    /**
+     * @brief check if the plan was made for these HContainers and their memory is unchanged
+     */
+    bool is_valid(const HContainer<T>* hr_s_in, const HContainer<T>* hr_p_in) const;
+
+    /**
+     * @brief hr_p += values of hr_s of all ranks, same as transferSerials2Parallels()
+     */
+    void serials2parallels();
+
+    /**
+     * @brief hr_s = values of hr_p of all ranks, same as transferParallels2Serials()
+     */
+    void parallels2serials();
+
+  private:
+    // contiguous segments of values in one HContainer, with their offsets in the buffer
+    struct Segments
+    {
+        std::vector<T*> begins;
+        std::vector<long> lengths;
+        std::vector<long> offsets;
+        // the segments of neighbor i are [neighbor_begin[i], neighbor_begin[i+1])
+        std::vector<long> neighbor_begin;
+        // number and displacement of values to/from each neighbor in the buffer
+        std::vector<int> counts;
+        std::vector<int> displs;
+        std::vector<T> buffer;
+    };
+
+    const HContainer<T>* hr_s = nullptr;
+    const HContainer<T>* hr_p = nullptr;
+    const T* wrapper_s = nullptr;
+    const T* wrapper_p = nullptr;
+    size_t nnr_s = 0;
+    size_t nnr_p = 0;
+
+    // communicator of the ranks sharing values with this rank, in increasing order of rank
+    MPI_Comm graph_comm = MPI_COMM_NULL;
+    Segments segments_s;
+    Segments segments_p;
+
+    // copy the values of segments [begin, end) into the buffer
+    static void pack(Segments& seg, const long begin, const long end);
+    // copy or add the values of the buffer to segments [begin, end)
+    static void unpack(Segments& seg, const long begin, const long end, const bool add);
+};
+
 } // namespace hamilt
 
 /**
@@ -10,9 +10,14 @@
 #include "module_base/math_ylmreal.h"
 #include "module_base/memory.h"
 #include "module_base/module_device/device.h"
+#include "module_base/spherical_bessel_transformer.h"
+#include "module_base/table_cache.h"
 #include "module_base/timer.h"
 #include "module_hamilt_pw/hamilt_pwdft/global.h"
 #include "module_hamilt_pw/hamilt_pwdft/kernels/vnl_op.h"
+#include "module_hamilt_pw/hamilt_pwdft/radial_proj.h"
+
+#include <type_traits>
 
 
 pseudopot_cell_vnl::pseudopot_cell_vnl()
@@ -61,7 +66,7 @@ void pseudopot_cell_vnl::release_memory()
     }
     else
     {
-        if (PARAM.inp.precision == "single")
+        if (PARAM.inp.precision == "single" || PARAM.inp.precision == "mixed")
         {
             delmem_sh_op()(cpu_ctx, this->s_deeq);
             delmem_sh_op()(cpu_ctx, this->s_nhtol);
@@ -179,7 +184,7 @@ void pseudopot_cell_vnl::init(const UnitCell& ucell,
         }
         else
         {
-            if (PARAM.inp.precision == "single")
+            if (PARAM.inp.precision == "single" || PARAM.inp.precision == "mixed")
             {
                 resmem_sh_op()(cpu_ctx,
                                s_deeq,
@@ -195,7 +200,7 @@ void pseudopot_cell_vnl::init(const UnitCell& ucell,
                                "VNL::c_deeq_nc");
                 resmem_ch_op()(cpu_ctx, c_qq_so, ntype * 4 * this->nhm * this->nhm, "VNL::c_qq_so");
             }
-            else
+            if (PARAM.inp.precision != "single")
             {
                 this->z_deeq_nc = this->deeq_nc.ptr;
                 this->z_qq_so = this->qq_so.ptr;
@@ -283,7 +288,7 @@ void pseudopot_cell_vnl::init(const UnitCell& ucell,
     }
     else
     {
-        if (PARAM.inp.precision == "single")
+        if (PARAM.inp.precision == "single" || PARAM.inp.precision == "mixed")
         {
             resmem_sh_op()(cpu_ctx, s_tab, this->tab.getSize());
             resmem_ch_op()(cpu_ctx, c_vkb, nkb * npwx);
@@ -485,7 +490,7 @@ void pseudopot_cell_vnl::getvnl(Device* ctx,
         atom_nh = h_atom_nh;
         atom_nb = h_atom_nb;
         atom_na = h_atom_na;
-        if (PARAM.inp.precision == "single")
+        if (std::is_same<FPTYPE, float>::value)
         {
             resmem_var_op()(ctx, gk, npw * 3);
             castmem_var_h2h_op()(cpu_ctx, cpu_ctx, gk, reinterpret_cast<double*>(_gk), npw * 3);
@@ -539,6 +544,10 @@ void pseudopot_cell_vnl::getvnl(Device* ctx,
         delmem_int_op()(ctx, atom_nb);
         delmem_int_op()(ctx, atom_na);
     }
+    else if (std::is_same<FPTYPE, float>::value)
+    {
+        delmem_var_op()(ctx, gk);
+    }
     ModuleBase::timer::tick("pp_cell_vnl", "getvnl");
 } // end subroutine getvnl
 
@@ -842,28 +851,85 @@ void pseudopot_cell_vnl::init_vnl(UnitCell& cell, const ModulePW::PW_Basis* rho_
             kkbeta--;
         }
 
-        double* jl = new double[kkbeta];
-        double* aux = new double[kkbeta];
+        // the integrals do not depend on the cell, so they are kept on disk without pref
+        const std::size_t ntab = static_cast<std::size_t>(nbeta) * PARAM.globalv.nqx;
+        double* tab_it = (nbeta > 0) ? &this->tab(it, 0, 0) : nullptr;
+        ModuleBase::Table_Cache cache(PARAM.inp.pw_table_fft ? "vnl_tab_fft" : "vnl_tab");
+        const bool use_cache = (PARAM.inp.table_cache_dir != "none" && nbeta > 0);
+        if (use_cache)
+        {
+            cache.add(PARAM.globalv.nqx);
+            cache.add(PARAM.globalv.dq);
+            cache.add(kkbeta);
+            cache.add(cell.atoms[it].ncpp.lll.data(), nbeta);
+            cache.add(cell.atoms[it].ncpp.r.data(), kkbeta);
+            cache.add(cell.atoms[it].ncpp.rab.data(), kkbeta);
+            for (int ib = 0; ib < nbeta; ib++)
+            {
+                cache.add(&cell.atoms[it].ncpp.betar(ib, 0), kkbeta);
+            }
+        }
 
-        for (int ib = 0; ib < nbeta; ib++)
+        if (!use_cache || !cache.load(PARAM.inp.table_cache_dir, tab_it, ntab))
         {
-            const int l = cell.atoms[it].ncpp.lll[ib];
-            for (int iq = 0; iq < PARAM.globalv.nqx; iq++)
+            if (PARAM.inp.pw_table_fft && kkbeta > 1)
+            {
+                // int betar(r) * j_l(qr) * r dr, with betar = r * beta(r)
+                ModuleBase::SphericalBesselTransformer sbt(true);
+                for (int ib = 0; ib < nbeta; ib++)
+                {
+                    RadialProjection::_sbt_tab_fft(sbt,
+                                                   cell.atoms[it].ncpp.lll[ib],
+                                                   kkbeta,
+                                                   cell.atoms[it].ncpp.r.data(),
+                                                   &cell.atoms[it].ncpp.betar(ib, 0),
+                                                   1,
+                                                   PARAM.globalv.nqx,
+                                                   PARAM.globalv.dq,
+                                                   &this->tab(it, ib, 0));
+                }
+            }
+            else
             {
-                const double q = iq * PARAM.globalv.dq;
-                ModuleBase::Sphbes::Spherical_Bessel(kkbeta, cell.atoms[it].ncpp.r.data(), q, l, jl);
+                double* jl = new double[kkbeta];
+                double* aux = new double[kkbeta];
 
-                for (int ir = 0; ir < kkbeta; ir++)
+                for (int ib = 0; ib < nbeta; ib++)
                 {
-                    aux[ir] = cell.atoms[it].ncpp.betar(ib, ir) * jl[ir] * cell.atoms[it].ncpp.r[ir];
+                    const int l = cell.atoms[it].ncpp.lll[ib];
+                    for (int iq = 0; iq < PARAM.globalv.nqx; iq++)
+                    {
+                        const double q = iq * PARAM.globalv.dq;
+                        ModuleBase::Sphbes::Spherical_Bessel(kkbeta, cell.atoms[it].ncpp.r.data(), q, l, jl);
+
+                        for (int ir = 0; ir < kkbeta; ir++)
+                        {
+                            aux[ir] = cell.atoms[it].ncpp.betar(ib, ir) * jl[ir] * cell.atoms[it].ncpp.r[ir];
+                        }
+                        double vqint;
+                        ModuleBase::Integral::Simpson_Integral(kkbeta, aux, cell.atoms[it].ncpp.rab.data(), vqint);
+                        this->tab(it, ib, iq) = vqint;
+                    }
                 }
-                double vqint;
-                ModuleBase::Integral::Simpson_Integral(kkbeta, aux, cell.atoms[it].ncpp.rab.data(), vqint);
-                this->tab(it, ib, iq) = vqint * pref;
+                delete[] aux;
+                delete[] jl;
+            }
+
+            if (use_cache && GlobalV::MY_RANK == 0)
+            {
+                cache.save(PARAM.inp.table_cache_dir, tab_it, ntab);
             }
         }
-        delete[] aux;
-        delete[] jl;
+        else
+        {
+            GlobalV::ofs_running << "\n Read the table of " << cell.atoms[it].label << " from "
+                                 << cache.file_name(PARAM.inp.table_cache_dir);
+        }
+
+        for (std::size_t i = 0; i < ntab; ++i)
+        {
+            tab_it[i] *= pref;
+        }
     }
     if (PARAM.inp.device == "gpu")
     {
@@ -891,7 +957,7 @@ void pseudopot_cell_vnl::init_vnl(UnitCell& cell, const ModulePW::PW_Basis* rho_
     }
     else
     {
-        if (PARAM.inp.precision == "single")
+        if (PARAM.inp.precision == "single" || PARAM.inp.precision == "mixed")
         {
             castmem_d2s_h2h_op()(cpu_ctx, cpu_ctx, this->s_indv, this->indv.c, this->indv.nr * this->indv.nc);
             castmem_d2s_h2h_op()(cpu_ctx, cpu_ctx, this->s_nhtol, this->nhtol.c, this->nhtol.nr * this->nhtol.nc);
@@ -922,40 +988,116 @@ void pseudopot_cell_vnl::compute_qrad(UnitCell& cell)
             {
                 kkbeta--;
             }
-            double* aux = new double[kkbeta];
-            double* besr = new double[kkbeta];
+            // the integrals do not depend on the cell, so they are kept on disk without pref
+            const std::size_t nqrad = static_cast<std::size_t>(qrad.getBound2()) * qrad.getBound3() * qrad.getBound4();
+            double* qrad_it = &this->qrad(it, 0, 0, 0);
+            ModuleBase::Table_Cache cache(PARAM.inp.pw_table_fft ? "vnl_qrad_fft" : "vnl_qrad");
+            const bool use_cache = (PARAM.inp.table_cache_dir != "none");
+            if (use_cache)
+            {
+                cache.add(PARAM.globalv.nqxq);
+                cache.add(PARAM.globalv.dq);
+                cache.add(qrad.getBound2());
+                cache.add(qrad.getBound3());
+                cache.add(kkbeta);
+                cache.add(upf->nqlc);
+                cache.add(upf->lll.data(), nbeta);
+                cache.add(upf->r.data(), kkbeta);
+                cache.add(upf->rab.data(), kkbeta);
+                for (int l = 0; l < upf->nqlc; l++)
+                {
+                    for (int ijv = 0; ijv < nbeta * (nbeta + 1) / 2; ijv++)
+                    {
+                        cache.add(&upf->qfuncl(l, ijv, 0), kkbeta);
+                    }
+                }
+            }
+            if (use_cache && cache.load(PARAM.inp.table_cache_dir, qrad_it, nqrad))
+            {
+                GlobalV::ofs_running << "\n Read the table of " << cell.atoms[it].label << " from "
+                                     << cache.file_name(PARAM.inp.table_cache_dir);
+                for (std::size_t i = 0; i < nqrad; ++i)
+                {
+                    qrad_it[i] *= pref;
+                }
+                continue;
+            }
 
-            for (int l = 0; l < upf->nqlc; l++)
+            if (PARAM.inp.pw_table_fft && kkbeta > 1)
             {
-                for (int iq = 0; iq < PARAM.globalv.nqxq; iq++)
+                // int qfuncl(r) * j_l(qr) dr, where qfuncl includes r^2
+                ModuleBase::SphericalBesselTransformer sbt(true);
+                for (int l = 0; l < upf->nqlc; l++)
                 {
-                    const double q = iq * PARAM.globalv.dq;
-                    // here we compute the spherical bessel function for each q_i
-                    ModuleBase::Sphbes::Spherical_Bessel(kkbeta, upf->r.data(), q, l, besr);
                     for (int nb = 0; nb < nbeta; nb++)
                     {
-                        // the Q are symmetric with respect to indices nb and mb
                         for (int mb = nb; mb < nbeta; mb++)
                         {
                             const int ijv = mb * (mb + 1) / 2 + nb;
                             if ((l >= std::abs(upf->lll[nb] - upf->lll[mb])) && (l <= (upf->lll[nb] + upf->lll[mb]))
                                 && ((l + upf->lll[nb] + upf->lll[mb]) % 2 == 0))
                             {
-                                for (int ir = 0; ir < kkbeta; ir++)
+                                RadialProjection::_sbt_tab_fft(sbt,
+                                                               l,
+                                                               kkbeta,
+                                                               upf->r.data(),
+                                                               &upf->qfuncl(l, ijv, 0),
+                                                               2,
+                                                               PARAM.globalv.nqxq,
+                                                               PARAM.globalv.dq,
+                                                               &qrad(it, l, ijv, 0));
+                            }
+                        }
+                    }
+                }
+            }
+            else
+            {
+                double* aux = new double[kkbeta];
+                double* besr = new double[kkbeta];
+
+                for (int l = 0; l < upf->nqlc; l++)
+                {
+                    for (int iq = 0; iq < PARAM.globalv.nqxq; iq++)
+                    {
+                        const double q = iq * PARAM.globalv.dq;
+                        // here we compute the spherical bessel function for each q_i
+                        ModuleBase::Sphbes::Spherical_Bessel(kkbeta, upf->r.data(), q, l, besr);
+                        for (int nb = 0; nb < nbeta; nb++)
+                        {
+                            // the Q are symmetric with respect to indices nb and mb
+                            for (int mb = nb; mb < nbeta; mb++)
+                            {
+                                const int ijv = mb * (mb + 1) / 2 + nb;
+                                if ((l >= std::abs(upf->lll[nb] - upf->lll[mb]))
+                                    && (l <= (upf->lll[nb] + upf->lll[mb]))
+                                    && ((l + upf->lll[nb] + upf->lll[mb]) % 2 == 0))
                                 {
-                                    aux[ir] = besr[ir] * upf->qfuncl(l, ijv, ir);
+                                    for (int ir = 0; ir < kkbeta; ir++)
+                                    {
+                                        aux[ir] = besr[ir] * upf->qfuncl(l, ijv, ir);
+                                    }
+                                    // then we integrate with all the Q functions
+                                    double vqint;
+                                    ModuleBase::Integral::Simpson_Integral(kkbeta, aux, upf->rab.data(), vqint);
+                                    qrad(it, l, ijv, iq) = vqint;
                                 }
-                                // then we integrate with all the Q functions
-                                double vqint;
-                                ModuleBase::Integral::Simpson_Integral(kkbeta, aux, upf->rab.data(), vqint);
-                                qrad(it, l, ijv, iq) = vqint * pref;
                             }
                         }
                     }
                 }
+                delete[] aux;
+                delete[] besr;
+            }
+
+            if (use_cache && GlobalV::MY_RANK == 0)
+            {
+                cache.save(PARAM.inp.table_cache_dir, qrad_it, nqrad);
+            }
+            for (std::size_t i = 0; i < nqrad; ++i)
+            {
+                qrad_it[i] *= pref;
             }
-            delete[] aux;
-            delete[] besr;
         }
     }
 }
@@ -1338,6 +1480,33 @@ void pseudopot_cell_vnl::init_vnl_alpha(const UnitCell& ucell) // pengfei Li 201
             kkbeta--;
         }
 
+        if (PARAM.inp.pw_table_fft && kkbeta > 1)
+        {
+            // int betar(r) * j_L(qr) * r^2 dr
+            ModuleBase::SphericalBesselTransformer sbt(true);
+            std::vector<double> vq(PARAM.globalv.nqx);
+            for (int ib = 0; ib < nbeta; ib++)
+            {
+                for (int L = 0; L <= lmaxkb + 1; L++)
+                {
+                    RadialProjection::_sbt_tab_fft(sbt,
+                                                   L,
+                                                   kkbeta,
+                                                   ucell.atoms[it].ncpp.r.data(),
+                                                   &ucell.atoms[it].ncpp.betar(ib, 0),
+                                                   0,
+                                                   PARAM.globalv.nqx,
+                                                   PARAM.globalv.dq,
+                                                   vq.data());
+                    for (int iq = 0; iq < PARAM.globalv.nqx; iq++)
+                    {
+                        this->tab_alpha(it, ib, L, iq) = vq[iq] * pref;
+                    }
+                }
+            }
+            continue;
+        }
+
         double* jl = new double[kkbeta];
         double* aux = new double[kkbeta];
 
@@ -1514,7 +1683,7 @@ void pseudopot_cell_vnl::cal_effective_D(const ModuleBase::matrix& veff,
     }
     else
     {
-        if (PARAM.inp.precision == "single")
+        if (PARAM.inp.precision == "single" || PARAM.inp.precision == "mixed")
         {
             castmem_d2s_h2h_op()(cpu_ctx,
                                  cpu_ctx,
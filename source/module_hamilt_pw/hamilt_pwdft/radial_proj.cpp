@@ -3,6 +3,7 @@
 #include <cmath>
 #include <numeric>
 #include <map>
+#include <vector>
 #include "module_hamilt_pw/hamilt_pwdft/radial_proj.h"
 #include "module_base/constants.h"
 #include "module_base/matrix.h"
@@ -240,6 +241,65 @@ void RadialProjection::RadialProjector::sbtft(const std::vector<ModuleBase::Vect
     ModuleBase::timer::tick("RadialProjection", "interp_sphbes_ft_flzYlm");
 }
 
+void RadialProjection::_sbt_tab_fft(const ModuleBase::SphericalBesselTransformer& sbt,
+                                    const int l,
+                                    const int nr,
+                                    const double* r,
+                                    const double* in,
+                                    const int p,
+                                    const int nq,
+                                    const double dq,
+                                    double* out,
+                                    const double dr)
+{
+    assert(nr > 1 && nq > 0 && dq > 0.0 && dr > 0.0);
+    // the output grid of radrfft is j*pi/cutoff
+    const double cutoff = std::acos(-1.0) / dq;
+
+    // number of intervals of the uniform grid, rounded up to a product of 2, 3 and 5 for the FFT
+    int n = std::max(static_cast<int>(std::ceil(cutoff / dr)), nq);
+    auto is_smooth = [](int m) {
+        for (const int f: {2, 3, 5})
+        {
+            while (m % f == 0)
+            {
+                m /= f;
+            }
+        }
+        return m == 1;
+    };
+    while (!is_smooth(n))
+    {
+        ++n;
+    }
+    const double dx = cutoff / n;
+
+    // interpolate in[] to the uniform grid, zero outside [r[0], r[nr-1]]
+    const int ibegin = static_cast<int>(std::ceil(r[0] / dx));
+    const int iend = std::min(static_cast<int>(r[nr - 1] / dx), n);
+    std::vector<double> value(n + 1, 0.0);
+    if (iend >= ibegin)
+    {
+        std::vector<double> grid(iend - ibegin + 1);
+        for (int i = ibegin; i <= iend; ++i)
+        {
+            grid[i - ibegin] = std::min(std::max(i * dx, r[0]), r[nr - 1]);
+        }
+        ModuleBase::CubicSpline cubspl(nr, r, in); // not-a-knot boundary condition
+        cubspl.eval(grid.size(), grid.data(), &value[ibegin]);
+    }
+
+    std::vector<double> tmp(n + 1);
+    sbt.radrfft(l, n + 1, cutoff, value.data(), tmp.data(), p);
+
+    // the SphericalBesselTransformer's result is multiplied by one extra factor sqrt(2/pi)
+    const double pref = std::sqrt(2.0 / std::acos(-1.0));
+    for (int iq = 0; iq < nq; ++iq)
+    {
+        out[iq] = tmp[iq] / pref;
+    }
+}
+
 void RadialProjection::_mask_func(std::vector<double>& mask)
 {
     /* mask function is hard coded here, eta = 15 */
@@ -13,6 +13,7 @@
 
 #include "module_base/vector3.h"
 #include "module_base/cubic_spline.h"
+#include "module_base/spherical_bessel_transformer.h"
 #include <memory>
 #include <vector>
 #include <complex>
@@ -199,6 +200,39 @@ namespace RadialProjection
             std::vector<int> l_;
     };
   
+    /**
+     * @brief tabulate the Spherical Bessel Transform Jl[f](q) = int(f(r)*j_l(q*r)*r^2 dr) on
+     * the grid q = iq*dq (iq = 0, 1, ..., nq-1) with the FFT-based algorithm.
+     * 
+     * The input r^p*f(r), given on any radial grid (logarithmic in pseudopotential files), is
+     * interpolated by cubic spline to a uniform grid and padded with zeros up to pi/dq, so that
+     * the output grid of ModuleBase::SphericalBesselTransformer::radrfft is exactly the q grid.
+     * The cost is O(N*log(N)) with N ~ pi/(dq*dr), instead of O(nq*nr) of the direct integration.
+     * For the projectors of pseudopotential files the table agrees with Simpson's rule on the radial
+     * grid within 1e-3 of its largest value.
+     * 
+     * @param sbt spherical Bessel transformer, whose FFT plan is reused if the cache is enabled
+     * @param l angular momentum
+     * @param nr number of radial grid points, f(r) is zero beyond r[nr-1]
+     * @param r radial grid, strictly increasing
+     * @param in r^p*f(r) on the radial grid
+     * @param p exponent of the extra power term in input values, p <= 2
+     * @param nq number of q-points
+     * @param dq space between q-points
+     * @param out Jl[f](q) on the q grid
+     * @param dr largest spacing of the uniform radial grid, which controls the accuracy
+     */
+    void _sbt_tab_fft(const ModuleBase::SphericalBesselTransformer& sbt,
+                      const int l,
+                      const int nr,
+                      const double* r,
+                      const double* in,
+                      const int p,
+                      const int nq,
+                      const double dq,
+                      double* out,
+                      const double dr = 0.01);
+
     /** ====================================================================================
      * 
      *                       Small box Fast-Fourier-Transform (SBFFT)
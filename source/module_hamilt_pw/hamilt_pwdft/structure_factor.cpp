@@ -36,7 +36,7 @@ Structure_Factor::~Structure_Factor()
         delmem_zd_op()(gpu_ctx, this->z_eigts3);
     }
     else {
-        if (PARAM.inp.precision == "single") {
+        if (PARAM.inp.precision == "single" || PARAM.inp.precision == "mixed") {
             delmem_ch_op()(cpu_ctx, this->c_eigts1);
             delmem_ch_op()(cpu_ctx, this->c_eigts2);
             delmem_ch_op()(cpu_ctx, this->c_eigts3);
@@ -166,7 +166,7 @@ void Structure_Factor::setup_structure_factor(const UnitCell* Ucell, const Paral
         syncmem_z2z_h2d_op()(gpu_ctx, cpu_ctx, this->z_eigts3, this->eigts3.c, Ucell->nat * (2 * rho_basis->nz + 1));
     }
     else {
-        if (PARAM.inp.precision == "single") {
+        if (PARAM.inp.precision == "single" || PARAM.inp.precision == "mixed") {
             resmem_ch_op()(cpu_ctx, this->c_eigts1, Ucell->nat * (2 * rho_basis->nx + 1));
             resmem_ch_op()(cpu_ctx, this->c_eigts2, Ucell->nat * (2 * rho_basis->ny + 1));
             resmem_ch_op()(cpu_ctx, this->c_eigts3, Ucell->nat * (2 * rho_basis->nz + 1));
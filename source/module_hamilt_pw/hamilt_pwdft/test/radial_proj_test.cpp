@@ -4,6 +4,10 @@
 #include <numeric>
 #include <fftw3.h>
 #include <random>
+#include <fstream>
+#include <string>
+#include "module_base/math_integral.h"
+#include "module_base/math_sphbes.h"
 
 #define DOUBLETHRESHOLD 1e-15
 
@@ -288,8 +292,115 @@ TEST(RadialProjectionTest, BuildSbtTabStabilityTest)
     }
 }
 
+TEST(RadialProjectionTest, SbtTabFFTTest)
+{
+    // Gaussian-type functions on a logarithmic grid, like that in pseudopotential files
+    const int nr = 1000;
+    std::vector<double> r(nr);
+    const double r0 = 1e-5;
+    const double h = std::log(20.0 / r0) / (nr - 1);
+    for (int ir = 0; ir < nr; ++ir)
+    {
+        r[ir] = r0 * std::exp(ir * h);
+    }
+
+    const int nq = 1000;
+    const double dq = 0.01;
+    std::vector<double> in(nr);
+    std::vector<double> out(nq);
+    ModuleBase::SphericalBesselTransformer sbt(true);
+    for (int l = 0; l <= 3; ++l)
+    {
+        for (int p = 0; p <= 2; ++p)
+        {
+            // in = r^p * f(r) with f(r) = r^l * exp(-r^2)
+            for (int ir = 0; ir < nr; ++ir)
+            {
+                in[ir] = std::pow(r[ir], l + p) * std::exp(-r[ir] * r[ir]);
+            }
+            RadialProjection::_sbt_tab_fft(sbt, l, nr, r.data(), in.data(), p, nq, dq, out.data());
+
+            // int(r^(l+2)*exp(-r^2)*j_l(q*r) dr) = sqrt(pi)/2^(l+2)*q^l*exp(-q^2/4)
+            for (int iq = 0; iq < nq; ++iq)
+            {
+                const double q = iq * dq;
+                const double ref = std::sqrt(M_PI) / std::pow(2.0, l + 2) * std::pow(q, l) * std::exp(-q * q / 4);
+                EXPECT_NEAR(out[iq], ref, 1e-6);
+            }
+        }
+    }
+}
+
+// read the values of the first UPF 2.0.1 block whose tag starts with tag, and its attribute attr if any
+std::vector<double> read_upf_block(const std::string& file, const std::string& tag, const std::string& attr, int& value)
+{
+    std::ifstream ifs(file);
+    std::string line;
+    while (std::getline(ifs, line) && line.find("<" + tag) == std::string::npos)
+    {
+    }
+    const std::size_t pos = line.find(attr + "=\"");
+    if (!attr.empty() && pos != std::string::npos)
+    {
+        value = std::stoi(line.substr(pos + attr.size() + 2));
+    }
+    std::vector<double> data;
+    double x = 0.0;
+    while (ifs >> x)
+    {
+        data.push_back(x);
+    }
+    return data;
+}
+
+TEST(RadialProjectionTest, SbtTabFFTUPFTest)
+{
+    // the beta tables of pseudopot_cell_vnl::init_vnl, by Simpson's rule and by FFT
+    const std::string file = "../../../../../tests/PP_ORB/Fe.pbe-nd-rrkjus.UPF";
+    int dummy = 0;
+    const std::vector<double> r = read_upf_block(file, "PP_R>", "", dummy);
+    const std::vector<double> rab = read_upf_block(file, "PP_RAB>", "", dummy);
+    ASSERT_EQ(r.size(), 957);
+    ASSERT_EQ(rab.size(), r.size());
+
+    const int nq = 1000;
+    const double dq = 0.01;
+    ModuleBase::SphericalBesselTransformer sbt(true);
+    for (int ib = 1; ib <= 6; ++ib)
+    {
+        int l = -1;
+        const std::vector<double> betar = read_upf_block(file, "PP_BETA." + std::to_string(ib), "angular_momentum", l);
+        ASSERT_EQ(betar.size(), r.size());
+        // kkbeta is the largest cutoff_radius_index of the projectors
+        const int kkbeta = 751;
+
+        std::vector<double> tab_fft(nq);
+        RadialProjection::_sbt_tab_fft(sbt, l, kkbeta, r.data(), betar.data(), 1, nq, dq, tab_fft.data());
+
+        std::vector<double> jl(kkbeta);
+        std::vector<double> aux(kkbeta);
+        double tab_max = 0.0;
+        double err_max = 0.0;
+        for (int iq = 0; iq < nq; ++iq)
+        {
+            ModuleBase::Sphbes::Spherical_Bessel(kkbeta, r.data(), iq * dq, l, jl.data());
+            for (int ir = 0; ir < kkbeta; ++ir)
+            {
+                aux[ir] = betar[ir] * jl[ir] * r[ir];
+            }
+            double vqint = 0.0;
+            ModuleBase::Integral::Simpson_Integral(kkbeta, aux.data(), rab.data(), vqint);
+            tab_max = std::max(tab_max, std::abs(vqint));
+            err_max = std::max(err_max, std::abs(tab_fft[iq] - vqint));
+        }
+        // the tables differ by less than 1e-3 of their largest value, mostly because the projectors
+        // are cut at r[kkbeta-1], where Simpson's rule and the spline treat the step differently
+        EXPECT_LT(err_max, 1e-3 * tab_max) << "beta " << ib << " l = " << l;
+    }
+}
+
 int main()
 {
     testing::InitGoogleTest();
     return RUN_ALL_TESTS();
-}
\ No newline at end of file
+}
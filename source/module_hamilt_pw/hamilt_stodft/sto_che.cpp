@@ -26,6 +26,10 @@ StoChe<REAL, Device>::StoChe(const int& nche, const int& method, const REAL& ema
     else
     {
         resmem_var_op()(this->ctx, spolyv, nche * nche);
+        if (method == 3)
+        {
+            spolyv_cpu = new REAL[nche * nche];
+        }
     }
 
     this->emax_sto = emax_sto;
@@ -81,6 +81,10 @@ void Sto_DOS::caldos(const double sigmain, const double de, const int npart)
     {
         spolyv.resize(dos_nche, 0);
     }
+    else if (this->method_sto == 3)
+    {
+        spolyv.resize(dos_nche * dos_nche, 0);
+    }
     else
     {
         spolyv.resize(dos_nche * dos_nche, 0);
@@ -123,6 +127,15 @@ void Sto_DOS::caldos(const double sigmain, const double de, const int npart)
                 spolyv[i] += che.polytrace[i] * p_kv->wk[ik] / 2;
             }
         }
+        else if (this->method_sto == 3)
+        {
+            std::vector<double> polygram(dos_nche * dos_nche);
+            che.tracepolyAA(hchi_norm, pchi, polygram.data(), npw, npwx, nchipk);
+            for (int i = 0; i < dos_nche * dos_nche; ++i)
+            {
+                spolyv[i] += polygram[i] * p_kv->wk[ik] / 2;
+            }
+        }
         else
         {
             int N = dos_nche;
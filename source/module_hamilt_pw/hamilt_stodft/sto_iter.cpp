@@ -360,6 +360,10 @@ void Stochastic_Iter<T, Device>::calPn(const int& ik, Stochastic_WF<T, Device>&
         {
             ModuleBase::GlobalFunc::ZEROS(spolyv_cpu, norder);
         }
+        else if (this->method == 3)
+        {
+            ModuleBase::GlobalFunc::ZEROS(spolyv_cpu, norder * norder);
+        }
         else
         {
             setmem_var_op()(this->ctx, spolyv, 0, norder * norder);
@@ -394,6 +398,21 @@ void Stochastic_Iter<T, Device>::calPn(const int& ik, Stochastic_WF<T, Device>&
             syncmem_var_h2d_op()(this->ctx, cpu_ctx, spolyv, spolyv_cpu, norder);
         }
     }
+    else if (this->method == 3)
+    {
+        // the same matrix as method 2, but T_n(H)|chi> of all orders are not stored
+        std::vector<Real> polygram(norder * norder);
+        p_che->tracepolyAA(hchi_norm, pchi, polygram.data(), npw, npwx, nchip_ik);
+        const Real kweight = this->pkv->wk[ik];
+        for (int i = 0; i < norder * norder; ++i)
+        {
+            spolyv_cpu[i] += polygram[i] * kweight;
+        }
+        if (ik == this->pkv->get_nks() - 1)
+        {
+            syncmem_var_h2d_op()(this->ctx, cpu_ctx, spolyv, spolyv_cpu, norder * norder);
+        }
+    }
     else
     {
         p_che->calpolyvec_complex(hchi_norm, pchi, stowf.chiallorder[ik].get_pointer(), npw, npwx, nchip_ik);
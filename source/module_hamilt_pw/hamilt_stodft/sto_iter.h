@@ -30,7 +30,7 @@ class Stochastic_Iter
     /**
      * @brief init for iteration process of SDFT
      *
-     * @param method_in 1: slow   2: fast but cost much memories
+     * @param method_in 1: slow   2: fast but cost much memories   3: slow, but N_e is calculated as 2
      * @param pkv_in K_Vectors
      * @param wfc_basis wfc pw basis
      * @param stowf stochastic wave function
@@ -132,7 +132,7 @@ class Stochastic_Iter
     double KS_ne=0.0;
 
   public:
-    int method; // different methods 1: slow, less memory  2: fast, more memory
+    int method; // different methods 1: slow, less memory  2: fast, more memory  3: as 2 with less memory
     // cal shchi = \sqrt{f(\hat{H})}|\chi>
     void calHsqrtchi(Stochastic_WF<T, Device>& stowf);
     // cal Pn = \sum_\chi <\chi|Tn(\hat{h})|\chi>
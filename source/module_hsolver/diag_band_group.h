@@ -0,0 +1,68 @@
+#ifndef DIAG_BAND_GROUP_H
+#define DIAG_BAND_GROUP_H
+
+#include "module_hsolver/diag_comm_info.h"
+#ifdef __MPI
+#include "module_base/parallel_device.h"
+#endif
+
+#include <algorithm>
+#include <vector>
+
+namespace hsolver
+{
+// Band groups of the Kohn-Sham PW diagonalization (bndpar > 1):
+// every group holds all the bands, distributed over the plane waves of its own pool,
+// and the groups are connected by band_comm (PARAPW_WORLD), in which rank is the index of the group.
+
+/// @brief the vectors [start, start + num) of n vectors handled by the band group `rank` of `nproc` groups
+inline void band_group_range(const int n, const int nproc, const int rank, int& start, int& num)
+{
+    num = n / nproc + (rank < n % nproc ? 1 : 0);
+    start = rank * (n / nproc) + std::min(rank, n % nproc);
+}
+
+/**
+ * @brief HX = H(X) with the nvec vectors of X split over the band groups.
+ *
+ * Each group applies hpsi_func to its own slice of X, then the slices of HX are gathered in
+ * all groups. X and HX are (ld_psi, nvec)-shaped blockvectors, as in DiagoDavid::HPsiFunc.
+ */
+template <typename T, typename Device, typename HPsiFunc>
+void band_group_hpsi(const HPsiFunc& hpsi_func,
+                     const diag_comm_info& band_comm,
+                     T* psi_in,
+                     T* hpsi_out,
+                     const int ld_psi,
+                     const int nvec)
+{
+    if (band_comm.nproc == 1)
+    {
+        hpsi_func(psi_in, hpsi_out, ld_psi, nvec);
+        return;
+    }
+#ifdef __MPI
+    int start = 0;
+    int num = 0;
+    band_group_range(nvec, band_comm.nproc, band_comm.rank, start, num);
+    if (num > 0)
+    {
+        hpsi_func(psi_in + start * ld_psi, hpsi_out + start * ld_psi, ld_psi, num);
+    }
+
+    std::vector<int> counts(band_comm.nproc, 0);
+    std::vector<int> displs(band_comm.nproc, 0);
+    for (int ip = 0; ip < band_comm.nproc; ++ip)
+    {
+        band_group_range(nvec, band_comm.nproc, ip, displs[ip], counts[ip]);
+        counts[ip] *= ld_psi;
+        displs[ip] *= ld_psi;
+    }
+    const Device* ctx = {};
+    Parallel_Common::gatherv_dev(ctx, hpsi_out, ld_psi * nvec, counts.data(), displs.data(), band_comm.comm);
+#endif
+}
+
+} // namespace hsolver
+
+#endif
@@ -0,0 +1,509 @@
+#include "diago_chebfilter.h"
+
+#include "diago_iter_assist.h"
+#include "module_base/lapack_connector.h"
+#include "module_base/module_container/base/third_party/lapack.h"
+#include "module_base/parallel_reduce.h"
+#include "module_base/tool_quit.h"
+#include "module_base/timer.h"
+#include "module_hsolver/kernels/dngvd_op.h"
+#include "module_hsolver/kernels/math_kernel_op.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+using namespace hsolver;
+
+template <typename T, typename Device>
+std::vector<typename DiagoChebFilter<T, Device>::Real> DiagoChebFilter<T, Device>::upper_bounds;
+
+template <typename T, typename Device>
+DiagoChebFilter<T, Device>::DiagoChebFilter(const int nband_in,
+                                            const int dim_in,
+                                            const int degree_in,
+                                            const int diag_nmax_in,
+                                            const diag_comm_info& diag_comm_in)
+    : diag_comm(diag_comm_in), n_band(nband_in), dim(dim_in), degree(degree_in), iter_nmax(diag_nmax_in)
+{
+    this->device = base_device::get_device_type<Device>(this->ctx);
+
+    assert(this->degree > 0);
+    assert(this->n_band > 0);
+
+    this->n_buffer = std::min(std::max(2, this->n_band / 10), this->n_band);
+    this->n_block = this->n_band + this->n_buffer;
+    assert(this->n_block < this->dim * this->diag_comm.nproc);
+
+    resmem_complex_op()(this->ctx, this->psi_iter, this->n_block * this->dim, "ChebFilter::psi_iter");
+    resmem_complex_op()(this->ctx, this->hphi, this->n_block * this->dim, "ChebFilter::hphi");
+    resmem_complex_op()(this->ctx, this->work, this->n_block * this->dim, "ChebFilter::work");
+    setmem_complex_op()(this->ctx, this->psi_iter, 0, this->n_block * this->dim);
+    setmem_complex_op()(this->ctx, this->hphi, 0, this->n_block * this->dim);
+    setmem_complex_op()(this->ctx, this->work, 0, this->n_block * this->dim);
+
+    resmem_complex_op()(this->ctx, this->hcc, this->n_block * this->n_block, "ChebFilter::hcc");
+    resmem_complex_op()(this->ctx, this->vcc, this->n_block * this->n_block, "ChebFilter::vcc");
+    this->hcc_cpu.resize(this->n_block * this->n_block);
+    this->scc_cpu.resize(this->n_block * this->n_block);
+    this->vcc_cpu.resize(this->n_block * this->n_block);
+}
+
+template <typename T, typename Device>
+DiagoChebFilter<T, Device>::~DiagoChebFilter()
+{
+    delmem_complex_op()(this->ctx, this->psi_iter);
+    delmem_complex_op()(this->ctx, this->hphi);
+    delmem_complex_op()(this->ctx, this->work);
+    delmem_complex_op()(this->ctx, this->hcc);
+    delmem_complex_op()(this->ctx, this->vcc);
+}
+
+template <typename T, typename Device>
+typename DiagoChebFilter<T, Device>::Real DiagoChebFilter<T, Device>::estimate_upper_bound(const HPsiFunc& hpsi_func)
+{
+    ModuleBase::timer::tick("DiagoChebFilter", "upper_bound");
+
+    // the same seed on every rank, the bound only depends on the reduced dot products
+    std::vector<T> v_cpu(this->dim);
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<Real> uniform(-0.5, 0.5);
+    for (int i = 0; i < this->dim; i++)
+    {
+        v_cpu[i] = T(uniform(rng), uniform(rng));
+    }
+
+    T* v0 = nullptr;
+    T* v = nullptr;
+    T* f = nullptr;
+    resmem_complex_op()(this->ctx, v0, this->dim);
+    resmem_complex_op()(this->ctx, v, this->dim);
+    resmem_complex_op()(this->ctx, f, this->dim);
+    syncmem_h2d_op()(this->ctx, this->cpu_ctx, v, v_cpu.data(), this->dim);
+
+    Real norm = std::sqrt(dot_real_op<T, Device>()(this->ctx, this->dim, v, v));
+    vector_div_constant_op<T, Device>()(this->ctx, this->dim, v, v, norm);
+
+    // diagonal and sub-diagonal of the Lanczos tridiagonal matrix
+    std::vector<double> alpha(this->nlanczos, 0.0);
+    std::vector<double> beta(this->nlanczos, 0.0);
+
+    // f = H v - alpha v
+    hpsi_func(v, f, this->dim, 1);
+    alpha[0] = dot_real_op<T, Device>()(this->ctx, this->dim, v, f);
+    constantvector_addORsub_constantVector_op<T, Device>()(this->ctx, this->dim, f, f, 1.0, v, -alpha[0]);
+
+    int nstep = 1;
+    Real fnorm = std::sqrt(dot_real_op<T, Device>()(this->ctx, this->dim, f, f));
+    for (int j = 1; j < this->nlanczos && fnorm > 1.0e-10; j++)
+    {
+        // v0 = v, v = f / |f|
+        syncmem_complex_op()(this->ctx, this->ctx, v0, v, this->dim);
+        vector_div_constant_op<T, Device>()(this->ctx, this->dim, v, f, fnorm);
+        beta[j - 1] = fnorm;
+
+        // f = H v - beta v0 - alpha v
+        hpsi_func(v, f, this->dim, 1);
+        constantvector_addORsub_constantVector_op<T, Device>()(this->ctx, this->dim, f, f, 1.0, v0, -fnorm);
+        alpha[j] = dot_real_op<T, Device>()(this->ctx, this->dim, v, f);
+        constantvector_addORsub_constantVector_op<T, Device>()(this->ctx, this->dim, f, f, 1.0, v, -alpha[j]);
+
+        fnorm = std::sqrt(dot_real_op<T, Device>()(this->ctx, this->dim, f, f));
+        nstep++;
+    }
+
+    delmem_complex_op()(this->ctx, v0);
+    delmem_complex_op()(this->ctx, v);
+    delmem_complex_op()(this->ctx, f);
+
+    // eigenvalues of the tridiagonal matrix, in ascending order
+    int info = 0;
+    dsterf_(&nstep, alpha.data(), beta.data(), &info);
+    assert(info == 0);
+
+    ModuleBase::timer::tick("DiagoChebFilter", "upper_bound");
+    return static_cast<Real>(alpha[nstep - 1]) + fnorm;
+}
+
+template <typename T, typename Device>
+void DiagoChebFilter<T, Device>::normalize(const int first, const int nvec)
+{
+    T* psi_first = this->psi_iter + first * this->dim;
+    std::vector<double> norm(nvec, 0.0);
+    for (int m = 0; m < nvec; m++)
+    {
+        norm[m] = dot_real_op<T, Device>()(this->ctx,
+                                           this->dim,
+                                           psi_first + m * this->dim,
+                                           psi_first + m * this->dim,
+                                           false);
+    }
+    if (this->diag_comm.nproc > 1)
+    {
+        Parallel_Reduce::reduce_pool(norm.data(), nvec);
+    }
+    for (int m = 0; m < nvec; m++)
+    {
+        vector_div_constant_op<T, Device>()(this->ctx,
+                                            this->dim,
+                                            psi_first + m * this->dim,
+                                            psi_first + m * this->dim,
+                                            static_cast<Real>(std::sqrt(norm[m])));
+    }
+}
+
+template <typename T, typename Device>
+void DiagoChebFilter<T, Device>::build_buffer(const HPsiFunc& hpsi_func)
+{
+    ModuleBase::timer::tick("DiagoChebFilter", "build_buffer");
+
+    const int first = this->n_band - this->n_buffer;
+
+    // Rayleigh quotients <psi|H|psi> / <psi|psi> of the highest bands, one reduction for all of them
+    std::vector<double> quotient(2 * this->n_buffer, 0.0);
+    for (int j = 0; j < this->n_buffer; j++)
+    {
+        const T* psi_j = this->psi_iter + (first + j) * this->dim;
+        quotient[2 * j] = dot_real_op<T, Device>()(this->ctx, this->dim, psi_j, this->hphi + (first + j) * this->dim, false);
+        quotient[2 * j + 1] = dot_real_op<T, Device>()(this->ctx, this->dim, psi_j, psi_j, false);
+    }
+    if (this->diag_comm.nproc > 1)
+    {
+        Parallel_Reduce::reduce_pool(quotient.data(), 2 * this->n_buffer);
+    }
+
+    // residuals H psi - e psi point to the part of the spectrum just above the wanted bands
+    std::vector<double> rnorm(this->n_buffer, 0.0);
+    for (int j = 0; j < this->n_buffer; j++)
+    {
+        T* buffer_j = this->psi_iter + (this->n_band + j) * this->dim;
+        constantvector_addORsub_constantVector_op<T, Device>()(this->ctx,
+                                                               this->dim,
+                                                               buffer_j,
+                                                               this->hphi + (first + j) * this->dim,
+                                                               1.0,
+                                                               this->psi_iter + (first + j) * this->dim,
+                                                               -quotient[2 * j] / quotient[2 * j + 1]);
+        rnorm[j] = dot_real_op<T, Device>()(this->ctx, this->dim, buffer_j, buffer_j, false);
+    }
+    if (this->diag_comm.nproc > 1)
+    {
+        Parallel_Reduce::reduce_pool(rnorm.data(), this->n_buffer);
+    }
+
+    // an exact eigenvector has no residual, use a random direction instead
+    std::mt19937 rng(this->diag_comm.rank + 1);
+    std::uniform_real_distribution<Real> uniform(-0.5, 0.5);
+    std::vector<T> random_cpu(this->dim);
+    for (int j = 0; j < this->n_buffer; j++)
+    {
+        if (rnorm[j] < 1.0e-20 * quotient[2 * j + 1])
+        {
+            for (int i = 0; i < this->dim; i++)
+            {
+                random_cpu[i] = T(uniform(rng), uniform(rng));
+            }
+            syncmem_h2d_op()(this->ctx,
+                             this->cpu_ctx,
+                             this->psi_iter + (this->n_band + j) * this->dim,
+                             random_cpu.data(),
+                             this->dim);
+        }
+    }
+
+    this->normalize(this->n_band, this->n_buffer);
+    hpsi_func(this->psi_iter + this->n_band * this->dim, this->hphi + this->n_band * this->dim, this->dim, this->n_buffer);
+
+    ModuleBase::timer::tick("DiagoChebFilter", "build_buffer");
+}
+
+template <typename T, typename Device>
+void DiagoChebFilter<T, Device>::chebyshev_filter(const HPsiFunc& hpsi_func,
+                                                  const Real lower,
+                                                  const Real upper,
+                                                  const Real scale)
+{
+    ModuleBase::timer::tick("DiagoChebFilter", "filter");
+
+    const int size = this->n_block * this->dim;
+    const Real e = (upper - lower) / 2;
+    const Real c = (upper + lower) / 2;
+    Real sigma = e / (scale - c);
+    const Real tau = 2 / sigma;
+
+    // Y = (H - c) X * sigma / e, X = psi_iter, H X = hphi, Y = work
+    constantvector_addORsub_constantVector_op<T, Device>()(this->ctx,
+                                                           size,
+                                                           this->work,
+                                                           this->hphi,
+                                                           sigma / e,
+                                                           this->psi_iter,
+                                                           -c * sigma / e);
+
+    for (int i = 1; i < this->degree; i++)
+    {
+        const Real sigma_new = 1 / (tau - sigma);
+
+        // Y_new = (H - c) Y * 2 sigma_new / e - sigma * sigma_new * X, built in hphi
+        hpsi_func(this->work, this->hphi, this->dim, this->n_block);
+        constantvector_addORsub_constantVector_op<T, Device>()(this->ctx,
+                                                               size,
+                                                               this->hphi,
+                                                               this->hphi,
+                                                               2 * sigma_new / e,
+                                                               this->work,
+                                                               -2 * c * sigma_new / e);
+        constantvector_addORsub_constantVector_op<T, Device>()(this->ctx,
+                                                               size,
+                                                               this->hphi,
+                                                               this->hphi,
+                                                               1.0,
+                                                               this->psi_iter,
+                                                               -sigma * sigma_new);
+
+        // X <- Y, Y <- Y_new, and the old X becomes the free buffer
+        T* old_x = this->psi_iter;
+        this->psi_iter = this->work;
+        this->work = this->hphi;
+        this->hphi = old_x;
+
+        sigma = sigma_new;
+    }
+
+    // the filtered block is Y
+    std::swap(this->psi_iter, this->work);
+
+    ModuleBase::timer::tick("DiagoChebFilter", "filter");
+}
+
+template <typename T, typename Device>
+void DiagoChebFilter<T, Device>::subspace_matrix(const T* left, const T* right, std::vector<T>& out)
+{
+    // out = left^H right on the device, summed over the pool on the host
+    gemm_op<T, Device>()(this->ctx,
+                         'C',
+                         'N',
+                         this->n_block,
+                         this->n_block,
+                         this->dim,
+                         &this->one_,
+                         left,
+                         this->dim,
+                         right,
+                         this->dim,
+                         &this->zero_,
+                         this->hcc,
+                         this->n_block);
+    syncmem_d2h_op()(this->cpu_ctx, this->ctx, out.data(), this->hcc, this->n_block * this->n_block);
+    if (this->diag_comm.nproc > 1)
+    {
+        Parallel_Reduce::reduce_pool(out.data(), this->n_block * this->n_block);
+    }
+}
+
+template <typename T, typename Device>
+void DiagoChebFilter<T, Device>::rotate(T*& block)
+{
+    // block = block * vcc, vcc is copied from vcc_cpu
+    syncmem_h2d_op()(this->ctx, this->cpu_ctx, this->vcc, this->vcc_cpu.data(), this->n_block * this->n_block);
+    gemm_op<T, Device>()(this->ctx,
+                         'N',
+                         'N',
+                         this->dim,
+                         this->n_block,
+                         this->n_block,
+                         &this->one_,
+                         block,
+                         this->dim,
+                         this->vcc,
+                         this->n_block,
+                         &this->zero_,
+                         this->work,
+                         this->dim);
+    std::swap(block, this->work);
+}
+
+template <typename T, typename Device>
+void DiagoChebFilter<T, Device>::orthonormalize(const bool with_hphi)
+{
+    ModuleBase::timer::tick("DiagoChebFilter", "orthonormalize");
+
+    const int n = this->n_block;
+    // the filtered block is ill-conditioned, the second pass of Cholesky-QR restores the orthogonality
+    for (int pass = 0; pass < 2; pass++)
+    {
+        this->subspace_matrix(this->psi_iter, this->psi_iter, this->scc_cpu);
+
+        // S = R^H R, R is kept in the upper triangle of vcc_cpu
+        this->vcc_cpu = this->scc_cpu;
+        int info = 0;
+        container::lapackConnector::potrf('U', n, this->vcc_cpu.data(), n, info);
+        if (info != 0)
+        {
+            // shifted Cholesky-QR: S + s I is positive definite for columns which are dependent in working precision
+            Real trace = 0.0;
+            for (int i = 0; i < n; i++)
+            {
+                trace += std::real(this->scc_cpu[i * n + i]);
+            }
+            const Real dim_tot = static_cast<Real>(this->dim) * this->diag_comm.nproc;
+            const Real shift = 11 * (dim_tot * n + n * (n + 1)) * std::numeric_limits<Real>::epsilon() * trace;
+            this->vcc_cpu = this->scc_cpu;
+            for (int i = 0; i < n; i++)
+            {
+                this->vcc_cpu[i * n + i] += shift;
+            }
+            container::lapackConnector::potrf('U', n, this->vcc_cpu.data(), n, info);
+            if (info != 0)
+            {
+                ModuleBase::WARNING_QUIT("DiagoChebFilter", "the Cholesky factorization of the filtered block failed");
+            }
+        }
+        container::lapackConnector::trtri('U', 'N', n, this->vcc_cpu.data(), n, info);
+        assert(info == 0);
+        for (int j = 0; j < n; j++)
+        {
+            for (int i = j + 1; i < n; i++)
+            {
+                this->vcc_cpu[j * n + i] = this->zero_;
+            }
+        }
+
+        // psi R^{-1} has orthonormal columns, H psi R^{-1} follows
+        this->rotate(this->psi_iter);
+        if (with_hphi)
+        {
+            this->rotate(this->hphi);
+        }
+    }
+
+    ModuleBase::timer::tick("DiagoChebFilter", "orthonormalize");
+}
+
+template <typename T, typename Device>
+void DiagoChebFilter<T, Device>::rayleigh_ritz(Real* eigenvalue_out)
+{
+    ModuleBase::timer::tick("DiagoChebFilter", "rayleigh_ritz");
+
+    // psi is orthonormal, the Ritz pairs come from the standard eigenproblem of hcc = psi^H H psi;
+    // every rank solves the same small problem, so no broadcast is needed
+    this->subspace_matrix(this->psi_iter, this->hphi, this->hcc_cpu);
+    dnevx_op<T, base_device::DEVICE_CPU>()(this->cpu_ctx,
+                                           this->n_block,
+                                           this->n_block,
+                                           this->hcc_cpu.data(),
+                                           this->n_block,
+                                           eigenvalue_out,
+                                           this->vcc_cpu.data());
+
+    // rotate psi and hpsi onto the Ritz vectors
+    this->rotate(this->psi_iter);
+    this->rotate(this->hphi);
+
+    ModuleBase::timer::tick("DiagoChebFilter", "rayleigh_ritz");
+}
+
+template <typename T, typename Device>
+int DiagoChebFilter<T, Device>::diag(const HPsiFunc& hpsi_func,
+                                     T* psi_in,
+                                     const int psi_in_dmax,
+                                     Real* eigenvalue_in,
+                                     const std::vector<double>& ethr_band,
+                                     const bool& scf_type,
+                                     const int ik)
+{
+    ModuleBase::timer::tick("DiagoChebFilter", "diag");
+
+    for (int m = 0; m < this->n_band; m++)
+    {
+        syncmem_complex_op()(this->ctx, this->ctx, this->psi_iter + m * this->dim, psi_in + m * psi_in_dmax, this->dim);
+    }
+
+    // Ritz values of the starting block give the lower end of the spectrum
+    // and the lower bound of the damped interval
+    std::vector<Real> eigenvalue_iter(this->n_block, 0.0);
+    std::vector<Real> eigenvalue_new(this->n_block, 0.0);
+    hpsi_func(this->psi_iter, this->hphi, this->dim, this->n_band);
+    this->build_buffer(hpsi_func);
+    this->orthonormalize(true);
+    this->rayleigh_ritz(eigenvalue_iter.data());
+
+    // after the first SCF iteration the subspace only needs to follow the change of H,
+    // one filter pass and one Rayleigh-Ritz step are enough
+    const bool single_pass = scf_type && DiagoIterAssist<T, Device>::SCF_ITER > 1;
+    const int npass_max = single_pass ? 1 : std::max(1, this->iter_nmax);
+
+    // the top of the spectrum is set by the kinetic energy at the cutoff and hardly moves during the SCF,
+    // the bound of the first SCF iteration is kept for each k point
+    Real upper = 0.0;
+    if (single_pass && ik >= 0 && static_cast<std::size_t>(ik) < upper_bounds.size() && upper_bounds[ik] > 0.0)
+    {
+        upper = upper_bounds[ik];
+    }
+    else
+    {
+        upper = this->estimate_upper_bound(hpsi_func);
+        if (ik >= 0)
+        {
+            if (static_cast<std::size_t>(ik) >= upper_bounds.size())
+            {
+                upper_bounds.resize(ik + 1, 0.0);
+            }
+            upper_bounds[ik] = upper;
+        }
+    }
+
+    int npass = 0;
+    int notconv = 0;
+    do
+    {
+        ++npass;
+
+        const Real lower = eigenvalue_iter[this->n_block - 1];
+        const Real scale = eigenvalue_iter[0];
+        upper = std::max(upper, lower + (lower - scale) + static_cast<Real>(1.0e-2));
+
+        this->chebyshev_filter(hpsi_func, lower, upper, scale);
+
+        // the filter changes the norms of the columns by orders of magnitude
+        this->normalize(0, this->n_block);
+        this->orthonormalize(false);
+        hpsi_func(this->psi_iter, this->hphi, this->dim, this->n_block);
+        this->rayleigh_ritz(eigenvalue_new.data());
+
+        notconv = 0;
+        for (int m = 0; m < this->n_block; m++)
+        {
+            if (m < this->n_band && std::abs(eigenvalue_new[m] - eigenvalue_iter[m]) > ethr_band[m])
+            {
+                notconv++;
+            }
+            eigenvalue_iter[m] = eigenvalue_new[m];
+        }
+    } while (notconv > 0 && npass < npass_max);
+
+    for (int m = 0; m < this->n_band; m++)
+    {
+        syncmem_complex_op()(this->ctx, this->ctx, psi_in + m * psi_in_dmax, this->psi_iter + m * this->dim, this->dim);
+        eigenvalue_in[m] = eigenvalue_iter[m];
+    }
+
+    ModuleBase::timer::tick("DiagoChebFilter", "diag");
+    return npass;
+}
+
+namespace hsolver
+{
+
+template class DiagoChebFilter<std::complex<float>, base_device::DEVICE_CPU>;
+template class DiagoChebFilter<std::complex<double>, base_device::DEVICE_CPU>;
+
+#if ((defined __CUDA) || (defined __ROCM))
+template class DiagoChebFilter<std::complex<float>, base_device::DEVICE_GPU>;
+template class DiagoChebFilter<std::complex<double>, base_device::DEVICE_GPU>;
+#endif
+
+} // namespace hsolver
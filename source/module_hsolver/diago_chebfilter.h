@@ -0,0 +1,204 @@
+#ifndef DIAGO_CHEBFILTER_H
+#define DIAGO_CHEBFILTER_H
+
+#include "module_base/macros.h"                  // GetRealType
+#include "module_base/module_device/device.h"    // base_device
+#include "module_base/module_device/memory_op.h" // base_device::memory
+
+#include "module_hsolver/diag_comm_info.h"
+
+#include <functional>
+#include <vector>
+
+namespace hsolver
+{
+/**
+ * @class DiagoChebFilter
+ * @brief Chebyshev-filtered subspace iteration (ChFSI) for the lowest eigenpairs of H.
+ *
+ * Every pass applies a degree-m scaled Chebyshev polynomial of H to the whole block of bands,
+ * which damps the unwanted part [b_low, b_up] of the spectrum. The filtered block is orthonormalized
+ * by Cholesky-QR and a single Rayleigh-Ritz step solves the standard eigenproblem in its span.
+ * The upper bound b_up is estimated with a few Lanczos steps in the first SCF iteration and kept
+ * for each k point; b_low and the scaling point are taken from the current Ritz values.
+ *
+ * The block is augmented with a few buffer vectors built from the residuals of the highest bands,
+ * so that b_low lies above the wanted part of the spectrum and the highest wanted bands
+ * are amplified with respect to the damped interval.
+ *
+ * The work is dominated by block hpsi_func calls and GEMMs, and the only communication
+ * is the reduction of the small subspace matrices, which are copied to the host for it.
+ *
+ * @tparam T The data type of the wavefunction (std::complex<float>, std::complex<double>).
+ * @tparam Device The device type (base_device::DEVICE_CPU or DEVICE_GPU).
+ */
+template <typename T = std::complex<double>, typename Device = base_device::DEVICE_CPU>
+class DiagoChebFilter
+{
+  private:
+    // Note GetTypeReal<T>::type will
+    // return T if T is real type(float, double),
+    // otherwise return the real type of T(complex<float>, complex<double>)
+    using Real = typename GetTypeReal<T>::type;
+
+  public:
+    /**
+     * @brief Constructor for the DiagoChebFilter class.
+     *
+     * @param[in] nband_in Number of eigenpairs required (i.e. bands).
+     * @param[in] dim_in Dimension of the matrix (local number of plane waves).
+     * @param[in] degree_in Degree of the Chebyshev filter applied in every pass.
+     * @param[in] diag_nmax_in Maximal number of filter passes when the subspace is not converged yet.
+     * @param[in] diag_comm_in Communication information for diagonalization.
+     */
+    DiagoChebFilter(const int nband_in,
+                    const int dim_in,
+                    const int degree_in,
+                    const int diag_nmax_in,
+                    const diag_comm_info& diag_comm_in);
+
+    ~DiagoChebFilter();
+
+    // See diago_bpcg.h for information on the HPsiFunc function type
+    using HPsiFunc = std::function<void(T*, T*, const int, const int)>;
+
+    /**
+     * @brief Filter psi and update the eigenvalues.
+     *
+     * In the first SCF iteration (or in non-SCF runs) passes are repeated until the Ritz values
+     * stop changing within ethr_band; in later SCF iterations a single pass is done, relying on
+     * the SCF loop itself to refine the subspace.
+     *
+     * @param hpsi_func A function computing the product of H and a blockvector X.
+     * @param psi_in Wavefunction psi [dim: psi_in_dmax x nband, column major].
+     * @param psi_in_dmax Leading dimension of psi_in.
+     * @param eigenvalue_in Output eigenvalues [dim: nband].
+     * @param ethr_band Convergence threshold of each band.
+     * @param scf_type true for scf, false for nscf.
+     * @param ik Index of the k point whose upper bound of the spectrum is kept across the SCF iterations,
+     *           a negative value estimates it in every call.
+     * @return The number of filter passes.
+     */
+    int diag(const HPsiFunc& hpsi_func,
+             T* psi_in,
+             const int psi_in_dmax,
+             Real* eigenvalue_in,
+             const std::vector<double>& ethr_band,
+             const bool& scf_type,
+             const int ik = -1);
+
+  private:
+    /// for MPI communication
+    const diag_comm_info diag_comm;
+
+    /// the number of eigenpairs sought
+    const int n_band = 0;
+
+    /// the dimension of the matrix (local part)
+    const int dim = 0;
+
+    /// degree of the Chebyshev polynomial
+    const int degree = 0;
+
+    /// maximal number of filter passes
+    const int iter_nmax = 0;
+
+    /// number of buffer vectors appended to the wanted bands
+    int n_buffer = 0;
+
+    /// size of the filtered block, n_band + n_buffer
+    int n_block = 0;
+
+    /// number of Lanczos steps used to estimate the upper bound of the spectrum
+    const int nlanczos = 10;
+
+    /// current block, the filtered block and H times one of them,
+    /// the three buffers are rotated during the three-term recurrence
+    T* psi_iter = nullptr;
+    T* hphi = nullptr;
+    T* work = nullptr;
+
+    /// subspace matrix of the filtered block and the rotation applied to it on the device
+    T* hcc = nullptr;
+    T* vcc = nullptr;
+
+    /// Hamiltonian, overlap and rotation in the subspace of the filtered block on the host
+    std::vector<T> hcc_cpu;
+    std::vector<T> scc_cpu;
+    std::vector<T> vcc_cpu;
+
+    /// upper bound of the spectrum of each k point, estimated in the first SCF iteration
+    static std::vector<Real> upper_bounds;
+
+    /// device type of psi
+    Device* ctx = {};
+    base_device::DEVICE_CPU* cpu_ctx = {};
+    base_device::AbacusDevice_t device = {};
+
+    /**
+     * @brief Estimate the upper bound of the spectrum of H with k-step Lanczos.
+     *
+     * The returned value is the largest Ritz value of the Lanczos tridiagonal matrix
+     * plus the norm of the last residual, which is a safe upper bound in practice.
+     */
+    Real estimate_upper_bound(const HPsiFunc& hpsi_func);
+
+    /**
+     * @brief Fill the buffer columns of psi_iter with the normalized residuals H psi - e psi
+     * of the highest n_buffer bands, using hphi = H * psi_iter for the first n_band columns.
+     */
+    void build_buffer(const HPsiFunc& hpsi_func);
+
+    /**
+     * @brief Normalize nvec columns of psi_iter starting from column first, with a single reduction for all norms.
+     */
+    void normalize(const int first, const int nvec);
+
+    /**
+     * @brief Apply the scaled Chebyshev filter to psi_iter, using hphi = H * psi_iter on input.
+     *
+     * On output psi_iter holds the filtered block and the content of hphi and work is undefined.
+     *
+     * @param lower Lower bound of the damped interval.
+     * @param upper Upper bound of the damped interval.
+     * @param scale Point in the wanted interval where the filter is normalized (lowest Ritz value).
+     */
+    void chebyshev_filter(const HPsiFunc& hpsi_func, const Real lower, const Real upper, const Real scale);
+
+    /**
+     * @brief out = left^H right of two blocks, reduced over the pool on the host.
+     */
+    void subspace_matrix(const T* left, const T* right, std::vector<T>& out);
+
+    /**
+     * @brief block = block * vcc_cpu, using work as the buffer.
+     */
+    void rotate(T*& block);
+
+    /**
+     * @brief Orthonormalize psi_iter by two passes of Cholesky-QR, shifted if the Gram matrix is singular.
+     *
+     * @param with_hphi Whether hphi = H * psi_iter is rotated along with psi_iter.
+     */
+    void orthonormalize(const bool with_hphi);
+
+    /**
+     * @brief Rayleigh-Ritz step on the orthonormal block psi_iter with hphi = H * psi_iter.
+     *
+     * psi_iter and hphi are rotated onto the Ritz vectors and eigenvalue_out holds the n_block Ritz values.
+     */
+    void rayleigh_ritz(Real* eigenvalue_out);
+
+    using resmem_complex_op = base_device::memory::resize_memory_op<T, Device>;
+    using delmem_complex_op = base_device::memory::delete_memory_op<T, Device>;
+    using setmem_complex_op = base_device::memory::set_memory_op<T, Device>;
+    using syncmem_complex_op = base_device::memory::synchronize_memory_op<T, Device, Device>;
+    using syncmem_h2d_op = base_device::memory::synchronize_memory_op<T, Device, base_device::DEVICE_CPU>;
+    using syncmem_d2h_op = base_device::memory::synchronize_memory_op<T, base_device::DEVICE_CPU, Device>;
+
+    const T one_ = static_cast<T>(1.0), zero_ = static_cast<T>(0.0);
+};
+
+} // namespace hsolver
+
+#endif
@@ -6,6 +6,9 @@
 
 #include "module_hsolver/kernels/dngvd_op.h"
 #include "module_hsolver/kernels/math_kernel_op.h"
+#ifdef __MPI
+#include "module_base/parallel_device.h"
+#endif
 
 #ifdef USE_PAW
 #include "module_cell/module_paw/paw_cell.h"
@@ -21,7 +24,24 @@ DiagoDavid<T, Device>::DiagoDavid(const Real* precondition_in,
                                   const int david_ndim_in,
                                   const bool use_paw_in,
                                   const diag_comm_info& diag_comm_in)
-    : nband(nband_in), dim(dim_in), nbase_x(david_ndim_in * nband_in), david_ndim(david_ndim_in), use_paw(use_paw_in), diag_comm(diag_comm_in)
+#ifdef __MPI
+    : DiagoDavid(precondition_in, nband_in, dim_in, david_ndim_in, use_paw_in, diag_comm_in, diag_comm_info(MPI_COMM_SELF, 0, 1))
+#else
+    : DiagoDavid(precondition_in, nband_in, dim_in, david_ndim_in, use_paw_in, diag_comm_in, diag_comm_info(0, 1))
+#endif
+{
+}
+
+template <typename T, typename Device>
+DiagoDavid<T, Device>::DiagoDavid(const Real* precondition_in,
+                                  const int nband_in,
+                                  const int dim_in,
+                                  const int david_ndim_in,
+                                  const bool use_paw_in,
+                                  const diag_comm_info& diag_comm_in,
+                                  const diag_comm_info& band_comm_in)
+    : nband(nband_in), dim(dim_in), nbase_x(david_ndim_in * nband_in), david_ndim(david_ndim_in), use_paw(use_paw_in), diag_comm(diag_comm_in),
+      band_comm(band_comm_in)
 {
     this->device = base_device::get_device_type<Device>(this->ctx);
     this->precondition = precondition_in;
@@ -596,21 +616,29 @@ void DiagoDavid<T, Device>::cal_elem(const int& dim,
     }
     ModuleBase::timer::tick("DiagoDavid", "cal_elem");
 
+    // with band groups, each group computes its own rows of the new block, which are gathered below
+    int row_start = 0;
+    int row_num = notconv;
+    band_group_range(notconv, band_comm.nproc, band_comm.rank, row_start, row_num);
+
     // hcc[nbase](notconv, nbase + notconv)= basis[nbase]' * hpsi
-    gemm_op<T, Device>()(this->ctx,
-                              'C',
-                              'N',
-                              notconv,
-                              nbase + notconv,
-                              dim,
-                              this->one,
-                              basis + dim*nbase, // basis(:,nbase:)  dim * notconv
-                              dim,
-                              hpsi,               // dim * (nbase + notconv)
-                              dim,
-                              this->zero,
-                              hcc + nbase,        // notconv * (nbase + notconv)
-                              nbase_x);
+    if (row_num > 0)
+    {
+        gemm_op<T, Device>()(this->ctx,
+                                  'C',
+                                  'N',
+                                  row_num,
+                                  nbase + notconv,
+                                  dim,
+                                  this->one,
+                                  basis + dim*(nbase + row_start), // basis(:,nbase + row_start:)  dim * row_num
+                                  dim,
+                                  hpsi,               // dim * (nbase + notconv)
+                                  dim,
+                                  this->zero,
+                                  hcc + nbase + row_start, // row_num * (nbase + notconv)
+                                  nbase_x);
+    }
     // scc[nbase] = basis[nbase]' * spsi
     // gemm_op<T, Device>()(this->ctx,
     //                           'C',
@@ -629,38 +657,61 @@ void DiagoDavid<T, Device>::cal_elem(const int& dim,
 
 
 #ifdef __MPI
-    if (diag_comm.nproc > 1)
+    if (diag_comm.nproc > 1 || band_comm.nproc > 1)
     {
         matrixTranspose_op<T, Device>()(this->ctx, nbase_x, nbase_x, hcc, hcc);
         // matrixTranspose_op<T, Device>()(this->ctx, nbase_x, nbase_x, scc, scc);
 
-        auto* swap = new T[notconv * nbase_x];
-        syncmem_complex_op()(this->ctx, this->ctx, swap, hcc + nbase * nbase_x, notconv * nbase_x);
-        if (std::is_same<T, double>::value)
+        // rows of the new block are contiguous in the transposed hcc
+        T* hcc_rows = hcc + (nbase + row_start) * nbase_x;
+        if (diag_comm.nproc > 1 && row_num > 0)
         {
-            Parallel_Reduce::reduce_pool(hcc + nbase * nbase_x, notconv * nbase_x);
-        }
-        else
-        {
-            if (base_device::get_current_precision(swap) == "single") {
-                MPI_Reduce(swap, hcc + nbase * nbase_x, notconv * nbase_x, MPI_COMPLEX, MPI_SUM, 0, diag_comm.comm);
-            }
-            else {
-                MPI_Reduce(swap, hcc + nbase * nbase_x, notconv * nbase_x, MPI_DOUBLE_COMPLEX, MPI_SUM, 0, diag_comm.comm);
-            }
-            // syncmem_complex_op()(this->ctx, this->ctx, swap, scc + nbase * nbase_x, notconv * nbase_x);
-            if (base_device::get_current_precision(swap) == "single") {
-                // MPI_Reduce(swap, scc + nbase * nbase_x, notconv * nbase_x, MPI_COMPLEX, MPI_SUM, 0, diag_comm.comm);
+            auto* swap = new T[row_num * nbase_x];
+            syncmem_complex_op()(this->ctx, this->ctx, swap, hcc_rows, row_num * nbase_x);
+            if (std::is_same<T, double>::value)
+            {
+                Parallel_Reduce::reduce_pool(hcc_rows, row_num * nbase_x);
             }
-            else {
-                // MPI_Reduce(swap, scc + nbase * nbase_x, notconv * nbase_x, MPI_DOUBLE_COMPLEX, MPI_SUM, 0, diag_comm.comm);
+            else
+            {
+                if (base_device::get_current_precision(swap) == "single") {
+                    MPI_Reduce(swap, hcc_rows, row_num * nbase_x, MPI_COMPLEX, MPI_SUM, 0, diag_comm.comm);
+                }
+                else {
+                    MPI_Reduce(swap, hcc_rows, row_num * nbase_x, MPI_DOUBLE_COMPLEX, MPI_SUM, 0, diag_comm.comm);
+                }
+                // syncmem_complex_op()(this->ctx, this->ctx, swap, scc + nbase * nbase_x, notconv * nbase_x);
+                if (base_device::get_current_precision(swap) == "single") {
+                    // MPI_Reduce(swap, scc + nbase * nbase_x, notconv * nbase_x, MPI_COMPLEX, MPI_SUM, 0, diag_comm.comm);
+                }
+                else {
+                    // MPI_Reduce(swap, scc + nbase * nbase_x, notconv * nbase_x, MPI_DOUBLE_COMPLEX, MPI_SUM, 0, diag_comm.comm);
+                }
             }
+            delete[] swap;
         }
-        delete[] swap;
 
         // Parallel_Reduce::reduce_complex_double_pool( hcc + nbase * nbase_x, notconv * nbase_x );
         // Parallel_Reduce::reduce_complex_double_pool( scc + nbase * nbase_x, notconv * nbase_x );
 
+        if (band_comm.nproc > 1)
+        {
+            std::vector<int> counts(band_comm.nproc, 0);
+            std::vector<int> displs(band_comm.nproc, 0);
+            for (int ip = 0; ip < band_comm.nproc; ++ip)
+            {
+                band_group_range(notconv, band_comm.nproc, ip, displs[ip], counts[ip]);
+                counts[ip] *= nbase_x;
+                displs[ip] = (nbase + displs[ip]) * nbase_x;
+            }
+            Parallel_Common::gatherv_dev(this->ctx,
+                                         hcc,
+                                         nbase_x * nbase_x,
+                                         counts.data(),
+                                         displs.data(),
+                                         band_comm.comm);
+        }
+
         matrixTranspose_op<T, Device>()(this->ctx, nbase_x, nbase_x, hcc, hcc);
         // matrixTranspose_op<T, Device>()(this->ctx, nbase_x, nbase_x, scc, scc);
     }
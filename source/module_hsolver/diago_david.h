@@ -5,6 +5,7 @@
 #include "module_base/module_device/device.h"   // base_device
 #include "module_base/module_device/memory_op.h"// base_device::memory
 
+#include "module_hsolver/diag_band_group.h"
 #include "module_hsolver/diag_comm_info.h"
 
 #include <vector>
@@ -57,6 +58,22 @@ class DiagoDavid
                const bool use_paw_in,
                const diag_comm_info& diag_comm_in);
 
+    /**
+     * @brief Constructor with band groups.
+     *
+     * The same as above, with the rows of the reduced Hamiltonian split over the band groups
+     * connected by `band_comm_in` (rank = index of the group, nproc = number of groups).
+     * All groups must hold the same basis and call `diag` together; the hpsi_func passed to `diag`
+     * is expected to return the full H * X in every group, e.g. through band_group_hpsi.
+     */
+    DiagoDavid(const Real* precondition_in,
+               const int nband_in,
+               const int dim_in,
+               const int david_ndim_in,
+               const bool use_paw_in,
+               const diag_comm_info& diag_comm_in,
+               const diag_comm_info& band_comm_in);
+
     /**
      * @brief Destructor for the DiagoDavid class.
      * 
@@ -143,6 +160,8 @@ class DiagoDavid
     int test_david = 0;
 
     diag_comm_info diag_comm;
+    /// communicator between the band groups, a single group by default
+    diag_comm_info band_comm;
 
     /// number of required eigenpairs
     const int nband;
@@ -0,0 +1,213 @@
+#include "diago_foe.h"
+
+#include "module_base/global_function.h"
+#include "module_base/global_variable.h"
+#include "module_base/timer.h"
+#include "module_base/tool_quit.h"
+#include "module_base/tool_title.h"
+#include "module_elecstate/occupy.h"
+#include "module_foe/foe_solver.h"
+#include "module_hamilt_lcao/hamilt_lcaodft/hamilt_lcao.h"
+#include "module_hamilt_lcao/module_hcontainer/hcontainer_funcs.h"
+#include "module_parameter/parameter.h"
+
+#include <algorithm>
+#include <complex>
+
+namespace hsolver
+{
+
+template <typename T>
+DiagoFoe<T>::DiagoFoe(const Parallel_Orbitals* ParaV_in) : ParaV(ParaV_in)
+{
+}
+
+template <typename T>
+DiagoFoe<T>::~DiagoFoe()
+{
+}
+
+namespace
+{
+// column atoms of the local atom rows in the 2D-block HContainers of all ranks
+std::vector<std::vector<int>> gather_row_pattern(const foe::AtomRows& rows, const hamilt::HContainer<double>& hr_2d)
+{
+    // every pair <I,J> is sent to the owner of atom I
+    std::vector<std::vector<int>> pairs(rows.nproc);
+    for (int iap = 0; iap < hr_2d.size_atom_pairs(); ++iap)
+    {
+        const hamilt::AtomPair<double>& ap = hr_2d.get_atom_pair(iap);
+        std::vector<int>& to = pairs[rows.owner[ap.get_atom_i()]];
+        to.push_back(ap.get_atom_i());
+        to.push_back(ap.get_atom_j());
+    }
+    std::vector<int> sendbuf;
+    std::vector<int> sendcounts(rows.nproc, 0);
+    std::vector<int> sdispls(rows.nproc, 0);
+    for (int ip = 0; ip < rows.nproc; ++ip)
+    {
+        sdispls[ip] = sendbuf.size();
+        sendcounts[ip] = pairs[ip].size();
+        sendbuf.insert(sendbuf.end(), pairs[ip].begin(), pairs[ip].end());
+    }
+    std::vector<int> recvcounts(rows.nproc, 0);
+    std::vector<int> rdispls(rows.nproc, 0);
+    MPI_Alltoall(sendcounts.data(), 1, MPI_INT, recvcounts.data(), 1, MPI_INT, rows.comm);
+    int recv_size = 0;
+    for (int ip = 0; ip < rows.nproc; ++ip)
+    {
+        rdispls[ip] = recv_size;
+        recv_size += recvcounts[ip];
+    }
+    std::vector<int> recvbuf(recv_size);
+    MPI_Alltoallv(sendbuf.data(),
+                  sendcounts.data(),
+                  sdispls.data(),
+                  MPI_INT,
+                  recvbuf.data(),
+                  recvcounts.data(),
+                  rdispls.data(),
+                  MPI_INT,
+                  rows.comm);
+
+    std::vector<std::vector<int>> cols(rows.last_atom - rows.first_atom);
+    for (int n = 0; n < recv_size; n += 2)
+    {
+        cols[recvbuf[n] - rows.first_atom].push_back(recvbuf[n + 1]);
+    }
+    for (auto& col: cols)
+    {
+        std::sort(col.begin(), col.end());
+        col.erase(std::unique(col.begin(), col.end()), col.end());
+    }
+    return cols;
+}
+} // namespace
+
+template <typename T>
+void DiagoFoe<T>::to_2d(const foe::BlockSparseMatrix& m,
+                        hamilt::HContainer<double>* out,
+                        std::unique_ptr<hamilt::HTransferPlan<double>>& plan)
+{
+    // the blocks of m on the pattern of DM(R), the blocks dropped by the truncation are zero
+    hamilt::HContainer<double>& m_rows = this->dm_pattern->get_hr();
+    m_rows.set_zero();
+    for (int iap = 0; iap < m_rows.size_atom_pairs(); ++iap)
+    {
+        hamilt::AtomPair<double>& ap = m_rows.get_atom_pair(iap);
+        const double* block = m.find_block(ap.get_atom_i(), ap.get_atom_j());
+        if (block != nullptr)
+        {
+            std::copy(block, block + ap.get_size(), ap.get_pointer(0));
+        }
+    }
+    out->set_zero();
+    hamilt::transferSerials2Parallels(m_rows, out, plan);
+}
+
+template <>
+void DiagoFoe<double>::add_spin(hamilt::Hamilt<double>* phm_in, const int ik)
+{
+    ModuleBase::TITLE("DiagoFoe", "add_spin");
+    ModuleBase::timer::tick("DiagoFoe", "add_spin");
+    auto* hamilt_lcao = dynamic_cast<hamilt::HamiltLCAO<double, double>*>(phm_in);
+    if (hamilt_lcao == nullptr)
+    {
+        ModuleBase::WARNING_QUIT("DiagoFoe::add_spin", "foe needs the H(R) and S(R) of the LCAO Hamiltonian");
+    }
+    hamilt_lcao->updateHR(ik);
+    const hamilt::HContainer<double>* hR = hamilt_lcao->getHR();
+    if (this->rows == nullptr)
+    {
+        const hamilt::HContainer<double>* sR = hamilt_lcao->getSR();
+        const int nat = this->ParaV->atom_begin_row.size() - 1;
+        std::vector<int> atom_begin(nat + 1);
+        for (int iat = 0; iat < nat; ++iat)
+        {
+            atom_begin[iat] = this->ParaV->iat2iwt_[iat];
+        }
+        atom_begin[nat] = this->ParaV->get_global_row_size();
+        this->rows.reset(new foe::AtomRows(atom_begin, this->ParaV->comm()));
+        // S(R) does not change in the SCF, it is moved only once
+        this->s_rows.reset(new foe::BlockSparseMatrix(this->rows.get(), gather_row_pattern(*this->rows, *sR)));
+        hamilt::transferParallels2Serials(*sR, &this->s_rows->get_hr());
+    }
+    // the pattern of H(R) is the same in all the SCF steps, the data of each spin has its own plan
+    const int is = this->nspin_added++;
+    if (is == static_cast<int>(this->h_rows.size()))
+    {
+        this->h_rows.push_back(foe::BlockSparseMatrix(this->rows.get(), gather_row_pattern(*this->rows, *hR)));
+        this->h_plans.emplace_back(nullptr);
+    }
+    hamilt::transferParallels2Serials(*hR, &this->h_rows[is].get_hr(), this->h_plans[is]);
+    ModuleBase::timer::tick("DiagoFoe", "add_spin");
+}
+
+template <>
+void DiagoFoe<double>::solve(const std::vector<double>& nelec,
+                             const bool two_efermi,
+                             elecstate::DensityMatrix<double, double>* dm)
+{
+    ModuleBase::TITLE("DiagoFoe", "solve");
+    ModuleBase::timer::tick("DiagoFoe", "solve");
+    if (!Occupy::gauss())
+    {
+        ModuleBase::WARNING_QUIT("DiagoFoe::solve", "foe needs a smearing of the occupations, please set smearing_method");
+    }
+    foe::FOE_Solver solver(PARAM.inp.foe_thr, PARAM.inp.foe_order, Occupy::gaussian_type, Occupy::gaussian_parameter);
+    const int nspin = this->nspin_added;
+    std::vector<const foe::BlockSparseMatrix*> h;
+    for (int is = 0; is < nspin; ++is)
+    {
+        h.push_back(&this->h_rows[is]);
+    }
+    this->nspin_added = 0;
+    std::vector<foe::BlockSparseMatrix> dm_rows;
+    std::vector<foe::BlockSparseMatrix> edm_rows;
+    solver.solve(h, *this->s_rows, nelec, two_efermi, dm_rows, edm_rows);
+    this->mu = solver.mu;
+    this->eband = solver.eband;
+    this->demet = solver.demet;
+    ModuleBase::GlobalFunc::OUT(GlobalV::ofs_running, "foe Chebyshev order", solver.order_used);
+    ModuleBase::GlobalFunc::OUT(GlobalV::ofs_running, "foe atom pairs of H", this->h_rows[0].nblocks());
+    ModuleBase::GlobalFunc::OUT(GlobalV::ofs_running, "foe atom pairs of DM", dm_rows[0].nblocks());
+
+    if (this->dm_pattern == nullptr)
+    {
+        this->dm_pattern.reset(
+            new foe::BlockSparseMatrix(this->rows.get(), gather_row_pattern(*this->rows, *dm->get_DMR_pointer(1))));
+        this->dm_plans.resize(nspin);
+        this->edm_plans.resize(nspin);
+        for (int is = 0; is < nspin; ++is)
+        {
+            this->edm_r.emplace_back(new hamilt::HContainer<double>(*dm->get_DMR_pointer(is + 1)));
+        }
+    }
+    dm->foe_EDMR.resize(nspin);
+    for (int is = 0; is < nspin; ++is)
+    {
+        this->to_2d(dm_rows[is], dm->get_DMR_pointer(is + 1), this->dm_plans[is]);
+        this->to_2d(edm_rows[is], this->edm_r[is].get(), this->edm_plans[is]);
+        dm->foe_EDMR[is] = this->edm_r[is].get();
+    }
+    ModuleBase::timer::tick("DiagoFoe", "solve");
+}
+
+template <>
+void DiagoFoe<std::complex<double>>::add_spin(hamilt::Hamilt<std::complex<double>>* phm_in, const int ik)
+{
+    ModuleBase::WARNING_QUIT("DiagoFoe", "foe is only implemented for gamma_only calculations");
+}
+
+template <>
+void DiagoFoe<std::complex<double>>::solve(const std::vector<double>& nelec,
+                                           const bool two_efermi,
+                                           elecstate::DensityMatrix<std::complex<double>, double>* dm)
+{
+    ModuleBase::WARNING_QUIT("DiagoFoe", "foe is only implemented for gamma_only calculations");
+}
+
+template class DiagoFoe<double>;
+template class DiagoFoe<std::complex<double>>;
+
+} // namespace hsolver
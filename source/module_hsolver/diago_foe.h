@@ -0,0 +1,74 @@
+#ifndef DIAGOFOE_H
+#define DIAGOFOE_H
+
+#include "module_basis/module_ao/parallel_orbitals.h"
+#include "module_elecstate/module_dm/density_matrix.h"
+#include "module_hamilt_general/hamilt.h"
+#include "module_hamilt_lcao/module_hcontainer/transfer.h"
+#include "module_foe/block_sparse_matrix.h"
+
+#include <memory>
+#include <vector>
+
+namespace hsolver
+{
+
+/**
+ * @brief linear-scaling density matrix of gamma-only LCAO calculations by the Fermi-operator expansion
+ * H(R) and S(R) of the Hamiltonian are moved from the 2D-block HContainers to block-sparse matrices
+ * distributed by atom rows, the density matrices are found by foe::FOE_Solver on the sparsity of the
+ * atom pairs and moved back into the 2D-block DM(R) of the DensityMatrix, no dense matrix is built.
+ * The object is kept during the SCF of one ionic step, so that the sparsity patterns and the
+ * transfer plans are made once, and EDM(R) lives until the forces are calculated.
+ */
+template <typename T>
+class DiagoFoe
+{
+  public:
+    DiagoFoe(const Parallel_Orbitals* ParaV_in);
+    ~DiagoFoe();
+
+    /**
+     * @brief update H(R) of the k point ik and keep it, S(R) is kept at the first call
+     * the k points of gamma-only calculations are the spins, H(k) is not calculated
+     */
+    void add_spin(hamilt::Hamilt<T>* phm_in, const int ik);
+
+    /**
+     * @brief density matrices of all the spins added by add_spin()
+     * @param nelec number of electrons of each spin if two_efermi, otherwise nelec[0] is the total number
+     * @param dm DM(R) of each spin is written into its DMR, EDM(R) is given to dm->foe_EDMR
+     */
+    void solve(const std::vector<double>& nelec, const bool two_efermi, elecstate::DensityMatrix<T, double>* dm);
+
+    // chemical potential of each spin
+    std::vector<double> mu;
+    double eband = 0.0;
+    double demet = 0.0;
+
+  private:
+    const Parallel_Orbitals* ParaV;
+
+    std::unique_ptr<foe::AtomRows> rows;
+    std::unique_ptr<foe::BlockSparseMatrix> s_rows;
+    // H(R) of each spin in the atom rows, and the plans moving them from the 2D-block H(R)
+    std::vector<foe::BlockSparseMatrix> h_rows;
+    std::vector<std::unique_ptr<hamilt::HTransferPlan<double>>> h_plans;
+    // number of spins added since the last solve()
+    int nspin_added = 0;
+
+    // the <I,J> pattern of DM(R) in the atom rows, used to move DM and EDM back
+    std::unique_ptr<foe::BlockSparseMatrix> dm_pattern;
+    std::vector<std::unique_ptr<hamilt::HTransferPlan<double>>> dm_plans;
+    // EDM(R) of each spin on the pattern of DM(R), kept for the forces
+    std::vector<std::unique_ptr<hamilt::HContainer<double>>> edm_r;
+    std::vector<std::unique_ptr<hamilt::HTransferPlan<double>>> edm_plans;
+
+    // values of m on the pattern of dm_pattern, moved into the 2D-block HContainer out
+    void to_2d(const foe::BlockSparseMatrix& m,
+               hamilt::HContainer<double>* out,
+               std::unique_ptr<hamilt::HTransferPlan<double>>& plan);
+};
+} // namespace hsolver
+
+#endif
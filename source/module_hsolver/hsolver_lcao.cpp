@@ -1,6 +1,7 @@
 #include "hsolver_lcao.h"
 
 #ifdef __MPI
+#include "diago_foe.h"
 #include "diago_scalapack.h"
 #include "module_base/scalapack_connector.h"
 #else
@@ -45,7 +46,7 @@ void HSolverLCAO<T, Device>::solve(hamilt::Hamilt<T>* pHamilt,
     ModuleBase::TITLE("HSolverLCAO", "solve");
     ModuleBase::timer::tick("HSolverLCAO", "solve");
 
-    if (this->method != "pexsi")
+    if (this->method != "pexsi" && this->method != "foe")
     {
         if (GlobalV::KPAR_LCAO > 1
             && (this->method == "genelpa" || this->method == "elpa" || this->method == "scalapack_gvx"))
@@ -113,6 +114,36 @@ void HSolverLCAO<T, Device>::solve(hamilt::Hamilt<T>* pHamilt,
         _pes->dmToRho(pe.DM, pe.EDM);
 #endif
     }
+    else if (this->method == "foe")
+    {
+#ifdef __MPI
+        if (this->foe == nullptr)
+        {
+            ModuleBase::WARNING_QUIT("HSolverLCAO::solve", "the foe solver is not given");
+        }
+        for (int ik = 0; ik < psi.get_nk(); ++ik)
+        {
+            /// update H(R) of each spin for gamma_only, H(k) is not needed by foe
+            this->foe->add_spin(pHamilt, ik);
+        }
+        auto _pes = dynamic_cast<elecstate::ElecStateLCAO<T>*>(pes);
+        const std::vector<double> nelec
+            = pes->eferm.two_efermi ? pes->nelec_spin : std::vector<double>(1, PARAM.inp.nelec);
+        this->foe->solve(nelec, pes->eferm.two_efermi, _pes->DM);
+        pes->f_en.eband = this->foe->eband;
+        pes->f_en.demet = this->foe->demet;
+        if (pes->eferm.two_efermi)
+        {
+            pes->eferm.ef_up = this->foe->mu[0];
+            pes->eferm.ef_dw = this->foe->mu[1];
+        }
+        else
+        {
+            pes->eferm.ef = this->foe->mu[0];
+        }
+        _pes->dmrToRho();
+#endif
+    }
 
     ModuleBase::timer::tick("HSolverLCAO", "solve");
     return;
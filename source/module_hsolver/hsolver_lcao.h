@@ -8,11 +8,16 @@
 namespace hsolver
 {
 
+template <typename T>
+class DiagoFoe;
+
 template <typename T, typename Device = base_device::DEVICE_CPU>
 class HSolverLCAO
 {
   public:
-    HSolverLCAO(const Parallel_Orbitals* ParaV_in, std::string method_in) : ParaV(ParaV_in), method(method_in) {};
+    /// foe_in is the foe solver kept by the caller over the SCF steps, only used if method_in is "foe"
+    HSolverLCAO(const Parallel_Orbitals* ParaV_in, std::string method_in, DiagoFoe<T>* foe_in = nullptr)
+        : ParaV(ParaV_in), method(method_in), foe(foe_in){};
 
     void solve(hamilt::Hamilt<T>* pHamilt,
                psi::Psi<T>& psi,
@@ -27,6 +32,8 @@ class HSolverLCAO
     const Parallel_Orbitals* ParaV;
     
     const std::string method;
+
+    DiagoFoe<T>* foe = nullptr;
 };
 
 } // namespace hsolver
@@ -1,13 +1,17 @@
 #include "hsolver_pw.h"
 
 #include "module_base/global_variable.h"
+#include "module_base/parallel_comm.h"
+#include "module_base/parallel_device.h"
 #include "module_base/timer.h"
 #include "module_base/tool_quit.h"
 #include "module_elecstate/elecstate_pw.h"
 #include "module_hamilt_general/hamilt.h"
+#include "module_hsolver/diag_band_group.h"
 #include "module_hsolver/diag_comm_info.h"
 #include "module_hsolver/diago_bpcg.h"
 #include "module_hsolver/diago_cg.h"
+#include "module_hsolver/diago_chebfilter.h"
 #include "module_hsolver/diago_dav_subspace.h"
 #include "module_hsolver/diago_david.h"
 #include "module_hsolver/diago_iter_assist.h"
@@ -267,9 +271,10 @@ void HSolverPW<T, Device>::solve(hamilt::Hamilt<T, Device>* pHamilt,
 
     this->rank_in_pool = rank_in_pool_in;
     this->nproc_in_pool = nproc_in_pool_in;
+    this->bndpar = PARAM.inp.bndpar;
 
     // report if the specified diagonalization method is not supported
-    const std::initializer_list<std::string> _methods = {"cg", "dav", "dav_subspace", "bpcg"};
+    const std::initializer_list<std::string> _methods = {"cg", "dav", "dav_subspace", "bpcg", "chfsi"};
     if (std::find(std::begin(_methods), std::end(_methods), this->method) == std::end(_methods))
     {
         ModuleBase::WARNING_QUIT("HSolverPW::solve", "This type of eigensolver is not supported!");
@@ -309,6 +314,14 @@ void HSolverPW<T, Device>::solve(hamilt::Hamilt<T, Device>* pHamilt,
         this->call_paw_cell_set_currentk(ik);
 #endif
 
+#ifdef __MPI
+        // the band groups diagonalize H(k) together, start them from the psi of the first group
+        if (this->bndpar > 1)
+        {
+            Parallel_Common::bcast_dev(this->ctx, psi.get_pointer(), psi.get_nbands() * psi.get_nbasis(), PARAPW_WORLD);
+        }
+#endif
+
         /// solve eigenvector and eigenvalue for H(k)
         this->hamiltSolvePsiK(pHamilt, psi, precondition, eigenvalues.data() + ik * psi.get_nbands(), this->wfc_basis->nks);
 
@@ -366,8 +379,11 @@ void HSolverPW<T, Device>::hamiltSolvePsiK(hamilt::Hamilt<T, Device>* hm,
 {
 #ifdef __MPI
     const diag_comm_info comm_info = {POOL_WORLD, this->rank_in_pool, this->nproc_in_pool};
+    // the band groups, in which hPsi of a block is split over the groups
+    const diag_comm_info band_comm = {PARAPW_WORLD, GlobalV::MY_STOGROUP, this->bndpar};
 #else
     const diag_comm_info comm_info = {this->rank_in_pool, this->nproc_in_pool};
+    const diag_comm_info band_comm = {0, 1};
 #endif
 
     auto ngk_pointer = psi.get_ngk_pointer();
@@ -500,9 +516,12 @@ void HSolverPW<T, Device>::hamiltSolvePsiK(hamilt::Hamilt<T, Device>* hm,
 
             ModuleBase::timer::tick("DavSubspace", "hpsi_func");
         };
+        auto hpsi_group = [&hpsi_func, band_comm](T* psi_in, T* hpsi_out, const int ld_psi, const int nvec) {
+            band_group_hpsi<T, Device>(hpsi_func, band_comm, psi_in, hpsi_out, ld_psi, nvec);
+        };
         DiagoBPCG<T, Device> bpcg(pre_condition.data());
         bpcg.init_iter(nband, nbasis);
-        bpcg.diag(hpsi_func, psi.get_pointer(), eigenvalue, this->ethr_band);
+        bpcg.diag(hpsi_group, psi.get_pointer(), eigenvalue, this->ethr_band);
     }
     else if (this->method == "dav_subspace")
     {
@@ -521,6 +540,9 @@ void HSolverPW<T, Device>::hamiltSolvePsiK(hamilt::Hamilt<T, Device>* hm,
 
             ModuleBase::timer::tick("DavSubspace", "hpsi_func");
         };
+        auto hpsi_group = [&hpsi_func, band_comm](T* psi_in, T* hpsi_out, const int ld_psi, const int nvec) {
+            band_group_hpsi<T, Device>(hpsi_func, band_comm, psi_in, hpsi_out, ld_psi, nvec);
+        };
         bool scf = this->calculation_type == "nscf" ? false : true;
 
         Diago_DavSubspace<T, Device> dav_subspace(pre_condition,
@@ -534,7 +556,44 @@ void HSolverPW<T, Device>::hamiltSolvePsiK(hamilt::Hamilt<T, Device>* hm,
                                                   comm_info);
 
         DiagoIterAssist<T, Device>::avg_iter += static_cast<double>(
-            dav_subspace.diag(hpsi_func, psi.get_pointer(), psi.get_nbasis(), eigenvalue, this->ethr_band, scf));
+            dav_subspace.diag(hpsi_group, psi.get_pointer(), psi.get_nbasis(), eigenvalue, this->ethr_band, scf));
+    }
+    else if (this->method == "chfsi")
+    {
+        // hpsi_func (X, HX, ld, nvec) -> HX = H(X), X and HX blockvectors of size ld x nvec
+        auto hpsi_func = [hm, ngk_vector](T* psi_in, T* hpsi_out, const int ld_psi, const int nvec) {
+            ModuleBase::timer::tick("ChebFilter", "hpsi_func");
+
+            // Convert "pointer data stucture" to a psi::Psi object
+            auto psi_iter_wrapper = psi::Psi<T, Device>(psi_in, 1, nvec, ld_psi, ngk_vector);
+
+            psi::Range bands_range(true, 0, 0, nvec - 1);
+
+            using hpsi_info = typename hamilt::Operator<T, Device>::hpsi_info;
+            hpsi_info info(&psi_iter_wrapper, bands_range, hpsi_out);
+            hm->ops->hPsi(info);
+
+            ModuleBase::timer::tick("ChebFilter", "hpsi_func");
+        };
+        auto hpsi_group = [&hpsi_func, band_comm](T* psi_in, T* hpsi_out, const int ld_psi, const int nvec) {
+            band_group_hpsi<T, Device>(hpsi_func, band_comm, psi_in, hpsi_out, ld_psi, nvec);
+        };
+        bool scf = this->calculation_type == "nscf" ? false : true;
+
+        DiagoChebFilter<T, Device> chfsi(psi.get_nbands(),
+                                         psi.get_current_nbas(),
+                                         PARAM.inp.pw_diag_cheb_degree,
+                                         this->diag_iter_max,
+                                         comm_info);
+
+        DiagoIterAssist<T, Device>::avg_iter += static_cast<double>(
+            chfsi.diag(hpsi_group,
+                       psi.get_pointer(),
+                       psi.get_nbasis(),
+                       eigenvalue,
+                       this->ethr_band,
+                       scf,
+                       psi.get_current_k()));
     }
     else if (this->method == "dav")
     {
@@ -572,6 +631,9 @@ void HSolverPW<T, Device>::hamiltSolvePsiK(hamilt::Hamilt<T, Device>* hm,
 
             ModuleBase::timer::tick("David", "hpsi_func");
         };
+        auto hpsi_group = [&hpsi_func, band_comm](T* psi_in, T* hpsi_out, const int ld_psi, const int nvec) {
+            band_group_hpsi<T, Device>(hpsi_func, band_comm, psi_in, hpsi_out, ld_psi, nvec);
+        };
 
         /// wrap spsi into lambda function, Matrix \times blockvector
         /// spsi(X, SX, ld, nvec)
@@ -588,9 +650,15 @@ void HSolverPW<T, Device>::hamiltSolvePsiK(hamilt::Hamilt<T, Device>* hm,
             ModuleBase::timer::tick("David", "spsi_func");
         };
 
-        DiagoDavid<T, Device> david(pre_condition.data(), nband, dim, PARAM.inp.pw_diag_ndim, this->use_paw, comm_info);
+        DiagoDavid<T, Device> david(pre_condition.data(),
+                                    nband,
+                                    dim,
+                                    PARAM.inp.pw_diag_ndim,
+                                    this->use_paw,
+                                    comm_info,
+                                    band_comm);
         // do diag and add davidson iteration counts up to avg_iter
-        DiagoIterAssist<T, Device>::avg_iter += static_cast<double>(david.diag(hpsi_func,
+        DiagoIterAssist<T, Device>::avg_iter += static_cast<double>(david.diag(hpsi_group,
                                                                                spsi_func,
                                                                                ld_psi,
                                                                                psi.get_pointer(),
@@ -84,6 +84,8 @@ class HSolverPW
 
     int rank_in_pool = 0;
     int nproc_in_pool = 1;
+    /// number of band groups sharing the diagonalization, see bndpar
+    int bndpar = 1;
 
     std::vector<double> ethr_band;
 
@@ -0,0 +1,504 @@
+#include "block_sparse_matrix.h"
+
+#include "module_base/blas_connector.h"
+#include "module_base/timer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace foe
+{
+
+AtomRows::AtomRows(const std::vector<int>& atom_begin_in, MPI_Comm comm_in)
+    : atom_begin(atom_begin_in), comm(comm_in)
+{
+    MPI_Comm_rank(comm, &this->rank);
+    MPI_Comm_size(comm, &this->nproc);
+    this->nat = static_cast<int>(atom_begin.size()) - 1;
+    this->nbasis = atom_begin[nat];
+
+    // an atom belongs to the rank whose share of the orbitals contains the middle of the atom
+    this->owner.resize(nat);
+    for (int iat = 0; iat < nat; ++iat)
+    {
+        const double middle = 0.5 * (atom_begin[iat] + atom_begin[iat + 1]);
+        const int ip = static_cast<int>(middle * nproc / std::max(nbasis, 1));
+        this->owner[iat] = std::min(ip, nproc - 1);
+    }
+    this->first_atom = std::lower_bound(owner.begin(), owner.end(), rank) - owner.begin();
+    this->last_atom = std::upper_bound(owner.begin(), owner.end(), rank) - owner.begin();
+}
+
+BlockSparseMatrix::BlockSparseMatrix(const AtomRows* rows_in, const std::vector<std::vector<int>>& cols)
+    : rows(rows_in)
+{
+    this->hr.reset(new hamilt::HContainer<double>(rows->nat));
+    for (int iat = rows->first_atom; iat < rows->last_atom; ++iat)
+    {
+        for (const int jat: cols[iat - rows->first_atom])
+        {
+            hamilt::AtomPair<double> ap(iat, jat, 0, 0, 0, rows->atom_begin.data(), rows->atom_begin.data(), rows->nat);
+            this->hr->insert_pair(ap);
+        }
+    }
+    this->hr->allocate(nullptr, true);
+}
+
+BlockSparseMatrix::BlockSparseMatrix(const AtomRows* rows_in, std::vector<RowBlocks>& row_blocks) : rows(rows_in)
+{
+    this->hr.reset(new hamilt::HContainer<double>(rows->nat));
+    for (int iat = rows->first_atom; iat < rows->last_atom; ++iat)
+    {
+        for (const int jat: row_blocks[iat - rows->first_atom].cols)
+        {
+            hamilt::AtomPair<double> ap(iat, jat, 0, 0, 0, rows->atom_begin.data(), rows->atom_begin.data(), rows->nat);
+            this->hr->insert_pair(ap);
+        }
+    }
+    this->hr->allocate(nullptr, true);
+    for (int iat = rows->first_atom; iat < rows->last_atom; ++iat)
+    {
+        RowBlocks& row = row_blocks[iat - rows->first_atom];
+        const double* value = row.values.data();
+        for (const int jat: row.cols)
+        {
+            const int size = rows->get_nw(iat) * rows->get_nw(jat);
+            std::copy(value, value + size, this->find_block(iat, jat));
+            value += size;
+        }
+        // release the memory as soon as the row is copied
+        std::vector<double>().swap(row.values);
+    }
+}
+
+BlockSparseMatrix BlockSparseMatrix::identity(const AtomRows* rows_in)
+{
+    std::vector<std::vector<int>> cols(rows_in->last_atom - rows_in->first_atom);
+    for (int iat = rows_in->first_atom; iat < rows_in->last_atom; ++iat)
+    {
+        cols[iat - rows_in->first_atom].push_back(iat);
+    }
+    BlockSparseMatrix unit(rows_in, cols);
+    for (int iat = rows_in->first_atom; iat < rows_in->last_atom; ++iat)
+    {
+        const int nw = rows_in->get_nw(iat);
+        double* block = unit.find_block(iat, iat);
+        for (int mu = 0; mu < nw; ++mu)
+        {
+            block[mu * nw + mu] = 1.0;
+        }
+    }
+    return unit;
+}
+
+double* BlockSparseMatrix::find_block(const int i, const int j) const
+{
+    hamilt::BaseMatrix<double>* mat = this->hr->find_matrix(i, j, 0, 0, 0);
+    return mat == nullptr ? nullptr : mat->get_pointer();
+}
+
+namespace
+{
+// column atoms and blocks of one atom row, either stored locally or received from its owner
+struct RowView
+{
+    int ncols = 0;
+    const int* cols = nullptr;
+    std::vector<const double*> blocks;
+};
+
+// fill the views of the local rows of a matrix
+void view_local_rows(const AtomRows& rows, const hamilt::HContainer<double>& hr, std::vector<RowView>& views)
+{
+    for (int iat = rows.first_atom; iat < rows.last_atom; ++iat)
+    {
+        const std::vector<int>& cols = hr.get_sparse_ap()[iat];
+        const std::vector<int>& index = hr.get_sparse_ap_index()[iat];
+        RowView& view = views[iat];
+        view.ncols = cols.size();
+        view.cols = cols.data();
+        view.blocks.resize(cols.size());
+        for (int k = 0; k < cols.size(); ++k)
+        {
+            view.blocks[k] = hr.get_atom_pair(index[k]).get_pointer(0);
+        }
+    }
+}
+
+// displacements of the counts
+std::vector<int> displacements(const std::vector<int>& counts)
+{
+    std::vector<int> displs(counts.size() + 1, 0);
+    for (int ip = 0; ip < counts.size(); ++ip)
+    {
+        displs[ip + 1] = displs[ip] + counts[ip];
+    }
+    return displs;
+}
+} // namespace
+
+BlockSparseMatrix BlockSparseMatrix::multiply(const BlockSparseMatrix& a, const BlockSparseMatrix& b, const double thr)
+{
+    ModuleBase::timer::tick("BlockSparseMatrix", "multiply");
+    const AtomRows& rows = *a.rows;
+    const int nproc = rows.nproc;
+
+    // 1. the remote rows of B needed by the column atoms of the local rows of A
+    std::vector<char> needed(rows.nat, 0);
+    for (int iat = rows.first_atom; iat < rows.last_atom; ++iat)
+    {
+        for (const int kat: a.hr->get_sparse_ap()[iat])
+        {
+            if (!rows.is_local(kat))
+            {
+                needed[kat] = 1;
+            }
+        }
+    }
+    std::vector<int> request;
+    std::vector<int> request_counts(nproc, 0);
+    for (int kat = 0; kat < rows.nat; ++kat)
+    {
+        if (needed[kat])
+        {
+            // the atoms of a rank are contiguous, so the requests are grouped by rank
+            request.push_back(kat);
+            ++request_counts[rows.owner[kat]];
+        }
+    }
+    std::vector<int> asked_counts(nproc, 0);
+    MPI_Alltoall(request_counts.data(), 1, MPI_INT, asked_counts.data(), 1, MPI_INT, rows.comm);
+    const std::vector<int> request_displs = displacements(request_counts);
+    const std::vector<int> asked_displs = displacements(asked_counts);
+    std::vector<int> asked(asked_displs[nproc]);
+    MPI_Alltoallv(request.data(),
+                  request_counts.data(),
+                  request_displs.data(),
+                  MPI_INT,
+                  asked.data(),
+                  asked_counts.data(),
+                  asked_displs.data(),
+                  MPI_INT,
+                  rows.comm);
+
+    // 2. send the asked rows of B: [ncols, col_0, col_1, ...] and the values of the blocks
+    std::vector<int> send_index;
+    std::vector<double> send_values;
+    std::vector<int> index_counts(nproc, 0);
+    std::vector<int> value_counts(nproc, 0);
+    for (int ip = 0; ip < nproc; ++ip)
+    {
+        const size_t index_begin = send_index.size();
+        const size_t value_begin = send_values.size();
+        for (int n = asked_displs[ip]; n < asked_displs[ip + 1]; ++n)
+        {
+            const int kat = asked[n];
+            const std::vector<int>& cols = b.hr->get_sparse_ap()[kat];
+            const std::vector<int>& index = b.hr->get_sparse_ap_index()[kat];
+            send_index.push_back(cols.size());
+            send_index.insert(send_index.end(), cols.begin(), cols.end());
+            for (int k = 0; k < cols.size(); ++k)
+            {
+                const double* block = b.hr->get_atom_pair(index[k]).get_pointer(0);
+                send_values.insert(send_values.end(), block, block + rows.get_nw(kat) * rows.get_nw(cols[k]));
+            }
+        }
+        index_counts[ip] = send_index.size() - index_begin;
+        value_counts[ip] = send_values.size() - value_begin;
+    }
+    std::vector<int> recv_index_counts(nproc, 0);
+    std::vector<int> recv_value_counts(nproc, 0);
+    MPI_Alltoall(index_counts.data(), 1, MPI_INT, recv_index_counts.data(), 1, MPI_INT, rows.comm);
+    MPI_Alltoall(value_counts.data(), 1, MPI_INT, recv_value_counts.data(), 1, MPI_INT, rows.comm);
+    const std::vector<int> index_displs = displacements(index_counts);
+    const std::vector<int> value_displs = displacements(value_counts);
+    const std::vector<int> recv_index_displs = displacements(recv_index_counts);
+    const std::vector<int> recv_value_displs = displacements(recv_value_counts);
+    std::vector<int> recv_index(recv_index_displs[nproc]);
+    std::vector<double> recv_values(recv_value_displs[nproc]);
+    MPI_Alltoallv(send_index.data(),
+                  index_counts.data(),
+                  index_displs.data(),
+                  MPI_INT,
+                  recv_index.data(),
+                  recv_index_counts.data(),
+                  recv_index_displs.data(),
+                  MPI_INT,
+                  rows.comm);
+    MPI_Alltoallv(send_values.data(),
+                  value_counts.data(),
+                  value_displs.data(),
+                  MPI_DOUBLE,
+                  recv_values.data(),
+                  recv_value_counts.data(),
+                  recv_value_displs.data(),
+                  MPI_DOUBLE,
+                  rows.comm);
+    std::vector<int>().swap(send_index);
+    std::vector<double>().swap(send_values);
+
+    // 3. views of all the rows of B used here, the received ones come in the order of the requests
+    std::vector<RowView> b_rows(rows.nat);
+    view_local_rows(rows, *b.hr, b_rows);
+    {
+        const int* index = recv_index.data();
+        const double* value = recv_values.data();
+        for (const int kat: request)
+        {
+            RowView& view = b_rows[kat];
+            view.ncols = *index;
+            view.cols = index + 1;
+            view.blocks.resize(view.ncols);
+            for (int k = 0; k < view.ncols; ++k)
+            {
+                view.blocks[k] = value;
+                value += rows.get_nw(kat) * rows.get_nw(view.cols[k]);
+            }
+            index += 1 + view.ncols;
+        }
+    }
+
+    // 4. C_ij = sum_k A_ik B_kj for the local atoms i
+    std::vector<RowBlocks> c_rows(rows.last_atom - rows.first_atom);
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    {
+        // position of the block of each column atom in the accumulator, -1 if not touched yet
+        std::vector<int> slot(rows.nat, -1);
+        std::vector<int> touched;
+        std::vector<size_t> offset;
+        std::vector<double> acc;
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic)
+#endif
+        for (int iat = rows.first_atom; iat < rows.last_atom; ++iat)
+        {
+            const int nwi = rows.get_nw(iat);
+            touched.clear();
+            offset.clear();
+            acc.clear();
+            const std::vector<int>& a_cols = a.hr->get_sparse_ap()[iat];
+            const std::vector<int>& a_index = a.hr->get_sparse_ap_index()[iat];
+            for (int ka = 0; ka < a_cols.size(); ++ka)
+            {
+                const int kat = a_cols[ka];
+                const int nwk = rows.get_nw(kat);
+                const double* a_block = a.hr->get_atom_pair(a_index[ka]).get_pointer(0);
+                const RowView& b_row = b_rows[kat];
+                for (int kb = 0; kb < b_row.ncols; ++kb)
+                {
+                    const int jat = b_row.cols[kb];
+                    const int nwj = rows.get_nw(jat);
+                    if (slot[jat] < 0)
+                    {
+                        slot[jat] = touched.size();
+                        touched.push_back(jat);
+                        offset.push_back(acc.size());
+                        acc.resize(acc.size() + nwi * nwj, 0.0);
+                    }
+                    BlasConnector::gemm('N',
+                                        'N',
+                                        nwi,
+                                        nwj,
+                                        nwk,
+                                        1.0,
+                                        a_block,
+                                        nwk,
+                                        b_row.blocks[kb],
+                                        nwj,
+                                        1.0,
+                                        acc.data() + offset[slot[jat]],
+                                        nwj);
+                }
+            }
+
+            // keep the diagonal block and the blocks above the threshold, in increasing order of column
+            std::vector<int> order = touched;
+            std::sort(order.begin(), order.end());
+            RowBlocks& c_row = c_rows[iat - rows.first_atom];
+            for (const int jat: order)
+            {
+                const int size = nwi * rows.get_nw(jat);
+                const double* block = acc.data() + offset[slot[jat]];
+                double norm2 = 0.0;
+                for (int n = 0; n < size; ++n)
+                {
+                    norm2 += block[n] * block[n];
+                }
+                if (jat == iat || norm2 >= thr * thr)
+                {
+                    c_row.cols.push_back(jat);
+                    c_row.values.insert(c_row.values.end(), block, block + size);
+                }
+            }
+            for (const int jat: touched)
+            {
+                slot[jat] = -1;
+            }
+        }
+    }
+
+    BlockSparseMatrix c(a.rows, c_rows);
+    ModuleBase::timer::tick("BlockSparseMatrix", "multiply");
+    return c;
+}
+
+BlockSparseMatrix BlockSparseMatrix::add(const double alpha,
+                                         const BlockSparseMatrix& a,
+                                         const double beta,
+                                         const BlockSparseMatrix& b)
+{
+    const AtomRows& rows = *a.rows;
+    std::vector<RowBlocks> c_rows(rows.last_atom - rows.first_atom);
+    for (int iat = rows.first_atom; iat < rows.last_atom; ++iat)
+    {
+        const int nwi = rows.get_nw(iat);
+        const std::vector<int>& a_cols = a.hr->get_sparse_ap()[iat];
+        const std::vector<int>& b_cols = b.hr->get_sparse_ap()[iat];
+        RowBlocks& c_row = c_rows[iat - rows.first_atom];
+        std::set_union(a_cols.begin(), a_cols.end(), b_cols.begin(), b_cols.end(), std::back_inserter(c_row.cols));
+        for (const int jat: c_row.cols)
+        {
+            const int size = nwi * rows.get_nw(jat);
+            const double* a_block = a.find_block(iat, jat);
+            const double* b_block = b.find_block(iat, jat);
+            for (int n = 0; n < size; ++n)
+            {
+                double value = 0.0;
+                if (a_block != nullptr)
+                {
+                    value += alpha * a_block[n];
+                }
+                if (b_block != nullptr)
+                {
+                    value += beta * b_block[n];
+                }
+                c_row.values.push_back(value);
+            }
+        }
+    }
+    return BlockSparseMatrix(a.rows, c_rows);
+}
+
+void BlockSparseMatrix::scale(const double alpha)
+{
+    double* value = this->hr->get_wrapper();
+    const size_t nnr = this->hr->get_nnr();
+    for (size_t n = 0; n < nnr; ++n)
+    {
+        value[n] *= alpha;
+    }
+}
+
+double BlockSparseMatrix::trace() const
+{
+    double sum = 0.0;
+    for (int iat = rows->first_atom; iat < rows->last_atom; ++iat)
+    {
+        const double* block = this->find_block(iat, iat);
+        if (block == nullptr)
+        {
+            continue;
+        }
+        const int nw = rows->get_nw(iat);
+        for (int mu = 0; mu < nw; ++mu)
+        {
+            sum += block[mu * nw + mu];
+        }
+    }
+    MPI_Allreduce(MPI_IN_PLACE, &sum, 1, MPI_DOUBLE, MPI_SUM, rows->comm);
+    return sum;
+}
+
+double BlockSparseMatrix::dot(const BlockSparseMatrix& other) const
+{
+    double sum = 0.0;
+    for (int iat = rows->first_atom; iat < rows->last_atom; ++iat)
+    {
+        const int nwi = rows->get_nw(iat);
+        for (const int jat: this->hr->get_sparse_ap()[iat])
+        {
+            const double* other_block = other.find_block(iat, jat);
+            if (other_block == nullptr)
+            {
+                continue;
+            }
+            const double* block = this->find_block(iat, jat);
+            const int size = nwi * rows->get_nw(jat);
+            for (int n = 0; n < size; ++n)
+            {
+                sum += block[n] * other_block[n];
+            }
+        }
+    }
+    MPI_Allreduce(MPI_IN_PLACE, &sum, 1, MPI_DOUBLE, MPI_SUM, rows->comm);
+    return sum;
+}
+
+double BlockSparseMatrix::norm() const
+{
+    const double* value = this->hr->get_wrapper();
+    const size_t nnr = this->hr->get_nnr();
+    double sum = 0.0;
+    for (size_t n = 0; n < nnr; ++n)
+    {
+        sum += value[n] * value[n];
+    }
+    MPI_Allreduce(MPI_IN_PLACE, &sum, 1, MPI_DOUBLE, MPI_SUM, rows->comm);
+    return std::sqrt(sum);
+}
+
+void BlockSparseMatrix::gershgorin(double& lower, double& upper) const
+{
+    lower = 1e300;
+    upper = -1e300;
+    std::vector<double> radius;
+    std::vector<double> center;
+    for (int iat = rows->first_atom; iat < rows->last_atom; ++iat)
+    {
+        const int nwi = rows->get_nw(iat);
+        radius.assign(nwi, 0.0);
+        center.assign(nwi, 0.0);
+        for (const int jat: this->hr->get_sparse_ap()[iat])
+        {
+            const int nwj = rows->get_nw(jat);
+            const double* block = this->find_block(iat, jat);
+            for (int mu = 0; mu < nwi; ++mu)
+            {
+                for (int nu = 0; nu < nwj; ++nu)
+                {
+                    if (jat == iat && nu == mu)
+                    {
+                        center[mu] = block[mu * nwj + nu];
+                    }
+                    else
+                    {
+                        radius[mu] += std::abs(block[mu * nwj + nu]);
+                    }
+                }
+            }
+        }
+        for (int mu = 0; mu < nwi; ++mu)
+        {
+            lower = std::min(lower, center[mu] - radius[mu]);
+            upper = std::max(upper, center[mu] + radius[mu]);
+        }
+    }
+    MPI_Allreduce(MPI_IN_PLACE, &lower, 1, MPI_DOUBLE, MPI_MIN, rows->comm);
+    MPI_Allreduce(MPI_IN_PLACE, &upper, 1, MPI_DOUBLE, MPI_MAX, rows->comm);
+}
+
+long BlockSparseMatrix::nblocks() const
+{
+    long n = this->hr->size_atom_pairs();
+    MPI_Allreduce(MPI_IN_PLACE, &n, 1, MPI_LONG, MPI_SUM, rows->comm);
+    return n;
+}
+
+} // namespace foe
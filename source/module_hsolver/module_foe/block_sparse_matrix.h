@@ -0,0 +1,128 @@
+#ifndef FOE_BLOCK_SPARSE_MATRIX_H
+#define FOE_BLOCK_SPARSE_MATRIX_H
+
+#include "module_hamilt_lcao/module_hcontainer/hcontainer.h"
+
+#include <memory>
+#include <mpi.h>
+#include <vector>
+
+namespace foe
+{
+
+/**
+ * @brief 1D distribution of the atom rows of a block-sparse matrix
+ * every rank of comm owns a contiguous range of atoms [first_atom, last_atom),
+ * the ranges are balanced by the number of orbitals.
+ */
+class AtomRows
+{
+  public:
+    /**
+     * @param atom_begin_in the first orbital of each atom, dim: nat + 1, atom_begin_in[nat] = nbasis
+     * @param comm_in communicator of the ranks sharing the matrices
+     */
+    AtomRows(const std::vector<int>& atom_begin_in, MPI_Comm comm_in);
+
+    bool is_local(const int iat) const
+    {
+        return iat >= first_atom && iat < last_atom;
+    }
+    int get_nw(const int iat) const
+    {
+        return atom_begin[iat + 1] - atom_begin[iat];
+    }
+
+    int nat = 0;
+    int nbasis = 0;
+    // the first orbital of each atom, dim: nat + 1
+    std::vector<int> atom_begin;
+    // the rank owning the row of each atom, dim: nat
+    std::vector<int> owner;
+    int first_atom = 0;
+    int last_atom = 0;
+    MPI_Comm comm = MPI_COMM_NULL;
+    int rank = 0;
+    int nproc = 1;
+};
+
+/**
+ * @brief real symmetric matrix stored as atom-pair blocks, distributed by AtomRows
+ * the local atom rows are kept in a serial HContainer<double> (no Parallel_Orbitals, R = 0),
+ * every AtomPair <i, j> holds the full row-major block of atoms i and j,
+ * so the matrix can be exchanged with the 2D-block H(R) by transferParallels2Serials().
+ * All the functions returning a number are collective over rows->comm.
+ */
+class BlockSparseMatrix
+{
+  public:
+    /**
+     * @brief matrix with blocks <i, cols[i - first_atom][*]> for the local atoms i, values are zero
+     */
+    BlockSparseMatrix(const AtomRows* rows_in, const std::vector<std::vector<int>>& cols);
+
+    BlockSparseMatrix(BlockSparseMatrix&& other) = default;
+    BlockSparseMatrix& operator=(BlockSparseMatrix&& other) = default;
+
+    // the unit matrix
+    static BlockSparseMatrix identity(const AtomRows* rows_in);
+
+    /**
+     * @brief C = A * B, the blocks of C with a Frobenius norm below thr are dropped
+     * the rows of B needed by the column atoms of the local rows of A are fetched from their owners.
+     */
+    static BlockSparseMatrix multiply(const BlockSparseMatrix& a, const BlockSparseMatrix& b, const double thr);
+
+    // C = alpha * A + beta * B, the blocks of C are the union of the blocks of A and B
+    static BlockSparseMatrix add(const double alpha,
+                                 const BlockSparseMatrix& a,
+                                 const double beta,
+                                 const BlockSparseMatrix& b);
+
+    // this = alpha * this
+    void scale(const double alpha);
+
+    // sum of the diagonal elements
+    double trace() const;
+
+    // sum_ij A_ij B_ij, which is Tr(A B) for a symmetric B
+    double dot(const BlockSparseMatrix& other) const;
+
+    // Frobenius norm
+    double norm() const;
+
+    // lower and upper bounds of the eigenvalues from the Gershgorin discs of the rows
+    void gershgorin(double& lower, double& upper) const;
+
+    // number of blocks of all ranks
+    long nblocks() const;
+
+    // block <i, j> of a local atom i, row-major, nullptr if it is not stored
+    double* find_block(const int i, const int j) const;
+
+    const AtomRows* get_rows() const
+    {
+        return this->rows;
+    }
+    hamilt::HContainer<double>& get_hr() const
+    {
+        return *this->hr;
+    }
+
+  private:
+    // blocks of one local row, in increasing order of the column atom
+    struct RowBlocks
+    {
+        std::vector<int> cols;
+        std::vector<double> values;
+    };
+
+    BlockSparseMatrix(const AtomRows* rows_in, std::vector<RowBlocks>& row_blocks);
+
+    const AtomRows* rows = nullptr;
+    std::unique_ptr<hamilt::HContainer<double>> hr;
+};
+
+} // namespace foe
+
+#endif
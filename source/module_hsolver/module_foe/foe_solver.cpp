@@ -0,0 +1,254 @@
+#include "foe_solver.h"
+
+#include "module_base/constants.h"
+#include "module_base/timer.h"
+#include "module_base/tool_quit.h"
+#include "module_base/tool_title.h"
+#include "module_elecstate/occupy.h"
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+namespace foe
+{
+
+FOE_Solver::FOE_Solver(const double thr, const int order, const int ngauss, const double sigma)
+    : thr(thr), order(order), ngauss(ngauss), sigma(sigma)
+{
+}
+
+BlockSparseMatrix FOE_Solver::inverse(const BlockSparseMatrix& s) const
+{
+    ModuleBase::timer::tick("FOE_Solver", "inverse");
+    const AtomRows* rows = s.get_rows();
+    const BlockSparseMatrix unit = BlockSparseMatrix::identity(rows);
+
+    // all eigenvalues of I - S X are in [0, 1) at the start, and are squared by every step
+    double lower = 0.0;
+    double upper = 0.0;
+    s.gershgorin(lower, upper);
+    BlockSparseMatrix x = BlockSparseMatrix::identity(rows);
+    x.scale(1.0 / upper);
+
+    double res_old = 1e300;
+    bool converged = false;
+    for (int iter = 0; iter < this->max_inverse_iter; ++iter)
+    {
+        const BlockSparseMatrix sx = BlockSparseMatrix::multiply(s, x, this->thr);
+        const double res = BlockSparseMatrix::add(1.0, unit, -1.0, sx).norm() / std::sqrt(rows->nbasis);
+        // stop at the convergence or at the floor set by the truncation
+        if (res < this->inverse_tol || (res < 1e-3 && res >= res_old))
+        {
+            converged = true;
+            break;
+        }
+        res_old = res;
+        x = BlockSparseMatrix::add(2.0, x, -1.0, BlockSparseMatrix::multiply(x, sx, this->thr));
+    }
+    if (!converged)
+    {
+        ModuleBase::WARNING("FOE_Solver", "the Newton-Schulz iteration of S^{-1} is not converged");
+    }
+    ModuleBase::timer::tick("FOE_Solver", "inverse");
+    return x;
+}
+
+double FOE_Solver::find_mu(const std::vector<double>& energy,
+                           const std::vector<double>& weight,
+                           const double occ,
+                           const double nelec) const
+{
+    const auto bounds = std::minmax_element(energy.begin(), energy.end());
+    double lower = *bounds.first - 50.0 * this->sigma;
+    double upper = *bounds.second + 50.0 * this->sigma;
+    double mu = 0.5 * (lower + upper);
+    for (int iter = 0; iter < 200; ++iter)
+    {
+        mu = 0.5 * (lower + upper);
+        double ne = 0.0;
+        for (int l = 0; l < energy.size(); ++l)
+        {
+            ne += occ * Occupy::wgauss((mu - energy[l]) / this->sigma, this->ngauss) * weight[l];
+        }
+        if (ne > nelec)
+        {
+            upper = mu;
+        }
+        else
+        {
+            lower = mu;
+        }
+        if (upper - lower < 1e-14 * std::max(1.0, std::abs(mu)))
+        {
+            break;
+        }
+    }
+    return mu;
+}
+
+void FOE_Solver::solve(const std::vector<const BlockSparseMatrix*>& h,
+                       const BlockSparseMatrix& s,
+                       const std::vector<double>& nelec,
+                       const bool two_efermi,
+                       std::vector<BlockSparseMatrix>& dm,
+                       std::vector<BlockSparseMatrix>& edm)
+{
+    ModuleBase::TITLE("FOE_Solver", "solve");
+    ModuleBase::timer::tick("FOE_Solver", "solve");
+    const AtomRows* rows = s.get_rows();
+    const int nspin = h.size();
+    const double occ = (nspin == 1) ? 2.0 : 1.0;
+
+    // 1. M = S^{-1} H, scaled into [-1, 1] with the Gershgorin bounds of all spins
+    const BlockSparseMatrix sinv = this->inverse(s);
+    const BlockSparseMatrix unit = BlockSparseMatrix::identity(rows);
+    std::vector<BlockSparseMatrix> m;
+    double emin = 1e300;
+    double emax = -1e300;
+    for (int is = 0; is < nspin; ++is)
+    {
+        m.push_back(BlockSparseMatrix::multiply(sinv, *h[is], this->thr));
+        double lower = 0.0;
+        double upper = 0.0;
+        m[is].gershgorin(lower, upper);
+        emin = std::min(emin, lower);
+        emax = std::max(emax, upper);
+    }
+    const double pad = 0.01 * (emax - emin) + 1e-6;
+    emin -= pad;
+    emax += pad;
+    const double half_width = 0.5 * (emax - emin);
+    const double center = 0.5 * (emax + emin);
+    for (int is = 0; is < nspin; ++is)
+    {
+        m[is] = BlockSparseMatrix::add(1.0 / half_width, m[is], -center / half_width, unit);
+    }
+
+    // the error of the expansion of a function smeared by sigma decays as exp(-k pi sigma / half_width)
+    if (this->order > 0)
+    {
+        this->order_used = this->order;
+    }
+    else
+    {
+        const double estimate = std::ceil(6.0 * half_width / this->sigma);
+        if (estimate > this->max_order)
+        {
+            ModuleBase::WARNING("FOE_Solver",
+                                "the estimated Chebyshev order is too large for the smearing, it is cut to foe_order = "
+                                    + std::to_string(this->max_order) + ", please use a larger smearing_sigma");
+        }
+        this->order_used = static_cast<int>(std::min(estimate, static_cast<double>(this->max_order)));
+    }
+    this->order_used = std::max(this->order_used, 20);
+    const int nnode = 2 * this->order_used;
+    std::vector<double> energy(nnode);
+    // cos(k theta_l) of the Chebyshev-Gauss nodes x_l = cos(theta_l)
+    std::vector<double> cos_k(static_cast<size_t>(this->order_used) * nnode);
+    for (int l = 0; l < nnode; ++l)
+    {
+        const double theta = ModuleBase::PI * (l + 0.5) / nnode;
+        energy[l] = half_width * std::cos(theta) + center;
+        for (int k = 0; k < this->order_used; ++k)
+        {
+            cos_k[static_cast<size_t>(k) * nnode + l] = std::cos(k * theta);
+        }
+    }
+
+    // 2. first pass: moments Tr(X_k S) turned into the weights of the nodes, Tr F(M) = sum_l F(e_l) w_l
+    std::vector<std::vector<double>> weight(nspin, std::vector<double>(nnode, 0.0));
+    for (int is = 0; is < nspin; ++is)
+    {
+        BlockSparseMatrix x_prev = BlockSparseMatrix::add(1.0, sinv, 0.0, sinv);
+        BlockSparseMatrix x_cur = BlockSparseMatrix::multiply(m[is], sinv, this->thr);
+        for (int k = 0; k < this->order_used; ++k)
+        {
+            if (k >= 2)
+            {
+                BlockSparseMatrix x_next
+                    = BlockSparseMatrix::add(2.0, BlockSparseMatrix::multiply(m[is], x_cur, this->thr), -1.0, x_prev);
+                x_prev = std::move(x_cur);
+                x_cur = std::move(x_next);
+            }
+            const double moment = (k == 0 ? x_prev : x_cur).dot(s);
+            const double factor = (k == 0 ? 1.0 : 2.0) * moment / nnode;
+            for (int l = 0; l < nnode; ++l)
+            {
+                weight[is][l] += factor * cos_k[static_cast<size_t>(k) * nnode + l];
+            }
+        }
+    }
+
+    // 3. chemical potential, band energy and entropy from the weights of the nodes
+    this->mu.assign(nspin, 0.0);
+    if (two_efermi)
+    {
+        for (int is = 0; is < nspin; ++is)
+        {
+            this->mu[is] = this->find_mu(energy, weight[is], occ, nelec[is]);
+        }
+    }
+    else
+    {
+        std::vector<double> weight_sum(nnode, 0.0);
+        for (int is = 0; is < nspin; ++is)
+        {
+            for (int l = 0; l < nnode; ++l)
+            {
+                weight_sum[l] += weight[is][l];
+            }
+        }
+        this->mu.assign(nspin, this->find_mu(energy, weight_sum, occ, nelec[0]));
+    }
+    this->eband = 0.0;
+    this->demet = 0.0;
+    std::vector<std::vector<double>> f(nspin, std::vector<double>(nnode, 0.0));
+    for (int is = 0; is < nspin; ++is)
+    {
+        for (int l = 0; l < nnode; ++l)
+        {
+            const double x = (this->mu[is] - energy[l]) / this->sigma;
+            f[is][l] = occ * Occupy::wgauss(x, this->ngauss);
+            this->eband += energy[l] * f[is][l] * weight[is][l];
+            this->demet += occ * this->sigma * Occupy::w1gauss(x, this->ngauss) * weight[is][l];
+        }
+    }
+
+    // 4. second pass: D = sum_k c_k X_k and E = sum_k e_k X_k
+    dm.clear();
+    edm.clear();
+    for (int is = 0; is < nspin; ++is)
+    {
+        std::vector<double> c(this->order_used, 0.0);
+        std::vector<double> e(this->order_used, 0.0);
+        for (int k = 0; k < this->order_used; ++k)
+        {
+            const double factor = (k == 0 ? 1.0 : 2.0) / nnode;
+            for (int l = 0; l < nnode; ++l)
+            {
+                const double ck = factor * f[is][l] * cos_k[static_cast<size_t>(k) * nnode + l];
+                c[k] += ck;
+                e[k] += ck * energy[l];
+            }
+        }
+        BlockSparseMatrix x_prev = BlockSparseMatrix::add(1.0, sinv, 0.0, sinv);
+        BlockSparseMatrix x_cur = BlockSparseMatrix::multiply(m[is], sinv, this->thr);
+        BlockSparseMatrix d = BlockSparseMatrix::add(c[0], x_prev, c[1], x_cur);
+        BlockSparseMatrix ed = BlockSparseMatrix::add(e[0], x_prev, e[1], x_cur);
+        for (int k = 2; k < this->order_used; ++k)
+        {
+            BlockSparseMatrix x_next
+                = BlockSparseMatrix::add(2.0, BlockSparseMatrix::multiply(m[is], x_cur, this->thr), -1.0, x_prev);
+            x_prev = std::move(x_cur);
+            x_cur = std::move(x_next);
+            d = BlockSparseMatrix::add(1.0, d, c[k], x_cur);
+            ed = BlockSparseMatrix::add(1.0, ed, e[k], x_cur);
+        }
+        dm.push_back(std::move(d));
+        edm.push_back(std::move(ed));
+    }
+    ModuleBase::timer::tick("FOE_Solver", "solve");
+}
+
+} // namespace foe
@@ -0,0 +1,82 @@
+#ifndef FOE_SOLVER_H
+#define FOE_SOLVER_H
+
+#include "block_sparse_matrix.h"
+
+#include <vector>
+
+namespace foe
+{
+
+/**
+ * @brief Fermi-operator expansion of the density matrix of H c = e S c on block-sparse matrices
+ * With M = S^{-1} H scaled into [-1, 1], the density matrix D = f(M) S^{-1} and the energy-weighted
+ * density matrix E = (M f(M)) S^{-1} are expanded in Chebyshev polynomials of M:
+ *     X_k = T_k(M) S^{-1},  X_{k+1} = 2 M X_k - X_{k-1},
+ * all X_k are symmetric and as sparse as the truncation threshold allows, so the cost is linear
+ * in the number of atoms for systems with a gap or a finite smearing.
+ * The chemical potential is found before the expansion from the moments Tr(X_k S) of a first pass
+ * of the recursion, so that D holds exactly the number of electrons of the expansion.
+ * S^{-1} is found with the Newton-Schulz iteration X <- 2 X - X S X.
+ */
+class FOE_Solver
+{
+  public:
+    /**
+     * @param thr truncation threshold of the blocks of all matrix products
+     * @param order number of Chebyshev polynomials, 0 for an estimate from the spectral width and sigma,
+     *              the estimate is at most max_order
+     * @param ngauss smearing type of Occupy::wgauss(), -99 for Fermi-Dirac
+     * @param sigma smearing width, in the energy unit of H
+     */
+    FOE_Solver(const double thr, const int order, const int ngauss, const double sigma);
+
+    /**
+     * @brief density matrices of all spins
+     * @param h Hamiltonian of each spin, one spin is occupied by 2 electrons per state, two spins by 1
+     * @param s overlap
+     * @param nelec number of electrons of each spin if two_efermi, otherwise nelec[0] is the total number
+     * @param two_efermi one chemical potential for each spin
+     * @param dm output, density matrix of each spin
+     * @param edm output, energy-weighted density matrix of each spin
+     */
+    void solve(const std::vector<const BlockSparseMatrix*>& h,
+               const BlockSparseMatrix& s,
+               const std::vector<double>& nelec,
+               const bool two_efermi,
+               std::vector<BlockSparseMatrix>& dm,
+               std::vector<BlockSparseMatrix>& edm);
+
+    /**
+     * @brief S^{-1} by the Newton-Schulz iteration from X = I / max(eig(S))
+     */
+    BlockSparseMatrix inverse(const BlockSparseMatrix& s) const;
+
+    // chemical potential of each spin
+    std::vector<double> mu;
+    // sum of the occupied eigenvalues weighted by the occupations, Tr(D H)
+    double eband = 0.0;
+    // -TS, the smearing correction as in Occupy::gweights()
+    double demet = 0.0;
+    // number of Chebyshev polynomials of the last expansion
+    int order_used = 0;
+
+  private:
+    // chemical potential holding nelec electrons for the weights of the quadrature nodes
+    double find_mu(const std::vector<double>& energy, const std::vector<double>& weight, const double occ, const double nelec) const;
+
+    double thr = 1e-7;
+    int order = 0;
+    int ngauss = 0;
+    double sigma = 0.01;
+    // upper limit of the estimated order, the cosines on the quadrature nodes take 2 * order^2 doubles
+    const int max_order = 2000;
+    // maximal number of Newton-Schulz steps
+    const int max_inverse_iter = 100;
+    // convergence of the Newton-Schulz iteration, root mean square of I - S X per orbital
+    const double inverse_tol = 1e-10;
+};
+
+} // namespace foe
+
+#endif
@@ -0,0 +1,376 @@
+#include "../block_sparse_matrix.h"
+#include "../foe_solver.h"
+#include "module_base/lapack_connector.h"
+#include "module_elecstate/occupy.h"
+
+#include "gtest/gtest.h"
+
+#include <cmath>
+#include <mpi.h>
+#include <random>
+#include <vector>
+
+/************************************************
+ *  unit test of the FOE density matrix solver
+ ***********************************************/
+
+/**
+ * - Tested Functions:
+ *  - AtomRows: contiguous atom rows balanced by orbitals
+ *  - BlockSparseMatrix::multiply(): block-sparse product with the remote rows of B
+ *  - FOE_Solver::inverse(): S^{-1} by the Newton-Schulz iteration
+ *  - FOE_Solver::solve(): density matrices, chemical potential, band energy and entropy
+ *    compared with the dense generalized eigenvalue problem
+ */
+
+class FOESolverTest : public testing::Test
+{
+  protected:
+    // a chain of atoms with 1, 2 or 3 orbitals, neighbors up to the second one
+    const int nat = 13;
+    const int range = 2;
+    std::vector<int> atom_begin;
+    int nbasis = 0;
+    // dense matrices, row-major
+    std::vector<double> h;
+    std::vector<double> h2;
+    std::vector<double> s;
+
+    void SetUp()
+    {
+        atom_begin.assign(nat + 1, 0);
+        for (int iat = 0; iat < nat; ++iat)
+        {
+            atom_begin[iat + 1] = atom_begin[iat] + 1 + iat % 3;
+        }
+        nbasis = atom_begin[nat];
+        h = random_symmetric(1, 0.3, true);
+        h2 = random_symmetric(3, 0.3, true);
+        s = random_symmetric(2, 0.08, false);
+    }
+
+    int atom_of(const int mu)
+    {
+        return std::upper_bound(atom_begin.begin(), atom_begin.end(), mu) - atom_begin.begin() - 1;
+    }
+
+    std::vector<double> random_symmetric(const int seed, const double coupling, const bool hamilt)
+    {
+        std::mt19937 gen(seed);
+        std::uniform_real_distribution<double> dis(-1.0, 1.0);
+        std::vector<double> a(nbasis * nbasis, 0.0);
+        for (int mu = 0; mu < nbasis; ++mu)
+        {
+            for (int nu = 0; nu <= mu; ++nu)
+            {
+                const int dist = std::abs(atom_of(mu) - atom_of(nu));
+                double value = 0.0;
+                if (mu == nu)
+                {
+                    value = hamilt ? dis(gen) : 1.0;
+                }
+                else if (dist <= range)
+                {
+                    value = coupling * dis(gen) / (1 + dist);
+                }
+                a[mu * nbasis + nu] = value;
+                a[nu * nbasis + mu] = value;
+            }
+        }
+        return a;
+    }
+
+    foe::BlockSparseMatrix to_sparse(const foe::AtomRows* rows, const std::vector<double>& a)
+    {
+        std::vector<std::vector<int>> cols(rows->last_atom - rows->first_atom);
+        for (int iat = rows->first_atom; iat < rows->last_atom; ++iat)
+        {
+            for (int jat = std::max(0, iat - range); jat <= std::min(nat - 1, iat + range); ++jat)
+            {
+                cols[iat - rows->first_atom].push_back(jat);
+            }
+        }
+        foe::BlockSparseMatrix m(rows, cols);
+        for (int iat = rows->first_atom; iat < rows->last_atom; ++iat)
+        {
+            for (const int jat: cols[iat - rows->first_atom])
+            {
+                double* block = m.find_block(iat, jat);
+                for (int mu = atom_begin[iat]; mu < atom_begin[iat + 1]; ++mu)
+                {
+                    for (int nu = atom_begin[jat]; nu < atom_begin[jat + 1]; ++nu)
+                    {
+                        *block++ = a[mu * nbasis + nu];
+                    }
+                }
+            }
+        }
+        return m;
+    }
+
+    // max |a - m| over the blocks of the local rows of m
+    double max_diff(const foe::BlockSparseMatrix& m, const std::vector<double>& a)
+    {
+        const foe::AtomRows* rows = m.get_rows();
+        double diff = 0.0;
+        for (int iat = rows->first_atom; iat < rows->last_atom; ++iat)
+        {
+            for (const int jat: m.get_hr().get_sparse_ap()[iat])
+            {
+                const double* block = m.find_block(iat, jat);
+                for (int mu = atom_begin[iat]; mu < atom_begin[iat + 1]; ++mu)
+                {
+                    for (int nu = atom_begin[jat]; nu < atom_begin[jat + 1]; ++nu)
+                    {
+                        diff = std::max(diff, std::abs(*block++ - a[mu * nbasis + nu]));
+                    }
+                }
+            }
+        }
+        return diff;
+    }
+
+    std::vector<double> matmul(const std::vector<double>& a, const std::vector<double>& b)
+    {
+        std::vector<double> c(nbasis * nbasis, 0.0);
+        for (int i = 0; i < nbasis; ++i)
+        {
+            for (int k = 0; k < nbasis; ++k)
+            {
+                for (int j = 0; j < nbasis; ++j)
+                {
+                    c[i * nbasis + j] += a[i * nbasis + k] * b[k * nbasis + j];
+                }
+            }
+        }
+        return c;
+    }
+
+    // H c = e S c, the columns of c are normalized by S
+    void eigh(const std::vector<double>& ha, std::vector<double>& e, std::vector<double>& c)
+    {
+        const int itype = 1;
+        const char jobz = 'V';
+        const char uplo = 'U';
+        int lwork = 8 * nbasis;
+        int info = 0;
+        std::vector<double> work(lwork);
+        std::vector<double> b = s;
+        c = ha;
+        e.resize(nbasis);
+        dsygv_(&itype, &jobz, &uplo, &nbasis, c.data(), &nbasis, b.data(), &nbasis, e.data(), work.data(), &lwork, &info);
+        ASSERT_EQ(info, 0);
+    }
+
+    // sum_n c_n w_n c_n^T, c is column-major from LAPACK
+    std::vector<double> weighted_sum(const std::vector<double>& c, const std::vector<double>& w)
+    {
+        std::vector<double> d(nbasis * nbasis, 0.0);
+        for (int n = 0; n < nbasis; ++n)
+        {
+            for (int mu = 0; mu < nbasis; ++mu)
+            {
+                for (int nu = 0; nu < nbasis; ++nu)
+                {
+                    d[mu * nbasis + nu] += c[n * nbasis + mu] * w[n] * c[n * nbasis + nu];
+                }
+            }
+        }
+        return d;
+    }
+};
+
+TEST_F(FOESolverTest, AtomRows)
+{
+    foe::AtomRows rows(atom_begin, MPI_COMM_WORLD);
+    EXPECT_EQ(rows.nat, nat);
+    EXPECT_EQ(rows.nbasis, nbasis);
+    for (int iat = 1; iat < nat; ++iat)
+    {
+        EXPECT_LE(rows.owner[iat - 1], rows.owner[iat]);
+    }
+    int nlocal = rows.last_atom - rows.first_atom;
+    MPI_Allreduce(MPI_IN_PLACE, &nlocal, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+    EXPECT_EQ(nlocal, nat);
+    for (int iat = rows.first_atom; iat < rows.last_atom; ++iat)
+    {
+        EXPECT_EQ(rows.owner[iat], rows.rank);
+    }
+}
+
+TEST_F(FOESolverTest, Multiply)
+{
+    foe::AtomRows rows(atom_begin, MPI_COMM_WORLD);
+    const foe::BlockSparseMatrix hs = to_sparse(&rows, h);
+    const foe::BlockSparseMatrix ss = to_sparse(&rows, s);
+    const foe::BlockSparseMatrix c = foe::BlockSparseMatrix::multiply(hs, ss, 0.0);
+    EXPECT_LT(max_diff(c, matmul(h, s)), 1e-12);
+    // the product couples the atoms up to 2 * range
+    long nblocks = 0;
+    for (int iat = 0; iat < nat; ++iat)
+    {
+        nblocks += std::min(nat - 1, iat + 2 * range) - std::max(0, iat - 2 * range) + 1;
+    }
+    EXPECT_EQ(c.nblocks(), nblocks);
+    EXPECT_NEAR(c.trace(), hs.dot(ss), 1e-12);
+
+    // a large threshold keeps only the diagonal blocks
+    const foe::BlockSparseMatrix diag = foe::BlockSparseMatrix::multiply(hs, ss, 1e10);
+    EXPECT_EQ(diag.nblocks(), nat);
+    EXPECT_NEAR(diag.trace(), c.trace(), 1e-12);
+}
+
+TEST_F(FOESolverTest, AddAndGershgorin)
+{
+    foe::AtomRows rows(atom_begin, MPI_COMM_WORLD);
+    const foe::BlockSparseMatrix hs = to_sparse(&rows, h);
+    const foe::BlockSparseMatrix unit = foe::BlockSparseMatrix::identity(&rows);
+    const foe::BlockSparseMatrix shifted = foe::BlockSparseMatrix::add(2.0, hs, -0.5, unit);
+    std::vector<double> ref(h);
+    for (int mu = 0; mu < nbasis; ++mu)
+    {
+        for (int nu = 0; nu < nbasis; ++nu)
+        {
+            ref[mu * nbasis + nu] = 2.0 * h[mu * nbasis + nu] - (mu == nu ? 0.5 : 0.0);
+        }
+    }
+    EXPECT_LT(max_diff(shifted, ref), 1e-14);
+    EXPECT_NEAR(shifted.trace(), 2.0 * hs.trace() - 0.5 * nbasis, 1e-12);
+
+    std::vector<double> e;
+    std::vector<double> c;
+    std::vector<double> ha = h;
+    std::fill(s.begin(), s.end(), 0.0);
+    for (int mu = 0; mu < nbasis; ++mu)
+    {
+        s[mu * nbasis + mu] = 1.0;
+    }
+    eigh(ha, e, c);
+    double lower = 0.0;
+    double upper = 0.0;
+    hs.gershgorin(lower, upper);
+    EXPECT_LE(lower, e.front());
+    EXPECT_GE(upper, e.back());
+}
+
+TEST_F(FOESolverTest, Inverse)
+{
+    foe::AtomRows rows(atom_begin, MPI_COMM_WORLD);
+    const foe::BlockSparseMatrix ss = to_sparse(&rows, s);
+    foe::FOE_Solver solver(1e-14, 0, -99, 0.05);
+    const foe::BlockSparseMatrix x = solver.inverse(ss);
+
+    // dense inverse from S = U e U^T
+    std::vector<double> e;
+    std::vector<double> u = s;
+    e.resize(nbasis);
+    const char jobz = 'V';
+    const char uplo = 'U';
+    int lwork = 8 * nbasis;
+    int info = 0;
+    std::vector<double> work(lwork);
+    dsyev_(&jobz, &uplo, &nbasis, u.data(), &nbasis, e.data(), work.data(), &lwork, &info);
+    ASSERT_EQ(info, 0);
+    for (int n = 0; n < nbasis; ++n)
+    {
+        e[n] = 1.0 / e[n];
+    }
+    EXPECT_LT(max_diff(x, weighted_sum(u, e)), 1e-8);
+}
+
+TEST_F(FOESolverTest, SolveFermiDirac)
+{
+    foe::AtomRows rows(atom_begin, MPI_COMM_WORLD);
+    const foe::BlockSparseMatrix hs = to_sparse(&rows, h);
+    const foe::BlockSparseMatrix ss = to_sparse(&rows, s);
+    const double sigma = 0.05;
+    const double nelec = 11.0;
+    foe::FOE_Solver solver(1e-14, 0, -99, sigma);
+    std::vector<foe::BlockSparseMatrix> dm;
+    std::vector<foe::BlockSparseMatrix> edm;
+    solver.solve({&hs}, ss, {nelec}, false, dm, edm);
+    ASSERT_EQ(dm.size(), 1);
+    ASSERT_EQ(edm.size(), 1);
+
+    std::vector<double> e;
+    std::vector<double> c;
+    eigh(h, e, c);
+    // chemical potential of the eigenvalues
+    double lower = e.front() - 1.0;
+    double upper = e.back() + 1.0;
+    for (int iter = 0; iter < 200; ++iter)
+    {
+        const double mu = 0.5 * (lower + upper);
+        double ne = 0.0;
+        for (int n = 0; n < nbasis; ++n)
+        {
+            ne += 2.0 * Occupy::wgauss((mu - e[n]) / sigma, -99);
+        }
+        (ne > nelec ? upper : lower) = mu;
+    }
+    const double mu = 0.5 * (lower + upper);
+    std::vector<double> f(nbasis);
+    std::vector<double> ef(nbasis);
+    double eband = 0.0;
+    double demet = 0.0;
+    for (int n = 0; n < nbasis; ++n)
+    {
+        f[n] = 2.0 * Occupy::wgauss((mu - e[n]) / sigma, -99);
+        ef[n] = e[n] * f[n];
+        eband += ef[n];
+        demet += 2.0 * sigma * Occupy::w1gauss((mu - e[n]) / sigma, -99);
+    }
+
+    EXPECT_NEAR(solver.mu[0], mu, 1e-6);
+    EXPECT_NEAR(solver.eband, eband, 1e-6);
+    EXPECT_NEAR(solver.demet, demet, 1e-6);
+    EXPECT_LT(max_diff(dm[0], weighted_sum(c, f)), 1e-6);
+    EXPECT_LT(max_diff(edm[0], weighted_sum(c, ef)), 1e-6);
+    // number of electrons and band energy from the density matrix
+    EXPECT_NEAR(dm[0].dot(ss), nelec, 1e-6);
+    EXPECT_NEAR(dm[0].dot(hs), eband, 1e-6);
+}
+
+TEST_F(FOESolverTest, SolveTwoSpins)
+{
+    foe::AtomRows rows(atom_begin, MPI_COMM_WORLD);
+    const foe::BlockSparseMatrix hs_up = to_sparse(&rows, h);
+    const foe::BlockSparseMatrix hs_dw = to_sparse(&rows, h2);
+    const foe::BlockSparseMatrix ss = to_sparse(&rows, s);
+    const double sigma = 0.02;
+    foe::FOE_Solver solver(1e-14, 0, 0, sigma);
+    std::vector<foe::BlockSparseMatrix> dm;
+    std::vector<foe::BlockSparseMatrix> edm;
+
+    // one chemical potential for both spins
+    solver.solve({&hs_up, &hs_dw}, ss, {9.0}, false, dm, edm);
+    ASSERT_EQ(dm.size(), 2);
+    EXPECT_DOUBLE_EQ(solver.mu[0], solver.mu[1]);
+    EXPECT_NEAR(dm[0].dot(ss) + dm[1].dot(ss), 9.0, 1e-6);
+
+    // fixed number of electrons of each spin
+    solver.solve({&hs_up, &hs_dw}, ss, {5.0, 4.0}, true, dm, edm);
+    EXPECT_NEAR(dm[0].dot(ss), 5.0, 1e-6);
+    EXPECT_NEAR(dm[1].dot(ss), 4.0, 1e-6);
+    for (int is = 0; is < 2; ++is)
+    {
+        std::vector<double> e;
+        std::vector<double> c;
+        eigh(is == 0 ? h : h2, e, c);
+        std::vector<double> f(nbasis);
+        for (int n = 0; n < nbasis; ++n)
+        {
+            f[n] = Occupy::wgauss((solver.mu[is] - e[n]) / sigma, 0);
+        }
+        EXPECT_LT(max_diff(dm[is], weighted_sum(c, f)), 1e-6);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    MPI_Init(&argc, &argv);
+    testing::InitGoogleTest(&argc, argv);
+    int result = RUN_ALL_TESTS();
+    MPI_Finalize();
+    return result;
+}
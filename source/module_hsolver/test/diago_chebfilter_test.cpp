@@ -0,0 +1,220 @@
+#include "module_base/lapack_connector.h"
+#include "module_psi/psi.h"
+#include "module_hamilt_general/hamilt.h"
+#include "module_hamilt_pw/hamilt_pwdft/hamilt_pw.h"
+#include "../diago_iter_assist.h"
+#include "../diago_chebfilter.h"
+#include "diago_mock.h"
+#include "mpi.h"
+#include "module_basis/module_pw/test/test_tool.h"
+
+#include <gtest/gtest.h>
+#include <complex>
+#include <random>
+
+/************************************************
+ *  unit test of functions in DiagoChebFilter
+ ***********************************************/
+
+/**
+ * Class DiagoChebFilter is a Chebyshev-filtered subspace iteration for eigenvalue problems.
+ * This unittest tests the function DiagoChebFilter::diag() for T=std::complex<double>, Device=cpu
+ *  - the Hermite matrices (npw=500,1000) produced using random numbers and with sparsity of 0%, 60%, 80%
+ *  - the Hamiltonian matrix read from "H-KPoints-Si64.dat"
+ *
+ * The test is passed when the eigenvalues are close to those calculated by LAPACK.
+ *  - the upper bound of the spectrum of a k point is estimated by Lanczos in the first SCF iteration only
+ */
+
+// call lapack in order to compare to chebfilter
+void lapackEigen(int& npw, std::vector<std::complex<double>>& hm, double* e)
+{
+    int lwork = 2 * npw;
+    std::complex<double>* work2 = new std::complex<double>[lwork];
+    double* rwork = new double[3 * npw - 2];
+    int info = 0;
+    char tmp_c1 = 'V', tmp_c2 = 'U';
+    zheev_(&tmp_c1, &tmp_c2, &npw, hm.data(), &npw, e, work2, &lwork, rwork, &info);
+    delete[] rwork;
+    delete[] work2;
+}
+
+class DiagoChebFilterPrepare
+{
+  public:
+    DiagoChebFilterPrepare(int nband, int npw, int sparsity, int degree, double eps, int maxiter, double threshold)
+        : nband(nband), npw(npw), sparsity(sparsity), degree(degree), eps(eps), maxiter(maxiter),
+          threshold(threshold)
+    {
+    }
+
+    int nband, npw, sparsity, degree, maxiter;
+    // eps is the convergence threshold of the filter passes
+    double eps;
+    // threshold is the comparison standard between chebfilter and lapack
+    double threshold;
+
+    void CompareEigen()
+    {
+        // calculate eigenvalues by LAPACK;
+        std::vector<double> e_lapack(npw, 0.0);
+        auto ev = DIAGOTEST::hmatrix;
+        lapackEigen(npw, ev, e_lapack.data());
+
+        // initial guess of psi by perturbing lapack psi
+        using T = std::complex<double>;
+        psi::Psi<T> psi;
+        psi.resize(1, nband, npw);
+        std::default_random_engine p(1);
+        std::uniform_int_distribution<unsigned> u(1, 10);
+        for (int i = 0; i < nband; i++)
+        {
+            for (int j = 0; j < npw; j++)
+            {
+                double rand = static_cast<double>(u(p)) / 10.;
+                psi(i, j) = ev[i * npw + j] * rand;
+            }
+        }
+        psi.fix_k(0);
+
+        const int dim = npw;
+        const std::vector<T>& h_mat = DIAGOTEST::hmatrix;
+        auto hpsi_func = [h_mat, dim](T* psi_in, T* hpsi_out, const int ld_psi, const int nvec) {
+            const T one = 1.0;
+            const T zero = 0.0;
+            base_device::DEVICE_CPU* ctx = {};
+            // hpsi_out(dim * nvec) = h_mat(dim * dim) * psi_in(dim * nvec)
+            hsolver::gemm_op<T, base_device::DEVICE_CPU>()(ctx,
+                                                            'N',
+                                                            'N',
+                                                            dim,
+                                                            nvec,
+                                                            dim,
+                                                            &one,
+                                                            h_mat.data(),
+                                                            dim,
+                                                            psi_in,
+                                                            ld_psi,
+                                                            &zero,
+                                                            hpsi_out,
+                                                            ld_psi);
+        };
+
+        const hsolver::diag_comm_info comm_info = {MPI_COMM_SELF, 0, 1};
+        hsolver::DiagoChebFilter<T> chebfilter(nband, npw, degree, maxiter, comm_info);
+        std::vector<double> en(nband, 0.0);
+        std::vector<double> ethr_band(nband, eps);
+        const int npass = chebfilter.diag(hpsi_func, psi.get_pointer(), npw, en.data(), ethr_band, false);
+        EXPECT_GT(npass, 0);
+        EXPECT_LE(npass, maxiter);
+
+        for (int i = 0; i < nband; i++)
+        {
+            EXPECT_NEAR(en[i], e_lapack[i], threshold);
+        }
+    }
+};
+
+class DiagoChebFilterTest : public ::testing::TestWithParam<DiagoChebFilterPrepare>
+{
+};
+
+TEST_P(DiagoChebFilterTest, RandomHamilt)
+{
+    DiagoChebFilterPrepare dcp = GetParam();
+    HPsi<std::complex<double>> hpsi(dcp.nband, dcp.npw, dcp.sparsity);
+    DIAGOTEST::hmatrix = hpsi.hamilt();
+    DIAGOTEST::npw = dcp.npw;
+    dcp.CompareEigen();
+}
+
+INSTANTIATE_TEST_SUITE_P(VerifyChebFilter,
+                         DiagoChebFilterTest,
+                         ::testing::Values(
+                             // nband, npw, sparsity, degree, eps, maxiter, threshold
+                             DiagoChebFilterPrepare(10, 500, 0, 10, 1e-8, 300, 1e-5),
+                             DiagoChebFilterPrepare(20, 500, 6, 10, 1e-8, 300, 1e-5),
+                             DiagoChebFilterPrepare(20, 1000, 8, 16, 1e-8, 300, 1e-5)));
+
+TEST(DiagoChebFilterTest, readH)
+{
+    // read Hamilt matrix from file data-H
+    std::vector<std::complex<double>> hm;
+    std::ifstream ifs;
+    ifs.open("H-KPoints-Si64.dat");
+    DIAGOTEST::readh(ifs, hm);
+    ifs.close();
+    int dim = DIAGOTEST::npw;
+    int nband = 10;
+    DIAGOTEST::hmatrix = hm;
+    // nband, npw, sparsity, degree, eps, maxiter, threshold
+    DiagoChebFilterPrepare dcp(nband, dim, 0, 12, 1e-8, 500, 1e-5);
+    dcp.CompareEigen();
+}
+
+TEST(DiagoChebFilterTest, UpperBoundKept)
+{
+    using T = std::complex<double>;
+    const int npw = 300;
+    const int nband = 10;
+    HPsi<T> hpsi(nband, npw, 0);
+    const std::vector<T> h_mat = hpsi.hamilt();
+    std::vector<double> e_lapack(npw, 0.0);
+    std::vector<T> ev = h_mat;
+    int dim = npw;
+    lapackEigen(dim, ev, e_lapack.data());
+
+    // the Lanczos steps are the only calls with a single vector
+    int nsingle = 0;
+    auto hpsi_func = [&h_mat, &nsingle, npw](T* psi_in, T* hpsi_out, const int ld_psi, const int nvec) {
+        const T one = 1.0;
+        const T zero = 0.0;
+        base_device::DEVICE_CPU* ctx = {};
+        nsingle += (nvec == 1);
+        hsolver::gemm_op<T, base_device::DEVICE_CPU>()
+            (ctx, 'N', 'N', npw, nvec, npw, &one, h_mat.data(), npw, psi_in, ld_psi, &zero, hpsi_out, ld_psi);
+    };
+    std::vector<T> psi(nband * npw);
+    std::default_random_engine p(1);
+    std::uniform_real_distribution<double> u(-1.0, 1.0);
+    for (auto& x: psi)
+    {
+        x = T(u(p), u(p));
+    }
+
+    const hsolver::diag_comm_info comm_info = {MPI_COMM_SELF, 0, 1};
+    std::vector<double> en(nband, 0.0);
+    std::vector<double> ethr_band(nband, 1e-8);
+    const int ik = 3;
+    hsolver::DiagoIterAssist<T>::SCF_ITER = 1;
+    hsolver::DiagoChebFilter<T> first(nband, npw, 10, 300, comm_info);
+    first.diag(hpsi_func, psi.data(), npw, en.data(), ethr_band, true, ik);
+    EXPECT_GT(nsingle, 0);
+
+    // a new solver of a later SCF iteration reuses the bound and still refines the bands
+    nsingle = 0;
+    hsolver::DiagoIterAssist<T>::SCF_ITER = 2;
+    hsolver::DiagoChebFilter<T> second(nband, npw, 10, 300, comm_info);
+    EXPECT_EQ(second.diag(hpsi_func, psi.data(), npw, en.data(), ethr_band, true, ik), 1);
+    EXPECT_EQ(nsingle, 0);
+    for (int i = 0; i < nband; i++)
+    {
+        EXPECT_NEAR(en[i], e_lapack[i], 1e-5);
+    }
+
+    // another k point has no bound yet
+    second.diag(hpsi_func, psi.data(), npw, en.data(), ethr_band, true, ik + 1);
+    EXPECT_GT(nsingle, 0);
+    hsolver::DiagoIterAssist<T>::SCF_ITER = 1;
+}
+
+int main(int argc, char** argv)
+{
+    MPI_Init(&argc, &argv);
+
+    testing::InitGoogleTest(&argc, argv);
+    int result = RUN_ALL_TESTS();
+
+    MPI_Finalize();
+    return result;
+}
@@ -231,6 +231,70 @@ TEST(DiagoDavRealSystemTest, dataH)
 	delete [] precondition_local;
 }
 
+#ifdef __MPI
+// every process is a band group holding the whole H and psi: hpsi and the rows of the
+// reduced Hamiltonian are split over the processes and gathered in all of them
+TEST(DiagoDavBandGroupTest, RandomHamilt)
+{
+	int nprocs = 1, mypnum = 0;
+	MPI_Comm_size(MPI_COMM_WORLD, &nprocs);
+	MPI_Comm_rank(MPI_COMM_WORLD, &mypnum);
+	const int nband = 10;
+	int npw = 100;
+
+	HPsi<std::complex<double>> hpsi(nband, npw, 0);
+	std::vector<std::complex<double>> hmatrix = hpsi.hamilt();
+	psi::Psi<std::complex<double>> psi = hpsi.psi();
+	// the same H and psi in all the band groups
+	MPI_Bcast(hmatrix.data(), npw * npw, MPI_DOUBLE_COMPLEX, 0, MPI_COMM_WORLD);
+	MPI_Bcast(psi.get_pointer(), nband * npw, MPI_DOUBLE_COMPLEX, 0, MPI_COMM_WORLD);
+	std::vector<double> e_lapack(npw);
+	lapackEigen(npw, hmatrix, e_lapack.data());
+
+	// the pool of each band group is a single process
+	const MPI_Comm pool_world = POOL_WORLD;
+	POOL_WORLD = MPI_COMM_SELF;
+	const hsolver::diag_comm_info comm_info = {MPI_COMM_SELF, 0, 1};
+	const hsolver::diag_comm_info band_comm = {MPI_COMM_WORLD, mypnum, nprocs};
+	hsolver::DiagoDavid<std::complex<double>> dav(hpsi.precond(), nband, npw, 4, false, comm_info, band_comm);
+
+	auto hpsi_func = [&hmatrix](std::complex<double>* psi_in, std::complex<double>* hpsi_out,
+					const int ld_psi, const int nvec)
+					{
+						const std::complex<double> one = 1.0, zero = 0.0;
+						char transa = 'N', transb = 'N';
+						int m = ld_psi, n = nvec, k = ld_psi;
+						zgemm_(&transa, &transb, &m, &n, &k, &one, hmatrix.data(), &m, psi_in, &k, &zero, hpsi_out, &m);
+					};
+	auto hpsi_group = [&hpsi_func, band_comm](std::complex<double>* psi_in, std::complex<double>* hpsi_out,
+					const int ld_psi, const int nvec)
+					{
+						hsolver::band_group_hpsi<std::complex<double>, base_device::DEVICE_CPU>(hpsi_func, band_comm, psi_in, hpsi_out, ld_psi, nvec);
+					};
+	auto spsi_func = [](const std::complex<double>* psi_in, std::complex<double>* spsi_out,
+					const int ld_psi, const int nvec)
+					{
+						std::copy(psi_in, psi_in + ld_psi * nvec, spsi_out);
+					};
+	std::vector<double> ethr_band(nband, 1e-5);
+	std::vector<double> en(npw, 0.0);
+	dav.diag(hpsi_group, spsi_func, npw, psi.get_pointer(), en.data(), ethr_band, 500);
+	POOL_WORLD = pool_world;
+
+	for (int i = 0; i < nband; i++)
+	{
+		EXPECT_NEAR(en[i], e_lapack[i], CONVTHRESHOLD);
+	}
+	// the groups end with the same eigenvectors
+	std::vector<std::complex<double>> psi0(psi.get_pointer(), psi.get_pointer() + nband * npw);
+	MPI_Bcast(psi0.data(), nband * npw, MPI_DOUBLE_COMPLEX, 0, MPI_COMM_WORLD);
+	for (int i = 0; i < nband * npw; i++)
+	{
+		EXPECT_NEAR(std::abs(psi0[i] - psi.get_pointer()[i]), 0.0, 1e-10);
+	}
+}
+#endif
+
 int main(int argc, char **argv)
 {
 	int nproc = 1, myrank = 0;
@@ -0,0 +1,106 @@
+#include "batch_stru.h"
+
+#include <algorithm>
+#include <dirent.h>
+#include <fstream>
+#include <sstream>
+#include <sys/stat.h>
+
+namespace
+{
+
+bool is_directory(const std::string& path)
+{
+    struct stat st;
+    return stat(path.c_str(), &st) == 0 && S_ISDIR(st.st_mode);
+}
+
+std::string file_name(const std::string& path)
+{
+    const std::size_t pos = path.find_last_of('/');
+    return (pos == std::string::npos) ? path : path.substr(pos + 1);
+}
+
+} // namespace
+
+namespace ModuleIO
+{
+
+Batch_Stru::Batch_Stru(const std::string& batch_in) : batch(batch_in)
+{
+    this->is_dir = is_directory(batch_in);
+}
+
+void Batch_Stru::find(std::vector<std::string>& new_files, std::vector<std::string>& new_names)
+{
+    new_files.clear();
+    new_names.clear();
+    if (this->is_dir)
+    {
+        const std::string dir = (this->batch.back() == '/') ? this->batch : this->batch + "/";
+        std::vector<std::string> entries;
+        DIR* dp = opendir(dir.c_str());
+        if (dp == nullptr)
+        {
+            return;
+        }
+        struct dirent* ep = nullptr;
+        while ((ep = readdir(dp)) != nullptr)
+        {
+            const std::string entry = ep->d_name;
+            // skip ".", ".." and the hidden files
+            if (entry.empty() || entry[0] == '.' || is_directory(dir + entry))
+            {
+                continue;
+            }
+            entries.push_back(entry);
+        }
+        closedir(dp);
+        std::sort(entries.begin(), entries.end());
+
+        for (const std::string& entry: entries)
+        {
+            if (this->found.insert(dir + entry).second)
+            {
+                new_files.push_back(dir + entry);
+                new_names.push_back(entry);
+            }
+        }
+        return;
+    }
+
+    std::ifstream ifs(this->batch.c_str());
+    std::string line;
+    while (std::getline(ifs, line))
+    {
+        std::stringstream ss(line);
+        std::string path;
+        std::string name;
+        if (!(ss >> path) || path[0] == '#')
+        {
+            continue;
+        }
+        if (!(ss >> name))
+        {
+            name = file_name(path);
+        }
+        if (this->found.insert(path).second)
+        {
+            new_files.push_back(path);
+            new_names.push_back(name);
+        }
+    }
+}
+
+bool Batch_Stru::add(const std::string& file, const std::string& name)
+{
+    if (!this->used_names.insert(name).second)
+    {
+        return false;
+    }
+    this->files.push_back(file);
+    this->names.push_back(name);
+    return true;
+}
+
+} // namespace ModuleIO
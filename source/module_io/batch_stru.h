@@ -0,0 +1,56 @@
+#ifndef BATCH_STRU_H
+#define BATCH_STRU_H
+
+#include <set>
+#include <string>
+#include <vector>
+
+namespace ModuleIO
+{
+
+/**
+ * @brief the structures of the batch mode (stru_batch)
+ * stru_batch is a file whose lines are "path [name]", or a directory of structure files whose names are
+ * the file names. Each name is the output directory of its structure, so two structures can not share it.
+ */
+class Batch_Stru
+{
+  public:
+    explicit Batch_Stru(const std::string& batch_in);
+
+    /// whether stru_batch is a directory, which is scanned again for the structures streamed in
+    bool from_dir() const
+    {
+        return this->is_dir;
+    }
+
+    /**
+     * @brief look for the structures not found by the earlier calls, only called by rank 0
+     * the lines starting with '#' of a list file, and the hidden files and subdirectories of a directory are skipped
+     * @param new_files paths of the new structures
+     * @param new_names names of the new structures
+     */
+    void find(std::vector<std::string>& new_files, std::vector<std::string>& new_names);
+
+    /**
+     * @brief add a structure to run
+     * @return false if an earlier structure has the same name, then the structure is not added
+     */
+    bool add(const std::string& file, const std::string& name);
+
+    // paths and names of the structures added
+    std::vector<std::string> files;
+    std::vector<std::string> names;
+
+  private:
+    std::string batch;
+    bool is_dir = false;
+    // paths found by find()
+    std::set<std::string> found;
+    // names of the structures added
+    std::set<std::string> used_names;
+};
+
+} // namespace ModuleIO
+
+#endif
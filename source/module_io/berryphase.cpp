@@ -252,6 +252,11 @@ double berryphase::stringPhase(const UnitCell& ucell,
     ModuleBase::Vector3<double> G(0.0, 0.0, 0.0);
     ModuleBase::Vector3<double> dk = kv.kvec_c[k_index[index_str][1]] - kv.kvec_c[k_index[index_str][0]];
     // GlobalV::ofs_running << "the std::string index is " << index_str << std::endl;
+    std::vector<int> bands(nbands);
+    for (int ib = 0; ib < nbands; ib++)
+    {
+        bands[ib] = ib;
+    }
 
     for (int k_start = 0; k_start < (nppstr - 1); k_start++)
     {
@@ -260,74 +265,13 @@ double berryphase::stringPhase(const UnitCell& ucell,
 
         if (PARAM.inp.basis_type == "pw")
         {
-            for (int mb = 0; mb < nbands; mb++)
+            // the last k point of the string is k_0 + G
+            G = ModuleBase::Vector3<double>(0.0, 0.0, 0.0);
+            if (k_start == (nppstr - 2))
             {
-
-                for (int nb = 0; nb < nbands; nb++)
-                {
-
-                    if (PARAM.inp.nspin != 4)
-                    {
-                        if (k_start == (nppstr - 2))
-                        {
-                            if (direction == 1)
-                            {
-                                ModuleBase::Vector3<double> tem_G(1.0, 0.0, 0.0);
-                                G = tem_G;
-                            }
-                            if (direction == 2)
-                            {
-                                ModuleBase::Vector3<double> tem_G(0.0, 1.0, 0.0);
-                                G = tem_G;
-                            }
-                            if (direction == 3)
-                            {
-                                ModuleBase::Vector3<double> tem_G(0.0, 0.0, 1.0);
-                                G = tem_G;
-                            }
-
-                            mat(nb, mb) = pw_method.unkdotp_G0(rhopw, wfcpw, ik_1, ik_2, nb, mb, psi_in, G);
-                        }
-                        else
-                        {
-                            mat(nb, mb) = pw_method.unkdotp_G(wfcpw, ik_1, ik_2, nb, mb, psi_in);
-                        }
-                    }
-                    else
-                    {
-                        if (k_start == (nppstr - 2))
-                        {
-                            if (direction == 1)
-                            {
-                                ModuleBase::Vector3<double> tem_G(1.0, 0.0, 0.0);
-                                G = tem_G;
-                            }
-                            if (direction == 2)
-                            {
-                                ModuleBase::Vector3<double> tem_G(0.0, 1.0, 0.0);
-                                G = tem_G;
-                            }
-                            if (direction == 3)
-                            {
-                                ModuleBase::Vector3<double> tem_G(0.0, 0.0, 1.0);
-                                G = tem_G;
-                            }
-
-                            mat(nb, mb) = pw_method.unkdotp_soc_G0(rhopw, wfcpw, ik_1, ik_2, nb, mb, psi_in, G);
-                        } else {
-                            mat(nb, mb) = pw_method.unkdotp_soc_G(wfcpw,
-                                                                  ik_1,
-                                                                  ik_2,
-                                                                  nb,
-                                                                  mb,
-                                                                  npwx,
-                                                                  psi_in);
-                        }
-                    }
-
-                } // nb
-
-            } // mb
+                G[direction - 1] = 1.0;
+            }
+            pw_method.unkdotp_matrix(wfcpw, ik_1, ik_2, bands, psi_in, G, mat);
 
             std::complex<double> det(1.0, 0.0);
             int info = 0;
@@ -192,7 +192,7 @@ void Input_Conv::Convert()
     {
         GlobalV::KPAR = PARAM.inp.kpar;
     }
-    if (PARAM.inp.device  == "cpu" and PARAM.inp.precision == "single")
+    if (PARAM.inp.device  == "cpu" and (PARAM.inp.precision == "single" or PARAM.inp.precision == "mixed"))
     {
 // cpu single precision is not supported while float_fftw lib is not available
 #ifndef __ENABLE_FLOAT_FFTW
@@ -1,6 +1,7 @@
 #include "output_info.h"
 #include "../para_json.h"
 #include "module_parameter/parameter.h"
+#include "module_base/memory.h"
 #include "abacusjson.h"
 
 
@@ -161,5 +162,35 @@ namespace Json
         // Json::AbacusJson::add_Json(scf_obj,true,"output",-1,"scf");
     }
 
+    void add_output_memory()
+    {
+        if (!ModuleBase::Memory::get_track())
+        {
+            return;
+        }
+        const std::vector<ModuleBase::Memory::TrackRecord> records = ModuleBase::Memory::reduce_track();
+        for (const auto& record : records)
+        {
+            Json::jsonValue scope_obj(JobjectType);
+            scope_obj.JaddStringV("tag", record.tag);
+            scope_obj.JaddNormal("peak_min_MB", record.peak_min);
+            scope_obj.JaddNormal("peak_avg_MB", record.peak_avg);
+            scope_obj.JaddNormal("peak_max_MB", record.peak_max);
+            scope_obj.JaddNormal("stage_peak_max_MB", record.stage_peak_max);
+            scope_obj.JaddNormal("thread_peak_max_MB", record.thread_peak_max);
+            scope_obj.JaddNormal("count", static_cast<int64_t>(record.count));
+            Json::AbacusJson::add_json({"memory", "scopes"}, scope_obj, true);
+        }
+        for (const auto& entry : ModuleBase::Memory::get_timeline())
+        {
+            Json::jsonValue entry_obj(JobjectType);
+            entry_obj.JaddStringV("tag", entry.tag);
+            entry_obj.JaddNormal("time_s", entry.time);
+            entry_obj.JaddNormal("live_MB", entry.live);
+            entry_obj.JaddNormal("stage_peak_MB", entry.stage_peak);
+            Json::AbacusJson::add_json({"memory", "timeline"}, entry_obj, true);
+        }
+    }
+
 #endif
 } // namespace Json
\ No newline at end of file
@@ -31,6 +31,12 @@ namespace Json
         const double energy, const double ediff, const double drho,const double time
     );
 
+    /**
+    * @brief add the tracked memory of each tagged scope (min/avg/max over the ranks)
+    *        and the timeline of rank 0, must be called by all ranks
+    */
+    void add_output_memory();
+
 #endif
 }
 #endif
\ No newline at end of file
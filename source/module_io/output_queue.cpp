@@ -0,0 +1,114 @@
+#include "output_queue.h"
+
+#include "module_base/timer.h"
+
+namespace ModuleIO
+{
+
+Output_Queue& Output_Queue::instance()
+{
+    static Output_Queue queue;
+    return queue;
+}
+
+Output_Queue::~Output_Queue()
+{
+    this->finalize();
+}
+
+void Output_Queue::set_capacity(const std::size_t capacity_in)
+{
+    if (capacity_in == 0)
+    {
+        this->flush();
+    }
+    std::lock_guard<std::mutex> lock(this->mtx);
+    this->capacity = capacity_in;
+}
+
+void Output_Queue::push(std::function<void()> job, const std::size_t bytes)
+{
+    if (!this->async())
+    {
+        job();
+        return;
+    }
+    std::unique_lock<std::mutex> lock(this->mtx);
+    if (!this->thread.joinable())
+    {
+        this->stop = false;
+        this->thread = std::thread(&Output_Queue::worker, this);
+    }
+    // wait for room, a job larger than the capacity is taken alone
+    if (this->bytes_queued + bytes > this->capacity && this->bytes_queued > 0)
+    {
+        ModuleBase::timer::tick("Output_Queue", "wait_full");
+        this->cv_done.wait(lock, [&] { return this->bytes_queued + bytes <= this->capacity || this->bytes_queued == 0; });
+        ModuleBase::timer::tick("Output_Queue", "wait_full");
+    }
+    this->jobs.push_back(Job{std::move(job), bytes});
+    this->bytes_queued += bytes;
+    lock.unlock();
+    this->cv_push.notify_one();
+}
+
+void Output_Queue::flush()
+{
+    std::unique_lock<std::mutex> lock(this->mtx);
+    if (!this->thread.joinable() || this->thread.get_id() == std::this_thread::get_id())
+    {
+        return;
+    }
+    this->cv_done.wait(lock, [this] { return this->jobs.empty() && !this->busy; });
+}
+
+void Output_Queue::finalize()
+{
+    this->flush();
+    {
+        std::lock_guard<std::mutex> lock(this->mtx);
+        if (!this->thread.joinable())
+        {
+            return;
+        }
+        this->stop = true;
+    }
+    this->cv_push.notify_one();
+    if (this->thread.get_id() == std::this_thread::get_id())
+    {
+        // a job ended the program, the thread can not wait for itself
+        this->thread.detach();
+    }
+    else
+    {
+        this->thread.join();
+    }
+}
+
+void Output_Queue::worker()
+{
+    std::unique_lock<std::mutex> lock(this->mtx);
+    while (true)
+    {
+        this->cv_push.wait(lock, [this] { return !this->jobs.empty() || this->stop; });
+        if (this->jobs.empty())
+        {
+            return;
+        }
+        Job job = std::move(this->jobs.front());
+        this->jobs.pop_front();
+        this->busy = true;
+        lock.unlock();
+
+        job.run();
+        // free the buffers before they are given back to the capacity
+        job.run = nullptr;
+
+        lock.lock();
+        this->busy = false;
+        this->bytes_queued -= job.bytes;
+        this->cv_done.notify_all();
+    }
+}
+
+} // namespace ModuleIO
@@ -0,0 +1,83 @@
+#ifndef OUTPUT_QUEUE_H
+#define OUTPUT_QUEUE_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace ModuleIO
+{
+
+/**
+ * @brief queue of output jobs written by a dedicated I/O thread
+ * The computing process gathers the data to be written, moves the gathered buffers into a job and
+ * pushes it here, then goes on with the next SCF or MD step while the I/O thread formats and writes
+ * the file. The queue holds at most `capacity` bytes of buffers, push() waits for the I/O thread when
+ * it is full. With a capacity of 0 the jobs are run at once by the calling thread, as without the queue.
+ * The jobs must not use MPI nor the running logs, they only own their buffers and write their own file.
+ */
+class Output_Queue
+{
+  public:
+    /// the queue of this process, the I/O thread is started by the first push
+    static Output_Queue& instance();
+
+    /// capacity in bytes of the buffers held by the queue, 0 for synchronous output
+    void set_capacity(const std::size_t capacity_in);
+
+    /// whether pushed jobs are written asynchronously
+    bool async() const
+    {
+        return this->capacity > 0;
+    }
+
+    /**
+     * @brief hand an output job to the I/O thread
+     * @param job formats and writes one file, owning all the data it needs
+     * @param bytes size of the buffers owned by the job, counted against the capacity
+     */
+    void push(std::function<void()> job, const std::size_t bytes);
+
+    /// wait until all the pushed jobs are written
+    void flush();
+
+    /// flush and stop the I/O thread, called at the end of the run and at exit
+    void finalize();
+
+    ~Output_Queue();
+
+  private:
+    Output_Queue() = default;
+    Output_Queue(const Output_Queue&) = delete;
+    Output_Queue& operator=(const Output_Queue&) = delete;
+
+    void worker();
+
+    struct Job
+    {
+        std::function<void()> run;
+        std::size_t bytes;
+    };
+
+    std::size_t capacity = 0;
+    // bytes of the jobs waiting or being written
+    std::size_t bytes_queued = 0;
+    std::deque<Job> jobs;
+    // the job taken by the I/O thread but not finished yet
+    bool busy = false;
+    bool stop = false;
+
+    std::mutex mtx;
+    // signalled when a job is pushed or the thread is asked to stop
+    std::condition_variable cv_push;
+    // signalled when a job is finished
+    std::condition_variable cv_done;
+    std::thread thread;
+};
+
+} // namespace ModuleIO
+
+#endif
@@ -11,6 +11,7 @@
 #include "json_output/abacusjson.h"
 #include "json_output/general_info.h"
 #include "json_output/init_info.h"
+#include "json_output/output_info.h"
 #include "json_output/readin_info.h"
 
 #endif // __RAPIDJSON
@@ -42,6 +43,7 @@ void create_Json(UnitCell* ucell, const Parameter& param)
 #ifdef __RAPIDJSON
     gen_general_info(param);
     gen_init(ucell);
+    add_output_memory();
     // gen_stru(ucell);
 #endif
     json_output();
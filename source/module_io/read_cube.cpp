@@ -1,4 +1,5 @@
 #include "module_io/cube_io.h"
+#include "module_io/output_queue.h"
 #include <limits>
 #include "module_hamilt_pw/hamilt_pwdft/parallel_grid.h"
 // #include "module_base/global_variable.h" // GlobalV reference removed
@@ -13,6 +14,9 @@ bool ModuleIO::read_vdata_palgrid(
 {
     ModuleBase::TITLE("ModuleIO", "read_vdata_palgrid");
 
+    // the file may still be in the output queue
+    Output_Queue::instance().flush();
+
     // check if the file exists
     std::ifstream ifs(fn.c_str());
     if (!ifs)
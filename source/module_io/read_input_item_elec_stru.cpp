@@ -62,7 +62,7 @@ void ReadInput::item_elec_stru()
         };
         item.check_value = [](const Input_Item& item, const Parameter& para) {
             const std::string& ks_solver = para.input.ks_solver;
-            const std::vector<std::string> pw_solvers = {"cg", "dav", "bpcg", "dav_subspace"};
+            const std::vector<std::string> pw_solvers = {"cg", "dav", "bpcg", "dav_subspace", "chfsi"};
             const std::vector<std::string> lcao_solvers = {
                 "genelpa",
                 "elpa",
@@ -72,6 +72,7 @@ void ReadInput::item_elec_stru()
                 "cusolvermp",
                 "pexsi",
                 "cg_in_lcao",
+                "foe",
             };
 
             if (para.input.basis_type == "pw")
@@ -137,6 +138,16 @@ void ReadInput::item_elec_stru()
                                              "ks_solver to scalapack_gvx.");
 #endif
                 }
+                else if (ks_solver == "foe")
+                {
+#ifndef __MPI
+                    ModuleBase::WARNING_QUIT("ReadInput", "foe can not be used for series version.");
+#endif
+                    if (!para.input.gamma_only)
+                    {
+                        ModuleBase::WARNING_QUIT("ReadInput", "foe is only implemented for gamma_only calculations.");
+                    }
+                }
             }
             else if (para.input.basis_type == "lcao_in_pw")
             {
@@ -326,6 +337,18 @@ void ReadInput::item_elec_stru()
         read_sync_int(input.pw_diag_ndim);
         this->add_item(item);
     }
+    {
+        Input_Item item("pw_diag_cheb_degree");
+        item.annotation = "degree of the Chebyshev filter for chfsi diagonalization";
+        read_sync_int(input.pw_diag_cheb_degree);
+        item.check_value = [](const Input_Item& item, const Parameter& para) {
+            if (para.input.ks_solver == "chfsi" && para.input.pw_diag_cheb_degree < 1)
+            {
+                ModuleBase::WARNING_QUIT("ReadInput", "pw_diag_cheb_degree should be positive");
+            }
+        };
+        this->add_item(item);
+    }
     {
         Input_Item item("diago_cg_prec");
         item.annotation = "diago_cg_prec";
@@ -748,6 +771,12 @@ void ReadInput::item_elec_stru()
         };
         this->add_item(item);
     }
+    {
+        Input_Item item("gint_balance");
+        item.annotation = "distribute the big cells of grid integration by their cost";
+        read_sync_bool(input.gint_balance);
+        this->add_item(item);
+    }
     {
         Input_Item item("elpa_num_thread");
         item.annotation = "Number of threads need to use in elpa";
@@ -2,6 +2,8 @@
 #include "read_input.h"
 #include "read_input_tool.h"
 
+#include <unistd.h>
+
 namespace ModuleIO
 {
 void ReadInput::item_md()
@@ -312,6 +314,53 @@ void ReadInput::item_md()
         read_sync_int(input.mdp.md_nraise);
         this->add_item(item);
     }
+    {
+        Input_Item item("md_respa");
+        item.annotation = "number of steps with the cheap forces per Kohn-Sham force, 1 for off";
+        read_sync_int(input.mdp.md_respa);
+        item.check_value = [](const Input_Item& item, const Parameter& para) {
+            const MD_para& mdp = para.input.mdp;
+            if (mdp.md_respa < 1)
+            {
+                ModuleBase::WARNING_QUIT("ReadInput", "md_respa should be positive");
+            }
+            if (mdp.md_respa == 1 || para.input.calculation != "md")
+            {
+                return;
+            }
+            if (mdp.md_type != "nve" && mdp.md_type != "nvt" && mdp.md_type != "langevin")
+            {
+                ModuleBase::WARNING_QUIT("ReadInput", "md_respa > 1 only supports md_type nve, nvt and langevin");
+            }
+            if (para.input.esolver_type == "lj" || para.input.esolver_type == "dp")
+            {
+                ModuleBase::WARNING_QUIT("ReadInput", "md_respa > 1 needs a first-principles esolver_type");
+            }
+            if (mdp.md_restartfreq % mdp.md_respa != 0)
+            {
+                ModuleBase::WARNING_QUIT("ReadInput", "md_restartfreq should be a multiple of md_respa");
+            }
+        };
+        this->add_item(item);
+    }
+    {
+        Input_Item item("md_respa_esolver");
+        item.annotation = "the cheap force model of the multiple time step MD: lj, dp";
+        read_sync_string(input.mdp.md_respa_esolver);
+        item.check_value = [](const Input_Item& item, const Parameter& para) {
+            const MD_para& mdp = para.input.mdp;
+            if (mdp.md_respa_esolver != "lj" && mdp.md_respa_esolver != "dp")
+            {
+                ModuleBase::WARNING_QUIT("ReadInput", "md_respa_esolver should be lj or dp");
+            }
+            if (mdp.md_respa > 1 && para.input.calculation == "md" && mdp.md_respa_esolver == "dp"
+                && access(mdp.pot_file.c_str(), 0) == -1)
+            {
+                ModuleBase::WARNING_QUIT("ReadInput", "Can not find DP model !");
+            }
+        };
+        this->add_item(item);
+    }
     {
         Input_Item item("cal_syns");
         item.annotation = "calculate asynchronous overlap matrix to output for Hefei-NAMD";
@@ -127,6 +127,18 @@ void ReadInput::item_others()
         read_sync_double(input.sc_drop_thr);
         this->add_item(item);
     }
+    {
+        Input_Item item("sc_subspace_thr");
+        item.annotation = "Residual threshold (Ry) of lambda steps in the band subspace for LCAO, 0: full diagonalization";
+        read_sync_double(input.sc_subspace_thr);
+        item.check_value = [](const Input_Item& item, const Parameter& para) {
+            if (para.input.sc_subspace_thr < 0.0)
+            {
+                ModuleBase::WARNING_QUIT("ReadInput", "sc_subspace_thr must >= 0.0");
+            }
+        };
+        this->add_item(item);
+    }
     {
         Input_Item item("sc_scf_thr");
         item.annotation = "Density error threshold for inner loop of spin-constrained SCF";
@@ -414,6 +426,76 @@ void ReadInput::item_others()
         this->add_item(item);
     }
 
+    // FOE
+    {
+        Input_Item item("foe_order");
+        item.annotation = "number of Chebyshev polynomials of the Fermi-operator expansion, 0 for an estimate";
+        read_sync_int(input.foe_order);
+        item.check_value = [](const Input_Item& item, const Parameter& para) {
+            if (para.input.foe_order < 0)
+            {
+                ModuleBase::WARNING_QUIT("ReadInput", "foe_order should be non-negative");
+            }
+        };
+        this->add_item(item);
+    }
+    {
+        Input_Item item("foe_thr");
+        item.annotation = "truncation threshold of the blocks of the sparse matrices in foe";
+        read_sync_double(input.foe_thr);
+        this->add_item(item);
+    }
+
+    // Atom grids
+    {
+        Input_Item item("atom_grid");
+        item.annotation = "integrate the XC potential on atom-centered grids instead of the FFT grid";
+        read_sync_bool(input.atom_grid);
+        item.check_value = [](const Input_Item& item, const Parameter& para) {
+            if (!para.input.atom_grid)
+            {
+                return;
+            }
+            if (para.input.basis_type != "lcao" || !para.input.gamma_only)
+            {
+                ModuleBase::WARNING_QUIT("ReadInput", "atom_grid is only available for gamma_only LCAO calculations");
+            }
+            if (para.input.nspin != 1 && para.input.nspin != 2)
+            {
+                ModuleBase::WARNING_QUIT("ReadInput", "atom_grid is only available for nspin 1 or 2");
+            }
+            if (para.input.cal_force || para.input.cal_stress)
+            {
+                ModuleBase::WARNING_QUIT("ReadInput", "atom_grid does not support forces and stresses yet");
+            }
+        };
+        this->add_item(item);
+    }
+    {
+        Input_Item item("atom_grid_nrad");
+        item.annotation = "number of radial points of each atom grid";
+        read_sync_int(input.atom_grid_nrad);
+        item.check_value = [](const Input_Item& item, const Parameter& para) {
+            if (para.input.atom_grid_nrad <= 0)
+            {
+                ModuleBase::WARNING_QUIT("ReadInput", "atom_grid_nrad should be positive");
+            }
+        };
+        this->add_item(item);
+    }
+    {
+        Input_Item item("atom_grid_lmax");
+        item.annotation = "order of the Delley angular grid of each atom grid";
+        read_sync_int(input.atom_grid_lmax);
+        item.check_value = [](const Input_Item& item, const Parameter& para) {
+            if (para.input.atom_grid_lmax < 0 || para.input.atom_grid_lmax > 59)
+            {
+                ModuleBase::WARNING_QUIT("ReadInput", "atom_grid_lmax should be between 0 and 59");
+            }
+        };
+        this->add_item(item);
+    }
+
     // Only for Test
     {
         Input_Item item("out_alllog");
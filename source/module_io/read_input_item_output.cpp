@@ -356,6 +356,24 @@ void ReadInput::item_output()
         read_sync_int(input.out_ndigits);
         this->add_item(item);
     }
+    {
+        Input_Item item("out_async");
+        item.annotation = "MB of gathered outputs queued for the I/O thread, 0: synchronous output";
+        read_sync_int(input.out_async);
+        item.check_value = [](const Input_Item& item, const Parameter& para) {
+            if (para.input.out_async < 0)
+            {
+                ModuleBase::WARNING_QUIT("ReadInput", "out_async should be non-negative");
+            }
+        };
+        this->add_item(item);
+    }
+    {
+        Input_Item item("out_mem_track");
+        item.annotation = "track the CPU blocks of each stage and print their peaks";
+        read_sync_bool(input.out_mem_track);
+        this->add_item(item);
+    }
     {
         Input_Item item("out_mat_t");
         item.annotation = "output T(R) matrix";
@@ -9,10 +9,10 @@ void ReadInput::item_relax()
 {
     {
         Input_Item item("relax_method");
-        item.annotation = "cg; bfgs; sd; cg; cg_bfgs;";
+        item.annotation = "cg; bfgs; sd; cg; cg_bfgs; lbfgs_precon;";
         read_sync_string(input.relax_method);
         item.check_value = [](const Input_Item& item, const Parameter& para) {
-            const std::vector<std::string> relax_methods = {"cg", "bfgs", "sd", "cg_bfgs","bfgs_trad"};
+            const std::vector<std::string> relax_methods = {"cg", "bfgs", "sd", "cg_bfgs","bfgs_trad", "lbfgs_precon"};
             if (std::find(relax_methods.begin(),relax_methods.end(), para.input.relax_method)==relax_methods.end())
             {
                 const std::string warningstr = nofound_str(relax_methods, "relax_method");
@@ -26,10 +26,15 @@ void ReadInput::item_relax()
         item.annotation = "whether to use the new relaxation method";
         read_sync_bool(input.relax_new);
         item.reset_value = [](const Input_Item& item, Parameter& para) {
-            if (para.input.relax_new && para.input.relax_method != "cg")
+            if (para.input.relax_new && para.input.relax_method != "cg" && para.input.relax_method != "lbfgs_precon")
             {
                 para.input.relax_new = false;
             }
+            // lbfgs_precon is only implemented in the new relaxation framework
+            if (para.input.relax_method == "lbfgs_precon")
+            {
+                para.input.relax_new = true;
+            }
         };
         this->add_item(item);
     }
@@ -168,6 +173,28 @@ void ReadInput::item_relax()
         read_sync_double(input.relax_bfgs_init);
         this->add_item(item);
     }
+    {
+        Input_Item item("relax_precon");
+        item.annotation = "model Hessian of lbfgs_precon: exp; lindh";
+        read_sync_string(input.relax_precon);
+        item.check_value = [](const Input_Item& item, const Parameter& para) {
+            const std::vector<std::string> precons = {"exp", "lindh"};
+            if (std::find(precons.begin(), precons.end(), para.input.relax_precon) == precons.end())
+            {
+                const std::string warningstr = nofound_str(precons, "relax_precon");
+                ModuleBase::WARNING_QUIT("ReadInput", warningstr);
+            }
+            if (para.input.relax_method == "lbfgs_precon" && para.input.calculation == "cell-relax"
+                && ((para.input.fixed_axes != "None" && para.input.fixed_axes != "shape"
+                     && para.input.fixed_axes != "volume")
+                    || para.input.fixed_ibrav))
+            {
+                ModuleBase::WARNING_QUIT("ReadInput",
+                                         "lbfgs_precon only supports fixed_axes = None, shape or volume without fixed_ibrav");
+            }
+        };
+        this->add_item(item);
+    }
     {
         Input_Item item("fixed_axes");
         item.annotation = "which axes are fixed";
@@ -9,12 +9,12 @@ void ReadInput::item_sdft()
 {
     {
         Input_Item item("method_sto");
-        item.annotation = "1: slow and save memory, 2: fast and waste memory";
+        item.annotation = "1: slow and save memory, 2: fast and waste memory, 3: slow and save memory, N_e as 2";
         read_sync_int(input.method_sto);
         item.check_value = [](const Input_Item& item, const Parameter& para) {
-            if (para.input.method_sto != 1 && para.input.method_sto != 2)
+            if (para.input.method_sto != 1 && para.input.method_sto != 2 && para.input.method_sto != 3)
             {
-                ModuleBase::WARNING_QUIT("ReadInput", "method_sto should be 1 or 2");
+                ModuleBase::WARNING_QUIT("ReadInput", "method_sto should be 1, 2 or 3");
             }
         };
         this->add_item(item);
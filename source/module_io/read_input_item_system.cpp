@@ -247,7 +247,9 @@ void ReadInput::item_system()
                           "will be distributed among each group";
         read_sync_int(input.bndpar);
         item.reset_value = [](const Input_Item& item, Parameter& para) {
-            if (para.input.esolver_type != "sdft")
+            // band groups are used by stochastic DFT and by the Kohn-Sham PW diagonalization
+            if (para.input.esolver_type != "sdft"
+                && !(para.input.esolver_type == "ksdft" && para.input.basis_type == "pw"))
             {
                 para.input.bndpar = 1;
             }
@@ -477,6 +479,12 @@ void ReadInput::item_system()
         read_sync_int(input.fft_mode);
         this->add_item(item);
     }
+    {
+        Input_Item item("pw_table_fft");
+        item.annotation = "build the PW interpolation tables by FFT-based spherical Bessel transforms";
+        read_sync_bool(input.pw_table_fft);
+        this->add_item(item);
+    }
     {
         Input_Item item("init_wfc");
         item.annotation = "start wave functions are from 'atomic', "
@@ -595,6 +603,26 @@ void ReadInput::item_system()
         };
         this->add_item(item);
     }
+    {
+        Input_Item item("wfc_extrap");
+        item.annotation = "none; first-order; aspc: extrapolation of wave functions between ionic steps";
+        read_sync_string(input.wfc_extrap);
+        item.check_value = [](const Input_Item& item, const Parameter& para) {
+            const std::vector<std::string> wfc_extrap_list = {"none", "first-order", "aspc"};
+            if (std::find(wfc_extrap_list.begin(), wfc_extrap_list.end(), para.input.wfc_extrap)
+                == wfc_extrap_list.end())
+            {
+                const std::string warningstr = nofound_str(wfc_extrap_list, "wfc_extrap");
+                ModuleBase::WARNING_QUIT("ReadInput", warningstr);
+            }
+            // the LCAO SCF starts from the extrapolated charge, DM(R) is not extrapolated
+            if (para.input.wfc_extrap != "none" && para.input.basis_type != "pw")
+            {
+                ModuleBase::WARNING_QUIT("ReadInput", "wfc_extrap is only available for the pw basis");
+            }
+        };
+        this->add_item(item);
+    }
     {
         Input_Item item("init_vel");
         item.annotation = "read velocity from STRU or not";
@@ -616,6 +644,31 @@ void ReadInput::item_system()
         read_sync_string(input.stru_file);
         this->add_item(item);
     }
+    {
+        Input_Item item("stru_batch");
+        item.annotation = "a file listing the STRU files, or a directory of STRU files, run one by one";
+        read_sync_string(input.stru_batch);
+        item.check_value = [](const Input_Item& item, const Parameter& para) {
+            if (para.input.stru_batch == "none")
+            {
+                return;
+            }
+            const std::vector<std::string> callist = {"scf", "relax", "cell-relax", "md"};
+            if (std::find(callist.begin(), callist.end(), para.input.calculation) == callist.end())
+            {
+                ModuleBase::WARNING_QUIT("ReadInput", "stru_batch only supports scf, relax, cell-relax and md");
+            }
+            if (para.input.mdp.md_restart)
+            {
+                ModuleBase::WARNING_QUIT("ReadInput", "stru_batch can not be used with md_restart");
+            }
+            if (access(para.input.stru_batch.c_str(), 0) == -1)
+            {
+                ModuleBase::WARNING_QUIT("ReadInput", "Can not find the file or directory of stru_batch");
+            }
+        };
+        this->add_item(item);
+    }
     {
         Input_Item item("kpoint_file");
         item.annotation = "the name of file containing k points";
@@ -674,6 +727,18 @@ void ReadInput::item_system()
         };
         this->add_item(item);
     }
+    {
+        Input_Item item("table_cache_dir");
+        item.annotation = "directory of the interpolation tables kept between runs, none for off";
+        read_sync_string(input.table_cache_dir);
+        item.reset_value = [](const Input_Item& item, Parameter& para) {
+            if (para.input.table_cache_dir != "none")
+            {
+                para.input.table_cache_dir = to_dir(para.input.table_cache_dir);
+            }
+        };
+        this->add_item(item);
+    }
     {
         Input_Item item("restart_load");
         item.annotation = "restart from disk";
@@ -787,6 +852,45 @@ void ReadInput::item_system()
         Input_Item item("precision");
         item.annotation = "the computing precision for ABACUS";
         read_sync_string(input.precision);
+        item.check_value = [](const Input_Item& item, const Parameter& para) {
+            const std::vector<std::string> avail_list = {"single", "double", "mixed"};
+            if (std::find(avail_list.begin(), avail_list.end(), para.input.precision) == avail_list.end())
+            {
+                const std::string warningstr = nofound_str(avail_list, "precision");
+                ModuleBase::WARNING_QUIT("ReadInput", warningstr);
+            }
+            if (para.input.precision == "mixed")
+            {
+                if (para.input.basis_type != "pw" || para.input.esolver_type != "ksdft")
+                {
+                    ModuleBase::WARNING_QUIT("ReadInput", "precision = mixed is only available for ksdft with pw basis");
+                }
+                if (para.input.device == "gpu")
+                {
+                    ModuleBase::WARNING_QUIT("ReadInput", "precision = mixed is not supported on GPU yet");
+                }
+                if (para.input.dft_plus_u || para.input.sc_mag_switch || para.input.use_paw)
+                {
+                    ModuleBase::WARNING_QUIT("ReadInput",
+                                             "precision = mixed does not support DFT+U, DeltaSpin or PAW");
+                }
+#ifndef __ENABLE_FLOAT_FFTW
+                ModuleBase::WARNING_QUIT("ReadInput", "precision = mixed needs the single-precision FFTW, compile with ENABLE_FLOAT_FFTW");
+#endif
+            }
+        };
+        this->add_item(item);
+    }
+    {
+        Input_Item item("precision_switch_thr");
+        item.annotation = "drho below which precision = mixed switches from single to double precision";
+        read_sync_double(input.precision_switch_thr);
+        item.check_value = [](const Input_Item& item, const Parameter& para) {
+            if (para.input.precision_switch_thr <= 0.0)
+            {
+                ModuleBase::WARNING_QUIT("ReadInput", "precision_switch_thr should be positive");
+            }
+        };
         this->add_item(item);
     }
 }
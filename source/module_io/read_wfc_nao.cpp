@@ -2,6 +2,7 @@
 
 #include "module_base/parallel_common.h"
 #include "module_base/timer.h"
+#include "module_io/output_queue.h"
 #include "module_io/write_wfc_nao.h"
 
 #include "write_wfc_nao.h"
@@ -29,6 +30,8 @@ bool ModuleIO::read_wfc_nao(
 {
     ModuleBase::TITLE("ModuleIO", "read_wfc_nao");
     ModuleBase::timer::tick("ModuleIO", "read_wfc_nao");
+    // the file may still be in the output queue
+    Output_Queue::instance().flush();
     int nk = pelec->ekb.nr;
     bool gamma_only = std::is_same<T, double>::value;
     int out_type = 1; // only support text file now
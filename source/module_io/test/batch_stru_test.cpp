@@ -0,0 +1,134 @@
+#include "module_io/batch_stru.h"
+#include "module_parameter/parameter.h"
+
+#include "gtest/gtest.h"
+
+#include <cstdio>
+#include <fstream>
+#include <sys/stat.h>
+
+/************************************************
+ *  unit test of the structures of the batch mode
+ ***********************************************/
+
+/**
+ * - Tested Functions:
+ *   - Batch_Stru::find()
+ *     - the lines of a list file give "path [name]", comments and blank lines are skipped
+ *     - the files of a directory are found in order, the hidden files and subdirectories are skipped,
+ *       and the files added later are found by the next call
+ *   - Batch_Stru::add()
+ *     - the structures with the name of an earlier one are not added
+ *   - Parameter::set_batch_stru()
+ *     - the parameters read from INPUT are restored and the output goes to the directory of the structure
+ */
+
+class BatchStruTest : public testing::Test
+{
+  protected:
+    void TearDown() override
+    {
+        remove("batch_list");
+        remove("batch_dir/b_STRU");
+        remove("batch_dir/a_STRU");
+        remove("batch_dir/c_STRU");
+        remove("batch_dir/.hidden");
+        rmdir("batch_dir/sub");
+        rmdir("batch_dir");
+    }
+};
+
+TEST_F(BatchStruTest, List)
+{
+    std::ofstream ofs("batch_list");
+    ofs << "# path name" << std::endl;
+    ofs << "stru/Si_STRU  Si" << std::endl;
+    ofs << std::endl;
+    ofs << "  ../C_STRU" << std::endl;
+    ofs << "stru/Si_STRU  Si2" << std::endl;
+    ofs << "GaAs" << std::endl;
+    ofs.close();
+
+    ModuleIO::Batch_Stru batch("batch_list");
+    EXPECT_FALSE(batch.from_dir());
+    std::vector<std::string> files;
+    std::vector<std::string> names;
+    batch.find(files, names);
+    // the same path is run once
+    ASSERT_EQ(files.size(), 3);
+    EXPECT_EQ(files[0], "stru/Si_STRU");
+    EXPECT_EQ(names[0], "Si");
+    EXPECT_EQ(files[1], "../C_STRU");
+    EXPECT_EQ(names[1], "C_STRU");
+    EXPECT_EQ(files[2], "GaAs");
+    EXPECT_EQ(names[2], "GaAs");
+
+    batch.find(files, names);
+    EXPECT_TRUE(files.empty());
+    EXPECT_TRUE(names.empty());
+}
+
+TEST_F(BatchStruTest, Directory)
+{
+    mkdir("batch_dir", 0755);
+    mkdir("batch_dir/sub", 0755);
+    std::ofstream("batch_dir/b_STRU").close();
+    std::ofstream("batch_dir/a_STRU").close();
+    std::ofstream("batch_dir/.hidden").close();
+
+    ModuleIO::Batch_Stru batch("batch_dir");
+    EXPECT_TRUE(batch.from_dir());
+    std::vector<std::string> files;
+    std::vector<std::string> names;
+    batch.find(files, names);
+    ASSERT_EQ(files.size(), 2);
+    EXPECT_EQ(files[0], "batch_dir/a_STRU");
+    EXPECT_EQ(names[0], "a_STRU");
+    EXPECT_EQ(files[1], "batch_dir/b_STRU");
+    EXPECT_EQ(names[1], "b_STRU");
+
+    // a structure streamed in during the run
+    std::ofstream("batch_dir/c_STRU").close();
+    batch.find(files, names);
+    ASSERT_EQ(files.size(), 1);
+    EXPECT_EQ(files[0], "batch_dir/c_STRU");
+    EXPECT_EQ(names[0], "c_STRU");
+}
+
+TEST_F(BatchStruTest, DuplicateName)
+{
+    ModuleIO::Batch_Stru batch("batch_list");
+    EXPECT_TRUE(batch.add("a/STRU", "Si"));
+    EXPECT_TRUE(batch.add("b/STRU", "C"));
+    // the outputs would go to the same directory
+    EXPECT_FALSE(batch.add("c/STRU", "Si"));
+    ASSERT_EQ(batch.files.size(), 2);
+    EXPECT_EQ(batch.files[1], "b/STRU");
+    EXPECT_EQ(batch.names[1], "C");
+}
+
+TEST_F(BatchStruTest, ParameterReset)
+{
+    Input_para input0;
+    input0.nbands = 0;
+    input0.calculation = "relax";
+    System_para sys0;
+    sys0.global_out_dir = "OUT.batch/";
+    sys0.global_in_stru = "STRU";
+
+    Parameter param;
+    param.set_batch_stru(input0, sys0, "stru/Si_STRU", "Si");
+    // nbands is autoset from the first structure
+    param.set_input_nbands(16);
+    param.set_sys_nlocal(26);
+    EXPECT_EQ(param.inp.nbands, 16);
+
+    param.set_batch_stru(input0, sys0, "stru/C_STRU", "C");
+    EXPECT_EQ(param.inp.nbands, 0);
+    EXPECT_EQ(param.globalv.nlocal, sys0.nlocal);
+    EXPECT_EQ(param.inp.calculation, "relax");
+    EXPECT_EQ(param.globalv.global_in_stru, "stru/C_STRU");
+    EXPECT_EQ(param.globalv.global_out_dir, "OUT.batch/C/");
+    EXPECT_EQ(param.globalv.global_stru_dir, "OUT.batch/C/STRU/");
+    EXPECT_EQ(param.globalv.global_matrix_dir, "OUT.batch/C/matrix/");
+}
@@ -0,0 +1,125 @@
+#include "gtest/gtest.h"
+
+#include "../output_queue.h"
+
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+/************************************************
+ *  unit test of output_queue.cpp
+ ***********************************************/
+
+/**
+ * - Tested Functions:
+ *   - Output_Queue::push()
+ *     - jobs run at once without capacity, in order on the I/O thread with a capacity
+ *   - Output_Queue::push() with a full queue
+ *     - the caller waits until the buffers of the written jobs are released
+ *   - Output_Queue::flush()
+ *     - all the pushed files are complete after the flush
+ *   - Output_Queue::finalize()
+ *     - the I/O thread is stopped and restarted by the next push
+ */
+
+class OutputQueueTest : public testing::Test
+{
+  protected:
+    void TearDown() override
+    {
+        ModuleIO::Output_Queue::instance().finalize();
+        ModuleIO::Output_Queue::instance().set_capacity(0);
+    }
+};
+
+TEST_F(OutputQueueTest, Synchronous)
+{
+    ModuleIO::Output_Queue& queue = ModuleIO::Output_Queue::instance();
+    queue.set_capacity(0);
+    EXPECT_FALSE(queue.async());
+    std::thread::id id;
+    queue.push([&id]() { id = std::this_thread::get_id(); }, 8);
+    EXPECT_EQ(id, std::this_thread::get_id());
+}
+
+TEST_F(OutputQueueTest, AsyncOrderAndFlush)
+{
+    ModuleIO::Output_Queue& queue = ModuleIO::Output_Queue::instance();
+    queue.set_capacity(1 << 20);
+    EXPECT_TRUE(queue.async());
+    std::vector<int> order;
+    std::thread::id id;
+    for (int i = 0; i < 10; ++i)
+    {
+        const std::shared_ptr<const std::vector<double>> data = std::make_shared<const std::vector<double>>(100, i);
+        queue.push(
+            [i, &order, &id, data]() {
+                std::ofstream ofs("output_queue_" + std::to_string(i) + ".txt");
+                for (const double& d: *data)
+                {
+                    ofs << d << "\n";
+                }
+                order.push_back(i);
+                id = std::this_thread::get_id();
+            },
+            100 * sizeof(double));
+    }
+    queue.flush();
+    ASSERT_EQ(order.size(), 10);
+    for (int i = 0; i < 10; ++i)
+    {
+        EXPECT_EQ(order[i], i);
+        std::ifstream ifs("output_queue_" + std::to_string(i) + ".txt");
+        int lines = 0;
+        double d = 0.0;
+        while (ifs >> d)
+        {
+            EXPECT_EQ(d, i);
+            ++lines;
+        }
+        EXPECT_EQ(lines, 100);
+        std::remove(("output_queue_" + std::to_string(i) + ".txt").c_str());
+    }
+    EXPECT_NE(id, std::this_thread::get_id());
+}
+
+TEST_F(OutputQueueTest, FullQueueWaits)
+{
+    ModuleIO::Output_Queue& queue = ModuleIO::Output_Queue::instance();
+    queue.set_capacity(100);
+    std::atomic<int> running(0);
+    std::atomic<int> max_running(0);
+    std::atomic<int> done(0);
+    // every job fills the queue, so a push returns only when all the previous jobs are written
+    for (int i = 0; i < 5; ++i)
+    {
+        queue.push(
+            [&]() {
+                max_running = std::max(max_running.load(), ++running);
+                std::this_thread::sleep_for(std::chrono::milliseconds(20));
+                --running;
+                ++done;
+            },
+            100);
+        EXPECT_GE(done.load(), i);
+    }
+    queue.flush();
+    EXPECT_EQ(done.load(), 5);
+    EXPECT_EQ(max_running.load(), 1);
+}
+
+TEST_F(OutputQueueTest, FinalizeAndRestart)
+{
+    ModuleIO::Output_Queue& queue = ModuleIO::Output_Queue::instance();
+    queue.set_capacity(1 << 10);
+    int count = 0;
+    queue.push([&count]() { ++count; }, 8);
+    queue.finalize();
+    EXPECT_EQ(count, 1);
+    queue.push([&count]() { ++count; }, 8);
+    queue.flush();
+    EXPECT_EQ(count, 2);
+}
@@ -36,10 +36,12 @@ TEST_F(InputParaTest, ParaRead)
     readinput.read_parameters(param, "./support/INPUT");
     EXPECT_EQ(param.inp.suffix, "autotest");
     EXPECT_EQ(param.inp.stru_file, "./support/STRU");
+    EXPECT_EQ(param.inp.stru_batch, "none");
     EXPECT_EQ(param.inp.kpoint_file, "KPT");
     EXPECT_EQ(param.inp.pseudo_dir, "../../PP_ORB/");
     EXPECT_EQ(param.inp.orbital_dir, "../../PP_ORB/");
     EXPECT_EQ(param.inp.read_file_dir, "OUT.autotest/");
+    EXPECT_EQ(param.inp.table_cache_dir, "none");
     EXPECT_EQ(param.inp.wannier_card, "none");
     EXPECT_EQ(param.inp.latname, "none");
     EXPECT_EQ(param.inp.calculation, "scf");
@@ -127,6 +129,7 @@ TEST_F(InputParaTest, ParaRead)
     EXPECT_DOUBLE_EQ(param.inp.relax_bfgs_rmax, 0.8);
     EXPECT_DOUBLE_EQ(param.inp.relax_bfgs_rmin, 1e-5);
     EXPECT_DOUBLE_EQ(param.inp.relax_bfgs_init, 0.5);
+    EXPECT_EQ(param.inp.relax_precon, "exp");
     EXPECT_DOUBLE_EQ(param.inp.relax_scale_force, 0.5);
     EXPECT_EQ(param.inp.nbspline, -1);
     EXPECT_FALSE(param.globalv.gamma_only_pw);
@@ -137,6 +140,7 @@ TEST_F(InputParaTest, ParaRead)
     EXPECT_DOUBLE_EQ(param.inp.erf_sigma, 4.0);
     EXPECT_DOUBLE_EQ(param.inp.ecutrho, 80);
     EXPECT_EQ(param.inp.fft_mode, 0);
+    EXPECT_FALSE(param.inp.pw_table_fft);
     EXPECT_EQ(param.globalv.ncx, 0);
     EXPECT_EQ(param.globalv.ncy, 0);
     EXPECT_EQ(param.globalv.ncz, 0);
@@ -146,6 +150,7 @@ TEST_F(InputParaTest, ParaRead)
     EXPECT_EQ(param.inp.bx, 2);
     EXPECT_EQ(param.inp.by, 2);
     EXPECT_EQ(param.inp.bz, 2);
+    EXPECT_FALSE(param.inp.gint_balance);
     EXPECT_EQ(param.inp.ndx, 0);
     EXPECT_EQ(param.inp.ndy, 0);
     EXPECT_EQ(param.inp.ndz, 0);
@@ -153,6 +158,7 @@ TEST_F(InputParaTest, ParaRead)
     EXPECT_EQ(param.inp.pw_diag_nmax, 50);
     EXPECT_EQ(param.inp.diago_cg_prec, 1);
     EXPECT_EQ(param.inp.pw_diag_ndim, 4);
+    EXPECT_EQ(param.inp.pw_diag_cheb_degree, 10);
     EXPECT_DOUBLE_EQ(param.inp.pw_diag_thr, 1.0e-2);
     EXPECT_FALSE(param.inp.diago_smooth_ethr);
     EXPECT_EQ(param.inp.nb2d, 0);
@@ -184,6 +190,7 @@ TEST_F(InputParaTest, ParaRead)
     EXPECT_EQ(param.inp.printe, 100);
     EXPECT_EQ(param.inp.init_chg, "atomic");
     EXPECT_EQ(param.inp.chg_extrap, "atomic");
+    EXPECT_EQ(param.inp.wfc_extrap, "none");
     EXPECT_EQ(param.inp.out_freq_elec, 0);
     EXPECT_EQ(param.inp.out_freq_ion, 0);
     EXPECT_EQ(param.inp.out_chg[0], 0);
@@ -211,6 +218,8 @@ TEST_F(InputParaTest, ParaRead)
     EXPECT_FALSE(param.inp.out_eband_terms);
     EXPECT_EQ(param.inp.out_interval, 1);
     EXPECT_EQ(param.inp.out_app_flag, 0);
+    EXPECT_EQ(param.inp.out_async, 0);
+    EXPECT_FALSE(param.inp.out_mem_track);
     EXPECT_EQ(param.inp.out_mat_r, 0);
     EXPECT_FALSE(param.inp.out_wfc_lcao);
     EXPECT_FALSE(param.inp.out_alllog);
@@ -360,6 +369,8 @@ TEST_F(InputParaTest, ParaRead)
     EXPECT_FALSE(param.inp.of_read_kernel);
     EXPECT_EQ(param.inp.of_kernel_file, "WTkernel.txt");
     EXPECT_EQ(param.inp.device, "cpu");
+    EXPECT_EQ(param.inp.precision, "double");
+    EXPECT_DOUBLE_EQ(param.inp.precision_switch_thr, 1.0e-4);
     EXPECT_NEAR(param.inp.force_thr_ev, 0.025711245953622324, 1e-8);
     EXPECT_DOUBLE_EQ(param.globalv.hubbard_u[0], 0);
     EXPECT_EQ(param.inp.orbital_corr[0], -1);
@@ -372,6 +383,8 @@ TEST_F(InputParaTest, ParaRead)
     EXPECT_EQ(param.inp.mdp.md_dt, 1);
     EXPECT_EQ(param.inp.mdp.md_dumpfreq, 1);
     EXPECT_EQ(param.inp.mdp.md_nraise, 1);
+    EXPECT_EQ(param.inp.mdp.md_respa, 1);
+    EXPECT_EQ(param.inp.mdp.md_respa_esolver, "dp");
     EXPECT_EQ(param.inp.cal_syns, 0);
     EXPECT_EQ(param.inp.dmax, 0.01);
     EXPECT_EQ(param.inp.mdp.md_nstep, 10);
@@ -419,6 +432,12 @@ TEST_F(InputParaTest, ParaRead)
     EXPECT_DOUBLE_EQ(param.inp.sccut, 4.0);
     EXPECT_EQ(param.inp.sc_scf_thr, 1e-3);
     EXPECT_EQ(param.inp.sc_drop_thr, 1e-3);
+    EXPECT_EQ(param.inp.sc_subspace_thr, 0.0);
+    EXPECT_EQ(param.inp.foe_order, 0);
+    EXPECT_DOUBLE_EQ(param.inp.foe_thr, 1e-7);
+    EXPECT_FALSE(param.inp.atom_grid);
+    EXPECT_EQ(param.inp.atom_grid_nrad, 75);
+    EXPECT_EQ(param.inp.atom_grid_lmax, 29);
     EXPECT_EQ(param.inp.lr_nstates, 1);
     EXPECT_EQ(param.inp.nocc, param.inp.nbands);
     EXPECT_EQ(param.inp.nvirt, 1);
@@ -0,0 +1,148 @@
+#include "module_io/unk_overlap_pw.h"
+
+#include "gtest/gtest.h"
+#ifdef __MPI
+#include "module_base/parallel_global.h"
+#include "module_basis/module_pw/test/test_tool.h"
+#include "mpi.h"
+#endif
+
+/**
+ * - Tested Functions:
+ *  - unkOverlap_pw::unkdotp_matrix()
+ *    - the matrix agrees with the elements of unkdotp_G() for G = 0
+ *    - the matrix agrees with the elements of unkdotp_G0() for G != 0, also for a G outside the
+ *      G sphere of the wave functions
+ */
+
+class UnkOverlapPwTest : public ::testing::Test
+{
+  protected:
+    ModulePW::PW_Basis* rhopw = nullptr;
+    ModulePW::PW_Basis_K* wfcpw = nullptr;
+    psi::Psi<std::complex<double>>* evc = nullptr;
+    ModuleBase::Vector3<double> kvec_d[2];
+    const int nks = 2;
+    const int nbands = 4;
+    const double ecutwfc = 10.0;
+
+    void SetUp() override
+    {
+        const double lat0 = 5.0;
+        const ModuleBase::Matrix3 latvec(1.0, 0.0, 0.0, 0.1, 1.0, 0.0, 0.0, 0.0, 1.2);
+        kvec_d[0].set(0.0, 0.0, 0.375);
+        kvec_d[1].set(0.0, 0.0, -0.5);
+
+        rhopw = new ModulePW::PW_Basis;
+        wfcpw = new ModulePW::PW_Basis_K;
+#ifdef __MPI
+        rhopw->initmpi(GlobalV::NPROC_IN_POOL, GlobalV::RANK_IN_POOL, POOL_WORLD);
+        wfcpw->initmpi(GlobalV::NPROC_IN_POOL, GlobalV::RANK_IN_POOL, POOL_WORLD);
+#endif
+        rhopw->initgrids(lat0, latvec, 4 * ecutwfc);
+        rhopw->initparameters(false, 4 * ecutwfc);
+        rhopw->setuptransform();
+        rhopw->collect_local_pw();
+
+        wfcpw->initgrids(lat0, latvec, rhopw->nx, rhopw->ny, rhopw->nz);
+        wfcpw->initparameters(false, ecutwfc, nks, kvec_d);
+        wfcpw->setuptransform();
+        wfcpw->collect_local_pw();
+
+        evc = new psi::Psi<std::complex<double>>(nks, nbands, wfcpw->npwk_max, wfcpw->npwk);
+        for (int ik = 0; ik < nks; ik++)
+        {
+            for (int ib = 0; ib < nbands; ib++)
+            {
+                for (int ig = 0; ig < wfcpw->npwk_max; ig++)
+                {
+                    const int ig_global = (ig < wfcpw->npwk[ik]) ? wfcpw->getigl2ig(ik, ig) : -1;
+                    (*evc)(ik, ib, ig) = (ig < wfcpw->npwk[ik])
+                                             ? std::complex<double>(std::sin(0.3 * ig_global + ib + ik),
+                                                                    std::cos(0.7 * ig_global - 2 * ib))
+                                             : std::complex<double>(0.0, 0.0);
+                }
+            }
+        }
+    }
+
+    void TearDown() override
+    {
+        delete evc;
+        delete wfcpw;
+        delete rhopw;
+    }
+};
+
+TEST_F(UnkOverlapPwTest, MatrixG0)
+{
+    std::vector<int> bands = {0, 1, 2, 3};
+    ModuleBase::Vector3<double> G(0.0, 0.0, 0.0);
+    ModuleBase::ComplexMatrix mat;
+    unkOverlap_pw overlap;
+    overlap.unkdotp_matrix(wfcpw, 0, 1, bands, evc, G, mat);
+    for (int m = 0; m < nbands; m++)
+    {
+        for (int n = 0; n < nbands; n++)
+        {
+            const std::complex<double> ref = overlap.unkdotp_G(wfcpw, 0, 1, m, n, evc);
+            EXPECT_NEAR(mat(m, n).real(), ref.real(), 1e-8 * (1.0 + std::abs(ref)));
+            EXPECT_NEAR(mat(m, n).imag(), ref.imag(), 1e-8 * (1.0 + std::abs(ref)));
+        }
+    }
+}
+
+TEST_F(UnkOverlapPwTest, MatrixG)
+{
+    std::vector<int> bands = {0, 1, 2, 3};
+    unkOverlap_pw overlap;
+    // k_0 = k_1 + (0, 0, 1) is the neighbour of k_1 + G with G = (0, 0, 1);
+    // k_0 + (0, 0, 3) is outside the G sphere of the wave functions of k_0, but inside that of the density
+    for (const double gz: {1.0, 3.0})
+    {
+        const ModuleBase::Vector3<double> G(0.0, 0.0, gz);
+        const ModuleBase::Vector3<double> kg = kvec_d[0] + G;
+        EXPECT_LT(G * (rhopw->GGT * G), rhopw->ggecut);
+        if (gz > 2.0)
+        {
+            EXPECT_GT(kg * (wfcpw->GGT * kg), wfcpw->gk_ecut);
+        }
+
+        ModuleBase::ComplexMatrix mat;
+        overlap.unkdotp_matrix(wfcpw, 0, 1, bands, evc, G, mat);
+        double mat_max = 0.0;
+        for (int m = 0; m < nbands; m++)
+        {
+            for (int n = 0; n < nbands; n++)
+            {
+                const std::complex<double> ref = overlap.unkdotp_G0(rhopw, wfcpw, 0, 1, m, n, evc, G);
+                EXPECT_NEAR(mat(m, n).real(), ref.real(), 1e-8 * (1.0 + std::abs(ref)));
+                EXPECT_NEAR(mat(m, n).imag(), ref.imag(), 1e-8 * (1.0 + std::abs(ref)));
+                mat_max = std::max(mat_max, std::abs(mat(m, n)));
+            }
+        }
+        // the shift is not lost
+        EXPECT_GT(mat_max, 1e-3);
+    }
+}
+
+int main(int argc, char** argv)
+{
+#ifdef __MPI
+    setupmpi(argc, argv, GlobalV::NPROC, GlobalV::MY_RANK);
+    divide_pools(GlobalV::NPROC,
+                 GlobalV::MY_RANK,
+                 GlobalV::NPROC_IN_POOL,
+                 GlobalV::KPAR,
+                 GlobalV::MY_POOL,
+                 GlobalV::RANK_IN_POOL);
+#endif
+
+    testing::InitGoogleTest(&argc, argv);
+    int result = RUN_ALL_TESTS();
+
+#ifdef __MPI
+    finishmpi();
+#endif
+    return result;
+}
@@ -132,6 +132,40 @@ TEST_F(InputTest, Item_test)
         output = testing::internal::GetCapturedStdout();
         EXPECT_THAT(output, testing::HasSubstr("NOTICE"));
     }
+    { // precision
+        auto it = find_label("precision", readinput.input_lists);
+        const Input_para input_saved = param.input;
+        param.input.precision = "half";
+        testing::internal::CaptureStdout();
+        EXPECT_EXIT(it->second.check_value(it->second, param), ::testing::ExitedWithCode(1), "");
+        output = testing::internal::GetCapturedStdout();
+        EXPECT_THAT(output, testing::HasSubstr("NOTICE"));
+
+        param.input.precision = "mixed";
+        param.input.basis_type = "lcao";
+        testing::internal::CaptureStdout();
+        EXPECT_EXIT(it->second.check_value(it->second, param), ::testing::ExitedWithCode(1), "");
+        output = testing::internal::GetCapturedStdout();
+        EXPECT_THAT(output, testing::HasSubstr("NOTICE"));
+
+        param.input.basis_type = "pw";
+        param.input.esolver_type = "ksdft";
+        param.input.device = "gpu";
+        testing::internal::CaptureStdout();
+        EXPECT_EXIT(it->second.check_value(it->second, param), ::testing::ExitedWithCode(1), "");
+        output = testing::internal::GetCapturedStdout();
+        EXPECT_THAT(output, testing::HasSubstr("NOTICE"));
+        param.input = input_saved;
+    }
+    { // precision_switch_thr
+        auto it = find_label("precision_switch_thr", readinput.input_lists);
+        param.input.precision_switch_thr = -1.0;
+        testing::internal::CaptureStdout();
+        EXPECT_EXIT(it->second.check_value(it->second, param), ::testing::ExitedWithCode(1), "");
+        output = testing::internal::GetCapturedStdout();
+        EXPECT_THAT(output, testing::HasSubstr("NOTICE"));
+        param.input.precision_switch_thr = 1.0e-4;
+    }
     { // nbands
         auto it = find_label("nbands", readinput.input_lists);
         param.input.nbands = -1;
@@ -197,6 +231,19 @@ TEST_F(InputTest, Item_test)
         GlobalV::NPROC = 1;
         it->second.reset_value(it->second, param);
         EXPECT_EQ(param.input.bndpar, 1);
+
+        param.input.esolver_type = "ksdft";
+        param.input.basis_type = "lcao";
+        param.input.bndpar = 2;
+        GlobalV::NPROC = 4;
+        it->second.reset_value(it->second, param);
+        EXPECT_EQ(param.input.bndpar, 1);
+
+        param.input.basis_type = "pw";
+        param.input.bndpar = 2;
+        it->second.reset_value(it->second, param);
+        EXPECT_EQ(param.input.bndpar, 2);
+        GlobalV::NPROC = 1;
     }
     { // dft_plus_dmft
         auto it = find_label("dft_plus_dmft", readinput.input_lists);
@@ -363,6 +410,24 @@ TEST_F(InputTest, Item_test)
         it->second.reset_value(it->second, param);
         EXPECT_EQ(param.input.chg_extrap, "atomic");
     }
+    { // wfc_extrap
+        auto it = find_label("wfc_extrap", readinput.input_lists);
+        param.input.wfc_extrap = "second-order";
+        testing::internal::CaptureStdout();
+        EXPECT_EXIT(it->second.check_value(it->second, param), ::testing::ExitedWithCode(1), "");
+        output = testing::internal::GetCapturedStdout();
+        EXPECT_THAT(output, testing::HasSubstr("NOTICE"));
+
+        const std::string basis_saved = param.input.basis_type;
+        param.input.wfc_extrap = "aspc";
+        param.input.basis_type = "lcao";
+        testing::internal::CaptureStdout();
+        EXPECT_EXIT(it->second.check_value(it->second, param), ::testing::ExitedWithCode(1), "");
+        output = testing::internal::GetCapturedStdout();
+        EXPECT_THAT(output, testing::HasSubstr("NOTICE"));
+        param.input.basis_type = basis_saved;
+        param.input.wfc_extrap = "none";
+    }
     { // out_chg
         auto it = find_label("out_chg", readinput.input_lists);
         param.input.calculation = "get_wf";
@@ -704,6 +769,30 @@ TEST_F(InputTest, Item_test)
         param.input.relax_method = "none";
         it->second.reset_value(it->second, param);
         EXPECT_EQ(param.input.relax_new, false);
+
+        param.input.relax_new = false;
+        param.input.relax_method = "lbfgs_precon";
+        it->second.reset_value(it->second, param);
+        EXPECT_EQ(param.input.relax_new, true);
+    }
+    { // relax_precon
+        auto it = find_label("relax_precon", readinput.input_lists);
+        param.input.relax_precon = "none";
+        testing::internal::CaptureStdout();
+        EXPECT_EXIT(it->second.check_value(it->second, param), ::testing::ExitedWithCode(1), "");
+        output = testing::internal::GetCapturedStdout();
+        EXPECT_THAT(output, testing::HasSubstr("NOTICE"));
+
+        param.input.relax_precon = "exp";
+        param.input.relax_method = "lbfgs_precon";
+        param.input.calculation = "cell-relax";
+        param.input.fixed_axes = "a";
+        testing::internal::CaptureStdout();
+        EXPECT_EXIT(it->second.check_value(it->second, param), ::testing::ExitedWithCode(1), "");
+        output = testing::internal::GetCapturedStdout();
+        EXPECT_THAT(output, testing::HasSubstr("NOTICE"));
+        param.input.fixed_axes = "None";
+        param.input.relax_method = "cg";
     }
     { // force_thr
         auto it = find_label("force_thr", readinput.input_lists);
@@ -8,6 +8,7 @@
 #include "module_base/math_ylmreal.h"
 #include "module_base/parallel_reduce.h"
 #include "binstream.h"
+#include "unk_overlap_pw.h"
 
 toWannier90_PW::toWannier90_PW(
     const bool &out_wannier_mmn, 
@@ -364,131 +365,16 @@ void toWannier90_PW::unkdotkb(
 )
 {
     Mmn.create(num_bands, num_bands);
-
-    for (int m = 0; m < num_bands; m++)
+    if (gamma_only_wannier)
     {
-        int im = cal_band_index[m];
-        std::complex<double>* phase = new std::complex<double>[wfcpw->nmaxgr];
-        ModuleBase::GlobalFunc::ZEROS(phase, wfcpw->nmaxgr);
-
-        // get the phase value in realspace
-        for (int ig = 0; ig < wfcpw->npwk[cal_ik]; ig++)
-        {
-            // if wfcpw->getgdirect(cal_ik, ig) == phase_G
-            ModuleBase::Vector3<double> temp_G = wfcpw->getgdirect(cal_ik, ig) - G;
-            if (temp_G.norm() < 1e-9)
-            {
-                phase[ig] = std::complex<double>(1.0, 0.0);
-                break;
-            }
-        }
-
-        wfcpw->recip2real(phase, phase, cal_ik);
-
-        if (PARAM.inp.nspin == 4)
-        {
-            // (1) set value
-            std::complex<double>* psir_up = new std::complex<double>[wfcpw->nmaxgr];
-            std::complex<double>* psir_dn = new std::complex<double>[wfcpw->nmaxgr];
-            ModuleBase::GlobalFunc::ZEROS(psir_up, wfcpw->nmaxgr);
-            ModuleBase::GlobalFunc::ZEROS(psir_dn, wfcpw->nmaxgr);
-
-            // (2) fft and get value
-            // int npw_ik = wfcpw->npwk[cal_ik];
-            int npwx = wfcpw->npwk_max;
-            wfcpw->recip2real(&psi_pw(cal_ik, im, 0), psir_up, cal_ik);
-            // wfcpw->recip2real(&psi_pw(cal_ik, im, npw_ik), psir_dn, cal_ik);
-            wfcpw->recip2real(&psi_pw(cal_ik, im, npwx), psir_dn, cal_ik);
-            for (int ir = 0; ir < wfcpw->nrxx; ir++)
-            {
-                psir_up[ir] *= phase[ir];
-                psir_dn[ir] *= phase[ir];
-            }
-
-            wfcpw->real2recip(psir_up, psir_up, cal_ikb);
-            wfcpw->real2recip(psir_dn, psir_dn, cal_ikb);
-
-            for (int n = 0; n < num_bands; n++)
-            {
-                int in = cal_band_index[n];
-
-                if (!gamma_only_wannier)
-                {
-                    std::complex<double> result_tem(0.0, 0.0);
-
-                    // int npw_ikb = wfcpw->npwk[cal_ikb];
-                    int pwNumberMax = wfcpw->npwk_max;
-
-                    // Can be accelerated using lapack
-                    for (int ig = 0; ig < pwNumberMax; ig++)
-                    {
-                        result_tem = result_tem + conj(psir_up[ig]) * psi_pw(cal_ikb, in, ig) + conj(psir_dn[ig]) * psi_pw(cal_ikb, in, ig+pwNumberMax);
-                    }
-#ifdef __MPI
-                    Parallel_Reduce::reduce_all(result_tem);
-#endif
-                    Mmn(m, n) = result_tem;
-                }
-                else
-                {
-                    // GlobalV::ofs_running << "gamma only test" << std::endl;
-                }
-
-            }
-
-            delete[] psir_up;
-            delete[] psir_dn;
-
-        }
-        else
-        {
-            // (1) set value
-            std::complex<double>* psir = new std::complex<double>[wfcpw->nmaxgr];
-            ModuleBase::GlobalFunc::ZEROS(psir, wfcpw->nmaxgr);
-
-            // (2) fft and get value
-            wfcpw->recip2real(&psi_pw(cal_ik, im, 0), psir, cal_ik);
-            for (int ir = 0; ir < wfcpw->nrxx; ir++)
-            {
-                psir[ir] *= phase[ir];
-            }
-
-            wfcpw->real2recip(psir, psir, cal_ikb);
-
-            for (int n = 0; n < num_bands; n++)
-            {
-                int in = cal_band_index[n];
-
-                if (!gamma_only_wannier)
-                {
-                    std::complex<double> result_tem(0.0, 0.0);
-
-                    // Can be accelerated using lapack
-                    for (int ig = 0; ig < wfcpw->npwk[cal_ikb]; ig++)
-                    {
-                        result_tem = result_tem + conj(psir[ig]) * psi_pw(cal_ikb, in, ig);
-                    }
-
-#ifdef __MPI
-                    Parallel_Reduce::reduce_all(result_tem);
-#endif
-                    Mmn(m, n) = result_tem;
-                }
-                else
-                {
-                    // GlobalV::ofs_running << "gamma only test" << std::endl;
-                }
-
-            }
-
-            delete[] psir;
-            
-        }
-
-        delete[] phase;
-
+        return;
     }
 
+    // all the M_mn of the k-pair by one ZGEMM and one reduction
+    const std::vector<int> bands(cal_band_index, cal_band_index + num_bands);
+    unkOverlap_pw overlap;
+    overlap.unkdotp_matrix(wfcpw, cal_ik, cal_ikb, bands, &psi_pw, G, Mmn);
+
 }
 
 void toWannier90_PW::gen_radial_function_in_q(std::vector<ModuleBase::matrix> &radial_in_q)
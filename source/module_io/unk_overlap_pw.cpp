@@ -1,7 +1,10 @@
 #include "unk_overlap_pw.h"
 
+#include "module_base/blas_connector.h"
+#include "module_base/constants.h"
+#include "module_base/parallel_comm.h"
+#include "module_base/timer.h"
 #include "module_parameter/parameter.h"
-#include "module_hamilt_pw/hamilt_pwdft/global.h"
 
 unkOverlap_pw::unkOverlap_pw()
 {
@@ -81,7 +84,7 @@ std::complex<double> unkOverlap_pw::unkdotp_G0(const ModulePW::PW_Basis* rhopw,
     std::complex<double>* phase = new std::complex<double>[rhopw->nmaxgr];
 
     // get the phase value in realspace
-    for (int ig = 0; ig < rhopw->nmaxgr; ig++)
+    for (int ig = 0; ig < rhopw->npw; ig++)
     {
 		ModuleBase::Vector3<double> delta_G = rhopw->gdirect[ig] - G;
 		if (delta_G.norm2() < 1e-10) // rhopw->gdirect[ig] == G
@@ -247,3 +250,123 @@ std::complex<double> unkOverlap_pw::unkdotp_soc_G0(const ModulePW::PW_Basis* rho
 	delete[] psi_down;
     return result;
 }
+
+void unkOverlap_pw::unkdotp_matrix(const ModulePW::PW_Basis_K* wfcpw,
+                                   const int ik_L,
+                                   const int ik_R,
+                                   const std::vector<int>& bands,
+                                   const psi::Psi<std::complex<double>>* evc,
+                                   const ModuleBase::Vector3<double>& G,
+                                   ModuleBase::ComplexMatrix& mat)
+{
+    ModuleBase::timer::tick("unkOverlap_pw", "unkdotp_matrix");
+    const int nb = bands.size();
+    const int npol = PARAM.globalv.npol;
+    const int npwx = wfcpw->npwk_max;
+    const int npw_R = wfcpw->npwk[ik_R];
+    const int rows = npw_R * npol;
+
+    // (1) the bands of ik_L on the plane waves of ik_R, and the bands of ik_R, one band per row
+    std::vector<std::complex<double>> block_L(static_cast<size_t>(nb) * rows, std::complex<double>(0.0, 0.0));
+    std::vector<std::complex<double>> block_R(static_cast<size_t>(nb) * rows);
+    for (int ib = 0; ib < nb; ib++)
+    {
+        for (int ip = 0; ip < npol; ip++)
+        {
+            const std::complex<double>* unk_R = &evc[0](ik_R, bands[ib], ip * npwx);
+            std::copy(unk_R, unk_R + npw_R, &block_R[static_cast<size_t>(ib) * rows + ip * npw_R]);
+        }
+    }
+
+    if (G.norm2() < 1e-10)
+    {
+        // the same G vectors of both k points are local on the same process
+        std::vector<int> ig2igl_L(wfcpw->npw, -1);
+        for (int igl = 0; igl < wfcpw->npwk[ik_L]; igl++)
+        {
+            ig2igl_L[wfcpw->getigl2ig(ik_L, igl)] = igl;
+        }
+        std::vector<int> igl_R2igl_L(npw_R);
+        for (int igl = 0; igl < npw_R; igl++)
+        {
+            igl_R2igl_L[igl] = ig2igl_L[wfcpw->getigl2ig(ik_R, igl)];
+        }
+        for (int ib = 0; ib < nb; ib++)
+        {
+            for (int ip = 0; ip < npol; ip++)
+            {
+                const std::complex<double>* unk_L = &evc[0](ik_L, bands[ib], ip * npwx);
+                std::complex<double>* row = &block_L[static_cast<size_t>(ib) * rows + ip * npw_R];
+                for (int igl = 0; igl < npw_R; igl++)
+                {
+                    if (igl_R2igl_L[igl] >= 0)
+                    {
+                        row[igl] = unk_L[igl_R2igl_L[igl]];
+                    }
+                }
+            }
+        }
+    }
+    else
+    {
+        // shifted G vectors may live on other processes, exp(iG.r) is applied in real space.
+        // G is in direct coordinates, so the phase is set on the local grid points directly,
+        // and it does not matter whether G is inside a G sphere.
+        std::vector<std::complex<double>> phase(wfcpw->nmaxgr, std::complex<double>(0.0, 0.0));
+        const double twopi = ModuleBase::TWO_PI;
+        for (int ixy = 0; ixy < wfcpw->nx * wfcpw->ny; ixy++)
+        {
+            const int ix = ixy / wfcpw->ny;
+            const int iy = ixy % wfcpw->ny;
+            for (int iz = 0; iz < wfcpw->nplane; iz++)
+            {
+                const double arg = twopi
+                                   * (G.x * ix / wfcpw->nx + G.y * iy / wfcpw->ny
+                                      + G.z * (iz + wfcpw->startz_current) / wfcpw->nz);
+                phase[ixy * wfcpw->nplane + iz] = std::complex<double>(std::cos(arg), std::sin(arg));
+            }
+        }
+
+        std::vector<std::complex<double>> psi_r(wfcpw->nmaxgr);
+        for (int ib = 0; ib < nb; ib++)
+        {
+            for (int ip = 0; ip < npol; ip++)
+            {
+                wfcpw->recip2real(&evc[0](ik_L, bands[ib], ip * npwx), psi_r.data(), ik_L);
+                for (int ir = 0; ir < wfcpw->nrxx; ir++)
+                {
+                    psi_r[ir] *= phase[ir];
+                }
+                wfcpw->real2recip(psi_r.data(), psi_r.data(), ik_R);
+                std::copy(psi_r.begin(), psi_r.begin() + npw_R, &block_L[static_cast<size_t>(ib) * rows + ip * npw_R]);
+            }
+        }
+    }
+
+    // (2) conj(mat)(m, n) = sum_G block_L(m, G) * conj(block_R(n, G)), then one reduction in the pool
+    mat.create(nb, nb);
+    if (rows > 0)
+    {
+        BlasConnector::gemm('N',
+                            'C',
+                            nb,
+                            nb,
+                            rows,
+                            std::complex<double>(1.0, 0.0),
+                            block_L.data(),
+                            rows,
+                            block_R.data(),
+                            rows,
+                            std::complex<double>(0.0, 0.0),
+                            mat.c,
+                            nb);
+    }
+#ifdef __MPI
+    Parallel_Reduce::reduce_pool(mat.c, nb * nb);
+#endif
+    for (int i = 0; i < nb * nb; i++)
+    {
+        mat.c[i] = std::conj(mat.c[i]);
+    }
+    ModuleBase::timer::tick("unkOverlap_pw", "unkdotp_matrix");
+}
@@ -5,6 +5,7 @@
 #include <complex>
 #include <fstream>
 #include <string>
+#include <vector>
 
 #include "module_base/complexmatrix.h"
 #include "module_base/global_variable.h"
@@ -50,6 +51,22 @@ class unkOverlap_pw
                                         const psi::Psi<std::complex<double>>* evc,
                                         const ModuleBase::Vector3<double> G);
 
+    /**
+     * @brief overlap matrix mat(m, n) = <u_{m,k_L}|u_{n,k_R}> of the given bands, with one ZGEMM and one pool reduction
+     * The coefficients of ik_L are moved to the plane waves of ik_R and gathered into a contiguous block, by an
+     * index map built once if G is zero, or by one FFT pair per band after multiplying exp(iG.r) otherwise.
+     * exp(iG.r) is evaluated on the real-space grid, so G needs not be inside the G sphere of the wave functions.
+     * @param bands bands of both k points, such as 0, 1, ..., nbands-1
+     * @param G reciprocal lattice vector in direct coordinates, k_R + G is the neighbour of k_L
+     */
+    void unkdotp_matrix(const ModulePW::PW_Basis_K* wfcpw,
+                        const int ik_L,
+                        const int ik_R,
+                        const std::vector<int>& bands,
+                        const psi::Psi<std::complex<double>>* evc,
+                        const ModuleBase::Vector3<double>& G,
+                        ModuleBase::ComplexMatrix& mat);
+
     // this function just for test the class unkOverlap_pw that is works successful.
     void test_for_unkOverlap_pw();
 
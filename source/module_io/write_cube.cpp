@@ -1,6 +1,8 @@
 #include "module_base/element_name.h"
 #include "module_io/cube_io.h"
+#include "module_io/output_queue.h"
 #include "module_parameter/parameter.h"
+#include<memory>
 #include<vector>
 #include "module_hamilt_pw/hamilt_pwdft/parallel_grid.h"
 
@@ -122,7 +124,16 @@ void ModuleIO::write_vdata_palgrid(
                 atom_pos.push_back({ fac * ucell->atoms[it].tau[ia].x, fac * ucell->atoms[it].tau[ia].y, fac * ucell->atoms[it].tau[ia].z });
             }
         }
-        write_cube(fn, comment, ucell->nat, { 0.0, 0.0, 0.0 }, nx, ny, nz, dx, dy, dz, atom_type, atom_charge, atom_pos, data_xyz_full, precision);
+        // the gathered data and the header are owned by the job, the next step may go on at once
+        const int nat = ucell->nat;
+        const std::size_t bytes = sizeof(double) * data_xyz_full.size();
+        const std::shared_ptr<const std::vector<double>> data
+            = std::make_shared<const std::vector<double>>(std::move(data_xyz_full));
+        Output_Queue::instance().push(
+            [=]() {
+                write_cube(fn, comment, nat, {0.0, 0.0, 0.0}, nx, ny, nz, dx, dy, dz, atom_type, atom_charge, atom_pos, *data, precision);
+            },
+            bytes);
         end = time(nullptr);
         ModuleBase::GlobalFunc::OUT_TIME("write_vdata_palgrid", start, end);
     }
@@ -4,8 +4,10 @@
 #include "module_hamilt_lcao/module_hcontainer/hcontainer_funcs.h"
 #include "module_hamilt_lcao/module_hcontainer/output_hcontainer.h"
 #include "module_hamilt_pw/hamilt_pwdft/global.h"
+#include "module_io/output_queue.h"
 
 #include <iostream>
+#include <memory>
 
 namespace ModuleIO
 {
@@ -71,20 +73,25 @@ void write_dmr(const std::vector<hamilt::HContainer<double>*> dmr,
         {
             int nbasis = dmr[ispin]->get_nbasis();
             // gather the parallel matrix to serial matrix
+            // kept alive by the output job until the file is written
 #ifdef __MPI
-            Parallel_Orbitals serialV;
-            serialV.init(nbasis, nbasis, nbasis, paraV.comm());
-            serialV.set_serial(nbasis, nbasis);
-            serialV.set_atomic_trace(iat2iwt, *nat, nbasis);
-            hamilt::HContainer<double> dm_serial(&serialV);
-            hamilt::gatherParallels(*dmr[ispin], &dm_serial, 0);
+            auto serialV = std::make_shared<Parallel_Orbitals>();
+            serialV->init(nbasis, nbasis, nbasis, paraV.comm());
+            serialV->set_serial(nbasis, nbasis);
+            serialV->set_atomic_trace(iat2iwt, *nat, nbasis);
+            auto dm_serial = std::make_shared<hamilt::HContainer<double>>(serialV.get());
+            hamilt::gatherParallels(*dmr[ispin], dm_serial.get(), 0);
 #else
-            hamilt::HContainer<double> dm_serial(*dmr[ispin]);
+            auto serialV = std::make_shared<Parallel_Orbitals>();
+            auto dm_serial = std::make_shared<hamilt::HContainer<double>>(*dmr[ispin]);
 #endif
             if (GlobalV::MY_RANK == 0)
             {
                 std::string fname = PARAM.globalv.global_out_dir + dmr_gen_fname(1, ispin, append, istep);
-                write_dmr_csr(fname, &dm_serial, istep);
+                const size_t bytes = sizeof(double) * dm_serial->get_nnr();
+                Output_Queue::instance().push(
+                    [fname, serialV, dm_serial, istep]() mutable { write_dmr_csr(fname, dm_serial.get(), istep); },
+                    bytes);
             }
         }
 
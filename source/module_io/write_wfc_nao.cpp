@@ -8,6 +8,7 @@
 #include "module_base/scalapack_connector.h"
 #include "module_base/global_variable.h"
 #include "binstream.h"
+#include "output_queue.h"
 #include "module_base/global_function.h"
 
 namespace ModuleIO
@@ -48,9 +49,6 @@ std::string wfc_nao_gen_fname(const int out_type,
 
 void wfc_nao_write2file(const std::string &name, const double* ctot, const int nlocal, const int ik, const ModuleBase::matrix& ekb, const ModuleBase::matrix& wg, bool writeBinary)
 {
-    ModuleBase::TITLE("ModuleIO", "write_wfc_nao");
-    ModuleBase::timer::tick("ModuleIO", "write_wfc_nao");
-
     //if (GlobalV::DRANK == 0)
     {
         int nbands = ekb.nc;
@@ -117,16 +115,11 @@ void wfc_nao_write2file(const std::string &name, const double* ctot, const int n
         }
     }
 
-    ModuleBase::timer::tick("ModuleIO", "write_wfc_nao");
     return;
 }
 
 void wfc_nao_write2file_complex(const std::string &name, const std::complex<double>* ctot, const int nlocal,const int &ik, const ModuleBase::Vector3<double> &kvec_c, const ModuleBase::matrix& ekb, const ModuleBase::matrix& wg, bool writeBinary)
 {
-    ModuleBase::TITLE("ModuleIO","write_wfc_nao_complex");
-    ModuleBase::timer::tick("ModuleIO","write_wfc_nao_complex");
-
-    
     //if (GlobalV::DRANK==0)
     {
         int nbands = ekb.nc;
@@ -198,7 +191,6 @@ void wfc_nao_write2file_complex(const std::string &name, const std::complex<doub
         }
     }
 
-    ModuleBase::timer::tick("ModuleIO","write_wfc_nao_complex");
     return;
 }
 
@@ -267,21 +259,31 @@ void write_wfc_nao(const int out_type,
         if (myid == 0)
         {
             std::string fn = PARAM.globalv.global_out_dir + wfc_nao_gen_fname(out_type, gamma_only, PARAM.inp.out_app_flag, ik, istep);
-            if (std::is_same<double, T>::value)
-            {
-                wfc_nao_write2file(fn, reinterpret_cast<double*>(ctot.data()), nlocal, ik, ekb, wg, writeBinary);
-            }
-            else
-            {
-                wfc_nao_write2file_complex(fn,
-                                      reinterpret_cast<std::complex<double>*>(ctot.data()),
-                                      nlocal,
-                                      ik,
-                                      kvec_c[ik],
-                                      ekb,
-                                      wg,
-                                      writeBinary);
-            }
+            const ModuleBase::Vector3<double> kvec = gamma_only ? ModuleBase::Vector3<double>() : kvec_c[ik];
+            // the gathered coefficients are handed to the output queue, a new buffer is used for the next k point
+            const std::shared_ptr<const std::vector<T>> ctot_ik
+                = std::make_shared<const std::vector<T>>(std::move(ctot));
+            ctot.resize(ctot_ik->size());
+            const size_t bytes = sizeof(T) * ctot_ik->size();
+            Output_Queue::instance().push(
+                [=]() {
+                    if (std::is_same<double, T>::value)
+                    {
+                        wfc_nao_write2file(fn, reinterpret_cast<const double*>(ctot_ik->data()), nlocal, ik, ekb, wg, writeBinary);
+                    }
+                    else
+                    {
+                        wfc_nao_write2file_complex(fn,
+                                                   reinterpret_cast<const std::complex<double>*>(ctot_ik->data()),
+                                                   nlocal,
+                                                   ik,
+                                                   kvec,
+                                                   ekb,
+                                                   wg,
+                                                   writeBinary);
+                    }
+                },
+                bytes);
         }
     }
     ModuleBase::timer::tick("ModuleIO", "write_wfc_nao");
@@ -1,6 +1,7 @@
 #include "md_func.h"
 
 #include "module_base/global_variable.h"
+#include "module_base/memory.h"
 #include "module_base/timer.h"
 
 namespace MD_func
@@ -260,10 +261,14 @@ void force_virial(ModuleESolver::ESolver* p_esolver,
     potential = p_esolver->cal_energy();
 
     ModuleBase::matrix force_temp(unit_in.nat, 3);
-    p_esolver->cal_force(unit_in, force_temp);
+    {
+        ModuleBase::Memory::Scope scope("ESolver::cal_force");
+        p_esolver->cal_force(unit_in, force_temp);
+    }
 
     if (cal_stress)
     {
+        ModuleBase::Memory::Scope scope("ESolver::cal_stress");
         p_esolver->cal_stress(unit_in, virial);
     }
 
@@ -0,0 +1,143 @@
+#include "md_respa.h"
+
+#include "md_func.h"
+#include "module_base/timer.h"
+#ifdef __MPI
+#include "mpi.h"
+#endif
+
+MD_RESPA::MD_RESPA(const Parameter& param_in, UnitCell& unit_in, ModuleESolver::ESolver* p_fast_in)
+    : p_fast(p_fast_in), ucell(unit_in)
+{
+    nrespa = param_in.mdp.md_respa;
+    md_dt = param_in.mdp.md_dt / ModuleBase::AU_to_FS;
+    cal_stress = param_in.inp.cal_stress;
+    my_rank = param_in.globalv.myrank;
+
+    assert(nrespa > 0);
+
+    force_fast = new ModuleBase::Vector3<double>[ucell.nat];
+    force_slow = new ModuleBase::Vector3<double>[ucell.nat];
+    virial_fast.create(3, 3);
+    virial_slow.create(3, 3);
+}
+
+
+MD_RESPA::~MD_RESPA()
+{
+    delete[] force_fast;
+    delete[] force_slow;
+}
+
+
+void MD_RESPA::setup(MD_base* mdrun)
+{
+    ModuleBase::TITLE("MD_RESPA", "setup");
+    ModuleBase::timer::tick("MD_RESPA", "setup");
+
+    MD_func::force_virial(p_fast, mdrun->step_, ucell, potential_fast, force_fast, cal_stress, virial_fast);
+
+    for (int i = 0; i < ucell.nat; ++i)
+    {
+        force_slow[i] = mdrun->force[i] - force_fast[i];
+    }
+    potential_slow = mdrun->potential - potential_fast;
+    virial_slow = mdrun->virial - virial_fast;
+    kick_pending = true;
+
+    ModuleBase::timer::tick("MD_RESPA", "setup");
+}
+
+
+void MD_RESPA::begin_step(MD_base* mdrun)
+{
+    if (kick_pending)
+    {
+        kick(mdrun);
+        kick_pending = false;
+    }
+
+    for (int i = 0; i < ucell.nat; ++i)
+    {
+        mdrun->force[i] = force_fast[i];
+    }
+}
+
+
+void MD_RESPA::force_virial(MD_base* mdrun, ModuleESolver::ESolver* p_slow)
+{
+    ModuleBase::TITLE("MD_RESPA", "force_virial");
+    ModuleBase::timer::tick("MD_RESPA", "force_virial");
+
+    MD_func::force_virial(p_fast, mdrun->step_, ucell, potential_fast, force_fast, cal_stress, virial_fast);
+
+    if (is_slow_step(mdrun->step_ + mdrun->step_rst_))
+    {
+        MD_func::force_virial(p_slow,
+                              mdrun->step_,
+                              ucell,
+                              mdrun->potential,
+                              mdrun->force,
+                              cal_stress,
+                              mdrun->virial);
+
+        for (int i = 0; i < ucell.nat; ++i)
+        {
+            force_slow[i] = mdrun->force[i] - force_fast[i];
+        }
+        potential_slow = mdrun->potential - potential_fast;
+        virial_slow = mdrun->virial - virial_fast;
+    }
+
+    for (int i = 0; i < ucell.nat; ++i)
+    {
+        mdrun->force[i] = force_fast[i];
+    }
+
+    ModuleBase::timer::tick("MD_RESPA", "force_virial");
+}
+
+
+void MD_RESPA::end_step(MD_base* mdrun)
+{
+    if (is_slow_step(mdrun->step_ + mdrun->step_rst_))
+    {
+        kick(mdrun);
+        kick_pending = true;
+    }
+
+    this->sum_forces(mdrun);
+}
+
+
+void MD_RESPA::kick(MD_base* mdrun)
+{
+    if (my_rank == 0)
+    {
+        for (int i = 0; i < ucell.nat; ++i)
+        {
+            for (int k = 0; k < 3; ++k)
+            {
+                if (mdrun->ionmbl[i][k])
+                {
+                    mdrun->vel[i][k] += 0.5 * nrespa * md_dt * force_slow[i][k] / mdrun->allmass[i];
+                }
+            }
+        }
+    }
+
+#ifdef __MPI
+    MPI_Bcast(mdrun->vel, ucell.nat * 3, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+#endif
+}
+
+
+void MD_RESPA::sum_forces(MD_base* mdrun)
+{
+    for (int i = 0; i < ucell.nat; ++i)
+    {
+        mdrun->force[i] = force_fast[i] + force_slow[i];
+    }
+    mdrun->potential = potential_fast + potential_slow;
+    mdrun->virial = virial_fast + virial_slow;
+}
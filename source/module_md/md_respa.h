@@ -0,0 +1,94 @@
+#ifndef MD_RESPA_H
+#define MD_RESPA_H
+
+#include "md_base.h"
+
+/**
+ * @brief multiple time step (r-RESPA) splitting of the forces
+ *
+ * The atoms are moved by the integrator in mdrun with the forces of a cheap
+ * model (LJ or DP) in every step of md_dt, while the expensive energy solver
+ * is called every md_respa steps. The difference of the two forces is the
+ * slow force, which is applied as a half kick of md_respa * md_dt / 2 before
+ * and after each group of md_respa steps (Tuckerman et al., JCP 97, 1990).
+ *
+ * The groups end at the steps that are multiples of md_respa, where the
+ * velocities are synchronized and the restart files can be written.
+ * Between two calls of the expensive solver, the energy, force and virial of
+ * mdrun are those of the cheap model plus the last slow part.
+ */
+class MD_RESPA
+{
+  public:
+    /**
+     * @brief constructor
+     * @param param_in input parameters
+     * @param unit_in unitcell shared by the two energy solvers
+     * @param p_fast_in the cheap energy solver, initialized by the caller
+     */
+    MD_RESPA(const Parameter& param_in, UnitCell& unit_in, ModuleESolver::ESolver* p_fast_in);
+    ~MD_RESPA();
+
+    /**
+     * @brief split the forces of the initial configuration after mdrun->setup()
+     * @param mdrun the md integrator, whose force, potential and virial are from the expensive solver
+     */
+    void setup(MD_base* mdrun);
+
+    /**
+     * @brief the half kick of the slow forces at the beginning of a group,
+     * then the fast forces are given to mdrun for first_half()
+     * @param mdrun the md integrator
+     */
+    void begin_step(MD_base* mdrun);
+
+    /**
+     * @brief the forces of the new positions, used instead of MD_func::force_virial()
+     * @param mdrun the md integrator, its force is the fast force for second_half()
+     * @param p_slow the expensive energy solver, called if the step ends a group
+     */
+    void force_virial(MD_base* mdrun, ModuleESolver::ESolver* p_slow);
+
+    /**
+     * @brief the half kick of the slow forces at the end of a group after second_half(),
+     * then the total forces are given to mdrun for the output
+     * @param mdrun the md integrator
+     */
+    void end_step(MD_base* mdrun);
+
+    /**
+     * @brief whether the step ends a group of md_respa steps
+     * @param istep md step counted from the very beginning
+     */
+    bool is_slow_step(const int& istep) const
+    {
+        return istep % nrespa == 0;
+    }
+
+  private:
+    /**
+     * @brief add 1/2 * nrespa * md_dt * force_slow / m to the velocities
+     */
+    void kick(MD_base* mdrun);
+
+    /**
+     * @brief mdrun->force = force_fast + force_slow, and the same for the energy and the virial
+     */
+    void sum_forces(MD_base* mdrun);
+
+    ModuleESolver::ESolver* p_fast;         ///< the cheap energy solver
+    UnitCell& ucell;                        ///< unitcell information
+    int nrespa;                             ///< number of fast steps per slow step
+    double md_dt;                           ///< the fast time step (hbar/E_hartree)
+    bool cal_stress;                        ///< whether calculate stress
+    int my_rank;                            ///< MPI rank of the processor
+    bool kick_pending = false;              ///< the half kick of the next group is not applied yet
+    ModuleBase::Vector3<double>* force_fast; ///< forces of the cheap model
+    ModuleBase::Vector3<double>* force_slow; ///< expensive minus cheap forces of the last slow step
+    double potential_fast = 0.0;            ///< potential energy of the cheap model
+    double potential_slow = 0.0;            ///< expensive minus cheap energy of the last slow step
+    ModuleBase::matrix virial_fast;         ///< virial of the cheap model
+    ModuleBase::matrix virial_slow;         ///< expensive minus cheap virial of the last slow step
+};
+
+#endif // MD_RESPA_H
@@ -6,7 +6,10 @@
 #include "md_func.h"
 #include "module_base/global_file.h"
 #include "module_base/timer.h"
+#include "module_esolver/esolver_dp.h"
+#include "module_esolver/esolver_lj.h"
 #include "module_io/print_info.h"
+#include "md_respa.h"
 #include "msst.h"
 #include "nhchain.h"
 #include "verlet.h"
@@ -46,28 +49,64 @@ void md_line(UnitCell& unit_in, ModuleESolver::ESolver* p_esolver, const Paramet
         ModuleBase::WARNING_QUIT("md_line", "no such md_type!");
     }
 
+    /// the cheap force model of the multiple time step integration
+    ModuleESolver::ESolver* p_fast = nullptr;
+    MD_RESPA* respa = nullptr;
+    if (param_in.mdp.md_respa > 1)
+    {
+        if (param_in.mdp.md_respa_esolver == "lj")
+        {
+            p_fast = new ModuleESolver::ESolver_LJ();
+        }
+        else
+        {
+            p_fast = new ModuleESolver::ESolver_DP(param_in.mdp.pot_file);
+        }
+        p_fast->before_all_runners(unit_in, param_in.inp);
+        respa = new MD_RESPA(param_in, unit_in, p_fast);
+    }
+
     /// md cycle
     while ((mdrun->step_ + mdrun->step_rst_) <= param_in.mdp.md_nstep && !mdrun->stop)
     {
         if (mdrun->step_ == 0)
         {
             mdrun->setup(p_esolver, PARAM.globalv.global_readin_dir);
+            if (respa != nullptr)
+            {
+                respa->setup(mdrun);
+            }
         }
         else
         {
             ModuleIO::print_screen(0, 0, mdrun->step_ + mdrun->step_rst_);
+            if (respa != nullptr)
+            {
+                respa->begin_step(mdrun);
+            }
             mdrun->first_half(GlobalV::ofs_running);
 
             /// update force and virial due to the update of atom positions
-            MD_func::force_virial(p_esolver,
-                                  mdrun->step_,
-                                  unit_in,
-                                  mdrun->potential,
-                                  mdrun->force,
-                                  param_in.inp.cal_stress,
-                                  mdrun->virial);
+            if (respa != nullptr)
+            {
+                respa->force_virial(mdrun, p_esolver);
+            }
+            else
+            {
+                MD_func::force_virial(p_esolver,
+                                      mdrun->step_,
+                                      unit_in,
+                                      mdrun->potential,
+                                      mdrun->force,
+                                      param_in.inp.cal_stress,
+                                      mdrun->virial);
+            }
 
             mdrun->second_half();
+            if (respa != nullptr)
+            {
+                respa->end_step(mdrun);
+            }
 
             MD_func::compute_stress(unit_in,
                                     mdrun->vel,
@@ -122,6 +161,8 @@ void md_line(UnitCell& unit_in, ModuleESolver::ESolver* p_esolver, const Paramet
         mdrun->step_++;
     }
 
+    delete respa;
+    delete p_fast;
     delete mdrun;
     ModuleBase::timer::tick("Run_MD", "md_line");
     return;
@@ -0,0 +1,199 @@
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#define private public
+#include "module_parameter/parameter.h"
+#undef private
+#define private public
+#define protected public
+#include "module_esolver/esolver_lj.h"
+#include "module_md/md_func.h"
+#include "module_md/md_respa.h"
+#include "module_md/verlet.h"
+#include "setcell.h"
+#define doublethreshold 1e-12
+
+
+/************************************************
+ *  unit test of functions in md_respa.h
+ ***********************************************/
+
+/**
+ * - Tested Function
+ *   - MD_RESPA::setup
+ *     - split the forces of the initial configuration into the fast and the slow parts
+ *
+ *   - MD_RESPA::begin_step
+ *     - the half kick of the slow forces, then the fast forces for first_half
+ *
+ *   - MD_RESPA::force_virial
+ *     - the fast forces in every step, and the slow forces every md_respa steps
+ *
+ *   - MD_RESPA::end_step
+ *     - the half kick of the slow forces at the end of a group, then the total forces
+ *
+ *   - MD_RESPA::is_slow_step
+ *     - whether the step ends a group of md_respa steps
+ */
+
+class RESPA_test : public testing::Test
+{
+  protected:
+    MD_base* mdrun;
+    MD_RESPA* respa;
+    UnitCell ucell;
+    Parameter param_in;
+    ModuleESolver::ESolver* p_esolver;
+    ModuleESolver::ESolver* p_fast;
+
+    void SetUp()
+    {
+        Setcell::setupcell(ucell);
+        Setcell::parameters(param_in.input);
+        param_in.input.mdp.md_type = "nve";
+        param_in.input.mdp.md_respa = 2;
+
+        p_esolver = new ModuleESolver::ESolver_LJ();
+        p_esolver->before_all_runners(ucell, param_in.inp);
+        p_fast = new ModuleESolver::ESolver_LJ();
+        p_fast->before_all_runners(ucell, param_in.inp);
+
+        mdrun = new Verlet(param_in, ucell);
+        mdrun->setup(p_esolver, PARAM.sys.global_readin_dir);
+        respa = new MD_RESPA(param_in, ucell, p_fast);
+        respa->setup(mdrun);
+    }
+
+    void TearDown()
+    {
+        delete respa;
+        delete mdrun;
+        delete p_fast;
+        delete p_esolver;
+    }
+
+    void respa_step()
+    {
+        respa->begin_step(mdrun);
+        mdrun->first_half(GlobalV::ofs_running);
+        respa->force_virial(mdrun, p_esolver);
+        mdrun->second_half();
+        respa->end_step(mdrun);
+        mdrun->step_++;
+    }
+};
+
+TEST_F(RESPA_test, setup)
+{
+    EXPECT_EQ(respa->nrespa, 2);
+    EXPECT_TRUE(respa->kick_pending);
+    EXPECT_NEAR(respa->potential_slow, 0.0, doublethreshold);
+    for (int i = 0; i < ucell.nat; ++i)
+    {
+        EXPECT_NEAR(respa->force_slow[i].norm(), 0.0, doublethreshold);
+        EXPECT_NEAR((respa->force_fast[i] - mdrun->force[i]).norm(), 0.0, doublethreshold);
+    }
+    for (int i = 0; i < 3; ++i)
+    {
+        for (int j = 0; j < 3; ++j)
+        {
+            EXPECT_NEAR(respa->virial_slow(i, j), 0.0, doublethreshold);
+        }
+    }
+}
+
+TEST_F(RESPA_test, is_slow_step)
+{
+    EXPECT_TRUE(respa->is_slow_step(0));
+    EXPECT_FALSE(respa->is_slow_step(1));
+    EXPECT_TRUE(respa->is_slow_step(2));
+    EXPECT_FALSE(respa->is_slow_step(3));
+}
+
+TEST_F(RESPA_test, begin_step)
+{
+    ModuleBase::Vector3<double>* vel0 = new ModuleBase::Vector3<double>[ucell.nat];
+    for (int i = 0; i < ucell.nat; ++i)
+    {
+        vel0[i] = mdrun->vel[i];
+        respa->force_slow[i].set(1e-3 * (i + 1), -2e-3, 3e-3 * i);
+    }
+
+    mdrun->step_ = 1;
+    respa->begin_step(mdrun);
+
+    EXPECT_FALSE(respa->kick_pending);
+    const double dt = param_in.mdp.md_dt / ModuleBase::AU_to_FS;
+    for (int i = 0; i < ucell.nat; ++i)
+    {
+        for (int k = 0; k < 3; ++k)
+        {
+            EXPECT_NEAR(mdrun->vel[i][k] - vel0[i][k], dt * respa->force_slow[i][k] / mdrun->allmass[i], doublethreshold);
+            EXPECT_NEAR(mdrun->force[i][k], respa->force_fast[i][k], doublethreshold);
+        }
+    }
+
+    // the kick is applied once per group
+    respa->begin_step(mdrun);
+    for (int i = 0; i < ucell.nat; ++i)
+    {
+        for (int k = 0; k < 3; ++k)
+        {
+            EXPECT_NEAR(mdrun->vel[i][k] - vel0[i][k], dt * respa->force_slow[i][k] / mdrun->allmass[i], doublethreshold);
+        }
+    }
+    delete[] vel0;
+}
+
+TEST_F(RESPA_test, end_step)
+{
+    mdrun->step_ = 1;
+    respa_step();
+    EXPECT_FALSE(respa->kick_pending);
+
+    respa_step();
+    EXPECT_TRUE(respa->kick_pending);
+    for (int i = 0; i < ucell.nat; ++i)
+    {
+        EXPECT_NEAR((respa->force_fast[i] + respa->force_slow[i] - mdrun->force[i]).norm(), 0.0, doublethreshold);
+    }
+    EXPECT_NEAR(mdrun->potential, respa->potential_fast + respa->potential_slow, doublethreshold);
+}
+
+TEST_F(RESPA_test, same_model)
+{
+    // with the same force model for both parts, the slow forces vanish and RESPA is velocity Verlet
+    UnitCell ucell_ref;
+    Setcell::setupcell(ucell_ref);
+    ModuleESolver::ESolver* p_ref = new ModuleESolver::ESolver_LJ();
+    p_ref->before_all_runners(ucell_ref, param_in.inp);
+    MD_base* verlet = new Verlet(param_in, ucell_ref);
+    verlet->setup(p_ref, PARAM.sys.global_readin_dir);
+
+    mdrun->step_ = 1;
+    for (int istep = 1; istep <= 4; ++istep)
+    {
+        verlet->step_ = istep;
+        verlet->first_half(GlobalV::ofs_running);
+        MD_func::force_virial(p_ref,
+                              verlet->step_,
+                              ucell_ref,
+                              verlet->potential,
+                              verlet->force,
+                              param_in.inp.cal_stress,
+                              verlet->virial);
+        verlet->second_half();
+
+        respa_step();
+    }
+
+    for (int i = 0; i < ucell.nat; ++i)
+    {
+        EXPECT_NEAR((mdrun->pos[i] - verlet->pos[i]).norm(), 0.0, doublethreshold);
+        EXPECT_NEAR((mdrun->vel[i] - verlet->vel[i]).norm(), 0.0, doublethreshold);
+        EXPECT_NEAR((mdrun->force[i] - verlet->force[i]).norm(), 0.0, doublethreshold);
+    }
+    EXPECT_NEAR(mdrun->potential, verlet->potential, doublethreshold);
+
+    delete verlet;
+    delete p_ref;
+}
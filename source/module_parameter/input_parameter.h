@@ -44,21 +44,25 @@ struct Input_para
     double erf_height = 0;              ///< the height of the energy step for reciprocal vectors
     double erf_sigma = 0.1;             ///< the width of the energy step for reciprocal vectors
     int fft_mode = 0;                   ///< fftw mode 0: estimate, 1: measure, 2: patient, 3: exhaustive
+    bool pw_table_fft = false;          ///< build the PW interpolation tables by FFT-based spherical Bessel transforms
     std::string init_wfc = "atomic";    ///< "file","atomic","random"
     bool psi_initializer = false;       ///< whether use psi_initializer to initialize wavefunctions
     int pw_seed = 0;                    ///< random seed for initializing wave functions
     std::string init_chg = "atomic";    ///< "file","atomic"
     bool dm_to_rho = false;             ///< read density matrix from npz format and calculate charge density
     std::string chg_extrap = "default"; ///< xiaohui modify 2015-02-01
+    std::string wfc_extrap = "none";    ///< "none", "first-order", "aspc": extrapolation of psi between ionic steps
     bool init_vel = false;              ///< read velocity from STRU or not  liuyu 2021-07-14
     
     std::string input_file = "INPUT";   ///< input file name
     std::string stru_file = "STRU";     ///< file contains atomic positions --
                                         ///< xiaohui modify 2015-02-01
+    std::string stru_batch = "none";    ///< list file or directory of the STRU files run one by one in a process
     std::string kpoint_file = "KPT";    ///< file contains k-points -- xiaohui modify 2015-02-01
     std::string pseudo_dir = "";        ///< directory of pseudopotential
     std::string orbital_dir = "";       ///< directory of orbital file
     std::string read_file_dir = "auto"; ///< directory of files for reading
+    std::string table_cache_dir = "none"; ///< directory of the interpolation tables kept between runs
     bool restart_load = false;
     std::string wannier_card = "none";              ///< input card for wannier functions.
     int mem_saver = 0;                              ///< 1: save psi when nscf calculation.
@@ -69,6 +73,7 @@ struct Input_para
 
     std::string device = "auto";
     std::string precision = "double";
+    double precision_switch_thr = 1.0e-4; ///< drho below which precision = mixed switches to double precision
 
     // ==============   #Parameters (2.Electronic structure) ===========================
     std::string ks_solver = "default"; ///< xiaohui add 2013-09-01
@@ -88,6 +93,7 @@ struct Input_para
     double pw_diag_thr = 0.01; ///< used in cg method
     bool diago_smooth_ethr = false; ///< smooth ethr for iter methods
     int pw_diag_ndim = 4;      ///< dimension of workspace for Davidson diagonalization
+    int pw_diag_cheb_degree = 10; ///< degree of the Chebyshev filter for chfsi diagonalization
     int diago_cg_prec = 1;     ///< mohan add 2012-03-31
 
     std::string smearing_method = "gauss"; ///< "gauss",
@@ -136,6 +142,7 @@ struct Input_para
     double search_radius = -1.0;               ///< 11.1
     bool search_pbc = true;                    ///< 11.2
     int bx = 0, by = 0, bz = 0;                ///< big mesh ball. 0: auto set bx/by/bz
+    bool gint_balance = false;                 ///< distribute the big cells of grid integration by their cost
     int elpa_num_thread = -1;                  ///< Number of threads need to use in elpa
     int nstream = 4;                           ///< Number of streams in CUDA as per input data
     std::string bessel_nao_ecut = "default";   ///< energy cutoff for spherical bessel functions(Ry)
@@ -168,6 +175,7 @@ struct Input_para
     double relax_bfgs_rmax = 0.2;    ///< trust radius max
     double relax_bfgs_rmin = 1e-05;  ///< trust radius min
     double relax_bfgs_init = 0.5;    ///< initial move
+    std::string relax_precon = "exp"; ///< model Hessian of lbfgs_precon: exp, lindh
     std::string fixed_axes = "None"; ///< which axes are fixed
     bool fixed_ibrav = false;        ///< whether to keep type of lattice; must be used
                                      ///< along with latname
@@ -349,6 +357,8 @@ struct Input_para
     bool out_app_flag = true; ///< whether output r(R), H(R), S(R), T(R), and dH(R) matrices
                               ///< in an append manner during MD liuyu 2023-03-20
     int out_ndigits = 8;      ///< Assuming 8 digits precision is needed for matrices output
+    int out_async = 0;        ///< MB of gathered outputs queued for the I/O thread, 0: synchronous output
+    bool out_mem_track = false; ///< track the CPU blocks of each stage and print their peaks
     bool out_mat_t = false;
     bool out_element_info = false;        ///< output information of all elements
     bool out_mat_r = false;               ///< jingan add 2019-8-14, output r(R) matrix.
@@ -534,6 +544,8 @@ struct Input_para
     double sccut = 3.0;             ///< restriction of step size in eV/uB
     double sc_scf_thr = 1e-3;       ///< minimum number of outer scf loop before initial lambda loop
     double sc_drop_thr = 1e-3;      ///< threshold for lambda-loop threshold cutoff in spin-constrained DFT
+    double sc_subspace_thr = 0.0;   ///< residual threshold (Ry) of the lambda steps in the band subspace, 0: off
+                                    ///< for LCAO, 0: full diagonalization in every lambda step
 
     // ==============   #Parameters (18.Quasiatomic Orbital analysis) =========
     ///<==========================================================
@@ -571,6 +583,15 @@ struct Input_para
     double pexsi_elec_thr = 0.001;
     double pexsi_zero_thr = 1e-10;
 
+    // ==============   #Parameters (FOE) ====================
+    int foe_order = 0;     ///< number of Chebyshev polynomials of the FOE, 0: estimated from the spectrum and smearing
+    double foe_thr = 1e-7; ///< blocks of the FOE sparse matrices with a smaller Frobenius norm are dropped
+
+    // ==============   #Parameters (Atom grids) ====================
+    bool atom_grid = false;  ///< integrate the XC of gamma-only LCAO molecules on atom-centered grids
+    int atom_grid_nrad = 75; ///< number of radial points of each atom grid
+    int atom_grid_lmax = 29; ///< order of the Delley angular grid of each atom grid
+
     // ==============   #Parameters (20.Test) ====================
     bool out_alllog = false;         ///< output all logs.
     int nurse = 0;                   ///< used for debug.
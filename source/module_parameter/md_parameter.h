@@ -61,6 +61,9 @@ struct MD_para
     double md_tolerance = 100.0; ///< tolerance for velocity rescaling (K)
     int md_nraise = 1;           ///< parameters used when md_type=nvt
 
+    int md_respa = 1;                      ///< number of steps with the cheap forces per Kohn-Sham force, 1 for off
+    std::string md_respa_esolver = "dp";   ///< the cheap force model of the multiple time step MD: lj, dp
+
     bool dump_force = true;  ///< output atomic forces into the file MD_dump or
                              ///< not. liuyu 2023-03-01
     bool dump_vel = true;    ///< output atomic velocities into the file MD_dump or
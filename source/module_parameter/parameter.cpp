@@ -24,3 +24,16 @@ void Parameter::set_sys_nlocal(const int& nlocal)
 {
     sys.nlocal = nlocal;
 }
+
+void Parameter::set_batch_stru(const Input_para& input_in,
+                               const System_para& sys_in,
+                               const std::string& stru,
+                               const std::string& name)
+{
+    input = input_in;
+    sys = sys_in;
+    sys.global_in_stru = stru;
+    sys.global_out_dir = sys_in.global_out_dir + name + "/";
+    sys.global_stru_dir = sys.global_out_dir + "STRU/";
+    sys.global_matrix_dir = sys.global_out_dir + "matrix/";
+}
@@ -37,6 +37,12 @@ class Parameter
     void set_input_nbands(const int& nbands);
     // set sys.nlocal
     void set_sys_nlocal(const int& nlocal);
+    // restore the parameters read from INPUT and set the structure of the batch mode,
+    // the output of the structure is written to the directory "name" in global_out_dir
+    void set_batch_stru(const Input_para& input_in,
+                        const System_para& sys_in,
+                        const std::string& stru,
+                        const std::string& name);
 
   private:
     // Only ReadInput and CalAtomInfo can modify the value of Parameter.
@@ -0,0 +1,265 @@
+#include "psi_extrap.h"
+
+#include "module_base/parallel_reduce.h"
+#include "module_base/timer.h"
+#include "module_base/tool_quit.h"
+#include "module_base/tool_title.h"
+#include "module_hsolver/kernels/math_kernel_op.h"
+
+#include <algorithm>
+
+namespace psi
+{
+
+namespace
+{
+// ASPC coefficients B_m of Kolafa for K = 0, 1, 2, see Kuhne et al., PRL 98, 066401 (2007)
+const std::vector<std::vector<double>> aspc_coef = {{2.0, -1.0}, {2.5, -2.0, 0.5}, {2.8, -2.8, 1.2, -0.2}};
+} // namespace
+
+template <typename T, typename Device>
+PsiExtrap<T, Device>::PsiExtrap(const std::string& method_in)
+{
+    if (method_in == "first-order")
+    {
+        this->nhist_max = 2;
+    }
+    else if (method_in == "aspc")
+    {
+        this->nhist_max = 4;
+        this->use_corrector = true;
+    }
+    else
+    {
+        ModuleBase::WARNING_QUIT("PsiExtrap", "unknown wavefunction extrapolation method " + method_in);
+    }
+}
+
+template <typename T, typename Device>
+PsiExtrap<T, Device>::~PsiExtrap()
+{
+    delmem_complex_op()(this->ctx, this->overlap);
+    delmem_complex_op()(this->ctx, this->pred);
+}
+
+template <typename T, typename Device>
+void PsiExtrap<T, Device>::clear()
+{
+    this->hist.clear();
+    this->predicted.reset();
+}
+
+template <typename T, typename Device>
+void PsiExtrap<T, Device>::save(const Psi<T, Device>& psi_in)
+{
+    ModuleBase::timer::tick("PsiExtrap", "save");
+
+    // a prediction not corrected in the SCF of this step is dropped
+    this->predicted.reset();
+
+    // the stored steps are useless once the shape of psi changes
+    if (!this->hist.empty()
+        && (this->hist[0]->get_nk() != psi_in.get_nk() || this->hist[0]->get_nbands() != psi_in.get_nbands()
+            || this->hist[0]->get_nbasis() != psi_in.get_nbasis()))
+    {
+        this->clear();
+    }
+
+    if (static_cast<int>(this->hist.size()) < this->nhist_max)
+    {
+        this->hist.insert(this->hist.begin(), std::unique_ptr<Psi<T, Device>>(new Psi<T, Device>(psi_in)));
+    }
+    else
+    {
+        // recycle the oldest step
+        std::unique_ptr<Psi<T, Device>> oldest = std::move(this->hist.back());
+        this->hist.pop_back();
+        syncmem_complex_op()(this->ctx,
+                             this->ctx,
+                             oldest->get_pointer() - oldest->get_psi_bias(),
+                             psi_in.get_pointer() - psi_in.get_psi_bias(),
+                             psi_in.size());
+        this->hist.insert(this->hist.begin(), std::move(oldest));
+    }
+
+    ModuleBase::timer::tick("PsiExtrap", "save");
+}
+
+template <typename T, typename Device>
+bool PsiExtrap<T, Device>::extrapolate(Psi<T, Device>& psi_inout)
+{
+    const int nhist = static_cast<int>(this->hist.size());
+    if (nhist < 2 || this->hist[0]->get_nk() != psi_inout.get_nk()
+        || this->hist[0]->get_nbands() != psi_inout.get_nbands()
+        || this->hist[0]->get_nbasis() != psi_inout.get_nbasis())
+    {
+        return false;
+    }
+    ModuleBase::TITLE("PsiExtrap", "extrapolate");
+    ModuleBase::timer::tick("PsiExtrap", "extrapolate");
+
+    const std::vector<double>& coef = aspc_coef[nhist - 2];
+    const int nbands = psi_inout.get_nbands();
+    const int ld = psi_inout.get_nbasis();
+    const T one = static_cast<T>(1.0);
+    const T zero = static_cast<T>(0.0);
+
+    resmem_complex_op()(this->ctx, this->overlap, nbands * nbands);
+    resmem_complex_op()(this->ctx, this->pred, nbands * ld);
+
+    const int current_k = psi_inout.get_current_k();
+    for (int ik = 0; ik < psi_inout.get_nk(); ++ik)
+    {
+        psi_inout.fix_k(ik);
+        for (int ih = 0; ih < nhist; ++ih)
+        {
+            this->hist[ih]->fix_k(ik);
+        }
+        const int dim = psi_inout.get_current_nbas();
+        const T* latest = this->hist[0]->get_pointer();
+
+        setmem_complex_op()(this->ctx, this->pred, 0, nbands * ld);
+        for (int ih = 0; ih < nhist; ++ih)
+        {
+            const T* previous = this->hist[ih]->get_pointer();
+
+            // overlap = C^\dagger(t-m) C(t-dt)
+            hsolver::gemm_op<T, Device>()(this->ctx,
+                                          'C',
+                                          'N',
+                                          nbands,
+                                          nbands,
+                                          dim,
+                                          &one,
+                                          previous,
+                                          ld,
+                                          latest,
+                                          ld,
+                                          &zero,
+                                          this->overlap,
+                                          nbands);
+            Parallel_Reduce::reduce_pool(this->overlap, nbands * nbands);
+
+            // pred += B_m C(t-m) overlap
+            const T alpha = static_cast<T>(coef[ih]);
+            hsolver::gemm_op<T, Device>()(this->ctx,
+                                          'N',
+                                          'N',
+                                          dim,
+                                          nbands,
+                                          nbands,
+                                          &alpha,
+                                          previous,
+                                          ld,
+                                          this->overlap,
+                                          nbands,
+                                          &one,
+                                          this->pred,
+                                          ld);
+        }
+        syncmem_complex_op()(this->ctx, this->ctx, psi_inout.get_pointer(), this->pred, nbands * ld);
+    }
+    psi_inout.fix_k(std::max(current_k, 0));
+
+    // the prediction of order K = nhist - 2 is kept for the corrector
+    if (this->use_corrector)
+    {
+        if (this->predicted == nullptr)
+        {
+            this->predicted.reset(new Psi<T, Device>(psi_inout));
+        }
+        else
+        {
+            syncmem_complex_op()(this->ctx,
+                                 this->ctx,
+                                 this->predicted->get_pointer() - this->predicted->get_psi_bias(),
+                                 psi_inout.get_pointer() - psi_inout.get_psi_bias(),
+                                 psi_inout.size());
+        }
+        this->omega = static_cast<double>(nhist) / (2.0 * nhist - 1.0);
+    }
+
+    ModuleBase::timer::tick("PsiExtrap", "extrapolate");
+    return true;
+}
+
+template <typename T, typename Device>
+bool PsiExtrap<T, Device>::correct(Psi<T, Device>& psi_inout)
+{
+    if (this->predicted == nullptr || this->predicted->get_nk() != psi_inout.get_nk()
+        || this->predicted->get_nbands() != psi_inout.get_nbands()
+        || this->predicted->get_nbasis() != psi_inout.get_nbasis())
+    {
+        this->predicted.reset();
+        return false;
+    }
+    ModuleBase::TITLE("PsiExtrap", "correct");
+    ModuleBase::timer::tick("PsiExtrap", "correct");
+
+    const int nbands = psi_inout.get_nbands();
+    const int ld = psi_inout.get_nbasis();
+    const T one = static_cast<T>(1.0);
+    const T zero = static_cast<T>(0.0);
+    const T alpha = static_cast<T>(this->omega);
+    const T beta = static_cast<T>(1.0 - this->omega);
+
+    resmem_complex_op()(this->ctx, this->overlap, nbands * nbands);
+    resmem_complex_op()(this->ctx, this->pred, nbands * ld);
+
+    const int current_k = psi_inout.get_current_k();
+    for (int ik = 0; ik < psi_inout.get_nk(); ++ik)
+    {
+        psi_inout.fix_k(ik);
+        this->predicted->fix_k(ik);
+        const int dim = psi_inout.get_current_nbas();
+
+        // overlap = C^\dagger C^p
+        hsolver::gemm_op<T, Device>()(this->ctx,
+                                      'C',
+                                      'N',
+                                      nbands,
+                                      nbands,
+                                      dim,
+                                      &one,
+                                      psi_inout.get_pointer(),
+                                      ld,
+                                      this->predicted->get_pointer(),
+                                      ld,
+                                      &zero,
+                                      this->overlap,
+                                      nbands);
+        Parallel_Reduce::reduce_pool(this->overlap, nbands * nbands);
+
+        // pred = \omega C overlap + (1 - \omega) C^p
+        syncmem_complex_op()(this->ctx, this->ctx, this->pred, this->predicted->get_pointer(), nbands * ld);
+        hsolver::gemm_op<T, Device>()(this->ctx,
+                                      'N',
+                                      'N',
+                                      dim,
+                                      nbands,
+                                      nbands,
+                                      &alpha,
+                                      psi_inout.get_pointer(),
+                                      ld,
+                                      this->overlap,
+                                      nbands,
+                                      &beta,
+                                      this->pred,
+                                      ld);
+        syncmem_complex_op()(this->ctx, this->ctx, psi_inout.get_pointer(), this->pred, nbands * ld);
+    }
+    psi_inout.fix_k(std::max(current_k, 0));
+    this->predicted.reset();
+
+    ModuleBase::timer::tick("PsiExtrap", "correct");
+    return true;
+}
+
+template class PsiExtrap<std::complex<float>, base_device::DEVICE_CPU>;
+template class PsiExtrap<std::complex<double>, base_device::DEVICE_CPU>;
+#if ((defined __CUDA) || (defined __ROCM))
+template class PsiExtrap<std::complex<float>, base_device::DEVICE_GPU>;
+template class PsiExtrap<std::complex<double>, base_device::DEVICE_GPU>;
+#endif
+
+} // namespace psi
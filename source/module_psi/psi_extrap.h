@@ -0,0 +1,102 @@
+#ifndef PSI_EXTRAP_H
+#define PSI_EXTRAP_H
+
+#include "module_base/module_device/device.h"
+#include "module_base/module_device/memory_op.h"
+#include "module_psi/psi.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace psi
+{
+
+/**
+ * @brief wavefunction extrapolation between ionic steps
+ *
+ * The converged wavefunctions of the last few ionic steps are kept, and the starting guess
+ * of the next step is predicted with the always stable predictor (ASPC) of Kolafa,
+ * in the form of Kuhne et al., PRL 98, 066401 (2007):
+ *    \[ C^p(t) = \sum_{m=1}^{K+2} B_m\ C(t-m)\ C^\dagger(t-m)\ C(t-dt). \]
+ * Each previous set of bands is projected onto the latest one, so the prediction does not depend on
+ * the arbitrary unitary rotation (phases, degenerate subspaces) of the bands of each step.
+ *
+ * method = "first-order" : K = 0, B = (2, -1)
+ * method = "aspc"        : K = 2, B = (2.8, -2.8, 1.2, -0.2), with lower orders in the first steps
+ *
+ * The predicted bands are not orthonormal; the iterative eigensolvers orthogonalize
+ * or rotate their starting subspace.
+ *
+ * With "aspc" the bands C of the first SCF iteration started from C^p are corrected as
+ *    \[ C \leftarrow \omega\ C C^\dagger C^p + (1-\omega)\ C^p, \quad \omega = (K+2)/(2K+3), \]
+ * the corrector of Kolafa in the same projector form, before the SCF goes on. The SCF is still run to
+ * convergence, so the corrector only improves the starting subspace of the second iteration.
+ *
+ * Only the plane-wave psi is extrapolated. The LCAO SCF starts from the extrapolated charge; the
+ * DM(R) of the previous steps would first need remapping between the neighbour lists of the steps.
+ */
+template <typename T, typename Device = base_device::DEVICE_CPU>
+class PsiExtrap
+{
+  public:
+    PsiExtrap(const std::string& method_in);
+    ~PsiExtrap();
+
+    /// store a copy of the converged psi of the current ionic step
+    void save(const Psi<T, Device>& psi_in);
+
+    /**
+     * @brief overwrite psi with the prediction for the next ionic step
+     *
+     * @return false if there are fewer than two stored steps, psi is untouched then
+     */
+    bool extrapolate(Psi<T, Device>& psi_inout);
+
+    /**
+     * @brief apply the ASPC corrector to the bands of the first SCF iteration after extrapolate()
+     *
+     * @return false if there is no prediction to correct, psi is untouched then;
+     *         the prediction is used once, later calls return false until the next extrapolate()
+     */
+    bool correct(Psi<T, Device>& psi_inout);
+
+    /// drop the stored steps, e.g. when the plane-wave basis changes with the cell
+    void clear();
+
+    /// number of stored steps
+    int get_nhist() const
+    {
+        return static_cast<int>(this->hist.size());
+    }
+
+  private:
+    /// maximal number of stored steps
+    int nhist_max = 2;
+
+    /// whether extrapolate() keeps the prediction for correct()
+    bool use_corrector = false;
+    /// the prediction of the current ionic step, nullptr once corrected
+    std::unique_ptr<Psi<T, Device>> predicted;
+    /// weight of the corrector
+    double omega = 0.0;
+
+    /// stored wavefunctions, the latest first
+    std::vector<std::unique_ptr<Psi<T, Device>>> hist;
+
+    /// overlap between a previous and the latest set of bands
+    T* overlap = nullptr;
+    /// the predicted wavefunction of one k point
+    T* pred = nullptr;
+
+    Device* ctx = {};
+
+    using setmem_complex_op = base_device::memory::set_memory_op<T, Device>;
+    using resmem_complex_op = base_device::memory::resize_memory_op<T, Device>;
+    using delmem_complex_op = base_device::memory::delete_memory_op<T, Device>;
+    using syncmem_complex_op = base_device::memory::synchronize_memory_op<T, Device, Device>;
+};
+
+} // namespace psi
+
+#endif
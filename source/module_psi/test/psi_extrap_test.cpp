@@ -0,0 +1,322 @@
+#include "module_psi/psi_extrap.h"
+#include "module_base/parallel_comm.h"
+
+#include <gtest/gtest.h>
+#include <complex>
+#include <random>
+#ifdef __MPI
+#include <mpi.h>
+#endif
+
+/************************************************
+ *  unit test of class PsiExtrap
+ ***********************************************/
+
+/**
+ * - Tested Functions:
+ *   - PsiExtrap::save / extrapolate
+ *     - no prediction with fewer than two stored steps
+ *     - a stationary trajectory is reproduced by first-order and ASPC extrapolation
+ *     - the prediction does not depend on the phases of the bands of older steps
+ *     - the prediction from three steps agrees with a direct evaluation of the ASPC formula
+ *   - PsiExtrap::correct
+ *     - only ASPC corrects, once per prediction, and a prediction left at save() is dropped
+ *     - the corrected bands agree with a direct evaluation of the corrector, independent of the phases
+ *       of the bands of the first SCF iteration
+ *   - PsiExtrap::clear
+ */
+
+class PsiExtrapTest : public ::testing::Test
+{
+  protected:
+    const int nk = 2;
+    const int nbands = 3;
+    const int nbasis = 12;
+    std::vector<int> ngk = {12, 10};
+
+    // orthonormal bands with the Gram-Schmidt process, for every k point
+    void orthonormal_psi(psi::Psi<std::complex<double>>& psi, const int seed)
+    {
+        std::mt19937 gen(seed);
+        std::uniform_real_distribution<double> dis(-1.0, 1.0);
+        for (int ik = 0; ik < nk; ++ik)
+        {
+            psi.fix_k(ik);
+            const int npw = ngk[ik];
+            for (int ib = 0; ib < nbands; ++ib)
+            {
+                std::complex<double>* v = &psi(ib, 0);
+                for (int ig = 0; ig < nbasis; ++ig)
+                {
+                    v[ig] = (ig < npw) ? std::complex<double>(dis(gen), dis(gen)) : 0.0;
+                }
+                for (int jb = 0; jb < ib; ++jb)
+                {
+                    const std::complex<double>* u = &psi(jb, 0);
+                    std::complex<double> proj = 0.0;
+                    for (int ig = 0; ig < npw; ++ig)
+                    {
+                        proj += std::conj(u[ig]) * v[ig];
+                    }
+                    for (int ig = 0; ig < npw; ++ig)
+                    {
+                        v[ig] -= proj * u[ig];
+                    }
+                }
+                double norm = 0.0;
+                for (int ig = 0; ig < npw; ++ig)
+                {
+                    norm += std::norm(v[ig]);
+                }
+                for (int ig = 0; ig < npw; ++ig)
+                {
+                    v[ig] /= std::sqrt(norm);
+                }
+            }
+        }
+        psi.fix_k(0);
+    }
+
+    double max_diff(psi::Psi<std::complex<double>>& a, psi::Psi<std::complex<double>>& b)
+    {
+        double diff = 0.0;
+        for (int ik = 0; ik < nk; ++ik)
+        {
+            a.fix_k(ik);
+            b.fix_k(ik);
+            for (int ib = 0; ib < nbands; ++ib)
+            {
+                for (int ig = 0; ig < ngk[ik]; ++ig)
+                {
+                    diff = std::max(diff, std::abs(a(ib, ig) - b(ib, ig)));
+                }
+            }
+        }
+        return diff;
+    }
+};
+
+TEST_F(PsiExtrapTest, NotEnoughSteps)
+{
+    psi::PsiExtrap<std::complex<double>> extrap("first-order");
+    psi::Psi<std::complex<double>> psi(nk, nbands, nbasis, ngk.data());
+    orthonormal_psi(psi, 1);
+    psi::Psi<std::complex<double>> ref(psi);
+
+    EXPECT_FALSE(extrap.extrapolate(psi));
+    extrap.save(psi);
+    EXPECT_EQ(extrap.get_nhist(), 1);
+    EXPECT_FALSE(extrap.extrapolate(psi));
+    EXPECT_EQ(max_diff(psi, ref), 0.0);
+
+    extrap.save(psi);
+    EXPECT_TRUE(extrap.extrapolate(psi));
+    extrap.clear();
+    EXPECT_EQ(extrap.get_nhist(), 0);
+    EXPECT_FALSE(extrap.extrapolate(psi));
+}
+
+TEST_F(PsiExtrapTest, StationaryTrajectory)
+{
+    for (const std::string method: {"first-order", "aspc"})
+    {
+        psi::PsiExtrap<std::complex<double>> extrap(method);
+        psi::Psi<std::complex<double>> psi(nk, nbands, nbasis, ngk.data());
+        orthonormal_psi(psi, 2);
+        psi::Psi<std::complex<double>> ref(psi);
+
+        // more steps than kept, so that the oldest buffer is recycled
+        for (int istep = 0; istep < 6; ++istep)
+        {
+            extrap.save(ref);
+        }
+        EXPECT_EQ(extrap.get_nhist(), method == "aspc" ? 4 : 2);
+        EXPECT_TRUE(extrap.extrapolate(psi));
+        EXPECT_LT(max_diff(psi, ref), 1e-12);
+    }
+}
+
+TEST_F(PsiExtrapTest, PhaseInvariance)
+{
+    psi::PsiExtrap<std::complex<double>> extrap("first-order");
+    psi::Psi<std::complex<double>> psi(nk, nbands, nbasis, ngk.data());
+    orthonormal_psi(psi, 3);
+    psi::Psi<std::complex<double>> ref(psi);
+
+    // the same bands with arbitrary phases in the older step
+    psi::Psi<std::complex<double>> rotated(psi);
+    for (int ik = 0; ik < nk; ++ik)
+    {
+        rotated.fix_k(ik);
+        for (int ib = 0; ib < nbands; ++ib)
+        {
+            const std::complex<double> phase = std::polar(1.0, 0.7 * (ib + 1) + 0.3 * ik);
+            for (int ig = 0; ig < nbasis; ++ig)
+            {
+                rotated(ib, ig) *= phase;
+            }
+        }
+    }
+
+    extrap.save(rotated);
+    extrap.save(ref);
+    EXPECT_TRUE(extrap.extrapolate(psi));
+    EXPECT_LT(max_diff(psi, ref), 1e-12);
+}
+
+TEST_F(PsiExtrapTest, ThreeSteps)
+{
+    // with three stored steps ASPC uses B = (2.5, -2, 0.5)
+    psi::PsiExtrap<std::complex<double>> extrap("aspc");
+    std::vector<psi::Psi<std::complex<double>>> steps(3, psi::Psi<std::complex<double>>(nk, nbands, nbasis, ngk.data()));
+    for (int istep = 0; istep < 3; ++istep)
+    {
+        orthonormal_psi(steps[istep], 10 + istep);
+        extrap.save(steps[istep]);
+    }
+
+    // reference: \sum_m B_m C(t-m) C^\dagger(t-m) C(t-dt), with C(t-dt) = steps[2]
+    const std::vector<double> coef = {2.5, -2.0, 0.5};
+    psi::Psi<std::complex<double>> ref(nk, nbands, nbasis, ngk.data());
+    for (int ik = 0; ik < nk; ++ik)
+    {
+        ref.fix_k(ik);
+        for (int ib = 0; ib < nbands; ++ib)
+        {
+            for (int ig = 0; ig < nbasis; ++ig)
+            {
+                ref(ib, ig) = 0.0;
+            }
+        }
+        steps[2].fix_k(ik);
+        for (int m = 0; m < 3; ++m)
+        {
+            psi::Psi<std::complex<double>>& cm = steps[2 - m];
+            cm.fix_k(ik);
+            for (int ib = 0; ib < nbands; ++ib)
+            {
+                for (int jb = 0; jb < nbands; ++jb)
+                {
+                    std::complex<double> s = 0.0;
+                    for (int ig = 0; ig < ngk[ik]; ++ig)
+                    {
+                        s += std::conj(cm(jb, ig)) * steps[2](ib, ig);
+                    }
+                    for (int ig = 0; ig < ngk[ik]; ++ig)
+                    {
+                        ref(ib, ig) += coef[m] * cm(jb, ig) * s;
+                    }
+                }
+            }
+        }
+    }
+
+    psi::Psi<std::complex<double>> psi(steps[2]);
+    EXPECT_TRUE(extrap.extrapolate(psi));
+    EXPECT_LT(max_diff(psi, ref), 1e-12);
+}
+
+TEST_F(PsiExtrapTest, CorrectOnce)
+{
+    psi::Psi<std::complex<double>> psi(nk, nbands, nbasis, ngk.data());
+    orthonormal_psi(psi, 4);
+    psi::Psi<std::complex<double>> ref(psi);
+
+    psi::PsiExtrap<std::complex<double>> first("first-order");
+    first.save(ref);
+    first.save(ref);
+    EXPECT_TRUE(first.extrapolate(psi));
+    EXPECT_FALSE(first.correct(psi));
+
+    psi::PsiExtrap<std::complex<double>> aspc("aspc");
+    EXPECT_FALSE(aspc.correct(psi));
+    aspc.save(ref);
+    aspc.save(ref);
+    EXPECT_TRUE(aspc.extrapolate(psi));
+    // the SCF already gives the predicted bands
+    EXPECT_TRUE(aspc.correct(psi));
+    EXPECT_LT(max_diff(psi, ref), 1e-12);
+    EXPECT_FALSE(aspc.correct(psi));
+
+    // the prediction of a step whose first iteration was not corrected
+    EXPECT_TRUE(aspc.extrapolate(psi));
+    aspc.save(ref);
+    EXPECT_FALSE(aspc.correct(psi));
+}
+
+TEST_F(PsiExtrapTest, Corrector)
+{
+    // three stored steps, K = 1 and omega = 3/5
+    psi::PsiExtrap<std::complex<double>> extrap("aspc");
+    for (int istep = 0; istep < 3; ++istep)
+    {
+        psi::Psi<std::complex<double>> step(nk, nbands, nbasis, ngk.data());
+        orthonormal_psi(step, 20 + istep);
+        extrap.save(step);
+    }
+    psi::Psi<std::complex<double>> pred(nk, nbands, nbasis, ngk.data());
+    EXPECT_TRUE(extrap.extrapolate(pred));
+
+    // the bands of the first SCF iteration, with arbitrary phases
+    psi::Psi<std::complex<double>> scf(nk, nbands, nbasis, ngk.data());
+    orthonormal_psi(scf, 30);
+    psi::Psi<std::complex<double>> rotated(scf);
+    for (int ik = 0; ik < nk; ++ik)
+    {
+        rotated.fix_k(ik);
+        for (int ib = 0; ib < nbands; ++ib)
+        {
+            const std::complex<double> phase = std::polar(1.0, 1.1 * (ib + 1) - 0.4 * ik);
+            for (int ig = 0; ig < nbasis; ++ig)
+            {
+                rotated(ib, ig) *= phase;
+            }
+        }
+    }
+
+    // reference: omega C C^\dagger C^p + (1 - omega) C^p
+    const double omega = 0.6;
+    psi::Psi<std::complex<double>> ref(nk, nbands, nbasis, ngk.data());
+    for (int ik = 0; ik < nk; ++ik)
+    {
+        ref.fix_k(ik);
+        scf.fix_k(ik);
+        pred.fix_k(ik);
+        for (int ib = 0; ib < nbands; ++ib)
+        {
+            for (int ig = 0; ig < nbasis; ++ig)
+            {
+                ref(ib, ig) = (1.0 - omega) * pred(ib, ig);
+            }
+            for (int jb = 0; jb < nbands; ++jb)
+            {
+                std::complex<double> s = 0.0;
+                for (int ig = 0; ig < ngk[ik]; ++ig)
+                {
+                    s += std::conj(scf(jb, ig)) * pred(ib, ig);
+                }
+                for (int ig = 0; ig < ngk[ik]; ++ig)
+                {
+                    ref(ib, ig) += omega * scf(jb, ig) * s;
+                }
+            }
+        }
+    }
+
+    EXPECT_TRUE(extrap.correct(rotated));
+    EXPECT_LT(max_diff(rotated, ref), 1e-12);
+}
+
+int main(int argc, char** argv)
+{
+#ifdef __MPI
+    MPI_Init(&argc, &argv);
+    MPI_Comm_split(MPI_COMM_WORLD, 0, 1, &POOL_WORLD);
+#endif
+    testing::InitGoogleTest(&argc, argv);
+    int result = RUN_ALL_TESTS();
+#ifdef __MPI
+    MPI_Finalize();
+#endif
+    return result;
+}
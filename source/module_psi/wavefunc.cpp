@@ -447,7 +447,7 @@ void diago_PAO_in_pw_k2(const base_device::DEVICE_GPU* ctx,
             // GlobalC::hm.diagH_subspace(ik ,starting_nw, nbands, wfcatom, wfcatom, etatom.data());
         }
     }
-    else if (PARAM.inp.ks_solver == "dav" || PARAM.inp.ks_solver == "dav_subspace")
+    else if (PARAM.inp.ks_solver == "dav" || PARAM.inp.ks_solver == "dav_subspace" || PARAM.inp.ks_solver == "chfsi")
     {
         assert(nbands <= wfcatom.nr);
         // replace by haozhihan 2022-11-23
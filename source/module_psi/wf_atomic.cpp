@@ -4,9 +4,12 @@
 #include "module_base/math_polyint.h"
 #include "module_base/math_sphbes.h"
 #include "module_base/math_ylmreal.h"
+#include "module_base/spherical_bessel_transformer.h"
+#include "module_base/table_cache.h"
 #include "module_base/timer.h"
 #include "module_base/tool_quit.h"
 #include "module_hamilt_pw/hamilt_pwdft/global.h"
+#include "module_hamilt_pw/hamilt_pwdft/radial_proj.h"
 #include "module_hamilt_pw/hamilt_pwdft/soc.h"
 #include "module_parameter/parameter.h"
 
@@ -76,6 +79,7 @@ void WF_atomic::init_at_1(const UnitCell& ucell,
     const double pref = ModuleBase::FOUR_PI / sqrt(ucell.omega);
     double* aux = new double[ndm];
     double* vchi = new double[ndm];
+    ModuleBase::SphericalBesselTransformer sbt(true);
 
     ModuleBase::GlobalFunc::OUT(GlobalV::ofs_running, "dq(describe PAO in reciprocal space)", PARAM.globalv.dq);
     ModuleBase::GlobalFunc::OUT(GlobalV::ofs_running, "max q", PARAM.globalv.nqx);
@@ -189,36 +193,71 @@ void WF_atomic::init_at_1(const UnitCell& ucell,
                 }
             }
 
-            if (atom->ncpp.oc[ic] >= 0.0)
+            // the integrals do not depend on the cell, so they are kept on disk without pref
+            double* tab_ic = &tab_at->operator()(it, ic, 0);
+            ModuleBase::Table_Cache cache(PARAM.inp.pw_table_fft ? "wfc_tab_fft" : "wfc_tab");
+            const bool use_cache = (PARAM.inp.table_cache_dir != "none");
+            if (use_cache)
             {
-                const int l = atom->ncpp.lchi[ic];
-                for (int iq = startq; iq < PARAM.globalv.nqx; iq++)
+                cache.add(PARAM.globalv.nqx);
+                cache.add(PARAM.globalv.dq);
+                cache.add(atom->ncpp.lchi[ic]);
+                cache.add(atom->ncpp.msh);
+                cache.add(atom->ncpp.r.data(), atom->ncpp.msh);
+                cache.add(atom->ncpp.rab.data(), atom->ncpp.msh);
+                // chi is normalized above
+                cache.add(&atom->ncpp.chi(ic, 0), atom->ncpp.msh);
+            }
+
+            if (!use_cache || !cache.load(PARAM.inp.table_cache_dir, tab_ic, PARAM.globalv.nqx))
+            {
+                if (PARAM.inp.pw_table_fft && atom->ncpp.msh > 1)
+                {
+                    // int chi(r) * j_l(qr) * r dr
+                    RadialProjection::_sbt_tab_fft(sbt,
+                                                   atom->ncpp.lchi[ic],
+                                                   atom->ncpp.msh,
+                                                   atom->ncpp.r.data(),
+                                                   &atom->ncpp.chi(ic, 0),
+                                                   1,
+                                                   PARAM.globalv.nqx,
+                                                   PARAM.globalv.dq,
+                                                   tab_ic);
+                }
+                else
                 {
-                    const double q = PARAM.globalv.dq * iq;
-                    ModuleBase::Sphbes::Spherical_Bessel(atom->ncpp.msh, atom->ncpp.r.data(), q, l, aux);
-                    for (int ir = 0; ir < atom->ncpp.msh; ir++)
+                    const int l = atom->ncpp.lchi[ic];
+                    for (int iq = startq; iq < PARAM.globalv.nqx; iq++)
                     {
-                        vchi[ir] = atom->ncpp.chi(ic, ir) * aux[ir] * atom->ncpp.r[ir];
-                    }
+                        const double q = PARAM.globalv.dq * iq;
+                        ModuleBase::Sphbes::Spherical_Bessel(atom->ncpp.msh, atom->ncpp.r.data(), q, l, aux);
+                        for (int ir = 0; ir < atom->ncpp.msh; ir++)
+                        {
+                            vchi[ir] = atom->ncpp.chi(ic, ir) * aux[ir] * atom->ncpp.r[ir];
+                        }
+
+                        double vqint = 0.0;
+                        ModuleBase::Integral::Simpson_Integral(atom->ncpp.msh, vchi, atom->ncpp.rab.data(), vqint);
+
+                        tab_ic[iq] = vqint;
+                    } // enddo
+                }
+
+                if (use_cache && GlobalV::MY_RANK == 0)
+                {
+                    cache.save(PARAM.inp.table_cache_dir, tab_ic, PARAM.globalv.nqx);
+                }
+            }
+            else
+            {
+                GlobalV::ofs_running << " Read the table of atomic wave function # " << ic + 1 << " from "
+                                     << cache.file_name(PARAM.inp.table_cache_dir) << std::endl;
+            }
 
-                    double vqint = 0.0;
-                    ModuleBase::Integral::Simpson_Integral(atom->ncpp.msh, vchi, atom->ncpp.rab.data(), vqint);
-
-                    tab_at->operator()(it, ic, iq) = vqint * pref;
-                    //				if( it == 0 && ic == 0 )
-                    //				{
-                    //
-                    //					for (ir = 0;ir < ucell.atoms[it].msh;ir++)
-                    //						GlobalV::ofs_running << std::setprecision(20) << "\n vchi(" << ir << ")=" <<
-                    // vchi[ir]; 					GlobalV::ofs_running<<"\n aux[0] = "<<aux[0];
-                    // GlobalV::ofs_running<<"\n msh
-                    // =
-                    // "<<
-                    // ucell.atoms[it].msh; 					GlobalV::ofs_running<<"\n tab_at :
-                    // "<<ppcell.tab_at(it, ic, iq) ; 					GlobalV::ofs_running<<"\n pref = "<<pref;
-                    //				}
-                } // enddo
-            }     // endif
+            for (int iq = startq; iq < PARAM.globalv.nqx; iq++)
+            {
+                tab_ic[iq] *= pref;
+            }
         }         // enddo
     }             // enddo
 
@@ -1,6 +1,7 @@
 #include "relax_driver.h"
 
 #include "module_base/global_file.h"
+#include "module_base/memory.h"
 #include "module_hamilt_pw/hamilt_pwdft/global.h" // use chr.
 #include "module_io/cif_io.h"
 #include "module_io/json_output/output_info.h"
@@ -20,6 +21,10 @@ void Relax_Driver::relax_driver(ModuleESolver::ESolver* p_esolver, UnitCell& uce
         {
             rl_old.init_relax(ucell.nat);
         }
+        else if (PARAM.inp.relax_method == "lbfgs_precon")
+        {
+            rl_lbfgs.init_relax(ucell.nat);
+        }
         else
         {
             rl.init_relax(ucell.nat);
@@ -66,17 +71,23 @@ void Relax_Driver::relax_driver(ModuleESolver::ESolver* p_esolver, UnitCell& uce
         // calculate and gather all parts of total ionic forces
         if (PARAM.inp.cal_force)
         {
+            ModuleBase::Memory::Scope scope("ESolver::cal_force");
             p_esolver->cal_force(ucell, force);
         }
         // calculate and gather all parts of stress
         if (PARAM.inp.cal_stress)
         {
+            ModuleBase::Memory::Scope scope("ESolver::cal_stress");
             p_esolver->cal_stress(ucell, stress);
         }
 
         if (PARAM.inp.calculation == "relax" || PARAM.inp.calculation == "cell-relax")
         {
-            if (PARAM.inp.relax_new)
+            if (PARAM.inp.relax_new && PARAM.inp.relax_method == "lbfgs_precon")
+            {
+                stop = rl_lbfgs.relax_step(ucell, force, stress, this->etot);
+            }
+            else if (PARAM.inp.relax_new)
             {
                 stop = rl.relax_step(ucell, force, stress, this->etot);
             }
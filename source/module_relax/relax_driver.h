@@ -5,6 +5,7 @@
 #include "module_esolver/esolver.h"
 #include "module_esolver/esolver_ks.h"
 #include "relax_new/relax.h"
+#include "relax_new/relax_lbfgs.h"
 #include "relax_old/relax_old.h"
 #include "relax_old/bfgs.h"
 class Relax_Driver
@@ -25,6 +26,9 @@ class Relax_Driver
     // new relaxation method
     Relax rl;
 
+    // preconditioned L-BFGS, relax_method = lbfgs_precon
+    Relax_LBFGS rl_lbfgs;
+
     // old relaxation method
     Relax_old rl_old;
 
@@ -0,0 +1,248 @@
+#include "precon.h"
+
+#include "module_base/element_name.h"
+#include "module_base/tool_quit.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <map>
+
+namespace
+{
+// parameters of the Lindh model in Bohr, for the rows H-He, Li-Ne and the rest
+const double lindh_alpha[3][3] = {{1.0000, 0.3949, 0.3949}, {0.3949, 0.2800, 0.2800}, {0.3949, 0.2800, 0.2800}};
+const double lindh_rref[3][3] = {{1.35, 2.10, 2.53}, {2.10, 2.87, 3.40}, {2.53, 3.40, 3.40}};
+// 0.45 Hartree/Bohr^2
+const double lindh_kr = 0.9;
+// the pairs whose force constant is smaller than kr / lindh_ratio are left out
+const double lindh_ratio = 1000.0;
+} // namespace
+
+void Precon::init(const std::string& type_in, const std::vector<std::string>& elements)
+{
+    if (type_in != "exp" && type_in != "lindh")
+    {
+        ModuleBase::WARNING_QUIT("Precon::init", "the model Hessian should be exp or lindh");
+    }
+    this->type = type_in;
+    this->nat = elements.size();
+    this->row.assign(this->nat, 2);
+    for (int iat = 0; iat < this->nat; ++iat)
+    {
+        const auto it = std::find(ModuleBase::element_name.begin(), ModuleBase::element_name.end(), elements[iat]);
+        const int z = std::distance(ModuleBase::element_name.begin(), it) + 1;
+        if (z <= 2)
+        {
+            this->row[iat] = 0;
+        }
+        else if (z <= 10)
+        {
+            this->row[iat] = 1;
+        }
+    }
+    this->row_ptr.assign(this->nat + 1, 0);
+    this->col.clear();
+    this->val.clear();
+}
+
+double Precon::get_rcut(const double r_nn) const
+{
+    if (this->type == "exp")
+    {
+        return this->r_cut_factor * r_nn;
+    }
+    double rcut = 0.0;
+    const int rmax = this->row.empty() ? 0 : *std::max_element(this->row.begin(), this->row.end());
+    const int rmin = this->row.empty() ? 0 : *std::min_element(this->row.begin(), this->row.end());
+    for (int ri = rmin; ri <= rmax; ++ri)
+    {
+        for (int rj = rmin; rj <= rmax; ++rj)
+        {
+            const double r2 = lindh_rref[ri][rj] * lindh_rref[ri][rj] + std::log(lindh_ratio) / lindh_alpha[ri][rj];
+            rcut = std::max(rcut, std::sqrt(r2));
+        }
+    }
+    return rcut;
+}
+
+double Precon::lindh_k(const int ri, const int rj, const double r) const
+{
+    return lindh_kr * std::exp(lindh_alpha[ri][rj] * (lindh_rref[ri][rj] * lindh_rref[ri][rj] - r * r));
+}
+
+void Precon::build(const std::vector<Pair>& pairs, const double r_nn)
+{
+    const double rcut = this->get_rcut(r_nn);
+    const double stab = this->c_stab * (this->type == "exp" ? this->mu : lindh_kr);
+
+    std::vector<std::map<int, std::array<double, 9>>> blocks(this->nat);
+    for (int iat = 0; iat < this->nat; ++iat)
+    {
+        std::array<double, 9>& d = blocks[iat][iat];
+        d.fill(0.0);
+        d[0] = d[4] = d[8] = stab;
+    }
+    for (const Pair& p: pairs)
+    {
+        const double r = p.dr.norm();
+        if (r >= rcut || r < 1.0e-8)
+        {
+            continue;
+        }
+        std::array<double, 9> h;
+        h.fill(0.0);
+        if (this->type == "exp")
+        {
+            const double c = this->mu * std::exp(-this->A * (r / r_nn - 1.0));
+            h[0] = h[4] = h[8] = c;
+        }
+        else
+        {
+            const double k = this->lindh_k(this->row[p.iat], this->row[p.jat], r);
+            const double u[3] = {p.dr.x / r, p.dr.y / r, p.dr.z / r};
+            for (int a = 0; a < 3; ++a)
+            {
+                for (int b = 0; b < 3; ++b)
+                {
+                    h[a * 3 + b] = k * u[a] * u[b];
+                }
+            }
+        }
+        // the other side of the pair adds the transposed blocks of the row jat
+        std::array<double, 9>& hii = blocks[p.iat][p.iat];
+        auto ij = blocks[p.iat].find(p.jat);
+        if (ij == blocks[p.iat].end())
+        {
+            ij = blocks[p.iat].emplace(p.jat, std::array<double, 9>()).first;
+            ij->second.fill(0.0);
+        }
+        for (int k = 0; k < 9; ++k)
+        {
+            hii[k] += h[k];
+            ij->second[k] -= h[k];
+        }
+    }
+
+    this->row_ptr.assign(this->nat + 1, 0);
+    this->col.clear();
+    this->val.clear();
+    for (int iat = 0; iat < this->nat; ++iat)
+    {
+        for (const auto& b: blocks[iat])
+        {
+            this->col.push_back(b.first);
+            this->val.insert(this->val.end(), b.second.begin(), b.second.end());
+        }
+        this->row_ptr[iat + 1] = this->col.size();
+    }
+}
+
+void Precon::apply(const double* x, double* y) const
+{
+    for (int iat = 0; iat < this->nat; ++iat)
+    {
+        double sum[3] = {0.0, 0.0, 0.0};
+        for (int ib = this->row_ptr[iat]; ib < this->row_ptr[iat + 1]; ++ib)
+        {
+            const double* h = &this->val[9 * ib];
+            const double* xj = &x[3 * this->col[ib]];
+            for (int a = 0; a < 3; ++a)
+            {
+                sum[a] += h[3 * a] * xj[0] + h[3 * a + 1] * xj[1] + h[3 * a + 2] * xj[2];
+            }
+        }
+        for (int a = 0; a < 3; ++a)
+        {
+            y[3 * iat + a] = sum[a];
+        }
+    }
+}
+
+void Precon::solve(const double* b, double* x) const
+{
+    const int n = 3 * this->nat;
+    // the diagonal of P is the Jacobi preconditioner of the conjugate gradients
+    std::vector<double> diag(n, 1.0);
+    for (int iat = 0; iat < this->nat; ++iat)
+    {
+        for (int ib = this->row_ptr[iat]; ib < this->row_ptr[iat + 1]; ++ib)
+        {
+            if (this->col[ib] == iat)
+            {
+                for (int a = 0; a < 3; ++a)
+                {
+                    diag[3 * iat + a] = this->val[9 * ib + 4 * a];
+                }
+            }
+        }
+    }
+
+    std::vector<double> r(b, b + n);
+    std::vector<double> z(n);
+    std::vector<double> p(n);
+    std::vector<double> ap(n);
+    double b2 = 0.0;
+    for (int i = 0; i < n; ++i)
+    {
+        x[i] = 0.0;
+        z[i] = r[i] / diag[i];
+        p[i] = z[i];
+        b2 += b[i] * b[i];
+    }
+    double rz = 0.0;
+    for (int i = 0; i < n; ++i)
+    {
+        rz += r[i] * z[i];
+    }
+    const double thr2 = 1.0e-24 * b2;
+    for (int iter = 0; iter < 10 * n && b2 > 0.0; ++iter)
+    {
+        this->apply(p.data(), ap.data());
+        double pap = 0.0;
+        for (int i = 0; i < n; ++i)
+        {
+            pap += p[i] * ap[i];
+        }
+        const double alpha = rz / pap;
+        double r2 = 0.0;
+        for (int i = 0; i < n; ++i)
+        {
+            x[i] += alpha * p[i];
+            r[i] -= alpha * ap[i];
+            r2 += r[i] * r[i];
+        }
+        if (r2 < thr2)
+        {
+            break;
+        }
+        double rz_new = 0.0;
+        for (int i = 0; i < n; ++i)
+        {
+            z[i] = r[i] / diag[i];
+            rz_new += r[i] * z[i];
+        }
+        const double beta = rz_new / rz;
+        rz = rz_new;
+        for (int i = 0; i < n; ++i)
+        {
+            p[i] = z[i] + beta * p[i];
+        }
+    }
+}
+
+double Precon::get_mean_diag() const
+{
+    double sum = 0.0;
+    for (int iat = 0; iat < this->nat; ++iat)
+    {
+        for (int ib = this->row_ptr[iat]; ib < this->row_ptr[iat + 1]; ++ib)
+        {
+            if (this->col[ib] == iat)
+            {
+                sum += this->val[9 * ib] + this->val[9 * ib + 4] + this->val[9 * ib + 8];
+            }
+        }
+    }
+    return this->nat > 0 ? sum / (3 * this->nat) : 1.0;
+}
@@ -0,0 +1,86 @@
+#ifndef PRECON_H
+#define PRECON_H
+
+#include "module_base/vector3.h"
+
+#include <string>
+#include <vector>
+
+//----------------------------------------------------------
+//! Sparse model Hessian of the atomic positions, used as the
+//! preconditioner of Relax_LBFGS.
+//!   exp   : P_ij = -mu exp(-A (r_ij / r_nn - 1)) I_3 for
+//!           r_ij < 2 r_nn (Packwood et al., JCP 144, 164109)
+//!   lindh : P_ij = -k_ij u_ij u_ij^T with the bond stretching
+//!           force constants of Lindh et al., CPL 241, 423
+//! The diagonal blocks are minus the sum of the off-diagonal
+//! ones, plus c_stab * mu I_3 (c_stab * k_r for lindh) to
+//! remove the zero modes of translation and rotation.
+//! Everything is in Ry and Bohr.
+//----------------------------------------------------------
+class Precon
+{
+  public:
+    Precon() {};
+    ~Precon() {};
+
+    //! two atoms within the cutoff, dr = tau_j - tau_i in Bohr
+    //! every pair is given from both sides, as the neighbor list of Grid_Driver gives it
+    struct Pair
+    {
+        int iat;
+        int jat;
+        ModuleBase::Vector3<double> dr;
+    };
+
+    /**
+     * @brief set the type of the model Hessian
+     * @param type_in "exp" or "lindh"
+     * @param elements element symbol of each atom, used by the Lindh force constants
+     */
+    void init(const std::string& type_in, const std::vector<std::string>& elements);
+
+    //! radius within which the pairs have to be given, r_nn is the nearest neighbor distance
+    double get_rcut(const double r_nn) const;
+
+    //! assemble the sparse blocks from the pairs, the pairs beyond get_rcut(r_nn) are skipped
+    void build(const std::vector<Pair>& pairs, const double r_nn);
+
+    //! y = P x, both of size 3 * nat
+    void apply(const double* x, double* y) const;
+
+    //! solve P x = b by conjugate gradients, both of size 3 * nat
+    void solve(const double* b, double* x) const;
+
+    //! the mean of the diagonal of P, which sets the scale of the cell degrees of freedom
+    double get_mean_diag() const;
+
+    //! number of nonzero 3x3 blocks
+    int get_nblocks() const
+    {
+        return this->col.size();
+    }
+
+    // parameters of the exponential preconditioner
+    double mu = 0.05;
+    double A = 3.0;
+    double r_cut_factor = 2.0;
+    double c_stab = 0.1;
+
+  private:
+    std::string type = "exp";
+    int nat = 0;
+
+    // row of the periodic table of each atom, 0, 1 or 2 (for all the elements after Ne)
+    std::vector<int> row;
+
+    // 3x3 blocks of P in the compressed sparse row format, val has 9 numbers per block
+    std::vector<int> row_ptr;
+    std::vector<int> col;
+    std::vector<double> val;
+
+    // force constant of the Lindh model between atoms of rows ri and rj at distance r
+    double lindh_k(const int ri, const int rj, const double r) const;
+};
+
+#endif
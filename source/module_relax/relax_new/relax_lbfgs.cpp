@@ -0,0 +1,511 @@
+#include "relax_lbfgs.h"
+
+#include "module_base/parallel_common.h"
+#include "module_base/timer.h"
+#include "module_base/tool_title.h"
+#include "module_cell/module_neighbor/sltk_atom_arrange.h"
+#include "module_cell/update_cell.h"
+#include "module_hamilt_pw/hamilt_pwdft/global.h"
+#include "module_parameter/parameter.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+double dot(const std::vector<double>& a, const std::vector<double>& b)
+{
+    double sum = 0.0;
+    for (int i = 0; i < a.size(); ++i)
+    {
+        sum += a[i] * b[i];
+    }
+    return sum;
+}
+} // namespace
+
+void Relax_LBFGS::init_relax(const int nat_in)
+{
+    ModuleBase::TITLE("Relax_LBFGS", "init_relax");
+
+    nat = nat_in;
+    istep = 0;
+    ls_step = 0;
+    ls_last = false;
+
+    if_cell_moves = (PARAM.inp.calculation == "cell-relax");
+    dim = 3 * nat + (if_cell_moves ? 9 : 0);
+    // as the UnitCellFilter of ASE, so that the cell variables are as stiff as the atomic ones
+    cell_factor = nat;
+
+    mask.assign(dim, 1.0);
+    x.assign(dim, 0.0);
+    grad.assign(dim, 0.0);
+    x0.assign(dim, 0.0);
+    grad0.assign(dim, 0.0);
+    dr.assign(dim, 0.0);
+    s_list.clear();
+    y_list.clear();
+}
+
+bool Relax_LBFGS::relax_step(UnitCell& ucell,
+                             const ModuleBase::matrix& force,
+                             const ModuleBase::matrix& stress,
+                             const double etot_in)
+{
+    ModuleBase::TITLE("Relax_LBFGS", "relax_step");
+    ModuleBase::timer::tick("Relax_LBFGS", "relax_step");
+
+    etot = etot_in;
+    if (istep == 0)
+    {
+        etot0 = etot;
+        latvec0 = ucell.latvec;
+        deform.Identity();
+        lat_max = std::max(std::max(ucell.a1.norm(), ucell.a2.norm()), ucell.a3.norm()) * ucell.lat0;
+        std::vector<std::string> elements(nat);
+        for (int iat = 0; iat < nat; ++iat)
+        {
+            const int it = ucell.iat2it[iat];
+            const int ia = ucell.iat2ia[iat];
+            elements[iat] = ucell.atoms[it].ncpp.psd;
+            for (int i = 0; i < 3; ++i)
+            {
+                x[3 * iat + i] = ucell.atoms[it].tau[ia][i] * ucell.lat0;
+                mask[3 * iat + i] = ucell.atoms[it].mbl[ia][i] ? 1.0 : 0.0;
+            }
+        }
+        precon.init(PARAM.inp.relax_precon, elements);
+    }
+
+    if (this->setup_gradient(ucell, force, stress))
+    {
+        ModuleBase::timer::tick("Relax_LBFGS", "relax_step");
+        return true;
+    }
+
+    if (ls_step > 0)
+    {
+        // check the point of the line search
+        const double slope = dot(grad, dr);
+        const bool wolfe = etot <= etot0 + PARAM.inp.relax_bfgs_w1 * alpha * slope0
+                           && std::abs(slope) <= PARAM.inp.relax_bfgs_w2 * std::abs(slope0);
+        if (!wolfe && !ls_last)
+        {
+            double xnew = alpha;
+            ls_last = this->ls.line_search(false, alpha, etot, slope, xnew, PARAM.inp.force_thr) || ls_step >= max_ls;
+            alpha = (xnew > 0.0) ? std::min(xnew, alpha_max) : 0.5 * alpha;
+            ++ls_step;
+            GlobalV::ofs_running << " Line search step " << ls_step << ", alpha = " << alpha << std::endl;
+            this->move_cell_ions(ucell);
+            ++istep;
+            ModuleBase::timer::tick("Relax_LBFGS", "relax_step");
+            return false;
+        }
+
+        // the point is accepted, keep the curvature pair if it is positive
+        std::vector<double> s(dim);
+        std::vector<double> y(dim);
+        for (int i = 0; i < dim; ++i)
+        {
+            s[i] = x[i] - x0[i];
+            y[i] = grad[i] - grad0[i];
+        }
+        if (dot(s, y) > 1.0e-12)
+        {
+            s_list.push_back(s);
+            y_list.push_back(y);
+            if (s_list.size() > memory)
+            {
+                s_list.pop_front();
+                y_list.pop_front();
+            }
+        }
+    }
+
+    x0 = x;
+    grad0 = grad;
+    etot0 = etot;
+
+    this->build_precon(ucell);
+    this->new_direction();
+
+    // the trial step of Line_Search is alpha = 1
+    double xnew = 1.0;
+    this->ls.line_search(true, 0.0, etot, slope0, xnew, PARAM.inp.force_thr);
+    alpha = std::min(xnew, alpha_max);
+    ls_step = 1;
+    ls_last = false;
+
+    this->move_cell_ions(ucell);
+    ++istep;
+
+    ModuleBase::timer::tick("Relax_LBFGS", "relax_step");
+    return false;
+}
+
+bool Relax_LBFGS::setup_gradient(const UnitCell& ucell,
+                                 const ModuleBase::matrix& force,
+                                 const ModuleBase::matrix& stress)
+{
+    ModuleBase::TITLE("Relax_LBFGS", "setup_gradient");
+
+    bool force_converged = true;
+    grad.assign(dim, 0.0);
+
+    //=========================================
+    // dE/dx = -f F^T for the atoms
+    //=========================================
+    const ModuleBase::Matrix3 deform_t = deform.Transpose();
+    double max_grad = 0.0;
+    for (int iat = 0; iat < nat; ++iat)
+    {
+        const int it = ucell.iat2it[iat];
+        const int ia = ucell.iat2ia[iat];
+        const ModuleBase::Vector3<int>& mbl = ucell.atoms[it].mbl[ia];
+        const ModuleBase::Vector3<double> f(force(iat, 0), force(iat, 1), force(iat, 2));
+        const ModuleBase::Vector3<double> g = f * deform_t;
+        for (int i = 0; i < 3; ++i)
+        {
+            if (mbl[i])
+            {
+                grad[3 * iat + i] = -g[i];
+                max_grad = std::max(max_grad, std::abs(f[i]));
+            }
+        }
+    }
+    max_grad *= ModuleBase::Ry_to_eV / ModuleBase::BOHR_TO_A; // convert to eV/A
+    if (max_grad > PARAM.inp.force_thr_ev)
+    {
+        force_converged = false;
+    }
+    if (PARAM.inp.out_level == "ie")
+    {
+        std::cout << " ETOT DIFF (eV)       : " << (etot - etot0) * ModuleBase::Ry_to_eV << std::endl;
+        std::cout << " LARGEST GRAD (eV/A)  : " << max_grad << std::endl;
+    }
+    GlobalV::ofs_running << "\n Largest gradient in force is " << max_grad << " eV/A." << std::endl;
+    GlobalV::ofs_running << " Threshold is " << PARAM.inp.force_thr_ev << " eV/A." << std::endl;
+
+    //=========================================
+    // dE/dF = -omega F^{-T} sigma for the cell
+    //=========================================
+    if (if_cell_moves)
+    {
+        ModuleBase::Matrix3 sigma(stress(0, 0),
+                                  stress(0, 1),
+                                  stress(0, 2),
+                                  stress(1, 0),
+                                  stress(1, 1),
+                                  stress(1, 2),
+                                  stress(2, 0),
+                                  stress(2, 1),
+                                  stress(2, 2));
+        const double pressure = (sigma.e11 + sigma.e22 + sigma.e33) / 3.0;
+        if (PARAM.inp.fixed_axes == "shape")
+        {
+            sigma.Zero();
+            sigma.e11 = sigma.e22 = sigma.e33 = pressure;
+        }
+        else if (PARAM.inp.fixed_axes == "volume")
+        {
+            sigma.e11 -= pressure;
+            sigma.e22 -= pressure;
+            sigma.e33 -= pressure;
+        }
+
+        double largest_grad = std::max(sigma.to_matrix().max(), -sigma.to_matrix().min());
+        largest_grad *= ModuleBase::RYDBERG_SI / pow(ModuleBase::BOHR_RADIUS_SI, 3) * 1.0e-8; // convert to kbar
+        if (largest_grad > PARAM.inp.stress_thr)
+        {
+            force_converged = false;
+        }
+        GlobalV::ofs_running << "\n Largest gradient in stress is " << largest_grad << " kbar." << std::endl;
+        GlobalV::ofs_running << " Threshold is " << PARAM.inp.stress_thr << " kbar." << std::endl;
+
+        const ModuleBase::matrix g_cell
+            = (deform.Inverse().Transpose() * sigma * (-ucell.omega / cell_factor)).to_matrix();
+        for (int i = 0; i < 9; ++i)
+        {
+            grad[3 * nat + i] = g_cell.c[i];
+        }
+    }
+
+    if (force_converged)
+    {
+        GlobalV::ofs_running << "\n Relaxation is converged!" << std::endl;
+    }
+    else
+    {
+        GlobalV::ofs_running << "\n Relaxation is not converged yet!" << std::endl;
+    }
+    return force_converged;
+}
+
+void Relax_LBFGS::build_precon(const UnitCell& ucell)
+{
+    ModuleBase::TITLE("Relax_LBFGS", "build_precon");
+    ModuleBase::timer::tick("Relax_LBFGS", "build_precon");
+
+    std::vector<Precon::Pair> pairs;
+    // all the pairs within radius from the neighbor list, return the nearest neighbor distance
+    auto collect_pairs = [&ucell, &pairs](const double radius) -> double {
+        Grid_Driver grid_d(PARAM.inp.test_deconstructor, PARAM.inp.test_grid);
+        atom_arrange::search(PARAM.inp.search_pbc,
+                             GlobalV::ofs_running,
+                             grid_d,
+                             ucell,
+                             radius,
+                             PARAM.inp.test_atom_input);
+        pairs.clear();
+        double r_nn = 0.0;
+        for (int it = 0; it < ucell.ntype; ++it)
+        {
+            for (int ia = 0; ia < ucell.atoms[it].na; ++ia)
+            {
+                const int iat = ucell.itia2iat(it, ia);
+                AdjacentAtomInfo adjs;
+                grid_d.Find_atom(ucell, it, ia, &adjs);
+                for (int ad = 0; ad < adjs.adj_num + 1; ++ad)
+                {
+                    const ModuleBase::Vector3<double> dtau
+                        = (adjs.adjacent_tau[ad] - ucell.atoms[it].tau[ia]) * ucell.lat0;
+                    const double r = dtau.norm();
+                    if (r < 1.0e-8 || r >= radius)
+                    {
+                        continue;
+                    }
+                    pairs.push_back({iat, ucell.itia2iat(adjs.ntype[ad], adjs.natom[ad]), dtau});
+                    r_nn = (r_nn == 0.0) ? r : std::min(r_nn, r);
+                }
+            }
+        }
+        return r_nn;
+    };
+
+    double radius = std::max(precon.get_rcut(0.0), 6.0);
+    double r_nn = collect_pairs(radius);
+    while (r_nn == 0.0 && radius < 50.0)
+    {
+        radius *= 2.0;
+        r_nn = collect_pairs(radius);
+    }
+    if (r_nn > 0.0 && precon.get_rcut(r_nn) > radius)
+    {
+        r_nn = collect_pairs(precon.get_rcut(r_nn));
+    }
+    precon.build(pairs, r_nn);
+
+    GlobalV::ofs_running << " Model Hessian " << PARAM.inp.relax_precon << " with " << precon.get_nblocks()
+                         << " 3x3 blocks, nearest neighbor distance " << r_nn << " Bohr" << std::endl;
+    ModuleBase::timer::tick("Relax_LBFGS", "build_precon");
+}
+
+void Relax_LBFGS::precon_solve(const std::vector<double>& b, std::vector<double>& y) const
+{
+    y.resize(dim);
+    precon.solve(b.data(), y.data());
+    // P couples the fixed atoms to the free ones, the fixed components are projected out,
+    // so that neither dr nor the (s, y) pairs ever move them
+    for (int i = 0; i < 3 * nat; ++i)
+    {
+        y[i] *= mask[i];
+    }
+    const double mu_cell = precon.get_mean_diag();
+    for (int i = 3 * nat; i < dim; ++i)
+    {
+        y[i] = b[i] / mu_cell;
+    }
+}
+
+void Relax_LBFGS::new_direction()
+{
+    ModuleBase::TITLE("Relax_LBFGS", "new_direction");
+
+    const int m = s_list.size();
+    std::vector<double> rho(m);
+    std::vector<double> a(m);
+    std::vector<double> q = grad;
+    for (int i = m - 1; i >= 0; --i)
+    {
+        rho[i] = 1.0 / dot(y_list[i], s_list[i]);
+        a[i] = rho[i] * dot(s_list[i], q);
+        for (int k = 0; k < dim; ++k)
+        {
+            q[k] -= a[i] * y_list[i][k];
+        }
+    }
+
+    // the initial inverse Hessian is gamma P^{-1}
+    std::vector<double> z;
+    this->precon_solve(q, z);
+    if (m > 0)
+    {
+        std::vector<double> py;
+        this->precon_solve(y_list[m - 1], py);
+        const double gamma = dot(s_list[m - 1], y_list[m - 1]) / dot(y_list[m - 1], py);
+        for (int k = 0; k < dim; ++k)
+        {
+            z[k] *= gamma;
+        }
+    }
+
+    for (int i = 0; i < m; ++i)
+    {
+        const double b = rho[i] * dot(y_list[i], z);
+        for (int k = 0; k < dim; ++k)
+        {
+            z[k] += (a[i] - b) * s_list[i][k];
+        }
+    }
+    for (int k = 0; k < dim; ++k)
+    {
+        dr[k] = -z[k];
+    }
+    slope0 = dot(grad, dr);
+
+    // restart from the preconditioned steepest descent if dr is not downhill
+    if (slope0 >= 0.0)
+    {
+        GlobalV::ofs_running << " Reset the L-BFGS memory" << std::endl;
+        s_list.clear();
+        y_list.clear();
+        this->precon_solve(grad, z);
+        for (int k = 0; k < dim; ++k)
+        {
+            dr[k] = -z[k];
+        }
+        slope0 = dot(grad, dr);
+    }
+
+    // the largest move of an atom, the cell deformation is measured by the longest lattice vector
+    double dmax = 0.0;
+    for (int iat = 0; iat < nat; ++iat)
+    {
+        dmax = std::max(dmax, std::sqrt(dr[3 * iat] * dr[3 * iat] + dr[3 * iat + 1] * dr[3 * iat + 1]
+                                        + dr[3 * iat + 2] * dr[3 * iat + 2]));
+    }
+    if (if_cell_moves)
+    {
+        double df2 = 0.0;
+        for (int i = 3 * nat; i < dim; ++i)
+        {
+            df2 += dr[i] * dr[i];
+        }
+        dmax = std::max(dmax, std::sqrt(df2) / cell_factor * lat_max);
+    }
+    const double rmax = PARAM.inp.relax_bfgs_rmax;
+    if (dmax > rmax)
+    {
+        for (int k = 0; k < dim; ++k)
+        {
+            dr[k] *= rmax / dmax;
+        }
+        slope0 *= rmax / dmax;
+        dmax = rmax;
+    }
+    alpha_max = (dmax > 0.0) ? rmax / dmax : 1.0;
+}
+
+void Relax_LBFGS::move_cell_ions(UnitCell& ucell)
+{
+    ModuleBase::TITLE("Relax_LBFGS", "move_cell_ions");
+
+    ucell.ionic_position_updated = true;
+    if (if_cell_moves)
+    {
+        ucell.cell_parameter_updated = true;
+    }
+
+    std::vector<double> dx(dim);
+    for (int i = 0; i < dim; ++i)
+    {
+        const double xt = x0[i] + alpha * dr[i];
+        dx[i] = xt - x[i];
+        x[i] = xt;
+    }
+
+    // =================================================================
+    // Step 1 : the lattice vectors are L0 F
+    // =================================================================
+    if (if_cell_moves)
+    {
+        double* f = &x[3 * nat];
+        deform = ModuleBase::Matrix3(1.0 + f[0] / cell_factor,
+                                     f[1] / cell_factor,
+                                     f[2] / cell_factor,
+                                     f[3] / cell_factor,
+                                     1.0 + f[4] / cell_factor,
+                                     f[5] / cell_factor,
+                                     f[6] / cell_factor,
+                                     f[7] / cell_factor,
+                                     1.0 + f[8] / cell_factor);
+        if (PARAM.inp.fixed_axes == "volume")
+        {
+            deform *= 1.0 / std::cbrt(deform.Det());
+            const ModuleBase::matrix strain = (deform - ModuleBase::Matrix3()).to_matrix();
+            for (int i = 0; i < 9; ++i)
+            {
+                f[i] = strain.c[i] * cell_factor;
+            }
+        }
+        ucell.latvec = latvec0 * deform;
+    }
+
+    // =================================================================
+    // Step 2 : the direct coordinates are x L0^{-1}, whatever F is
+    // =================================================================
+    const ModuleBase::Matrix3 GT0 = latvec0.Inverse();
+    std::vector<double> move_ion(3 * nat, 0.0);
+    for (int iat = 0; iat < nat; ++iat)
+    {
+        const ModuleBase::Vector3<double> dx_ion(dx[3 * iat], dx[3 * iat + 1], dx[3 * iat + 2]);
+        const ModuleBase::Vector3<double> move_ion_dr = dx_ion * GT0 / ucell.lat0;
+        const Atom* atom = &ucell.atoms[ucell.iat2it[iat]];
+        const int ia = ucell.iat2ia[iat];
+        for (int i = 0; i < 3; ++i)
+        {
+            if (atom->mbl[ia][i])
+            {
+                move_ion[3 * iat + i] = move_ion_dr[i];
+            }
+        }
+    }
+    ucell.update_pos_taud(move_ion.data());
+    ucell.print_tau();
+
+    // =================================================================
+    // Step 3 : update G, GT and other stuff
+    // =================================================================
+    if (if_cell_moves)
+    {
+#ifdef __MPI
+        // distribute lattice vectors.
+        double* latvec[9] = {&ucell.latvec.e11,
+                             &ucell.latvec.e12,
+                             &ucell.latvec.e13,
+                             &ucell.latvec.e21,
+                             &ucell.latvec.e22,
+                             &ucell.latvec.e23,
+                             &ucell.latvec.e31,
+                             &ucell.latvec.e32,
+                             &ucell.latvec.e33};
+        for (double* e: latvec)
+        {
+            Parallel_Common::bcast_double(*e);
+        }
+#endif
+        ucell.a1 = ModuleBase::Vector3<double>(ucell.latvec.e11, ucell.latvec.e12, ucell.latvec.e13);
+        ucell.a2 = ModuleBase::Vector3<double>(ucell.latvec.e21, ucell.latvec.e22, ucell.latvec.e23);
+        ucell.a3 = ModuleBase::Vector3<double>(ucell.latvec.e31, ucell.latvec.e32, ucell.latvec.e33);
+
+        ucell.omega = std::abs(ucell.latvec.Det()) * ucell.lat0 * ucell.lat0 * ucell.lat0;
+        ucell.GT = ucell.latvec.Inverse();
+        ucell.G = ucell.GT.Transpose();
+        ucell.GGT = ucell.G * ucell.GT;
+        ucell.invGGT = ucell.GGT.Inverse();
+
+        unitcell::setup_cell_after_vc(ucell, GlobalV::ofs_running);
+        ModuleBase::GlobalFunc::DONE(GlobalV::ofs_running, "SETUP UNITCELL");
+    }
+}
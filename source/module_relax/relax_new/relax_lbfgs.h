@@ -0,0 +1,98 @@
+#ifndef RELAX_LBFGS_H
+#define RELAX_LBFGS_H
+
+#include "line_search.h"
+#include "module_base/matrix.h"
+#include "module_base/matrix3.h"
+#include "module_cell/unitcell.h"
+#include "precon.h"
+
+#include <deque>
+#include <vector>
+
+//----------------------------------------------------------
+//! Preconditioned L-BFGS relaxation (relax_method lbfgs_precon).
+//! The inverse Hessian of the two-loop recursion starts from
+//! the sparse model Hessian of Precon, rebuilt from the neighbor
+//! list of Grid_Driver after every accepted step, instead of
+//! a scaled identity. Each direction is followed with Line_Search
+//! until the strong Wolfe conditions relax_bfgs_w1/w2 hold.
+//! For cell-relax, the cell is L = L0 F, the atoms are moved in
+//! the undeformed coordinates x = r F^{-1}, and the 9 components
+//! of nat * (F - I) are optimized together with them.
+//----------------------------------------------------------
+class Relax_LBFGS
+{
+  public:
+    Relax_LBFGS() {};
+    ~Relax_LBFGS() {};
+
+    // prepare for relaxation
+    void init_relax(const int nat_in);
+
+    // perform a single relaxation step, return true when converged
+    bool relax_step(UnitCell& ucell,
+                    const ModuleBase::matrix& force,
+                    const ModuleBase::matrix& stress,
+                    const double etot_in);
+
+    // number of (s, y) pairs kept
+    int memory = 20;
+    // the most line search steps along one direction
+    int max_ls = 5;
+
+  private:
+    int nat = 0;
+    int istep = 0;
+    int dim = 0; // 3 * nat, plus 9 for cell-relax
+    bool if_cell_moves = false;
+    double cell_factor = 1.0;
+    double lat_max = 0.0; // length of the longest lattice vector at the start, in Bohr
+
+    // 1 for the free components, 0 for the atomic components fixed by mbl
+    std::vector<double> mask;
+
+    // variables, gradient and energy of this step, in Ry and Bohr
+    std::vector<double> x;
+    std::vector<double> grad;
+    double etot = 0.0;
+
+    // variables, gradient and energy of the last accepted point
+    std::vector<double> x0;
+    std::vector<double> grad0;
+    double etot0 = 0.0;
+
+    // search direction, scaled so that alpha = 1 moves the atoms by relax_bfgs_rmax at most
+    std::vector<double> dr;
+    double alpha = 0.0;
+    double alpha_max = 1.0;
+    double slope0 = 0.0; // grad0 * dr
+    int ls_step = 0;     // 0 if no line search is going on
+    bool ls_last = false;
+
+    std::deque<std::vector<double>> s_list;
+    std::deque<std::vector<double>> y_list;
+
+    ModuleBase::Matrix3 latvec0; // lattice vectors at the start, L0
+    ModuleBase::Matrix3 deform;  // F
+
+    Precon precon;
+    Line_Search ls;
+
+    // gradient from force and stress, constraints are considered here, return true when converged
+    bool setup_gradient(const UnitCell& ucell, const ModuleBase::matrix& force, const ModuleBase::matrix& stress);
+
+    // model Hessian of the current structure
+    void build_precon(const UnitCell& ucell);
+
+    // y = P^{-1} b, the cell block of P is a multiple of the identity, the fixed components of y are zero
+    void precon_solve(const std::vector<double>& b, std::vector<double>& y) const;
+
+    // two-loop recursion
+    void new_direction();
+
+    // move atoms and cell to x0 + alpha * dr
+    void move_cell_ions(UnitCell& ucell);
+};
+
+#endif
@@ -0,0 +1,152 @@
+#include "../precon.h"
+
+#include "gtest/gtest.h"
+
+#include <cmath>
+#include <vector>
+
+/************************************************
+ *  unit test of class Precon
+ ***********************************************/
+
+/**
+ * - Tested Functions:
+ *   - Precon::build(): the model Hessian is symmetric, and a rigid translation only feels the stabilization
+ *   - Precon::apply(), Precon::solve(): solve() inverts apply()
+ *   - Precon::get_rcut(): the pairs beyond the cutoff are left out
+ */
+
+namespace
+{
+// a bent chain of four atoms with the pairs of all sides, in Bohr
+std::vector<Precon::Pair> chain_pairs(std::vector<ModuleBase::Vector3<double>>& tau)
+{
+    tau = {{0.0, 0.0, 0.0}, {2.0, 0.3, 0.0}, {4.1, 0.0, 0.4}, {5.9, 1.2, 0.0}};
+    std::vector<Precon::Pair> pairs;
+    for (int i = 0; i < tau.size(); ++i)
+    {
+        for (int j = 0; j < tau.size(); ++j)
+        {
+            if (i != j)
+            {
+                pairs.push_back({i, j, tau[j] - tau[i]});
+            }
+        }
+    }
+    return pairs;
+}
+
+double nearest(const std::vector<ModuleBase::Vector3<double>>& tau)
+{
+    double r_nn = 1.0e10;
+    for (int i = 0; i < tau.size(); ++i)
+    {
+        for (int j = i + 1; j < tau.size(); ++j)
+        {
+            r_nn = std::min(r_nn, (tau[j] - tau[i]).norm());
+        }
+    }
+    return r_nn;
+}
+} // namespace
+
+class PreconTest : public testing::TestWithParam<std::string>
+{
+};
+
+TEST_P(PreconTest, Symmetric)
+{
+    std::vector<ModuleBase::Vector3<double>> tau;
+    const std::vector<Precon::Pair> pairs = chain_pairs(tau);
+    Precon p;
+    p.init(GetParam(), {"H", "C", "Si", "O"});
+    p.build(pairs, nearest(tau));
+
+    const int n = 3 * tau.size();
+    std::vector<double> e(n, 0.0);
+    std::vector<double> h(n * n);
+    for (int i = 0; i < n; ++i)
+    {
+        e[i] = 1.0;
+        p.apply(e.data(), &h[i * n]);
+        e[i] = 0.0;
+    }
+    for (int i = 0; i < n; ++i)
+    {
+        EXPECT_GT(h[i * n + i], 0.0);
+        for (int j = 0; j < n; ++j)
+        {
+            EXPECT_NEAR(h[i * n + j], h[j * n + i], 1e-12);
+        }
+    }
+
+    // a rigid translation only feels c_stab times the scale of the force constants
+    std::vector<double> t(n);
+    std::vector<double> pt(n);
+    for (int i = 0; i < n; ++i)
+    {
+        t[i] = (i % 3 == 1) ? 1.0 : 0.0;
+    }
+    p.apply(t.data(), pt.data());
+    const double stab = p.c_stab * (GetParam() == "exp" ? p.mu : 0.9);
+    for (int i = 0; i < n; ++i)
+    {
+        EXPECT_NEAR(pt[i], stab * t[i], 1e-12);
+    }
+}
+
+TEST_P(PreconTest, Solve)
+{
+    std::vector<ModuleBase::Vector3<double>> tau;
+    const std::vector<Precon::Pair> pairs = chain_pairs(tau);
+    Precon p;
+    p.init(GetParam(), {"H", "C", "Si", "O"});
+    p.build(pairs, nearest(tau));
+
+    const int n = 3 * tau.size();
+    std::vector<double> b(n);
+    for (int i = 0; i < n; ++i)
+    {
+        b[i] = std::sin(1.0 + i);
+    }
+    std::vector<double> x(n);
+    std::vector<double> px(n);
+    p.solve(b.data(), x.data());
+    p.apply(x.data(), px.data());
+    for (int i = 0; i < n; ++i)
+    {
+        EXPECT_NEAR(px[i], b[i], 1e-8);
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(ExpLindh, PreconTest, testing::Values("exp", "lindh"));
+
+TEST(PreconCutoffTest, Exp)
+{
+    std::vector<ModuleBase::Vector3<double>> tau;
+    const std::vector<Precon::Pair> pairs = chain_pairs(tau);
+    Precon p;
+    p.init("exp", {"Si", "Si", "Si", "Si"});
+    const double r_nn = nearest(tau);
+    EXPECT_DOUBLE_EQ(p.get_rcut(r_nn), 2.0 * r_nn);
+    p.build(pairs, r_nn);
+    // 4 diagonal blocks, the 3 bonds of the chain and the pair 1-3 from both sides, the others are beyond 2 r_nn
+    EXPECT_EQ(p.get_nblocks(), 4 + 2 * 3 + 2);
+    // the block of two nearest neighbors is -mu
+    std::vector<double> e(12, 0.0);
+    std::vector<double> pe(12);
+    e[0] = 1.0;
+    p.apply(e.data(), pe.data());
+    EXPECT_NEAR(pe[3], -p.mu * std::exp(-p.A * ((tau[1] - tau[0]).norm() / r_nn - 1.0)), 1e-12);
+    EXPECT_DOUBLE_EQ(pe[9], 0.0);
+}
+
+TEST(PreconCutoffTest, Lindh)
+{
+    Precon p;
+    p.init("lindh", {"H", "H"});
+    // k = k_r / 1000 at the cutoff of two hydrogen atoms
+    EXPECT_NEAR(p.get_rcut(1.0), std::sqrt(1.35 * 1.35 + std::log(1000.0)), 1e-12);
+    p.init("lindh", {"H", "Fe"});
+    EXPECT_NEAR(p.get_rcut(1.0), std::sqrt(3.40 * 3.40 + std::log(1000.0) / 0.28), 1e-12);
+}
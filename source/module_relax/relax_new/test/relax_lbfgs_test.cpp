@@ -0,0 +1,208 @@
+#include "gtest/gtest.h"
+#define private public
+#include "module_parameter/parameter.h"
+#include "../relax_lbfgs.h"
+#undef private
+#include "module_cell/module_neighbor/sltk_atom_arrange.h"
+#include "module_cell/unitcell.h"
+#include "relax_test.h"
+
+#include <cmath>
+
+/************************************************
+ *  unit test of class Relax_LBFGS
+ ***********************************************/
+
+/**
+ * - Tested Functions:
+ *   - Relax_LBFGS::relax_step(): the components fixed by mbl never move, while the free
+ *     ones relax a triangle of harmonic springs
+ *   - Relax_LBFGS::precon_solve(): the fixed components of P^{-1} b are zero
+ */
+
+// all the atoms of the cell are neighbors, no periodic images
+Grid::Grid(const int& test_grid_in) : test_grid(test_grid_in)
+{
+}
+Grid::~Grid()
+{
+}
+Grid_Driver::Grid_Driver(const int& test_d_in, const int& test_grid_in)
+    : Grid(test_grid_in), test_deconstructor(test_d_in)
+{
+}
+Grid_Driver::~Grid_Driver()
+{
+}
+void Grid_Driver::Find_atom(const UnitCell& ucell, const int ntype, const int nnumber, AdjacentAtomInfo* adjs) const
+{
+    adjs->clear();
+    for (int it = 0; it < ucell.ntype; ++it)
+    {
+        for (int ia = 0; ia < ucell.atoms[it].na; ++ia)
+        {
+            adjs->ntype.push_back(it);
+            adjs->natom.push_back(ia);
+            adjs->adjacent_tau.push_back(ucell.atoms[it].tau[ia]);
+            adjs->box.push_back(ModuleBase::Vector3<int>(0, 0, 0));
+        }
+    }
+    adjs->adj_num = adjs->ntype.size() - 1;
+}
+void atom_arrange::search(const bool flag,
+                          std::ofstream& ofs,
+                          Grid_Driver& grid_d,
+                          const UnitCell& ucell,
+                          const double& search_radius_bohr,
+                          const int& test_atom_in,
+                          const bool test_only)
+{
+}
+
+class Test_LBFGS : public testing::Test
+{
+  protected:
+    UnitCell ucell;
+    const int nat = 3;
+    // springs of all the pairs, in Ry and Bohr
+    const double k_spring = 0.5;
+    const double d_spring = 2.0;
+
+    void SetUp()
+    {
+        PARAM.input.calculation = "relax";
+        PARAM.input.relax_precon = "exp";
+        PARAM.input.force_thr_ev = 1.0e-4;
+        PARAM.input.relax_bfgs_rmax = 0.8;
+
+        ucell.ntype = 1;
+        ucell.nat = nat;
+        ucell.lat0 = 1.0;
+        ucell.latvec.e11 = ucell.latvec.e22 = ucell.latvec.e33 = 20.0;
+        ucell.a1 = ModuleBase::Vector3<double>(20.0, 0.0, 0.0);
+        ucell.a2 = ModuleBase::Vector3<double>(0.0, 20.0, 0.0);
+        ucell.a3 = ModuleBase::Vector3<double>(0.0, 0.0, 20.0);
+        ucell.iat2it = new int[nat];
+        ucell.iat2ia = new int[nat];
+        ucell.itia2iat.create(1, nat);
+        ucell.atoms = new Atom[1];
+        ucell.atoms[0].na = nat;
+        ucell.atoms[0].ncpp.psd = "H";
+        ucell.atoms[0].mbl.resize(nat);
+        ucell.atoms[0].taud.resize(nat);
+        ucell.atoms[0].tau.resize(nat);
+        for (int iat = 0; iat < nat; ++iat)
+        {
+            ucell.iat2it[iat] = 0;
+            ucell.iat2ia[iat] = iat;
+            ucell.itia2iat(0, iat) = iat;
+            ucell.atoms[0].mbl[iat] = {1, 1, 1};
+        }
+        // atom 0 is fixed, atom 1 can not move along z
+        ucell.atoms[0].mbl[0] = {0, 0, 0};
+        ucell.atoms[0].mbl[1] = {1, 1, 0};
+        ucell.atoms[0].taud[0] = {0.50, 0.50, 0.50};
+        ucell.atoms[0].taud[1] = {0.58, 0.51, 0.53};
+        ucell.atoms[0].taud[2] = {0.47, 0.60, 0.46};
+        this->set_tau();
+    }
+
+    // iat2it and iat2ia are deleted by the UnitCell
+    void TearDown()
+    {
+        delete[] ucell.atoms;
+    }
+
+    // the mocked UnitCell::update_pos_taud() only moves taud
+    void set_tau()
+    {
+        for (int iat = 0; iat < nat; ++iat)
+        {
+            ucell.atoms[0].tau[iat] = ucell.atoms[0].taud[iat] * ucell.latvec;
+        }
+    }
+
+    // energy and forces of the springs, the forces on the fixed components are kept as a DFT code gives them
+    double springs(ModuleBase::matrix& force) const
+    {
+        force.create(nat, 3);
+        double energy = 0.0;
+        for (int i = 0; i < nat; ++i)
+        {
+            for (int j = i + 1; j < nat; ++j)
+            {
+                const ModuleBase::Vector3<double> rij = ucell.atoms[0].tau[j] - ucell.atoms[0].tau[i];
+                const double r = rij.norm();
+                energy += 0.5 * k_spring * (r - d_spring) * (r - d_spring);
+                const ModuleBase::Vector3<double> fj = rij * (-k_spring * (r - d_spring) / r);
+                for (int c = 0; c < 3; ++c)
+                {
+                    force(j, c) += fj[c];
+                    force(i, c) -= fj[c];
+                }
+            }
+        }
+        return energy;
+    }
+};
+
+TEST_F(Test_LBFGS, FixedAtoms)
+{
+    const std::vector<ModuleBase::Vector3<double>> taud_start = ucell.atoms[0].taud;
+    Relax_LBFGS rl;
+    rl.init_relax(nat);
+    ModuleBase::matrix force;
+    ModuleBase::matrix stress(3, 3);
+    bool converged = false;
+    for (int istep = 0; istep < 100 && !converged; ++istep)
+    {
+        const double energy = this->springs(force);
+        converged = rl.relax_step(ucell, force, stress, energy);
+        this->set_tau();
+
+        // P^{-1} couples all the atoms, the fixed components of the direction are still zero
+        for (int i = 0; i < 3; ++i)
+        {
+            EXPECT_EQ(rl.dr[i], 0.0);
+        }
+        EXPECT_EQ(rl.dr[5], 0.0);
+        for (int i = 0; i < 3; ++i)
+        {
+            EXPECT_EQ(ucell.atoms[0].taud[0][i], taud_start[0][i]);
+        }
+        EXPECT_EQ(ucell.atoms[0].taud[1].z, taud_start[1].z);
+    }
+    EXPECT_TRUE(converged);
+
+    // all the springs are relaxed, which is possible with the constraints
+    for (int i = 0; i < nat; ++i)
+    {
+        for (int j = i + 1; j < nat; ++j)
+        {
+            EXPECT_NEAR((ucell.atoms[0].tau[j] - ucell.atoms[0].tau[i]).norm(), d_spring, 1.0e-4);
+        }
+    }
+}
+
+TEST_F(Test_LBFGS, PreconSolve)
+{
+    Relax_LBFGS rl;
+    rl.init_relax(nat);
+    ModuleBase::matrix force;
+    ModuleBase::matrix stress(3, 3);
+    const double energy = this->springs(force);
+    rl.relax_step(ucell, force, stress, energy);
+
+    std::vector<double> b(3 * nat, 1.0);
+    std::vector<double> y;
+    rl.precon_solve(b, y);
+    for (int i = 0; i < 3; ++i)
+    {
+        EXPECT_EQ(y[i], 0.0);
+    }
+    EXPECT_EQ(y[5], 0.0);
+    for (int i = 6; i < 3 * nat; ++i)
+    {
+        EXPECT_NE(y[i], 0.0);
+    }
+}
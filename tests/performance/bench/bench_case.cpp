@@ -0,0 +1,165 @@
+#include "bench_case.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+namespace abacus_bench
+{
+
+namespace
+{
+[[noreturn]] void bench_quit(const std::string& message)
+{
+    std::cerr << " abacus_bench: " << message << std::endl;
+    std::exit(1);
+}
+
+// next line that is neither empty nor a comment
+bool next_line(std::ifstream& ifs, std::string& line)
+{
+    while (std::getline(ifs, line))
+    {
+        const size_t pos = line.find_first_of("#/");
+        if (pos != std::string::npos)
+        {
+            line = line.substr(0, pos);
+        }
+        if (line.find_first_not_of(" \t\r") != std::string::npos)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void read_input(const std::string& file, BenchCase& bcase)
+{
+    std::ifstream ifs(file);
+    if (!ifs)
+    {
+        bench_quit("cannot open " + file);
+    }
+    std::string line;
+    while (next_line(ifs, line))
+    {
+        std::istringstream iss(line);
+        std::string key;
+        iss >> key;
+        std::transform(key.begin(), key.end(), key.begin(), ::tolower);
+        if (key == "ecutwfc")
+        {
+            iss >> bcase.ecutwfc;
+        }
+        else if (key == "basis_type")
+        {
+            iss >> bcase.basis_type;
+        }
+        else if (key == "nbands")
+        {
+            iss >> bcase.nbands;
+        }
+    }
+}
+
+void read_stru(const std::string& file, BenchCase& bcase)
+{
+    std::ifstream ifs(file);
+    if (!ifs)
+    {
+        bench_quit("cannot open " + file);
+    }
+    int ntype = 0;
+    bool direct = true;
+    std::vector<ModuleBase::Vector3<double>> pos;
+    std::string line;
+    while (next_line(ifs, line))
+    {
+        std::istringstream iss(line);
+        std::string block;
+        iss >> block;
+        if (block == "ATOMIC_SPECIES")
+        {
+            // the species block ends at the next keyword, count the lines before it
+            std::streampos mark = ifs.tellg();
+            while (next_line(ifs, line))
+            {
+                std::istringstream iss_sp(line);
+                std::string word;
+                iss_sp >> word;
+                if (word.find('_') != std::string::npos && std::isupper(word[0]) && std::isupper(word[1]))
+                {
+                    break;
+                }
+                ++ntype;
+                mark = ifs.tellg();
+            }
+            ifs.seekg(mark);
+        }
+        else if (block == "LATTICE_CONSTANT")
+        {
+            next_line(ifs, line);
+            bcase.lat0 = std::atof(line.c_str());
+        }
+        else if (block == "LATTICE_VECTORS")
+        {
+            ModuleBase::Matrix3& a = bcase.latvec;
+            next_line(ifs, line);
+            std::istringstream(line) >> a.e11 >> a.e12 >> a.e13;
+            next_line(ifs, line);
+            std::istringstream(line) >> a.e21 >> a.e22 >> a.e23;
+            next_line(ifs, line);
+            std::istringstream(line) >> a.e31 >> a.e32 >> a.e33;
+        }
+        else if (block == "ATOMIC_POSITIONS")
+        {
+            next_line(ifs, line);
+            direct = (line.find("Direct") != std::string::npos);
+            for (int it = 0; it < ntype; ++it)
+            {
+                next_line(ifs, line); // element
+                next_line(ifs, line); // magnetism
+                next_line(ifs, line);
+                const int na = std::atoi(line.c_str());
+                for (int ia = 0; ia < na; ++ia)
+                {
+                    next_line(ifs, line);
+                    ModuleBase::Vector3<double> r;
+                    std::istringstream(line) >> r.x >> r.y >> r.z;
+                    pos.push_back(r);
+                }
+            }
+        }
+    }
+    if (ntype == 0 || pos.empty())
+    {
+        bench_quit("no atoms found in " + file);
+    }
+    // cartesian positions in bohr
+    for (auto& r: pos)
+    {
+        bcase.tau.push_back(direct ? r * bcase.latvec * bcase.lat0 : r * bcase.lat0);
+    }
+}
+} // namespace
+
+BenchCase read_case(const std::string& dir)
+{
+    BenchCase bcase;
+    const size_t pos = dir.find_last_not_of('/');
+    const std::string path = dir.substr(0, pos + 1);
+    bcase.name = path.substr(path.find_last_of('/') + 1);
+    bcase.dir = path;
+
+    read_input(path + "/INPUT", bcase);
+    read_stru(path + "/STRU", bcase);
+    if (bcase.nbands <= 0)
+    {
+        bcase.nbands = std::max(8, 2 * bcase.nat());
+    }
+    return bcase;
+}
+
+} // namespace abacus_bench
@@ -0,0 +1,48 @@
+#ifndef ABACUS_BENCH_CASE_H
+#define ABACUS_BENCH_CASE_H
+
+#include "module_base/matrix3.h"
+#include "module_base/vector3.h"
+
+#include <string>
+#include <vector>
+
+namespace abacus_bench
+{
+
+/**
+ * @brief Sizes of one performance case, read from the INPUT and STRU files of
+ *        a directory in tests/performance (e.g. P000_si16_pw, P100_si16_lcao).
+ *
+ * Only what the kernels need is read: the cell, the atomic positions, ecutwfc,
+ * basis_type and nbands. The remaining sizes are not part of the input files
+ * and can be set from the command line.
+ */
+struct BenchCase
+{
+    std::string name;       ///< directory name, used in the benchmark names
+    std::string dir;        ///< path of the directory
+    std::string basis_type = "pw";
+    double lat0 = 1.0;      ///< lattice constant in bohr
+    ModuleBase::Matrix3 latvec;
+    std::vector<ModuleBase::Vector3<double>> tau; ///< cartesian positions in bohr
+    double ecutwfc = 50.0;  ///< Ry
+    int nbands = 0;         ///< from INPUT, or two per atom if it is not given
+    int nw = 13;            ///< LCAO orbitals per atom, DZP for Si by default
+    double rcut = 16.0;     ///< LCAO neighbour cutoff in bohr, twice the orbital radius
+    int iterations = 0;     ///< fixed number of iterations per benchmark, 0 to let google benchmark decide
+
+    int nat() const
+    {
+        return static_cast<int>(this->tau.size());
+    }
+};
+
+/**
+ * @brief read the case in directory dir, quits with a message on malformed files
+ */
+BenchCase read_case(const std::string& dir);
+
+} // namespace abacus_bench
+
+#endif
@@ -0,0 +1,306 @@
+#include "bench_kernels.h"
+
+#include "module_base/global_variable.h"
+#include "module_base/module_mixing/broyden_mixing.h"
+#include "module_base/parallel_comm.h"
+#include "module_base/parallel_reduce.h"
+#include "module_basis/module_pw/pw_basis_k.h"
+#ifdef __LCAO
+#include "module_basis/module_ao/parallel_orbitals.h"
+#include "module_elecstate/module_dm/density_matrix.h"
+#include "module_hamilt_lcao/module_hcontainer/hcontainer.h"
+#include "module_hamilt_lcao/module_hcontainer/hcontainer_funcs.h"
+#endif
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <random>
+#include <vector>
+
+namespace abacus_bench
+{
+
+namespace
+{
+using Complex = std::complex<double>;
+
+// the same random numbers on every run, so that the iteration counts are reproducible
+std::vector<Complex> random_vector(const size_t size, const int seed)
+{
+    std::mt19937 gen(seed + GlobalV::RANK_IN_POOL);
+    std::uniform_real_distribution<double> dis(-1.0, 1.0);
+    std::vector<Complex> v(size);
+    for (auto& x: v)
+    {
+        x = Complex(dis(gen), dis(gen));
+    }
+    return v;
+}
+
+// plane waves of the wavefunctions at Gamma, or of the charge density if dense
+void init_pw_basis(const BenchCase& bcase, ModulePW::PW_Basis_K& pw, const bool dense)
+{
+#ifdef __MPI
+    pw.initmpi(GlobalV::NPROC_IN_POOL, GlobalV::RANK_IN_POOL, POOL_WORLD);
+#endif
+    const ModuleBase::Vector3<double> gamma(0.0, 0.0, 0.0);
+    pw.initgrids(bcase.lat0, bcase.latvec, 4.0 * bcase.ecutwfc);
+    pw.initparameters(false, dense ? 4.0 * bcase.ecutwfc : bcase.ecutwfc, 1, &gamma);
+    pw.setuptransform();
+    pw.collect_local_pw();
+}
+
+//----------------------------------------------------------
+// FFT of all bands between G space and the real space grid
+//----------------------------------------------------------
+void bm_pw_fft(benchmark::State& state, const BenchCase bcase)
+{
+    ModulePW::PW_Basis_K pw("cpu", "double");
+    init_pw_basis(bcase, pw, false);
+    const int npw = pw.npwk[0];
+    const int nbands = bcase.nbands;
+    const base_device::DEVICE_CPU* ctx = {};
+
+    std::vector<Complex> psi = random_vector(static_cast<size_t>(npw) * nbands, 1);
+    std::vector<Complex> psir(pw.nrxx);
+    std::vector<Complex> out(npw);
+    for (auto _: state)
+    {
+        for (int ib = 0; ib < nbands; ++ib)
+        {
+            pw.recip_to_real(ctx, &psi[static_cast<size_t>(ib) * npw], psir.data(), 0);
+            pw.real_to_recip(ctx, psir.data(), out.data(), 0);
+        }
+        benchmark::DoNotOptimize(out.data());
+    }
+
+    // two 3D FFTs per band, 5 N log2(N) flops each
+    const double nxyz = static_cast<double>(pw.nxyz);
+    const double flops = 2.0 * nbands * 5.0 * nxyz * std::log2(nxyz);
+    state.SetItemsProcessed(state.iterations() * nbands);
+    state.SetBytesProcessed(state.iterations() * nbands * 2 * (pw.nrxx + npw) * sizeof(Complex));
+    state.counters["GFLOP/s"] = benchmark::Counter(flops * 1e-9, benchmark::Counter::kIsIterationInvariantRate);
+    state.counters["npw"] = npw;
+    state.counters["nxyz"] = pw.nxyz;
+}
+
+//----------------------------------------------------------
+// one Broyden step on the charge density in G space
+//----------------------------------------------------------
+void bm_broyden(benchmark::State& state, const BenchCase bcase)
+{
+    ModulePW::PW_Basis_K pw("cpu", "double");
+    init_pw_basis(bcase, pw, true);
+    const int length = pw.npw;
+    const int ndim = 8;
+
+    Base_Mixing::Broyden_Mixing broyden(ndim, 0.3);
+    Base_Mixing::Mixing& mixing = broyden;
+    Base_Mixing::Mixing_Data mdata;
+    mixing.init_mixing_data(mdata, length, sizeof(Complex));
+    auto inner_product_local = [length](Complex* a, Complex* b) {
+        double sum = 0.0;
+        for (int ig = 0; ig < length; ++ig)
+        {
+            sum += (std::conj(a[ig]) * b[ig]).real();
+        }
+        return sum;
+    };
+    auto reduce = [](double* sums, const int n) { Parallel_Reduce::reduce_pool(sums, n); };
+
+    // x_out = A x_in + b with a contraction A, the mixing converges to its fixed point
+    std::vector<Complex> x_in = random_vector(length, 4);
+    const std::vector<Complex> b = random_vector(length, 5);
+    std::vector<Complex> x_out(length);
+    auto step = [&]() {
+        for (int ig = 0; ig < length; ++ig)
+        {
+            x_out[ig] = (0.5 + 0.4 * ig / length) * x_in[ig] + b[ig];
+        }
+        mixing.push_data(mdata, x_in.data(), x_out.data(), nullptr, true);
+        mixing.cal_coef(mdata, inner_product_local, reduce);
+        mixing.mix_data(mdata, x_in.data());
+    };
+    // fill the history, so that every timed step works on all ndim vectors
+    for (int istep = 0; istep < ndim + 1; ++istep)
+    {
+        step();
+    }
+
+    for (auto _: state)
+    {
+        step();
+        benchmark::DoNotOptimize(x_in.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * length);
+    state.SetBytesProcessed(state.iterations() * (ndim + 3) * length * sizeof(Complex));
+    state.counters["length"] = length;
+}
+
+#ifdef __LCAO
+//----------------------------------------------------------
+// the H(R) pattern of all atom pairs closer than rcut
+//----------------------------------------------------------
+struct LcaoSetup
+{
+    Parallel_Orbitals pv;
+    std::vector<int> iat2iwt;
+    std::vector<ModuleBase::Vector3<int>> rs;
+    std::vector<std::pair<int, int>> pairs;
+
+    explicit LcaoSetup(const BenchCase& bcase)
+    {
+        const int nat = bcase.nat();
+        const int nlocal = nat * bcase.nw;
+        for (int iat = 0; iat < nat; ++iat)
+        {
+            this->iat2iwt.push_back(iat * bcase.nw);
+        }
+#ifdef __MPI
+        this->pv.init(nlocal, nlocal, std::min(32, nlocal), MPI_COMM_WORLD);
+#else
+        this->pv.set_serial(nlocal, nlocal);
+#endif
+        this->pv.set_atomic_trace(this->iat2iwt.data(), nat, nlocal);
+
+        for (int iat1 = 0; iat1 < nat; ++iat1)
+        {
+            for (int iat2 = 0; iat2 < nat; ++iat2)
+            {
+                for (int rx = -1; rx <= 1; ++rx)
+                {
+                    for (int ry = -1; ry <= 1; ++ry)
+                    {
+                        for (int rz = -1; rz <= 1; ++rz)
+                        {
+                            const ModuleBase::Vector3<double> r(rx, ry, rz);
+                            const ModuleBase::Vector3<double> d
+                                = bcase.tau[iat2] + r * bcase.latvec * bcase.lat0 - bcase.tau[iat1];
+                            if (d.norm() < bcase.rcut)
+                            {
+                                this->rs.push_back(ModuleBase::Vector3<int>(rx, ry, rz));
+                                this->pairs.push_back(std::make_pair(iat1, iat2));
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    void fill(hamilt::HContainer<double>& hR) const
+    {
+        for (size_t i = 0; i < this->pairs.size(); ++i)
+        {
+            hR.insert_pair(
+                hamilt::AtomPair<double>(this->pairs[i].first, this->pairs[i].second, this->rs[i], &this->pv));
+        }
+        hR.allocate(nullptr, true);
+        std::mt19937 gen(6);
+        std::uniform_real_distribution<double> dis(-1.0, 1.0);
+        for (size_t i = 0; i < hR.get_nnr(); ++i)
+        {
+            hR.get_wrapper()[i] = dis(gen);
+        }
+    }
+};
+
+// H(k) = \sum_R H(R) e^{ikR}
+void bm_folding_hr(benchmark::State& state, const BenchCase bcase)
+{
+    const LcaoSetup setup(bcase);
+    hamilt::HContainer<double> hR(&setup.pv);
+    setup.fill(hR);
+    const int nrow = setup.pv.get_row_size();
+    const int ncol = setup.pv.get_col_size();
+    std::vector<Complex> hk(static_cast<size_t>(nrow) * ncol);
+    const ModuleBase::Vector3<double> kvec_d(0.1, 0.2, 0.3);
+
+    for (auto _: state)
+    {
+        std::fill(hk.begin(), hk.end(), Complex(0.0, 0.0));
+        hamilt::folding_HR(hR, hk.data(), kvec_d, ncol, 0);
+        benchmark::DoNotOptimize(hk.data());
+    }
+
+    // one real-complex multiply-add per element of H(R)
+    const double nnr = static_cast<double>(hR.get_nnr());
+    state.SetItemsProcessed(state.iterations() * hR.get_nnr());
+    state.SetBytesProcessed(state.iterations() * hR.get_nnr() * (sizeof(double) + sizeof(Complex)));
+    state.counters["GFLOP/s"] = benchmark::Counter(4.0 * nnr * 1e-9, benchmark::Counter::kIsIterationInvariantRate);
+    state.counters["nnr"] = nnr;
+}
+
+// DM(R) = \sum_k DM(k) e^{-ikR}, for one k point
+void bm_cal_dmr(benchmark::State& state, const BenchCase bcase)
+{
+    const LcaoSetup setup(bcase);
+    hamilt::HContainer<double> hR(&setup.pv);
+    setup.fill(hR);
+    const std::vector<ModuleBase::Vector3<double>> kvec_d = {ModuleBase::Vector3<double>(0.1, 0.2, 0.3)};
+    elecstate::DensityMatrix<Complex, double> dm(&setup.pv, 1, kvec_d, 1);
+    dm.init_DMR(hR);
+    for (auto& dmk: dm.get_DMK_vector())
+    {
+        const std::vector<Complex> values = random_vector(dmk.size(), 7);
+        std::copy(values.begin(), values.end(), dmk.begin());
+    }
+
+    for (auto _: state)
+    {
+        dm.cal_DMR();
+    }
+
+    const double nnr = static_cast<double>(hR.get_nnr());
+    state.SetItemsProcessed(state.iterations() * hR.get_nnr());
+    state.SetBytesProcessed(state.iterations() * hR.get_nnr() * (sizeof(double) + sizeof(Complex)));
+    state.counters["GFLOP/s"] = benchmark::Counter(4.0 * nnr * 1e-9, benchmark::Counter::kIsIterationInvariantRate);
+    state.counters["nnr"] = nnr;
+}
+#endif
+} // namespace
+
+void set_run(benchmark::internal::Benchmark* bm, const BenchCase& bcase, const benchmark::TimeUnit unit)
+{
+    bm->Unit(unit);
+    if (bcase.iterations > 0)
+    {
+        bm->Iterations(bcase.iterations);
+    }
+    else if (GlobalV::NPROC_IN_POOL > 1)
+    {
+        bm->Iterations(10);
+    }
+}
+
+void register_pw_benchmarks(const BenchCase& bcase)
+{
+    set_run(benchmark::RegisterBenchmark(("pw_fft/" + bcase.name).c_str(), bm_pw_fft, bcase),
+            bcase,
+            benchmark::kMillisecond);
+}
+
+void register_mixing_benchmarks(const BenchCase& bcase)
+{
+    set_run(benchmark::RegisterBenchmark(("broyden/" + bcase.name).c_str(), bm_broyden, bcase),
+            bcase,
+            benchmark::kMicrosecond);
+}
+
+#ifdef __LCAO
+void register_lcao_benchmarks(const BenchCase& bcase)
+{
+    set_run(benchmark::RegisterBenchmark(("folding_hr/" + bcase.name).c_str(), bm_folding_hr, bcase),
+            bcase,
+            benchmark::kMillisecond);
+    set_run(benchmark::RegisterBenchmark(("cal_dmr/" + bcase.name).c_str(), bm_cal_dmr, bcase),
+            bcase,
+            benchmark::kMillisecond);
+}
+#endif
+
+} // namespace abacus_bench
@@ -0,0 +1,37 @@
+#ifndef ABACUS_BENCH_KERNELS_H
+#define ABACUS_BENCH_KERNELS_H
+
+#include "bench_case.h"
+
+#include <benchmark/benchmark.h>
+
+namespace abacus_bench
+{
+
+/**
+ * Each function registers the benchmarks of one group of hot kernels for a case,
+ * named "<kernel>/<case name>". Every benchmark reports its throughput as
+ * items_per_second and bytes_per_second, and as a GFLOP/s counter where the
+ * operation count is well defined.
+ *
+ *  - PW:     PW_Basis_K::recip_to_real + real_to_recip of all bands (FFT)
+ *  - mixing: Broyden_Mixing push_data + cal_coef + mix_data on the charge density
+ *  - LCAO:   hamilt::folding_HR and DensityMatrix::cal_DMR on the H(R) pattern of the cell
+ * They only need the sizes of the case. The kernels that need a real run are in bench_scf.h.
+ */
+void register_pw_benchmarks(const BenchCase& bcase);
+void register_mixing_benchmarks(const BenchCase& bcase);
+#ifdef __LCAO
+void register_lcao_benchmarks(const BenchCase& bcase);
+#endif
+
+/**
+ * @brief set the time unit of a benchmark, and its number of iterations if it is fixed
+ * With several processes all of them must run the same number of iterations, because the kernels
+ * communicate; google benchmark times every rank on its own.
+ */
+void set_run(benchmark::internal::Benchmark* bm, const BenchCase& bcase, const benchmark::TimeUnit unit);
+
+} // namespace abacus_bench
+
+#endif
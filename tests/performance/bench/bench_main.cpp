@@ -0,0 +1,218 @@
+//==========================================================
+// abacus_bench: google-benchmark driver for the hot kernels
+// of ABACUS, with problem sizes taken from the cases in
+// tests/performance. See README in this directory.
+//==========================================================
+#include "bench_case.h"
+#include "bench_kernels.h"
+#include "bench_scf.h"
+
+#include "module_base/global_variable.h"
+#include "module_base/parallel_comm.h"
+#include "module_base/parallel_global.h"
+#include "module_parameter/parameter.h"
+
+#include <benchmark/benchmark.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+#ifdef __MPI
+#include <mpi.h>
+#endif
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace
+{
+// ranks other than 0 run the same benchmarks, as the kernels communicate, but report nothing
+class NullReporter : public benchmark::BenchmarkReporter
+{
+  public:
+    bool ReportContext(const Context&) override
+    {
+        return true;
+    }
+    void ReportRuns(const std::vector<Run>&) override
+    {
+    }
+    void Finalize() override
+    {
+    }
+};
+
+void print_usage()
+{
+    std::cout << " abacus_bench [--case=<dir>]... [--omp_threads=<n>] [--nbands=<n>] [--ecut=<Ry>]\n"
+                 "              [--nw=<n>] [--rcut=<bohr>] [--iterations=<n>] [google benchmark options]\n"
+                 "   --case         case directory with INPUT, STRU and KPT, may be repeated\n"
+                 "                  (default: ../P000_si16_pw ../P100_si16_lcao)\n"
+                 "   --omp_threads  number of OpenMP threads per process\n"
+                 "   --nbands       number of bands, overrides INPUT\n"
+                 "   --ecut         ecutwfc in Ry, overrides INPUT\n"
+                 "   --nw           LCAO orbitals per atom (default 13)\n"
+                 "   --rcut         LCAO neighbour cutoff in bohr (default 16)\n"
+                 "                  the four options above are not used by gint_*, mix_rho and pw_david,\n"
+                 "                  which run the case as abacus does\n"
+                 "   --iterations   fixed iterations per benchmark (default: automatic on one process,\n"
+                 "                  10 on more, as all processes must run the same number)\n"
+              << std::endl;
+}
+
+bool read_flag(const char* arg, const char* flag, std::string& value)
+{
+    const size_t len = std::strlen(flag);
+    if (std::strncmp(arg, flag, len) == 0 && arg[len] == '=')
+    {
+        value = arg + len + 1;
+        return true;
+    }
+    return false;
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+#ifdef __MPI
+    MPI_Init(&argc, &argv);
+    MPI_Comm_size(MPI_COMM_WORLD, &GlobalV::NPROC);
+    MPI_Comm_rank(MPI_COMM_WORLD, &GlobalV::MY_RANK);
+    // the worlds of Driver::reading, with one pool and one band group for all cases
+    Parallel_Global::split_diag_world(GlobalV::NPROC,
+                                      GlobalV::NPROC,
+                                      GlobalV::MY_RANK,
+                                      GlobalV::DRANK,
+                                      GlobalV::DSIZE,
+                                      GlobalV::DCOLOR);
+    Parallel_Global::split_grid_world(GlobalV::NPROC, GlobalV::NPROC, GlobalV::MY_RANK, GlobalV::GRANK, GlobalV::GSIZE);
+    Parallel_Global::init_pools(GlobalV::NPROC,
+                                GlobalV::MY_RANK,
+                                1,
+                                1,
+                                GlobalV::NPROC_IN_STOGROUP,
+                                GlobalV::RANK_IN_STOGROUP,
+                                GlobalV::MY_STOGROUP,
+                                GlobalV::NPROC_IN_POOL,
+                                GlobalV::RANK_IN_POOL,
+                                GlobalV::MY_POOL);
+#endif
+
+    // take our own flags out of argv, the rest goes to google benchmark
+    std::vector<std::string> case_dirs;
+    int omp_threads = 0;
+    int nbands = 0;
+    int nw = 0;
+    int iterations = 0;
+    double ecut = 0.0;
+    double rcut = 0.0;
+    int nargs = 1;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string value;
+        if (read_flag(argv[i], "--case", value))
+        {
+            case_dirs.push_back(value);
+        }
+        else if (read_flag(argv[i], "--omp_threads", value))
+        {
+            omp_threads = std::atoi(value.c_str());
+        }
+        else if (read_flag(argv[i], "--nbands", value))
+        {
+            nbands = std::atoi(value.c_str());
+        }
+        else if (read_flag(argv[i], "--ecut", value))
+        {
+            ecut = std::atof(value.c_str());
+        }
+        else if (read_flag(argv[i], "--nw", value))
+        {
+            nw = std::atoi(value.c_str());
+        }
+        else if (read_flag(argv[i], "--rcut", value))
+        {
+            rcut = std::atof(value.c_str());
+        }
+        else if (read_flag(argv[i], "--iterations", value))
+        {
+            iterations = std::atoi(value.c_str());
+        }
+        else if (std::strcmp(argv[i], "--help") == 0 && GlobalV::RANK_IN_POOL == 0)
+        {
+            print_usage();
+            argv[nargs++] = argv[i];
+        }
+        else
+        {
+            argv[nargs++] = argv[i];
+        }
+    }
+    argc = nargs;
+    if (case_dirs.empty())
+    {
+        case_dirs = {"../P000_si16_pw", "../P100_si16_lcao"};
+    }
+#ifdef _OPENMP
+    if (omp_threads > 0)
+    {
+        omp_set_num_threads(omp_threads);
+    }
+    PARAM.set_pal_param(GlobalV::MY_RANK, GlobalV::NPROC, omp_get_max_threads());
+#else
+    PARAM.set_pal_param(GlobalV::MY_RANK, GlobalV::NPROC, 1);
+#endif
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv))
+    {
+        return 1;
+    }
+
+    for (const std::string& dir: case_dirs)
+    {
+        abacus_bench::BenchCase bcase = abacus_bench::read_case(dir);
+        bcase.nbands = (nbands > 0) ? nbands : bcase.nbands;
+        bcase.ecutwfc = (ecut > 0.0) ? ecut : bcase.ecutwfc;
+        bcase.nw = (nw > 0) ? nw : bcase.nw;
+        bcase.rcut = (rcut > 0.0) ? rcut : bcase.rcut;
+        bcase.iterations = iterations;
+        if (bcase.basis_type == "lcao")
+        {
+#ifdef __LCAO
+            abacus_bench::register_lcao_benchmarks(bcase);
+            abacus_bench::register_scf_benchmarks(bcase);
+#else
+            if (GlobalV::RANK_IN_POOL == 0)
+            {
+                std::cout << " abacus_bench: " << bcase.name << " skipped, built without LCAO" << std::endl;
+            }
+#endif
+        }
+        else
+        {
+            abacus_bench::register_pw_benchmarks(bcase);
+            abacus_bench::register_mixing_benchmarks(bcase);
+            abacus_bench::register_scf_benchmarks(bcase);
+        }
+    }
+
+    if (GlobalV::RANK_IN_POOL == 0)
+    {
+        benchmark::RunSpecifiedBenchmarks();
+    }
+    else
+    {
+        NullReporter null_reporter;
+        benchmark::RunSpecifiedBenchmarks(&null_reporter, &null_reporter);
+    }
+    benchmark::Shutdown();
+    abacus_bench::free_scf_case();
+
+#ifdef __MPI
+    MPI_Finalize();
+#endif
+    return 0;
+}
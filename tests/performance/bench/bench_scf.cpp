@@ -0,0 +1,453 @@
+#include "bench_scf.h"
+
+#include "bench_kernels.h"
+
+#include "module_base/global_file.h"
+#include "module_base/global_variable.h"
+#include "module_base/parallel_comm.h"
+#include "module_base/tool_quit.h"
+#include "module_cell/unitcell.h"
+#include "module_elecstate/module_charge/charge_mixing.h"
+#include "module_esolver/esolver_ks_pw.h"
+#include "module_hsolver/diago_david.h"
+#include "module_io/input_conv.h"
+#include "module_io/read_input.h"
+#include "module_parameter/parameter.h"
+#ifdef __LCAO
+#include "module_elecstate/elecstate_lcao.h"
+#include "module_esolver/esolver_ks_lcao.h"
+#endif
+
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+#include <complex>
+#include <memory>
+#include <vector>
+#include <unistd.h>
+
+namespace abacus_bench
+{
+
+namespace
+{
+using Complex = std::complex<double>;
+
+//----------------------------------------------------------
+// a case set up in its directory, after one SCF iteration
+//----------------------------------------------------------
+class ScfCase
+{
+  public:
+    virtual ~ScfCase()
+    {
+        ModuleBase::Global_File::close_all_log(GlobalV::MY_RANK, PARAM.inp.out_alllog, PARAM.inp.calculation);
+        if (chdir(this->cwd.c_str()) != 0)
+        {
+            ModuleBase::WARNING_QUIT("abacus_bench", "cannot go back to " + this->cwd);
+        }
+    }
+
+    /// before_all_runners, before_scf and the first SCF iteration, as in ESolver_KS::runner
+    virtual void prepare() = 0;
+    virtual Charge* charge() = 0;
+    virtual Charge_Mixing* mixing() = 0;
+
+    virtual void gint_vlocal()
+    {
+        ModuleBase::WARNING_QUIT("abacus_bench", "gint_vlocal is only for LCAO cases");
+    }
+    virtual void gint_rho(std::vector<std::vector<double>>& rho)
+    {
+        ModuleBase::WARNING_QUIT("abacus_bench", "gint_rho is only for LCAO cases");
+    }
+    /// the number of elements of H(R) on the grid of this process
+    virtual size_t gint_nnr()
+    {
+        return 0;
+    }
+    /// @return the number of Davidson iterations
+    virtual int david(int64_t& nhpsi)
+    {
+        ModuleBase::WARNING_QUIT("abacus_bench", "pw_david is only for PW cases");
+        return 0;
+    }
+    virtual int npw()
+    {
+        return 0;
+    }
+
+    /// keep the input and output densities of the first SCF iteration, which mix_rho changes
+    void save_charge()
+    {
+        const Charge* chr = this->charge();
+        const int npw = chr->rhopw->npw;
+        for (int is = 0; is < chr->nspin; ++is)
+        {
+            this->rho.emplace_back(chr->rho[is], chr->rho[is] + chr->nrxx);
+            this->rho_save.emplace_back(chr->rho_save[is], chr->rho_save[is] + chr->nrxx);
+            this->rhog.emplace_back(chr->rhog[is], chr->rhog[is] + npw);
+            this->rhog_save.emplace_back(chr->rhog_save[is], chr->rhog_save[is] + npw);
+        }
+    }
+
+    void restore_charge()
+    {
+        Charge* chr = this->charge();
+        for (int is = 0; is < chr->nspin; ++is)
+        {
+            std::copy(this->rho[is].begin(), this->rho[is].end(), chr->rho[is]);
+            std::copy(this->rho_save[is].begin(), this->rho_save[is].end(), chr->rho_save[is]);
+            std::copy(this->rhog[is].begin(), this->rhog[is].end(), chr->rhog[is]);
+            std::copy(this->rhog_save[is].begin(), this->rhog_save[is].end(), chr->rhog_save[is]);
+        }
+    }
+
+    std::string dir;
+    std::string cwd;
+    UnitCell cell;
+
+  private:
+    std::vector<std::vector<double>> rho;
+    std::vector<std::vector<double>> rho_save;
+    std::vector<std::vector<Complex>> rhog;
+    std::vector<std::vector<Complex>> rhog_save;
+};
+
+template <typename T>
+class PwScf : public ScfCase, public ModuleESolver::ESolver_KS_PW<T>
+{
+  public:
+    void prepare() override
+    {
+        this->before_all_runners(this->cell, PARAM.inp);
+        this->before_scf(this->cell, 0);
+        this->diag_ethr = PARAM.inp.pw_diag_thr;
+        this->iter_init(this->cell, 0, 1);
+        this->hamilt2density(this->cell, 0, 1, this->diag_ethr);
+
+        // the wave functions of the first k point after the first iteration, each diagonalization starts from them
+        this->kspw_psi->fix_k(0);
+        this->psi0.assign(this->kspw_psi->get_pointer(),
+                          this->kspw_psi->get_pointer() + this->kspw_psi->get_nbands() * this->kspw_psi->get_nbasis());
+    }
+
+    Charge* charge() override
+    {
+        return this->pelec->charge;
+    }
+
+    Charge_Mixing* mixing() override
+    {
+        return this->p_chgmix;
+    }
+
+    // as in HSolverPW::hamiltSolvePsiK with ks_solver = dav
+    int david(int64_t& nhpsi) override
+    {
+        const int ik = 0;
+        this->p_hamilt->updateHk(ik);
+        psi::Psi<T>& psi = *this->kspw_psi;
+        psi.fix_k(ik);
+        std::copy(this->psi0.begin(), this->psi0.end(), psi.get_pointer());
+
+        const int npw = this->pw_wfc->npwk[ik];
+        const int nbasis = psi.get_nbasis();
+        std::vector<double> precondition(nbasis, 1.0);
+        for (int ig = 0; ig < npw; ++ig)
+        {
+            const double g2kin = this->pw_wfc->getgk2(ik, ig) * this->pw_wfc->tpiba2;
+            precondition[ig] = 1.0 + g2kin + std::sqrt(1.0 + (g2kin - 1.0) * (g2kin - 1.0));
+            if (PARAM.globalv.npol == 2)
+            {
+                precondition[ig + nbasis / 2] = precondition[ig];
+            }
+        }
+
+        const std::vector<int> ngk = {npw};
+        hamilt::Hamilt<T>* hm = this->p_hamilt;
+        auto hpsi_func = [hm, &ngk, &nhpsi](T* psi_in, T* hpsi_out, const int ld_psi, const int nvec) {
+            psi::Psi<T> psi_wrapper(psi_in, 1, nvec, ld_psi, ngk);
+            const psi::Range bands_range(true, 0, 0, nvec - 1);
+            typename hamilt::Operator<T>::hpsi_info info(&psi_wrapper, bands_range, hpsi_out);
+            hm->ops->hPsi(info);
+            nhpsi += nvec;
+        };
+        auto spsi_func = [hm](T* psi_in, T* spsi_out, const int ld_psi, const int nvec) {
+            hm->sPsi(psi_in, spsi_out, ld_psi, ld_psi, nvec);
+        };
+
+#ifdef __MPI
+        const hsolver::diag_comm_info comm_info(POOL_WORLD, GlobalV::RANK_IN_POOL, GlobalV::NPROC_IN_POOL);
+#else
+        const hsolver::diag_comm_info comm_info(GlobalV::RANK_IN_POOL, GlobalV::NPROC_IN_POOL);
+#endif
+        const int nband = psi.get_nbands();
+        std::vector<double> eigenvalue(nband);
+        const std::vector<double> ethr_band(nband, this->diag_ethr);
+        hsolver::DiagoDavid<T> david(precondition.data(),
+                                     nband,
+                                     psi.get_current_nbas(),
+                                     PARAM.inp.pw_diag_ndim,
+                                     false,
+                                     comm_info);
+        return david.diag(hpsi_func,
+                          spsi_func,
+                          nbasis,
+                          psi.get_pointer(),
+                          eigenvalue.data(),
+                          ethr_band,
+                          PARAM.inp.pw_diag_nmax);
+    }
+
+    int npw() override
+    {
+        return this->pw_wfc->npwk[0];
+    }
+
+  private:
+    std::vector<T> psi0;
+};
+
+#ifdef __LCAO
+template <typename TK, typename TR>
+class LcaoScf : public ScfCase, public ModuleESolver::ESolver_KS_LCAO<TK, TR>
+{
+  public:
+    void prepare() override
+    {
+        this->before_all_runners(this->cell, PARAM.inp);
+        this->before_scf(this->cell, 0);
+        this->diag_ethr = PARAM.inp.pw_diag_thr;
+        this->iter_init(this->cell, 0, 1);
+        this->hamilt2density(this->cell, 0, 1, this->diag_ethr);
+    }
+
+    Charge* charge() override
+    {
+        return this->pelec->charge;
+    }
+
+    Charge_Mixing* mixing() override
+    {
+        return this->p_chgmix;
+    }
+
+    // as in Veff::contributeHR, without the transfer to H(R)
+    void gint_vlocal() override
+    {
+        for (int is = 0; is < PARAM.inp.nspin; ++is)
+        {
+            Gint_inout inout(this->pelec->pot->get_effective_v(is), is, Gint_Tools::job_type::vlocal);
+            this->gint()->cal_gint(&inout);
+        }
+    }
+
+    // as in ElecStateLCAO::psiToRho
+    void gint_rho(std::vector<std::vector<double>>& rho) override
+    {
+        auto* dm = dynamic_cast<elecstate::ElecStateLCAO<TK>*>(this->pelec)->get_DM();
+        std::vector<double*> rho_ptr;
+        for (auto& rho_is: rho)
+        {
+            std::fill(rho_is.begin(), rho_is.end(), 0.0);
+            rho_ptr.push_back(rho_is.data());
+        }
+        this->gint()->transfer_DM2DtoGrid(dm->get_DMR_vector());
+        Gint_inout inout(rho_ptr.data(), Gint_Tools::job_type::rho, PARAM.inp.nspin);
+        this->gint()->cal_gint(&inout);
+    }
+
+    size_t gint_nnr() override
+    {
+        const hamilt::HContainer<double>* hR = this->gint()->get_hRGint();
+        return (hR == nullptr) ? 0 : hR->get_nnr();
+    }
+
+  private:
+    Gint* gint()
+    {
+        if (PARAM.globalv.gamma_only_local)
+        {
+            return &this->GG;
+        }
+        return &this->GK;
+    }
+};
+#endif
+
+// the case of the benchmarks running now
+std::unique_ptr<ScfCase> scf_case;
+
+// the case is read as Driver::reading and Driver::driver_run do
+ScfCase& get_scf_case(const BenchCase& bcase)
+{
+    if (scf_case != nullptr && scf_case->dir == bcase.dir)
+    {
+        return *scf_case;
+    }
+    // the logs of the previous case are closed in its own directory
+    scf_case.reset();
+
+    // the parameters before any INPUT is read, restored for every case
+    static const Input_para input0 = PARAM.inp;
+    static const System_para sys0 = PARAM.globalv;
+
+    char cwd[4096];
+    if (getcwd(cwd, sizeof(cwd)) == nullptr || chdir(bcase.dir.c_str()) != 0)
+    {
+        ModuleBase::WARNING_QUIT("abacus_bench", "cannot go to the directory " + bcase.dir);
+    }
+    // the paths of the pseudopotentials and the orbitals in STRU are relative to the case
+    PARAM.set_batch_stru(input0, sys0, sys0.global_in_stru, bcase.name);
+    ModuleIO::ReadInput read_input(GlobalV::MY_RANK);
+    read_input.read_parameters(PARAM, PARAM.globalv.global_in_card);
+    read_input.create_directory(PARAM);
+    Input_Conv::Convert();
+    if (PARAM.inp.kpar != 1 || PARAM.inp.bndpar != 1)
+    {
+        ModuleBase::WARNING_QUIT("abacus_bench", "kpar and bndpar must be 1 in " + bcase.dir);
+    }
+
+    if (PARAM.inp.basis_type == "pw")
+    {
+        scf_case.reset(new PwScf<Complex>);
+    }
+#ifdef __LCAO
+    else if (PARAM.globalv.gamma_only_local)
+    {
+        scf_case.reset(new LcaoScf<double, double>);
+    }
+    else if (PARAM.inp.nspin < 4)
+    {
+        scf_case.reset(new LcaoScf<Complex, double>);
+    }
+    else
+    {
+        scf_case.reset(new LcaoScf<Complex, Complex>);
+    }
+#endif
+    if (scf_case == nullptr)
+    {
+        ModuleBase::WARNING_QUIT("abacus_bench", "basis_type " + PARAM.inp.basis_type + " is not benchmarked");
+    }
+    scf_case->dir = bcase.dir;
+    scf_case->cwd = cwd;
+
+    UnitCell& ucell = scf_case->cell;
+    ucell.setup(PARAM.inp.latname, PARAM.inp.ntype, PARAM.inp.lmaxmax, PARAM.inp.init_vel, PARAM.inp.fixed_axes);
+    ucell.setup_cell(PARAM.globalv.global_in_stru, GlobalV::ofs_running);
+    scf_case->prepare();
+    scf_case->save_charge();
+    return *scf_case;
+}
+
+//----------------------------------------------------------
+// <phi|V_loc|phi> on the real space grid
+//----------------------------------------------------------
+void bm_gint_vlocal(benchmark::State& state, const BenchCase bcase)
+{
+    ScfCase& scf = get_scf_case(bcase);
+    for (auto _: state)
+    {
+        scf.gint_vlocal();
+    }
+
+    const Charge* chr = scf.charge();
+    state.SetItemsProcessed(state.iterations() * chr->nrxx * chr->nspin);
+    state.counters["nrxx"] = chr->nrxx;
+    state.counters["nnr"] = static_cast<double>(scf.gint_nnr());
+}
+
+//----------------------------------------------------------
+// the charge density from DM(R) on the real space grid
+//----------------------------------------------------------
+void bm_gint_rho(benchmark::State& state, const BenchCase bcase)
+{
+    ScfCase& scf = get_scf_case(bcase);
+    const Charge* chr = scf.charge();
+    std::vector<std::vector<double>> rho(chr->nspin, std::vector<double>(chr->nrxx));
+    for (auto _: state)
+    {
+        scf.gint_rho(rho);
+        benchmark::DoNotOptimize(rho.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * chr->nrxx * chr->nspin);
+    state.counters["nrxx"] = chr->nrxx;
+}
+
+//----------------------------------------------------------
+// one step of the charge mixing of the SCF, from the same densities each time
+//----------------------------------------------------------
+void bm_mix_rho(benchmark::State& state, const BenchCase bcase)
+{
+    ScfCase& scf = get_scf_case(bcase);
+    Charge* chr = scf.charge();
+    Charge_Mixing* chgmix = scf.mixing();
+    for (auto _: state)
+    {
+        state.PauseTiming();
+        scf.restore_charge();
+        state.ResumeTiming();
+        chgmix->mix_rho(chr);
+    }
+    scf.restore_charge();
+
+    state.SetItemsProcessed(state.iterations() * chr->nrxx * chr->nspin);
+    state.SetBytesProcessed(state.iterations() * chr->nspin
+                            * (2 * chr->nrxx * sizeof(double) + 2 * chr->rhopw->npw * sizeof(Complex)));
+    state.counters["nrxx"] = chr->nrxx;
+    state.counters["npw"] = chr->rhopw->npw;
+}
+
+//----------------------------------------------------------
+// Davidson diagonalization of H(k) of the first k point
+//----------------------------------------------------------
+void bm_pw_david(benchmark::State& state, const BenchCase bcase)
+{
+    ScfCase& scf = get_scf_case(bcase);
+    int64_t nhpsi = 0;
+    int64_t niter = 0;
+    for (auto _: state)
+    {
+        niter += scf.david(nhpsi);
+    }
+
+    // one item is one band multiplied by H
+    state.SetItemsProcessed(nhpsi);
+    state.counters["hpsi_per_diag"] = benchmark::Counter(static_cast<double>(nhpsi), benchmark::Counter::kAvgIterations);
+    state.counters["iter_per_diag"] = benchmark::Counter(static_cast<double>(niter), benchmark::Counter::kAvgIterations);
+    state.counters["npw"] = scf.npw();
+}
+
+} // namespace
+
+void register_scf_benchmarks(const BenchCase& bcase)
+{
+    if (bcase.basis_type == "lcao")
+    {
+        set_run(benchmark::RegisterBenchmark(("gint_vlocal/" + bcase.name).c_str(), bm_gint_vlocal, bcase),
+                bcase,
+                benchmark::kMillisecond);
+        set_run(benchmark::RegisterBenchmark(("gint_rho/" + bcase.name).c_str(), bm_gint_rho, bcase),
+                bcase,
+                benchmark::kMillisecond);
+    }
+    else
+    {
+        set_run(benchmark::RegisterBenchmark(("pw_david/" + bcase.name).c_str(), bm_pw_david, bcase),
+                bcase,
+                benchmark::kMillisecond);
+    }
+    set_run(benchmark::RegisterBenchmark(("mix_rho/" + bcase.name).c_str(), bm_mix_rho, bcase),
+            bcase,
+            benchmark::kMillisecond);
+}
+
+void free_scf_case()
+{
+    scf_case.reset();
+}
+
+} // namespace abacus_bench
@@ -0,0 +1,31 @@
+#ifndef ABACUS_BENCH_SCF_H
+#define ABACUS_BENCH_SCF_H
+
+#include "bench_case.h"
+
+namespace abacus_bench
+{
+
+/**
+ * Registers the benchmarks that run on the ESolver of a case, named "<kernel>/<case name>".
+ * The case is set up as abacus does, from the INPUT, STRU, KPT, pseudopotentials and orbitals
+ * in its directory, and runs one SCF iteration, so that the kernels work on the potential, the
+ * density matrix, the charge density and the wave functions of a real calculation:
+ *
+ *  - LCAO: gint_vlocal (Gint::cal_gint of <phi|V_loc|phi> for all spins)
+ *          gint_rho    (Gint::transfer_DM2DtoGrid + Gint::cal_gint of the charge density)
+ *  - PW:   pw_david    (DiagoDavid on H(k) of the first k point, with the hPsi of the Hamiltonian)
+ *  - both: mix_rho     (Charge_Mixing::mix_rho on the densities of the first SCF iteration)
+ *
+ * The case runs in its directory, where its logs go to OUT.<suffix>. Only one case is kept at a time,
+ * the benchmarks of a case must be registered together. The cases run in one pool and one band group,
+ * so kpar and bndpar must not be set in their INPUT.
+ */
+void register_scf_benchmarks(const BenchCase& bcase);
+
+/// free the case kept by the benchmarks, to be called before MPI_Finalize
+void free_scf_case();
+
+} // namespace abacus_bench
+
+#endif
@@ -0,0 +1,76 @@
+#!/usr/bin/env python
+import os,sys,json,argparse
+
+'''
+This script compares a google-benchmark JSON output of abacus_bench
+with a baseline file and exits with 1 if any benchmark is slower
+than the baseline by more than the tolerance.
+The throughput is compared where it is reported (GFLOP/s counter,
+then items_per_second, then bytes_per_second), otherwise real_time.
+usage:
+    abacus_bench --benchmark_out=result.json --benchmark_out_format=json
+    python compare_bench.py result.json baseline.json [-t 0.1]
+    python compare_bench.py result.json baseline.json --update
+'''
+
+def load(filename):
+    with open(filename) as f:
+        data = json.load(f)
+    results = {}
+    for bm in data.get("benchmarks",[]):
+        # only plain runs, the aggregates of --benchmark_repetitions use the mean
+        if bm.get("run_type","iteration") == "aggregate" and bm.get("aggregate_name") != "mean":
+            continue
+        name = bm.get("run_name",bm["name"])
+        results[name] = bm
+    return results
+
+def metric(bm):
+    # (name, value, larger_is_better)
+    for key in ["GFLOP/s","items_per_second","bytes_per_second"]:
+        if key in bm:
+            return key, float(bm[key]), True
+    return "real_time", float(bm["real_time"]), False
+
+def compare(result, baseline, tolerance):
+    nregress = 0
+    print("%-40s %-18s %14s %14s %9s" % ("benchmark","metric","baseline","current","change"))
+    for name in sorted(result):
+        if name not in baseline:
+            print("%-40s not in baseline" % name)
+            continue
+        key, value, larger_is_better = metric(result[name])
+        key_base, value_base, _ = metric(baseline[name])
+        if key != key_base or value_base == 0.0:
+            print("%-40s metrics differ, skipped" % name)
+            continue
+        change = value/value_base - 1.0
+        regress = -change > tolerance if larger_is_better else change > tolerance
+        nregress += regress
+        print("%-40s %-18s %14.6g %14.6g %+8.1f%% %s" % (name,key,value_base,value,100*change,"REGRESSION" if regress else ""))
+    for name in sorted(baseline):
+        if name not in result:
+            print("%-40s missing in result" % name)
+    return nregress
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description="compare abacus_bench results with a baseline")
+    parser.add_argument("result",help="JSON output of abacus_bench")
+    parser.add_argument("baseline",help="JSON baseline of the same machine")
+    parser.add_argument("-t","--tolerance",type=float,default=0.1,help="allowed relative slowdown, default 0.1")
+    parser.add_argument("--update",action="store_true",help="replace the baseline by the result")
+    args = parser.parse_args()
+
+    if args.update:
+        with open(args.result) as f1, open(args.baseline,'w') as f2:
+            f2.write(f1.read())
+        print("baseline %s updated" % args.baseline)
+        sys.exit(0)
+    if not os.path.isfile(args.baseline):
+        print("no baseline %s, create it with --update" % args.baseline)
+        sys.exit(1)
+
+    nregress = compare(load(args.result),load(args.baseline),args.tolerance)
+    if nregress > 0:
+        print("%d benchmark(s) slower than the baseline by more than %.0f%%" % (nregress,100*args.tolerance))
+        sys.exit(1)